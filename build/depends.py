@@ -790,6 +790,7 @@ class MixxxCore(Feature):
 
                    "src/engine/engineworker.cpp",
                    "src/engine/engineworkerscheduler.cpp",
+                   "src/engine/engineparallelprocessor.cpp",
                    "src/engine/enginebuffer.cpp",
                    "src/engine/bufferscalers/enginebufferscale.cpp",
                    "src/engine/bufferscalers/enginebufferscalelinear.cpp",
@@ -810,12 +811,14 @@ class MixxxCore(Feature):
                    "src/engine/engineobject.cpp",
                    "src/engine/enginepregain.cpp",
                    "src/engine/enginemaster.cpp",
+                   "src/engine/offlinerenderer.cpp",
                    "src/engine/enginedelay.cpp",
                    "src/engine/enginevumeter.cpp",
                    "src/engine/enginesidechaincompressor.cpp",
                    "src/engine/sidechain/enginesidechain.cpp",
                    "src/engine/sidechain/networkoutputstreamworker.cpp",
                    "src/engine/sidechain/networkinputstreamworker.cpp",
+                   "src/engine/sidechain/networksendqueue.cpp",
                    "src/engine/enginexfader.cpp",
                    "src/engine/channelmixer_autogen.cpp",
                    "src/engine/positionscratchcontroller.cpp",
@@ -831,10 +834,13 @@ class MixxxCore(Feature):
                    "src/engine/enginetalkoverducking.cpp",
                    "src/engine/cachingreader/cachingreader.cpp",
                    "src/engine/cachingreader/cachingreaderchunk.cpp",
+                   "src/engine/cachingreader/cachingreaderchunkindex.cpp",
+                   "src/engine/cachingreader/cachingreaderpcmcache.cpp",
                    "src/engine/cachingreader/cachingreaderworker.cpp",
 
                    "src/analyzer/trackanalysisscheduler.cpp",
                    "src/analyzer/analyzerthread.cpp",
+                   "src/analyzer/analyzertaskpool.cpp",
                    "src/analyzer/analyzerwaveform.cpp",
                    "src/analyzer/analyzergain.cpp",
                    "src/analyzer/analyzerbeats.cpp",
@@ -961,6 +967,7 @@ class MixxxCore(Feature):
                    "src/library/trackcollection.cpp",
                    "src/library/basesqltablemodel.cpp",
                    "src/library/basetrackcache.cpp",
+                   "src/library/columnartrackindex.cpp",
                    "src/library/columncache.cpp",
                    "src/library/librarytablemodel.cpp",
                    "src/library/searchquery.cpp",
@@ -1032,12 +1039,15 @@ class MixxxCore(Feature):
                    "src/library/scanner/scannertask.cpp",
                    "src/library/scanner/importfilestask.cpp",
                    "src/library/scanner/recursivescandirectorytask.cpp",
+                   "src/library/scanner/scanindex.cpp",
+                   "src/library/scanner/librarywatcher.cpp",
 
                    "src/library/dao/cuedao.cpp",
                    "src/library/dao/cue.cpp",
                    "src/library/dao/trackdao.cpp",
                    "src/library/dao/playlistdao.cpp",
                    "src/library/dao/libraryhashdao.cpp",
+                   "src/library/dao/scanindexdao.cpp",
                    "src/library/dao/settingsdao.cpp",
                    "src/library/dao/analysisdao.cpp",
                    "src/library/dao/autodjcratesdao.cpp",
@@ -1066,6 +1076,7 @@ class MixxxCore(Feature):
                    "src/waveform/sharedglcontext.cpp",
                    "src/waveform/waveform.cpp",
                    "src/waveform/waveformfactory.cpp",
+                   "src/waveform/waveformfile.cpp",
                    "src/waveform/waveformwidgetfactory.cpp",
                    "src/waveform/vsyncthread.cpp",
                    "src/waveform/guitick.cpp",
@@ -1158,6 +1169,7 @@ class MixxxCore(Feature):
                    "src/mixer/sampler.cpp",
                    "src/mixer/samplerbank.cpp",
 
+                   "src/soundio/callbacktimingrecorder.cpp",
                    "src/soundio/sounddevice.cpp",
                    "src/soundio/sounddevicenetwork.cpp",
                    "src/engine/sidechain/enginenetworkstream.cpp",
@@ -1175,10 +1187,12 @@ class MixxxCore(Feature):
                    "src/encoder/encodervorbissettings.cpp",
                    "src/encoder/encoderwave.cpp",
                    "src/encoder/encoderwavesettings.cpp",
+                   "src/encoder/sharedencoder.cpp",
                    'src/encoder/encoderopussettings.cpp',
 
                    "src/util/sleepableqthread.cpp",
                    "src/util/statsmanager.cpp",
+                   "src/util/statid.cpp",
                    "src/util/stat.cpp",
                    "src/util/statmodel.cpp",
                    "src/util/duration.cpp",
@@ -1211,6 +1225,7 @@ class MixxxCore(Feature):
                    "src/util/db/sqlstringformatter.cpp",
                    "src/util/db/sqltransaction.cpp",
                    "src/util/sample.cpp",
+                   "src/util/samplesimd.cpp",
                    "src/util/samplebuffer.cpp",
                    "src/util/readaheadsamplebuffer.cpp",
                    "src/util/rotary.cpp",
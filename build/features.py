@@ -210,7 +210,8 @@ class Mad(Feature):
         build.env.Append(CPPDEFINES='__MAD__')
 
     def sources(self, build):
-        return ['src/sources/soundsourcemp3.cpp']
+        return ['src/sources/soundsourcemp3.cpp',
+                'src/sources/mp3seekindex.cpp']
 
 
 class CoreAudio(Feature):
@@ -640,7 +641,9 @@ class TestSuite(Feature):
     def enabled(self, build):
         build.flags['test'] = (util.get_flags(build.env, 'test', 0) or
                                'test' in SCons.COMMAND_LINE_TARGETS or
-                               'mixxx-test' in SCons.COMMAND_LINE_TARGETS)
+                               'mixxx-test' in SCons.COMMAND_LINE_TARGETS or
+                               'benchmark' in SCons.COMMAND_LINE_TARGETS or
+                               'mixxx-benchmark' in SCons.COMMAND_LINE_TARGETS)
         if int(build.flags['test']):
             return True
         return False
@@ -186,6 +186,15 @@ def copy_with_gain(output, base_indent_depth, num_channels):
         write('return;', depth=2)
         write('}', depth=1)
 
+    write('const CSAMPLE* pSrcs[] = {%s};' % ', '.join(
+        'pSrc%(i)d' % {'i': i} for i in xrange(num_channels)), depth=1)
+    write('const CSAMPLE_GAIN gains[] = {%s};' % ', '.join(
+        'gain%(i)d' % {'i': i} for i in xrange(num_channels)), depth=1)
+    write('if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, %(n)d, iNumSamples)) {' %
+          {'n': num_channels}, depth=1)
+    write('return;', depth=2)
+    write('}', depth=1)
+
     write('// note: LOOP VECTORIZED.', depth=1)
     write('for (int i = 0; i < iNumSamples; ++i) {', depth=1)
     terms = ['pSrc%(i)d[i] * gain%(i)d' % {'i': i} for i in xrange(num_channels)]
@@ -224,6 +233,17 @@ def copy_with_ramping_gain(output, base_indent_depth, num_channels):
         write('const CSAMPLE_GAIN gain_delta%(i)d = (gain%(i)dout - gain%(i)din) / (iNumSamples / 2);' % {'i': i}, depth=1)
         write('const CSAMPLE_GAIN start_gain%(i)d = gain%(i)din + gain_delta%(i)d;' % {'i': i}, depth=1)
 
+    write('const CSAMPLE* pSrcs[] = {%s};' % ', '.join(
+        'pSrc%(i)d' % {'i': i} for i in xrange(num_channels)), depth=1)
+    write('const CSAMPLE_GAIN start_gains[] = {%s};' % ', '.join(
+        'start_gain%(i)d' % {'i': i} for i in xrange(num_channels)), depth=1)
+    write('const CSAMPLE_GAIN gain_deltas[] = {%s};' % ', '.join(
+        'gain_delta%(i)d' % {'i': i} for i in xrange(num_channels)), depth=1)
+    write('if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, %(n)d, iNumSamples)) {' %
+          {'n': num_channels}, depth=1)
+    write('return;', depth=2)
+    write('}', depth=1)
+
     write('// note: LOOP VECTORIZED.', depth=1)
     write('for (int i = 0; i < iNumSamples / 2; ++i) {', depth=1)
 
@@ -0,0 +1,166 @@
+#include "analyzer/analyzertaskpool.h"
+
+#include <QThread>
+
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/memory.h"
+
+
+namespace {
+
+mixxx::Logger kLogger("AnalyzerTaskPool");
+
+} // anonymous namespace
+
+class AnalyzerTaskPoolThread : public QThread {
+  public:
+    AnalyzerTaskPoolThread(AnalyzerTaskPool* pPool, int index)
+            : m_pPool(pPool) {
+        setObjectName(QString("AnalyzerHelper %1").arg(index + 1));
+    }
+
+  protected:
+    void run() override {
+        m_pPool->helperThreadLoop();
+    }
+
+  private:
+    AnalyzerTaskPool* const m_pPool;
+};
+
+AnalyzerTaskPool::AnalyzerTaskPool(
+        int numQueues,
+        int numHelperThreads)
+        : m_queuedTasks(0),
+          m_nextVictim(0),
+          m_stop(false) {
+    DEBUG_ASSERT(numQueues > 0);
+    m_queues.reserve(numQueues);
+    for (int i = 0; i < numQueues; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < numHelperThreads; ++i) {
+        AnalyzerTaskPoolThread* pThread = new AnalyzerTaskPoolThread(this, i);
+        m_threads.push_back(pThread);
+        pThread->start(QThread::LowPriority);
+    }
+    kLogger.debug()
+            << "Created" << numQueues << "queues and"
+            << numHelperThreads << "helper threads";
+}
+
+AnalyzerTaskPool::~AnalyzerTaskPool() {
+    {
+        QMutexLocker locker(&m_waitMutex);
+        m_stop.store(true);
+        m_waitCondition.wakeAll();
+    }
+    for (const auto& pThread : m_threads) {
+        pThread->wait();
+        delete pThread;
+    }
+}
+
+void AnalyzerTaskPool::run(int queueIndex, std::vector<Task>* pTasks) {
+    DEBUG_ASSERT(pTasks);
+    VERIFY_OR_DEBUG_ASSERT(queueIndex >= 0 && queueIndex < queueCount()) {
+        for (auto& task : *pTasks) {
+            task();
+        }
+        return;
+    }
+    if (pTasks->empty()) {
+        return;
+    }
+
+    Batch batch;
+    batch.pendingTasks.store(static_cast<int>(pTasks->size()));
+    {
+        Queue& queue = *m_queues[queueIndex];
+        QMutexLocker locker(&queue.mutex);
+        for (auto& task : *pTasks) {
+            queue.items.push_back(Item{&task, &batch});
+        }
+    }
+    m_queuedTasks.fetch_add(static_cast<int>(pTasks->size()));
+    if (!m_threads.empty() || queueCount() > 1) {
+        QMutexLocker locker(&m_waitMutex);
+        m_waitCondition.wakeAll();
+    }
+
+    while (batch.pendingTasks.load() > 0) {
+        Item item;
+        // Prefer own tasks before helping others
+        if (tryPop(queueIndex, &item) || trySteal(queueIndex, &item)) {
+            execute(item);
+            continue;
+        }
+        // Remaining tasks of the batch are processed by other threads
+        QMutexLocker locker(&m_waitMutex);
+        if (batch.pendingTasks.load() > 0 && m_queuedTasks.load() == 0) {
+            m_waitCondition.wait(&m_waitMutex);
+        }
+    }
+}
+
+bool AnalyzerTaskPool::tryPop(int queueIndex, Item* pItem) {
+    Queue& queue = *m_queues[queueIndex];
+    QMutexLocker locker(&queue.mutex);
+    if (queue.items.empty()) {
+        return false;
+    }
+    *pItem = queue.items.back();
+    queue.items.pop_back();
+    m_queuedTasks.fetch_sub(1);
+    return true;
+}
+
+bool AnalyzerTaskPool::trySteal(int queueIndex, Item* pItem) {
+    if (m_queuedTasks.load() <= 0) {
+        return false;
+    }
+    // Start with a different victim each time to distribute the stealing
+    const int numQueues = queueCount();
+    const int firstVictim = static_cast<int>(m_nextVictim.fetch_add(1) % numQueues);
+    for (int i = 0; i < numQueues; ++i) {
+        const int victim = (firstVictim + i) % numQueues;
+        if (victim == queueIndex) {
+            continue;
+        }
+        Queue& queue = *m_queues[victim];
+        QMutexLocker locker(&queue.mutex);
+        if (!queue.items.empty()) {
+            *pItem = queue.items.front();
+            queue.items.pop_front();
+            m_queuedTasks.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AnalyzerTaskPool::execute(const Item& item) {
+    (*item.pTask)();
+    if (item.pBatch->pendingTasks.fetch_sub(1) == 1) {
+        // Wake up the owner of the batch. The batch must not be
+        // accessed after the decrement, because the owner might
+        // already have returned from run().
+        QMutexLocker locker(&m_waitMutex);
+        m_waitCondition.wakeAll();
+    }
+}
+
+void AnalyzerTaskPool::helperThreadLoop() {
+    while (!m_stop.load()) {
+        Item item;
+        if (trySteal(-1, &item)) {
+            execute(item);
+            continue;
+        }
+        QMutexLocker locker(&m_waitMutex);
+        if (!m_stop.load() && m_queuedTasks.load() == 0) {
+            m_waitCondition.wait(&m_waitMutex);
+        }
+    }
+}
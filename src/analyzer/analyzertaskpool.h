@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QMutex>
+#include <QWaitCondition>
+
+
+// forward declaration(s)
+class AnalyzerTaskPoolThread;
+
+// Work-stealing pool for running independent analyzers of a track
+// concurrently.
+//
+// Every AnalyzerThread owns a task queue. run() pushes the tasks onto
+// the queue of the calling thread, processes them from the back of its
+// own queue and returns after all of them have finished (fork/join).
+// Threads that are waiting for their own tasks and the helper threads
+// of the pool steal tasks from the front of other queues. This keeps
+// otherwise idle cores busy, e.g. when only a few tracks remain at the
+// end of a batch analysis.
+//
+// Tasks are expected to be coarse grained, i.e. a task processes many
+// blocks of decoded audio data. The queues are guarded by a mutex.
+class AnalyzerTaskPool {
+  public:
+    typedef std::function<void()> Task;
+
+    AnalyzerTaskPool(
+            int numQueues,
+            int numHelperThreads);
+    virtual ~AnalyzerTaskPool();
+
+    int queueCount() const {
+        return static_cast<int>(m_queues.size());
+    }
+
+    int helperThreadCount() const {
+        return static_cast<int>(m_threads.size());
+    }
+
+    // Processes all tasks and waits until all of them have finished.
+    // The queue must only be used by a single thread at a time.
+    void run(int queueIndex, std::vector<Task>* pTasks);
+
+  private:
+    struct Batch {
+        std::atomic<int> pendingTasks;
+    };
+
+    struct Item {
+        Task* pTask;
+        Batch* pBatch;
+    };
+
+    struct Queue {
+        QMutex mutex;
+        std::deque<Item> items;
+    };
+
+    // The owner of a queue pops from the back
+    bool tryPop(int queueIndex, Item* pItem);
+    // All others steal from the front. A queueIndex < 0 denotes
+    // a helper thread.
+    bool trySteal(int queueIndex, Item* pItem);
+
+    void execute(const Item& item);
+
+    void helperThreadLoop();
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::atomic<int> m_queuedTasks;
+    std::atomic<unsigned int> m_nextVictim;
+
+    // Sleeping helper threads and threads that are waiting for their
+    // tasks to finish
+    QMutex m_waitMutex;
+    QWaitCondition m_waitCondition;
+
+    std::vector<AnalyzerTaskPoolThread*> m_threads;
+    std::atomic<bool> m_stop;
+
+    friend class AnalyzerTaskPoolThread;
+};
+
+typedef std::shared_ptr<AnalyzerTaskPool> AnalyzerTaskPoolPointer;
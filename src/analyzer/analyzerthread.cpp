@@ -40,6 +40,11 @@ mixxx::Logger kLogger("AnalyzerThread");
 // continuous feedback.
 const mixxx::Duration kBusyProgressInhibitDuration = mixxx::Duration::fromMillis(60);
 
+// The number of blocks that are decoded before passing them to the
+// analyzers. Larger chunks reduce the synchronization overhead when
+// running the analyzers concurrently.
+constexpr int kAnalysisBlocksPerChunk = 16;
+
 void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     if (plainPtr) {
         plainPtr->deleteAfterFinished();
@@ -66,12 +71,14 @@ AnalyzerThread::Pointer AnalyzerThread::createInstance(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags) {
+        AnalyzerModeFlags modeFlags,
+        AnalyzerTaskPoolPointer pTaskPool) {
     return Pointer(new AnalyzerThread(
             id,
             dbConnectionPool,
             pConfig,
-            modeFlags),
+            modeFlags,
+            std::move(pTaskPool)),
             deleteAnalyzerThread);
 }
 
@@ -79,16 +86,20 @@ AnalyzerThread::AnalyzerThread(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags)
+        AnalyzerModeFlags modeFlags,
+        AnalyzerTaskPoolPointer pTaskPool)
         : WorkerThread(QString("AnalyzerThread %1").arg(id)),
           m_id(id),
           m_dbConnectionPool(std::move(dbConnectionPool)),
           m_pConfig(std::move(pConfig)),
           m_modeFlags(modeFlags),
+          m_pTaskPool(std::move(pTaskPool)),
           m_nextTrack(MpscFifoConcurrency::SingleProducer),
-          m_sampleBuffer(mixxx::kAnalysisSamplesPerBlock),
+          m_sampleBuffer(mixxx::kAnalysisSamplesPerBlock * kAnalysisBlocksPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
+    DEBUG_ASSERT(!m_pTaskPool || (m_id < m_pTaskPool->queueCount()));
+    m_decodedBlocks.reserve(kAnalysisBlocksPerChunk);
 }
 
 void AnalyzerThread::doRun() {
@@ -121,6 +132,17 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    if (m_pTaskPool) {
+        for (const auto& analyzer: m_analyzers) {
+            Analyzer* pAnalyzer = analyzer.get();
+            m_analyzerTasks.push_back([this, pAnalyzer] {
+                for (const auto& block: m_decodedBlocks) {
+                    pAnalyzer->process(block.data(), block.length());
+                }
+            });
+        }
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
@@ -183,6 +205,7 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_analyzerTasks.clear();
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -229,16 +252,46 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
             return AnalysisResult::Cancelled;
         }
 
-        // 1st step: Decode next chunk of audio data
-        const auto inputFrameIndexRange =
-                remainingFrames.splitAndShrinkFront(
-                        math_min(mixxx::kAnalysisFramesPerBlock, remainingFrames.length()));
-        DEBUG_ASSERT(!inputFrameIndexRange.empty());
-        const auto readableSampleFrames =
-                audioSourceProxy.readSampleFrames(
-                        mixxx::WritableSampleFrames(
-                                inputFrameIndexRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+        // 1st step: Decode next chunk of audio data block by block
+        m_decodedBlocks.clear();
+        while ((result == AnalysisResult::Pending) &&
+                (static_cast<int>(m_decodedBlocks.size()) < kAnalysisBlocksPerChunk)) {
+            const SINT blockOffset =
+                    m_decodedBlocks.size() * mixxx::kAnalysisSamplesPerBlock;
+            const auto inputFrameIndexRange =
+                    remainingFrames.splitAndShrinkFront(
+                            math_min(mixxx::kAnalysisFramesPerBlock, remainingFrames.length()));
+            DEBUG_ASSERT(!inputFrameIndexRange.empty());
+            const auto readableSampleFrames =
+                    audioSourceProxy.readSampleFrames(
+                            mixxx::WritableSampleFrames(
+                                    inputFrameIndexRange,
+                                    mixxx::SampleBuffer::WritableSlice(
+                                            m_sampleBuffer,
+                                            blockOffset,
+                                            mixxx::kAnalysisSamplesPerBlock)));
+            if (readableSampleFrames.frameLength() == mixxx::kAnalysisFramesPerBlock) {
+                // Complete block of audio samples has been read for analysis
+                m_decodedBlocks.push_back(readableSampleFrames.readableSlice());
+                if (remainingFrames.empty()) {
+                    result = AnalysisResult::Complete;
+                }
+            } else {
+                // Partial block of audio samples has been read.
+                // This should only happen at the end of an audio stream,
+                // otherwise a decoding error must have occurred.
+                if (remainingFrames.empty()) {
+                    result = AnalysisResult::Complete;
+                } else {
+                    // EOF not reached -> Maybe a corrupt file?
+                    kLogger.warning()
+                            << "Aborting analysis after failure to read sample data:"
+                            << "expected frames =" << inputFrameIndexRange
+                            << ", actual frames =" << readableSampleFrames.frameIndexRange();
+                    result = AnalysisResult::Partial;
+                }
+            }
+        }
 
         sleepWhileSuspended();
         if (isStopping()) {
@@ -246,31 +299,7 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         }
 
         // 2nd: step: Analyze chunk of decoded audio data
-        if (readableSampleFrames.frameLength() == mixxx::kAnalysisFramesPerBlock) {
-            // Complete chunk of audio samples has been read for analysis
-            for (auto const& analyzer: m_analyzers) {
-                analyzer->process(
-                        readableSampleFrames.readableData(),
-                        readableSampleFrames.readableLength());
-            }
-            if (remainingFrames.empty()) {
-                result = AnalysisResult::Complete;
-            }
-        } else {
-            // Partial chunk of audio samples has been read.
-            // This should only happen at the end of an audio stream,
-            // otherwise a decoding error must have occurred.
-            if (remainingFrames.empty()) {
-                result = AnalysisResult::Complete;
-            } else {
-                // EOF not reached -> Maybe a corrupt file?
-                kLogger.warning()
-                        << "Aborting analysis after failure to read sample data:"
-                        << "expected frames =" << inputFrameIndexRange
-                        << ", actual frames =" << readableSampleFrames.frameIndexRange();
-                result = AnalysisResult::Partial;
-            }
-        }
+        processDecodedBlocks();
 
         // Don't check again for paused/stopped and simply finish the
         // current iteration by emitting progress.
@@ -288,6 +317,23 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     return result;
 }
 
+void AnalyzerThread::processDecodedBlocks() {
+    if (m_decodedBlocks.empty()) {
+        return;
+    }
+    if (m_pTaskPool) {
+        // The analyzers are independent of each other and run
+        // concurrently, each of them on all blocks in order
+        m_pTaskPool->run(m_id, &m_analyzerTasks);
+    } else {
+        for (const auto& block: m_decodedBlocks) {
+            for (auto const& analyzer: m_analyzers) {
+                analyzer->process(block.data(), block.length());
+            }
+        }
+    }
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack);
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
@@ -6,6 +6,7 @@
 
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzertaskpool.h"
 #include "preferences/usersettings.h"
 #include "sources/audiosource.h"
 #include "track/track.h"
@@ -53,17 +54,21 @@ class AnalyzerThread : public WorkerThread {
         NullPointer();
     };
 
+    // The analyzers of a track are run concurrently on the optional
+    // task pool, using the queue with the index id.
     static Pointer createInstance(
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            AnalyzerTaskPoolPointer pTaskPool = AnalyzerTaskPoolPointer());
 
     /*private*/ AnalyzerThread(
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            AnalyzerTaskPoolPointer pTaskPool);
     ~AnalyzerThread() override = default;
 
     int id() const {
@@ -98,6 +103,7 @@ class AnalyzerThread : public WorkerThread {
     const mixxx::DbConnectionPoolPtr m_dbConnectionPool;
     const UserSettingsPointer m_pConfig;
     const AnalyzerModeFlags m_modeFlags;
+    const AnalyzerTaskPoolPointer m_pTaskPool;
 
     /////////////////////////////////////////////////////////////////////////
     // Thread-safe atomic values
@@ -117,7 +123,13 @@ class AnalyzerThread : public WorkerThread {
     typedef std::unique_ptr<Analyzer> AnalyzerPtr;
     std::vector<AnalyzerPtr> m_analyzers;
 
+    // Each track is decoded only once in chunks of multiple blocks.
+    // All analyzers read the blocks of a chunk from the shared buffer.
     mixxx::SampleBuffer m_sampleBuffer;
+    std::vector<mixxx::SampleBuffer::ReadableSlice> m_decodedBlocks;
+
+    // One task per analyzer that processes all decoded blocks
+    std::vector<AnalyzerTaskPool::Task> m_analyzerTasks;
 
     TrackPointer m_currentTrack;
 
@@ -134,6 +146,9 @@ class AnalyzerThread : public WorkerThread {
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
 
+    // Passes the decoded blocks to all analyzers
+    void processDecodedBlocks();
+
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
 
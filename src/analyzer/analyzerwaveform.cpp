@@ -105,13 +105,17 @@ bool AnalyzerWaveform::isDisabledOrLoadStoredSuccess(TrackPointer tio) const {
         QList<AnalysisDao::AnalysisInfo> analyses =
                 m_analysisDao.getAnalysesForTrack(trackId);
 
-        QListIterator<AnalysisDao::AnalysisInfo> it(analyses);
+        QMutableListIterator<AnalysisDao::AnalysisInfo> it(analyses);
         while (it.hasNext()) {
-            const AnalysisDao::AnalysisInfo& analysis = it.next();
+            AnalysisDao::AnalysisInfo& analysis = it.next();
             WaveformFactory::VersionClass vc;
 
             if (analysis.type == AnalysisDao::TYPE_WAVEFORM) {
                 vc = WaveformFactory::waveformVersionToVersionClass(analysis.version);
+                if (missingWaveform && vc == WaveformFactory::VC_MIGRATE &&
+                        m_analysisDao.migrateWaveformAnalysis(&analysis)) {
+                    vc = WaveformFactory::VC_USE;
+                }
                 if (missingWaveform && vc == WaveformFactory::VC_USE) {
                     pLoadedTrackWaveform = ConstWaveformPointer(
                             WaveformFactory::loadWaveformFromAnalysis(analysis));
@@ -122,6 +126,10 @@ bool AnalyzerWaveform::isDisabledOrLoadStoredSuccess(TrackPointer tio) const {
                 }
             } if (analysis.type == AnalysisDao::TYPE_WAVESUMMARY) {
                 vc = WaveformFactory::waveformSummaryVersionToVersionClass(analysis.version);
+                if (missingWavesummary && vc == WaveformFactory::VC_MIGRATE &&
+                        m_analysisDao.migrateWaveformAnalysis(&analysis)) {
+                    vc = WaveformFactory::VC_USE;
+                }
                 if (missingWavesummary && vc == WaveformFactory::VC_USE) {
                     pLoadedTrackWaveformSummary = ConstWaveformPointer(
                             WaveformFactory::loadWaveformFromAnalysis(analysis));
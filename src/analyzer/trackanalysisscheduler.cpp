@@ -12,6 +12,8 @@ mixxx::Logger kLogger("TrackAnalysisScheduler");
 
 constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
 
+const ConfigKey kConcurrentAnalyzersConfigKey("[Library]", "ConcurrentAnalyzers");
+
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
 
@@ -55,7 +57,8 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
           m_finishedTracksCount(0),
           m_dequeuedTracksCount(0),
           // The first signal should always be emitted
-          m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration) {
+          m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration),
+          m_analysisStarted(false) {
     VERIFY_OR_DEBUG_ASSERT(numWorkerThreads > 0) {
             kLogger.warning()
                     << "Invalid number of worker threads:"
@@ -66,6 +69,15 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 << numWorkerThreads
                 << "worker threads";
     }
+    // The analyzers of each track are distributed among all worker
+    // threads and additional helper threads. The helper threads keep
+    // the cores busy when only a few tracks are left for analysis.
+    if ((numWorkerThreads > 1) &&
+            pConfig->getValue(kConcurrentAnalyzersConfigKey, true)) {
+        m_pTaskPool = std::make_shared<AnalyzerTaskPool>(
+                numWorkerThreads,
+                numWorkerThreads - 1);
+    }
     // 1st pass: Create worker threads
     m_workers.reserve(numWorkerThreads);
     for (int threadId = 0; threadId < numWorkerThreads; ++threadId) {
@@ -73,7 +85,8 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 threadId,
                 library->dbConnectionPool(),
                 pConfig,
-                modeFlags));
+                modeFlags,
+                m_pTaskPool));
         connect(m_workers.back().thread(), &AnalyzerThread::progress,
             this, &TrackAnalysisScheduler::onWorkerThreadProgress);
     }
@@ -92,6 +105,11 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
     // The finished() signal is emitted regardless of when the last
     // signal has been emitted
     if (allTracksFinished()) {
+        if (m_analysisStarted && (m_finishedTracksCount > 0)) {
+            kLogger.info()
+                    << "Analyzed" << m_finishedTracksCount << "tracks:"
+                    << tracksPerMinute() << "tracks per minute";
+        }
         emit finished();
         return;
     }
@@ -164,12 +182,27 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
     DEBUG_ASSERT(m_finishedTracksCount <= m_currentTrackNumber);
     DEBUG_ASSERT(m_currentTrackNumber <= m_dequeuedTracksCount);
     DEBUG_ASSERT(m_dequeuedTracksCount <= totalTracksCount);
+    if (m_finishedTracksCount > 0) {
+        emit throughput(tracksPerMinute());
+    }
     emit progress(
             m_currentTrackProgress,
             m_currentTrackNumber,
             totalTracksCount);
 }
 
+double TrackAnalysisScheduler::tracksPerMinute() const {
+    if (!m_analysisStarted) {
+        return 0.0;
+    }
+    const std::chrono::duration<double, std::ratio<60>> elapsedMinutes =
+            Clock::now() - m_analysisStartedAt;
+    if (elapsedMinutes.count() <= 0.0) {
+        return 0.0;
+    }
+    return m_finishedTracksCount / elapsedMinutes.count();
+}
+
 void TrackAnalysisScheduler::onWorkerThreadProgress(
         int threadId,
         AnalyzerThreadState threadState,
@@ -226,6 +259,10 @@ void TrackAnalysisScheduler::suspend() {
 
 void TrackAnalysisScheduler::resume() {
     kLogger.debug() << "Resuming";
+    if (!m_analysisStarted && !m_queuedTrackIds.empty()) {
+        m_analysisStarted = true;
+        m_analysisStartedAt = Clock::now();
+    }
     for (auto& worker: m_workers) {
         if (worker.threadIdle()) {
             submitNextTrack(&worker);
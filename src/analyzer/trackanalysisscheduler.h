@@ -54,6 +54,8 @@ class TrackAnalysisScheduler : public QObject {
     void trackProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
     // Current average progress for all scheduled tracks and from all workers
     void progress(AnalyzerProgress currentTrackProgress, int currentTrackNumber, int totalTracksCount);
+    // Number of finished tracks per minute since the analysis has been started
+    void throughput(double tracksPerMinute);
     void finished();
 
   private slots:
@@ -157,6 +159,8 @@ class TrackAnalysisScheduler : public QObject {
     bool submitNextTrack(Worker* worker);
     void emitProgressOrFinished();
 
+    double tracksPerMinute() const;
+
     bool allTracksFinished() const {
         DEBUG_ASSERT(m_finishedTracksCount <= m_dequeuedTracksCount);
         return m_queuedTrackIds.empty() && (m_finishedTracksCount == m_dequeuedTracksCount);
@@ -164,6 +168,10 @@ class TrackAnalysisScheduler : public QObject {
 
     Library* m_library;
 
+    // Shared by all worker threads for running the analyzers of
+    // a track concurrently. Might be null.
+    AnalyzerTaskPoolPointer m_pTaskPool;
+
     std::vector<Worker> m_workers;
 
     std::deque<TrackId> m_queuedTrackIds;
@@ -178,4 +186,7 @@ class TrackAnalysisScheduler : public QObject {
 
     typedef std::chrono::steady_clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
+
+    bool m_analysisStarted;
+    Clock::time_point m_analysisStartedAt;
 };
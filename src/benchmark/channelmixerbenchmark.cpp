@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <QScopedPointer>
+
+#include "effects/effectsmanager.h"
+#include "engine/channelhandle.h"
+#include "engine/channelmixer.h"
+#include "test/mixxxtest.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const int kFramesPerBuffer = 1024;
+const int kSampleRate = 44100;
+
+// Alternates the gain of the channels between buffers, such that the
+// mixer always ramps like a moving fader.
+class AlternatingGainCalculator : public EngineMaster::GainCalculator {
+  public:
+    double getGain(EngineMaster::ChannelInfo* pChannelInfo) const override {
+        return (m_odd + pChannelInfo->m_index) % 2 ? 0.5 : 1.0;
+    }
+
+    void toggle() {
+        m_odd = (m_odd + 1) % 2;
+    }
+
+  private:
+    int m_odd = 0;
+};
+
+class ChannelMixerBenchmarkFixture : public MixxxTestEnvironment {
+  public:
+    explicit ChannelMixerBenchmarkFixture(int channelCount)
+            : m_pEffectsManager(new EffectsManager(nullptr, config(), &m_factory)),
+              m_masterHandle(m_factory.getOrCreateHandle("[Master]")),
+              m_output(kFramesPerBuffer * 2) {
+        for (int i = 0; i < channelCount; ++i) {
+            EngineMaster::ChannelInfo* pChannelInfo = new EngineMaster::ChannelInfo(i);
+            pChannelInfo->m_handle = m_factory.getOrCreateHandle(
+                    QString("[Channel%1]").arg(i + 1));
+            pChannelInfo->m_pBuffer = SampleUtil::alloc(kFramesPerBuffer * 2);
+            for (int j = 0; j < kFramesPerBuffer * 2; ++j) {
+                pChannelInfo->m_pBuffer[j] = (j % 64) / 64.0f - 0.5f;
+            }
+            m_activeChannels.append(pChannelInfo);
+            EngineMaster::GainCache gainCache{0, false};
+            m_gainCache.append(gainCache);
+        }
+    }
+
+    ~ChannelMixerBenchmarkFixture() override {
+        for (EngineMaster::ChannelInfo* pChannelInfo : m_activeChannels) {
+            SampleUtil::free(pChannelInfo->m_pBuffer);
+            delete pChannelInfo;
+        }
+    }
+
+    void mix() {
+        m_gainCalculator.toggle();
+        ChannelMixer::applyEffectsAndMixChannels(
+                m_gainCalculator, &m_activeChannels, &m_gainCache,
+                m_output.data(), m_masterHandle,
+                m_output.size(), kSampleRate,
+                m_pEffectsManager->getEngineEffectsManager());
+    }
+
+  private:
+    ChannelHandleFactory m_factory;
+    QScopedPointer<EffectsManager> m_pEffectsManager;
+    const ChannelHandle m_masterHandle;
+    AlternatingGainCalculator m_gainCalculator;
+    QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels> m_activeChannels;
+    QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels> m_gainCache;
+    mixxx::SampleBuffer m_output;
+};
+
+static void BM_ChannelMixer(benchmark::State& state) {
+    ChannelMixerBenchmarkFixture fixture(state.range_x());
+    while (state.KeepRunning()) {
+        fixture.mix();
+    }
+    state.SetItemsProcessed(state.iterations() * kFramesPerBuffer);
+}
+BENCHMARK(BM_ChannelMixer)->Arg(2)->Arg(3)->Arg(4)->Arg(8)->Arg(12)->Arg(16);
+
+} // namespace
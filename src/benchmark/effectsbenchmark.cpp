@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include "effects/builtin/builtinbackend.h"
+#include "effects/effect.h"
+#include "effects/effectchain.h"
+#include "effects/effectchainslot.h"
+#include "effects/effectrack.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "test/signalpathtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const int kFramesPerBuffer = 1024;
+const int kSampleRate = 44100;
+
+const char* kEffectIds[] = {
+    "org.mixxx.effects.filter",
+    "org.mixxx.effects.echo",
+    "org.mixxx.effects.flanger",
+    "org.mixxx.effects.phaser",
+};
+
+// Routes [Channel1] through the first effect unit of the standard rack
+// with the given number of built-in effects enabled.
+class EffectsBenchmarkFixture : public MixxxTestEnvironment,
+        public SignalPathEnvironment {
+  public:
+    explicit EffectsBenchmarkFixture(int effectCount)
+            : SignalPathEnvironment(config()),
+              m_buffer(kFramesPerBuffer * 2) {
+        m_pEffectsManager->addEffectsBackend(new BuiltInBackend(m_pEffectsManager));
+        StandardEffectRackPointer pRack = m_pEffectsManager->addStandardEffectRack();
+
+        EffectChainPointer pChain(new EffectChain(m_pEffectsManager,
+                "org.mixxx.benchmark.chain"));
+        for (int i = 0; i < effectCount; ++i) {
+            EffectPointer pEffect = m_pEffectsManager->instantiateEffect(kEffectIds[i]);
+            if (pEffect) {
+                pEffect->setEnabled(true);
+                pChain->addEffect(pEffect);
+            }
+        }
+        pRack->getEffectChainSlot(0)->loadEffectChainToSlot(pChain);
+        pChain->setEnabled(true);
+        pChain->setMix(1.0);
+        pChain->enableForInputChannel(ChannelHandleAndGroup(
+                m_pChannel1->getHandle(), m_sGroup1));
+
+        for (int i = 0; i < kFramesPerBuffer * 2; ++i) {
+            m_buffer.data()[i] = (i % 128) / 128.0f - 0.5f;
+        }
+
+        // The engine applies the requests of the effects manager at the
+        // start of the callback.
+        ProcessBuffer();
+    }
+
+    void process() {
+        GroupFeatureState features;
+        m_pEffectsManager->getEngineEffectsManager()->processPostFaderInPlace(
+                m_pChannel1->getHandle(), m_pEffectsManager->getMasterHandle(),
+                m_buffer.data(), m_buffer.size(), kSampleRate, features);
+    }
+
+  private:
+    mixxx::SampleBuffer m_buffer;
+};
+
+static void BM_EngineEffectsChain(benchmark::State& state) {
+    EffectsBenchmarkFixture fixture(state.range_x());
+    while (state.KeepRunning()) {
+        fixture.process();
+    }
+    state.SetItemsProcessed(state.iterations() * kFramesPerBuffer);
+}
+BENCHMARK(BM_EngineEffectsChain)->Arg(0)->Arg(1)->Arg(2)->Arg(3)->Arg(4);
+
+} // namespace
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <QThread>
+
+#include "engine/enginebuffer.h"
+#include "test/signalpathtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const int kFramesPerBuffer = 1024;
+
+enum Scaler {
+    LINEAR,
+    SOUNDTOUCH,
+    RUBBERBAND,
+};
+
+const char* scalerName(int scaler) {
+    switch (scaler) {
+    case SOUNDTOUCH:
+        return "SoundTouch";
+    case RUBBERBAND:
+        return "Rubber Band";
+    default:
+        return "linear";
+    }
+}
+
+// Plays a deck slightly faster than the original tempo, which selects
+// the linear scaler without keylock and the keylock scaler otherwise.
+class EngineBufferBenchmarkFixture : public MixxxTestEnvironment,
+        public SignalPathEnvironment {
+  public:
+    explicit EngineBufferBenchmarkFixture(int scaler)
+            : SignalPathEnvironment(config()),
+              m_pEngineBuffer(m_pChannel1->getEngineBuffer()),
+              m_buffer(kFramesPerBuffer * 2) {
+        loadTestTracks();
+        if (scaler == SOUNDTOUCH) {
+            ControlObject::set(ConfigKey("[Master]", "keylock_engine"),
+                    static_cast<double>(EngineBuffer::SOUNDTOUCH));
+        } else if (scaler == RUBBERBAND) {
+            ControlObject::set(ConfigKey("[Master]", "keylock_engine"),
+                    static_cast<double>(EngineBuffer::RUBBERBAND));
+        }
+        ControlObject::set(ConfigKey(m_sGroup1, "keylock"), scaler != LINEAR ? 1.0 : 0.0);
+        ControlObject::set(ConfigKey(m_sGroup1, "rate"), getRateSliderValue(1.05));
+        ControlObject::set(ConfigKey(m_sGroup1, "repeat"), 1.0);
+        ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+    }
+
+    void process(benchmark::State* pState) {
+        m_pEngineBuffer->process(m_buffer.data(), m_buffer.size());
+        m_pEngineBuffer->postProcess(m_buffer.size());
+        // Measure the scaler instead of cache misses, the deck plays
+        // faster than realtime.
+        if (m_pEngineBuffer->hasPendingReads()) {
+            pState->PauseTiming();
+            while (m_pEngineBuffer->hasPendingReads()) {
+                QThread::usleep(100);
+            }
+            pState->ResumeTiming();
+        }
+    }
+
+  private:
+    EngineBuffer* m_pEngineBuffer;
+    mixxx::SampleBuffer m_buffer;
+};
+
+static void BM_EngineBufferProcess(benchmark::State& state) {
+    EngineBufferBenchmarkFixture fixture(state.range_x());
+    while (state.KeepRunning()) {
+        fixture.process(&state);
+    }
+    state.SetItemsProcessed(state.iterations() * kFramesPerBuffer);
+    state.SetLabel(scalerName(state.range_x()));
+}
+BENCHMARK(BM_EngineBufferProcess)->Arg(LINEAR)->Arg(SOUNDTOUCH)->Arg(RUBBERBAND);
+
+} // namespace
@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "control/controlobject.h"
+#include "engine/enginevumeter.h"
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilterbiquad1.h"
+#include "engine/filters/enginefilteriirbank.h"
+#include "engine/filters/enginefilterlinkwitzriley2.h"
+#include "engine/filters/enginefilterlinkwitzriley4.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const int kSampleRate = 44100;
+
+#define FOR_COMMON_BUFFER_SIZES(bm) bm->Arg(64)->Arg(256)->Arg(1024)->Arg(4096);
+
+void fillBuffer(mixxx::SampleBuffer* pBuffer) {
+    for (SINT i = 0; i < pBuffer->size(); ++i) {
+        pBuffer->data()[i] = (i % 100) / 100.0f - 0.5f;
+    }
+}
+
+// The constructors of the filters take the sample rate and either one
+// corner frequency or a center frequency and a Q.
+template<typename Filter>
+Filter* createFilter() {
+    return new Filter(kSampleRate, 1000);
+}
+
+template<>
+EngineFilterBiquad1LowShelving* createFilter<EngineFilterBiquad1LowShelving>() {
+    return new EngineFilterBiquad1LowShelving(kSampleRate, 250, 0.7);
+}
+
+template<>
+EngineFilterBiquad1Peaking* createFilter<EngineFilterBiquad1Peaking>() {
+    return new EngineFilterBiquad1Peaking(kSampleRate, 1000, 1.75);
+}
+
+template<>
+EngineFilterBiquad1HighShelving* createFilter<EngineFilterBiquad1HighShelving>() {
+    return new EngineFilterBiquad1HighShelving(kSampleRate, 2500, 0.7);
+}
+
+template<>
+EngineFilterBessel4Band* createFilter<EngineFilterBessel4Band>() {
+    return new EngineFilterBessel4Band(kSampleRate, 250, 2500);
+}
+
+template<>
+EngineFilterBessel8Band* createFilter<EngineFilterBessel8Band>() {
+    return new EngineFilterBessel8Band(kSampleRate, 250, 2500);
+}
+
+template<typename Filter>
+static void BM_EngineFilter(benchmark::State& state) {
+    const SINT bufferSize = state.range_x() * 2;
+    mixxx::SampleBuffer input(bufferSize);
+    mixxx::SampleBuffer output(bufferSize);
+    fillBuffer(&input);
+    std::unique_ptr<Filter> pFilter(createFilter<Filter>());
+    while (state.KeepRunning()) {
+        pFilter->process(input.data(), output.data(), bufferSize);
+        benchmark::DoNotOptimize(output.data()[bufferSize / 2]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterBiquad1LowShelving));
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterBiquad1Peaking));
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterBiquad1HighShelving));
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterBessel4Low));
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterBessel4Band));
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterBessel8Low));
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterBessel8Band));
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterLinkwitzRiley2Low));
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterLinkwitzRiley4Low));
+FOR_COMMON_BUFFER_SIZES(BENCHMARK_TEMPLATE(BM_EngineFilter, EngineFilterLinkwitzRiley8Low));
+
+// The crossover of the LinkwitzRiley8 EQ, with the low and high pass
+// processed one after the other or side by side in EngineFilterIIRBank.
+static void BM_LinkwitzRiley8Crossover(benchmark::State& state) {
+    const SINT bufferSize = state.range_x() * 2;
+    const bool useBank = state.range_y() != 0;
+    mixxx::SampleBuffer input(bufferSize);
+    mixxx::SampleBuffer low(bufferSize);
+    mixxx::SampleBuffer high(bufferSize);
+    fillBuffer(&input);
+    EngineFilterLinkwitzRiley8Low lowPass(kSampleRate, 2484);
+    EngineFilterLinkwitzRiley8High highPass(kSampleRate, 2484);
+    while (state.KeepRunning()) {
+        if (useBank) {
+            EngineFilterIIRBank::process(
+                    &lowPass, input.data(), low.data(),
+                    &highPass, input.data(), high.data(),
+                    bufferSize);
+        } else {
+            lowPass.process(input.data(), low.data(), bufferSize);
+            highPass.process(input.data(), high.data(), bufferSize);
+        }
+        benchmark::DoNotOptimize(low.data()[bufferSize / 2]);
+        benchmark::DoNotOptimize(high.data()[bufferSize / 2]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range_x());
+    state.SetLabel(useBank ? "bank" : "scalar");
+}
+BENCHMARK(BM_LinkwitzRiley8Crossover)
+        ->ArgPair(64, 0)->ArgPair(64, 1)
+        ->ArgPair(256, 0)->ArgPair(256, 1)
+        ->ArgPair(1024, 0)->ArgPair(1024, 1);
+
+// EngineVuMeter reads the sample rate from [Master],samplerate, which is
+// created by the sound manager in the application.
+class VuMeterBenchmarkFixture : public MixxxTestEnvironment {
+  public:
+    VuMeterBenchmarkFixture()
+            : m_sampleRate(ConfigKey("[Master]", "samplerate")) {
+        m_sampleRate.set(kSampleRate);
+    }
+
+  private:
+    ControlObject m_sampleRate;
+};
+
+static void BM_EngineVuMeter(benchmark::State& state) {
+    VuMeterBenchmarkFixture fixture;
+    EngineVuMeter vuMeter("[Channel1]");
+    const SINT bufferSize = state.range_x() * 2;
+    mixxx::SampleBuffer buffer(bufferSize);
+    fillBuffer(&buffer);
+    while (state.KeepRunning()) {
+        vuMeter.process(buffer.data(), bufferSize);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+FOR_COMMON_BUFFER_SIZES(BENCHMARK(BM_EngineVuMeter));
+
+} // namespace
@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <vector>
+
+#include "errordialoghandler.h"
+#include "test/mixxxtest.h"
+
+// Runs the benchmarks of the engine and the benchmarks of the test suite.
+// The results are reported as JSON on stdout unless another format is
+// requested with --benchmark_format, logging goes to stderr.
+int main(int argc, char **argv) {
+    // We never want to popup error dialogs when running benchmarks.
+    ErrorDialogHandler::setEnabled(false);
+
+    std::vector<char*> args(argv, argv + argc);
+    bool formatRequested = false;
+    for (int i = 0; i < argc; ++i) {
+        if (strncmp(argv[i], "--benchmark_format", 18) == 0) {
+            formatRequested = true;
+            break;
+        }
+    }
+    char jsonFormat[] = "--benchmark_format=json";
+    if (!formatRequested) {
+        args.push_back(jsonFormat);
+    }
+    int benchmarkArgc = static_cast<int>(args.size());
+    args.push_back(nullptr);
+
+    benchmark::Initialize(&benchmarkArgc, args.data());
+
+    MixxxTest::ApplicationScope applicationScope(benchmarkArgc, args.data());
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
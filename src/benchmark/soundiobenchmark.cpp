@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "soundio/soundmanagerutil.h"
+#include "util/fifo.h"
+#include "util/memory.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+// Four stereo timecode inputs of an eight channel sound card
+const int kInputs = 4;
+const int kFrameSize = kInputs * 2;
+
+// Routes the inputs of a device buffer to FIFOs like VinylControlProcessor,
+// either through the copied stereo buffers of the inputs or straight from
+// AudioInputViews into the device buffer.
+static void BM_SoundInputRouting(benchmark::State& state) {
+    const SINT frames = state.range_x();
+    const bool useViews = state.range_y() != 0;
+    mixxx::SampleBuffer device(frames * kFrameSize);
+    for (SINT i = 0; i < device.size(); ++i) {
+        device.data()[i] = (i % 100) / 100.0f - 0.5f;
+    }
+    mixxx::SampleBuffer inputBuffer(frames * 2);
+    std::vector<CSAMPLE> drain(frames * 2);
+    std::vector<std::unique_ptr<FIFO<CSAMPLE>>> fifos;
+    for (int i = 0; i < kInputs; ++i) {
+        fifos.push_back(std::make_unique<FIFO<CSAMPLE>>(frames * 4));
+    }
+    while (state.KeepRunning()) {
+        for (int i = 0; i < kInputs; ++i) {
+            AudioInputView view(&device.data()[i * 2], kFrameSize, 2);
+            if (useViews) {
+                view.writeStereo(fifos[i].get(), frames);
+            } else {
+                view.copyStereo(inputBuffer.data(), 0, frames);
+                fifos[i]->write(inputBuffer.data(), frames * 2);
+            }
+            fifos[i]->read(drain.data(), frames * 2);
+        }
+        benchmark::DoNotOptimize(drain[frames]);
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+    state.SetLabel(useViews ? "views" : "copied");
+}
+BENCHMARK(BM_SoundInputRouting)
+        ->ArgPair(64, 0)->ArgPair(64, 1)
+        ->ArgPair(256, 0)->ArgPair(256, 1)
+        ->ArgPair(1024, 0)->ArgPair(1024, 1);
+
+} // namespace
@@ -123,6 +123,12 @@ class ControlProxy : public QObject {
         return m_pControl ? m_pControl->defaultValue() : 0.0;
     }
 
+    // Returns the ControlObject that created the control or nullptr if it has
+    // been deleted. Unlike ControlObject::getControl() this needs no lookup.
+    inline ControlObject* getCreatorCO() const {
+        return m_pControl ? m_pControl->getCreatorCO() : nullptr;
+    }
+
   public slots:
     // Set the control to a new value. Non-blocking.
     inline void slotSet(double v) {
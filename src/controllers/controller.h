@@ -66,6 +66,12 @@ class Controller : public QObject, ConstControllerPresetVisitor {
 
     virtual bool matchPreset(const PresetInfo& preset) = 0;
 
+    // Returns true if the timestamps passed to receive() are taken from
+    // mixxx::Time when the data arrives from the device.
+    virtual bool hasArrivalTimestamps() const {
+        return false;
+    }
+
   signals:
     // Emitted when a new preset is loaded. pPreset is a /clone/ of the loaded
     // preset, not a pointer to the preset itself.
@@ -8,6 +8,8 @@
 
 #include "controllers/controllerengine.h"
 
+#include <algorithm>
+
 #include "controllers/controller.h"
 #include "controllers/controllerdebug.h"
 #include "control/controlobject.h"
@@ -28,18 +30,24 @@ const int kDecks = 16;
 // timer.
 const int kScratchTimerMs = 1;
 const double kAlphaBetaDt = kScratchTimerMs / 1000.0;
+const mixxx::Duration kScratchPeriod = mixxx::Duration::fromMillis(kScratchTimerMs);
+// Maximum number of filter periods that are caught up with in a single call of
+// scratchProcess() if its timer fired late.
+const int kMaxScratchPeriodsPerTimer = 32;
 
 ControllerEngine::ControllerEngine(Controller* controller)
         : m_pEngine(nullptr),
           m_pController(controller),
           m_bPopups(false),
-          m_pBaClass(nullptr) {
+          m_pBaClass(nullptr),
+          m_bInputTimestampValid(false) {
     // Handle error dialog buttons
     qRegisterMetaType<QMessageBox::StandardButton>("QMessageBox::StandardButton");
 
     // Pre-allocate arrays for average number of virtual decks
-    m_intervalAccumulator.resize(kDecks);
+    m_scratchTicks.resize(kDecks);
     m_lastMovement.resize(kDecks);
+    m_scratchPeriodEnd.resize(kDecks);
     m_dx.resize(kDecks);
     m_rampTo.resize(kDecks);
     m_ramp.resize(kDecks);
@@ -174,6 +182,11 @@ void ControllerEngine::gracefulShutdown() {
     // Clear the cache of function wrappers
     m_scriptWrappedFunctionCache.clear();
 
+    // The handles point to the ControlObjectScripts that are freed below.
+    // A reloaded script has to request new handles.
+    m_controlHandles.clear();
+    m_controlHandleIndices.clear();
+
     // Free all the ControlObjectScripts
     QList<ConfigKey> keys = m_controlCache.keys();
     QList<ConfigKey>::iterator it = keys.begin();
@@ -419,7 +432,6 @@ bool ControllerEngine::execute(QScriptValue functionObject,
                                unsigned char status,
                                const QString& group,
                                mixxx::Duration timestamp) {
-    Q_UNUSED(timestamp);
     if (m_pEngine == nullptr) {
         return false;
     }
@@ -429,19 +441,32 @@ bool ControllerEngine::execute(QScriptValue functionObject,
     args << QScriptValue(value);
     args << QScriptValue(status);
     args << QScriptValue(group);
-    return internalExecute(m_pEngine->globalObject(), functionObject, args);
+    setInputTimestamp(timestamp);
+    bool result = internalExecute(m_pEngine->globalObject(), functionObject, args);
+    m_bInputTimestampValid = false;
+    return result;
 }
 
 bool ControllerEngine::execute(QScriptValue function, const QByteArray data,
                                mixxx::Duration timestamp) {
-    Q_UNUSED(timestamp);
     if (m_pEngine == nullptr) {
         return false;
     }
     QScriptValueList args;
     args << m_pBaClass->newInstance(data);
     args << QScriptValue(data.size());
-    return internalExecute(m_pEngine->globalObject(), function, args);
+    setInputTimestamp(timestamp);
+    bool result = internalExecute(m_pEngine->globalObject(), function, args);
+    m_bInputTimestampValid = false;
+    return result;
+}
+
+void ControllerEngine::setInputTimestamp(mixxx::Duration timestamp) {
+    // Only timestamps that are taken from mixxx::Time when the message
+    // arrives can be compared with the scratch timers.
+    m_inputTimestamp = timestamp;
+    m_bInputTimestampValid = m_pController != nullptr &&
+            m_pController->hasArrivalTimestamps();
 }
 
 /* -------- ------------------------------------------------------
@@ -580,10 +605,14 @@ void ControllerEngine::setValue(QString group, QString name, double newValue) {
     ControlObjectScript* coScript = getControlObjectScript(group, name);
 
     if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(coScript->getKey());
-        if (pControl && !m_st.ignore(pControl, coScript->getParameterForValue(newValue))) {
-            coScript->slotSet(newValue);
-        }
+        setControlValue(coScript, newValue);
+    }
+}
+
+void ControllerEngine::setControlValue(ControlObjectScript* coScript, double newValue) {
+    ControlObject* pControl = coScript->getCreatorCO();
+    if (pControl && !m_st.ignore(pControl, coScript->getParameterForValue(newValue))) {
+        coScript->slotSet(newValue);
     }
 }
 
@@ -617,10 +646,15 @@ void ControllerEngine::setParameter(QString group, QString name, double newParam
     ControlObjectScript* coScript = getControlObjectScript(group, name);
 
     if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(coScript->getKey());
-        if (pControl && !m_st.ignore(pControl, newParameter)) {
-          coScript->setParameter(newParameter);
-        }
+        setControlParameter(coScript, newParameter);
+    }
+}
+
+void ControllerEngine::setControlParameter(ControlObjectScript* coScript,
+                                           double newParameter) {
+    ControlObject* pControl = coScript->getCreatorCO();
+    if (pControl && !m_st.ignore(pControl, newParameter)) {
+        coScript->setParameter(newParameter);
     }
 }
 
@@ -690,6 +724,82 @@ double ControllerEngine::getDefaultParameter(QString group, QString name) {
     return coScript->getParameterForValue(coScript->getDefault());
 }
 
+ControlObjectScript* ControllerEngine::getControlObjectScript(int handle) {
+    if (handle < 0 || handle >= m_controlHandles.size()) {
+        qWarning() << "ControllerEngine: Invalid control handle" << handle;
+        return nullptr;
+    }
+    return m_controlHandles[handle];
+}
+
+/* -------- ------------------------------------------------------
+   Purpose: Returns a handle for a Mixxx control (for scripts)
+   Input:   Control group, Key name
+   Output:  The handle or -1 if the control does not exist
+   -------- ------------------------------------------------------ */
+int ControllerEngine::getControlHandle(QString group, QString name) {
+    ConfigKey key(group, name);
+    auto it = m_controlHandleIndices.constFind(key);
+    if (it != m_controlHandleIndices.constEnd()) {
+        return it.value();
+    }
+
+    ControlObjectScript* coScript = getControlObjectScript(group, name);
+    if (coScript == nullptr) {
+        qWarning() << "ControllerEngine: Unknown control" << group << name
+                   << ", returning invalid handle";
+        return -1;
+    }
+    // The handles stay valid until the ControlObjectScripts are freed
+    // in gracefulShutdown(), i.e. until the scripts are reloaded.
+    int handle = m_controlHandles.size();
+    m_controlHandles.append(coScript);
+    m_controlHandleIndices.insert(key, handle);
+    return handle;
+}
+
+double ControllerEngine::getValueByHandle(int handle) {
+    ControlObjectScript* coScript = getControlObjectScript(handle);
+    if (coScript == nullptr) {
+        return 0.0;
+    }
+    return coScript->get();
+}
+
+void ControllerEngine::setValueByHandle(int handle, double newValue) {
+    ControlObjectScript* coScript = getControlObjectScript(handle);
+    if (coScript == nullptr) {
+        return;
+    }
+    if (isnan(newValue)) {
+        qWarning() << "ControllerEngine: script setting" << coScript->getKey()
+                   << "to NotANumber, ignoring.";
+        return;
+    }
+    setControlValue(coScript, newValue);
+}
+
+double ControllerEngine::getParameterByHandle(int handle) {
+    ControlObjectScript* coScript = getControlObjectScript(handle);
+    if (coScript == nullptr) {
+        return 0.0;
+    }
+    return coScript->getParameter();
+}
+
+void ControllerEngine::setParameterByHandle(int handle, double newParameter) {
+    ControlObjectScript* coScript = getControlObjectScript(handle);
+    if (coScript == nullptr) {
+        return;
+    }
+    if (isnan(newParameter)) {
+        qWarning() << "ControllerEngine: script setting" << coScript->getKey()
+                   << "to NotANumber, ignoring.";
+        return;
+    }
+    setControlParameter(coScript, newParameter);
+}
+
 /* -------- ------------------------------------------------------
    Purpose: qDebugs script output so it ends up in mixxx.log
    Input:   String to log
@@ -1197,7 +1307,7 @@ void ControllerEngine::scratchEnable(int deck, int intervalsPerRev, double rpm,
     }
 
     m_dx[deck] = 1.0 / intervalsPerSecond;
-    m_intervalAccumulator[deck] = 0.0;
+    m_scratchTicks[deck].clear();
     m_ramp[deck] = false;
     m_rampFactor[deck] = 0.001;
     m_brakeActive[deck] = false;
@@ -1238,6 +1348,7 @@ void ControllerEngine::scratchEnable(int deck, int intervalsPerRev, double rpm,
 
     // 1ms is shortest possible, OS dependent
     int timerId = startTimer(kScratchTimerMs);
+    m_scratchPeriodEnd[deck] = mixxx::Time::elapsed() + kScratchPeriod;
 
     // Associate this virtual deck with this timer for later processing
     m_scratchTimers[timerId] = deck;
@@ -1254,8 +1365,15 @@ void ControllerEngine::scratchEnable(int deck, int intervalsPerRev, double rpm,
     Output:  -
     -------- ------------------------------------------------------ */
 void ControllerEngine::scratchTick(int deck, int interval) {
-    m_lastMovement[deck] = mixxx::Time::elapsed();
-    m_intervalAccumulator[deck] += interval;
+    // Ticks are applied at the time the message that caused them has been
+    // received, independent of when the script and the scratch timer run.
+    const mixxx::Duration timestamp = m_bInputTimestampValid ?
+            m_inputTimestamp : mixxx::Time::elapsed();
+    m_lastMovement[deck] = timestamp;
+    // Ticks are only observed while scratching
+    if (m_dx[deck] != 0.0) {
+        m_scratchTicks[deck].append(ScratchTick{timestamp, interval});
+    }
 }
 
 /* -------- ------------------------------------------------------
@@ -1275,22 +1393,24 @@ void ControllerEngine::scratchProcess(int timerId) {
 
     const double oldRate = filter->predictedVelocity();
 
-    // Give the filter a data point:
-
-    // If we're ramping to end scratching and the wheel hasn't been turned very
-    // recently (spinback after lift-off,) feed fixed data
-    if (m_ramp[deck] && !m_softStartActive[deck] &&
-        ((mixxx::Time::elapsed() - m_lastMovement[deck]) >= mixxx::Duration::fromMillis(1))) {
-        filter->observation(m_rampTo[deck] * m_rampFactor[deck]);
-        // Once this code path is run, latch so it always runs until reset
-        //m_lastMovement[deck] += mixxx::Duration::fromSeconds(1);
-    } else if (m_softStartActive[deck]) {
-        // pretend we have moved by (desired rate*default distance)
-        filter->observation(m_rampTo[deck]*kAlphaBetaDt);
-    } else {
-        // This will (and should) be 0 if no net ticks have been accumulated
-        // (i.e. the wheel is stopped)
-        filter->observation(m_dx[deck] * m_intervalAccumulator[deck]);
+    // The filter expects one observation per kAlphaBetaDt, but the timer
+    // neither fires exactly nor reliably in time. Feed one observation for
+    // every period that has passed since the last call, each with the ticks
+    // that were received during that period.
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    int periods = 0;
+    while (m_scratchPeriodEnd[deck] <= now && periods < kMaxScratchPeriodsPerTimer) {
+        scratchObserve(deck, m_scratchPeriodEnd[deck]);
+        m_scratchPeriodEnd[deck] += kScratchPeriod;
+        ++periods;
+    }
+    if (periods == 0) {
+        return;
+    }
+    if (m_scratchPeriodEnd[deck] <= now) {
+        // The controller thread has stalled. Skip the missed periods instead of
+        // catching up with all of them, their ticks go to the next observation.
+        m_scratchPeriodEnd[deck] = now + kScratchPeriod;
     }
 
     const double newRate = filter->predictedVelocity();
@@ -1302,9 +1422,6 @@ void ControllerEngine::scratchProcess(int timerId) {
     }
     pScratch2->set(newRate);
 
-    // Reset accumulator
-    m_intervalAccumulator[deck] = 0;
-
     // End scratching if we're ramping and the current rate is really close to the rampTo value
     if ((m_ramp[deck] && fabs(m_rampTo[deck] - newRate) <= 0.00001) ||
         // or if we brake or softStart and have crossed over the desired value,
@@ -1343,6 +1460,41 @@ void ControllerEngine::scratchProcess(int timerId) {
     }
 }
 
+void ControllerEngine::scratchObserve(int deck, mixxx::Duration periodEnd) {
+    AlphaBetaFilter* filter = m_scratchFilters[deck];
+
+    // Take the ticks that have been received before the end of the period
+    QVector<ScratchTick>& ticks = m_scratchTicks[deck];
+    int intervals = 0;
+    auto end = std::remove_if(ticks.begin(), ticks.end(),
+            [periodEnd, &intervals](const ScratchTick& tick) {
+                if (tick.timestamp < periodEnd) {
+                    intervals += tick.interval;
+                    return true;
+                }
+                return false;
+            });
+    ticks.erase(end, ticks.end());
+
+    // Give the filter a data point:
+
+    // If we're ramping to end scratching and the wheel hasn't been turned very
+    // recently (spinback after lift-off,) feed fixed data
+    if (m_ramp[deck] && !m_softStartActive[deck] &&
+        (m_lastMovement[deck] + mixxx::Duration::fromMillis(1) <= periodEnd)) {
+        filter->observation(m_rampTo[deck] * m_rampFactor[deck]);
+        // Once this code path is run, latch so it always runs until reset
+        //m_lastMovement[deck] += mixxx::Duration::fromSeconds(1);
+    } else if (m_softStartActive[deck]) {
+        // pretend we have moved by (desired rate*default distance)
+        filter->observation(m_rampTo[deck]*kAlphaBetaDt);
+    } else {
+        // This will (and should) be 0 if no net ticks have been received
+        // (i.e. the wheel is stopped)
+        filter->observation(m_dx[deck] * intervals);
+    }
+}
+
 /* -------- ------------------------------------------------------
     Purpose: Stops scratching the specified virtual deck
     Input:   Virtual deck to stop scratching
@@ -1477,6 +1629,7 @@ void ControllerEngine::brake(int deck, bool activate, double factor, double rate
         // setup timer and set scratch2
         timerId = startTimer(kScratchTimerMs);
         m_scratchTimers[timerId] = deck;
+        m_scratchPeriodEnd[deck] = mixxx::Time::elapsed() + kScratchPeriod;
 
         ControlObjectScript* pScratch2 = getControlObjectScript(group, "scratch2");
         if (pScratch2 != nullptr) {
@@ -1541,6 +1694,7 @@ void ControllerEngine::softStart(int deck, bool activate, double factor) {
         // setup timer, start playing and set scratch2
         timerId = startTimer(kScratchTimerMs);
         m_scratchTimers[timerId] = deck;
+        m_scratchPeriodEnd[deck] = mixxx::Time::elapsed() + kScratchPeriod;
 
         ControlObjectScript* pPlay = getControlObjectScript(group, "play");
         if (pPlay != nullptr) {
@@ -111,6 +111,13 @@ class ControllerEngine : public QObject {
     Q_INVOKABLE void reset(QString group, QString name);
     Q_INVOKABLE double getDefaultValue(QString group, QString name);
     Q_INVOKABLE double getDefaultParameter(QString group, QString name);
+    // Resolves a control once for the *ByHandle() functions, which avoid the
+    // lookup by name on each call. Returns -1 if the control does not exist.
+    Q_INVOKABLE int getControlHandle(QString group, QString name);
+    Q_INVOKABLE double getValueByHandle(int handle);
+    Q_INVOKABLE void setValueByHandle(int handle, double newValue);
+    Q_INVOKABLE double getParameterByHandle(int handle);
+    Q_INVOKABLE void setParameterByHandle(int handle, double newParameter);
     Q_INVOKABLE QScriptValue makeConnection(QString group, QString name,
                                             const QScriptValue callback);
     // DEPRECATED: Use makeConnection instead.
@@ -175,6 +182,9 @@ class ControllerEngine : public QObject {
     bool internalExecute(QScriptValue thisObject, QScriptValue functionObject,
                          QScriptValueList arguments);
     void initializeScriptEngine();
+    // Remembers the timestamp of the input message that is about to be
+    // executed for scratchTick().
+    void setInputTimestamp(mixxx::Duration timestamp);
 
     void scriptErrorDialog(const QString& detailedError);
     void generateScriptFunctions(const QString& code);
@@ -186,9 +196,15 @@ class ControllerEngine : public QObject {
     QScriptEngine *m_pEngine;
 
     ControlObjectScript* getControlObjectScript(const QString& group, const QString& name);
+    ControlObjectScript* getControlObjectScript(int handle);
+    void setControlValue(ControlObjectScript* coScript, double newValue);
+    void setControlParameter(ControlObjectScript* coScript, double newParameter);
 
     // Scratching functions & variables
     void scratchProcess(int timerId);
+    // Feeds the scratch filter of deck with the observation for the period
+    // that ends at periodEnd.
+    void scratchObserve(int deck, mixxx::Duration periodEnd);
 
     bool isDeckPlaying(const QString& group);
     double getDeckRate(const QString& group);
@@ -198,6 +214,9 @@ class ControllerEngine : public QObject {
     QList<QString> m_scriptFunctionPrefixes;
     QMap<QString, QStringList> m_scriptErrors;
     QHash<ConfigKey, ControlObjectScript*> m_controlCache;
+    // The controls that scripts have requested handles for, indexed by handle
+    QVector<ControlObjectScript*> m_controlHandles;
+    QHash<ConfigKey, int> m_controlHandleIndices;
     struct TimerInfo {
         QScriptValue callback;
         QScriptValue context;
@@ -209,12 +228,22 @@ class ControllerEngine : public QObject {
     std::unique_ptr<ColorJSProxy> m_pColorJSProxy;
     // 256 (default) available virtual decks is enough I would think.
     //  If more are needed at run-time, these will move to the heap automatically
-    QVarLengthArray<int> m_intervalAccumulator;
+    struct ScratchTick {
+        mixxx::Duration timestamp;
+        int interval;
+    };
+    QVarLengthArray<QVector<ScratchTick>> m_scratchTicks;
     QVarLengthArray<mixxx::Duration> m_lastMovement;
+    // End of the scratch filter period that is observed next
+    QVarLengthArray<mixxx::Duration> m_scratchPeriodEnd;
     QVarLengthArray<double> m_dx, m_rampTo, m_rampFactor;
     QVarLengthArray<bool> m_ramp, m_brakeActive, m_softStartActive;
     QVarLengthArray<AlphaBetaFilter*> m_scratchFilters;
     QHash<int, int> m_scratchTimers;
+    // The time at which the input message that is currently executed has
+    // been received, if the controller reports arrival times.
+    mixxx::Duration m_inputTimestamp;
+    bool m_bInputTimestampValid;
     QHash<QString, QScriptValue> m_scriptWrappedFunctionCache;
     // Filesystem watcher for script auto-reload
     QFileSystemWatcher m_scriptWatcher;
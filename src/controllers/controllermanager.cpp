@@ -127,7 +127,10 @@ void ControllerManager::slotInitialize() {
 
     // Instantiate all enumerators. Enumerators can take a long time to
     // construct since they interact with host MIDI APIs.
-    m_enumerators.append(new PortMidiEnumerator());
+    // Read MIDI input on a dedicated thread unless disabled, this delivers it
+    // without waiting for the next poll.
+    m_enumerators.append(new PortMidiEnumerator(m_pConfig->getValue<bool>(
+            ConfigKey("[Controller]", "PortMidiInputThread"), true)));
 #ifdef __HSS1394__
     m_enumerators.append(new Hss1394Enumerator());
 #endif
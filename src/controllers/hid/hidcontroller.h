@@ -67,6 +67,11 @@ class HidController final : public Controller {
         return m_preset.isMappable();
     }
 
+    bool hasArrivalTimestamps() const override {
+        // HidReader stamps each packet when it arrives.
+        return true;
+    }
+
     bool matchPreset(const PresetInfo& preset) override;
 
     static QString safeDecodeWideString(const wchar_t* pStr, size_t max_length);
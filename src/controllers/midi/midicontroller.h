@@ -67,6 +67,21 @@ class MidiController : public Controller {
         send(data);
     }
 
+    // If enabled, short messages are not sent immediately but collected until
+    // control returns to the event loop and then sent to the device at once.
+    // The messages are sent in the order of the calls. The only exception:
+    // a message replaces the last collected message of its channel if both
+    // address the same note or control, so only the latest state of an LED
+    // is sent. Sequences like (N)RPNs or 14-bit MSB/LSB pairs are never
+    // merged or reordered, because they alternate between controls.
+    // Repeated messages for the same control without another message on
+    // the channel in between are merged though. SysEx messages flush the
+    // collected messages first. Backends that can't batch their output
+    // send immediately.
+    Q_INVOKABLE virtual void setOutputBatching(bool enabled) {
+        Q_UNUSED(enabled);
+    }
+
   protected slots:
     virtual void receive(unsigned char status, unsigned char control,
                          unsigned char value, mixxx::Duration timestamp);
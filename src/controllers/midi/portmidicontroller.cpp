@@ -10,12 +10,110 @@
 #include "controllers/midi/midiutils.h"
 #include "controllers/midi/portmidicontroller.h"
 #include "controllers/controllerdebug.h"
+#include "util/time.h"
+
+namespace {
+
+// PortMidi can not block until input arrives, so the reader polls the device.
+// A single MIDI byte takes 320 us to transmit, polling in shorter intervals
+// does not reduce the latency any further.
+const unsigned long kReaderPollIntervalMicros = 250;
+
+// After the device has been idle for this long the poll interval is doubled
+// on each idle poll, up to the longest interval the ControllerManager polls
+// with. The short interval is used again as soon as events arrive, so only
+// the first event after a pause is delayed.
+const mixxx::Duration kReaderIdleTimeout = mixxx::Duration::fromSeconds(1);
+const unsigned long kReaderMaxPollIntervalMicros = 5000;
+
+// The queue holds a few reads of the device in case the controller thread is
+// busy, e.g. with a long running script.
+const int kReaderQueueLength = 4 * MIXXX_PORTMIDI_BUFFER_LEN;
+
+} // anonymous namespace
+
+PortMidiReader::PortMidiReader(PortMidiDevice* pDevice, QMutex* pDeviceMutex)
+        : QThread(),
+          m_pDevice(pDevice),
+          m_pDeviceMutex(pDeviceMutex),
+          m_events(kReaderQueueLength),
+          m_stop(0),
+          m_notified(0) {
+}
+
+PortMidiReader::~PortMidiReader() {
+}
+
+void PortMidiReader::run() {
+    // The stop flag is cleared in the constructor and only set by stop()
+    // while shutting down, i.e. it is never reset here and a stop() before
+    // the thread has been scheduled is not lost. A relaxed load suffices:
+    // The device is only closed after wait() has returned, which orders
+    // the last access to the device in this thread before closing it.
+    unsigned long pollIntervalMicros = kReaderPollIntervalMicros;
+    mixxx::Duration lastArrival = mixxx::Time::elapsed();
+    while (m_stop.load() == 0) {
+        int numEvents = 0;
+        mixxx::Duration arrival;
+        {
+            QMutexLocker locker(m_pDeviceMutex);
+            // Returns true if events are available or an error code.
+            PmError gotEvents = m_pDevice->poll();
+            if (gotEvents < 0) {
+                qWarning() << "PortMidi error:" << Pm_GetErrorText(gotEvents);
+            } else if (gotEvents != FALSE) {
+                arrival = mixxx::Time::elapsed();
+                numEvents = m_pDevice->read(m_midiBuffer, MIXXX_PORTMIDI_BUFFER_LEN);
+                if (numEvents < 0) {
+                    qWarning() << "PortMidi error:" << Pm_GetErrorText((PmError)numEvents);
+                    numEvents = 0;
+                }
+            }
+        }
+
+        if (numEvents == 0) {
+            QThread::usleep(pollIntervalMicros);
+            if (mixxx::Time::elapsed() - lastArrival > kReaderIdleTimeout) {
+                pollIntervalMicros = math_min(2 * pollIntervalMicros,
+                        kReaderMaxPollIntervalMicros);
+            }
+            continue;
+        }
+        pollIntervalMicros = kReaderPollIntervalMicros;
+        lastArrival = arrival;
+
+        for (int i = 0; i < numEvents; ++i) {
+            m_eventBuffer[i].event = m_midiBuffer[i];
+            m_eventBuffer[i].arrival = arrival;
+        }
+        // Never block here, this would delay all events behind the busy
+        // controller thread and overflow the buffer of PortMidi instead.
+        int written = m_events.write(m_eventBuffer, numEvents);
+        if (written < numEvents) {
+            qWarning() << "PortMidiReader: Queue overflow, dropped"
+                       << numEvents - written << "MIDI events";
+        }
+        if (written > 0 && m_notified.fetchAndStoreOrdered(1) == 0) {
+            emit(eventsAvailable());
+        }
+    }
+}
+
+int PortMidiReader::readEvents(Event* pEvents, int maxEvents) {
+    // Reset before reading so that events written from now on are signaled
+    // again.
+    m_notified.fetchAndStoreOrdered(0);
+    return m_events.read(pEvents, maxEvents);
+}
 
 PortMidiController::PortMidiController(const PmDeviceInfo* inputDeviceInfo,
                                        const PmDeviceInfo* outputDeviceInfo,
                                        int inputDeviceIndex,
-                                       int outputDeviceIndex)
+                                       int outputDeviceIndex,
+                                       bool useInputThread)
         : MidiController(),
+          m_bUseInputThread(useInputThread),
+          m_bBatchOutput(false),
           m_cReceiveMsg_index(0),
           m_bInSysex(false) {
     for (unsigned int k = 0; k < MIXXX_PORTMIDI_BUFFER_LEN; ++k) {
@@ -71,6 +169,16 @@ int PortMidiController::open() {
             qWarning() << "PortMidi error:" << Pm_GetErrorText(err);
             return -2;
         }
+
+        if (m_bUseInputThread) {
+            m_pReader = std::make_unique<PortMidiReader>(
+                    m_pInputDevice.data(), &m_deviceMutex);
+            m_pReader->setObjectName(QString("PortMidiReader %1").arg(getName()));
+            connect(m_pReader.get(), SIGNAL(eventsAvailable()),
+                    this, SLOT(processReaderEvents()),
+                    Qt::QueuedConnection);
+            m_pReader->start(QThread::TimeCriticalPriority);
+        }
     }
     if (m_pOutputDevice && isOutputDevice()) {
         controllerDebug("PortMidiController: Opening"
@@ -95,8 +203,10 @@ int PortMidiController::close() {
         return -1;
     }
 
+    stopReader();
     stopEngine();
     MidiController::close();
+    flushOutputBatch();
 
     int result = 0;
 
@@ -125,6 +235,10 @@ bool PortMidiController::poll() {
     if (m_pInputDevice.isNull() || !m_pInputDevice->isOpen()) {
         return false;
     }
+    // The input is read by m_pReader
+    if (m_pReader) {
+        return false;
+    }
 
     // Returns true if events are available or an error code.
     PmError gotEvents = m_pInputDevice->poll();
@@ -146,62 +260,92 @@ bool PortMidiController::poll() {
     }
 
     for (int i = 0; i < numEvents; i++) {
-        unsigned char status = Pm_MessageStatus(m_midiBuffer[i].message);
-        mixxx::Duration timestamp = mixxx::Duration::fromMillis(m_midiBuffer[i].timestamp);
+        processEvent(m_midiBuffer[i],
+                mixxx::Duration::fromMillis(m_midiBuffer[i].timestamp));
+    }
+    return numEvents > 0;
+}
 
-        if ((status & 0xF8) == 0xF8) {
-            // Handle real-time MIDI messages at any time
-            receive(status, 0, 0, timestamp);
-            continue;
+void PortMidiController::processReaderEvents() {
+    if (!m_pReader) {
+        return;
+    }
+    int numEvents;
+    while ((numEvents = m_pReader->readEvents(
+            m_readerEvents, MIXXX_PORTMIDI_BUFFER_LEN)) > 0) {
+        for (int i = 0; i < numEvents; i++) {
+            processEvent(m_readerEvents[i].event, m_readerEvents[i].arrival);
         }
+    }
+}
 
-        reprocessMessage:
-
-        if (!m_bInSysex) {
-            if (status == 0xF0) {
-                m_bInSysex = true;
-                status = 0;
-            } else {
-                //unsigned char channel = status & 0x0F;
-                unsigned char note = Pm_MessageData1(m_midiBuffer[i].message);
-                unsigned char velocity = Pm_MessageData2(m_midiBuffer[i].message);
-                receive(status, note, velocity, timestamp);
-            }
+void PortMidiController::stopReader() {
+    if (!m_pReader) {
+        return;
+    }
+    disconnect(m_pReader.get(), SIGNAL(eventsAvailable()),
+               this, SLOT(processReaderEvents()));
+    m_pReader->stop();
+    controllerDebug("  Waiting on reader to finish");
+    m_pReader->wait();
+    m_pReader.reset();
+}
+
+void PortMidiController::processEvent(const PmEvent& event,
+                                      mixxx::Duration timestamp) {
+    unsigned char status = Pm_MessageStatus(event.message);
+
+    if ((status & 0xF8) == 0xF8) {
+        // Handle real-time MIDI messages at any time
+        receive(status, 0, 0, timestamp);
+        return;
+    }
+
+    reprocessMessage:
+
+    if (!m_bInSysex) {
+        if (status == 0xF0) {
+            m_bInSysex = true;
+            status = 0;
+        } else {
+            //unsigned char channel = status & 0x0F;
+            unsigned char note = Pm_MessageData1(event.message);
+            unsigned char velocity = Pm_MessageData2(event.message);
+            receive(status, note, velocity, timestamp);
         }
+    }
 
-        if (m_bInSysex) {
-            // Abort (drop) the current System Exclusive message if a
-            //  non-realtime status byte was received
-            if (status > 0x7F && status < 0xF7) {
-                m_bInSysex = false;
-                m_cReceiveMsg_index = 0;
-                qWarning() << "Buggy MIDI device: SysEx interrupted!";
-                goto reprocessMessage;    // Don't lose the new message
-            }
+    if (m_bInSysex) {
+        // Abort (drop) the current System Exclusive message if a
+        //  non-realtime status byte was received
+        if (status > 0x7F && status < 0xF7) {
+            m_bInSysex = false;
+            m_cReceiveMsg_index = 0;
+            qWarning() << "Buggy MIDI device: SysEx interrupted!";
+            goto reprocessMessage;    // Don't lose the new message
+        }
 
-            // Collect bytes from PmMessage
-            unsigned char data = 0;
-            for (int shift = 0; shift < 32 && (data != MIDI_EOX); shift += 8) {
-                // TODO(rryan): This prevents buffer overflow if the sysex is
-                // larger than 1024 bytes. I don't want to radically change
-                // anything before the 2.0 release so this will do for now.
-                data = (m_midiBuffer[i].message >> shift) & 0xFF;
-                if (m_cReceiveMsg_index < MIXXX_SYSEX_BUFFER_LEN) {
-                    m_cReceiveMsg[m_cReceiveMsg_index++] = data;
-                }
+        // Collect bytes from PmMessage
+        unsigned char data = 0;
+        for (int shift = 0; shift < 32 && (data != MIDI_EOX); shift += 8) {
+            // TODO(rryan): This prevents buffer overflow if the sysex is
+            // larger than 1024 bytes. I don't want to radically change
+            // anything before the 2.0 release so this will do for now.
+            data = (event.message >> shift) & 0xFF;
+            if (m_cReceiveMsg_index < MIXXX_SYSEX_BUFFER_LEN) {
+                m_cReceiveMsg[m_cReceiveMsg_index++] = data;
             }
+        }
 
-            // End System Exclusive message if the EOX byte was received
-            if (data == MIDI_EOX) {
-                m_bInSysex = false;
-                const char* buffer = reinterpret_cast<const char*>(m_cReceiveMsg);
-                receive(QByteArray::fromRawData(buffer, m_cReceiveMsg_index),
-                        timestamp);
-                m_cReceiveMsg_index = 0;
-            }
+        // End System Exclusive message if the EOX byte was received
+        if (data == MIDI_EOX) {
+            m_bInSysex = false;
+            const char* buffer = reinterpret_cast<const char*>(m_cReceiveMsg);
+            receive(QByteArray::fromRawData(buffer, m_cReceiveMsg_index),
+                    timestamp);
+            m_cReceiveMsg_index = 0;
         }
     }
-    return numEvents > 0;
 }
 
 void PortMidiController::sendShortMsg(unsigned char status, unsigned char byte1,
@@ -213,7 +357,16 @@ void PortMidiController::sendShortMsg(unsigned char status, unsigned char byte1,
     unsigned int word = (((unsigned int)byte2) << 16) |
                          (((unsigned int)byte1) << 8) | status;
 
-    PmError err = m_pOutputDevice->writeShort(word);
+    if (m_bBatchOutput) {
+        queueShortMsg(word, status, byte1);
+        return;
+    }
+
+    PmError err;
+    {
+        QMutexLocker locker(m_bUseInputThread ? &m_deviceMutex : nullptr);
+        err = m_pOutputDevice->writeShort(word);
+    }
     if (err == pmNoError) {
         controllerDebug(MidiUtils::formatMidiMessage(getName(),
                                                      status, byte1, byte2,
@@ -244,7 +397,14 @@ void PortMidiController::send(QByteArray data) {
         return;
     }
 
-    PmError err = m_pOutputDevice->writeSysEx((unsigned char*)data.constData());
+    // Keep the order of the messages
+    flushOutputBatch();
+
+    PmError err;
+    {
+        QMutexLocker locker(m_bUseInputThread ? &m_deviceMutex : nullptr);
+        err = m_pOutputDevice->writeSysEx((unsigned char*)data.constData());
+    }
     if (err == pmNoError) {
         controllerDebug(MidiUtils::formatSysexMessage(getName(), data));
     } else {
@@ -254,3 +414,75 @@ void PortMidiController::send(QByteArray data) {
         qWarning() << "PortMidi error:" << Pm_GetErrorText(err);
     }
 }
+
+void PortMidiController::setOutputBatching(bool enabled) {
+    if (!enabled) {
+        flushOutputBatch();
+    }
+    m_bBatchOutput = enabled;
+}
+
+void PortMidiController::queueShortMsg(PmMessage message, unsigned char status,
+                                       unsigned char byte1) {
+    MidiOpCode opCode = MidiUtils::opCodeFromStatus(status);
+    if (opCode >= MIDI_SYSEX) {
+        // Keep the order of the channel messages around system messages
+        for (auto& lastMessage : m_lastBatchedMessages) {
+            lastMessage.index = -1;
+        }
+    } else {
+        // Note on and note off address the same LED. For the other channel
+        // messages only the ones with a note or control number in the first
+        // data byte are told apart by it.
+        if (opCode == MIDI_NOTE_OFF) {
+            status = MIDI_NOTE_ON | MidiUtils::channelFromStatus(status);
+        } else if (opCode != MIDI_NOTE_ON && opCode != MIDI_AFTERTOUCH &&
+                opCode != MIDI_CC) {
+            byte1 = 0;
+        }
+        const uint16_t key = (static_cast<uint16_t>(status) << 8) | byte1;
+        // Only the last message of a channel is replaced. Otherwise ordered
+        // sequences like (N)RPNs or 14-bit controls would be reordered.
+        BatchedMessage& lastMessage =
+                m_lastBatchedMessages[MidiUtils::channelFromStatus(status)];
+        if (lastMessage.index >= 0 && lastMessage.key == key) {
+            m_outputBatch[lastMessage.index].message = message;
+            return;
+        }
+        lastMessage.index = m_outputBatch.size();
+        lastMessage.key = key;
+    }
+
+    PmEvent event;
+    event.message = message;
+    event.timestamp = 0;
+    m_outputBatch.append(event);
+    if (m_outputBatch.size() == 1) {
+        QMetaObject::invokeMethod(this, "flushOutputBatch", Qt::QueuedConnection);
+    }
+}
+
+void PortMidiController::flushOutputBatch() {
+    if (m_outputBatch.isEmpty()) {
+        return;
+    }
+    if (!m_pOutputDevice.isNull() && m_pOutputDevice->isOpen()) {
+        PmError err;
+        {
+            QMutexLocker locker(m_bUseInputThread ? &m_deviceMutex : nullptr);
+            err = m_pOutputDevice->write(m_outputBatch.data(), m_outputBatch.size());
+        }
+        if (err == pmNoError) {
+            controllerDebug("PortMidiController: Sent" << m_outputBatch.size()
+                            << "short messages to" << getName());
+        } else {
+            qWarning() << "Error sending" << m_outputBatch.size()
+                       << "short messages to" << getName();
+            qWarning() << "PortMidi error:" << Pm_GetErrorText(err);
+        }
+    }
+    m_outputBatch.clear();
+    for (auto& lastMessage : m_lastBatchedMessages) {
+        lastMessage.index = -1;
+    }
+}
@@ -19,10 +19,17 @@
 
 #include <portmidi.h>
 
+#include <QAtomicInt>
+#include <QMutex>
 #include <QScopedPointer>
+#include <QThread>
+#include <QVector>
 
 #include "controllers/midi/midicontroller.h"
 #include "controllers/midi/portmididevice.h"
+#include "util/duration.h"
+#include "util/fifo.h"
+#include "util/memory.h"
 
 // Note:
 // A standard Midi device runs at 31.25 kbps, with 10 bits / byte
@@ -55,25 +62,80 @@
 // String to display for no MIDI devices present
 #define MIXXX_PORTMIDI_NO_DEVICE_STRING "None"
 
+// Reads the input of a PortMidiDevice on a dedicated thread. Each event is
+// stamped with the time it arrived and pushed into a lock-free queue that is
+// drained by the controller thread, so that input is not delayed until the next
+// poll of the ControllerManager.
+class PortMidiReader : public QThread {
+    Q_OBJECT
+  public:
+    struct Event {
+        PmEvent event;
+        mixxx::Duration arrival;
+    };
+
+    // pDeviceMutex serializes the access to PortMidi with the sending thread.
+    PortMidiReader(PortMidiDevice* pDevice, QMutex* pDeviceMutex);
+    ~PortMidiReader() override;
+
+    void stop() {
+        m_stop = 1;
+    }
+
+    // Moves up to maxEvents queued events into pEvents and returns their
+    // number. Must only be called by a single consumer.
+    int readEvents(Event* pEvents, int maxEvents);
+
+  signals:
+    // Emitted when events have been queued. Not emitted again before the
+    // consumer has called readEvents().
+    void eventsAvailable();
+
+  protected:
+    void run() override;
+
+  private:
+    PortMidiDevice* m_pDevice;
+    QMutex* m_pDeviceMutex;
+    FIFO<Event> m_events;
+    PmEvent m_midiBuffer[MIXXX_PORTMIDI_BUFFER_LEN];
+    Event m_eventBuffer[MIXXX_PORTMIDI_BUFFER_LEN];
+    QAtomicInt m_stop;
+    QAtomicInt m_notified;
+};
+
 // A PortMidi-based implementation of MidiController
 class PortMidiController : public MidiController {
     Q_OBJECT
   public:
+    // If useInputThread is set the input is read by a PortMidiReader instead
+    // of being polled by the ControllerManager.
     PortMidiController(const PmDeviceInfo* inputDeviceInfo,
                        const PmDeviceInfo* outputDeviceInfo,
                        int inputDeviceIndex,
-                       int outputDeviceIndex);
+                       int outputDeviceIndex,
+                       bool useInputThread = false);
     ~PortMidiController() override;
 
+    bool hasArrivalTimestamps() const override {
+        return m_bUseInputThread;
+    }
+
   private slots:
     int open() override;
     int close() override;
     bool poll() override;
+    // Processes the events that the PortMidiReader has queued.
+    void processReaderEvents();
+    // Sends the short messages that have been collected while output batching
+    // is enabled with a single write.
+    void flushOutputBatch();
 
   protected:
     // MockPortMidiController needs this to not be private.
     void sendShortMsg(unsigned char status, unsigned char byte1,
                       unsigned char byte2) override;
+    void setOutputBatching(bool enabled) override;
 
   private:
     // The sysex data must already contain the start byte 0xf0 and the end byte
@@ -81,9 +143,15 @@ class PortMidiController : public MidiController {
     void send(QByteArray data) override;
 
     bool isPolling() const override {
-        return true;
+        return !m_bUseInputThread;
     }
 
+    // Handles a single event that has been read from the input device.
+    void processEvent(const PmEvent& event, mixxx::Duration timestamp);
+    void queueShortMsg(PmMessage message, unsigned char status,
+                       unsigned char byte1);
+    void stopReader();
+
     // For testing only so that test fixtures can install mock PortMidiDevices.
     void setPortMidiInputDevice(PortMidiDevice* device) {
         m_pInputDevice.reset(device);
@@ -94,8 +162,29 @@ class PortMidiController : public MidiController {
 
     QScopedPointer<PortMidiDevice> m_pInputDevice;
     QScopedPointer<PortMidiDevice> m_pOutputDevice;
+    // Held while a device is accessed if the input is read by m_pReader.
+    QMutex m_deviceMutex;
+
+    const bool m_bUseInputThread;
+    std::unique_ptr<PortMidiReader> m_pReader;
 
     PmEvent m_midiBuffer[MIXXX_PORTMIDI_BUFFER_LEN];
+    PortMidiReader::Event m_readerEvents[MIXXX_PORTMIDI_BUFFER_LEN];
+
+    bool m_bBatchOutput;
+    QVector<PmEvent> m_outputBatch;
+    struct BatchedMessage {
+        BatchedMessage()
+                : index(-1),
+                  key(0) {
+        }
+        // Index in m_outputBatch or -1
+        int index;
+        // Status and note/control number
+        uint16_t key;
+    };
+    // The last message in m_outputBatch for each MIDI channel
+    BatchedMessage m_lastBatchedMessages[16];
 
     // Storage for SysEx messages
     unsigned char m_cReceiveMsg[MIXXX_SYSEX_BUFFER_LEN];
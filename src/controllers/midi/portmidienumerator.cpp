@@ -21,7 +21,9 @@ bool shouldBlacklistDevice(const PmDeviceInfo* device) {
             deviceName.startsWith("Midi Through Port", Qt::CaseInsensitive);
 }
 
-PortMidiEnumerator::PortMidiEnumerator() : MidiEnumerator() {
+PortMidiEnumerator::PortMidiEnumerator(bool useInputThread)
+        : MidiEnumerator(),
+          m_bUseInputThread(useInputThread) {
     PmError err = Pm_Initialize();
     // Based on reading the source, it's not possible for this to fail.
     if (err != pmNoError) {
@@ -259,7 +261,7 @@ QList<Controller*> PortMidiEnumerator::queryDevices() {
             //.... so create our (aggregate) MIDI device!
             PortMidiController *currentDevice = new PortMidiController(
                 inputDeviceInfo, outputDeviceInfo,
-                inputDevIndex, outputDevIndex);
+                inputDevIndex, outputDevIndex, m_bUseInputThread);
             m_devices.push_back(currentDevice);
         }
 
@@ -13,13 +13,16 @@
 class PortMidiEnumerator : public MidiEnumerator {
     Q_OBJECT
   public:
-    PortMidiEnumerator();
+    // If useInputThread is set the input of the devices is read on a
+    // dedicated thread instead of being polled.
+    explicit PortMidiEnumerator(bool useInputThread = false);
     virtual ~PortMidiEnumerator();
 
     QList<Controller*> queryDevices();
 
   private:
     QList<Controller*> m_devices;
+    const bool m_bUseInputThread;
 };
 
 // For testing.
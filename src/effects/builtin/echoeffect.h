@@ -25,10 +25,29 @@ class EchoGroupState : public EffectState {
     }
 
     void audioParametersChanged(const mixxx::EngineParameters bufferParameters) {
-        delay_buf = mixxx::SampleBuffer(kMaxDelaySeconds
-                * bufferParameters.sampleRate() * bufferParameters.channelCount());
+        delay_buf = mixxx::SampleBuffer(delayBufferSize(bufferParameters));
     };
 
+    bool isRecyclable() const override {
+        return true;
+    }
+
+    void reset(const mixxx::EngineParameters& bufferParameters) override {
+        if (delay_buf.size() != delayBufferSize(bufferParameters)) {
+            audioParametersChanged(bufferParameters);
+        }
+        clear();
+    }
+
+    std::size_t allocatedBytes() const override {
+        return delay_buf.size() * sizeof(CSAMPLE);
+    }
+
+    static SINT delayBufferSize(const mixxx::EngineParameters& bufferParameters) {
+        return kMaxDelaySeconds
+                * bufferParameters.sampleRate() * bufferParameters.channelCount();
+    }
+
     void clear() {
         delay_buf.clear();
         prev_send = 0.0f;
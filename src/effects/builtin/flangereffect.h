@@ -25,17 +25,30 @@ constexpr double kMaxLfoBeats = 32.0;
 
 struct FlangerGroupState : public EffectState {
     FlangerGroupState(const mixxx::EngineParameters& bufferParameters)
-            : EffectState(bufferParameters),
-              delayPos(0),
-              lfoFrames(0),
-              previousPeriodFrames(-1),
-              prev_regen(0),
-              prev_mix(0),
-              prev_width(0),
-              prev_manual(kCenterDelayMs) {
+            : EffectState(bufferParameters) {
+        clear();
+    }
+
+    void clear() {
+        delayPos = 0;
+        lfoFrames = 0;
+        previousPeriodFrames = -1;
+        prev_regen = 0;
+        prev_mix = 0;
+        prev_width = 0;
+        prev_manual = kCenterDelayMs;
         SampleUtil::clear(delayLeft, kBufferLenth);
         SampleUtil::clear(delayRight, kBufferLenth);
     }
+
+    bool isRecyclable() const override {
+        return true;
+    }
+
+    void reset(const mixxx::EngineParameters& bufferParameters) override {
+        Q_UNUSED(bufferParameters);
+        clear();
+    }
     CSAMPLE delayLeft[kBufferLenth];
     CSAMPLE delayRight[kBufferLenth];
     unsigned int delayPos;
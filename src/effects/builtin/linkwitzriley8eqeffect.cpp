@@ -1,6 +1,7 @@
 #include "effects/builtin/linkwitzriley8eqeffect.h"
 
 #include "effects/builtin/equalizer_util.h"
+#include "engine/filters/enginefilteriirbank.h"
 #include "util/math.h"
 
 static const unsigned int kStartupSamplerate = 44100;
@@ -111,8 +112,11 @@ void LinkwitzRiley8EQEffect::processChannel(const ChannelHandle& handle,
         pState->setFilters(bufferParameters.sampleRate(), pState->m_loFreq, pState->m_hiFreq);
     }
 
-    pState->m_high2->process(pInput, pState->m_pHighBuf, bufferParameters.samplesPerBuffer()); // HighPass first run
-    pState->m_low2->process(pInput, pState->m_pLowBuf, bufferParameters.samplesPerBuffer()); // LowPass first run for low and bandpass
+    // HighPass first run and LowPass first run for low and bandpass
+    EngineFilterIIRBank::process(
+            pState->m_high2, pInput, pState->m_pHighBuf,
+            pState->m_low2, pInput, pState->m_pLowBuf,
+            bufferParameters.samplesPerBuffer());
 
     if (fMid != pState->old_mid || fHigh != pState->old_high) {
         SampleUtil::applyRampingGain(pState->m_pHighBuf,
@@ -128,8 +132,11 @@ void LinkwitzRiley8EQEffect::processChannel(const ChannelHandle& handle,
                                 bufferParameters.samplesPerBuffer());
     }
 
-    pState->m_high1->process(pState->m_pHighBuf, pState->m_pMidBuf, bufferParameters.samplesPerBuffer()); // HighPass + BandPass second run
-    pState->m_low1->process(pState->m_pLowBuf, pState->m_pLowBuf, bufferParameters.samplesPerBuffer()); // LowPass second run
+    // HighPass + BandPass second run and LowPass second run
+    EngineFilterIIRBank::process(
+            pState->m_high1, pState->m_pHighBuf, pState->m_pMidBuf,
+            pState->m_low1, pState->m_pLowBuf, pState->m_pLowBuf,
+            bufferParameters.samplesPerBuffer());
 
     if (fLow != pState->old_low) {
         SampleUtil::copy2WithRampingGain(pOutput,
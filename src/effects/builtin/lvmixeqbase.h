@@ -3,6 +3,7 @@
 
 #include "effects/effectprocessor.h"
 #include "engine/filters/enginefilterdelay.h"
+#include "engine/filters/enginefilteriirbank.h"
 #include "util/defs.h"
 #include "util/math.h"
 #include "util/sample.h"
@@ -87,12 +88,20 @@ class LVMixEQEffectGroupState : public EffectState {
             m_delay3->process(pInput, m_pHighBuf, numSamples);
         }
 
-        if (fMid || m_oldMid) {
+        const bool processMid = fMid || m_oldMid;
+        const bool processLow = fLow || m_oldLow;
+        if (processMid) {
             m_delay2->process(pInput, m_pBandBuf, numSamples);
-            m_low2->process(m_pBandBuf, m_pBandBuf, numSamples);
         }
-
-        if (fLow || m_oldLow) {
+        if (processMid && processLow) {
+            // Both low passes run in parallel
+            EngineFilterIIRBank::process(
+                    m_low2, m_pBandBuf, m_pBandBuf,
+                    m_low1, pInput, m_pLowBuf,
+                    numSamples);
+        } else if (processMid) {
+            m_low2->process(m_pBandBuf, m_pBandBuf, numSamples);
+        } else if (processLow) {
             m_low1->process(pInput, m_pLowBuf, numSamples);
         }
 
@@ -28,6 +28,15 @@ class PhaserGroupState final : public EffectState {
         SampleUtil::clear(oldOutRight, MAXSTAGES);
     }
 
+    bool isRecyclable() const override {
+        return true;
+    }
+
+    void reset(const mixxx::EngineParameters& bufferParameters) override {
+        Q_UNUSED(bufferParameters);
+        clear();
+    }
+
     CSAMPLE oldInLeft[MAXSTAGES];
     CSAMPLE oldInRight[MAXSTAGES];
     CSAMPLE oldOutLeft[MAXSTAGES];
@@ -28,6 +28,17 @@ class ReverbGroupState : public EffectState {
         sendPrevious = 0;
     }
 
+    bool isRecyclable() const override {
+        return true;
+    }
+
+    // The reverb itself is initialized by ReverbEffect::processChannel
+    // when the state is enabled.
+    void reset(const mixxx::EngineParameters& bufferParameters) override {
+        Q_UNUSED(bufferParameters);
+        sendPrevious = 0;
+    }
+
     float sampleRate;
     float sendPrevious;
     MixxxPlateX2 reverb{};
@@ -34,6 +34,10 @@ enum class EffectChainMixMode {
 
 constexpr int kNumEffectsPerUnit = 4;
 
+// The number of input channels for which recyclable EffectStates are
+// preallocated when an effect is loaded, see EffectProcessorImpl.
+constexpr int kEffectStatePoolInputChannels = 8;
+
 // NOTE: Setting this to true will enable string manipulation and calls to
 // qDebug() in the audio engine thread. That may cause audio dropouts, so only
 // enable this when debugging the effects system.
@@ -44,6 +44,13 @@ EffectState* Effect::createState(const mixxx::EngineParameters& bufferParameters
     return m_pEngineEffect->createState(bufferParameters);
 }
 
+std::size_t Effect::stateMemoryBytes() const {
+    if (!m_pEngineEffect) {
+        return 0;
+    }
+    return m_pEngineEffect->stateMemoryBytes();
+}
+
 void Effect::addToEngine(EngineEffectChain* pChain, int iIndex,
                          const QSet<ChannelHandleAndGroup>& activeInputChannels) {
     VERIFY_OR_DEBUG_ASSERT(pChain) {
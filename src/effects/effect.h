@@ -32,6 +32,9 @@ class Effect : public QObject {
     virtual ~Effect();
 
     EffectState* createState(const mixxx::EngineParameters& bufferParameters);
+    // The memory of all EffectStates of this effect, 0 if it has not
+    // been added to the engine.
+    std::size_t stateMemoryBytes() const;
 
     EffectManifestPointer getManifest() const;
 
@@ -311,6 +311,16 @@ unsigned int EffectChain::numEffects() const {
     return m_effects.size();
 }
 
+std::size_t EffectChain::stateMemoryBytes() const {
+    std::size_t bytes = 0;
+    for (const EffectPointer& pEffect : m_effects) {
+        if (pEffect) {
+            bytes += pEffect->stateMemoryBytes();
+        }
+    }
+    return bytes;
+}
+
 const QList<EffectPointer>& EffectChain::effects() const {
     return m_effects;
 }
@@ -87,6 +87,8 @@ class EffectChain : public QObject {
 
     const QList<EffectPointer>& effects() const;
     unsigned int numEffects() const;
+    // The total memory of the EffectStates of all effects in this chain
+    std::size_t stateMemoryBytes() const;
 
     EngineEffectChain* getEngineEffectChain();
 
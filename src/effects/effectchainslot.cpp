@@ -27,6 +27,9 @@ EffectChainSlot::EffectChainSlot(EffectRack* pRack, const QString& group,
     m_pControlNumEffectSlots = new ControlObject(ConfigKey(m_group, "num_effectslots"));
     m_pControlNumEffectSlots->setReadOnly();
 
+    m_pControlStateMemoryBytes = new ControlObject(ConfigKey(m_group, "state_memory_bytes"));
+    m_pControlStateMemoryBytes->setReadOnly();
+
     m_pControlChainLoaded = new ControlObject(ConfigKey(m_group, "loaded"));
     m_pControlChainLoaded->setReadOnly();
 
@@ -94,6 +97,7 @@ EffectChainSlot::~EffectChainSlot() {
     delete m_pControlClear;
     delete m_pControlNumEffects;
     delete m_pControlNumEffectSlots;
+    delete m_pControlStateMemoryBytes;
     delete m_pControlChainLoaded;
     delete m_pControlChainEnabled;
     delete m_pControlChainMix;
@@ -159,6 +163,7 @@ void EffectChainSlot::slotChainChannelStatusChanged(const QString& group,
     ChannelInfo* pInfo = m_channelInfoByName.value(group, NULL);
     if (pInfo != NULL && pInfo->pEnabled != NULL) {
         pInfo->pEnabled->set(enabled);
+        updateStateMemoryBytes();
         emit(updated());
     }
 }
@@ -188,6 +193,7 @@ void EffectChainSlot::slotChainEffectChanged(unsigned int effectSlotNumber,
         m_pControlNumEffects->forceSet(math_min(
                 static_cast<unsigned int>(m_slots.size()),
                 m_pEffectChain->numEffects()));
+        updateStateMemoryBytes();
 
         if (shouldEmit) {
             emit(updated());
@@ -245,6 +251,16 @@ void EffectChainSlot::updateRoutingSwitches() {
             m_pEffectChain->disableForInputChannel(pChannelInfo->handle_group);
         }
     }
+    updateStateMemoryBytes();
+}
+
+void EffectChainSlot::updateStateMemoryBytes() {
+    if (m_pEffectChain) {
+        m_pControlStateMemoryBytes->forceSet(
+                static_cast<double>(m_pEffectChain->stateMemoryBytes()));
+    } else {
+        m_pControlStateMemoryBytes->forceSet(0.0);
+    }
 }
 
 EffectChainPointer EffectChainSlot::getEffectChain() const {
@@ -278,6 +294,7 @@ void EffectChainSlot::clear() {
         m_pEffectChain.clear();
     }
     m_pControlNumEffects->forceSet(0.0);
+    m_pControlStateMemoryBytes->forceSet(0.0);
     m_pControlChainLoaded->forceSet(0.0);
     m_pControlChainMixMode->set(
             static_cast<double>(EffectChainMixMode::DrySlashWet));
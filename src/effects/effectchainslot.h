@@ -121,6 +121,9 @@ class EffectChainSlot : public QObject {
         return QString("EffectChainSlot(%1)").arg(m_group);
     }
 
+    // Refreshes the state_memory_bytes control from the loaded chain
+    void updateStateMemoryBytes();
+
     const unsigned int m_iChainSlotNumber;
     const QString m_group;
     EffectRack* m_pEffectRack;
@@ -130,6 +133,7 @@ class EffectChainSlot : public QObject {
     ControlPushButton* m_pControlClear;
     ControlObject* m_pControlNumEffects;
     ControlObject* m_pControlNumEffectSlots;
+    ControlObject* m_pControlStateMemoryBytes;
     ControlObject* m_pControlChainLoaded;
     ControlPushButton* m_pControlChainEnabled;
     ControlObject* m_pControlChainMix;
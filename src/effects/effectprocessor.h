@@ -2,11 +2,15 @@
 #ifndef EFFECTPROCESSOR_H
 #define EFFECTPROCESSOR_H
 
+#include <atomic>
+#include <vector>
+
 #include <QString>
 #include <QHash>
 #include <QDebug>
 #include <QPair>
 
+#include "util/math.h"
 #include "util/types.h"
 #include "engine/engine.h"
 #include "effects/defs.h"
@@ -38,6 +42,12 @@ class EngineEffect;
 // EffectStates are only allocated for input signals that are enabled at that
 // time. This allows for scaling up to an arbitrary number of input signals
 // without wasting a lot of memory.
+//
+// EffectStates that opt in by overriding isRecyclable() are not deleted when
+// an input signal is disabled but kept in a pool of the EffectProcessorImpl
+// and reused when an input signal is enabled again. The pool is prefilled
+// when the effect is loaded, so toggling the routing switches of a chain
+// does not allocate memory for these effects.
 class EffectState {
   public:
     EffectState(const mixxx::EngineParameters& bufferParameters) {
@@ -45,6 +55,23 @@ class EffectState {
         Q_UNUSED(bufferParameters);
     };
     virtual ~EffectState() {};
+
+    // Recyclable states must implement reset().
+    virtual bool isRecyclable() const {
+        return false;
+    }
+    // Called from the main thread before a recycled state is reused. Must
+    // restore the state of a newly constructed EffectState, i.e. clear all
+    // signal history. May reallocate if the buffer parameters require it.
+    virtual void reset(const mixxx::EngineParameters& bufferParameters) {
+        Q_UNUSED(bufferParameters);
+    }
+
+    // Memory that is owned by this state in addition to its own size,
+    // e.g. delay lines that are allocated on the heap.
+    virtual std::size_t allocatedBytes() const {
+        return 0;
+    }
 };
 
 // EffectProcessor is an abstract base class for interfacing with the main
@@ -66,6 +93,12 @@ class EffectProcessor {
     // callback executes process() with EffectEnableState::Disabling
     virtual void deleteStatesForInputChannel(const ChannelHandle* inputChannel) = 0;
 
+    // The total memory of all EffectStates owned by this processor including
+    // recycled states that are currently unused. Thread-safe.
+    virtual std::size_t stateMemoryBytes() const {
+        return 0;
+    }
+
     // Take a buffer of audio samples as pInput, process the buffer according to
     // Effect-specific logic, and output it to the buffer pOutput. Both pInput
     // and pOutput are represented as stereo interleaved samples for now, but
@@ -92,7 +125,8 @@ template <typename EffectSpecificState>
 class EffectProcessorImpl : public EffectProcessor {
   public:
     EffectProcessorImpl()
-      : m_pEffectsManager(nullptr) {
+      : m_pEffectsManager(nullptr),
+        m_stateMemoryBytes(0) {
     }
     // Subclasses should not implement their own destructor. All state should
     // be stored in the EffectState subclass, not the EffectProcessorImpl subclass.
@@ -112,13 +146,17 @@ class EffectProcessorImpl : public EffectProcessor {
                              << "for input ChannelHandle(" << inputChannelHandleNumber << ")"
                              << "and output ChannelHandle(" << outputChannelHandleNumber << ")";
                 }
-                delete pState;
+                destroySpecificState(pState);
                 outputChannelHandleNumber++;
             }
             outputsMap.clear();
             inputChannelHandleNumber++;
         }
         m_channelStateMatrix.clear();
+        for (EffectSpecificState* pState : m_statePool) {
+            destroySpecificState(pState);
+        }
+        m_statePool.clear();
     };
 
     // NOTE: Subclasses must implement the following static methods for
@@ -151,7 +189,7 @@ class EffectProcessorImpl : public EffectProcessor {
                            << "EffectState should have been preallocated in the"
                               "main thread.";
             }
-            pState = createSpecificState(bufferParameters);
+            pState = allocateSpecificState(bufferParameters);
             m_channelStateMatrix[inputHandle][outputHandle] = pState;
         }
         processChannel(inputHandle, pState, pInput, pOutput, bufferParameters,
@@ -170,7 +208,7 @@ class EffectProcessorImpl : public EffectProcessor {
             for (const ChannelHandleAndGroup& outputChannel :
                     pEffectsManager->registeredOutputChannels()) {
                 outputChannelMap.insert(outputChannel.handle(),
-                        createSpecificState(bufferParameters));
+                        allocateSpecificState(bufferParameters));
                 if (kEffectDebugOutput) {
                     qDebug() << this << "EffectProcessorImpl::initialize "
                                 "registering output" << outputChannel << outputChannelMap[outputChannel.handle()];
@@ -180,10 +218,25 @@ class EffectProcessorImpl : public EffectProcessor {
         }
         m_pEffectsManager = pEffectsManager;
         DEBUG_ASSERT(m_pEffectsManager != nullptr);
+        preallocateStatePool(activeInputChannels, bufferParameters);
     };
 
+    // Reuses a recycled state if available
     EffectState* createState(const mixxx::EngineParameters& bufferParameters) final {
-        return createSpecificState(bufferParameters);
+        if (!m_statePool.empty()) {
+            EffectSpecificState* pState = m_statePool.back();
+            m_statePool.pop_back();
+            const std::size_t bytesBefore = stateBytes(pState);
+            pState->reset(bufferParameters);
+            const std::size_t bytesAfter = stateBytes(pState);
+            m_stateMemoryBytes.fetch_add(bytesAfter);
+            m_stateMemoryBytes.fetch_sub(bytesBefore);
+            if (kEffectDebugOutput) {
+                qDebug() << this << "EffectProcessorImpl recycling EffectState" << pState;
+            }
+            return pState;
+        }
+        return allocateSpecificState(bufferParameters);
     };
 
     bool loadStatesForInputChannel(const ChannelHandle* inputChannel,
@@ -213,7 +266,7 @@ class EffectProcessorImpl : public EffectProcessor {
           // not go through any iterations.
           for (EffectSpecificState* pState : effectSpecificStatesMap) {
               VERIFY_OR_DEBUG_ASSERT(pState == nullptr) {
-                  delete pState;
+                  destroySpecificState(pState);
               }
           }
 
@@ -253,27 +306,76 @@ class EffectProcessorImpl : public EffectProcessor {
                 VERIFY_OR_DEBUG_ASSERT(pState != nullptr) {
                       continue;
                 }
+                if (pState->isRecyclable()) {
+                      if (kEffectDebugOutput) {
+                            qDebug() << "EffectProcessorImpl::deleteStatesForInputChannel"
+                                     << this << "recycling state" << pState;
+                      }
+                      m_statePool.push_back(pState);
+                      continue;
+                }
                 if (kEffectDebugOutput) {
                       qDebug() << "EffectProcessorImpl::deleteStatesForInputChannel"
                                << this << "deleting state" << pState;
                 }
-                delete pState;
+                destroySpecificState(pState);
           }
           stateMap.clear();
     };
 
+    std::size_t stateMemoryBytes() const final {
+        return m_stateMemoryBytes.load();
+    }
+
   private:
+    static std::size_t stateBytes(const EffectSpecificState* pState) {
+        return sizeof(EffectSpecificState) + pState->allocatedBytes();
+    }
+
+    // Fills the pool with states for the inputs that may be enabled later,
+    // up to kEffectStatePoolInputChannels inputs in total. Does nothing if
+    // the states of this effect are not recyclable.
+    void preallocateStatePool(
+            const QSet<ChannelHandleAndGroup>& activeInputChannels,
+            const mixxx::EngineParameters& bufferParameters) {
+        const int numOutputChannels =
+                m_pEffectsManager->registeredOutputChannels().size();
+        const int numInputChannels =
+                m_pEffectsManager->registeredInputChannels().size();
+        // Reserve the maximum size up front, so recycling never reallocates
+        m_statePool.reserve(numInputChannels * numOutputChannels);
+        const int numPreallocatedInputChannels =
+                math_min(numInputChannels, kEffectStatePoolInputChannels) -
+                activeInputChannels.size();
+        for (int i = 0; i < numPreallocatedInputChannels * numOutputChannels; ++i) {
+            EffectSpecificState* pState = allocateSpecificState(bufferParameters);
+            if (!pState->isRecyclable()) {
+                destroySpecificState(pState);
+                return;
+            }
+            m_statePool.push_back(pState);
+        }
+    }
 
-    EffectSpecificState* createSpecificState(const mixxx::EngineParameters& bufferParameters) {
+    EffectSpecificState* allocateSpecificState(const mixxx::EngineParameters& bufferParameters) {
         EffectSpecificState* pState = new EffectSpecificState(bufferParameters);
+        m_stateMemoryBytes.fetch_add(stateBytes(pState));
         if (kEffectDebugOutput) {
             qDebug() << this << "EffectProcessorImpl creating EffectState" << pState;
         }
         return pState;
     };
 
+    void destroySpecificState(EffectSpecificState* pState) {
+        m_stateMemoryBytes.fetch_sub(stateBytes(pState));
+        delete pState;
+    }
+
     EffectsManager* m_pEffectsManager;
     ChannelHandleMap<ChannelHandleMap<EffectSpecificState*>> m_channelStateMatrix;
+    // Unused recyclable states. Only accessed from the main thread.
+    std::vector<EffectSpecificState*> m_statePool;
+    std::atomic<std::size_t> m_stateMemoryBytes;
 };
 
 #endif /* EFFECTPROCESSOR_H */
@@ -32,6 +32,7 @@
 #include "encoder/encoderopus.h"
 #endif
 #include "encoder/encoderopussettings.h"
+#include "encoder/sharedencoder.h"
 
 #include <QList>
 
@@ -146,3 +147,26 @@ EncoderSettingsPointer EncoderFactory::getEncoderSettings(Encoder::Format format
         return std::make_shared<EncoderWaveSettings>(pConfig, format);
     }
 }
+
+EncoderPointer EncoderFactory::getSharedEncoder(Encoder::Format format,
+    const EncoderSettings& settings, int samplerate,
+    UserSettingsPointer pConfig, EncoderCallback* pCallback,
+    QString* pErrorMessage, const QString& artist,
+    const QString& title, const QString& album) const
+{
+    if (SharedEncoder::isShareable(format)) {
+        return SharedEncoder::subscribe(format, settings, samplerate,
+                artist, title, album, pConfig, pCallback, pErrorMessage);
+    }
+    EncoderPointer pEncoder = getNewEncoder(format, pConfig, pCallback);
+    pEncoder->setEncoderSettings(settings);
+    pEncoder->updateMetaData(artist, title, album);
+    QString errorMessage;
+    if (pEncoder->initEncoder(samplerate, errorMessage) < 0) {
+        if (pErrorMessage) {
+            *pErrorMessage = errorMessage;
+        }
+        return EncoderPointer();
+    }
+    return pEncoder;
+}
@@ -59,6 +59,17 @@ class EncoderFactory {
         UserSettingsPointer pConfig, EncoderCallback* pCallback) const;
     EncoderSettingsPointer getEncoderSettings(Encoder::Format format,
         UserSettingsPointer pConfig) const;
+    // Returns an initialized encoder that shares the encoding with all
+    // other sinks that use the same format, settings, sample rate and
+    // metadata, see SharedEncoder. Returns a null pointer if the
+    // initialization failed.
+    EncoderPointer getSharedEncoder(Encoder::Format format,
+        const EncoderSettings& settings, int samplerate,
+        UserSettingsPointer pConfig, EncoderCallback* pCallback,
+        QString* pErrorMessage,
+        const QString& artist = QString(),
+        const QString& title = QString(),
+        const QString& album = QString()) const;
   private:
     static EncoderFactory factory;
     QList<Encoder::Format> m_formats;
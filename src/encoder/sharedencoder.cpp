@@ -0,0 +1,404 @@
+#include "encoder/sharedencoder.h"
+
+#include <QHash>
+#include <QMutexLocker>
+
+#include <cstring>
+
+#include "encoder/encodermp3settings.h"
+#include "encoder/encoderopussettings.h"
+#include "recording/defs_recording.h"
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/threadcputimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SharedEncoder");
+
+// A few seconds of encoded audio, the encoders emit at most a few
+// packets for each buffer of samples.
+const std::size_t kPacketCapacity = 1024;
+
+const char kOggCapturePattern[4] = { 'O', 'g', 'g', 'S' };
+const int kOggGranulePositionOffset = 6;
+const int kOggGranulePositionLength = 8;
+
+const StatId kDroppedPacketsStatId("SharedEncoder::dropped_packets",
+        Stat::COUNTER);
+
+// The values that the encoders read from their settings, whichever
+// settings class provides them. Broadcast connections use
+// EncoderBroadcastSettings, which has no option groups and thus always
+// selects option 0, e.g. CBR for MP3, except for Opus, which uses the
+// settings of the recording preferences.
+class EncoderSettingsSnapshot : public EncoderSettings {
+  public:
+    EncoderSettingsSnapshot(const Encoder::Format& format, const EncoderSettings& settings)
+            : m_qualityValues(settings.getQualityValues()),
+              m_quality(settings.getQuality()),
+              m_qualityIndex(settings.getQualityIndex()),
+              m_channelMode(settings.getChannelMode()) {
+        if (format.internalName == ENCODING_MP3) {
+            m_modeGroup = EncoderMp3Settings::ENCODING_MODE_GROUP;
+        } else if (format.internalName == ENCODING_OPUS) {
+            m_modeGroup = EncoderOpusSettings::BITRATE_MODE_GROUP;
+        }
+        m_selectedMode = m_modeGroup.isEmpty() ? 0 : settings.getSelectedOption(m_modeGroup);
+    }
+
+    bool usesQualitySlider() const override {
+        return false;
+    }
+    bool usesCompressionSlider() const override {
+        return false;
+    }
+    bool usesOptionGroups() const override {
+        return false;
+    }
+    QList<int> getQualityValues() const override {
+        return m_qualityValues;
+    }
+    int getQuality() const override {
+        return m_quality;
+    }
+    int getQualityIndex() const override {
+        return m_qualityIndex;
+    }
+    int getSelectedOption(QString groupCode) const override {
+        return (groupCode == m_modeGroup) ? m_selectedMode : 0;
+    }
+    ChannelMode getChannelMode() const override {
+        return m_channelMode;
+    }
+
+    QString toString() const {
+        QString result = QString("quality %1 channels %2")
+                .arg(QString::number(m_quality),
+                     QString::number(static_cast<int>(m_channelMode)));
+        if (!m_modeGroup.isEmpty()) {
+            result += QString(" %1 %2").arg(m_modeGroup, QString::number(m_selectedMode));
+            // The VBR modes of EncoderMp3 are selected by the index into
+            // the quality values instead of the bitrate
+            if ((m_modeGroup == EncoderMp3Settings::ENCODING_MODE_GROUP) &&
+                    (m_selectedMode != 0)) {
+                result += QString(" vbr %1").arg(
+                        m_qualityValues.size() - 1 - m_qualityIndex);
+            }
+        }
+        return result;
+    }
+
+  private:
+    QList<int> m_qualityValues;
+    int m_quality;
+    int m_qualityIndex;
+    ChannelMode m_channelMode;
+    QString m_modeGroup;
+    int m_selectedMode;
+};
+
+QMutex s_registryMutex;
+QHash<QString, std::weak_ptr<SharedEncoder>> s_registry;
+
+} // anonymous namespace
+
+class SharedEncoder::Subscription : public Encoder {
+  public:
+    Subscription(std::shared_ptr<SharedEncoder> pShared, EncoderCallback* pSinkArg)
+            : pSink(pSinkArg),
+              started(false),
+              inputSamples(0),
+              readSequence(0),
+              headerPending(false),
+              flushed(false),
+              endSequence(0),
+              m_pShared(std::move(pShared)) {
+        m_pShared->attach();
+    }
+    ~Subscription() override {
+        m_pShared->detach(this);
+    }
+
+    // The shared encoder has already been initialized
+    int initEncoder(int samplerate, QString errorMessage) override {
+        Q_UNUSED(samplerate);
+        Q_UNUSED(errorMessage);
+        return 0;
+    }
+    void encodeBuffer(const CSAMPLE *samples, const int size) override {
+        m_pShared->encode(this, samples, size);
+        m_pShared->deliver(this);
+    }
+    // The metadata is part of the key of the shared encoder
+    void updateMetaData(const QString& artist, const QString& title, const QString& album) override {
+        Q_UNUSED(artist);
+        Q_UNUSED(title);
+        Q_UNUSED(album);
+    }
+    void flush() override {
+        m_pShared->flush(this);
+        m_pShared->deliver(this);
+    }
+    // The settings are part of the key of the shared encoder
+    void setEncoderSettings(const EncoderSettings& settings) override {
+        Q_UNUSED(settings);
+        DEBUG_ASSERT(!"Settings of a shared encoder can't be changed");
+    }
+
+    EncoderCallback* const pSink;
+    // Only accessed from the thread of the sink
+    bool started;
+    // The position of the end of the input in the shared stream
+    quint64 inputSamples;
+    // The sequence number of the next packet to deliver
+    quint64 readSequence;
+    bool headerPending;
+    // After flushing only the packets before endSequence are delivered
+    bool flushed;
+    quint64 endSequence;
+
+  private:
+    const std::shared_ptr<SharedEncoder> m_pShared;
+};
+
+// static
+bool SharedEncoder::isOggHeaderPage(const QByteArray& packet) {
+    if ((packet.size() < kOggGranulePositionOffset + kOggGranulePositionLength) ||
+            (std::memcmp(packet.constData(), kOggCapturePattern,
+                     sizeof(kOggCapturePattern)) != 0)) {
+        return false;
+    }
+    for (int i = 0; i < kOggGranulePositionLength; ++i) {
+        if (packet[kOggGranulePositionOffset + i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// static
+EncoderPointer SharedEncoder::subscribe(
+        Encoder::Format format,
+        const EncoderSettings& settings,
+        int sampleRate,
+        const QString& artist,
+        const QString& title,
+        const QString& album,
+        UserSettingsPointer pConfig,
+        EncoderCallback* pSink,
+        QString* pErrorMessage) {
+    DEBUG_ASSERT(isShareable(format));
+    auto pSettings = std::make_shared<EncoderSettingsSnapshot>(format, settings);
+    // The encoders write the metadata into the stream, e.g. into the
+    // ID3 tag of MP3 or the comment header of Ogg streams
+    const QString key = QString("%1 %2 Hz %3 artist %4 title %5 album %6").arg(
+            format.internalName, QString::number(sampleRate), pSettings->toString(),
+            artist, title, album);
+
+    QMutexLocker locker(&s_registryMutex);
+    std::shared_ptr<SharedEncoder> pShared = s_registry.value(key).lock();
+    if (!pShared || pShared->isFinished()) {
+        pShared = std::shared_ptr<SharedEncoder>(new SharedEncoder(
+                key, format, std::move(pSettings), sampleRate,
+                artist, title, album, pConfig));
+        QString errorMessage;
+        if (!pShared->initEncoder(&errorMessage)) {
+            if (pErrorMessage) {
+                *pErrorMessage = errorMessage;
+            }
+            // The destructor unregisters the encoder
+            locker.unlock();
+            pShared.reset();
+            return EncoderPointer();
+        }
+        s_registry.insert(key, pShared);
+        kLogger.debug() << "Created encoder" << key;
+    }
+    return std::make_shared<Subscription>(std::move(pShared), pSink);
+}
+
+SharedEncoder::SharedEncoder(const QString& key,
+                             const Encoder::Format& format,
+                             EncoderSettingsPointer pSettings,
+                             int sampleRate,
+                             const QString& artist,
+                             const QString& title,
+                             const QString& album,
+                             UserSettingsPointer pConfig)
+        : m_key(key),
+          m_format(format),
+          m_pSettings(std::move(pSettings)),
+          m_sampleRate(sampleRate),
+          m_pConfig(pConfig),
+          m_artist(artist),
+          m_title(title),
+          m_album(album),
+          m_encodeTimeStatId(
+                  QString("SharedEncoder::encode %1").arg(format.internalName)
+                          .toUtf8().constData(),
+                  Stat::DURATION_NANOSEC),
+          m_encodedSamples(0),
+          m_subscriptionCount(0),
+          m_finished(false),
+          m_packets(kPacketCapacity),
+          m_writeSequence(0),
+          m_headerComplete(false) {
+}
+
+SharedEncoder::~SharedEncoder() {
+    // Destroying the encoder might still write packets
+    m_pEncoder.reset();
+
+    QMutexLocker locker(&s_registryMutex);
+    // The key might already refer to a new encoder
+    const auto it = s_registry.find(m_key);
+    if ((it != s_registry.end()) && it.value().expired()) {
+        s_registry.erase(it);
+    }
+}
+
+bool SharedEncoder::initEncoder(QString* pErrorMessage) {
+    m_pEncoder = EncoderFactory::getFactory().getNewEncoder(m_format, m_pConfig, this);
+    m_pEncoder->setEncoderSettings(*m_pSettings);
+    m_pEncoder->updateMetaData(m_artist, m_title, m_album);
+    return m_pEncoder->initEncoder(m_sampleRate, *pErrorMessage) >= 0;
+}
+
+bool SharedEncoder::isFinished() {
+    QMutexLocker locker(&m_encoderMutex);
+    return m_finished;
+}
+
+void SharedEncoder::attach() {
+    QMutexLocker locker(&m_encoderMutex);
+    ++m_subscriptionCount;
+}
+
+void SharedEncoder::detach(Subscription* pSubscription) {
+    QMutexLocker locker(&m_encoderMutex);
+    if (!pSubscription->flushed) {
+        --m_subscriptionCount;
+        DEBUG_ASSERT(m_subscriptionCount >= 0);
+    }
+}
+
+void SharedEncoder::encode(Subscription* pSubscription, const CSAMPLE* samples, int size) {
+    QMutexLocker locker(&m_encoderMutex);
+    if (!pSubscription->started) {
+        // Join the stream at the current position. Packets that have
+        // been written before any audio has been encoded belong to
+        // the beginning of the stream.
+        pSubscription->started = true;
+        pSubscription->inputSamples = m_encodedSamples;
+        QMutexLocker packetLocker(&m_packetMutex);
+        if (m_encodedSamples > 0) {
+            pSubscription->readSequence = m_writeSequence;
+            pSubscription->headerPending = true;
+        }
+    }
+    pSubscription->inputSamples += size;
+    if (m_finished || pSubscription->flushed) {
+        return;
+    }
+    if (pSubscription->inputSamples <= m_encodedSamples) {
+        // Already encoded for another subscription
+        return;
+    }
+    const int newSamples = static_cast<int>(
+            pSubscription->inputSamples - m_encodedSamples);
+    DEBUG_ASSERT(newSamples <= size);
+    m_encodedSamples = pSubscription->inputSamples;
+
+    ThreadCpuTimer timer;
+    timer.start();
+    m_pEncoder->encodeBuffer(samples + (size - newSamples), newSamples);
+    m_encodeTimeStatId.report(timer.elapsed().toIntegerNanos());
+}
+
+void SharedEncoder::flush(Subscription* pSubscription) {
+    QMutexLocker locker(&m_encoderMutex);
+    if (!pSubscription->started || pSubscription->flushed || m_finished) {
+        return;
+    }
+    pSubscription->flushed = true;
+    --m_subscriptionCount;
+    DEBUG_ASSERT(m_subscriptionCount >= 0);
+    if (m_subscriptionCount == 0) {
+        // The last subscription receives the tail of the stream, e.g.
+        // the samples that are still buffered in the encoder. Destroying
+        // the encoder might still write packets.
+        m_pEncoder->flush();
+        m_pEncoder.reset();
+        m_finished = true;
+    }
+    // Otherwise the stream of the other subscriptions continues
+    // undisturbed, e.g. listeners of a broadcast would notice a restart.
+    QMutexLocker packetLocker(&m_packetMutex);
+    pSubscription->endSequence = m_writeSequence;
+}
+
+void SharedEncoder::deliver(Subscription* pSubscription) {
+    QList<QByteArray> packets;
+    {
+        QMutexLocker locker(&m_packetMutex);
+        if (!pSubscription->started) {
+            return;
+        }
+        if (pSubscription->headerPending) {
+            packets = m_headerPackets;
+            pSubscription->headerPending = false;
+        }
+        if (m_writeSequence - pSubscription->readSequence > kPacketCapacity) {
+            kDroppedPacketsStatId.report(
+                    m_writeSequence - pSubscription->readSequence - kPacketCapacity);
+            pSubscription->readSequence = m_writeSequence - kPacketCapacity;
+        }
+        const quint64 endSequence = pSubscription->flushed ?
+                pSubscription->endSequence : m_writeSequence;
+        for (; pSubscription->readSequence < endSequence;
+                ++pSubscription->readSequence) {
+            // Only increments the reference count of the packet
+            packets.append(m_packets[pSubscription->readSequence % kPacketCapacity]);
+        }
+    }
+    // Writing to the sink might block, e.g. on a slow network
+    for (const auto& packet : packets) {
+        pSubscription->pSink->write(nullptr,
+                reinterpret_cast<const unsigned char*>(packet.constData()),
+                0, packet.size());
+    }
+}
+
+void SharedEncoder::write(const unsigned char *header, const unsigned char *body,
+                          int headerLen, int bodyLen) {
+    QByteArray packet;
+    packet.reserve(headerLen + bodyLen);
+    if (headerLen > 0) {
+        packet.append(reinterpret_cast<const char*>(header), headerLen);
+    }
+    packet.append(reinterpret_cast<const char*>(body), bodyLen);
+
+    QMutexLocker locker(&m_packetMutex);
+    if (!m_headerComplete) {
+        if (isOggHeaderPage(packet)) {
+            m_headerPackets.append(packet);
+        } else {
+            m_headerComplete = true;
+        }
+    }
+    m_packets[m_writeSequence % kPacketCapacity] = std::move(packet);
+    ++m_writeSequence;
+}
+
+int SharedEncoder::tell() {
+    return -1;
+}
+
+void SharedEncoder::seek(int pos) {
+    Q_UNUSED(pos);
+}
+
+int SharedEncoder::filelen() {
+    return 0;
+}
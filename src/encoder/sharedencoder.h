@@ -0,0 +1,139 @@
+#ifndef SHAREDENCODER_H
+#define SHAREDENCODER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include <vector>
+
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "encoder/encodersettings.h"
+#include "util/statid.h"
+
+// Encodes the master output once per distinct combination of format,
+// encoder settings, sample rate and metadata and fans the encoded packets
+// out to any number of sinks, e.g. several broadcast connections that
+// use the same settings.
+//
+// Each sink gets a subscription that implements the Encoder interface
+// and delivers the packets to the sink's EncoderCallback. The encoded
+// packets are stored in a ring of implicitly shared byte arrays, i.e.
+// all subscriptions read the same memory without copying it.
+//
+// The sinks run in different threads and are fed from different FIFOs
+// that all carry the same signal. The input of the encoder is the
+// concatenation of all subscriptions' inputs by sample position: the
+// subscription that is furthest ahead encodes the new samples while
+// the others only deliver the packets that have been encoded for them.
+// A stalled sink never stalls the other sinks, but it might miss
+// packets if it falls behind by more than the capacity of the ring.
+//
+// The encoders are keyed by the values that they read from the
+// settings, so sinks share an encoder even if their settings are
+// provided by different classes.
+//
+// Sinks that join a running stream start at the next packet. For Ogg
+// streams the pages that contain the stream headers are delivered
+// first. A sink that flushes its subscription while other sinks are
+// subscribed leaves the stream without disturbing them, i.e. it doesn't
+// receive the tail of the stream. Only the last sink flushes the
+// encoder. Sinks that need a proper end of their stream, e.g.
+// recordings, must not share an encoder.
+class SharedEncoder : public EncoderCallback {
+  public:
+    ~SharedEncoder();
+
+    // Returns a subscription for pSink to the shared encoder for the
+    // given parameters, creating and initializing the encoder if it
+    // doesn't exist. Returns a null pointer if the encoder could not be
+    // initialized.
+    static EncoderPointer subscribe(
+            Encoder::Format format,
+            const EncoderSettings& settings,
+            int sampleRate,
+            const QString& artist,
+            const QString& title,
+            const QString& album,
+            UserSettingsPointer pConfig,
+            EncoderCallback* pSink,
+            QString* pErrorMessage);
+
+    // Lossless encoders seek in their output to finish the file header
+    // and can't be shared between sinks.
+    static bool isShareable(const Encoder::Format& format) {
+        return !format.lossless;
+    }
+
+    // The pages that contain the identification, comment and setup
+    // headers of Vorbis and Opus streams are the only pages with a
+    // granule position of 0.
+    static bool isOggHeaderPage(const QByteArray& packet);
+
+    // Receives the packets from the encoder. Might be called while
+    // initializing, encoding, flushing or destroying the encoder.
+    void write(const unsigned char *header, const unsigned char *body,
+               int headerLen, int bodyLen) override;
+    // Encoded streams are not seekable
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  private:
+    class Subscription;
+
+    SharedEncoder(const QString& key,
+                  const Encoder::Format& format,
+                  EncoderSettingsPointer pSettings,
+                  int sampleRate,
+                  const QString& artist,
+                  const QString& title,
+                  const QString& album,
+                  UserSettingsPointer pConfig);
+
+    bool initEncoder(QString* pErrorMessage);
+    // Returns true if the last subscription has flushed the encoder
+    bool isFinished();
+
+    void attach();
+    void detach(Subscription* pSubscription);
+    void encode(Subscription* pSubscription, const CSAMPLE* samples, int size);
+    // Ends the stream of the subscription. Only the last subscription
+    // flushes the encoder.
+    void flush(Subscription* pSubscription);
+    // Delivers all packets that the subscription has not received yet
+    void deliver(Subscription* pSubscription);
+
+    const QString m_key;
+    const Encoder::Format m_format;
+    const EncoderSettingsPointer m_pSettings;
+    const int m_sampleRate;
+    const UserSettingsPointer m_pConfig;
+    const QString m_artist;
+    const QString m_title;
+    const QString m_album;
+    const StatId m_encodeTimeStatId;
+    EncoderPointer m_pEncoder;
+
+    // Serializes all calls into the encoder
+    QMutex m_encoderMutex;
+    // Guarded by m_encoderMutex
+    quint64 m_encodedSamples;
+    // The subscriptions that have not been flushed
+    int m_subscriptionCount;
+    bool m_finished;
+
+    // Guards the ring of packets that is written by the encoding
+    // thread and read by the delivering threads.
+    QMutex m_packetMutex;
+    std::vector<QByteArray> m_packets;
+    // The sequence number of the next packet
+    quint64 m_writeSequence;
+    // The Ogg pages that precede the first audio page
+    QList<QByteArray> m_headerPackets;
+    bool m_headerComplete;
+};
+
+#endif // SHAREDENCODER_H
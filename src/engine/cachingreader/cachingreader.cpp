@@ -9,6 +9,7 @@
 #include "util/math.h"
 #include "util/sample.h"
 #include "util/logger.h"
+#include "util/statid.h"
 
 
 namespace {
@@ -20,11 +21,25 @@ mixxx::Logger kLogger("CachingReader");
 // TODO() Do we suffer cache misses if we use an audio buffer of above 23 ms?
 const SINT kDefaultHintFrames = 1024;
 
+// This is the hint frameCount that is adopted in case of Hint::kFrameCountPrefetch.
+// SoundTouch can read up to 2 chunks ahead after jumping to a new position.
+const SINT kPrefetchHintFrames = 2 * CachingReaderChunk::kFrames;
+
 // currently CachingReaderWorker::kCachingReaderChunkLength is 65536 (0x10000);
 // For 80 chunks we need 5242880 (0x500000) bytes (5 MiB) of Memory
 //static
 const SINT kNumberOfCachedChunksInMemory = 80;
 
+// The maximum number of chunks that are hinted including speculative hints
+const SINT kMaxHintedChunksWithPrefetch = kNumberOfCachedChunksInMemory * 3 / 4;
+
+const StatId kPrefetchStatId("CachingReader::prefetch",
+        Stat::COUNTER);
+const StatId kPrefetchHitStatId("CachingReader::prefetch_hit",
+        Stat::COUNTER);
+const StatId kPrefetchUnusedStatId("CachingReader::prefetch_unused",
+        Stat::COUNTER);
+
 } // anonymous namespace
 
 
@@ -34,12 +49,15 @@ CachingReader::CachingReader(QString group,
           m_chunkReadRequestFIFO(1024),
           m_readerStatusFIFO(1024),
           m_readerStatus(INVALID),
+          m_pendingChunkReadCount(0),
+          m_freeChunksHead(nullptr),
+          m_allocatedCachingReaderChunks(kNumberOfCachedChunksInMemory),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
           m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfCachedChunksInMemory),
-          m_worker(group, &m_chunkReadRequestFIFO, &m_readerStatusFIFO) {
+          m_worker(group, config, &m_chunkReadRequestFIFO, &m_readerStatusFIFO) {
 
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
+    m_chunks.reserve(kNumberOfCachedChunksInMemory);
     // Divide up the allocated raw memory buffer into total_chunks
     // chunks. Initialize each chunk to hold nothing and add it to the free
     // list.
@@ -51,7 +69,7 @@ CachingReader::CachingReader(QString group,
                                 CachingReaderChunk::kSamples * i,
                                 CachingReaderChunk::kSamples));
         m_chunks.push_back(c);
-        m_freeChunks.push_back(c);
+        pushFreeChunk(c);
     }
 
     // Forward signals from worker
@@ -73,6 +91,21 @@ CachingReader::~CachingReader() {
     qDeleteAll(m_chunks);
 }
 
+void CachingReader::pushFreeChunk(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::FREE);
+    // The most recently freed chunk is reused first
+    pChunk->insertIntoListBefore(m_freeChunksHead);
+    m_freeChunksHead = pChunk;
+}
+
+CachingReaderChunkForOwner* CachingReader::popFreeChunk() {
+    CachingReaderChunkForOwner* pChunk = m_freeChunksHead;
+    if (pChunk) {
+        pChunk->removeFromList(&m_freeChunksHead, nullptr);
+    }
+    return pChunk;
+}
+
 void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
     DEBUG_ASSERT(pChunk != nullptr);
     DEBUG_ASSERT(pChunk->getState() != CachingReaderChunkForOwner::READ_PENDING);
@@ -84,8 +117,11 @@ void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
 
     pChunk->removeFromList(
             &m_mruCachingReaderChunk, &m_lruCachingReaderChunk);
+    if (pChunk->isPrefetched()) {
+        kPrefetchUnusedStatId.report(1);
+    }
     pChunk->free();
-    m_freeChunks.push_back(pChunk);
+    pushFreeChunk(pChunk);
 }
 
 void CachingReader::freeAllChunks() {
@@ -99,20 +135,24 @@ void CachingReader::freeAllChunks() {
         if (pChunk->getState() != CachingReaderChunkForOwner::FREE) {
             pChunk->removeFromList(
                     &m_mruCachingReaderChunk, &m_lruCachingReaderChunk);
+            if (pChunk->isPrefetched()) {
+                kPrefetchUnusedStatId.report(1);
+            }
             pChunk->free();
-            m_freeChunks.push_back(pChunk);
+            pushFreeChunk(pChunk);
         }
     }
 
     m_allocatedCachingReaderChunks.clear();
     m_mruCachingReaderChunk = nullptr;
+    m_lruCachingReaderChunk = nullptr;
 }
 
 CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
-    if (m_freeChunks.isEmpty()) {
+    CachingReaderChunkForOwner* pChunk = popFreeChunk();
+    if (!pChunk) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.takeFirst();
     pChunk->init(chunkIndex);
 
     //kLogger.debug() << "Allocating chunk" << pChunk << pChunk->getIndex();
@@ -136,8 +176,8 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
 }
 
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
-    // Defaults to nullptr if it's not in the hash.
-    CachingReaderChunkForOwner* chunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
+    // Defaults to nullptr if it's not in the index.
+    CachingReaderChunkForOwner* chunk = m_allocatedCachingReaderChunks.find(chunkIndex);
 
     // Make sure the allocated number matches the indexed chunk number.
     DEBUG_ASSERT(chunk == nullptr || chunkIndex == chunk->getIndex());
@@ -190,6 +230,8 @@ void CachingReader::process() {
             // This has to be done before freeing all chunks
             // after a new track has been loaded (see below)!
             pChunk->takeFromWorker();
+            DEBUG_ASSERT(m_pendingChunkReadCount > 0);
+            --m_pendingChunkReadCount;
             if (status.status == CHUNK_READ_SUCCESS) {
                 // Insert or freshen the chunk in the MRU/LRU list after
                 // obtaining ownership from the worker.
@@ -220,6 +262,21 @@ void CachingReader::process() {
     }
 }
 
+bool CachingReader::hasPendingReads() {
+    // The worker writes the status of a loaded track before it has
+    // finished loading, so ask it before processing the status updates.
+    const bool loadingTrack = m_worker.isLoadingTrack();
+    process();
+    if (!loadingTrack && m_pendingChunkReadCount == 0) {
+        return false;
+    }
+    // Without an audio callback nobody might run the worker scheduler,
+    // so wake the worker directly.
+    m_worker.workReady();
+    m_worker.wakeIfReady();
+    return true;
+}
+
 CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples, bool reverse, CSAMPLE* buffer) {
     // Check for bad inputs
     VERIFY_OR_DEBUG_ASSERT(
@@ -346,8 +403,12 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                 }
 
                 mixxx::IndexRange bufferedFrameIndexRange;
-                const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
+                CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
                 if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    if (pChunk->isPrefetched()) {
+                        kPrefetchHitStatId.report(1);
+                        pChunk->setPrefetched(false);
+                    }
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -441,69 +502,113 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     // any are not, then wake.
     bool shouldWake = false;
 
+    // Hints are issued for each callback and all hinted chunks need to
+    // fit into the cache at once. Otherwise they would evict each other
+    // and be decoded again and again.
+    SINT hintedChunkCount = 0;
     for (const auto& hint: hintList) {
-        SINT hintFrame = hint.frame;
-        SINT hintFrameCount = hint.frameCount;
-
-        // Handle some special length values
-        if (hintFrameCount == Hint::kFrameCountForward) {
-        	hintFrameCount = kDefaultHintFrames;
-        } else if (hintFrameCount == Hint::kFrameCountBackward) {
-        	hintFrame -= kDefaultHintFrames;
-        	hintFrameCount = kDefaultHintFrames;
-            if (hintFrame < 0) {
-            	hintFrameCount += hintFrame;
-                hintFrame = 0;
-            }
+        if (hint.priority < Hint::kPriorityPrefetch) {
+            shouldWake |= requestHintedChunks(
+                    hint, &hintedChunkCount, kNumberOfCachedChunksInMemory);
         }
-
-        VERIFY_OR_DEBUG_ASSERT(hintFrameCount > 0) {
-            kLogger.warning() << "ERROR: Negative hint length. Ignoring.";
-            continue;
+    }
+    // Speculative hints are only served after all other hints and
+    // leave some room in the cache for chunks around the play position
+    // that have been read recently.
+    for (const auto& hint: hintList) {
+        if (hintedChunkCount >= kMaxHintedChunksWithPrefetch) {
+            break;
+        }
+        if (hint.priority >= Hint::kPriorityPrefetch) {
+            shouldWake |= requestHintedChunks(
+                    hint, &hintedChunkCount, kMaxHintedChunksWithPrefetch);
         }
+    }
 
-        const auto readableFrameIndexRange = intersect(
-                m_readableFrameIndexRange,
-                mixxx::IndexRange::forward(hintFrame, hintFrameCount));
-        if (readableFrameIndexRange.empty()) {
-            continue;
+    // If there are chunks to be read, wake up.
+    if (shouldWake) {
+        m_worker.workReady();
+    }
+}
+
+bool CachingReader::requestHintedChunks(
+        const Hint& hint,
+        SINT* pHintedChunkCount,
+        SINT maxHintedChunkCount) {
+    const bool prefetch = hint.priority >= Hint::kPriorityPrefetch;
+    SINT hintFrame = hint.frame;
+    SINT hintFrameCount = hint.frameCount;
+
+    // Handle some special length values
+    if (hintFrameCount == Hint::kFrameCountForward) {
+        hintFrameCount = kDefaultHintFrames;
+    } else if (hintFrameCount == Hint::kFrameCountBackward) {
+        hintFrame -= kDefaultHintFrames;
+        hintFrameCount = kDefaultHintFrames;
+        if (hintFrame < 0) {
+            hintFrameCount += hintFrame;
+            hintFrame = 0;
         }
+    } else if (hintFrameCount == Hint::kFrameCountPrefetch) {
+        hintFrameCount = kPrefetchHintFrames;
+    }
+
+    VERIFY_OR_DEBUG_ASSERT(hintFrameCount > 0) {
+        kLogger.warning() << "ERROR: Negative hint length. Ignoring.";
+        return false;
+    }
+
+    const auto readableFrameIndexRange = intersect(
+            m_readableFrameIndexRange,
+            mixxx::IndexRange::forward(hintFrame, hintFrameCount));
+    if (readableFrameIndexRange.empty()) {
+        return false;
+    }
 
-        const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
-        const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
-        for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
-            CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
+    bool shouldWake = false;
+    const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
+    const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
+    for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+        if (*pHintedChunkCount >= maxHintedChunkCount) {
+            break;
+        }
+        ++(*pHintedChunkCount);
+        CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
+        if (pChunk == nullptr) {
+            shouldWake = true;
+            pChunk = allocateChunkExpireLRU(chunkIndex);
             if (pChunk == nullptr) {
-                shouldWake = true;
-                pChunk = allocateChunkExpireLRU(chunkIndex);
-                if (pChunk == nullptr) {
-                    kLogger.warning() << "ERROR: Couldn't allocate spare CachingReaderChunk to make CachingReaderChunkReadRequest.";
-                    continue;
-                }
-                // Do not insert the allocated chunk into the MRU/LRU list,
-                // because it will be handed over to the worker immediately
-                CachingReaderChunkReadRequest request;
-                request.giveToWorker(pChunk);
-                // kLogger.debug() << "Requesting read of chunk" << current << "into" << pChunk;
-                // kLogger.debug() << "Requesting read into " << request.chunk->data;
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
-                    kLogger.warning() << "ERROR: Could not submit read request for "
-                             << chunkIndex;
-                    // Revoke the chunk from the worker and free it
-                    pChunk->takeFromWorker();
-                    freeChunk(pChunk);
+                kLogger.warning() << "ERROR: Couldn't allocate spare CachingReaderChunk to make CachingReaderChunkReadRequest.";
+                continue;
+            }
+            // Do not insert the allocated chunk into the MRU/LRU list,
+            // because it will be handed over to the worker immediately
+            CachingReaderChunkReadRequest request;
+            request.giveToWorker(pChunk, prefetch);
+            // kLogger.debug() << "Requesting read of chunk" << current << "into" << pChunk;
+            // kLogger.debug() << "Requesting read into " << request.chunk->data;
+            if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+                kLogger.warning() << "ERROR: Could not submit read request for "
+                         << chunkIndex;
+                // Revoke the chunk from the worker and free it
+                pChunk->takeFromWorker();
+                freeChunk(pChunk);
+            } else {
+                ++m_pendingChunkReadCount;
+                if (prefetch) {
+                    kPrefetchStatId.report(1);
                 }
-                //kLogger.debug() << "Checking chunk " << current << " shouldWake:" << shouldWake << " chunksToRead" << m_chunksToRead.size();
-            } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
-                // This will cause the chunk to be 'freshened' in the cache. The
-                // chunk will be moved to the end of the LRU list.
-                freshenChunk(pChunk);
             }
+            //kLogger.debug() << "Checking chunk " << current << " shouldWake:" << shouldWake << " chunksToRead" << m_chunksToRead.size();
+        } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+            // This will cause the chunk to be 'freshened' in the cache. The
+            // chunk will be moved to the end of the LRU list.
+            freshenChunk(pChunk);
+        } else if (!prefetch && pChunk->isSpeculative()) {
+            // The pending chunk has been requested speculatively, but is
+            // needed now. The worker must not defer it any longer.
+            pChunk->setSpeculative(false);
         }
     }
-
-    // If there are chunks to be read, wake up.
-    if (shouldWake) {
-        m_worker.workReady();
-    }
+    return shouldWake;
 }
@@ -7,8 +7,6 @@
 #include <QtDebug>
 #include <QList>
 #include <QVector>
-#include <QLinkedList>
-#include <QHash>
 #include <QVarLengthArray>
 
 #include "util/types.h"
@@ -16,6 +14,7 @@
 #include "track/track.h"
 #include "engine/engineworker.h"
 #include "util/fifo.h"
+#include "engine/cachingreader/cachingreaderchunkindex.h"
 #include "engine/cachingreader/cachingreaderworker.h"
 
 // A Hint is an indication to the CachingReader that a certain section of a
@@ -27,16 +26,21 @@ typedef struct Hint {
     // If a range of frames should be present, use frameCount to indicate that the
     // range (frame, frame + frameCount) should be present in memory.
     SINT frameCount;
-    // Currently unused -- but in the future could be used to prioritize certain
-    // hints over others. A priority of 1 is the highest priority and should be
-    // used for samples that will be read imminently. Hints for samples that
-    // have the potential to be read (i.e. a cue point) should be issued with
-    // priority >10.
+    // A priority of 1 is the highest priority and should be used for samples
+    // that will be read imminently. Hints for samples that have the potential
+    // to be read (i.e. a cue point) should be issued with priority >10.
+    // Hints with kPriorityPrefetch are speculative and only served if the
+    // cache has room left after all other hints have been served.
     int priority;
 
+    static constexpr int kPriorityPrefetch = 100;
+
     // for the default frame count in forward direction
     static constexpr SINT kFrameCountForward = 0;
     static constexpr SINT kFrameCountBackward = -1;
+    // for the frames that are needed after jumping to a position,
+    // i.e. to continue playing in forward direction
+    static constexpr SINT kFrameCountPrefetch = -2;
 
 } Hint;
 
@@ -71,6 +75,10 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least-recently-used list. When a chunk needs to be allocated and there are no
 // free chunks then the least recently used chunk is free'd (see
 // allocateChunkExpireLRU).
+//
+// All bookkeeping that is performed in the engine callback (lookup,
+// freshen, allocate, free) works on preallocated, intrusive data
+// structures and never allocates memory.
 class CachingReader : public QObject {
     Q_OBJECT
 
@@ -108,6 +116,13 @@ class CachingReader : public QObject {
     // for this to take effect.
     virtual void newTrack(TrackPointer pTrack);
 
+    // Returns true while a new track is being loaded or chunk reads that
+    // have been requested from the worker are still pending and wakes the
+    // worker in this case. Allows offline callers to wait until the next
+    // read() won't miss the cache for any hinted chunk. Must only be
+    // called from the engine callback.
+    bool hasPendingReads();
+
     void setScheduler(EngineWorkerScheduler* pScheduler) {
         m_worker.setScheduler(pScheduler);
     }
@@ -138,6 +153,10 @@ class CachingReader : public QObject {
     // Moves the provided chunk to the MRU position.
     void freshenChunk(CachingReaderChunkForOwner* pChunk);
 
+    // Pushes a free chunk onto or pops a free chunk from the free list.
+    void pushFreeChunk(CachingReaderChunkForOwner* pChunk);
+    CachingReaderChunkForOwner* popFreeChunk();
+
     // Returns a CachingReaderChunk to the free list
     void freeChunk(CachingReaderChunkForOwner* pChunk);
 
@@ -150,18 +169,31 @@ class CachingReader : public QObject {
     // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
 
+    // Requests all chunks of the hint that are not in the cache and
+    // freshens those that are. Stops after *pHintedChunkCount reaches
+    // maxHintedChunkCount. Returns true if the worker needs to be woken.
+    bool requestHintedChunks(
+            const Hint& hint,
+            SINT* pHintedChunkCount,
+            SINT maxHintedChunkCount);
+
     ReaderStatus m_readerStatus;
 
+    // The number of chunks that have been handed over to the worker
+    SINT m_pendingChunkReadCount;
+
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    QLinkedList<CachingReaderChunkForOwner*> m_freeChunks;
+    // The list of free chunks. Free chunks are never part of the MRU/LRU
+    // list, so the intrusive list pointers of each chunk are reused for
+    // this purpose. Constant time insertions and deletions without any
+    // memory allocations.
+    CachingReaderChunkForOwner* m_freeChunksHead;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
     // chunk number they are allocated to.
-    QHash<int, CachingReaderChunkForOwner*> m_allocatedCachingReaderChunks;
+    CachingReaderChunkIndex m_allocatedCachingReaderChunks;
 
     // The linked list of recently-used chunks.
     CachingReaderChunkForOwner* m_mruCachingReaderChunk;
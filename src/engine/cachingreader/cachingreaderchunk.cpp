@@ -33,7 +33,8 @@ const SINT CachingReaderChunk::kSamples =
 CachingReaderChunk::CachingReaderChunk(
         mixxx::SampleBuffer::WritableSlice sampleBuffer)
         : m_index(kInvalidChunkIndex),
-          m_sampleBuffer(sampleBuffer) {
+          m_sampleBuffer(sampleBuffer),
+          m_speculative(0) {
     DEBUG_ASSERT(sampleBuffer.length() == kSamples);
 }
 
@@ -43,6 +44,7 @@ CachingReaderChunk::~CachingReaderChunk() {
 void CachingReaderChunk::init(SINT index) {
     m_index = index;
     m_bufferedSampleFrames.frameIndexRange() = mixxx::IndexRange();
+    m_speculative.storeRelease(0);
 }
 
 // Frame index range of this chunk for the given audio source.
@@ -51,12 +53,17 @@ mixxx::IndexRange CachingReaderChunk::frameIndexRange(
     if (!pAudioSource) {
         return mixxx::IndexRange();
     }
+    return frameIndexRange(pAudioSource->frameIndexRange());
+}
+
+mixxx::IndexRange CachingReaderChunk::frameIndexRange(
+        const mixxx::IndexRange& sourceFrameIndexRange) const {
     const SINT minFrameIndex =
-            pAudioSource->frameIndexMin() +
+            sourceFrameIndexRange.start() +
             frameIndexOffset();
     return intersect(
             mixxx::IndexRange::forward(minFrameIndex, kFrames),
-            pAudioSource->frameIndexRange());
+            sourceFrameIndexRange);
 }
 
 mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
@@ -76,6 +83,23 @@ mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
     return m_bufferedSampleFrames.frameIndexRange();
 }
 
+mixxx::IndexRange CachingReaderChunk::copySampleFrames(
+        const mixxx::ReadableSampleFrames& sampleFrames) {
+    DEBUG_ASSERT(sampleFrames.frameLength() <= kFrames);
+    DEBUG_ASSERT(sampleFrames.readableLength() ==
+            frames2samples(sampleFrames.frameLength()));
+    SampleUtil::copy(
+            m_sampleBuffer.data(),
+            sampleFrames.readableData(),
+            sampleFrames.readableLength());
+    m_bufferedSampleFrames = mixxx::ReadableSampleFrames(
+            sampleFrames.frameIndexRange(),
+            mixxx::SampleBuffer::ReadableSlice(
+                    m_sampleBuffer.data(),
+                    sampleFrames.readableLength()));
+    return m_bufferedSampleFrames.frameIndexRange();
+}
+
 mixxx::IndexRange CachingReaderChunk::readBufferedSampleFrames(
         CSAMPLE* sampleBuffer,
         const mixxx::IndexRange& frameIndexRange) const {
@@ -118,6 +142,7 @@ CachingReaderChunkForOwner::CachingReaderChunkForOwner(
         mixxx::SampleBuffer::WritableSlice sampleBuffer)
         : CachingReaderChunk(sampleBuffer),
           m_state(FREE),
+          m_prefetched(false),
           m_pPrev(nullptr),
           m_pNext(nullptr) {
 }
@@ -129,12 +154,14 @@ void CachingReaderChunkForOwner::init(SINT index) {
     DEBUG_ASSERT(READ_PENDING != m_state);
     CachingReaderChunk::init(index);
     m_state = READY;
+    m_prefetched = false;
 }
 
 void CachingReaderChunkForOwner::free() {
     DEBUG_ASSERT(READ_PENDING != m_state);
     CachingReaderChunk::init(kInvalidChunkIndex);
     m_state = FREE;
+    m_prefetched = false;
 }
 
 void CachingReaderChunkForOwner::insertIntoListBefore(
@@ -1,6 +1,8 @@
 #ifndef ENGINE_CACHINGREADERCHUNK_H
 #define ENGINE_CACHINGREADERCHUNK_H
 
+#include <QAtomicInt>
+
 #include "sources/audiosource.h"
 
 // A Chunk is a memory-resident section of audio that has been cached.
@@ -50,6 +52,10 @@ public:
     // Frame index range of this chunk for the given audio source.
     mixxx::IndexRange frameIndexRange(
             const mixxx::AudioSourcePointer& pAudioSource) const;
+    // Frame index range of this chunk for an audio source with
+    // the given frame index range.
+    mixxx::IndexRange frameIndexRange(
+            const mixxx::IndexRange& sourceFrameIndexRange) const;
 
     // Read sample frames from the audio source and return the
     // range of frames that have been read.
@@ -57,6 +63,16 @@ public:
             const mixxx::AudioSourcePointer& pAudioSource,
             mixxx::SampleBuffer::WritableSlice tempOutputBuffer);
 
+    // Copy already decoded sample frames, e.g. from the PCM cache,
+    // and return the range of frames that have been copied.
+    mixxx::IndexRange copySampleFrames(
+            const mixxx::ReadableSampleFrames& sampleFrames);
+
+    // The sample frames that have been buffered by the worker thread.
+    const mixxx::ReadableSampleFrames& bufferedSampleFrames() const {
+        return m_bufferedSampleFrames;
+    }
+
     mixxx::IndexRange readBufferedSampleFrames(
             CSAMPLE* sampleBuffer,
             const mixxx::IndexRange& frameIndexRange) const;
@@ -64,6 +80,14 @@ public:
             CSAMPLE* reverseSampleBuffer,
             const mixxx::IndexRange& frameIndexRange) const;
 
+    // Chunks that have been requested by a speculative hint are read
+    // after all other chunks. This is the only state that the owner may
+    // change while the worker is in control, i.e. when a pending chunk
+    // is hinted again without speculation.
+    bool isSpeculative() const {
+        return m_speculative.load() != 0;
+    }
+
 protected:
     explicit CachingReaderChunk(
             mixxx::SampleBuffer::WritableSlice sampleBuffer);
@@ -71,6 +95,11 @@ protected:
 
     void init(SINT index);
 
+    // Only the owner may change this flag, see isSpeculative()
+    void setSpeculative(bool speculative) {
+        m_speculative.storeRelease(speculative ? 1 : 0);
+    }
+
 private:
     SINT frameIndexOffset() const {
         return m_index * kFrames;
@@ -82,6 +111,8 @@ private:
     // set the corresponding frame index range.
     mixxx::SampleBuffer::WritableSlice m_sampleBuffer;
     mixxx::ReadableSampleFrames m_bufferedSampleFrames;
+
+    QAtomicInt m_speculative;
 };
 
 // This derived class is only accessible for the cache as the owner,
@@ -116,6 +147,17 @@ public:
         m_state = READY;
     }
 
+    // Chunks that have been requested by a speculative hint remain
+    // marked until they are actually read for the first time.
+    bool isPrefetched() const {
+        return m_prefetched;
+    }
+    void setPrefetched(bool prefetched) {
+        m_prefetched = prefetched;
+    }
+
+    using CachingReaderChunk::setSpeculative;
+
     // Inserts a chunk into the double-linked list before the
     // given chunk. If the list is currently empty simply pass
     // pBefore = nullptr. Please note that if pBefore points to
@@ -132,6 +174,7 @@ public:
 
 private:
     State m_state;
+    bool m_prefetched;
 
     CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
     CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
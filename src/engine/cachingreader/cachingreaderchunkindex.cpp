@@ -0,0 +1,72 @@
+#include "engine/cachingreader/cachingreaderchunkindex.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/math.h"
+
+CachingReaderChunkIndex::CachingReaderChunkIndex(SINT capacity)
+        : m_slots(roundUpToPowerOf2(2 * capacity)),
+          m_slotMask(m_slots.size() - 1),
+          m_capacity(capacity),
+          m_size(0) {
+    DEBUG_ASSERT(capacity > 0);
+    DEBUG_ASSERT(m_slots.size() >= static_cast<size_t>(2 * capacity));
+}
+
+bool CachingReaderChunkIndex::insert(
+        SINT chunkIndex,
+        CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(chunkIndex >= 0);
+    DEBUG_ASSERT(pChunk);
+    DEBUG_ASSERT(!find(chunkIndex));
+    VERIFY_OR_DEBUG_ASSERT(m_size < m_capacity) {
+        return false;
+    }
+    SINT slot = slotForChunkIndex(chunkIndex);
+    while (m_slots[slot].pChunk) {
+        slot = nextSlot(slot);
+    }
+    m_slots[slot].chunkIndex = chunkIndex;
+    m_slots[slot].pChunk = pChunk;
+    ++m_size;
+    return true;
+}
+
+int CachingReaderChunkIndex::remove(SINT chunkIndex) {
+    SINT slot = slotForChunkIndex(chunkIndex);
+    while (m_slots[slot].chunkIndex != chunkIndex) {
+        if (!m_slots[slot].pChunk) {
+            return 0;
+        }
+        slot = nextSlot(slot);
+    }
+    // Backward-shift deletion: Move all subsequent entries of the
+    // same cluster that would not be reachable anymore into the
+    // resulting gap.
+    SINT gap = slot;
+    SINT next = nextSlot(gap);
+    while (m_slots[next].pChunk) {
+        const SINT home = slotForChunkIndex(m_slots[next].chunkIndex);
+        // Check if home is cyclically outside of the range (gap, next]
+        const bool movable = (gap <= next) ?
+                ((home <= gap) || (home > next)) :
+                ((home <= gap) && (home > next));
+        if (movable) {
+            m_slots[gap] = m_slots[next];
+            gap = next;
+        }
+        next = nextSlot(next);
+    }
+    m_slots[gap] = Slot();
+    DEBUG_ASSERT(m_size > 0);
+    --m_size;
+    return 1;
+}
+
+void CachingReaderChunkIndex::clear() {
+    if (m_size > 0) {
+        std::fill(m_slots.begin(), m_slots.end(), Slot());
+        m_size = 0;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef ENGINE_CACHINGREADERCHUNKINDEX_H
+#define ENGINE_CACHINGREADERCHUNKINDEX_H
+
+#include <vector>
+
+#include "util/types.h"
+
+class CachingReaderChunkForOwner;
+
+// A fixed-capacity index that maps chunk indices onto the chunks that
+// are currently allocated by the CachingReader.
+//
+// The table is sized once on construction and never allocates or rehashes
+// afterwards, which makes it safe to use from the engine callback. Chunk
+// indices are mapped directly onto slots (modulo the table size) so that
+// a run of consecutive chunks around the play position never collides.
+// Collisions that occur with hotcues or loops far away from the play
+// position are resolved by linear probing. Removal uses backward-shift
+// deletion and does not leave tombstones behind, i.e. the probe sequences
+// never degrade over time.
+class CachingReaderChunkIndex {
+  public:
+    // The capacity is the maximum number of chunks that will be inserted
+    // at the same time. The table is sized to keep the load factor <= 50%.
+    explicit CachingReaderChunkIndex(SINT capacity);
+
+    // Returns nullptr if no chunk has been inserted for chunkIndex.
+    CachingReaderChunkForOwner* find(SINT chunkIndex) const {
+        SINT slot = slotForChunkIndex(chunkIndex);
+        while (m_slots[slot].pChunk) {
+            if (m_slots[slot].chunkIndex == chunkIndex) {
+                return m_slots[slot].pChunk;
+            }
+            slot = nextSlot(slot);
+        }
+        return nullptr;
+    }
+
+    // Inserts a chunk that must not already be contained in the index.
+    // Returns false if the index is full.
+    bool insert(SINT chunkIndex, CachingReaderChunkForOwner* pChunk);
+
+    // Returns the number of removed chunks, i.e. either 0 or 1.
+    int remove(SINT chunkIndex);
+
+    void clear();
+
+    SINT size() const {
+        return m_size;
+    }
+
+  private:
+    struct Slot {
+        SINT chunkIndex = -1;
+        CachingReaderChunkForOwner* pChunk = nullptr;
+    };
+
+    SINT slotForChunkIndex(SINT chunkIndex) const {
+        return chunkIndex & m_slotMask;
+    }
+    SINT nextSlot(SINT slot) const {
+        return (slot + 1) & m_slotMask;
+    }
+
+    std::vector<Slot> m_slots;
+    const SINT m_slotMask;
+    const SINT m_capacity;
+    SINT m_size;
+};
+
+#endif // ENGINE_CACHINGREADERCHUNKINDEX_H
@@ -0,0 +1,345 @@
+#include "engine/cachingreader/cachingreaderpcmcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "util/counter.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderPcmCache");
+
+const QString kConfigGroup = QStringLiteral("[CachingReader]");
+const ConfigKey kConfigKeyEnabled(kConfigGroup, "PcmCacheEnabled");
+const ConfigKey kConfigKeySizeMB(kConfigGroup, "PcmCacheSizeMB");
+
+// Decoded stereo samples need ~10 MiB per minute at 44.1 kHz
+const int kDefaultCacheSizeMB = 4096;
+
+const char kFileMagic[8] = { 'M', 'I', 'X', 'X', 'X', 'P', 'C', 'M' };
+const quint32 kFileVersion = 1;
+const QString kFileSuffix = QStringLiteral(".pcm");
+
+// The sample data starts at a page boundary
+const qint64 kDataAlignment = 4096;
+
+QDir cacheDir(const UserSettingsPointer& pConfig) {
+    return QDir(pConfig->getSettingsPath() + "/pcmcache");
+}
+
+QString cacheFileName(const UserSettingsPointer& pConfig, const TrackPointer& pTrack) {
+    const QFileInfo fileInfo = pTrack->getFileInfo();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fileInfo.canonicalFilePath().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.size()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    return cacheDir(pConfig).absoluteFilePath(
+            QString::fromLatin1(hash.result().toHex()) + kFileSuffix);
+}
+
+qint64 chunkBytes() {
+    return CachingReaderChunk::kSamples * sizeof(CSAMPLE);
+}
+
+} // anonymous namespace
+
+struct CachingReaderPcmCache::Header {
+    char magic[8];
+    quint32 version;
+    quint32 channelCount;
+    quint32 chunkFrames;
+    quint32 sampleRate;
+    qint64 frameIndexStart;
+    qint64 frameIndexEnd;
+    qint64 lastAccessMSecsSinceEpoch;
+    qint64 dataOffset;
+};
+
+//static
+bool CachingReaderPcmCache::isValidHeader(const Header& header) {
+    // Check all fields that affect the memory layout
+    return (std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) == 0) &&
+            (header.version == kFileVersion) &&
+            (header.channelCount == static_cast<quint32>(CachingReaderChunk::kChannels)) &&
+            (header.chunkFrames == static_cast<quint32>(CachingReaderChunk::kFrames)) &&
+            (header.sampleRate > 0) &&
+            (header.frameIndexStart <= header.frameIndexEnd) &&
+            (header.dataOffset >= static_cast<qint64>(sizeof(Header)));
+}
+
+CachingReaderPcmCache::CachingReaderPcmCache(const QString& fileName)
+        : m_file(fileName),
+          m_pMapped(nullptr) {
+}
+
+CachingReaderPcmCache::~CachingReaderPcmCache() {
+    if (m_pMapped) {
+        m_file.unmap(m_pMapped);
+    }
+}
+
+//static
+bool CachingReaderPcmCache::isEnabled(const UserSettingsPointer& pConfig) {
+    return pConfig && pConfig->getValue(kConfigKeyEnabled, false);
+}
+
+//static
+std::unique_ptr<CachingReaderPcmCache> CachingReaderPcmCache::open(
+        const UserSettingsPointer& pConfig,
+        const TrackPointer& pTrack) {
+    if (!isEnabled(pConfig) || !pTrack) {
+        return nullptr;
+    }
+    const QString fileName = cacheFileName(pConfig, pTrack);
+    if (!QFileInfo(fileName).exists()) {
+        return nullptr;
+    }
+    auto pCache = std::unique_ptr<CachingReaderPcmCache>(
+            new CachingReaderPcmCache(fileName));
+    if (!pCache->m_file.open(QIODevice::ReadWrite) || !pCache->mapFile()) {
+        kLogger.warning()
+                << "Discarding invalid cache file"
+                << fileName;
+        pCache.reset();
+        QFile::remove(fileName);
+        return nullptr;
+    }
+    pCache->header()->lastAccessMSecsSinceEpoch =
+            QDateTime::currentMSecsSinceEpoch();
+    return pCache;
+}
+
+//static
+std::unique_ptr<CachingReaderPcmCache> CachingReaderPcmCache::create(
+        const UserSettingsPointer& pConfig,
+        const TrackPointer& pTrack,
+        SINT sampleRate,
+        mixxx::IndexRange frameIndexRange) {
+    if (!isEnabled(pConfig) || !pTrack) {
+        return nullptr;
+    }
+    const QDir dir = cacheDir(pConfig);
+    if (!dir.exists() && !QDir().mkpath(dir.absolutePath())) {
+        kLogger.warning()
+                << "Failed to create cache directory"
+                << dir.absolutePath();
+        return nullptr;
+    }
+    const QString fileName = cacheFileName(pConfig, pTrack);
+
+    Header header;
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version = kFileVersion;
+    header.channelCount = CachingReaderChunk::kChannels;
+    header.chunkFrames = CachingReaderChunk::kFrames;
+    header.sampleRate = sampleRate;
+    header.frameIndexStart = frameIndexRange.start();
+    header.frameIndexEnd = frameIndexRange.end();
+    header.lastAccessMSecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    const qint64 chunks =
+            (frameIndexRange.length() + CachingReaderChunk::kFrames - 1) /
+            CachingReaderChunk::kFrames;
+    header.dataOffset =
+            ((sizeof(Header) + chunks + kDataAlignment - 1) / kDataAlignment) *
+            kDataAlignment;
+    const qint64 fileSize = header.dataOffset + chunks * chunkBytes();
+
+    // Create the file under a temporary name and rename it afterwards,
+    // because other workers might try to open the same file concurrently.
+    // The file is sparse, i.e. disk space is only occupied for chunks that
+    // have actually been written.
+    const QString tempFileName = fileName + QStringLiteral(".tmp");
+    {
+        QFile tempFile(tempFileName);
+        if (!tempFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+                (tempFile.write(reinterpret_cast<const char*>(&header), sizeof(header)) !=
+                        sizeof(header)) ||
+                !tempFile.resize(fileSize)) {
+            kLogger.warning()
+                    << "Failed to create cache file"
+                    << tempFileName
+                    << tempFile.errorString();
+            tempFile.remove();
+            return nullptr;
+        }
+    }
+    if (!QFile::rename(tempFileName, fileName)) {
+        // Another worker has been faster
+        QFile::remove(tempFileName);
+        return open(pConfig, pTrack);
+    }
+
+    evictLeastRecentlyUsed(pConfig, fileName);
+
+    auto pCache = std::unique_ptr<CachingReaderPcmCache>(
+            new CachingReaderPcmCache(fileName));
+    if (!pCache->m_file.open(QIODevice::ReadWrite) || !pCache->mapFile()) {
+        kLogger.warning()
+                << "Failed to map cache file"
+                << fileName;
+        return nullptr;
+    }
+    return pCache;
+}
+
+//static
+void CachingReaderPcmCache::evictLeastRecentlyUsed(
+        const UserSettingsPointer& pConfig,
+        const QString& keepFileName) {
+    const qint64 maxTotalSize =
+            static_cast<qint64>(pConfig->getValue(kConfigKeySizeMB, kDefaultCacheSizeMB)) *
+            1024 * 1024;
+
+    struct CacheFile {
+        QString fileName;
+        qint64 size;
+        qint64 lastAccess;
+    };
+    std::vector<CacheFile> cacheFiles;
+    qint64 totalSize = 0;
+    const QFileInfoList fileInfos = cacheDir(pConfig).entryInfoList(
+            QStringList() << (QStringLiteral("*") + kFileSuffix), QDir::Files);
+    for (const auto& fileInfo : fileInfos) {
+        QFile file(fileInfo.absoluteFilePath());
+        Header header;
+        if (!file.open(QIODevice::ReadOnly) ||
+                (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)) ||
+                !isValidHeader(header)) {
+            // Remove stale or incompatible files
+            file.close();
+            file.remove();
+            continue;
+        }
+        totalSize += fileInfo.size();
+        if (fileInfo.absoluteFilePath() != keepFileName) {
+            cacheFiles.push_back(CacheFile{
+                    fileInfo.absoluteFilePath(),
+                    fileInfo.size(),
+                    header.lastAccessMSecsSinceEpoch});
+        }
+    }
+    if (totalSize <= maxTotalSize) {
+        return;
+    }
+
+    std::sort(cacheFiles.begin(), cacheFiles.end(),
+            [](const CacheFile& lhs, const CacheFile& rhs) {
+                return lhs.lastAccess < rhs.lastAccess;
+            });
+    for (const auto& cacheFile : cacheFiles) {
+        if (totalSize <= maxTotalSize) {
+            break;
+        }
+        // Files that are still mapped by another worker might not be
+        // removable on all platforms. They will be evicted later.
+        if (QFile::remove(cacheFile.fileName)) {
+            kLogger.debug()
+                    << "Evicted cache file"
+                    << cacheFile.fileName;
+            totalSize -= cacheFile.size;
+            Counter("CachingReaderPcmCache eviction")++;
+        }
+    }
+}
+
+bool CachingReaderPcmCache::mapFile() {
+    const qint64 fileSize = m_file.size();
+    if (fileSize < static_cast<qint64>(sizeof(Header))) {
+        return false;
+    }
+    m_pMapped = m_file.map(0, fileSize);
+    if (!m_pMapped) {
+        return false;
+    }
+    if (!isValidHeader(*header()) ||
+            (fileSize != header()->dataOffset + chunkCount() * chunkBytes())) {
+        m_file.unmap(m_pMapped);
+        m_pMapped = nullptr;
+        return false;
+    }
+    return true;
+}
+
+CachingReaderPcmCache::Header* CachingReaderPcmCache::header() const {
+    DEBUG_ASSERT(m_pMapped);
+    return reinterpret_cast<Header*>(m_pMapped);
+}
+
+uchar* CachingReaderPcmCache::chunkFlags() const {
+    return m_pMapped + sizeof(Header);
+}
+
+CSAMPLE* CachingReaderPcmCache::chunkData(SINT chunkIndex) const {
+    return reinterpret_cast<CSAMPLE*>(
+            m_pMapped + header()->dataOffset + chunkIndex * chunkBytes());
+}
+
+SINT CachingReaderPcmCache::chunkCount() const {
+    return (frameIndexRange().length() + CachingReaderChunk::kFrames - 1) /
+            CachingReaderChunk::kFrames;
+}
+
+SINT CachingReaderPcmCache::sampleRate() const {
+    return header()->sampleRate;
+}
+
+mixxx::IndexRange CachingReaderPcmCache::frameIndexRange() const {
+    return mixxx::IndexRange::between(
+            header()->frameIndexStart,
+            header()->frameIndexEnd);
+}
+
+mixxx::IndexRange CachingReaderPcmCache::chunkFrameIndexRange(SINT chunkIndex) const {
+    return intersect(
+            mixxx::IndexRange::forward(
+                    frameIndexRange().start() + chunkIndex * CachingReaderChunk::kFrames,
+                    CachingReaderChunk::kFrames),
+            frameIndexRange());
+}
+
+mixxx::ReadableSampleFrames CachingReaderPcmCache::readChunk(SINT chunkIndex) const {
+    if ((chunkIndex < 0) || (chunkIndex >= chunkCount()) ||
+            (chunkFlags()[chunkIndex] == 0)) {
+        Counter("CachingReaderPcmCache chunk miss")++;
+        return mixxx::ReadableSampleFrames();
+    }
+    // Pairs with the release fence in writeChunk()
+    std::atomic_thread_fence(std::memory_order_acquire);
+    Counter("CachingReaderPcmCache chunk hit")++;
+    const auto frameIndexRange = chunkFrameIndexRange(chunkIndex);
+    return mixxx::ReadableSampleFrames(
+            frameIndexRange,
+            mixxx::SampleBuffer::ReadableSlice(
+                    chunkData(chunkIndex),
+                    CachingReaderChunk::frames2samples(frameIndexRange.length())));
+}
+
+void CachingReaderPcmCache::writeChunk(
+        SINT chunkIndex,
+        const mixxx::ReadableSampleFrames& sampleFrames) {
+    VERIFY_OR_DEBUG_ASSERT((chunkIndex >= 0) && (chunkIndex < chunkCount())) {
+        return;
+    }
+    // Only complete chunks are cached
+    if (sampleFrames.frameIndexRange() != chunkFrameIndexRange(chunkIndex)) {
+        return;
+    }
+    DEBUG_ASSERT(sampleFrames.readableLength() ==
+            CachingReaderChunk::frames2samples(sampleFrames.frameLength()));
+    std::memcpy(
+            chunkData(chunkIndex),
+            sampleFrames.readableData(),
+            sampleFrames.readableLength() * sizeof(CSAMPLE));
+    // The sample data must be visible before the flag is set
+    std::atomic_thread_fence(std::memory_order_release);
+    chunkFlags()[chunkIndex] = 1;
+}
@@ -0,0 +1,88 @@
+#ifndef ENGINE_CACHINGREADERPCMCACHE_H
+#define ENGINE_CACHINGREADERPCMCACHE_H
+
+#include <QFile>
+#include <QString>
+
+#include "preferences/usersettings.h"
+#include "sources/audiosource.h"
+#include "track/track.h"
+#include "util/memory.h"
+
+// An optional on-disk cache of decoded sample data that allows
+// CachingReaderWorker to load recently played tracks and to seek
+// within them without decoding.
+//
+// Each track is stored in a separate sparse file that is memory mapped
+// and contains the decoded stereo samples of all chunks that have been
+// read from the audio source so far, i.e. the file is filled
+// incrementally while the track is played. A table of flags at the
+// beginning of the file indicates which chunks are available.
+//
+// Cache files are keyed by a hash of the canonical file location, the
+// file size and the modification time of the track file, i.e. they are
+// invalidated implicitly when the file is modified. The total size of
+// all cache files is bounded by evicting the least recently used files
+// whenever a new cache file is created.
+//
+// Instances are not thread-safe and owned by a single worker thread.
+// Multiple workers may open the same cache file concurrently.
+class CachingReaderPcmCache {
+  public:
+    ~CachingReaderPcmCache();
+
+    static bool isEnabled(const UserSettingsPointer& pConfig);
+
+    // Opens an existing cache file for the track. Returns nullptr if
+    // the cache is disabled or no valid cache file exists.
+    static std::unique_ptr<CachingReaderPcmCache> open(
+            const UserSettingsPointer& pConfig,
+            const TrackPointer& pTrack);
+
+    // Creates a new, empty cache file for the track. Returns nullptr
+    // if the cache is disabled or the file could not be created.
+    static std::unique_ptr<CachingReaderPcmCache> create(
+            const UserSettingsPointer& pConfig,
+            const TrackPointer& pTrack,
+            SINT sampleRate,
+            mixxx::IndexRange frameIndexRange);
+
+    SINT sampleRate() const;
+    mixxx::IndexRange frameIndexRange() const;
+
+    // Returns the cached sample frames of the chunk with the given index
+    // or empty sample frames if the chunk is not (yet) cached. The
+    // returned sample data is memory mapped and remains valid until
+    // this object is destroyed.
+    mixxx::ReadableSampleFrames readChunk(SINT chunkIndex) const;
+
+    // Stores the sample frames of a chunk that have been decoded
+    // completely.
+    void writeChunk(
+            SINT chunkIndex,
+            const mixxx::ReadableSampleFrames& sampleFrames);
+
+  private:
+    struct Header;
+
+    explicit CachingReaderPcmCache(const QString& fileName);
+
+    static bool isValidHeader(const Header& header);
+
+    bool mapFile();
+
+    Header* header() const;
+    uchar* chunkFlags() const;
+    CSAMPLE* chunkData(SINT chunkIndex) const;
+    SINT chunkCount() const;
+    mixxx::IndexRange chunkFrameIndexRange(SINT chunkIndex) const;
+
+    static void evictLeastRecentlyUsed(
+            const UserSettingsPointer& pConfig,
+            const QString& keepFileName);
+
+    QFile m_file;
+    uchar* m_pMapped;
+};
+
+#endif // ENGINE_CACHINGREADERPCMCACHE_H
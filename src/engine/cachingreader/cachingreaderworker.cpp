@@ -7,26 +7,45 @@
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "sources/soundsourceproxy.h"
 #include "util/compatibility.h"
+#include "util/counter.h"
 #include "util/event.h"
 #include "util/logger.h"
+#include "util/statid.h"
 
 
 namespace {
 
 mixxx::Logger kLogger("CachingReaderWorker");
 
+const ConfigKey kConfigKeyPersistSeekIndex("[CachingReader]", "PersistSeekIndex");
+
+// The number of read requests that is reserved for reordering them.
+// More requests are only pending if many speculative hints are issued.
+const int kReservedReadRequests = 32;
+
+const SINT kInvalidChunkIndex = -1;
+
+const StatId kSequentialChunkStatId("CachingReaderWorker::sequential_chunk",
+        Stat::COUNTER);
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
         QString group,
+        UserSettingsPointer pConfig,
         FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
         FIFO<ReaderStatusUpdate>* pReaderStatusFIFO)
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
+          m_pConfig(pConfig),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
           m_pReaderStatusFIFO(pReaderStatusFIFO),
           m_newTrackAvailable(false),
+          m_requestedTrackLoads(0),
+          m_finishedTrackLoads(0),
+          m_nextChunkIndex(kInvalidChunkIndex),
           m_stop(0) {
+    m_pendingReadRequests.reserve(kReservedReadRequests);
 }
 
 CachingReaderWorker::~CachingReaderWorker() {
@@ -40,18 +59,40 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
     // Before trying to read any data we need to check if the audio source
     // is available and if any audio data that is needed by the chunk is
     // actually available.
-    const auto chunkFrameIndexRange = pChunk->frameIndexRange(m_pAudioSource);
+    const auto chunkFrameIndexRange = pChunk->frameIndexRange(m_sourceFrameIndexRange);
     if (intersect(chunkFrameIndexRange, m_readableFrameIndexRange).empty()) {
         ReaderStatusUpdate result;
         result.init(CHUNK_READ_INVALID, pChunk, m_readableFrameIndexRange);
         return result;
     }
 
+    // Chunks that have been decoded before are copied from the PCM cache
+    if (m_pPcmCache) {
+        const auto cachedSampleFrames = m_pPcmCache->readChunk(pChunk->getIndex());
+        if (!cachedSampleFrames.frameIndexRange().empty()) {
+            DEBUG_ASSERT(cachedSampleFrames.frameIndexRange() == chunkFrameIndexRange);
+            pChunk->copySampleFrames(cachedSampleFrames);
+            ReaderStatusUpdate result;
+            result.init(CHUNK_READ_SUCCESS, pChunk, m_readableFrameIndexRange);
+            return result;
+        }
+    }
+
+    if (!openAudioSource()) {
+        // Consider all remaining audio data as unreadable
+        m_readableFrameIndexRange = mixxx::IndexRange();
+        ReaderStatusUpdate result;
+        result.init(CHUNK_READ_INVALID, pChunk, m_readableFrameIndexRange);
+        return result;
+    }
+
     // Try to read the data required for the chunk from the audio source
     // and adjust the max. readable frame index if decoding errors occur.
     const mixxx::IndexRange bufferedFrameIndexRange = pChunk->bufferSampleFrames(
             m_pAudioSource,
             mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+    m_nextChunkIndex = bufferedFrameIndexRange.empty() ?
+            kInvalidChunkIndex : pChunk->getIndex() + 1;
     ReaderStatus status = bufferedFrameIndexRange.empty() ? CHUNK_READ_EOF : CHUNK_READ_SUCCESS;
     if (chunkFrameIndexRange != bufferedFrameIndexRange) {
         kLogger.warning()
@@ -78,17 +119,93 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
                 << m_readableFrameIndexRange
                 << "from originally"
                 << m_pAudioSource->frameIndexRange();
+    } else if (m_pPcmCache) {
+        // Only chunks that have been decoded completely are cached
+        m_pPcmCache->writeChunk(pChunk->getIndex(), pChunk->bufferedSampleFrames());
     }
     ReaderStatusUpdate result;
     result.init(status, pChunk, m_readableFrameIndexRange);
     return result;
 }
 
+//static
+int CachingReaderWorker::selectNextReadRequest(
+        const CachingReaderChunkReadRequest* pRequests,
+        int requestCount,
+        SINT nextChunkIndex) {
+    DEBUG_ASSERT(requestCount > 0);
+    int firstRequest = -1;
+    int nextChunkRequest = -1;
+    for (int i = 0; i < requestCount; ++i) {
+        if ((firstRequest < 0) && !pRequests[i].chunk->isSpeculative()) {
+            firstRequest = i;
+        }
+        if ((nextChunkRequest < 0) && (pRequests[i].chunk->getIndex() == nextChunkIndex)) {
+            nextChunkRequest = i;
+        }
+    }
+    if ((nextChunkRequest >= 0) &&
+            (!pRequests[nextChunkRequest].chunk->isSpeculative() || (firstRequest < 0))) {
+        return nextChunkRequest;
+    }
+    if (firstRequest >= 0) {
+        return firstRequest;
+    }
+    return 0;
+}
+
+void CachingReaderWorker::processReadRequests() {
+    while (!m_newTrackAvailable && processNextReadRequest()) {
+    }
+    if (m_newTrackAvailable) {
+        // Cancel the remaining requests before loading the new track
+        for (const auto& request : m_pendingReadRequests) {
+            ReaderStatusUpdate update;
+            update.init(CHUNK_READ_INVALID, request.chunk, m_readableFrameIndexRange);
+            m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        }
+        m_pendingReadRequests.clear();
+    }
+}
+
+bool CachingReaderWorker::processNextReadRequest() {
+    // Requests are collected before selecting each one. A request that
+    // arrives while others are processed must not wait for all of them,
+    // e.g. for the play position after a jump behind speculative ones.
+    const int available = m_pChunkReadRequestFIFO->readAvailable();
+    if (available > 0) {
+        const std::size_t pendingCount = m_pendingReadRequests.size();
+        m_pendingReadRequests.resize(pendingCount + available);
+        const int readCount = m_pChunkReadRequestFIFO->read(
+                &m_pendingReadRequests[pendingCount], available);
+        m_pendingReadRequests.resize(pendingCount + readCount);
+    }
+    if (m_pendingReadRequests.empty()) {
+        return false;
+    }
+
+    const int next = selectNextReadRequest(
+            m_pendingReadRequests.data(),
+            m_pendingReadRequests.size(),
+            m_nextChunkIndex);
+    const CachingReaderChunkReadRequest request = m_pendingReadRequests[next];
+    // Preserve the order of arrival for the remaining requests
+    m_pendingReadRequests.erase(m_pendingReadRequests.begin() + next);
+
+    if (request.chunk->getIndex() == m_nextChunkIndex) {
+        kSequentialChunkStatId.report(1);
+    }
+    const ReaderStatusUpdate update(processReadRequest(request));
+    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    return true;
+}
+
 // WARNING: Always called from a different thread (GUI)
 void CachingReaderWorker::newTrack(TrackPointer pTrack) {
     QMutexLocker locker(&m_newTrackMutex);
     m_pNewTrack = pTrack;
     m_newTrackAvailable = true;
+    m_requestedTrackLoads.ref();
 }
 
 void CachingReaderWorker::run() {
@@ -97,21 +214,21 @@ void CachingReaderWorker::run() {
 
     Event::start(m_tag);
     while (!m_stop.load()) {
-        // Request is initialized by reading from FIFO
-        CachingReaderChunkReadRequest request;
         if (m_newTrackAvailable) {
             TrackPointer pLoadTrack;
+            int trackLoad;
             { // locking scope
                 QMutexLocker locker(&m_newTrackMutex);
                 pLoadTrack = m_pNewTrack;
                 m_pNewTrack.reset();
                 m_newTrackAvailable = false;
+                trackLoad = m_requestedTrackLoads.load();
             } // implicitly unlocks the mutex
             loadTrack(pLoadTrack);
-        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
-            // Read the requested chunk and send the result
-            const ReaderStatusUpdate update(processReadRequest(request));
-            m_pReaderStatusFIFO->writeBlocking(&update, 1);
+            m_finishedTrackLoads.storeRelease(trackLoad);
+        } else if (m_pChunkReadRequestFIFO->readAvailable() > 0) {
+            // Read the requested chunks and send the results
+            processReadRequests();
         } else {
             Event::end(m_tag);
             m_semaRun.acquire();
@@ -132,14 +249,46 @@ mixxx::AudioSourcePointer openAudioSourceForReading(const TrackPointer& pTrack,
 
 } // anonymous namespace
 
+bool CachingReaderWorker::openAudioSource() {
+    if (m_pAudioSource) {
+        return true;
+    }
+    if (!m_pTrack) {
+        return false;
+    }
+
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(CachingReaderChunk::kChannels);
+    // Loading long MP3 files is dominated by scanning all frames
+    if (m_pConfig && m_pConfig->getValue(kConfigKeyPersistSeekIndex, true)) {
+        config.setSeekIndexDir(m_pConfig->getSettingsPath() + "/seekindex");
+    }
+    m_pAudioSource = openAudioSourceForReading(m_pTrack, config);
+    if (!m_pAudioSource) {
+        return false;
+    }
+
+    const SINT tempReadBufferSize = m_pAudioSource->frames2samples(CachingReaderChunk::kFrames);
+    if (m_tempReadBuffer.size() != tempReadBufferSize) {
+        mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
+    }
+    return true;
+}
+
 void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
     ReaderStatusUpdate status;
     status.init(TRACK_NOT_LOADED);
 
+    // Close open file handles and cache files of the previous track
+    m_pTrack.reset();
+    m_pAudioSource.reset();
+    m_pPcmCache.reset();
+    m_sourceFrameIndexRange = mixxx::IndexRange();
+    m_readableFrameIndexRange = mixxx::IndexRange();
+    m_nextChunkIndex = kInvalidChunkIndex;
+
     if (!pTrack) {
         // Unload track
-        m_pAudioSource.reset(); // Close open file handles
-        m_readableFrameIndexRange = mixxx::IndexRange();
         m_pReaderStatusFIFO->writeBlocking(&status, 1);
         return;
     }
@@ -159,11 +308,9 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         return;
     }
 
-    mixxx::AudioSource::OpenParams config;
-    config.setChannelCount(CachingReaderChunk::kChannels);
-    m_pAudioSource = openAudioSourceForReading(pTrack, config);
-    if (!m_pAudioSource) {
-        m_readableFrameIndexRange = mixxx::IndexRange();
+    m_pTrack = pTrack;
+    if (!openAudioSource()) {
+        m_pTrack.reset();
         // Must unlock before emitting to avoid deadlock
         kLogger.debug() << m_group << "loadTrack() load failed for\""
                  << filename << "\", file invalid, unlocked reader lock";
@@ -172,16 +319,38 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             pTrack, QString("The file '%1' could not be loaded.").arg(filename)));
         return;
     }
+    const SINT sampleRate = m_pAudioSource->sampleRate();
+    m_sourceFrameIndexRange = m_pAudioSource->frameIndexRange();
 
-    const SINT tempReadBufferSize = m_pAudioSource->frames2samples(CachingReaderChunk::kFrames);
-    if (m_tempReadBuffer.size() != tempReadBufferSize) {
-        mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
+    // Tracks that have been played recently are read from the PCM cache
+    // instead of decoding them again. The chunks and the reported length
+    // of the track depend on the frame index range, so the cache is
+    // validated against the audio source before the track is reported
+    // as loaded.
+    m_pPcmCache = CachingReaderPcmCache::open(m_pConfig, pTrack);
+    if (m_pPcmCache &&
+            ((m_pPcmCache->sampleRate() != sampleRate) ||
+                    (m_pPcmCache->frameIndexRange() != m_sourceFrameIndexRange))) {
+        kLogger.warning()
+                << "Discarding PCM cache that doesn't match the audio source:"
+                << "cached =" << m_pPcmCache->frameIndexRange()
+                << "@" << m_pPcmCache->sampleRate() << "Hz"
+                << ", actual =" << m_sourceFrameIndexRange
+                << "@" << sampleRate << "Hz";
+        m_pPcmCache.reset();
+    }
+    if (m_pPcmCache) {
+        Counter("CachingReaderPcmCache track hit")++;
+    } else if (CachingReaderPcmCache::isEnabled(m_pConfig)) {
+        Counter("CachingReaderPcmCache track miss")++;
+        m_pPcmCache = CachingReaderPcmCache::create(
+                m_pConfig, pTrack, sampleRate, m_sourceFrameIndexRange);
     }
 
     // Initially assume that the complete content offered by audio source
     // is available for reading. Later if read errors occur this value will
     // be decreased to avoid repeated reading of corrupt audio data.
-    m_readableFrameIndexRange = m_pAudioSource->frameIndexRange();
+    m_readableFrameIndexRange = m_sourceFrameIndexRange;
 
     status.status = TRACK_LOADED;
     status.readableFrameIndexRangeStart = m_readableFrameIndexRange.start();
@@ -200,8 +369,8 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
     // Emit that the track is loaded.
     const SINT sampleCount =
             CachingReaderChunk::frames2samples(
-                    m_pAudioSource->frameLength());
-    emit(trackLoaded(pTrack, m_pAudioSource->sampleRate(), sampleCount));
+                    m_sourceFrameIndexRange.length());
+    emit(trackLoaded(pTrack, sampleRate, sampleCount));
 }
 
 void CachingReaderWorker::quitWait() {
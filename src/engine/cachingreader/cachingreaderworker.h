@@ -7,7 +7,11 @@
 #include <QThread>
 #include <QString>
 
+#include <vector>
+
 #include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderpcmcache.h"
+#include "preferences/usersettings.h"
 #include "track/track.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
@@ -18,9 +22,13 @@
 typedef struct CachingReaderChunkReadRequest {
     CachingReaderChunk* chunk;
 
-    void giveToWorker(CachingReaderChunkForOwner* chunkForOwner) {
+    // A chunk requested by a speculative hint is marked as speculative
+    // until it is hinted again without speculation.
+    void giveToWorker(CachingReaderChunkForOwner* chunkForOwner, bool prefetch = false) {
         DEBUG_ASSERT(chunkForOwner);
         chunk = chunkForOwner;
+        chunkForOwner->setPrefetched(prefetch);
+        chunkForOwner->setSpeculative(prefetch);
         chunkForOwner->giveToWorker();
     }
 } CachingReaderChunkReadRequest;
@@ -64,6 +72,7 @@ class CachingReaderWorker : public EngineWorker {
   public:
     // Construct a CachingReader with the given group.
     CachingReaderWorker(QString group,
+            UserSettingsPointer pConfig,
             FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
             FIFO<ReaderStatusUpdate>* pReaderStatusFIFO);
     virtual ~CachingReaderWorker();
@@ -71,12 +80,35 @@ class CachingReaderWorker : public EngineWorker {
     // Request to load a new track. wake() must be called afterwards.
     virtual void newTrack(TrackPointer pTrack);
 
+    // Returns true from the request to load a new track until the track
+    // has been loaded or failed to load, i.e. until after its status
+    // update has been written and the load signals have been emitted.
+    bool isLoadingTrack() const {
+        return m_requestedTrackLoads.loadAcquire() !=
+                m_finishedTrackLoads.loadAcquire();
+    }
+
     // Run upkeep operations like loading tracks and reading from file. Run by a
     // thread pool via the EngineWorkerScheduler.
     virtual void run();
 
     void quitWait();
 
+    // Selects the pending read request that should be processed next.
+    // Requests from non-speculative hints are processed in the order of
+    // their arrival, except that a request for the chunk that follows
+    // the last decoded chunk continues decoding without repositioning
+    // the audio source. Speculative requests are processed last.
+    static int selectNextReadRequest(
+            const CachingReaderChunkReadRequest* pRequests,
+            int requestCount,
+            SINT nextChunkIndex);
+
+    // Collects the requests that have arrived since the last call and
+    // processes the one selected by selectNextReadRequest(). Returns
+    // false if no request is pending. Only called by the worker thread.
+    bool processNextReadRequest();
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -86,6 +118,7 @@ class CachingReaderWorker : public EngineWorker {
   private:
     QString m_group;
     QString m_tag;
+    const UserSettingsPointer m_pConfig;
 
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
@@ -97,16 +130,37 @@ class CachingReaderWorker : public EngineWorker {
     QMutex m_newTrackMutex;
     bool m_newTrackAvailable;
     TrackPointer m_pNewTrack;
+    // Counts the calls of newTrack(). Loading a track finishes all
+    // requests before it, because only the last new track is loaded.
+    QAtomicInt m_requestedTrackLoads;
+    QAtomicInt m_finishedTrackLoads;
 
     // Internal method to load a track. Emits trackLoaded when finished.
     void loadTrack(const TrackPointer& pTrack);
 
+    // Processes pending requests until none is left or a new track
+    // needs to be loaded.
+    void processReadRequests();
+
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    // Opens the audio source of the current track unless it is open
+    bool openAudioSource();
+
+    // The track that is currently loaded
+    TrackPointer m_pTrack;
+
     // The current audio source of the track loaded
     mixxx::AudioSourcePointer m_pAudioSource;
 
+    // The optional cache of decoded samples for the track loaded. Only
+    // used if it matches the audio source.
+    std::unique_ptr<CachingReaderPcmCache> m_pPcmCache;
+
+    // The frame index range of the audio source
+    mixxx::IndexRange m_sourceFrameIndexRange;
+
     // Temporary buffer for reading samples from all channels
     // before conversion to a stereo signal.
     mixxx::SampleBuffer m_tempReadBuffer;
@@ -118,6 +172,14 @@ class CachingReaderWorker : public EngineWorker {
     // last frame with readable sample data.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The index of the chunk at the current position of the audio
+    // source, i.e. following the chunk that has been decoded last.
+    SINT m_nextChunkIndex;
+
+    // Requests that have been read from m_pChunkReadRequestFIFO and
+    // not been processed yet, in the order of their arrival.
+    std::vector<CachingReaderChunkReadRequest> m_pendingReadRequests;
+
     QAtomicInt m_stop;
 };
 
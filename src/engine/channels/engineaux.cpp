@@ -17,7 +17,8 @@ EngineAux::EngineAux(const ChannelHandleAndGroup& handle_group, EffectsManager*
         : EngineChannel(handle_group, EngineChannel::CENTER, pEffectsManager),
           m_pInputConfigured(new ControlObject(ConfigKey(getGroup(), "input_configured"))),
           m_pPregain(new ControlAudioTaperPot(ConfigKey(getGroup(), "pregain"), -12, 12, 0.5)),
-          m_wasActive(false) {
+          m_wasActive(false),
+          m_bApplyPreFaderEffects(false) {
     // Make input_configured read-only.
     m_pInputConfigured->setReadOnly();
     ControlDoublePrivate::insertAlias(ConfigKey(getGroup(), "enabled"),
@@ -71,19 +72,32 @@ void EngineAux::receiveBuffer(AudioInput input, const CSAMPLE* pBuffer,
 }
 
 void EngineAux::process(CSAMPLE* pOut, const int iBufferSize) {
+    processInput(pOut, iBufferSize);
+    processPreFaderEffects(pOut, iBufferSize);
+}
+
+void EngineAux::processInput(CSAMPLE* pOut, const int iBufferSize) {
     const CSAMPLE* sampleBuffer = m_sampleBuffer; // save pointer on stack
     double pregain = m_pPregain->get();
     if (sampleBuffer) {
         SampleUtil::copyWithGain(pOut, sampleBuffer, pregain, iBufferSize);
+        m_sampleBuffer = NULL;
+        m_bApplyPreFaderEffects = true;
+    } else {
+        SampleUtil::clear(pOut, iBufferSize);
+        m_bApplyPreFaderEffects = false;
+    }
+}
+
+void EngineAux::processPreFaderEffects(CSAMPLE* pOut, const int iBufferSize) {
+    if (m_bApplyPreFaderEffects) {
         EngineEffectsManager* pEngineEffectsManager = m_pEffectsManager->getEngineEffectsManager();
         if (pEngineEffectsManager != nullptr) {
             pEngineEffectsManager->processPreFaderInPlace(
                 m_group.handle(), m_pEffectsManager->getMasterHandle(),
                 pOut, iBufferSize, m_pSampleRate->get());
         }
-        m_sampleBuffer = NULL;
-    } else {
-        SampleUtil::clear(pOut, iBufferSize);
+        m_bApplyPreFaderEffects = false;
     }
 
     // Update VU meter
@@ -27,6 +27,8 @@ class EngineAux : public EngineChannel, public AudioDestination {
 
     // Called by EngineMaster whenever is requesting a new buffer of audio.
     virtual void process(CSAMPLE* pOutput, const int iBufferSize);
+    virtual void processInput(CSAMPLE* pOutput, const int iBufferSize);
+    virtual void processPreFaderEffects(CSAMPLE* pOutput, const int iBufferSize);
     virtual void collectFeatures(GroupFeatureState* pGroupFeatures) const;
     virtual void postProcess(const int iBufferSize) { Q_UNUSED(iBufferSize) }
 
@@ -50,6 +52,8 @@ class EngineAux : public EngineChannel, public AudioDestination {
     QScopedPointer<ControlObject> m_pInputConfigured;
     ControlAudioTaperPot* m_pPregain;
     bool m_wasActive;
+    // Set by processInput() if samples have been received
+    bool m_bApplyPreFaderEffects;
 };
 
 #endif // ENGINEAUX_H
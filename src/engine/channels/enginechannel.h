@@ -65,6 +65,21 @@ class EngineChannel : public EngineObject {
     inline bool isTalkoverChannel() { return m_bIsTalkoverChannel; };
 
     virtual void process(CSAMPLE* pOut, const int iBufferSize) = 0;
+
+    // Splits process() into two stages for EngineMaster, which might
+    // process the channels concurrently. processInput() only touches the
+    // state of this channel. The pre-fader effects share their state
+    // between all channels, so processPreFaderEffects() must be invoked
+    // for one channel at a time after processInput() has finished for
+    // all channels. By default everything is processed in processInput().
+    virtual void processInput(CSAMPLE* pOut, const int iBufferSize) {
+        process(pOut, iBufferSize);
+    }
+    virtual void processPreFaderEffects(CSAMPLE* pOut, const int iBufferSize) {
+        Q_UNUSED(pOut);
+        Q_UNUSED(iBufferSize);
+    }
+
     virtual void collectFeatures(GroupFeatureState* pGroupFeatures) const = 0;
     virtual void postProcess(const int iBuffersize) = 0;
 
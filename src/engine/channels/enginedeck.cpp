@@ -23,6 +23,8 @@
 #include "engine/enginebuffer.h"
 #include "engine/enginepregain.h"
 #include "engine/enginevumeter.h"
+#include "util/assert.h"
+#include "util/defs.h"
 #include "util/sample.h"
 #include "waveform/waveformwidgetfactory.h"
 
@@ -35,9 +37,11 @@ EngineDeck::EngineDeck(const ChannelHandleAndGroup& handle_group,
           m_pConfig(pConfig),
           m_pInputConfigured(new ControlObject(ConfigKey(getGroup(), "input_configured"))),
           m_pPassing(new ControlPushButton(ConfigKey(getGroup(), "passthrough"))),
+          m_pPassthroughBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
           // Need a +1 here because the CircularBuffer only allows its size-1
           // items to be held at once (it keeps a blank spot open persistently)
-          m_wasActive(false) {
+          m_wasActive(false),
+          m_bPreFaderEffectsPending(false) {
     m_pInputConfigured->setReadOnly();
     // Set up passthrough utilities and fields
     m_pPassing->setButtonMode(ControlPushButton::POWERWINDOW);
@@ -55,11 +59,19 @@ EngineDeck::EngineDeck(const ChannelHandleAndGroup& handle_group,
 
 EngineDeck::~EngineDeck() {
     delete m_pPassing;
+    SampleUtil::free(m_pPassthroughBuffer);
     delete m_pBuffer;
     delete m_pPregain;
 }
 
 void EngineDeck::process(CSAMPLE* pOut, const int iBufferSize) {
+    processInput(pOut, iBufferSize);
+    processPreFaderEffects(pOut, iBufferSize);
+}
+
+void EngineDeck::processInput(CSAMPLE* pOut, const int iBufferSize) {
+    m_bPreFaderEffectsPending = false;
+
     // Feed the incoming audio through if passthrough is active
     const CSAMPLE* sampleBuffer = m_sampleBuffer; // save pointer on stack
     if (isPassthroughActive() && sampleBuffer) {
@@ -83,6 +95,14 @@ void EngineDeck::process(CSAMPLE* pOut, const int iBufferSize) {
 
     // Apply pregain
     m_pPregain->process(pOut, iBufferSize);
+    m_bPreFaderEffectsPending = true;
+}
+
+void EngineDeck::processPreFaderEffects(CSAMPLE* pOut, const int iBufferSize) {
+    if (!m_bPreFaderEffectsPending) {
+        return;
+    }
+    m_bPreFaderEffectsPending = false;
 
     EngineEffectsManager* pEngineEffectsManager = m_pEffectsManager->getEngineEffectsManager();
     if (pEngineEffectsManager != nullptr) {
@@ -136,6 +156,19 @@ void EngineDeck::receiveBuffer(AudioInput input, const CSAMPLE* pBuffer, unsigne
     }
 }
 
+void EngineDeck::receiveView(AudioInput input, const AudioInputView& view,
+                             unsigned int nFrames) {
+    Q_UNUSED(input);
+    // Skip copying the audio input if passthrough is not active
+    if (!m_bPassthroughIsActive) {
+        m_sampleBuffer = NULL;
+        return;
+    }
+    DEBUG_ASSERT(nFrames * 2 <= MAX_BUFFER_LEN);
+    view.copyStereo(m_pPassthroughBuffer, 0, nFrames);
+    m_sampleBuffer = m_pPassthroughBuffer;
+}
+
 void EngineDeck::onInputConfigured(AudioInput input) {
     if (input.getType() != AudioPath::VINYLCONTROL) {
         // This is an error!
@@ -46,6 +46,8 @@ class EngineDeck : public EngineChannel, public AudioDestination {
     virtual ~EngineDeck();
 
     virtual void process(CSAMPLE* pOutput, const int iBufferSize);
+    virtual void processInput(CSAMPLE* pOutput, const int iBufferSize);
+    virtual void processPreFaderEffects(CSAMPLE* pOutput, const int iBufferSize);
     virtual void collectFeatures(GroupFeatureState* pGroupFeatures) const;
     virtual void postProcess(const int iBufferSize);
 
@@ -62,6 +64,16 @@ class EngineDeck : public EngineChannel, public AudioDestination {
     virtual void receiveBuffer(AudioInput input, const CSAMPLE* pBuffer,
                                unsigned int nFrames);
 
+    // The deck shares the vinyl control input with VinylControlProcessor
+    // but only needs the samples while passthrough is active. Receiving
+    // views avoids copying the timecode signal on every callback
+    // otherwise.
+    virtual bool receivesInputViews() const {
+        return true;
+    }
+    virtual void receiveView(AudioInput input, const AudioInputView& view,
+                             unsigned int nFrames);
+
     // Called by SoundManager whenever the passthrough input is connected to a
     // soundcard input.
     virtual void onInputConfigured(AudioInput input);
@@ -84,9 +96,15 @@ class EngineDeck : public EngineChannel, public AudioDestination {
     // Begin vinyl passthrough fields
     QScopedPointer<ControlObject> m_pInputConfigured;
     ControlPushButton* m_pPassing;
+    // The passthrough samples copied from the input views
+    CSAMPLE* m_pPassthroughBuffer;
     bool m_bPassthroughIsActive;
     bool m_bPassthroughWasActive;
     bool m_wasActive;
+    // Set by processInput() unless the deck has just been silenced
+    bool m_bPreFaderEffectsPending;
+
+    friend class SoundManagerRoutingTest;
 };
 
 #endif
@@ -17,7 +17,8 @@ EngineMicrophone::EngineMicrophone(const ChannelHandleAndGroup& handle_group,
         : EngineChannel(handle_group, EngineChannel::CENTER, pEffectsManager, true),
           m_pInputConfigured(new ControlObject(ConfigKey(getGroup(), "input_configured"))),
           m_pPregain(new ControlAudioTaperPot(ConfigKey(getGroup(), "pregain"), -12, 12, 0.5)),
-          m_wasActive(false) {
+          m_wasActive(false),
+          m_bApplyPreFaderEffects(false) {
     // Make input_configured read-only.
     m_pInputConfigured->setReadOnly();
     ControlDoublePrivate::insertAlias(ConfigKey(getGroup(), "enabled"),
@@ -69,22 +70,35 @@ void EngineMicrophone::receiveBuffer(AudioInput input, const CSAMPLE* pBuffer,
 }
 
 void EngineMicrophone::process(CSAMPLE* pOut, const int iBufferSize) {
+    processInput(pOut, iBufferSize);
+    processPreFaderEffects(pOut, iBufferSize);
+}
+
+void EngineMicrophone::processInput(CSAMPLE* pOut, const int iBufferSize) {
     // If configured read into the output buffer.
     // Otherwise, skip the appropriate number of samples to throw them away.
     const CSAMPLE* sampleBuffer = m_sampleBuffer; // save pointer on stack
     double pregain =  m_pPregain->get();
     if (sampleBuffer) {
         SampleUtil::copyWithGain(pOut, sampleBuffer, pregain, iBufferSize);
+        m_bApplyPreFaderEffects = true;
+    } else {
+        SampleUtil::clear(pOut, iBufferSize);
+        m_bApplyPreFaderEffects = false;
+    }
+    m_sampleBuffer = NULL;
+}
+
+void EngineMicrophone::processPreFaderEffects(CSAMPLE* pOut, const int iBufferSize) {
+    if (m_bApplyPreFaderEffects) {
         EngineEffectsManager* pEngineEffectsManager = m_pEffectsManager->getEngineEffectsManager();
         if (pEngineEffectsManager != nullptr) {
             pEngineEffectsManager->processPreFaderInPlace(
                 m_group.handle(), m_pEffectsManager->getMasterHandle(),
                 pOut, iBufferSize, m_pSampleRate->get());
         }
-    } else {
-        SampleUtil::clear(pOut, iBufferSize);
+        m_bApplyPreFaderEffects = false;
     }
-    m_sampleBuffer = NULL;
 
     // Update VU meter
     m_vuMeter.process(pOut, iBufferSize);
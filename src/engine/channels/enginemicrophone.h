@@ -30,6 +30,8 @@ class EngineMicrophone : public EngineChannel, public AudioDestination {
 
     // Called by EngineMaster whenever is requesting a new buffer of audio.
     virtual void process(CSAMPLE* pOutput, const int iBufferSize);
+    virtual void processInput(CSAMPLE* pOutput, const int iBufferSize);
+    virtual void processPreFaderEffects(CSAMPLE* pOutput, const int iBufferSize);
     virtual void collectFeatures(GroupFeatureState* pGroupFeatures) const;
     virtual void postProcess(const int iBufferSize) { Q_UNUSED(iBufferSize) }
 
@@ -57,6 +59,8 @@ class EngineMicrophone : public EngineChannel, public AudioDestination {
     ControlAudioTaperPot* m_pPregain;
 
     bool m_wasActive;
+    // Set by processInput() if samples have been received
+    bool m_bApplyPreFaderEffects;
 };
 
 #endif /* ENGINEMICROPHONE_H */
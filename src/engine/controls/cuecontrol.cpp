@@ -565,6 +565,23 @@ void CueControl::hintReader(HintVector* pHintList) {
             pHintList->append(cue_hint);
         }
     }
+
+    // Speculatively read the audio that follows the cue points for
+    // continuing playback without cache misses after jumping
+    Hint prefetch_hint;
+    prefetch_hint.frameCount = Hint::kFrameCountPrefetch;
+    prefetch_hint.priority = Hint::kPriorityPrefetch;
+    if (cuePoint >= 0) {
+        prefetch_hint.frame = SampleUtil::floorPlayPosToFrame(cuePoint);
+        pHintList->append(prefetch_hint);
+    }
+    for (const auto& pControl: m_hotcueControls) {
+        double position = pControl->getPosition();
+        if (position != -1) {
+            prefetch_hint.frame = SampleUtil::floorPlayPosToFrame(position);
+            pHintList->append(prefetch_hint);
+        }
+    }
 }
 
 // Moves the cue point to current position or to closest beat in case
@@ -435,6 +435,11 @@ void LoopingControl::hintReader(HintVector* pHintList) {
             loop_hint.frame = SampleUtil::floorPlayPosToFrame(loopSamples.start);
             loop_hint.frameCount = Hint::kFrameCountForward;
             pHintList->append(loop_hint);
+            // Playback continues after jumping back to the loop in
+            // position and needs more than the first frames
+            loop_hint.priority = Hint::kPriorityPrefetch;
+            loop_hint.frameCount = Hint::kFrameCountPrefetch;
+            pHintList->append(loop_hint);
         }
         if (loopSamples.end >= 0) {
             loop_hint.priority = 10;
@@ -35,6 +35,11 @@ class EngineEffect : public EffectsRequestHandler {
 
     EffectState* createState(const mixxx::EngineParameters& bufferParameters);
 
+    // Thread-safe
+    std::size_t stateMemoryBytes() const {
+        return m_pProcessor ? m_pProcessor->stateMemoryBytes() : 0;
+    }
+
     void loadStatesForInputChannel(const ChannelHandle* inputChannel,
       EffectStatesMap* pStatesMap);
     void deleteStatesForInputChannel(const ChannelHandle* inputChannel);
@@ -50,6 +55,16 @@ class EngineEffect : public EffectsRequestHandler {
                  const EffectEnableState chainEnableState,
                  const GroupFeatureState& groupFeatures);
 
+    // Returns true if process() would call the EffectProcessor for this
+    // routing with the given chain state. Does not modify any state.
+    bool isActiveForChannel(const ChannelHandle& inputHandle,
+                            const ChannelHandle& outputHandle,
+                            const EffectEnableState chainEnableState) {
+        return chainEnableState != EffectEnableState::Disabled &&
+                m_effectEnableStateForChannelMatrix[inputHandle][outputHandle] !=
+                        EffectEnableState::Disabled;
+    }
+
     const EffectManifestPointer getManifest() const {
         return m_pManifest;
     }
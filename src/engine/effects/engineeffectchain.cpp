@@ -226,12 +226,45 @@ EngineEffectChain::ChannelStatus& EngineEffectChain::getChannelStatus(
     return status;
 }
 
+bool EngineEffectChain::isActiveForChannel(const ChannelHandle& inputHandle,
+                                           const ChannelHandle& outputHandle) {
+    const EffectEnableState effectiveChainEnableState = effectiveEnableState(
+            m_chainStatusForChannelMatrix[inputHandle][outputHandle]);
+    if (effectiveChainEnableState == EffectEnableState::Disabled) {
+        return false;
+    }
+    for (EngineEffect* pEffect: m_effects) {
+        if (pEffect != nullptr
+                && pEffect->isActiveForChannel(inputHandle, outputHandle,
+                                               effectiveChainEnableState)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                                 const ChannelHandle& outputHandle,
                                 CSAMPLE* pIn, CSAMPLE* pOut,
                                 const unsigned int numSamples,
                                 const unsigned int sampleRate,
                                 const GroupFeatureState& groupFeatures) {
+    return processInner(inputHandle, outputHandle, pIn, pOut,
+                        numSamples, sampleRate, groupFeatures, false);
+}
+
+bool EngineEffectChain::processAndMix(const ChannelHandle& inputHandle,
+                                      const ChannelHandle& outputHandle,
+                                      CSAMPLE* pIn, CSAMPLE* pOut,
+                                      const unsigned int numSamples,
+                                      const unsigned int sampleRate,
+                                      const GroupFeatureState& groupFeatures) {
+    return processInner(inputHandle, outputHandle, pIn, pOut,
+                        numSamples, sampleRate, groupFeatures, true);
+}
+
+EffectEnableState EngineEffectChain::effectiveEnableState(
+        const ChannelStatus& channelStatus) const {
     // Compute the effective enable state from the channel input routing switch and
     // the chain's enable state. When either of these are turned on/off, send the
     // effects the intermediate enabling/disabling signal.
@@ -239,8 +272,6 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
     // intermediate state down to the EffectProcessor, which is then responsible for reacting
     // appropriately, for example the Echo effect clears its internal buffer for the channel
     // when it gets the intermediate disabling signal.
-
-    ChannelStatus& channelStatus = m_chainStatusForChannelMatrix[inputHandle][outputHandle];
     EffectEnableState effectiveChainEnableState = channelStatus.enableState;
 
     // If the channel is fully disabled, do not let intermediate
@@ -251,6 +282,19 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
             effectiveChainEnableState = m_enableState;
         }
     }
+    return effectiveChainEnableState;
+}
+
+bool EngineEffectChain::processInner(const ChannelHandle& inputHandle,
+                                     const ChannelHandle& outputHandle,
+                                     CSAMPLE* pIn, CSAMPLE* pOut,
+                                     const unsigned int numSamples,
+                                     const unsigned int sampleRate,
+                                     const GroupFeatureState& groupFeatures,
+                                     const bool mixIntoOutput) {
+    ChannelStatus& channelStatus = m_chainStatusForChannelMatrix[inputHandle][outputHandle];
+    const EffectEnableState effectiveChainEnableState =
+            effectiveEnableState(channelStatus);
 
     CSAMPLE currentMixKnob = m_dMix;
     CSAMPLE lastCallbackMixKnob = channelStatus.oldMixKnob;
@@ -293,9 +337,8 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                                 && m_mixMode == EffectChainMixMode::DryPlusWet;
 
                         if (!skipAddingDry) {
-                            for (SINT i = 0; i <= static_cast<SINT>(numSamples); ++i) {
-                                pIntermediateOutput[i] += pIntermediateInput[i];
-                            }
+                            SampleUtil::add(pIntermediateOutput,
+                                    pIntermediateInput, numSamples);
                         }
 
                         firstAddDryToWetEffectProcessed = true;
@@ -311,18 +354,26 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         if (processingOccured) {
             // pIntermediateInput is the output of the last processed effect. It would be the
             // intermediate input of the next effect if there was one.
+            CSAMPLE_GAIN lastCallbackDryGain = 1.0;
+            CSAMPLE_GAIN currentDryGain = 1.0;
             if (m_mixMode == EffectChainMixMode::DrySlashWet) {
                 // Dry/Wet mode: output = (input * (1-mix knob)) + (wet * mix knob)
-                SampleUtil::copy2WithRampingGain(
+                lastCallbackDryGain = 1.0 - lastCallbackMixKnob;
+                currentDryGain = 1.0 - currentMixKnob;
+            }
+            // Dry+Wet mode: output = input + (wet * mix knob)
+            if (mixIntoOutput) {
+                // The dry/wet mix is accumulated into the output in the same
+                // pass instead of being copied into it and added later.
+                SampleUtil::add2WithRampingGain(
                         pOut,
-                        pIn, 1.0 - lastCallbackMixKnob, 1.0 - currentMixKnob,
+                        pIn, lastCallbackDryGain, currentDryGain,
                         pIntermediateInput, lastCallbackMixKnob, currentMixKnob,
                         numSamples);
             } else {
-                // Dry+Wet mode: output = input + (wet * mix knob)
                 SampleUtil::copy2WithRampingGain(
                         pOut,
-                        pIn, 1.0, 1.0,
+                        pIn, lastCallbackDryGain, currentDryGain,
                         pIntermediateInput, lastCallbackMixKnob, currentMixKnob,
                         numSamples);
             }
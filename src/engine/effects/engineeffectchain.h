@@ -34,6 +34,22 @@ class EngineEffectChain : public EffectsRequestHandler {
                  const unsigned int sampleRate,
                  const GroupFeatureState& groupFeatures);
 
+    // Like process(), but adds the output of the chain to pOut instead of
+    // overwriting it. This fuses the dry/wet mix of the chain with mixing
+    // the channel into the output.
+    bool processAndMix(const ChannelHandle& inputHandle,
+                       const ChannelHandle& outputHandle,
+                       CSAMPLE* pIn, CSAMPLE* pOut,
+                       const unsigned int numSamples,
+                       const unsigned int sampleRate,
+                       const GroupFeatureState& groupFeatures);
+
+    // Returns true if process() would process any effect for this routing
+    // in the current callback, i.e. if it would write to its output buffer.
+    // Does not modify any state.
+    bool isActiveForChannel(const ChannelHandle& inputHandle,
+                            const ChannelHandle& outputHandle);
+
     const QString& id() const {
         return m_id;
     }
@@ -56,6 +72,15 @@ class EngineEffectChain : public EffectsRequestHandler {
         return QString("EngineEffectChain(%1)").arg(m_id);
     }
 
+    EffectEnableState effectiveEnableState(const ChannelStatus& channelStatus) const;
+    bool processInner(const ChannelHandle& inputHandle,
+                      const ChannelHandle& outputHandle,
+                      CSAMPLE* pIn, CSAMPLE* pOut,
+                      const unsigned int numSamples,
+                      const unsigned int sampleRate,
+                      const GroupFeatureState& groupFeatures,
+                      const bool mixIntoOutput);
+
     bool updateParameters(const EffectsRequest& message);
     bool addEffect(EngineEffect* pEffect, int iIndex);
     bool removeEffect(EngineEffect* pEffect, int iIndex);
@@ -31,6 +31,11 @@ class EngineEffectRack : public EffectsRequestHandler {
         return m_iRackNumber;
     }
 
+    // May contain nullptr for empty chain slots
+    const QList<EngineEffectChain*>& chains() const {
+        return m_chains;
+    }
+
   private:
     bool addEffectChain(EngineEffectChain* pChain, int iIndex);
     bool removeEffectChain(EngineEffectChain* pChain, int iIndex);
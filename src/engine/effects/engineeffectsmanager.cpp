@@ -193,25 +193,55 @@ void EngineEffectsManager::processInner(
         }
     } else {
         // Do not modify the input buffer.
-        // 1. Copy input buffer to a temporary buffer
-        // 2. Apply gain to temporary buffer
-        // 2. Process temporary buffer with each effect rack in series
-        // 3. Mix the temporary buffer into pOut
-        //    ChannelMixer::applyEffectsAndMixChannels use
-        //    this to mix channels into pOut regardless of whether any effects were processed.
-        CSAMPLE* pIntermediateInput = m_buffer1.data();
-        if (oldGain == CSAMPLE_GAIN_ONE && newGain == CSAMPLE_GAIN_ONE) {
-            // Avoid an unnecessary copy. EngineEffectRack::process does not modify the
-            // input buffer when its input & output buffers are different, so this is okay.
-            pIntermediateInput = pIn;
-        } else {
+        // 1. Copy input buffer to a temporary buffer and apply gain
+        // 2. Process temporary buffer with each effect chain of each rack in series
+        // 3. Mix the output of the last processing chain into pOut in the same
+        //    pass as the dry/wet mix of that chain
+        // ChannelMixer::applyEffectsAndMixChannels uses this to mix channels
+        // into pOut regardless of whether any effects were processed.
+        EngineEffectChain* pLastActiveChain = nullptr;
+        for (EngineEffectRack* pRack : racks) {
+            if (pRack == nullptr) {
+                continue;
+            }
+            for (EngineEffectChain* pChain : pRack->chains()) {
+                if (pChain != nullptr &&
+                        pChain->isActiveForChannel(inputHandle, outputHandle)) {
+                    pLastActiveChain = pChain;
+                }
+            }
+        }
+
+        CSAMPLE* pIntermediateInput = pIn;
+        if (pLastActiveChain == nullptr) {
+            // Nothing to process, mix the input into pOut directly
+            SampleUtil::addWithRampingGain(pOut, pIn, oldGain, newGain, numSamples);
+        } else if (oldGain != CSAMPLE_GAIN_ONE || newGain != CSAMPLE_GAIN_ONE) {
+            // Otherwise avoid an unnecessary copy. EngineEffectChain::process
+            // does not modify the input buffer when its input & output buffers
+            // are different, so this is okay.
+            pIntermediateInput = m_buffer1.data();
             SampleUtil::copyWithRampingGain(pIntermediateInput, pIn,
                                             oldGain, newGain, numSamples);
         }
 
+        // Inactive chains are processed as well to update their enable
+        // states, but they neither read nor write any samples.
         CSAMPLE* pIntermediateOutput;
         for (EngineEffectRack* pRack : racks) {
-            if (pRack != nullptr) {
+            if (pRack == nullptr) {
+                continue;
+            }
+            for (EngineEffectChain* pChain : pRack->chains()) {
+                if (pChain == nullptr) {
+                    continue;
+                }
+                if (pChain == pLastActiveChain) {
+                    pChain->processAndMix(inputHandle, outputHandle,
+                                          pIntermediateInput, pOut,
+                                          numSamples, sampleRate, groupFeatures);
+                    continue;
+                }
                 // Select an unused intermediate buffer for the next output
                 if (pIntermediateInput == m_buffer1.data()) {
                     pIntermediateOutput = m_buffer2.data();
@@ -219,17 +249,14 @@ void EngineEffectsManager::processInner(
                     pIntermediateOutput = m_buffer1.data();
                 }
 
-                if (pRack->process(inputHandle, outputHandle,
-                                   pIntermediateInput, pIntermediateOutput,
-                                   numSamples, sampleRate, groupFeatures)) {
-                    // Output of this rack becomes the input of the next rack.
+                if (pChain->process(inputHandle, outputHandle,
+                                    pIntermediateInput, pIntermediateOutput,
+                                    numSamples, sampleRate, groupFeatures)) {
+                    // Output of this chain becomes the input of the next chain.
                     pIntermediateInput = pIntermediateOutput;
                 }
             }
         }
-        // pIntermediateInput is the output of the last processed rack. It would be the
-        // intermediate input of the next rack if there was one.
-        SampleUtil::add(pOut, pIntermediateInput, numSamples);
     }
 }
 
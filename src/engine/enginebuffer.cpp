@@ -48,6 +48,9 @@ const double kLinearScalerElipsis = 1.00058; // 2^(0.01/12): changes < 1 cent al
 
 const SINT kSamplesPerFrame = 2; // Engine buffer uses Stereo frames only
 
+const StatId kProcessPauseLockStatId("EngineBuffer::process_pauselock",
+        Stat::DURATION_NANOSEC);
+
 } // anonymous namespace
 
 EngineBuffer::EngineBuffer(const QString& group, UserSettingsPointer pConfig,
@@ -695,7 +698,7 @@ void EngineBuffer::slotKeylockEngineChanged(double dIndex) {
 
 void EngineBuffer::processTrackLocked(
         CSAMPLE* pOutput, const int iBufferSize, int sample_rate) {
-    ScopedTimer t("EngineBuffer::process_pauselock");
+    ScopedStatTimer t(kProcessPauseLockStatId);
 
     m_trackSampleRateOld = m_pTrackSampleRate->get();
     m_trackSamplesOld = m_pTrackSamples->get();
@@ -141,6 +141,11 @@ class EngineBuffer : public EngineObject {
 
     QString getGroup();
     bool isTrackLoaded();
+    // Returns true while audio data that has been requested from the
+    // reader is pending, see CachingReader::hasPendingReads().
+    bool hasPendingReads() {
+        return m_pReader->hasPendingReads();
+    }
     TrackPointer getLoadedTrack() const;
 
     double getExactPlayPos();
@@ -29,6 +29,15 @@
 #include "util/timer.h"
 #include "util/trace.h"
 
+namespace {
+
+const StatId kProcessStatId("EngineMaster::process",
+        Stat::DURATION_NANOSEC);
+const StatId kProcessChannelsStatId("EngineMaster::processChannels",
+        Stat::DURATION_NANOSEC);
+
+} // anonymous namespace
+
 EngineMaster::EngineMaster(UserSettingsPointer pConfig,
                            const char* group,
                            EffectsManager* pEffectsManager,
@@ -36,6 +45,8 @@ EngineMaster::EngineMaster(UserSettingsPointer pConfig,
                            bool bEnableSidechain)
         : m_pChannelHandleFactory(pChannelHandleFactory),
           m_pEngineEffectsManager(pEffectsManager ? pEffectsManager->getEngineEffectsManager() : NULL),
+          m_pParallelProcessor(nullptr),
+          m_processChannelsTask(this),
           m_masterGainOld(0.0),
           m_boothGainOld(0.0),
           m_headphoneMasterGainOld(0.0),
@@ -66,6 +77,14 @@ EngineMaster::EngineMaster(UserSettingsPointer pConfig,
     m_pWorkerScheduler = new EngineWorkerScheduler(this);
     m_pWorkerScheduler->start(QThread::HighPriority);
 
+    // Experimental: Process channels in parallel on multiple cores
+    const int numHelperThreads = math_min(
+            pConfig->getValue(ConfigKey(group, "num_engine_helper_threads"), 0),
+            EngineParallelProcessor::maxHelperThreadCount());
+    if (numHelperThreads > 0) {
+        m_pParallelProcessor = new EngineParallelProcessor(numHelperThreads);
+    }
+
     // Master sample rate
     m_pMasterSampleRate = new ControlObject(ConfigKey(group, "samplerate"), true, true);
     m_pMasterSampleRate->set(44100.);
@@ -238,6 +257,7 @@ EngineMaster::~EngineMaster() {
         SampleUtil::free(m_pOutputBusBuffers[o]);
     }
 
+    delete m_pParallelProcessor;
     delete m_pWorkerScheduler;
 
     for (int i = 0; i < m_channels.size(); ++i) {
@@ -246,6 +266,7 @@ EngineMaster::~EngineMaster() {
         delete pChannelInfo->m_pChannel;
         delete pChannelInfo->m_pVolumeControl;
         delete pChannelInfo->m_pMuteControl;
+        delete pChannelInfo->m_pProcessStatId;
         delete pChannelInfo;
     }
 }
@@ -274,7 +295,7 @@ void EngineMaster::processChannels(int iBufferSize) {
     m_activeTalkoverChannels.clear();
     m_activeChannels.clear();
 
-    ScopedTimer timer("EngineMaster::processChannels");
+    ScopedStatTimer timer(kProcessChannelsStatId);
     EngineChannel* pMasterChannel = m_pMasterSync->getMaster();
     // Reserve the first place for the master channel which
     // should be processed first
@@ -347,17 +368,26 @@ void EngineMaster::processChannels(int iBufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex;
-             i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
+    if (m_pParallelProcessor) {
+        // The sync followers depend on the state of the sync master,
+        // which needs to be processed before all other channels are
+        // processed concurrently.
+        if (activeChannelsStartIndex == 0) {
+            processChannel(m_activeChannels[0], iBufferSize);
+        }
+        m_processChannelsTask.m_firstChannelIndex = 1;
+        m_processChannelsTask.m_iBufferSize = iBufferSize;
+        m_pParallelProcessor->run(&m_processChannelsTask,
+                m_activeChannels.size() - 1);
+        // The effect chains share their state between all channels, so
+        // the pre-fader effects are applied one channel at a time.
+        for (int i = 1; i < m_activeChannels.size(); ++i) {
+            processChannelPreFaderEffects(m_activeChannels[i], iBufferSize);
+        }
+    } else {
+        for (int i = activeChannelsStartIndex;
+                 i < m_activeChannels.size(); ++i) {
+            processChannel(m_activeChannels[i], iBufferSize);
         }
     }
 
@@ -371,6 +401,35 @@ void EngineMaster::processChannels(int iBufferSize) {
     }
 }
 
+void EngineMaster::processChannel(ChannelInfo* pChannelInfo, int iBufferSize) {
+    {
+        ScopedStatTimer timer(*pChannelInfo->m_pProcessStatId);
+        pChannelInfo->m_pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
+    }
+    collectChannelFeatures(pChannelInfo);
+}
+
+void EngineMaster::processChannelInput(ChannelInfo* pChannelInfo, int iBufferSize) {
+    ScopedStatTimer timer(*pChannelInfo->m_pProcessStatId);
+    pChannelInfo->m_pChannel->processInput(pChannelInfo->m_pBuffer, iBufferSize);
+}
+
+void EngineMaster::processChannelPreFaderEffects(ChannelInfo* pChannelInfo,
+        int iBufferSize) {
+    pChannelInfo->m_pChannel->processPreFaderEffects(
+            pChannelInfo->m_pBuffer, iBufferSize);
+    collectChannelFeatures(pChannelInfo);
+}
+
+void EngineMaster::collectChannelFeatures(ChannelInfo* pChannelInfo) {
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        GroupFeatureState features;
+        pChannelInfo->m_pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
 void EngineMaster::process(const int iBufferSize) {
     static bool haveSetName = false;
     if (!haveSetName) {
@@ -378,6 +437,7 @@ void EngineMaster::process(const int iBufferSize) {
         haveSetName = true;
     }
     Trace t("EngineMaster::process");
+    ScopedStatTimer timer(kProcessStatId);
 
     bool masterEnabled = m_pMasterEnabled->get();
     bool boothEnabled = m_pBoothEnabled->get();
@@ -782,6 +842,11 @@ void EngineMaster::addChannel(EngineChannel* pChannel) {
     pChannelInfo->m_pMuteControl->setButtonMode(ControlPushButton::POWERWINDOW);
     pChannelInfo->m_pBuffer = SampleUtil::alloc(MAX_BUFFER_LEN);
     SampleUtil::clear(pChannelInfo->m_pBuffer, MAX_BUFFER_LEN);
+    // Registered here, because formatting the key in the callback would
+    // allocate memory
+    pChannelInfo->m_pProcessStatId = new StatId(
+            QString("EngineMaster::processChannel %1").arg(group).toUtf8().constData(),
+            Stat::DURATION_NANOSEC);
     m_channels.append(pChannelInfo);
     const GainCache gainCacheDefault = {0, false};
     m_channelHeadphoneGainCache.append(gainCacheDefault);
@@ -814,6 +879,18 @@ EngineChannel* EngineMaster::getChannel(const QString& group) {
     return NULL;
 }
 
+bool EngineMaster::hasPendingReads() {
+    bool pending = false;
+    for (int i = 0; i < m_channels.size(); ++i) {
+        EngineBuffer* pBuffer = m_channels[i]->m_pChannel->getEngineBuffer();
+        // Check all channels to wake all readers with pending reads
+        if (pBuffer && pBuffer->hasPendingReads()) {
+            pending = true;
+        }
+    }
+    return pending;
+}
+
 const CSAMPLE* EngineMaster::getDeckBuffer(unsigned int i) const {
     return getChannelBuffer(PlayerManager::groupForDeck(i));
 }
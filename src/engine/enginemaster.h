@@ -25,6 +25,7 @@
 #include "control/controlobject.h"
 #include "control/controlpushbutton.h"
 #include "engine/engineobject.h"
+#include "engine/engineparallelprocessor.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/channelhandle.h"
 #include "soundio/soundmanager.h"
@@ -47,6 +48,7 @@ class GuiTick;
 class EngineSync;
 class EngineTalkoverDucking;
 class EngineDelay;
+class StatId;
 
 // The number of channels to pre-allocate in various structures in the
 // engine. Prevents memory allocation in EngineMaster::addChannel.
@@ -90,6 +92,10 @@ class EngineMaster : public QObject, public AudioSource {
     // only call it before the engine has started mixing.
     void addChannel(EngineChannel* pChannel);
     EngineChannel* getChannel(const QString& group);
+    // Returns true while any channel waits for audio data that has been
+    // requested from its reader. Must only be called between two calls
+    // of process(), e.g. by an offline driver that renders deterministically.
+    bool hasPendingReads();
     static inline double gainForOrientation(EngineChannel::ChannelOrientation orientation,
                                             double leftGain,
                                             double centerGain,
@@ -129,6 +135,7 @@ class EngineMaster : public QObject, public AudioSource {
                   m_pBuffer(NULL),
                   m_pVolumeControl(NULL),
                   m_pMuteControl(NULL),
+                  m_pProcessStatId(NULL),
                   m_index(index) {
         }
         ChannelHandle m_handle;
@@ -136,6 +143,7 @@ class EngineMaster : public QObject, public AudioSource {
         CSAMPLE* m_pBuffer;
         ControlObject* m_pVolumeControl;
         ControlPushButton* m_pMuteControl;
+        const StatId* m_pProcessStatId;
         GroupFeatureState m_features;
         int m_index;
     };
@@ -270,6 +278,38 @@ class EngineMaster : public QObject, public AudioSource {
     // respective output.
     void processChannels(int iBufferSize);
 
+    // Processes a single channel and collects its features for effects.
+    void processChannel(ChannelInfo* pChannelInfo, int iBufferSize);
+    // The two stages of processChannel() for parallel processing. Only
+    // processChannelInput() might be invoked concurrently for different
+    // channels.
+    void processChannelInput(ChannelInfo* pChannelInfo, int iBufferSize);
+    void processChannelPreFaderEffects(ChannelInfo* pChannelInfo, int iBufferSize);
+    void collectChannelFeatures(ChannelInfo* pChannelInfo);
+
+    // Processes the channels in m_activeChannels starting at
+    // m_firstChannelIndex with one task per channel.
+    class ProcessChannelsTask : public EngineParallelProcessor::Task {
+      public:
+        explicit ProcessChannelsTask(EngineMaster* pEngineMaster)
+                : m_firstChannelIndex(0),
+                  m_iBufferSize(0),
+                  m_pEngineMaster(pEngineMaster) {
+        }
+
+        void processTask(int taskIndex) override {
+            m_pEngineMaster->processChannelInput(
+                    m_pEngineMaster->m_activeChannels[m_firstChannelIndex + taskIndex],
+                    m_iBufferSize);
+        }
+
+        int m_firstChannelIndex;
+        int m_iBufferSize;
+
+      private:
+        EngineMaster* const m_pEngineMaster;
+    };
+
     ChannelHandleFactory* m_pChannelHandleFactory;
     void applyMasterEffects();
     void processHeadphones(const double masterMixGainInHeadphones);
@@ -305,6 +345,11 @@ class EngineMaster : public QObject, public AudioSource {
     EngineWorkerScheduler* m_pWorkerScheduler;
     EngineSync* m_pMasterSync;
 
+    // Distributes the processing of channels across multiple threads.
+    // Only allocated if enabled in the preferences.
+    EngineParallelProcessor* m_pParallelProcessor;
+    ProcessChannelsTask m_processChannelsTask;
+
     ControlObject* m_pMasterGain;
     ControlObject* m_pBoothGain;
     ControlObject* m_pHeadGain;
@@ -0,0 +1,264 @@
+#include "engine/engineparallelprocessor.h"
+
+#include <QtDebug>
+
+#ifdef __LINUX__
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <climits>
+
+#include "util/assert.h"
+#include "util/denormalsarezero.h"
+#include "util/math.h"
+
+namespace {
+
+// The number of tasks and the next task index are packed into 16 bits each
+const int kMaxTaskCount = 0xFFFF;
+
+inline quint32 packTasks(int taskCount, int nextTaskIndex) {
+    return (static_cast<quint32>(taskCount) << 16) |
+            static_cast<quint32>(nextTaskIndex);
+}
+
+inline int taskCountOf(quint32 tasks) {
+    return static_cast<int>(tasks >> 16);
+}
+
+inline int nextTaskIndexOf(quint32 tasks) {
+    return static_cast<int>(tasks & 0xFFFF);
+}
+
+inline void spinPause() {
+#ifdef __SSE__
+    _mm_pause();
+#endif
+}
+
+// Helper threads spin this many times before parking. Consecutive runs
+// within the same callback, e.g. for multiple stages, are picked up
+// without the latency of waking up.
+const int kSpinCountBeforeParking = 2000;
+
+#ifdef __LINUX__
+static_assert(sizeof(std::atomic<int>) == sizeof(int),
+        "m_generation can't be used as a futex");
+#else
+// Without a futex the parked helper threads poll with this interval
+const unsigned long kParkedPollMicros = 100;
+#endif
+
+} // anonymous namespace
+
+class EngineParallelProcessorThread : public QThread {
+  public:
+    EngineParallelProcessorThread(EngineParallelProcessor* pProcessor, int index)
+            : m_pProcessor(pProcessor),
+              m_index(index),
+              m_schedulingGeneration(0) {
+        setObjectName(QString("EngineHelper %1").arg(index + 1));
+    }
+
+    // Applies the scheduling policy of the calling thread if it has
+    // changed since the last call.
+    void updateScheduling() {
+        const int generation = m_pProcessor->m_schedulingGeneration.load();
+        if (generation == m_schedulingGeneration) {
+            return;
+        }
+        m_schedulingGeneration = generation;
+#ifdef __LINUX__
+        struct sched_param param = {};
+        param.sched_priority = m_pProcessor->m_schedulingPriority.load();
+        if (pthread_setschedparam(pthread_self(),
+                m_pProcessor->m_schedulingPolicy.load(), &param)) {
+            qWarning() << objectName() << "Failed to apply the scheduling"
+                    << "of the engine thread";
+        }
+#endif
+    }
+
+  protected:
+    void run() override {
+#ifdef __SSE__
+        // The callback thread enables these modes only for itself
+        _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+        _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+#ifdef __LINUX__
+        // Pin the helper threads to distinct cores. The first core is
+        // left to the callback thread, which is not pinned.
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET((m_index + 1) % QThread::idealThreadCount(), &cpuSet);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet)) {
+            qWarning() << objectName() << "Failed to set CPU affinity";
+        }
+#endif
+        m_pProcessor->helperThreadLoop(this);
+    }
+
+  private:
+    EngineParallelProcessor* const m_pProcessor;
+    const int m_index;
+    int m_schedulingGeneration;
+};
+
+EngineParallelProcessor::EngineParallelProcessor(int numHelperThreads)
+        : m_tasks(0),
+          m_pendingTasks(0),
+          m_pTask(nullptr),
+          m_generation(0),
+          m_parkedThreads(0),
+          m_stop(false),
+          m_bCallingThreadSchedulingApplied(false),
+          m_schedulingPolicy(0),
+          m_schedulingPriority(0),
+          m_schedulingGeneration(0) {
+    numHelperThreads = math_min(numHelperThreads, maxHelperThreadCount());
+    for (int i = 0; i < numHelperThreads; ++i) {
+        EngineParallelProcessorThread* pThread =
+                new EngineParallelProcessorThread(this, i);
+        m_threads.push_back(pThread);
+        // Only effective on platforms that map Qt priorities to realtime
+        // scheduling. On Linux the scheduling of the callback thread
+        // is applied by the helper threads on the first run.
+        pThread->start(QThread::TimeCriticalPriority);
+    }
+    if (numHelperThreads > 0) {
+        qDebug() << "EngineParallelProcessor: Using" << numHelperThreads
+                << "helper threads";
+    }
+}
+
+EngineParallelProcessor::~EngineParallelProcessor() {
+    m_stop.store(true);
+    m_generation.fetch_add(1);
+    wakeParkedThreads();
+    for (const auto& pThread : m_threads) {
+        pThread->wait();
+        delete pThread;
+    }
+}
+
+// static
+int EngineParallelProcessor::maxHelperThreadCount() {
+    return math_max(0, QThread::idealThreadCount() - 1);
+}
+
+void EngineParallelProcessor::run(Task* pTask, int taskCount) {
+    DEBUG_ASSERT(pTask);
+    VERIFY_OR_DEBUG_ASSERT(taskCount <= kMaxTaskCount) {
+        taskCount = kMaxTaskCount;
+    }
+    if (taskCount <= 0) {
+        return;
+    }
+    if (m_threads.empty() || taskCount == 1) {
+        for (int i = 0; i < taskCount; ++i) {
+            pTask->processTask(i);
+        }
+        return;
+    }
+
+    if (!m_bCallingThreadSchedulingApplied) {
+        applySchedulingOfCallingThread();
+    }
+
+    // All tasks of the previous run have finished at this point
+    m_pTask = pTask;
+    m_pendingTasks.store(taskCount, std::memory_order_relaxed);
+    // Publishes m_pTask and m_pendingTasks to the helper threads
+    m_tasks.store(packTasks(taskCount, 0), std::memory_order_release);
+    // Both are sequentially consistent, so either a parking helper thread
+    // sees the new generation or it is seen as parked here.
+    m_generation.fetch_add(1);
+    if (m_parkedThreads.load() > 0) {
+        wakeParkedThreads();
+    }
+
+    processTasks();
+
+    // Join: Wait for the tasks that have been claimed by helper threads
+    while (m_pendingTasks.load(std::memory_order_acquire) > 0) {
+        spinPause();
+    }
+}
+
+void EngineParallelProcessor::processTasks() {
+    quint32 tasks = m_tasks.load(std::memory_order_acquire);
+    while (nextTaskIndexOf(tasks) < taskCountOf(tasks)) {
+        // Helper threads might wake up late, i.e. after the run they have
+        // been woken for has finished. The tasks of a subsequent run may
+        // only be claimed if they have been published, which is ensured
+        // by the compare-exchange.
+        if (m_tasks.compare_exchange_weak(tasks, tasks + 1,
+                std::memory_order_acq_rel, std::memory_order_acquire)) {
+            m_pTask->processTask(nextTaskIndexOf(tasks));
+            m_pendingTasks.fetch_sub(1, std::memory_order_release);
+            tasks = m_tasks.load(std::memory_order_acquire);
+        }
+    }
+}
+
+void EngineParallelProcessor::helperThreadLoop(
+        EngineParallelProcessorThread* pThread) {
+    int generation = m_generation.load();
+    while (true) {
+        generation = waitForNextRun(generation);
+        if (m_stop.load()) {
+            return;
+        }
+        pThread->updateScheduling();
+        processTasks();
+    }
+}
+
+int EngineParallelProcessor::waitForNextRun(int generation) {
+    for (int i = 0; i < kSpinCountBeforeParking; ++i) {
+        const int nextGeneration = m_generation.load(std::memory_order_acquire);
+        if (nextGeneration != generation) {
+            return nextGeneration;
+        }
+        spinPause();
+    }
+    m_parkedThreads.fetch_add(1);
+    int nextGeneration = m_generation.load();
+    while (nextGeneration == generation) {
+#ifdef __LINUX__
+        // Returns immediately if the generation has changed in between
+        syscall(SYS_futex, reinterpret_cast<int*>(&m_generation),
+                FUTEX_WAIT_PRIVATE, generation, nullptr, nullptr, 0);
+#else
+        QThread::usleep(kParkedPollMicros);
+#endif
+        nextGeneration = m_generation.load();
+    }
+    m_parkedThreads.fetch_sub(1);
+    return nextGeneration;
+}
+
+void EngineParallelProcessor::wakeParkedThreads() {
+#ifdef __LINUX__
+    syscall(SYS_futex, reinterpret_cast<int*>(&m_generation),
+            FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+void EngineParallelProcessor::applySchedulingOfCallingThread() {
+    m_bCallingThreadSchedulingApplied = true;
+#ifdef __LINUX__
+    int policy;
+    struct sched_param param;
+    if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+        m_schedulingPolicy.store(policy);
+        m_schedulingPriority.store(param.sched_priority);
+        m_schedulingGeneration.fetch_add(1);
+    }
+#endif
+}
@@ -0,0 +1,81 @@
+#ifndef ENGINEPARALLELPROCESSOR_H
+#define ENGINEPARALLELPROCESSOR_H
+
+#include <atomic>
+#include <vector>
+
+#include <QThread>
+
+class EngineParallelProcessorThread;
+
+// Distributes independent tasks of the engine callback, e.g. processing
+// of channels, across a pool of helper threads.
+//
+// The calling (callback) thread takes part in the processing and returns
+// from run() after all tasks have finished (fork/join). Tasks are claimed
+// from a shared atomic counter, so the callback thread never blocks on a
+// mutex. Each run() increments an atomic generation counter. Idle helper
+// threads spin on it for a short while and then park. On Linux they park
+// on a futex, which the callback thread only wakes if a helper is parked.
+// On other platforms the helpers poll the counter while sleeping, so the
+// callback thread never makes a system call to wake them.
+//
+// If no helper threads are available, e.g. on single-core machines, all
+// tasks are processed by the calling thread.
+class EngineParallelProcessor {
+  public:
+    class Task {
+      public:
+        virtual ~Task() = default;
+        virtual void processTask(int taskIndex) = 0;
+    };
+
+    // The number of helper threads is limited by the number of available
+    // cores minus one for the calling thread.
+    explicit EngineParallelProcessor(int numHelperThreads);
+    virtual ~EngineParallelProcessor();
+
+    static int maxHelperThreadCount();
+
+    int helperThreadCount() const {
+        return static_cast<int>(m_threads.size());
+    }
+
+    // Invokes pTask->processTask() for all task indices in the range
+    // [0, taskCount) and waits until all of them have been processed.
+    // Must only be called from a single thread at a time.
+    void run(Task* pTask, int taskCount);
+
+  private:
+    // Claims and processes tasks until no task is left
+    void processTasks();
+
+    void helperThreadLoop(EngineParallelProcessorThread* pThread);
+
+    // Returns the generation of the next run() once it has started
+    int waitForNextRun(int generation);
+    void wakeParkedThreads();
+
+    void applySchedulingOfCallingThread();
+
+    // Packs the number of tasks of the current run (high 16 bits) and
+    // the index of the next unclaimed task (low 16 bits).
+    std::atomic<quint32> m_tasks;
+    std::atomic<int> m_pendingTasks;
+    Task* m_pTask;
+
+    std::vector<EngineParallelProcessorThread*> m_threads;
+    // Incremented for every run() and when stopping. Used as a futex.
+    std::atomic<int> m_generation;
+    std::atomic<int> m_parkedThreads;
+    std::atomic<bool> m_stop;
+
+    bool m_bCallingThreadSchedulingApplied;
+    std::atomic<int> m_schedulingPolicy;
+    std::atomic<int> m_schedulingPriority;
+    std::atomic<int> m_schedulingGeneration;
+
+    friend class EngineParallelProcessorThread;
+};
+
+#endif /* ENGINEPARALLELPROCESSOR_H */
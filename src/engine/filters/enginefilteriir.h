@@ -250,6 +250,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     }
 
   protected:
+    // Processes the channels of two filters in parallel
+    friend class EngineFilterIIRBank;
+
     inline double processSample(double* coef, double* buf, double val);
     inline void pauseFilterInner() {
         // Set the current buffers to 0
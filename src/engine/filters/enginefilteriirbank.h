@@ -0,0 +1,199 @@
+#ifndef ENGINEFILTERIIRBANK_H
+#define ENGINEFILTERIIRBANK_H
+
+#include "engine/filters/enginefilteriir.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIXXX_IIRBANK_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MIXXX_IIRBANK_NEON
+#include <arm_neon.h>
+#endif
+
+// Processes two stereo EngineFilterIIRs of the same order side by side,
+// e.g. the low and high pass of a crossover or the two low passes of an
+// isolator EQ. The left and right channels of both filters are four
+// independent recursions that run in SIMD lanes: one vector holds the
+// stereo channels of each filter.
+//
+// The filter states are transposed into registers for the whole buffer
+// and written back afterwards, i.e. the filters keep working with all
+// other EngineFilterIIR methods. The results are bit-identical to calling
+// process() on both filters, the bank performs the same double precision
+// operations in the same order. Like for SampleUtilSimd, this only holds
+// as long as the compiler does not fuse multiplications and additions,
+// which it does not on x86 without -mfma. While a filter ramps to new
+// coefficients or from a pause, both filters are processed one after the
+// other.
+//
+// Only the cascaded low and high passes of fidlib (IIR_LP and IIR_HP) are
+// supported. Each second order section of those calculates
+//   iir = in * gain - coef1 * buf[0] - coef2 * buf[1]
+//   out = buf[0] + fir1 * buf[1] + iir
+// where fir1 is 2 for low passes and -2 for high passes.
+class EngineFilterIIRBank {
+  public:
+    static bool isAccelerated() {
+#if defined(MIXXX_IIRBANK_SSE2) || defined(MIXXX_IIRBANK_NEON)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Equivalent to
+    //   pFilterA->process(pInA, pOutA, iBufferSize);
+    //   pFilterB->process(pInB, pOutB, iBufferSize);
+    // All inputs of a frame are read before its outputs are written, so
+    // the buffers may be processed in place and pOutA may be pInB.
+    template<unsigned int SIZE, enum IIRPass PASS_A, enum IIRPass PASS_B>
+    static void process(
+            EngineFilterIIR<SIZE, PASS_A>* pFilterA,
+            const CSAMPLE* pInA, CSAMPLE* pOutA,
+            EngineFilterIIR<SIZE, PASS_B>* pFilterB,
+            const CSAMPLE* pInB, CSAMPLE* pOutB,
+            const int iBufferSize) {
+        static_assert(SIZE % 2 == 0, "Only cascades of second order sections are supported");
+        if (!isAccelerated() || pFilterA->m_doRamping || pFilterB->m_doRamping) {
+            pFilterA->process(pInA, pOutA, iBufferSize);
+            pFilterB->process(pInB, pOutB, iBufferSize);
+            return;
+        }
+#if defined(MIXXX_IIRBANK_SSE2) || defined(MIXXX_IIRBANK_NEON)
+        const unsigned int kSections = SIZE / 2;
+
+        // Index 0 is filter A, index 1 is filter B
+        const Lanes gain[2] = {
+            set1(pFilterA->m_coef[0]),
+            set1(pFilterB->m_coef[0]),
+        };
+        const Lanes fir1[2] = {
+            set1(Section<PASS_A>::fir1()),
+            set1(Section<PASS_B>::fir1()),
+        };
+        Lanes coef1[kSections][2];
+        Lanes coef2[kSections][2];
+        Lanes buf0[kSections][2];
+        Lanes buf1[kSections][2];
+        for (unsigned int k = 0; k < kSections; ++k) {
+            coef1[k][0] = set1(pFilterA->m_coef[2 * k + 1]);
+            coef1[k][1] = set1(pFilterB->m_coef[2 * k + 1]);
+            coef2[k][0] = set1(pFilterA->m_coef[2 * k + 2]);
+            coef2[k][1] = set1(pFilterB->m_coef[2 * k + 2]);
+            buf0[k][0] = set(pFilterA->m_buf1[2 * k], pFilterA->m_buf2[2 * k]);
+            buf0[k][1] = set(pFilterB->m_buf1[2 * k], pFilterB->m_buf2[2 * k]);
+            buf1[k][0] = set(pFilterA->m_buf1[2 * k + 1], pFilterA->m_buf2[2 * k + 1]);
+            buf1[k][1] = set(pFilterB->m_buf1[2 * k + 1], pFilterB->m_buf2[2 * k + 1]);
+        }
+
+        for (int i = 0; i < iBufferSize; i += 2) {
+            Lanes val[2] = {
+                loadFrame(pInA + i),
+                loadFrame(pInB + i),
+            };
+            for (unsigned int k = 0; k < kSections; ++k) {
+                for (int f = 0; f < 2; ++f) {
+                    // Only the first section applies the gain of the filter
+                    Lanes iir = k == 0 ? mul(val[f], gain[f]) : val[f];
+                    iir = sub(iir, mul(coef1[k][f], buf0[k][f]));
+                    iir = sub(iir, mul(coef2[k][f], buf1[k][f]));
+                    val[f] = add(add(buf0[k][f], mul(fir1[f], buf1[k][f])), iir);
+                    buf0[k][f] = buf1[k][f];
+                    buf1[k][f] = iir;
+                }
+            }
+            storeFrame(pOutA + i, val[0]);
+            storeFrame(pOutB + i, val[1]);
+        }
+
+        for (unsigned int k = 0; k < kSections; ++k) {
+            get(buf0[k][0], &pFilterA->m_buf1[2 * k], &pFilterA->m_buf2[2 * k]);
+            get(buf0[k][1], &pFilterB->m_buf1[2 * k], &pFilterB->m_buf2[2 * k]);
+            get(buf1[k][0], &pFilterA->m_buf1[2 * k + 1], &pFilterA->m_buf2[2 * k + 1]);
+            get(buf1[k][1], &pFilterB->m_buf1[2 * k + 1], &pFilterB->m_buf2[2 * k + 1]);
+        }
+#endif
+    }
+
+  private:
+    // The FIR part of the sections, multiplying by 2 or -2 is exactly the
+    // same as the additions in EngineFilterIIR::processSample()
+    template<enum IIRPass PASS>
+    struct Section;
+
+#if defined(MIXXX_IIRBANK_SSE2)
+    typedef __m128d Lanes;
+
+    static inline Lanes set1(double value) {
+        return _mm_set1_pd(value);
+    }
+    static inline Lanes set(double left, double right) {
+        return _mm_setr_pd(left, right);
+    }
+    static inline void get(Lanes lanes, double* pLeft, double* pRight) {
+        _mm_storel_pd(pLeft, lanes);
+        _mm_storeh_pd(pRight, lanes);
+    }
+    static inline Lanes loadFrame(const CSAMPLE* pFrame) {
+        return _mm_cvtps_pd(_mm_loadl_pi(_mm_setzero_ps(),
+                reinterpret_cast<const __m64*>(pFrame)));
+    }
+    static inline void storeFrame(CSAMPLE* pFrame, Lanes lanes) {
+        _mm_storel_pi(reinterpret_cast<__m64*>(pFrame), _mm_cvtpd_ps(lanes));
+    }
+    static inline Lanes add(Lanes a, Lanes b) {
+        return _mm_add_pd(a, b);
+    }
+    static inline Lanes sub(Lanes a, Lanes b) {
+        return _mm_sub_pd(a, b);
+    }
+    static inline Lanes mul(Lanes a, Lanes b) {
+        return _mm_mul_pd(a, b);
+    }
+#elif defined(MIXXX_IIRBANK_NEON)
+    typedef float64x2_t Lanes;
+
+    static inline Lanes set1(double value) {
+        return vdupq_n_f64(value);
+    }
+    static inline Lanes set(double left, double right) {
+        return vcombine_f64(vdup_n_f64(left), vdup_n_f64(right));
+    }
+    static inline void get(Lanes lanes, double* pLeft, double* pRight) {
+        *pLeft = vgetq_lane_f64(lanes, 0);
+        *pRight = vgetq_lane_f64(lanes, 1);
+    }
+    static inline Lanes loadFrame(const CSAMPLE* pFrame) {
+        return vcvt_f64_f32(vld1_f32(pFrame));
+    }
+    static inline void storeFrame(CSAMPLE* pFrame, Lanes lanes) {
+        vst1_f32(pFrame, vcvt_f32_f64(lanes));
+    }
+    static inline Lanes add(Lanes a, Lanes b) {
+        return vaddq_f64(a, b);
+    }
+    static inline Lanes sub(Lanes a, Lanes b) {
+        return vsubq_f64(a, b);
+    }
+    static inline Lanes mul(Lanes a, Lanes b) {
+        return vmulq_f64(a, b);
+    }
+#endif
+};
+
+template<>
+struct EngineFilterIIRBank::Section<IIR_LP> {
+    static double fir1() {
+        return 2.0;
+    }
+};
+
+template<>
+struct EngineFilterIIRBank::Section<IIR_HP> {
+    static double fir1() {
+        return -2.0;
+    }
+};
+
+#endif // ENGINEFILTERIIRBANK_H
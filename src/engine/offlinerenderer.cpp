@@ -0,0 +1,291 @@
+#include "engine/offlinerenderer.h"
+
+#include <QRegExp>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+
+#include "control/controlobject.h"
+#include "engine/engine.h"
+#include "engine/enginemaster.h"
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("OfflineRenderer");
+
+// Decoding a chunk takes far less than a millisecond
+const unsigned long kPendingReadPollMicros = 100;
+// Give up waiting for a reader that doesn't respond anymore
+const mixxx::Duration kMaxPendingReadWait = mixxx::Duration::fromSeconds(10);
+
+SINT framesForSeconds(double seconds, int sampleRate) {
+    return static_cast<SINT>(std::llround(seconds * sampleRate));
+}
+
+} // anonymous namespace
+
+bool ControlTimeline::parse(const QString& text, QString* pErrorMessage) {
+    const QRegExp separator("\\s+");
+    QList<Event> events;
+    const QStringList lines = text.split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        const QString line = lines[i].trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        const QStringList fields = line.split(separator);
+        bool ok = false;
+        Event event;
+        if (fields.size() >= 3) {
+            event.seconds = fields[0].toDouble(&ok);
+        }
+        if (ok) {
+            event.key = ConfigKey::parseCommaSeparated(fields[1]);
+            ok = event.seconds >= 0 &&
+                    event.key.group.startsWith('[') &&
+                    event.key.group.endsWith(']') &&
+                    !event.key.item.isEmpty();
+        }
+        if (!ok) {
+            if (pErrorMessage) {
+                *pErrorMessage = QString("Invalid timeline event in line %1: %2")
+                        .arg(i + 1).arg(line);
+            }
+            return false;
+        }
+        // The value may contain whitespace, e.g. file paths
+        event.value = line.section(separator, 2);
+        events.append(event);
+    }
+    std::stable_sort(events.begin(), events.end(),
+            [](const Event& lhs, const Event& rhs) {
+                return lhs.seconds < rhs.seconds;
+            });
+    m_events = events;
+    return true;
+}
+
+bool ControlTimeline::loadFromFile(const QString& fileName, QString* pErrorMessage) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (pErrorMessage) {
+            *pErrorMessage = QString("Failed to open timeline %1: %2")
+                    .arg(fileName, file.errorString());
+        }
+        return false;
+    }
+    QTextStream in(&file);
+    return parse(in.readAll(), pErrorMessage);
+}
+
+void ControlTimeline::addEvent(double seconds, const ConfigKey& key, const QString& value) {
+    DEBUG_ASSERT(seconds >= 0);
+    Event event;
+    event.seconds = seconds;
+    event.key = key;
+    event.value = value;
+    // Insert after all events with the same time
+    auto it = std::upper_bound(m_events.begin(), m_events.end(), event,
+            [](const Event& lhs, const Event& rhs) {
+                return lhs.seconds < rhs.seconds;
+            });
+    m_events.insert(it, event);
+}
+
+OfflineRenderer::OfflineRenderer(
+        UserSettingsPointer pConfig,
+        EngineMaster* pEngineMaster,
+        int sampleRate,
+        int framesPerBuffer)
+        : m_pConfig(pConfig),
+          m_pEngineMaster(pEngineMaster),
+          m_sampleRate(sampleRate),
+          m_framesPerBuffer(framesPerBuffer),
+          m_renderedFrames(0) {
+    DEBUG_ASSERT(m_pEngineMaster);
+    DEBUG_ASSERT(m_sampleRate > 0);
+    DEBUG_ASSERT(m_framesPerBuffer > 0);
+}
+
+OfflineRenderer::~OfflineRenderer() {
+}
+
+bool OfflineRenderer::render(const ControlTimeline& timeline, double durationSeconds,
+        QString* pErrorMessage) {
+    return renderWithEncoder(timeline, durationSeconds, nullptr, pErrorMessage);
+}
+
+bool OfflineRenderer::renderToFile(const ControlTimeline& timeline, double durationSeconds,
+        const QString& fileName, const Encoder::Format& format,
+        QString* pErrorMessage) {
+    // Only the lossless encoders are able to seek back and finish the
+    // header of the file.
+    VERIFY_OR_DEBUG_ASSERT(format.lossless) {
+        if (pErrorMessage) {
+            *pErrorMessage = QString("Unsupported format for rendering: %1")
+                    .arg(format.internalName);
+        }
+        return false;
+    }
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        if (pErrorMessage) {
+            *pErrorMessage = QString("Failed to open %1: %2")
+                    .arg(fileName, m_file.errorString());
+        }
+        return false;
+    }
+
+    bool success = false;
+    {
+        EncoderPointer pEncoder = EncoderFactory::getFactory().getNewEncoder(
+                format, m_pConfig, this);
+        // The error message of initEncoder() is passed by value and is
+        // lost, the encoder logs it.
+        if (pEncoder->initEncoder(m_sampleRate, QString()) < 0) {
+            if (pErrorMessage) {
+                *pErrorMessage = QString("Failed to initialize the %1 encoder")
+                        .arg(format.internalName);
+            }
+        } else {
+            success = renderWithEncoder(
+                    timeline, durationSeconds, pEncoder.get(), pErrorMessage);
+            pEncoder->flush();
+        }
+        // Destroying the encoder finishes the file
+    }
+    m_file.close();
+    return success;
+}
+
+bool OfflineRenderer::renderWithEncoder(const ControlTimeline& timeline,
+        double durationSeconds, Encoder* pEncoder, QString* pErrorMessage) {
+    m_renderedFrames = 0;
+    m_renderTime = mixxx::Duration();
+
+    if (durationSeconds <= 0) {
+        durationSeconds = timeline.durationSeconds();
+    }
+    const SINT totalFrames = framesForSeconds(durationSeconds, m_sampleRate);
+    const SINT samplesPerBuffer =
+            m_framesPerBuffer * mixxx::kEngineChannelCount;
+
+    ControlObject::set(ConfigKey("[Master]", "samplerate"), m_sampleRate);
+
+    const QList<ControlTimeline::Event>& events = timeline.events();
+    int nextEvent = 0;
+
+    // Start with all decks ready to play their current position
+    waitForPendingReads();
+
+    PerformanceTimer timer;
+    timer.start();
+    while (m_renderedFrames < totalFrames) {
+        const SINT bufferEnd = m_renderedFrames + m_framesPerBuffer;
+        while (nextEvent < events.size() &&
+                framesForSeconds(events[nextEvent].seconds, m_sampleRate) < bufferEnd) {
+            if (!applyEvent(events[nextEvent], pErrorMessage)) {
+                m_renderTime = timer.elapsed();
+                return false;
+            }
+            ++nextEvent;
+        }
+
+        m_pEngineMaster->process(samplesPerBuffer);
+
+        // The last buffer is cut at the requested duration
+        const SINT frames = math_min(
+                static_cast<SINT>(m_framesPerBuffer), totalFrames - m_renderedFrames);
+        if (pEncoder) {
+            pEncoder->encodeBuffer(m_pEngineMaster->getMasterBuffer(),
+                    frames * mixxx::kEngineChannelCount);
+        }
+        m_renderedFrames += frames;
+
+        waitForPendingReads();
+    }
+    m_renderTime = timer.elapsed();
+
+    kLogger.info()
+            << "Rendered" << renderedDuration().toDoubleSeconds() << "s in"
+            << m_renderTime.toDoubleSeconds() << "s, realtime factor"
+            << realtimeFactor();
+    return true;
+}
+
+bool OfflineRenderer::applyEvent(const ControlTimeline::Event& event,
+        QString* pErrorMessage) {
+    bool isNumber = false;
+    const double value = event.value.toDouble(&isNumber);
+    if (isNumber) {
+        ControlObject* pControl = ControlObject::getControl(event.key);
+        if (pControl) {
+            pControl->set(value);
+            return true;
+        }
+    } else if (m_commandHandler && m_commandHandler(event.key, event.value)) {
+        return true;
+    }
+    if (pErrorMessage) {
+        *pErrorMessage = QString("Failed to apply timeline event at %1 s: %2 %3")
+                .arg(event.seconds)
+                .arg(event.key.group + "," + event.key.item, event.value);
+    }
+    return false;
+}
+
+void OfflineRenderer::waitForPendingReads() {
+    PerformanceTimer timer;
+    timer.start();
+    while (m_pEngineMaster->hasPendingReads()) {
+        if (timer.elapsed() > kMaxPendingReadWait) {
+            kLogger.warning()
+                    << "Reading audio data takes too long, continuing without it";
+            return;
+        }
+        QThread::usleep(kPendingReadPollMicros);
+    }
+}
+
+mixxx::Duration OfflineRenderer::renderedDuration() const {
+    return mixxx::Duration::fromNanos(
+            m_renderedFrames * mixxx::Duration::kNanosPerSecond / m_sampleRate);
+}
+
+double OfflineRenderer::realtimeFactor() const {
+    if (m_renderTime <= mixxx::Duration()) {
+        return 0.0;
+    }
+    return renderedDuration().toDoubleSeconds() / m_renderTime.toDoubleSeconds();
+}
+
+void OfflineRenderer::write(const unsigned char *header, const unsigned char *body,
+                            int headerLen, int bodyLen) {
+    if (headerLen > 0) {
+        m_file.write(reinterpret_cast<const char*>(header), headerLen);
+    }
+    m_file.write(reinterpret_cast<const char*>(body), bodyLen);
+}
+
+int OfflineRenderer::tell() {
+    if (!m_file.isOpen()) {
+        return -1;
+    }
+    return static_cast<int>(m_file.pos());
+}
+
+void OfflineRenderer::seek(int pos) {
+    m_file.seek(static_cast<qint64>(pos));
+}
+
+int OfflineRenderer::filelen() {
+    return static_cast<int>(m_file.size());
+}
@@ -0,0 +1,139 @@
+#ifndef OFFLINERENDERER_H
+#define OFFLINERENDERER_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "preferences/usersettings.h"
+#include "util/duration.h"
+#include "util/types.h"
+
+class EngineMaster;
+
+// A scripted list of control changes on the time axis of the rendered
+// output. The text format has one event per line:
+//
+//   # seconds  control              value
+//   0          [Channel1],play      1
+//   12.5       [Master],crossfader  0.25
+//   30         [Channel2],load      /path/to/track.mp3
+//
+// Values that are not numbers are passed to the command handler of the
+// renderer, e.g. to load tracks. Empty lines and lines starting with '#'
+// are ignored.
+class ControlTimeline {
+  public:
+    struct Event {
+        double seconds;
+        ConfigKey key;
+        QString value;
+    };
+
+    // Replaces all events. Returns false and leaves the timeline
+    // unchanged if a line could not be parsed.
+    bool parse(const QString& text, QString* pErrorMessage);
+    bool loadFromFile(const QString& fileName, QString* pErrorMessage);
+
+    void addEvent(double seconds, const ConfigKey& key, const QString& value);
+    void addEvent(double seconds, const ConfigKey& key, double value) {
+        addEvent(seconds, key, QString::number(value, 'g', 17));
+    }
+
+    // Sorted by time, events with the same time keep their order
+    const QList<Event>& events() const {
+        return m_events;
+    }
+    double durationSeconds() const {
+        return m_events.isEmpty() ? 0.0 : m_events.last().seconds;
+    }
+
+  private:
+    QList<Event> m_events;
+};
+
+// Drives an EngineMaster without a sound device. The engine is processed
+// as fast as the CPU allows and a virtual clock, the number of rendered
+// frames, replaces the clock of the sound card. Control changes of the
+// timeline are applied before the buffer that contains their time.
+//
+// The rendering is deterministic: after each buffer the renderer waits
+// until the readers of all decks have decoded the chunks that have been
+// requested, i.e. only a seek to a position that is not cached yet
+// produces the same silence a sound card would hear.
+//
+// The renderer takes over the [Master],samplerate control and must run
+// in the thread that would otherwise run the audio callback. Nothing
+// else may call EngineMaster::process() at the same time.
+class OfflineRenderer : public EncoderCallback {
+  public:
+    // Handles timeline events with values that are not numbers. Returns
+    // false if the event could not be handled, which aborts rendering.
+    typedef std::function<bool(const ConfigKey& key, const QString& value)> CommandHandler;
+
+    OfflineRenderer(
+            UserSettingsPointer pConfig,
+            EngineMaster* pEngineMaster,
+            int sampleRate = 44100,
+            int framesPerBuffer = 1024);
+    ~OfflineRenderer() override;
+
+    void setCommandHandler(CommandHandler handler) {
+        m_commandHandler = std::move(handler);
+    }
+
+    // Renders the master output for the duration of the timeline if
+    // durationSeconds is not positive. The output is discarded, e.g.
+    // to measure the throughput of the engine.
+    bool render(const ControlTimeline& timeline, double durationSeconds,
+            QString* pErrorMessage);
+
+    // Renders the master output into a file that is written with the
+    // encoder for format, one of the lossless formats WAV, AIFF or FLAC.
+    bool renderToFile(const ControlTimeline& timeline, double durationSeconds,
+            const QString& fileName, const Encoder::Format& format,
+            QString* pErrorMessage);
+
+    // The result of the last rendering
+    SINT renderedFrames() const {
+        return m_renderedFrames;
+    }
+    mixxx::Duration renderedDuration() const;
+    // The wall clock time that rendering took
+    mixxx::Duration renderTime() const {
+        return m_renderTime;
+    }
+    // Rendered duration per wall clock time, i.e. a realtime factor of
+    // 10 renders 10 minutes of audio in one minute.
+    double realtimeFactor() const;
+
+    // Receives the encoded output
+    void write(const unsigned char *header, const unsigned char *body,
+               int headerLen, int bodyLen) override;
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  private:
+    bool renderWithEncoder(const ControlTimeline& timeline, double durationSeconds,
+            Encoder* pEncoder, QString* pErrorMessage);
+    bool applyEvent(const ControlTimeline::Event& event, QString* pErrorMessage);
+    void waitForPendingReads();
+
+    const UserSettingsPointer m_pConfig;
+    EngineMaster* const m_pEngineMaster;
+    const int m_sampleRate;
+    const int m_framesPerBuffer;
+    CommandHandler m_commandHandler;
+
+    QFile m_file;
+
+    SINT m_renderedFrames;
+    mixxx::Duration m_renderTime;
+};
+
+#endif // OFFLINERENDERER_H
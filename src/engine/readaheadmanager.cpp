@@ -213,6 +213,19 @@ void ReadAheadManager::hintReader(double dRate, HintVector* pHintList) {
     // top priority, we need to read this data immediately
     current_position.priority = 1;
     pHintList->append(current_position);
+
+    // Speculatively read ahead in the direction of playback
+    if (dRate != 0) {
+        Hint prefetch;
+        prefetch.frameCount = frameCountToCache;
+        if (in_reverse) {
+            prefetch.frame = current_position.frame - frameCountToCache;
+        } else {
+            prefetch.frame = current_position.frame + frameCountToCache;
+        }
+        prefetch.priority = Hint::kPriorityPrefetch;
+        pHintList->append(prefetch);
+    }
 }
 
 // Not thread-save, call from engine thread only
@@ -58,6 +58,8 @@ void EngineRecord::updateFromPreferences() {
     }
     Encoder::Format format = EncoderFactory::getFactory().getSelectedFormat(m_pConfig);
     m_encoding = format.internalName;
+    // Not a SharedEncoder: The recording needs the tail of its stream when
+    // it stops and the file carries the metadata of the preferences.
     m_pEncoder = EncoderFactory::getFactory().getNewEncoder(format,  m_pConfig, this);
     m_pEncoder->updateMetaData(m_baAuthor,m_baTitle,m_baAlbum);
 
@@ -83,6 +83,23 @@ void EngineSideChain::receiveBuffer(AudioInput input,
     writeSamples(pBuffer, iFrames);
 }
 
+void EngineSideChain::receiveView(AudioInput input,
+                                  const AudioInputView& view,
+                                  unsigned int iFrames) {
+    if (input.getType() != AudioInput::RECORD_BROADCAST) {
+        qDebug() << "WARNING: AudioInput type is not RECORD_BROADCAST. Ignoring incoming buffer.";
+        return;
+    }
+    Trace sidechain("EngineSideChain::receiveView");
+    SINT framesWritten = view.writeStereo(&m_sampleFifo, iFrames);
+
+    if (framesWritten != static_cast<SINT>(iFrames)) {
+        Counter("EngineSideChain::writeSamples buffer overrun").increment();
+    }
+
+    wakeUpIfSamplesAvailable();
+}
+
 void EngineSideChain::writeSamples(const CSAMPLE* pBuffer, int iFrames) {
     Trace sidechain("EngineSideChain::writeSamples");
     // TODO: remove assumption of stereo buffer
@@ -94,6 +111,10 @@ void EngineSideChain::writeSamples(const CSAMPLE* pBuffer, int iFrames) {
         Counter("EngineSideChain::writeSamples buffer overrun").increment();
     }
 
+    wakeUpIfSamplesAvailable();
+}
+
+void EngineSideChain::wakeUpIfSamplesAvailable() {
     if (m_sampleFifo.writeAvailable() < SIDECHAIN_BUFFER_SIZE / 5) {
         // Signal to the sidechain that samples are available.
         Trace wakeup("EngineSideChain::writeSamples wake up");
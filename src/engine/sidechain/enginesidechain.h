@@ -46,6 +46,15 @@ class EngineSideChain : public QThread, public AudioDestination {
                        const CSAMPLE* pBuffer,
                        unsigned int iFrames) override;
 
+    // Writes the samples of a sound card input to the FIFO straight from the
+    // device buffer.
+    bool receivesInputViews() const override {
+        return true;
+    }
+    void receiveView(AudioInput input,
+                     const AudioInputView& view,
+                     unsigned int iFrames) override;
+
     // Thread-safe, blocking.
     void addSideChainWorker(SideChainWorker* pWorker);
 
@@ -54,6 +63,8 @@ class EngineSideChain : public QThread, public AudioDestination {
   private:
     void run() override;
 
+    void wakeUpIfSamplesAvailable();
+
     UserSettingsPointer m_pConfig;
     // Indicates that the thread should exit.
     volatile bool m_bStopThread;
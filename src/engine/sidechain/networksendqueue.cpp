@@ -0,0 +1,141 @@
+#include "engine/sidechain/networksendqueue.h"
+
+#include "util/assert.h"
+#include "util/statid.h"
+#include "util/time.h"
+
+namespace {
+
+const QString kDropOldest = QStringLiteral("drop_oldest");
+const QString kDropNewest = QStringLiteral("drop_newest");
+const QString kReconnect = QStringLiteral("reconnect");
+
+const StatId kDroppedBytesStatId("NetworkSendQueue::dropped_bytes",
+        Stat::COUNTER);
+const StatId kQueuedBytesStatId("NetworkSendQueue::bytes_queued",
+        Stat::COUNTER);
+const StatId kSentBytesStatId("NetworkSendQueue::bytes_sent",
+        Stat::COUNTER);
+const StatId kSendLatencyStatId("NetworkSendQueue::send_latency",
+        Stat::DURATION_NANOSEC);
+
+} // anonymous namespace
+
+NetworkSendQueue::NetworkSendQueue(int capacityBytes, OverflowPolicy policy)
+        : m_capacityBytes(capacityBytes),
+          m_policy(policy),
+          m_queuedBytes(0),
+          m_sentBytesOfFirstPacket(0) {
+}
+
+bool NetworkSendQueue::enqueue(const QByteArray& packet, bool pinned) {
+    if (m_queuedBytes + packet.size() > m_capacityBytes) {
+        switch (m_policy) {
+        case OverflowPolicy::DropOldest: {
+            auto it = m_packets.begin();
+            // A partially sent packet can't be dropped without
+            // corrupting the stream
+            if ((it != m_packets.end()) && (m_sentBytesOfFirstPacket > 0)) {
+                ++it;
+            }
+            while ((it != m_packets.end()) &&
+                    (m_queuedBytes + packet.size() > m_capacityBytes)) {
+                if (it->pinned) {
+                    ++it;
+                } else {
+                    it = drop(it);
+                }
+            }
+            if (m_queuedBytes + packet.size() > m_capacityBytes) {
+                // The packet exceeds the capacity together with the
+                // pinned packets
+                kDroppedBytesStatId.report(packet.size());
+                return !pinned;
+            }
+            break;
+        }
+        case OverflowPolicy::DropNewest:
+            kDroppedBytesStatId.report(packet.size());
+            return !pinned;
+        case OverflowPolicy::Reconnect:
+            kDroppedBytesStatId.report(packet.size());
+            return false;
+        }
+    }
+
+    Packet queued;
+    queued.data = packet;
+    queued.enqueuedAt = mixxx::Time::elapsed();
+    queued.pinned = pinned;
+    m_packets.push_back(std::move(queued));
+    m_queuedBytes += packet.size();
+    kQueuedBytesStatId.report(m_queuedBytes);
+    return true;
+}
+
+std::deque<NetworkSendQueue::Packet>::iterator NetworkSendQueue::drop(
+        std::deque<Packet>::iterator it) {
+    DEBUG_ASSERT((it != m_packets.begin()) || (m_sentBytesOfFirstPacket == 0));
+    DEBUG_ASSERT(!it->pinned);
+    kDroppedBytesStatId.report(it->data.size());
+    m_queuedBytes -= it->data.size();
+    return m_packets.erase(it);
+}
+
+bool NetworkSendQueue::flush(const SendFunction& send) {
+    while (!m_packets.empty()) {
+        const Packet& first = m_packets.front();
+        const int unsentBytes = first.data.size() - m_sentBytesOfFirstPacket;
+        const int sentBytes = send(
+                first.data.constData() + m_sentBytesOfFirstPacket, unsentBytes);
+        if (sentBytes < 0) {
+            return false;
+        }
+        DEBUG_ASSERT(sentBytes <= unsentBytes);
+        if (sentBytes > 0) {
+            kSentBytesStatId.report(sentBytes);
+        }
+        m_queuedBytes -= sentBytes;
+        if (sentBytes < unsentBytes) {
+            // The connection is busy
+            m_sentBytesOfFirstPacket += sentBytes;
+            return true;
+        }
+        kSendLatencyStatId.report(
+                (mixxx::Time::elapsed() - first.enqueuedAt).toIntegerNanos());
+        m_packets.pop_front();
+        m_sentBytesOfFirstPacket = 0;
+    }
+    return true;
+}
+
+void NetworkSendQueue::clear() {
+    m_packets.clear();
+    m_queuedBytes = 0;
+    m_sentBytesOfFirstPacket = 0;
+}
+
+// static
+NetworkSendQueue::OverflowPolicy NetworkSendQueue::overflowPolicyFromString(
+        const QString& name) {
+    if (name == kDropOldest) {
+        return OverflowPolicy::DropOldest;
+    } else if (name == kDropNewest) {
+        return OverflowPolicy::DropNewest;
+    }
+    return OverflowPolicy::Reconnect;
+}
+
+// static
+QString NetworkSendQueue::overflowPolicyToString(OverflowPolicy policy) {
+    switch (policy) {
+    case OverflowPolicy::DropOldest:
+        return kDropOldest;
+    case OverflowPolicy::DropNewest:
+        return kDropNewest;
+    case OverflowPolicy::Reconnect:
+        return kReconnect;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return kReconnect;
+}
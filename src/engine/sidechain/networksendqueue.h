@@ -0,0 +1,93 @@
+#ifndef NETWORKSENDQUEUE_H
+#define NETWORKSENDQUEUE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <deque>
+#include <functional>
+
+#include "util/duration.h"
+
+// Buffers encoded packets between the encoder and a network connection
+// that must not block the thread that encodes, e.g. on a stalled uplink.
+// The size of the buffer is bounded and the overflow policy decides
+// what happens if the connection can't keep up.
+//
+// Not thread-safe, the queue is owned by the thread of the connection.
+class NetworkSendQueue {
+  public:
+    enum class OverflowPolicy {
+        // Discards the oldest packets, i.e. skips ahead in the stream
+        // and keeps the latency bounded.
+        DropOldest,
+        // Discards new packets until the connection catches up.
+        DropNewest,
+        // Keeps all packets and reports the overflow, e.g. to reconnect.
+        Reconnect,
+    };
+
+    // Sends up to size bytes without blocking. Returns the number of
+    // bytes that have been accepted, 0 if the connection is busy, or a
+    // negative value on errors.
+    typedef std::function<int(const char* data, int size)> SendFunction;
+
+    NetworkSendQueue(int capacityBytes, OverflowPolicy policy);
+
+    void setCapacityBytes(int capacityBytes) {
+        m_capacityBytes = capacityBytes;
+    }
+    int capacityBytes() const {
+        return m_capacityBytes;
+    }
+    void setOverflowPolicy(OverflowPolicy policy) {
+        m_policy = policy;
+    }
+    OverflowPolicy overflowPolicy() const {
+        return m_policy;
+    }
+
+    // Returns false if the packet overflowed the queue with the policy
+    // Reconnect. The packet is discarded in this case. Pinned packets,
+    // e.g. the header pages of an Ogg stream that can't be decoded
+    // without them, are never dropped. If a pinned packet overflows the
+    // queue it is handled like with the policy Reconnect.
+    bool enqueue(const QByteArray& packet, bool pinned = false);
+
+    // Sends the queued packets until the connection is busy. Returns
+    // false if sending failed, the unsent data stays queued.
+    bool flush(const SendFunction& send);
+
+    void clear();
+
+    bool isEmpty() const {
+        return m_packets.empty();
+    }
+    int queuedBytes() const {
+        return m_queuedBytes;
+    }
+
+    // The names that are used in the preferences, "drop_oldest",
+    // "drop_newest" and "reconnect". Unknown names map to Reconnect.
+    static OverflowPolicy overflowPolicyFromString(const QString& name);
+    static QString overflowPolicyToString(OverflowPolicy policy);
+
+  private:
+    struct Packet {
+        QByteArray data;
+        mixxx::Duration enqueuedAt;
+        bool pinned;
+    };
+
+    // Returns the packet after the dropped one
+    std::deque<Packet>::iterator drop(std::deque<Packet>::iterator it);
+
+    int m_capacityBytes;
+    OverflowPolicy m_policy;
+    std::deque<Packet> m_packets;
+    int m_queuedBytes;
+    // The number of bytes of the first packet that have been sent
+    int m_sentBytesOfFirstPacket;
+};
+
+#endif // NETWORKSENDQUEUE_H
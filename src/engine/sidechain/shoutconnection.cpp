@@ -22,6 +22,7 @@
 #include "control/controlpushbutton.h"
 #include "encoder/encoder.h"
 #include "encoder/encoderbroadcastsettings.h"
+#include "encoder/sharedencoder.h"
 #ifdef __OPUS__
 #include "encoder/encoderopus.h"
 #endif
@@ -31,19 +32,29 @@
 #include "track/track.h"
 #include "util/compatibility.h"
 #include "util/logger.h"
+#include "util/statid.h"
+#include "util/time.h"
 
 #include <engine/sidechain/shoutconnection.h>
 
 namespace {
 
 const int kConnectRetries = 30;
-const int kMaxNetworkCache = 491520;  // 10 s mp3 @ 192 kbit/s
+const int kDefaultSendBufferKBytes = 480;  // 10 s mp3 @ 192 kbit/s
 // Shoutcast default receive buffer 1048576 and autodumpsourcetime 30 s
 // http://wiki.shoutcast.com/wiki/SHOUTcast_DNAS_Server_2
 const int kMaxShoutFailures = 3;
+// Interval for retrying to send queued packets while the connection is busy
+const int kSendRetryMillis = 10;
+
+const ConfigKey kSendBufferKBytesKey(BROADCAST_PREF_KEY, "send_buffer_kbytes");
+const ConfigKey kSendOverflowPolicyKey(BROADCAST_PREF_KEY, "send_overflow_policy");
 
 const mixxx::Logger kLogger("ShoutConnection");
 
+const StatId kReconnectTimeStatId("ShoutConnection::reconnect_time",
+        Stat::DURATION_NANOSEC);
+
 }
 
 ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
@@ -70,6 +81,9 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
           m_protocol_is_shoutcast(false),
           m_ogg_dynamic_update(false),
           m_threadWaiting(false),
+          m_sendQueue(kDefaultSendBufferKBytes * 1024,
+                  NetworkSendQueue::OverflowPolicy::Reconnect),
+          m_sendQueueOverflow(false),
           m_retryCount(0),
           m_reconnectFirstDelay(0.0),
           m_reconnectPeriod(5.0),
@@ -252,6 +266,15 @@ void ShoutConnection::updateFromPreferences() {
 
     m_metadataFormat = m_pProfile->getMetadataFormat();
 
+    // The send buffer bounds the latency on a slow uplink and the
+    // overflow policy decides between skipping audio and reconnecting.
+    m_sendQueue.setCapacityBytes(1024 * m_pConfig->getValue(
+            kSendBufferKBytesKey, kDefaultSendBufferKBytes));
+    m_sendQueue.setOverflowPolicy(NetworkSendQueue::overflowPolicyFromString(
+            m_pConfig->getValue(kSendOverflowPolicyKey,
+                    NetworkSendQueue::overflowPolicyToString(
+                            NetworkSendQueue::OverflowPolicy::Reconnect))));
+
     bool enableReconnect = m_pProfile->getEnableReconnect();
     if (enableReconnect) {
         m_reconnectFirstDelay = m_pProfile->getReconnectFirstDelay();
@@ -418,21 +441,27 @@ void ShoutConnection::updateFromPreferences() {
         return;
     }
 
-    // Initialize m_encoder
+    // Initialize m_encoder. Connections with the same format and
+    // settings share the encoding.
+    const EncoderFactory& encoderFactory = EncoderFactory::getFactory();
     EncoderBroadcastSettings broadcastSettings(m_pProfile);
+    QString errorMsg;
     if (m_format_is_mp3) {
-        m_encoder = EncoderFactory::getFactory().getNewEncoder(
-            EncoderFactory::getFactory().getFormatFor(ENCODING_MP3), m_pConfig, this);
-        m_encoder->setEncoderSettings(broadcastSettings);
+        m_encoder = encoderFactory.getSharedEncoder(
+            encoderFactory.getFormatFor(ENCODING_MP3), broadcastSettings,
+            iMasterSamplerate, m_pConfig, this, &errorMsg);
     } else if (m_format_is_ov) {
-        m_encoder = EncoderFactory::getFactory().getNewEncoder(
-            EncoderFactory::getFactory().getFormatFor(ENCODING_OGG), m_pConfig, this);
-        m_encoder->setEncoderSettings(broadcastSettings);
+        m_encoder = encoderFactory.getSharedEncoder(
+            encoderFactory.getFormatFor(ENCODING_OGG), broadcastSettings,
+            iMasterSamplerate, m_pConfig, this, &errorMsg);
     }
 #ifdef __OPUS__
     else if (m_format_is_opus) {
-        m_encoder = EncoderFactory::getFactory().getNewEncoder(
-            EncoderFactory::getFactory().getFormatFor(ENCODING_OPUS), m_pConfig, this);
+        // Opus uses the settings of the recording preferences
+        Encoder::Format opusFormat = encoderFactory.getFormatFor(ENCODING_OPUS);
+        m_encoder = encoderFactory.getSharedEncoder(
+            opusFormat, *encoderFactory.getEncoderSettings(opusFormat, m_pConfig),
+            iMasterSamplerate, m_pConfig, this, &errorMsg);
     }
 #endif
     else {
@@ -442,17 +471,12 @@ void ShoutConnection::updateFromPreferences() {
         return;
     }
 
-    QString errorMsg;
-    if(m_encoder->initEncoder(iMasterSamplerate, errorMsg) < 0) {
+    if (!m_encoder) {
         // e.g., if lame is not found
         // init m_encoder itself will display a message box
         kLogger.warning() << "**** Encoder init failed";
         kLogger.warning() << errorMsg;
 
-        // delete m_encoder calls write() make sure it will be exit early
-        DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-        m_encoder.reset();
-
         setState(NETWORKSTREAMWORKER_STATE_ERROR);
         m_lastErrorStr = "Encoder error";
 
@@ -622,6 +646,9 @@ bool ShoutConnection::processDisconnect() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    // Packets of the previous connection are outdated
+    m_sendQueue.clear();
+    m_sendQueueOverflow = false;
     return disconnected;
 }
 
@@ -634,26 +661,44 @@ void ShoutConnection::write(const unsigned char* header, const unsigned char* bo
         return;
     }
 
-    // Send header if there is one
+    // The packets are sent by flushSendQueue() after encoding, which
+    // might also reconnect and replace the encoder.
+    QByteArray packet;
+    packet.reserve(headerLen + bodyLen);
     if (headerLen > 0) {
-        if(!writeSingle(header, headerLen)) {
-            return;
-        }
+        packet.append(reinterpret_cast<const char*>(header), headerLen);
+    }
+    packet.append(reinterpret_cast<const char*>(body), bodyLen);
+    // Listeners can't decode an Ogg stream without its header pages
+    const bool pinned = (m_format_is_ov || m_format_is_opus) &&
+            SharedEncoder::isOggHeaderPage(packet);
+    if (!m_sendQueue.enqueue(packet, pinned)) {
+        m_sendQueueOverflow = true;
     }
+}
 
-    if(!writeSingle(body, bodyLen)) {
+void ShoutConnection::flushSendQueue() {
+    if (m_sendQueueOverflow) {
+        m_sendQueueOverflow = false;
+        kLogger.warning()
+                << "Network cache overflow with"
+                << m_sendQueue.queuedBytes() << "bytes queued";
+        m_lastErrorStr = tr("Network cache overflow");
+        tryReconnect();
         return;
     }
-
-    ssize_t queuelen = shout_queuelen(m_pShout);
-    if (queuelen > 0) {
-        kLogger.debug() << "shout_queuelen" << queuelen;
-        if (queuelen > kMaxNetworkCache) {
-            m_lastErrorStr = tr("Network cache overflow");
+    if (m_sendQueue.isEmpty() || m_iShoutStatus != SHOUTERR_CONNECTED) {
+        return;
+    }
+    if (!m_sendQueue.flush([this](const char* data, int size) {
+                return sendToServer(data, size);
+            })) {
+        if (++m_iShoutFailures > kMaxShoutFailures) {
             tryReconnect();
         }
     }
 }
+
 // These are not used for streaming, but the interface requires them
 int ShoutConnection::tell() {
     if (!m_pShout) {
@@ -671,29 +716,33 @@ int ShoutConnection::filelen() {
     return 0;
 }
 
-bool ShoutConnection::writeSingle(const unsigned char* data, size_t len) {
+int ShoutConnection::sendToServer(const char* data, int size) {
     setFunctionCode(8);
-    int ret = shout_send_raw(m_pShout, data, len);
-    if (ret == SHOUTERR_BUSY) {
-        // in case of busy, frames are queued
-        // try to flush queue after a short sleep
-        kLogger.warning() << "writeSingle() SHOUTERR_BUSY, trying again";
-        usleep(10000); // wait 10 ms until "busy" is over. TODO() tweak for an optimum.
-        // if this fails, the queue is transmitted after the next regular shout_send_raw()
-        (void)shout_send_raw(m_pShout, nullptr, 0);
-    } else if (ret < SHOUTERR_SUCCESS) {
-        m_lastErrorStr = shout_get_error(m_pShout);
-        kLogger.warning()
-                << "writeSingle() error:"
-                << ret << m_lastErrorStr;
-        if (++m_iShoutFailures > kMaxShoutFailures) {
-            tryReconnect();
+    // In non-blocking mode libshout queues all data that can't be sent
+    // immediately. Only hand over more data after its queue has been
+    // drained, the backlog is kept in m_sendQueue where the overflow
+    // policy applies.
+    int ret = SHOUTERR_SUCCESS;
+    if (shout_queuelen(m_pShout) > 0) {
+        ret = shout_send_raw(m_pShout, nullptr, 0);
+        if ((ret == SHOUTERR_BUSY) || (shout_queuelen(m_pShout) > 0)) {
+            return 0;
         }
-        return false;
-    } else {
+    }
+    if (ret == SHOUTERR_SUCCESS) {
+        ret = shout_send_raw(m_pShout,
+                reinterpret_cast<const unsigned char*>(data), size);
+    }
+    if (ret == SHOUTERR_SUCCESS || ret == SHOUTERR_BUSY) {
+        // Either sent or queued by libshout
         m_iShoutFailures = 0;
+        return size;
     }
-    return true;
+    m_lastErrorStr = shout_get_error(m_pShout);
+    kLogger.warning()
+            << "sendToServer() error:"
+            << ret << m_lastErrorStr;
+    return -1;
 }
 
 void ShoutConnection::process(const CSAMPLE* pBuffer, const int iBufferSize) {
@@ -711,7 +760,8 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const int iBufferSize) {
     if (iBufferSize > 0 && m_encoder) {
         setFunctionCode(6);
         m_encoder->encodeBuffer(pBuffer, iBufferSize);
-        // the encoded frames are received by the write() callback.
+        // the encoded frames are received by the write() callback,
+        // including those encoded for other connections.
     }
 
     // Check if track metadata has changed and if so, update.
@@ -912,10 +962,13 @@ bool ShoutConnection::waitForRetry() {
 void ShoutConnection::tryReconnect() {
     QString originalErrorStr = m_lastErrorStr;
     setStatus(BroadcastProfile::STATUS_FAILURE);
+    const mixxx::Duration failedAt = mixxx::Time::elapsed();
 
     processDisconnect();
     while (waitForRetry()) {
         if (processConnect()) {
+            kReconnectTimeStatId.report(
+                    (mixxx::Time::elapsed() - failedAt).toIntegerNanos());
             break;
         }
     }
@@ -991,7 +1044,9 @@ void ShoutConnection::run() {
 
         setFunctionCode(1);
         incRunCount();
-        if(!m_readSema.tryAcquire(1, 1000)) {
+        // Retry sending queued packets soon if the connection was busy
+        if(!m_readSema.tryAcquire(1, m_sendQueue.isEmpty() ? 1000 : kSendRetryMillis)) {
+            flushSendQueue();
             continue;
         }
 
@@ -1015,6 +1070,7 @@ void ShoutConnection::run() {
 
             m_pOutputFifo->releaseReadRegions(readAvailable);
         }
+        flushSendQueue();
     }
 
     kLogger.debug() << "run: Thread stopped";
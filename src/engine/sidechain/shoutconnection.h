@@ -19,6 +19,7 @@
 #include "control/controlproxy.h"
 #include "encoder/encodercallback.h"
 #include "encoder/encoder.h"
+#include "engine/sidechain/networksendqueue.h"
 #include "errordialoghandler.h"
 #include "preferences/usersettings.h"
 #include "track/track.h"
@@ -46,8 +47,8 @@ class ShoutConnection
     void shutdown() {
     }
 
-    // Called by the encoder in method 'encodebuffer()' to flush the stream to
-    // the server.
+    // Called by the encoder in method 'encodebuffer()' to queue the stream
+    // for sending it to the server.
     void write(const unsigned char* header, const unsigned char* body,
                int headerLen, int bodyLen) override;
     // gets stream position
@@ -109,7 +110,11 @@ class ShoutConnection
     void ignoreSigpipe();
 #endif
 
-    bool writeSingle(const unsigned char *data, size_t len);
+    // Sends the queued packets without blocking and reconnects if the
+    // queue overflowed or sending failed repeatedly.
+    void flushSendQueue();
+    // The NetworkSendQueue::SendFunction for libshout
+    int sendToServer(const char* data, int size);
 
     QByteArray encodeString(const QString& string);
 
@@ -149,6 +154,8 @@ class ShoutConnection
     QAtomicInt m_threadWaiting;
     QSemaphore m_readSema;
     QSharedPointer<FIFO<CSAMPLE>> m_pOutputFifo;
+    NetworkSendQueue m_sendQueue;
+    bool m_sendQueueOverflow;
 
     QString m_lastErrorStr;
     int m_retryCount;
@@ -161,6 +168,8 @@ class ShoutConnection
 
     QMutex m_enabledMutex;
     QWaitCondition m_waitEnabled;
+
+    friend class ShoutConnectionTest;
 };
 
 typedef QSharedPointer<ShoutConnection> ShoutConnectionPtr;
@@ -140,6 +140,8 @@ void AnalysisFeature::analyzeTracks(QList<TrackId> trackIds) {
                 m_pAnalysisView, &DlgAnalysis::onTrackAnalysisSchedulerProgress);
         connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::progress,
                 this, &AnalysisFeature::onTrackAnalysisSchedulerProgress);
+        connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::throughput,
+                m_pAnalysisView, &DlgAnalysis::onTrackAnalysisSchedulerThroughput);
         connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::finished,
                 this, &AnalysisFeature::stopAnalysis);
 
@@ -14,6 +14,83 @@ namespace {
 
 constexpr bool sDebug = false;
 
+const ColumnCache::Column kTextColumns[] = {
+    ColumnCache::COLUMN_LIBRARYTABLE_ARTIST,
+    ColumnCache::COLUMN_LIBRARYTABLE_TITLE,
+    ColumnCache::COLUMN_LIBRARYTABLE_ALBUM,
+    ColumnCache::COLUMN_LIBRARYTABLE_ALBUMARTIST,
+    ColumnCache::COLUMN_LIBRARYTABLE_YEAR,
+    ColumnCache::COLUMN_LIBRARYTABLE_GENRE,
+    ColumnCache::COLUMN_LIBRARYTABLE_COMPOSER,
+    ColumnCache::COLUMN_LIBRARYTABLE_GROUPING,
+    ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER,
+    ColumnCache::COLUMN_LIBRARYTABLE_FILETYPE,
+    ColumnCache::COLUMN_LIBRARYTABLE_NATIVELOCATION,
+    ColumnCache::COLUMN_LIBRARYTABLE_COMMENT,
+    ColumnCache::COLUMN_LIBRARYTABLE_URL,
+    ColumnCache::COLUMN_LIBRARYTABLE_KEY,
+    ColumnCache::COLUMN_LIBRARYTABLE_COVERART_LOCATION,
+};
+
+const ColumnCache::Column kNumericColumns[] = {
+    ColumnCache::COLUMN_LIBRARYTABLE_ID,
+    ColumnCache::COLUMN_LIBRARYTABLE_DURATION,
+    ColumnCache::COLUMN_LIBRARYTABLE_BITRATE,
+    ColumnCache::COLUMN_LIBRARYTABLE_BPM,
+    ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN,
+    ColumnCache::COLUMN_LIBRARYTABLE_CUEPOINT,
+    ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE,
+    ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS,
+    ColumnCache::COLUMN_LIBRARYTABLE_MIXXXDELETED,
+    ColumnCache::COLUMN_LIBRARYTABLE_HEADERPARSED,
+    ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED,
+    ColumnCache::COLUMN_LIBRARYTABLE_PLAYED,
+    ColumnCache::COLUMN_LIBRARYTABLE_RATING,
+    ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID,
+    ColumnCache::COLUMN_LIBRARYTABLE_BPM_LOCK,
+    ColumnCache::COLUMN_LIBRARYTABLE_COVERART_SOURCE,
+    ColumnCache::COLUMN_LIBRARYTABLE_COVERART_TYPE,
+    ColumnCache::COLUMN_LIBRARYTABLE_COVERART_HASH,
+    ColumnCache::COLUMN_TRACKLOCATIONSTABLE_FSDELETED,
+};
+
+// All columns that are neither known as text nor as numeric
+// columns are stored as QVariant.
+QVector<ColumnarTrackIndex::ColumnType> columnTypes(
+        const ColumnCache& columnCache, int columnCount) {
+    QVector<ColumnarTrackIndex::ColumnType> types(
+            columnCount, ColumnarTrackIndex::ColumnType::Variant);
+    for (const auto column : kTextColumns) {
+        int index = columnCache.fieldIndex(column);
+        if (index >= 0 && index < columnCount) {
+            types[index] = ColumnarTrackIndex::ColumnType::Text;
+        }
+    }
+    for (const auto column : kNumericColumns) {
+        int index = columnCache.fieldIndex(column);
+        if (index >= 0 && index < columnCount) {
+            types[index] = ColumnarTrackIndex::ColumnType::Numeric;
+        }
+    }
+    return types;
+}
+
+// Each track that matches the current query also matches the previous
+// query if the current query has been created by appending characters
+// to the previous one and both consist only of plain search terms, i.e.
+// no field filters, negations or quotes.
+bool isSearchRefinement(const QString& previousQuery, const QString& currentQuery) {
+    if (previousQuery.isEmpty() || !currentQuery.startsWith(previousQuery)) {
+        return false;
+    }
+    for (const QChar c : currentQuery) {
+        if (c == ':' || c == '-' || c == '~' || c == '"') {
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // namespace
 
 BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
@@ -27,8 +104,10 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_columnCount(columns.size()),
           m_columnsJoined(columns.join(",")),
           m_columnCache(columns),
+          m_bSortedRowsValid(false),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
+          m_trackIndex(columns, columnTypes(m_columnCache, columns.size())),
           m_trackDAO(pTrackCollection->getTrackDAO()),
           m_database(pTrackCollection->database()),
           m_pQueryParser(new SearchQueryParser(pTrackCollection)) {
@@ -97,9 +176,10 @@ void BaseTrackCache::slotTracksRemoved(QSet<TrackId> trackIds) {
         qDebug() << this << "slotTracksRemoved" << trackIds.size();
     }
     for (const auto& trackId : qAsConst(trackIds)) {
-        m_trackInfo.remove(trackId);
+        m_trackIndex.removeTrack(trackId);
         m_dirtyTracks.remove(trackId);
     }
+    invalidateSortedRows();
 }
 
 void BaseTrackCache::slotTrackDirty(TrackId trackId) {
@@ -127,7 +207,7 @@ void BaseTrackCache::slotTrackClean(TrackId trackId) {
 }
 
 bool BaseTrackCache::isCached(TrackId trackId) const {
-    return m_trackInfo.contains(trackId);
+    return m_trackIndex.contains(trackId);
 }
 
 void BaseTrackCache::ensureCached(TrackId trackId) {
@@ -151,7 +231,7 @@ const TrackPointer& BaseTrackCache::getRecentTrack(TrackId trackId) const {
     if (m_recentTrackId != trackId) {
         if (trackId.isValid()) {
             TrackPointer trackPtr =
-                    GlobalTrackCacheLocker().lookupTrackById(trackId);
+                    GlobalTrackCache::lookupTrackById(trackId);
             replaceRecentTrack(
                     std::move(trackId),
                     std::move(trackPtr));
@@ -232,14 +312,18 @@ bool BaseTrackCache::updateIndexWithTrackpointer(TrackPointer pTrack) {
 
     TrackId trackId = pTrack->getId();
     if (trackId.isValid()) {
-        // m_trackInfo[id] will insert a QVector<QVariant> into the
-        // m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        // preallocate memory for all columns at once
-        record.resize(numColumns);
+        QVector<QVariant> record(numColumns);
         for (int i = 0; i < numColumns; ++i) {
             getTrackValueForColumn(pTrack, i, record[i]);
         }
+        const int locationColumn =
+                fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_NATIVELOCATION);
+        if (locationColumn >= 0 && locationColumn < numColumns) {
+            record[locationColumn] = QDir::fromNativeSeparators(
+                    record[locationColumn].toString());
+        }
+        m_trackIndex.setTrack(trackId, record);
+        invalidateSortedRows();
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), std::move(pTrack));
         }
@@ -277,25 +361,27 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
     int numColumns = columnCount();
     int idColumn = query.record().indexOf(m_idColumn);
 
+    invalidateSortedRows();
+
+    // Reused for all rows
+    QVector<QVariant> record(numColumns);
     while (query.next()) {
         TrackId trackId(query.value(idColumn));
 
-        //m_trackInfo[id] will insert a QVector<QVariant> into the
-        //m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        record.resize(numColumns);
-
         for (int i = 0; i < numColumns; ++i) {
             if (fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_NATIVELOCATION) == i) {
                 // Database stores all locations with Qt separators: "/"
-                // Here we want to cache the display string with native separators.
+                // The index does the same, otherwise the text filters would
+                // not match the same tracks as the SQL query. data() returns
+                // the display string with native separators.
                 QString location = query.value(i).toString();
-                record[i] = QDir::toNativeSeparators(location);
+                record[i] = QDir::fromNativeSeparators(location);
             }
             else {
                 record[i] = query.value(i);
             }
         }
+        m_trackIndex.setTrack(trackId, record);
     }
 
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
@@ -317,7 +403,8 @@ void BaseTrackCache::buildIndex() {
     // TODO(rryan) for very large tables, it probably makes more sense to NOT
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
-    m_trackInfo.clear();
+    m_trackIndex.clear();
+    invalidateSortedRows();
 
     if (!updateIndexWithQuery(queryString)) {
         qDebug() << "buildIndex failed!";
@@ -452,10 +539,13 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     // metadata. Currently the upper-levels will not delegate row-specific
     // columns to this method, but there should still be a check here I think.
     if (!result.isValid()) {
-        auto it = m_trackInfo.constFind(trackId);
-        if (it != m_trackInfo.constEnd()) {
-            const QVector<QVariant>& fields = it.value();
-            result = fields.value(column, result);
+        int row = m_trackIndex.row(trackId);
+        if (row >= 0) {
+            result = m_trackIndex.value(row, column);
+            if (fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_NATIVELOCATION) == column &&
+                    !result.isNull()) {
+                result = QDir::toNativeSeparators(result.toString());
+            }
         }
     }
     return result;
@@ -477,60 +567,39 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         buildIndex();
     }
 
-    QStringList idStrings;
-    // TODO(rryan) consider making this the data passed in and a separate
-    // QVector for output
     QSet<TrackId> dirtyTracks;
     for (const auto& trackId: trackIds) {
-        idStrings << trackId.toString();
         if (m_dirtyTracks.contains(trackId)) {
             dirtyTracks.insert(trackId);
         }
     }
 
-    std::unique_ptr<QueryNode> pQuery(parseQuery(
-        searchQuery, extraFilter, idStrings));
-
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
-
-    if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
-    }
-
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
+    // Prefer filtering the in-memory index over querying the database
+    std::unique_ptr<QueryNode> pQuery(m_pQueryParser->parseQuery(
+            searchQuery, m_searchColumns, QString()));
+    if (!pQuery->canMatchIndex(m_trackIndex) ||
+            !filterAndSortWithIndex(trackIds, searchQuery, extraFilter,
+                    orderByClause, *pQuery)) {
+        QStringList idStrings;
+        // TODO(rryan) consider making this the data passed in and a separate
+        // QVector for output
+        for (const auto& trackId: trackIds) {
+            idStrings << trackId.toString();
+        }
 
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
+        pQuery = parseQuery(searchQuery, extraFilter, idStrings);
 
-    if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
+        QString filter = pQuery->toSql();
+        if (!filter.isEmpty()) {
+            filter.prepend("WHERE ");
+        }
+        queryTrackOrder(filter, orderByClause, &m_trackOrder);
     }
 
-    m_trackOrder.resize(0); // keeps allocated memory
     trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
-    }
-
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+    trackToIndex->reserve(m_trackOrder.size());
+    for (int i = 0; i < m_trackOrder.size(); ++i) {
+        (*trackToIndex)[m_trackOrder[i]] = i;
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -608,6 +677,145 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 }
 
+bool BaseTrackCache::queryTrackOrder(const QString& filter,
+                                     const QString& orderByClause,
+                                     QVector<TrackId>* pTrackOrder) const {
+    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+
+    if (sDebug) {
+        qDebug() << this << "select() executing:" << queryString;
+    }
+
+    QSqlQuery query(m_database);
+    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+    // won't allocate a giant in-memory table that we won't use at all.
+    query.setForwardOnly(true);
+    query.prepare(queryString);
+
+    pTrackOrder->resize(0); // keeps allocated memory
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
+    int idColumn = query.record().indexOf(m_idColumn);
+    int rows = query.size();
+
+    if (sDebug) {
+        qDebug() << "Rows returned:" << rows;
+    }
+
+    if (rows > 0) {
+        pTrackOrder->reserve(rows);
+    }
+
+    while (query.next()) {
+        pTrackOrder->append(TrackId(query.value(idColumn)));
+    }
+    return true;
+}
+
+bool BaseTrackCache::filterAndSortWithIndex(const QSet<TrackId>& trackIds,
+                                            const QString& searchQuery,
+                                            const QString& extraFilter,
+                                            const QString& orderByClause,
+                                            const QueryNode& searchNode) {
+    if (!updateSortedRows(trackIds, extraFilter, orderByClause)) {
+        return false;
+    }
+
+    PerformanceTimer timer;
+    timer.start();
+
+    std::vector<int> matchingRows;
+    if (searchQuery.isEmpty()) {
+        matchingRows = m_sortedRows;
+    } else {
+        // Only the tracks that matched the previous query need to be
+        // evaluated while the user is typing.
+        const std::vector<int>& candidateRows =
+                isSearchRefinement(m_lastSearchQuery, searchQuery) ?
+                        m_lastSearchRows : m_sortedRows;
+        matchingRows.reserve(candidateRows.size());
+        for (const int row : candidateRows) {
+            if (searchNode.matchIndex(m_trackIndex, row)) {
+                matchingRows.push_back(row);
+            }
+        }
+    }
+    m_lastSearchQuery = searchQuery;
+    m_lastSearchRows.swap(matchingRows);
+
+    m_trackOrder.resize(0); // keeps allocated memory
+    m_trackOrder.reserve(m_lastSearchRows.size());
+    for (const int row : m_lastSearchRows) {
+        m_trackOrder.append(m_trackIndex.trackId(row));
+    }
+
+    if (sDebug) {
+        qDebug() << this << "filterAndSortWithIndex took"
+                 << timer.elapsed().debugMillisWithUnit();
+    }
+    return true;
+}
+
+bool BaseTrackCache::updateSortedRows(const QSet<TrackId>& trackIds,
+                                      const QString& extraFilter,
+                                      const QString& orderByClause) {
+    if (m_bSortedRowsValid &&
+            m_sortedRowsExtraFilter == extraFilter &&
+            m_sortedRowsOrderByClause == orderByClause &&
+            m_sortedRowsTrackIds == trackIds) {
+        return true;
+    }
+    invalidateSortedRows();
+
+    // The strings of removed or modified tracks stay in the pool of the
+    // index. Compacting renumbers the strings, but not the rows.
+    if (m_trackIndex.releasedStringCount() > m_trackIndex.stringCount() / 2) {
+        m_trackIndex.compactStrings();
+    }
+
+    QStringList idStrings;
+    for (const auto& trackId: trackIds) {
+        idStrings << trackId.toString();
+    }
+    std::unique_ptr<QueryNode> pQuery(parseQuery(
+            QString(), extraFilter, idStrings));
+    QString filter = pQuery->toSql();
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+    if (!queryTrackOrder(filter, orderByClause, &m_trackOrder)) {
+        return false;
+    }
+
+    m_sortedRows.reserve(m_trackOrder.size());
+    for (const auto& trackId : qAsConst(m_trackOrder)) {
+        int row = m_trackIndex.row(trackId);
+        if (row < 0) {
+            qDebug() << "WARNING: track" << trackId << "was not in index";
+            m_sortedRows.clear();
+            return false;
+        }
+        m_sortedRows.push_back(row);
+    }
+
+    m_sortedRowsTrackIds = trackIds;
+    m_sortedRowsExtraFilter = extraFilter;
+    m_sortedRowsOrderByClause = orderByClause;
+    m_bSortedRowsValid = true;
+    return true;
+}
+
+void BaseTrackCache::invalidateSortedRows() {
+    m_bSortedRowsValid = false;
+    m_sortedRows.clear();
+    m_lastSearchQuery.clear();
+    m_lastSearchRows.clear();
+}
+
 std::unique_ptr<QueryNode> BaseTrackCache::parseQuery(QString query, QString extraFilter,
                                       QStringList idStrings) const {
     QStringList queryFragments;
@@ -654,7 +862,7 @@ int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
 
         // This should not happen, but it's a recoverable error so we should
         // only log it.
-        if (!m_trackInfo.contains(otherTrackId)) {
+        if (!m_trackIndex.contains(otherTrackId)) {
             qDebug() << "WARNING: track" << otherTrackId << "was not in index";
             //updateTrackInIndex(otherTrackId);
         }
@@ -14,6 +14,7 @@
 #include <QVector>
 
 #include "library/dao/trackdao.h"
+#include "library/columnartrackindex.h"
 #include "library/columncache.h"
 #include "track/track.h"
 #include "util/class.h"
@@ -102,6 +103,18 @@ class BaseTrackCache : public QObject {
 
     std::unique_ptr<QueryNode> parseQuery(QString query, QString extraFilter,
                           QStringList idStrings) const;
+    bool queryTrackOrder(const QString& filter,
+                         const QString& orderByClause,
+                         QVector<TrackId>* pTrackOrder) const;
+    bool filterAndSortWithIndex(const QSet<TrackId>& trackIds,
+                                const QString& searchQuery,
+                                const QString& extraFilter,
+                                const QString& orderByClause,
+                                const QueryNode& searchNode);
+    bool updateSortedRows(const QSet<TrackId>& trackIds,
+                          const QString& extraFilter,
+                          const QString& orderByClause);
+    void invalidateSortedRows();
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -132,6 +145,21 @@ class BaseTrackCache : public QObject {
 
     QVector<TrackId> m_trackOrder;
 
+    // The rows of m_trackIndex that pass the extra filter in the order of
+    // the most recent filterAndSort() call. Searches only need to filter
+    // these rows as long as neither the tracks, the extra filter nor the
+    // order change, e.g. while the user is typing a search query. Rows are
+    // invalidated by any modification of m_trackIndex.
+    bool m_bSortedRowsValid;
+    QSet<TrackId> m_sortedRowsTrackIds;
+    QString m_sortedRowsExtraFilter;
+    QString m_sortedRowsOrderByClause;
+    std::vector<int> m_sortedRows;
+
+    // The rows of m_sortedRows that match the most recent search query
+    QString m_lastSearchQuery;
+    std::vector<int> m_lastSearchRows;
+
     // Remember key and value of the most recent cache lookup to avoid querying
     // the global track cache again and again while populating the columns
     // of a single row. These members serve as a single-valued private cache.
@@ -146,7 +174,7 @@ class BaseTrackCache : public QObject {
 
     bool m_bIndexBuilt;
     bool m_bIsCaching;
-    QHash<TrackId, QVector<QVariant> > m_trackInfo;
+    ColumnarTrackIndex m_trackIndex;
     TrackDAO& m_trackDAO;
     QSqlDatabase m_database;
     SearchQueryParser* m_pQueryParser;
@@ -0,0 +1,387 @@
+#include "library/columnartrackindex.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+const int kTrigramLength = 3;
+
+// The type of a numeric value is stored in 7 bits
+const quint8 kNullNumberFlag = 0x80;
+const quint8 kIrregularNumberType = 0x7F;
+
+inline quint64 trigramKey(const QChar* pChars) {
+    return (static_cast<quint64>(pChars[0].unicode()) << 32) |
+            (static_cast<quint64>(pChars[1].unicode()) << 16) |
+            static_cast<quint64>(pChars[2].unicode());
+}
+
+bool isStorableNumberType(QVariant::Type type) {
+    switch (static_cast<int>(type)) {
+    case QVariant::Invalid:
+    case QVariant::Bool:
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+    case QVariant::Double:
+    case QMetaType::Float:
+        return true;
+    default:
+        return false;
+    }
+}
+
+QVariant numberToVariant(double number, quint8 type) {
+    switch (type) {
+    case QVariant::Bool:
+        return QVariant(number != 0.0);
+    case QVariant::Int:
+        return QVariant(static_cast<int>(number));
+    case QVariant::UInt:
+        return QVariant(static_cast<uint>(number));
+    case QVariant::LongLong:
+        return QVariant(static_cast<qlonglong>(number));
+    case QVariant::ULongLong:
+        return QVariant(static_cast<qulonglong>(number));
+    case QMetaType::Float:
+        return QVariant(static_cast<float>(number));
+    default:
+        return QVariant(number);
+    }
+}
+
+} // anonymous namespace
+
+ColumnarTrackIndex::ColumnarTrackIndex(
+        const QStringList& columnNames,
+        const QVector<ColumnType>& columnTypes)
+        : m_columnNames(columnNames),
+          m_columns(columnNames.size()),
+          m_releasedStringCount(0),
+          m_trigramIndexedStringCount(0) {
+    DEBUG_ASSERT(columnNames.size() == columnTypes.size());
+    for (int i = 0; i < columnTypes.size(); ++i) {
+        m_columns[i].type = columnTypes[i];
+    }
+    clear();
+}
+
+void ColumnarTrackIndex::clear() {
+    for (auto& column : m_columns) {
+        column.stringIds.clear();
+        column.numbers.clear();
+        column.numberTypes.clear();
+        column.variants.clear();
+    }
+    m_trackIds.clear();
+    m_rowsByTrackId.clear();
+    m_freeRows.clear();
+    m_irregularValues.clear();
+
+    m_strings.clear();
+    m_foldedStrings.clear();
+    m_stringIds.clear();
+    m_releasedStringCount = 0;
+    m_trigramPostings.clear();
+    m_trigramIndexedStringCount = 0;
+    // String 0 represents null values
+    m_strings.append(QString());
+    m_foldedStrings.append(QString());
+}
+
+void ColumnarTrackIndex::setTrack(TrackId trackId, const QVector<QVariant>& values) {
+    DEBUG_ASSERT(trackId.isValid());
+    int row = this->row(trackId);
+    if (row < 0) {
+        if (m_freeRows.empty()) {
+            row = static_cast<int>(m_trackIds.size());
+            m_trackIds.push_back(trackId);
+            for (auto& column : m_columns) {
+                switch (column.type) {
+                case ColumnType::Text:
+                    column.stringIds.push_back(0);
+                    break;
+                case ColumnType::Numeric:
+                    column.numbers.push_back(0.0);
+                    column.numberTypes.push_back(kNullNumberFlag);
+                    break;
+                case ColumnType::Variant:
+                    column.variants.push_back(QVariant());
+                    break;
+                }
+            }
+        } else {
+            row = m_freeRows.back();
+            m_freeRows.pop_back();
+            m_trackIds[row] = trackId;
+        }
+        m_rowsByTrackId.insert(trackId, row);
+    }
+    for (int i = 0; i < columnCount(); ++i) {
+        setValue(row, i, values.value(i));
+    }
+}
+
+void ColumnarTrackIndex::removeTrack(TrackId trackId) {
+    auto it = m_rowsByTrackId.find(trackId);
+    if (it == m_rowsByTrackId.end()) {
+        return;
+    }
+    const int row = it.value();
+    m_rowsByTrackId.erase(it);
+    m_trackIds[row] = TrackId();
+    // Release the values
+    for (int i = 0; i < columnCount(); ++i) {
+        Column& col = m_columns[i];
+        switch (col.type) {
+        case ColumnType::Text:
+            if (col.stringIds[row] != 0) {
+                col.stringIds[row] = 0;
+                ++m_releasedStringCount;
+            }
+            break;
+        case ColumnType::Numeric:
+            col.numberTypes[row] = kNullNumberFlag;
+            break;
+        case ColumnType::Variant:
+            col.variants[row] = QVariant();
+            break;
+        }
+        if (!m_irregularValues.isEmpty()) {
+            m_irregularValues.remove(irregularValueKey(row, i));
+        }
+    }
+    m_freeRows.push_back(row);
+}
+
+void ColumnarTrackIndex::setValue(int row, int column, const QVariant& value) {
+    if (!m_irregularValues.isEmpty()) {
+        m_irregularValues.remove(irregularValueKey(row, column));
+    }
+    Column& col = m_columns[column];
+    switch (col.type) {
+    case ColumnType::Text: {
+        // The text representation of irregular values is used for filtering
+        const quint32 stringId = value.isNull() ? 0 : internString(value.toString());
+        if (col.stringIds[row] != 0 && col.stringIds[row] != stringId) {
+            ++m_releasedStringCount;
+        }
+        col.stringIds[row] = stringId;
+        if (value.type() != QVariant::String) {
+            m_irregularValues.insert(irregularValueKey(row, column), value);
+        }
+        break;
+    }
+    case ColumnType::Numeric:
+        if (isStorableNumberType(value.type())) {
+            col.numbers[row] = value.isNull() ? 0.0 : value.toDouble();
+            col.numberTypes[row] = static_cast<quint8>(value.type()) |
+                    (value.isNull() ? kNullNumberFlag : 0);
+        } else {
+            bool ok = false;
+            const double number = value.toDouble(&ok);
+            col.numbers[row] = number;
+            col.numberTypes[row] = kIrregularNumberType |
+                    (ok && !value.isNull() ? 0 : kNullNumberFlag);
+            m_irregularValues.insert(irregularValueKey(row, column), value);
+        }
+        break;
+    case ColumnType::Variant:
+        col.variants[row] = value;
+        break;
+    }
+}
+
+quint32 ColumnarTrackIndex::internString(const QString& string) {
+    auto it = m_stringIds.constFind(string);
+    if (it != m_stringIds.constEnd()) {
+        return it.value();
+    }
+    const quint32 stringId = m_strings.size();
+    m_strings.append(string);
+    QString foldedString = string;
+    foldString(&foldedString);
+    m_foldedStrings.append(foldedString);
+    m_stringIds.insert(string, stringId);
+    return stringId;
+}
+
+void ColumnarTrackIndex::compactStrings() {
+    // String 0 represents null values and is always kept
+    std::vector<quint32> newStringIds(m_strings.size(), 0);
+    for (const auto& column : m_columns) {
+        for (const auto stringId : column.stringIds) {
+            newStringIds[stringId] = 1;
+        }
+    }
+    newStringIds[0] = 0;
+    quint32 newStringCount = 1;
+    m_stringIds.clear();
+    for (int i = 1; i < m_strings.size(); ++i) {
+        if (newStringIds[i] == 0) {
+            continue;
+        }
+        newStringIds[i] = newStringCount;
+        m_strings[newStringCount] = m_strings[i];
+        m_foldedStrings[newStringCount] = m_foldedStrings[i];
+        m_stringIds.insert(m_strings[newStringCount], newStringCount);
+        ++newStringCount;
+    }
+    m_strings.resize(newStringCount);
+    m_strings.squeeze();
+    m_foldedStrings.resize(newStringCount);
+    m_foldedStrings.squeeze();
+    for (auto& column : m_columns) {
+        for (auto& stringId : column.stringIds) {
+            stringId = newStringIds[stringId];
+        }
+    }
+    m_releasedStringCount = 0;
+    // The posting lists refer to the old string ids
+    m_trigramPostings.clear();
+    m_trigramIndexedStringCount = 0;
+}
+
+QVariant ColumnarTrackIndex::value(int row, int column) const {
+    if (column < 0 || column >= columnCount()) {
+        return QVariant();
+    }
+    const Column& col = m_columns[column];
+    if (col.type == ColumnType::Variant) {
+        return col.variants[row];
+    }
+    if (!m_irregularValues.isEmpty()) {
+        auto it = m_irregularValues.constFind(irregularValueKey(row, column));
+        if (it != m_irregularValues.constEnd()) {
+            return it.value();
+        }
+    }
+    if (col.type == ColumnType::Text) {
+        const quint32 stringId = col.stringIds[row];
+        if (stringId == 0) {
+            // The database returns null strings for NULL
+            return QVariant(QVariant::String);
+        }
+        return m_strings[stringId];
+    }
+    const quint8 numberType = col.numberTypes[row];
+    if (numberType & kNullNumberFlag) {
+        return QVariant(static_cast<QVariant::Type>(numberType & ~kNullNumberFlag));
+    }
+    return numberToVariant(col.numbers[row], numberType);
+}
+
+bool ColumnarTrackIndex::isNull(int row, int column) const {
+    const Column& col = m_columns[column];
+    switch (col.type) {
+    case ColumnType::Text:
+        return col.stringIds[row] == 0;
+    case ColumnType::Numeric:
+        if ((col.numberTypes[row] & ~kNullNumberFlag) == kIrregularNumberType) {
+            return value(row, column).isNull();
+        }
+        return col.numberTypes[row] & kNullNumberFlag;
+    case ColumnType::Variant:
+        return col.variants[row].isNull();
+    }
+    return true;
+}
+
+bool ColumnarTrackIndex::numericValue(int row, int column, double* pValue) const {
+    const Column& col = m_columns[column];
+    switch (col.type) {
+    case ColumnType::Text: {
+        const quint32 stringId = col.stringIds[row];
+        if (stringId == 0) {
+            return false;
+        }
+        bool ok = false;
+        *pValue = m_strings[stringId].toDouble(&ok);
+        return ok;
+    }
+    case ColumnType::Numeric:
+        if (col.numberTypes[row] & kNullNumberFlag) {
+            return false;
+        }
+        *pValue = col.numbers[row];
+        return true;
+    case ColumnType::Variant: {
+        bool ok = false;
+        *pValue = col.variants[row].toDouble(&ok);
+        return ok && !col.variants[row].isNull();
+    }
+    }
+    return false;
+}
+
+void ColumnarTrackIndex::updateTrigramIndex() const {
+    std::vector<quint64> trigrams;
+    for (int i = m_trigramIndexedStringCount; i < m_foldedStrings.size(); ++i) {
+        const QString& string = m_foldedStrings[i];
+        trigrams.clear();
+        for (int j = 0; j + kTrigramLength <= string.size(); ++j) {
+            trigrams.push_back(trigramKey(string.constData() + j));
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        // String ids are increasing, i.e. the posting lists stay sorted
+        for (const auto trigram : trigrams) {
+            m_trigramPostings[trigram].push_back(i);
+        }
+    }
+    m_trigramIndexedStringCount = m_foldedStrings.size();
+}
+
+std::vector<bool> ColumnarTrackIndex::matchStrings(const QString& foldedNeedle) const {
+    std::vector<bool> matches(m_foldedStrings.size(), false);
+    if (foldedNeedle.size() < kTrigramLength) {
+        // Not selective enough for the trigram index
+        for (int i = 1; i < m_foldedStrings.size(); ++i) {
+            matches[i] = m_foldedStrings[i].contains(foldedNeedle);
+        }
+        return matches;
+    }
+
+    updateTrigramIndex();
+
+    // Candidates contain all trigrams of the needle
+    std::vector<const std::vector<quint32>*> postings;
+    for (int i = 0; i + kTrigramLength <= foldedNeedle.size(); ++i) {
+        auto it = m_trigramPostings.constFind(trigramKey(foldedNeedle.constData() + i));
+        if (it == m_trigramPostings.constEnd()) {
+            return matches;
+        }
+        postings.push_back(&it.value());
+    }
+    // Start with the shortest list to keep the intersections small
+    std::sort(postings.begin(), postings.end(),
+            [](const std::vector<quint32>* pLhs, const std::vector<quint32>* pRhs) {
+                return pLhs->size() < pRhs->size();
+            });
+    std::vector<quint32> candidates(*postings.front());
+    std::vector<quint32> intersection;
+    for (size_t i = 1; i < postings.size() && !candidates.empty(); ++i) {
+        intersection.clear();
+        std::set_intersection(
+                candidates.begin(), candidates.end(),
+                postings[i]->begin(), postings[i]->end(),
+                std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+
+    // The trigrams might occur in a different order
+    for (const auto stringId : candidates) {
+        matches[stringId] = m_foldedStrings[stringId].contains(foldedNeedle);
+    }
+    return matches;
+}
+
+// static
+void ColumnarTrackIndex::foldString(QString* pString) {
+    mixxx::DbConnection::makeStringLatinLow(pString);
+}
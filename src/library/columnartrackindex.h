@@ -0,0 +1,148 @@
+#ifndef COLUMNARTRACKINDEX_H
+#define COLUMNARTRACKINDEX_H
+
+#include <vector>
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include "track/trackid.h"
+
+// Column-oriented in-memory copy of the table of a BaseTrackCache that
+// allows to filter tracks without querying the database.
+//
+// Text values are interned in a string pool that also contains a folded
+// lowercase copy of each string as used by the text filters. The folded
+// strings are indexed by their trigrams on demand. Numeric values are
+// stored as doubles together with their original type. All other values
+// are stored as QVariant.
+//
+// Rows of removed tracks are reused for subsequently added tracks, i.e.
+// row numbers are only valid until the index is modified. The strings
+// of removed or modified values stay in the pool until it is compacted,
+// which changes the string ids.
+class ColumnarTrackIndex {
+  public:
+    enum class ColumnType {
+        Text,
+        Numeric,
+        Variant,
+    };
+
+    ColumnarTrackIndex(
+            const QStringList& columnNames,
+            const QVector<ColumnType>& columnTypes);
+
+    void clear();
+
+    // Inserts or replaces the values of a track. Missing values
+    // are stored as invalid QVariants.
+    void setTrack(TrackId trackId, const QVector<QVariant>& values);
+    void removeTrack(TrackId trackId);
+
+    int trackCount() const {
+        return m_rowsByTrackId.size();
+    }
+    bool contains(TrackId trackId) const {
+        return m_rowsByTrackId.contains(trackId);
+    }
+    // Returns -1 if the track is not stored
+    int row(TrackId trackId) const {
+        return m_rowsByTrackId.value(trackId, -1);
+    }
+    TrackId trackId(int row) const {
+        return m_trackIds[row];
+    }
+
+    int columnCount() const {
+        return m_columns.size();
+    }
+    // Returns -1 if the column does not exist
+    int columnIndex(const QString& columnName) const {
+        return m_columnNames.indexOf(columnName);
+    }
+    ColumnType columnType(int column) const {
+        return m_columns[column].type;
+    }
+
+    // Returns the value as it has been stored
+    QVariant value(int row, int column) const;
+
+    bool isNull(int row, int column) const;
+
+    // Text and numeric columns. Returns false if the value is null or not
+    // a number.
+    bool numericValue(int row, int column, double* pValue) const;
+
+    // Text columns. Null values are mapped to string 0, which is empty.
+    quint32 stringId(int row, int column) const {
+        return m_columns[column].stringIds[row];
+    }
+    const QString& foldedString(quint32 stringId) const {
+        return m_foldedStrings[stringId];
+    }
+    int stringCount() const {
+        return m_strings.size();
+    }
+    // The number of values that have released their string since the
+    // pool has been compacted. Other values might still refer to the
+    // same strings, i.e. this is an upper bound of the unused strings.
+    int releasedStringCount() const {
+        return m_releasedStringCount;
+    }
+    // Removes all strings from the pool that are not referenced by
+    // any value and renumbers the remaining strings.
+    void compactStrings();
+
+    // Returns for every string in the pool if it contains the folded
+    // needle, see foldString().
+    std::vector<bool> matchStrings(const QString& foldedNeedle) const;
+
+    // The folding of both the search term and the values of text filters
+    static void foldString(QString* pString);
+
+  private:
+    struct Column {
+        ColumnType type;
+        // Text
+        std::vector<quint32> stringIds;
+        // Numeric
+        std::vector<double> numbers;
+        std::vector<quint8> numberTypes;
+        // Variant
+        std::vector<QVariant> variants;
+    };
+
+    void setValue(int row, int column, const QVariant& value);
+    quint32 internString(const QString& string);
+    void updateTrigramIndex() const;
+
+    static quint64 irregularValueKey(int row, int column) {
+        return (static_cast<quint64>(row) << 16) | static_cast<quint64>(column);
+    }
+
+    const QStringList m_columnNames;
+    std::vector<Column> m_columns;
+
+    std::vector<TrackId> m_trackIds;
+    QHash<TrackId, int> m_rowsByTrackId;
+    std::vector<int> m_freeRows;
+
+    // Values that do not match the type of their column, e.g. text
+    // in a numeric column
+    QHash<quint64, QVariant> m_irregularValues;
+
+    QVector<QString> m_strings;
+    QVector<QString> m_foldedStrings;
+    QHash<QString, quint32> m_stringIds;
+    int m_releasedStringCount;
+
+    // Sorted ids of the strings that contain a trigram
+    mutable QHash<quint64, std::vector<quint32>> m_trigramPostings;
+    mutable int m_trigramIndexedStringCount;
+};
+
+#endif // COLUMNARTRACKINDEX_H
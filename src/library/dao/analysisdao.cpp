@@ -8,6 +8,8 @@
 #include "preferences/waveformsettings.h"
 #include "util/performancetimer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformfactory.h"
+#include "waveform/waveformfile.h"
 
 const QString AnalysisDao::s_analysisTableName = "track_analysis";
 
@@ -84,7 +86,27 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         int checksum = query->value(dataChecksumColumn).toInt();
         QString dataPath = analysisPath.absoluteFilePath(
             QString::number(info.analysisId));
-        QByteArray compressedData = loadDataFromFile(dataPath);
+        QFile file(dataPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qDebug() << "WARNING: Could not open analysis" << dataPath;
+            continue;
+        }
+        // Memory-mappable files are stored uncompressed and only their
+        // header is covered by the checksum. The data is mapped later
+        // when loading the waveform.
+        QByteArray header = WaveformFile::readHeader(&file);
+        if (!header.isEmpty()) {
+            if (checksum != qChecksum(header.constData(), header.length())) {
+                qDebug() << "WARNING: Corrupt analysis header loaded from"
+                         << dataPath;
+                continue;
+            }
+            info.dataFilePath = dataPath;
+            bytes += header.length();
+            analyses.append(info);
+            continue;
+        }
+        QByteArray compressedData = file.readAll();
         int file_checksum = qChecksum(compressedData.constData(),
                                       compressedData.length());
         if (checksum != file_checksum) {
@@ -114,9 +136,19 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
     PerformanceTimer time;
     time.start();
 
-    QByteArray compressedData = qCompress(info->data, kCompressionLevel);
-    int checksum = qChecksum(compressedData.constData(),
+    QByteArray compressedData;
+    int checksum;
+    const QByteArray waveformFileHeader = WaveformFile::header(info->data);
+    if (!waveformFileHeader.isEmpty()) {
+        // Stored as is for mapping it into memory
+        compressedData = info->data;
+        checksum = qChecksum(waveformFileHeader.constData(),
+                             waveformFileHeader.length());
+    } else {
+        compressedData = qCompress(info->data, kCompressionLevel);
+        checksum = qChecksum(compressedData.constData(),
                              compressedData.length());
+    }
 
     QSqlQuery query(m_db);
     if (info->analysisId == -1) {
@@ -251,17 +283,6 @@ QDir AnalysisDao::getAnalysisStoragePath() const {
     return dir.absolutePath().append("/");
 }
 
-QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
-    QFile file(filename);
-    if (!file.exists()) {
-        return QByteArray();
-    }
-    if (!file.open(QIODevice::ReadOnly)) {
-        return QByteArray();
-    }
-    return file.readAll();
-}
-
 bool AnalysisDao::deleteFile(const QString& fileName) const {
     QFile file(fileName);
     return file.remove();
@@ -321,6 +342,8 @@ void AnalysisDao::saveTrackAnalyses(
         return;
     }
 
+    const bool compress = waveformSettings.waveformCacheCompressionEnabled();
+
     AnalysisDao::AnalysisInfo analysis;
     analysis.trackId = trackId;
     if (pWaveform->getId() != -1) {
@@ -329,7 +352,8 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVEFORM;
     analysis.description = pWaveform->getDescription();
     analysis.version = pWaveform->getVersion();
-    analysis.data = pWaveform->toByteArray();
+    analysis.data = WaveformFactory::saveWaveformToAnalysisData(
+            *pWaveform, analysis.type, compress);
     bool success = saveAnalysis(&analysis);
     if (success) {
         pWaveform->setSaveState(Waveform::SaveState::Saved);
@@ -344,7 +368,8 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
     analysis.description = pWaveSummary->getDescription();
     analysis.version = pWaveSummary->getVersion();
-    analysis.data = pWaveSummary->toByteArray();
+    analysis.data = WaveformFactory::saveWaveformToAnalysisData(
+            *pWaveSummary, analysis.type, compress);
 
     success = saveAnalysis(&analysis);
     if (success) {
@@ -355,6 +380,40 @@ void AnalysisDao::saveTrackAnalyses(
              << "analysisId" << analysis.analysisId;
 }
 
+bool AnalysisDao::migrateWaveformAnalysis(AnalysisInfo* pAnalysis) {
+    DEBUG_ASSERT(pAnalysis);
+    PerformanceTimer time;
+    time.start();
+
+    std::unique_ptr<Waveform> pWaveform(
+            WaveformFactory::loadWaveformFromAnalysis(*pAnalysis));
+    if (!pWaveform->isValid()) {
+        return false;
+    }
+    if (pAnalysis->type == TYPE_WAVEFORM) {
+        pAnalysis->version = WaveformFactory::currentWaveformVersion();
+        pAnalysis->description = WaveformFactory::currentWaveformDescription();
+    } else if (pAnalysis->type == TYPE_WAVESUMMARY) {
+        pAnalysis->version = WaveformFactory::currentWaveformSummaryVersion();
+        pAnalysis->description = WaveformFactory::currentWaveformSummaryDescription();
+    } else {
+        DEBUG_ASSERT(!"unsupported analysis type");
+        return false;
+    }
+    WaveformSettings waveformSettings(m_pConfig);
+    pAnalysis->data = WaveformFactory::saveWaveformToAnalysisData(
+            *pWaveform, pAnalysis->type,
+            waveformSettings.waveformCacheCompressionEnabled());
+    pAnalysis->dataFilePath.clear();
+    if (!saveAnalysis(pAnalysis)) {
+        return false;
+    }
+    qDebug() << "AnalysisDAO migrated analysis" << pAnalysis->analysisId
+             << "to" << pAnalysis->version
+             << "in" << time.elapsed().debugMillisWithUnit();
+    return true;
+}
+
 size_t AnalysisDao::getDiskUsageInBytes(
         const QSqlDatabase& database,
         AnalysisType type) const {
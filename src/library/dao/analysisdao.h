@@ -31,6 +31,9 @@ class AnalysisDao : public DAO {
         QString description;
         QString version;
         QByteArray data;
+        // Only set for analyses that are stored in a memory-mappable
+        // format. The data is not loaded in this case.
+        QString dataFilePath;
     };
 
     explicit AnalysisDao(UserSettingsPointer pConfig);
@@ -57,6 +60,10 @@ class AnalysisDao : public DAO {
     void deleteAnalyses(const QList<TrackId>& trackIds);
     bool deleteAnalysesForTrack(TrackId trackId);
 
+    // Converts a waveform analysis that has been stored as protobuf by a
+    // previous version into the current format. The analysis keeps its id.
+    bool migrateWaveformAnalysis(AnalysisInfo* pAnalysis);
+
     void saveTrackAnalyses(
             TrackId trackId,
             ConstWaveformPointer pWaveform,
@@ -64,7 +71,6 @@ class AnalysisDao : public DAO {
 
   private:
     QDir getAnalysisStoragePath() const;
-    QByteArray loadDataFromFile(const QString& fileName) const;
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
     QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
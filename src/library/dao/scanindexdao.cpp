@@ -0,0 +1,172 @@
+#include <QtSql>
+
+#include "library/dao/scanindexdao.h"
+
+#include "library/dao/settingsdao.h"
+#include "library/queryutil.h"
+#include "util/db/sqlstringformatter.h"
+
+namespace {
+
+// Subdirectory names can't contain a slash on any platform.
+const QChar kSubdirectorySeparator('/');
+
+const QString kSupportedExtensionsSetting = "mixxx.scanindex.extensions";
+
+} // anonymous namespace
+
+void ScanIndexDAO::validateSupportedExtensions(const QString& supportedExtensions) {
+    SettingsDAO settings(m_database);
+    if (settings.getValue(kSupportedExtensionsSetting) == supportedExtensions) {
+        return;
+    }
+    // Files with newly supported extensions are missing in the index
+    removeAllDirectories();
+    settings.setValue(kSupportedExtensionsSetting, supportedExtensions);
+}
+
+ScanIndex ScanIndexDAO::getIndex() {
+    ScanIndex index;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT directory_path, size, mtime, inode, indexed_at, "
+                  "subdirectories FROM scan_index_directories");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return index;
+    }
+    const int pathColumn = query.record().indexOf("directory_path");
+    const int sizeColumn = query.record().indexOf("size");
+    const int mtimeColumn = query.record().indexOf("mtime");
+    const int inodeColumn = query.record().indexOf("inode");
+    const int indexedAtColumn = query.record().indexOf("indexed_at");
+    const int subdirectoriesColumn = query.record().indexOf("subdirectories");
+    while (query.next()) {
+        ScanIndexDirectory directory(
+                FileStamp(query.value(sizeColumn).toLongLong(),
+                          query.value(mtimeColumn).toLongLong(),
+                          query.value(inodeColumn).toULongLong()),
+                query.value(indexedAtColumn).toLongLong());
+        directory.subdirectories =
+                query.value(subdirectoriesColumn).toString().split(
+                        kSubdirectorySeparator, QString::SkipEmptyParts);
+        index.insert(query.value(pathColumn).toString(), directory);
+    }
+
+    query.prepare("SELECT directory_path, filename, size, mtime, inode "
+                  "FROM scan_index_files");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        // Without its files an entry would hide in place modifications
+        return ScanIndex();
+    }
+    const int filePathColumn = query.record().indexOf("directory_path");
+    const int fileNameColumn = query.record().indexOf("filename");
+    const int fileSizeColumn = query.record().indexOf("size");
+    const int fileMtimeColumn = query.record().indexOf("mtime");
+    const int fileInodeColumn = query.record().indexOf("inode");
+    while (query.next()) {
+        auto it = index.find(query.value(filePathColumn).toString());
+        if (it == index.end()) {
+            continue;
+        }
+        ScanIndexDirectory::File file;
+        file.name = query.value(fileNameColumn).toString();
+        file.stamp = FileStamp(query.value(fileSizeColumn).toLongLong(),
+                               query.value(fileMtimeColumn).toLongLong(),
+                               query.value(fileInodeColumn).toULongLong());
+        it->files.append(file);
+    }
+    return index;
+}
+
+QStringList ScanIndexDAO::getIndexedDirectories() {
+    QStringList dirPaths;
+    QSqlQuery query(m_database);
+    query.prepare("SELECT directory_path FROM scan_index_directories");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return dirPaths;
+    }
+    while (query.next()) {
+        dirPaths << query.value(0).toString();
+    }
+    return dirPaths;
+}
+
+void ScanIndexDAO::saveDirectories(const ScanIndex& directories) {
+    QSqlQuery directoryQuery(m_database);
+    directoryQuery.prepare("INSERT OR REPLACE INTO scan_index_directories "
+                           "(directory_path, size, mtime, inode, indexed_at, subdirectories) "
+                           "VALUES (:directory_path, :size, :mtime, :inode, :indexed_at, "
+                           ":subdirectories)");
+    QSqlQuery removeFilesQuery(m_database);
+    removeFilesQuery.prepare("DELETE FROM scan_index_files "
+                             "WHERE directory_path=:directory_path");
+    QSqlQuery fileQuery(m_database);
+    fileQuery.prepare("INSERT INTO scan_index_files "
+                      "(directory_path, filename, size, mtime, inode) "
+                      "VALUES (:directory_path, :filename, :size, :mtime, :inode)");
+
+    for (auto it = directories.constBegin(); it != directories.constEnd(); ++it) {
+        const ScanIndexDirectory& directory = it.value();
+        directoryQuery.bindValue(":directory_path", it.key());
+        directoryQuery.bindValue(":size", directory.stamp().size());
+        directoryQuery.bindValue(":mtime", directory.stamp().mtimeNanos());
+        directoryQuery.bindValue(":inode",
+                static_cast<qint64>(directory.stamp().inode()));
+        directoryQuery.bindValue(":indexed_at", directory.indexedAtMillis());
+        directoryQuery.bindValue(":subdirectories",
+                directory.subdirectories.join(kSubdirectorySeparator));
+        if (!directoryQuery.exec()) {
+            LOG_FAILED_QUERY(directoryQuery) << "Saving directory to scan index failed.";
+            continue;
+        }
+
+        removeFilesQuery.bindValue(":directory_path", it.key());
+        if (!removeFilesQuery.exec()) {
+            LOG_FAILED_QUERY(removeFilesQuery);
+        }
+        for (const ScanIndexDirectory::File& file : directory.files) {
+            fileQuery.bindValue(":directory_path", it.key());
+            fileQuery.bindValue(":filename", file.name);
+            fileQuery.bindValue(":size", file.stamp.size());
+            fileQuery.bindValue(":mtime", file.stamp.mtimeNanos());
+            fileQuery.bindValue(":inode", static_cast<qint64>(file.stamp.inode()));
+            if (!fileQuery.exec()) {
+                LOG_FAILED_QUERY(fileQuery) << "Saving file to scan index failed.";
+            }
+        }
+    }
+}
+
+void ScanIndexDAO::removeDirectories(const QStringList& dirPaths) {
+    if (dirPaths.isEmpty()) {
+        return;
+    }
+    const QString dirPathList =
+            SqlStringFormatter::formatList(m_database, dirPaths);
+    QSqlQuery query(m_database);
+    query.prepare(QString("DELETE FROM scan_index_files "
+                          "WHERE directory_path IN (%1)").arg(dirPathList));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+    query.prepare(QString("DELETE FROM scan_index_directories "
+                          "WHERE directory_path IN (%1)").arg(dirPathList));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+}
+
+void ScanIndexDAO::removeAllDirectories() {
+    QSqlQuery query(m_database);
+    query.prepare("DELETE FROM scan_index_files");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+    query.prepare("DELETE FROM scan_index_directories");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef SCANINDEXDAO_H
+#define SCANINDEXDAO_H
+
+#include <QSqlDatabase>
+#include <QStringList>
+
+#include "library/dao/dao.h"
+#include "library/scanner/scanindex.h"
+
+// Stores the ScanIndex of the library scanner.
+class ScanIndexDAO : public DAO {
+  public:
+    ~ScanIndexDAO() override {}
+
+    void initialize(const QSqlDatabase& database) override {
+        m_database = database;
+    }
+
+    // Discards the index if it has been built for a different set of
+    // supported file extensions.
+    void validateSupportedExtensions(const QString& supportedExtensions);
+
+    ScanIndex getIndex();
+    QStringList getIndexedDirectories();
+    // Inserts or replaces the given directories and their files.
+    void saveDirectories(const ScanIndex& directories);
+    void removeDirectories(const QStringList& dirPaths);
+    void removeAllDirectories();
+
+  private:
+    QSqlDatabase m_database;
+};
+
+#endif // SCANINDEXDAO_H
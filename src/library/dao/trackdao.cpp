@@ -41,6 +41,73 @@ namespace {
 
 enum { UndefinedRecordIndex = -2 };
 
+const QStringList kTrackLocationInsertColumns = QStringList()
+        << "location" << "directory" << "filename" << "filesize"
+        << "fs_deleted" << "needs_verification";
+
+const QStringList kLibraryInsertColumns = QStringList()
+        << "artist" << "title" << "album" << "album_artist" << "year" << "genre"
+        << "tracknumber" << "tracktotal" << "composer" << "grouping" << "filetype"
+        << "location" << "comment" << "url" << "duration" << "rating" << "key"
+        << "key_id" << "bitrate" << "samplerate" << "cuepoint" << "bpm"
+        << "replaygain" << "replaygain_peak" << "wavesummaryhex" << "timesplayed"
+        << "channels" << "mixxx_deleted" << "header_parsed"
+        << "beats_version" << "beats_sub_version" << "beats" << "bpm_lock"
+        << "keys_version" << "keys_sub_version" << "keys"
+        << "coverart_source" << "coverart_type" << "coverart_location"
+        << "coverart_hash" << "datetime_added";
+
+// Older versions of SQLite accept at most 999 bound parameters per statement.
+const int kMaxBoundValuesPerStatement = 999;
+
+// Multi-row inserts use the column names with the row index as the suffix
+// of their placeholders, e.g. ":location_3".
+QString insertPlaceholders(const QStringList& columns, const QString& suffix) {
+    QStringList placeholders;
+    placeholders.reserve(columns.size());
+    for (const QString& column : columns) {
+        placeholders << (':' + column + suffix);
+    }
+    return placeholders.join(',');
+}
+
+QString trackLocationInsertPlaceholders(const QString& suffix = QString()) {
+    return insertPlaceholders(kTrackLocationInsertColumns, suffix);
+}
+
+QString libraryInsertPlaceholders(const QString& suffix = QString()) {
+    return insertPlaceholders(kLibraryInsertColumns, suffix);
+}
+
+QString multiRowInsertStatement(
+        const QString& table, const QStringList& columns, int rowCount) {
+    QStringList rows;
+    rows.reserve(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        rows << QString("(%1)").arg(
+                insertPlaceholders(columns, QString("_%1").arg(row)));
+    }
+    return QString("INSERT INTO %1 (%2) VALUES %3").arg(
+            table, columns.join(','), rows.join(','));
+}
+
+// Binds the values of a single row in a multi-row insert.
+class RowBinder {
+  public:
+    RowBinder(QSqlQuery* pQuery, int row)
+        : m_pQuery(pQuery),
+          m_suffix(QString("_%1").arg(row)) {
+    }
+
+    void bindValue(const QString& placeholder, const QVariant& value) {
+        m_pQuery->bindValue(placeholder + m_suffix, value);
+    }
+
+  private:
+    QSqlQuery* m_pQuery;
+    const QString m_suffix;
+};
+
 void markTrackLocationsAsDeleted(QSqlDatabase database, const QString& directory) {
     //qDebug() << "TrackDAO::markTrackLocationsAsDeleted" << QThread::currentThread() << m_database.connectionName();
     QSqlQuery query(database);
@@ -316,35 +383,13 @@ void TrackDAO::addTracksPrepare() {
     m_pQueryLibraryUpdate = std::make_unique<QSqlQuery>(m_database);
     m_pQueryLibrarySelect = std::make_unique<QSqlQuery>(m_database);
 
-    m_pQueryTrackLocationInsert->prepare("INSERT INTO track_locations "
-            "("
-            "location,directory,filename,filesize,fs_deleted,needs_verification"
-            ") VALUES ("
-            ":location,:directory,:filename,:filesize,:fs_deleted,:needs_verification"
-            ")");
+    m_pQueryTrackLocationInsert->prepare(QString("INSERT INTO track_locations (%1) VALUES (%2)")
+            .arg(kTrackLocationInsertColumns.join(','), trackLocationInsertPlaceholders()));
 
     m_pQueryTrackLocationSelect->prepare("SELECT id FROM track_locations WHERE location=:location");
 
-    m_pQueryLibraryInsert->prepare("INSERT INTO library "
-            "("
-            "artist,title,album,album_artist,year,genre,tracknumber,tracktotal,composer,"
-            "grouping,filetype,location,comment,url,duration,rating,key,key_id,"
-            "bitrate,samplerate,cuepoint,bpm,replaygain,replaygain_peak,wavesummaryhex,"
-            "timesplayed,channels,mixxx_deleted,header_parsed,"
-            "beats_version,beats_sub_version,beats,bpm_lock,"
-            "keys_version,keys_sub_version,keys,"
-            "coverart_source,coverart_type,coverart_location,coverart_hash,"
-            "datetime_added"
-            ") VALUES ("
-            ":artist,:title,:album,:album_artist,:year,:genre,:tracknumber,:tracktotal,:composer,"
-            ":grouping,:filetype,:location,:comment,:url,:duration,:rating,:key,:key_id,"
-            ":bitrate,:samplerate,:cuepoint,:bpm,:replaygain,:replaygain_peak,:wavesummaryhex,"
-            ":timesplayed,:channels,:mixxx_deleted,:header_parsed,"
-            ":beats_version,:beats_sub_version,:beats,:bpm_lock,"
-            ":keys_version,:keys_sub_version,:keys,"
-            ":coverart_source,:coverart_type,:coverart_location,:coverart_hash,"
-            ":datetime_added"
-            ")");
+    m_pQueryLibraryInsert->prepare(QString("INSERT INTO library (%1) VALUES (%2)")
+            .arg(kLibraryInsertColumns.join(','), libraryInsertPlaceholders()));
 
     m_pQueryLibraryUpdate->prepare("UPDATE library SET mixxx_deleted = 0 "
             "WHERE id=:id");
@@ -373,14 +418,19 @@ void TrackDAO::addTracksFinish(bool rollback) {
 }
 
 namespace {
-    bool insertTrackLocation(QSqlQuery* pTrackLocationInsert, const Track& track) {
-        DEBUG_ASSERT(nullptr != pTrackLocationInsert);
+    template<typename Query>
+    void bindTrackLocationValues(Query* pTrackLocationInsert, const Track& track) {
         pTrackLocationInsert->bindValue(":location", track.getLocation());
         pTrackLocationInsert->bindValue(":directory", track.getDirectory());
         pTrackLocationInsert->bindValue(":filename", track.getFileName());
         pTrackLocationInsert->bindValue(":filesize", track.getFileSize());
         pTrackLocationInsert->bindValue(":fs_deleted", 0);
         pTrackLocationInsert->bindValue(":needs_verification", 0);
+    }
+
+    bool insertTrackLocation(QSqlQuery* pTrackLocationInsert, const Track& track) {
+        DEBUG_ASSERT(nullptr != pTrackLocationInsert);
+        bindTrackLocationValues(pTrackLocationInsert, track);
         if (pTrackLocationInsert->exec()) {
             return true;
         } else {
@@ -391,7 +441,8 @@ namespace {
     }
 
     // Bind common values for insert/update
-    void bindTrackLibraryValues(QSqlQuery* pTrackLibraryQuery, const Track& track) {
+    template<typename Query>
+    void bindTrackLibraryValues(Query* pTrackLibraryQuery, const Track& track) {
         pTrackLibraryQuery->bindValue(":artist", track.getArtist());
         pTrackLibraryQuery->bindValue(":title", track.getTitle());
         pTrackLibraryQuery->bindValue(":album", track.getAlbum());
@@ -464,7 +515,8 @@ namespace {
         pTrackLibraryQuery->bindValue(":key_id", static_cast<int>(key));
     }
 
-    bool insertTrackLibrary(QSqlQuery* pTrackLibraryInsert, const Track& track, DbId trackLocationId, QDateTime trackDateAdded) {
+    template<typename Query>
+    void bindTrackLibraryInsertValues(Query* pTrackLibraryInsert, const Track& track, DbId trackLocationId, QDateTime trackDateAdded) {
         bindTrackLibraryValues(pTrackLibraryInsert, track);
 
         DEBUG_ASSERT(track.getDateAdded().isNull());
@@ -480,7 +532,10 @@ namespace {
 
         // We no longer store the wavesummary in the library table.
         pTrackLibraryInsert->bindValue(":wavesummaryhex", QVariant(QVariant::ByteArray));
+    }
 
+    bool insertTrackLibrary(QSqlQuery* pTrackLibraryInsert, const Track& track, DbId trackLocationId, QDateTime trackDateAdded) {
+        bindTrackLibraryInsertValues(pTrackLibraryInsert, track, trackLocationId, trackDateAdded);
         if (pTrackLibraryInsert->exec()) {
             return true;
         } else {
@@ -492,6 +547,20 @@ namespace {
             return false;
         }
     }
+
+    // Transfers the metadata that has been imported into a temporary track
+    // object to the track object that is stored in the library.
+    void updateTrackFromImportedTrack(Track* pTrack, const Track& importedTrack) {
+        mixxx::TrackMetadata trackMetadata;
+        bool metadataSynchronized = false;
+        importedTrack.getTrackMetadata(&trackMetadata, &metadataSynchronized);
+        pTrack->setType(importedTrack.getType());
+        // Only the flag is stored and not the actual time stamp
+        pTrack->setTrackMetadata(
+                std::move(trackMetadata),
+                metadataSynchronized ? QDateTime::currentDateTimeUtc() : QDateTime());
+        pTrack->setCoverInfo(importedTrack.getCoverInfo());
+    }
 } // anonymous namespace
 
 TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
@@ -675,6 +744,258 @@ TrackPointer TrackDAO::addTracksAddFile(const QFileInfo& fileInfo, bool unremove
     return pTrack;
 }
 
+QHash<QString, DbId> TrackDAO::getTrackLocationIds(const QStringList& locations) {
+    QHash<QString, DbId> trackLocationIds;
+    QSqlQuery query(m_database);
+    query.prepare(QString("SELECT id, location FROM track_locations "
+                          "WHERE location IN (%1)").arg(
+                                  SqlStringFormatter::formatList(m_database, locations)));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return trackLocationIds;
+    }
+    while (query.next()) {
+        trackLocationIds.insert(query.value(1).toString(), DbId(query.value(0)));
+    }
+    return trackLocationIds;
+}
+
+TrackPointer TrackDAO::addTracksAddImportedTrack(
+        const Track& importedTrack, bool unremove) {
+    GlobalTrackCacheResolver cacheResolver(importedTrack.getFileInfo());
+    const TrackPointer pTrack = cacheResolver.getTrack();
+    if (!pTrack) {
+        qWarning() << "TrackDAO::addTracksAddImportedTrack:"
+                << "File not found"
+                << importedTrack.getLocation();
+        return TrackPointer();
+    }
+    if (pTrack->getId().isValid()) {
+        // Already added to the database
+        return TrackPointer();
+    }
+    if (cacheResolver.getLookupResult() == GlobalTrackCacheLookupResult::MISS) {
+        updateTrackFromImportedTrack(pTrack.get(), importedTrack);
+    } else {
+        // The track object existed before and might have been
+        // modified in the meantime.
+        SoundSourceProxy(pTrack).updateTrackFromSource();
+    }
+    const TrackId trackId = addTracksAddTrack(pTrack, unremove);
+    if (!trackId.isValid()) {
+        qWarning() << "TrackDAO::addTracksAddImportedTrack:"
+                << "Failed to add track to database"
+                << pTrack->getLocation();
+        // GlobalTrackCache will be unlocked implicitly
+        return TrackPointer();
+    }
+    cacheResolver.initTrackIdAndUnlockCache(trackId);
+    DEBUG_ASSERT(pTrack->getId() == trackId);
+    // Only newly inserted tracks must be marked as clean!
+    if (m_tracksAddedSet.contains(trackId)) {
+        pTrack->markClean();
+    }
+    return pTrack;
+}
+
+QList<TrackPointer> TrackDAO::addTracksAddImportedTracks(
+        const QList<TrackPointer>& importedTracks, bool unremove) {
+    QList<TrackPointer> addedTracks;
+    VERIFY_OR_DEBUG_ASSERT(m_pQueryLibraryInsert && m_pTransaction) {
+        qDebug() << "TrackDAO::addTracksAddImportedTracks: needed SqlQuerys have not "
+                "been prepared. Skipping" << importedTracks.size() << "tracks";
+        return addedTracks;
+    }
+
+    // The GlobalTrackCache is only locked for one track at a time and never
+    // while the rows are inserted, since every lookup of a track in the GUI
+    // and the engine has to wait for it. Tracks that are cached already are
+    // added one by one from the cached object, like in addTracksAddFile().
+    QList<TrackPointer> uncachedTracks;
+    QStringList locations;
+    for (const TrackPointer& pImportedTrack : importedTracks) {
+        const QFileInfo fileInfo = pImportedTrack->getFileInfo();
+        if (!SoundSourceProxy::isFileSupported(fileInfo)) {
+            qWarning() << "TrackDAO::addTracksAddImportedTracks:"
+                    << "Unsupported file type"
+                    << TrackRef::location(fileInfo);
+            continue;
+        }
+        const QString location = pImportedTrack->getLocation();
+        if (locations.contains(location)) {
+            continue;
+        }
+        locations.append(location);
+        bool cached;
+        {
+            GlobalTrackCacheLocker cacheLocker;
+            cached = static_cast<bool>(cacheLocker.lookupTrackByRef(
+                    TrackRef::fromFileInfo(fileInfo)));
+        }
+        if (cached) {
+            const TrackPointer pTrack =
+                    addTracksAddImportedTrack(*pImportedTrack, unremove);
+            if (pTrack) {
+                addedTracks.append(pTrack);
+            }
+        } else {
+            uncachedTracks.append(pImportedTrack);
+        }
+    }
+
+    // Existing track locations are reused one by one like in
+    // addTracksAddTrack().
+    QStringList uncachedLocations;
+    for (const TrackPointer& pImportedTrack : uncachedTracks) {
+        uncachedLocations.append(pImportedTrack->getLocation());
+    }
+    const QHash<QString, DbId> existingTrackLocationIds =
+            getTrackLocationIds(uncachedLocations);
+    QList<TrackPointer> newTracks;
+    for (const TrackPointer& pImportedTrack : uncachedTracks) {
+        if (existingTrackLocationIds.contains(pImportedTrack->getLocation())) {
+            const TrackPointer pTrack =
+                    addTracksAddImportedTrack(*pImportedTrack, unremove);
+            if (pTrack) {
+                addedTracks.append(pTrack);
+            }
+        } else {
+            newTracks.append(pImportedTrack);
+        }
+    }
+    if (newTracks.isEmpty()) {
+        return addedTracks;
+    }
+
+    qDebug() << "TrackDAO: Adding" << newTracks.size() << "tracks";
+
+    // The rows are inserted from the imported tracks, the corresponding
+    // cached tracks are only resolved once their ids are known.
+    const int trackLocationRowsPerStatement =
+            kMaxBoundValuesPerStatement / kTrackLocationInsertColumns.size();
+    QStringList newLocations;
+    for (int first = 0; first < newTracks.size();
+            first += trackLocationRowsPerStatement) {
+        const int rowCount = math_min(
+                trackLocationRowsPerStatement, newTracks.size() - first);
+        QSqlQuery query(m_database);
+        query.prepare(multiRowInsertStatement(
+                "track_locations", kTrackLocationInsertColumns, rowCount));
+        for (int row = 0; row < rowCount; ++row) {
+            const Track& track = *newTracks[first + row];
+            RowBinder rowBinder(&query, row);
+            bindTrackLocationValues(&rowBinder, track);
+            newLocations.append(track.getLocation());
+        }
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query)
+                    << "Failed to insert" << rowCount << "track locations";
+        }
+    }
+    const QHash<QString, DbId> trackLocationIds =
+            getTrackLocationIds(newLocations);
+
+    // Time stamps are stored with timezone UTC in the database
+    const auto trackDateAdded = QDateTime::currentDateTimeUtc();
+    const int libraryRowsPerStatement =
+            kMaxBoundValuesPerStatement / kLibraryInsertColumns.size();
+    QList<TrackPointer> insertedTracks;
+    for (const TrackPointer& pImportedTrack : newTracks) {
+        if (trackLocationIds.contains(pImportedTrack->getLocation())) {
+            insertedTracks.append(pImportedTrack);
+        } else {
+            qWarning() << "TrackDAO::addTracksAddImportedTracks:"
+                    << "Failed to add track to database"
+                    << pImportedTrack->getLocation();
+        }
+    }
+    QStringList trackLocationIdList;
+    for (int first = 0; first < insertedTracks.size();
+            first += libraryRowsPerStatement) {
+        const int rowCount = math_min(
+                libraryRowsPerStatement, insertedTracks.size() - first);
+        QSqlQuery query(m_database);
+        query.prepare(multiRowInsertStatement(
+                "library", kLibraryInsertColumns, rowCount));
+        for (int row = 0; row < rowCount; ++row) {
+            const Track& track = *insertedTracks[first + row];
+            const DbId trackLocationId = trackLocationIds.value(track.getLocation());
+            RowBinder rowBinder(&query, row);
+            bindTrackLibraryInsertValues(&rowBinder, track, trackLocationId, trackDateAdded);
+            trackLocationIdList.append(trackLocationId.toString());
+        }
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query)
+                    << "Failed to insert" << rowCount << "new tracks into library";
+        }
+    }
+
+    QHash<DbId, TrackId> trackIds;
+    QSqlQuery query(m_database);
+    query.prepare(QString("SELECT id, location FROM library "
+                          "WHERE location IN (%1)").arg(trackLocationIdList.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+    while (query.next()) {
+        trackIds.insert(DbId(query.value(1)), TrackId(query.value(0)));
+    }
+
+    for (const TrackPointer& pImportedTrack : insertedTracks) {
+        const TrackId trackId = trackIds.value(
+                trackLocationIds.value(pImportedTrack->getLocation()));
+        if (!trackId.isValid()) {
+            qWarning() << "TrackDAO::addTracksAddImportedTracks:"
+                    << "Failed to add track to database"
+                    << pImportedTrack->getLocation();
+            continue;
+        }
+        DEBUG_ASSERT(!m_tracksAddedSet.contains(trackId));
+        m_tracksAddedSet.insert(trackId);
+
+        GlobalTrackCacheResolver cacheResolver(pImportedTrack->getFileInfo());
+        const TrackPointer pTrack = cacheResolver.getTrack();
+        if (!pTrack) {
+            // The file has been deleted in the meantime, the next scan
+            // will mark the track as missing.
+            qWarning() << "TrackDAO::addTracksAddImportedTracks:"
+                    << "File not found"
+                    << pImportedTrack->getLocation();
+            continue;
+        }
+        VERIFY_OR_DEBUG_ASSERT(!pTrack->getId().isValid()) {
+            continue;
+        }
+        // The track might have been cached since it has been checked above,
+        // the cached object has precedence over the imported metadata.
+        const bool cachedMeanwhile =
+                cacheResolver.getLookupResult() != GlobalTrackCacheLookupResult::MISS;
+        if (cachedMeanwhile) {
+            SoundSourceProxy(pTrack).updateTrackFromSource();
+        } else {
+            updateTrackFromImportedTrack(pTrack.get(), *pImportedTrack);
+        }
+        pTrack->setDateAdded(trackDateAdded);
+        cacheResolver.initTrackIdAndUnlockCache(trackId);
+        DEBUG_ASSERT(pTrack->getId() == trackId);
+        if (cachedMeanwhile) {
+            // The inserted row still contains the imported metadata
+            pTrack->markDirty();
+        } else {
+            pTrack->markClean();
+        }
+        m_analysisDao.saveTrackAnalyses(
+                trackId,
+                pTrack->getWaveform(),
+                pTrack->getWaveformSummary());
+        m_cueDao.saveTrackCues(
+                trackId,
+                pTrack->getCuePoints());
+        addedTracks.append(pTrack);
+    }
+    return addedTracks;
+}
+
 TrackPointer TrackDAO::addSingleTrack(const QFileInfo& fileInfo, bool unremove) {
     addTracksPrepare();
     TrackPointer pTrack = addTracksAddFile(fileInfo, unremove);
@@ -1362,8 +1683,9 @@ TrackPointer TrackDAO::getTrackFromDB(TrackId trackId) const {
 TrackPointer TrackDAO::getTrack(TrackId trackId) const {
     //qDebug() << "TrackDAO::getTrack" << QThread::currentThread() << m_database.connectionName();
 
-    // The GlobalTrackCache is only locked while executing the following line.
-    TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+    // Only the shard of the GlobalTrackCache that contains the id is
+    // locked while executing the following line.
+    TrackPointer pTrack = GlobalTrackCache::lookupTrackById(trackId);
     // Accessing the database is a time consuming operation that should
     // not be executed with a lock on the GlobalTrackCache. The GlobalTrackCache will
     // be locked again after the query has been executed and potential
@@ -1503,6 +1825,23 @@ void TrackDAO::markTracksInDirectoriesAsVerified(const QStringList& directories)
     }
 }
 
+void TrackDAO::markTracksForMetadataReimport(const QStringList& locations) {
+    if (locations.isEmpty()) {
+        return;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(
+        QString("UPDATE library SET header_parsed=0 "
+                "WHERE location IN "
+                "(SELECT id FROM track_locations WHERE location IN (%1))").arg(
+                        SqlStringFormatter::formatList(m_database, locations)));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "Couldn't mark" << locations.size() << "tracks for metadata reimport.";
+    }
+}
+
 void TrackDAO::markUnverifiedTracksAsDeleted() {
     //qDebug() << "TrackDAO::markUnverifiedTracksAsDeleted" << QThread::currentThread() << m_database.connectionName();
     QSqlQuery query(m_database);
@@ -2,6 +2,7 @@
 #define TRACKDAO_H
 
 #include <QFileInfo>
+#include <QHash>
 #include <QObject>
 #include <QSet>
 #include <QList>
@@ -56,6 +57,12 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void addTracksPrepare();
     TrackPointer addTracksAddFile(const QFileInfo& fileInfo, bool unremove);
     TrackId addTracksAddTrack(const TrackPointer& pTrack, bool unremove);
+    // Adds tracks whose metadata has already been imported from their files
+    // into temporary track objects, e.g. concurrently by the library scanner.
+    // New tracks are inserted with multi-row statements. Tracks that could
+    // not be added are omitted from the returned list.
+    QList<TrackPointer> addTracksAddImportedTracks(
+            const QList<TrackPointer>& importedTracks, bool unremove);
     void addTracksFinish(bool rollback = false);
 
     bool onHidingTracks(
@@ -88,6 +95,8 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     // Scanning related calls. Should be elsewhere or private somehow.
     void markTrackLocationsAsVerified(const QStringList& locations);
     void markTracksInDirectoriesAsVerified(const QStringList& directories);
+    // The metadata of these tracks is imported again when they are loaded.
+    void markTracksForMetadataReimport(const QStringList& locations);
     void invalidateTrackLocationsInLibrary();
     void markUnverifiedTracksAsDeleted();
     bool detectMovedTracks(QSet<TrackId>* pTracksMovedSetOld,
@@ -126,6 +135,12 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void slotTrackClean(Track* pTrack);
 
   private:
+    QHash<QString, DbId> getTrackLocationIds(const QStringList& locations);
+    // Adds a single imported track after resolving it in the
+    // GlobalTrackCache, like addTracksAddFile() without parsing the file.
+    TrackPointer addTracksAddImportedTrack(
+            const Track& importedTrack, bool unremove);
+
     TrackPointer getTrackFromDB(TrackId trackId) const;
 
     bool updateTrack(Track* pTrack);
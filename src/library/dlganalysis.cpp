@@ -16,7 +16,8 @@ DlgAnalysis::DlgAnalysis(QWidget* parent,
         : QWidget(parent),
           m_pConfig(pConfig),
           m_pTrackCollection(&pLibrary->trackCollection()),
-          m_bAnalysisActive(false) {
+          m_bAnalysisActive(false),
+          m_tracksPerMinute(0.0) {
     setupUi(this);
     m_songsButtonGroup.addButton(radioButtonRecentlyAdded);
     m_songsButtonGroup.addButton(radioButtonAllSongs);
@@ -153,6 +154,7 @@ void DlgAnalysis::slotAnalysisActive(bool bActive) {
         pushButtonAnalyze->setText(tr("Analyze"));
         labelProgress->setText("");
         labelProgress->setEnabled(false);
+        m_tracksPerMinute = 0.0;
     }
 }
 
@@ -174,10 +176,18 @@ void DlgAnalysis::onTrackAnalysisSchedulerProgress(
                     QString::number(finishedCount),
                     QString::number(totalCount));
         }
+        if (m_tracksPerMinute > 0.0) {
+            progressText += " " + tr("(%1 tracks/min)").arg(
+                    QString::number(m_tracksPerMinute, 'f', 1));
+        }
         labelProgress->setText(progressText);
     }
 }
 
+void DlgAnalysis::onTrackAnalysisSchedulerThroughput(double tracksPerMinute) {
+    m_tracksPerMinute = tracksPerMinute;
+}
+
 void DlgAnalysis::showRecentSongs() {
     m_pAnalysisLibraryTableModel->showRecentSongs();
 }
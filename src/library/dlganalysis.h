@@ -43,6 +43,7 @@ class DlgAnalysis : public QWidget, public Ui::DlgAnalysis, public virtual Libra
     void analyze();
     void slotAnalysisActive(bool bActive);
     void onTrackAnalysisSchedulerProgress(AnalyzerProgress analyzerProgress, int finishedCount, int totalCount);
+    void onTrackAnalysisSchedulerThroughput(double tracksPerMinute);
     void showRecentSongs();
     void showAllSongs();
     void installEventFilter(QObject* pFilter);
@@ -59,6 +60,7 @@ class DlgAnalysis : public QWidget, public Ui::DlgAnalysis, public virtual Libra
     UserSettingsPointer m_pConfig;
     TrackCollection* m_pTrackCollection;
     bool m_bAnalysisActive;
+    double m_tracksPerMinute;
     QButtonGroup m_songsButtonGroup;
     WAnalysisLibraryTableView* m_pAnalysisLibraryTableView;
     AnalysisLibraryTableModel* m_pAnalysisLibraryTableModel;
@@ -1,6 +1,8 @@
 #include "library/scanner/importfilestask.h"
 
 #include "library/scanner/libraryscanner.h"
+#include "sources/soundsourceproxy.h"
+#include "track/globaltrackcache.h"
 #include "track/trackref.h"
 #include "util/timer.h"
 
@@ -21,6 +23,17 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
           m_pToken(pToken) {
 }
 
+namespace {
+
+// Metadata is only exported into files of cached tracks.
+bool isTrackCached(const QFileInfo& fileInfo) {
+    GlobalTrackCacheLocker cacheLocker;
+    return static_cast<bool>(
+            cacheLocker.lookupTrackByRef(TrackRef::fromFileInfo(fileInfo)));
+}
+
+} // anonymous namespace
+
 void ImportFilesTask::run() {
     ScopedTimer timer("ImportFilesTask::run");
     for (const QFileInfo& fileInfo: m_filesToImport) {
@@ -50,7 +63,17 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit(addNewTrack(trackLocation));
+            if (isTrackCached(fileInfo)) {
+                // The file might be written while parsing it, leave it
+                // to the library scanner thread. This is only a shortcut,
+                // the track might still be cached before it is added.
+                // TrackDAO checks again while resolving it.
+                emit(addNewTrack(trackLocation));
+                continue;
+            }
+            TrackPointer pImportedTrack = Track::newTemporary(fileInfo, m_pToken);
+            SoundSourceProxy(pImportedTrack).updateTrackFromSource();
+            emit(addNewImportedTrack(pImportedTrack));
         }
     }
     // Insert or update the hash in the database.
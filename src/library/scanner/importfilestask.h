@@ -10,6 +10,10 @@
 
 // Import the provided files. Successful if the scan completed without being
 // cancelled. False if the scan was cancelled part-way through.
+//
+// The metadata of new files is parsed by the task itself, i.e. concurrently
+// for multiple directories. Only the results are passed on to the library
+// scanner thread that adds them to the database in batches.
 class ImportFilesTask : public ScannerTask {
     Q_OBJECT
   public:
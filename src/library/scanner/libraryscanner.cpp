@@ -3,11 +3,13 @@
 #include "sources/soundsourceproxy.h"
 #include "library/scanner/recursivescandirectorytask.h"
 #include "library/scanner/libraryscannerdlg.h"
+#include "library/scanner/librarywatcher.h"
 #include "library/scanner/scannertask.h"
 #include "library/queryutil.h"
 #include "library/coverartutils.h"
 #include "library/trackcollection.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/trace.h"
 #include "util/file.h"
 #include "util/timer.h"
@@ -17,8 +19,12 @@
 
 namespace {
 
-// TODO(rryan) make configurable
-const int kScannerThreadPoolSize = 1;
+// Tags are parsed concurrently by the worker threads. More threads than
+// this only increase the seeks on rotational disks.
+const int kMaxScannerThreadPoolSize = 4;
+
+// The number of imported tracks that are added to the database at once.
+const int kAddTracksBatchSize = 64;
 
 mixxx::Logger kLogger("LibraryScanner");
 
@@ -32,10 +38,12 @@ LibraryScanner::LibraryScanner(
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
           m_pTrackCollection(pTrackCollection),
+          m_pConfig(pConfig),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
                   m_analysisDao, m_libraryHashDao,
                   pConfig),
+          m_bRescanRequested(false),
           m_stateSema(1), // only one transaction is possible at a time
           m_state(IDLE) {
     // Move LibraryScanner to its own thread so that our signals/slots will
@@ -47,7 +55,8 @@ LibraryScanner::LibraryScanner(
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    m_pool.setMaxThreadCount(math_clamp(
+            QThread::idealThreadCount(), 1, kMaxScannerThreadPoolSize));
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -68,7 +77,7 @@ LibraryScanner::LibraryScanner(
 
     m_pProgressDlg.reset(new LibraryScannerDlg());
     connect(this, SIGNAL(progressLoading(QString)),
-            m_pProgressDlg.data(), SLOT(slotUpdate(QString)));
+            m_pProgressDlg.data(), SLOT(slotTrackAdded(QString)));
     connect(this, SIGNAL(progressHashing(QString)),
             m_pProgressDlg.data(), SLOT(slotUpdate(QString)));
     connect(this, SIGNAL(scanStarted()),
@@ -109,11 +118,23 @@ void LibraryScanner::run() {
         m_playlistDao.initialize(dbConnection);
         m_analysisDao.initialize(dbConnection);
         m_directoryDao.initialize(dbConnection);
+        m_scanIndexDao.initialize(dbConnection);
+
+        // The watcher only reports changes of indexed directories
+        if (m_pConfig->getValue<bool>(ConfigKey("[Library]", "IncrementalScan"), true) &&
+                m_pConfig->getValue<bool>(ConfigKey("[Library]", "WatchDirectories"), false)) {
+            m_pWatcher = std::make_unique<LibraryWatcher>();
+            connect(m_pWatcher.get(), SIGNAL(directoriesChanged(QStringList)),
+                    this, SLOT(slotDirectoriesChanged(QStringList)));
+            m_pWatcher->watchDirectories(m_scanIndexDao.getIndexedDirectories());
+        }
 
         // Start the event loop.
         kLogger.debug() << "Event loop starting";
         exec();
         kLogger.debug() << "Event loop stopped";
+
+        m_pWatcher.reset();
     }
     kLogger.debug() << "Exiting thread";
 }
@@ -122,6 +143,11 @@ void LibraryScanner::slotStartScan() {
     kLogger.debug() << "slotStartScan()";
     DEBUG_ASSERT(m_state == STARTING);
 
+    QSet<QString> changedDirectories;
+    changedDirectories.swap(m_changedDirectories);
+    m_bRescanRequested = false;
+    m_importedTracks.clear();
+
     // Recursively scan each directory in the directories table.
     m_libraryRootDirs = m_directoryDao.getDirs();
     // If there are no directories then we have nothing to do. Cleanup and
@@ -140,9 +166,18 @@ void LibraryScanner::slotStartScan() {
                     Qt::CaseInsensitive);
     QStringList directoryBlacklist = ScannerUtil::getDirectoryBlacklist();
 
+    const bool scanIndexEnabled = m_pConfig->getValue<bool>(
+            ConfigKey("[Library]", "IncrementalScan"), true);
+    ScanIndex scanIndex;
+    if (scanIndexEnabled) {
+        m_scanIndexDao.validateSupportedExtensions(extensionFilter.pattern());
+        scanIndex = m_scanIndexDao.getIndex();
+    }
+
     m_scannerGlobal = ScannerGlobalPointer(
             new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+                              coverExtensionFilter, directoryBlacklist,
+                              scanIndexEnabled, scanIndex, changedDirectories));
 
     m_scannerGlobal->startTimer();
 
@@ -253,6 +288,13 @@ void LibraryScanner::cleanUpScan() {
     m_trackDao.markTracksInDirectoriesAsVerified(
             m_scannerGlobal->verifiedDirectories());
 
+    kLogger.debug() << "Marking modified tracks for metadata reimport";
+    m_trackDao.markTracksForMetadataReimport(
+            m_scannerGlobal->modifiedTracks());
+
+    kLogger.debug() << "Updating the scan index";
+    updateScanIndex();
+
     // After verifying tracks and directories via recursive scanning of the
     // library directories the only unverified tracks will be files that are
     // outside of the library directories, files that have been
@@ -303,6 +345,36 @@ void LibraryScanner::cleanUpScan() {
     emit(tracksChanged(coverArtTracksChanged));
 }
 
+void LibraryScanner::updateScanIndex() {
+    if (!m_scannerGlobal->scanIndexEnabled()) {
+        return;
+    }
+    const ScanIndex& scanIndex = m_scannerGlobal->scanIndex();
+    const ScanIndex& updatedScanIndex = m_scannerGlobal->updatedScanIndex();
+    const QSet<QString> verifiedDirectories =
+            m_scannerGlobal->verifiedDirectories().toSet();
+
+    // Entries of directories that have not been visited belong to
+    // directories that have been removed or blacklisted.
+    QStringList indexedDirectories = updatedScanIndex.keys();
+    QStringList removedDirectories;
+    for (auto it = scanIndex.constBegin(); it != scanIndex.constEnd(); ++it) {
+        if (updatedScanIndex.contains(it.key())) {
+            continue;
+        }
+        if (verifiedDirectories.contains(it.key())) {
+            indexedDirectories << it.key();
+        } else {
+            removedDirectories << it.key();
+        }
+    }
+    m_scanIndexDao.removeDirectories(removedDirectories);
+    m_scanIndexDao.saveDirectories(updatedScanIndex);
+
+    if (m_pWatcher) {
+        m_pWatcher->watchDirectories(indexedDirectories);
+    }
+}
 
 // is called when all tasks of the second stage are done (threads are finished)
 void LibraryScanner::slotFinishUnhashedScan() {
@@ -320,6 +392,11 @@ void LibraryScanner::slotFinishUnhashedScan() {
         kLogger.debug() << "Recursive scanning interrupted by the user";
     }
 
+    if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
+        addImportedTracks();
+    }
+    m_importedTracks.clear();
+
     // Finish adding the tracks -- rollback the transaction if the scan did not
     // finish cleanly and the user did not cancel the transaction.
     m_trackDao.addTracksFinish(!m_scannerGlobal->shouldCancel() &&
@@ -340,18 +417,28 @@ void LibraryScanner::slotFinishUnhashedScan() {
            "%d unchanged directories. "
            "%d changed/added directories. "
            "%d tracks verified from changed/added directories. "
-           "%d new tracks.",
+           "%d new tracks. "
+           "%d modified tracks.",
            m_scannerGlobal->timerElapsed().formatNanosWithUnit().toLocal8Bit().constData(),
            m_scannerGlobal->verifiedDirectories().size(),
            m_scannerGlobal->numScannedDirectories(),
            m_scannerGlobal->verifiedTracks().size(),
-           m_scannerGlobal->addedTracks().size());
+           m_scannerGlobal->addedTracks().size(),
+           m_scannerGlobal->modifiedTracks().size());
+
+    const bool rescan = m_bRescanRequested &&
+            !m_scannerGlobal->shouldCancel() && bScanFinishedCleanly;
 
     m_scannerGlobal.clear();
     changeScannerState(FINISHED);
     // now we may accept new scan commands
 
     emit(scanFinished());
+
+    if (rescan) {
+        // The watcher has reported changes while scanning
+        QMetaObject::invokeMethod(this, "scan", Qt::QueuedConnection);
+    }
 }
 
 void LibraryScanner::scan() {
@@ -417,6 +504,8 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this, SLOT(slotTrackExists(QString)));
     connect(pTask, SIGNAL(addNewTrack(QString)),
             this, SLOT(slotAddNewTrack(QString)));
+    connect(pTask, SIGNAL(addNewImportedTrack(TrackPointer)),
+            this, SLOT(slotAddNewImportedTrack(TrackPointer)));
 
     // Progress signals.
     // Pass directly to the main thread
@@ -495,6 +584,58 @@ void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
     }
 }
 
+void LibraryScanner::slotDirectoriesChanged(const QStringList& dirPaths) {
+    kLogger.debug() << "slotDirectoriesChanged" << dirPaths.size();
+    for (const QString& dirPath : dirPaths) {
+        m_changedDirectories.insert(dirPath);
+    }
+    // Scanning is deferred until the current scan has finished
+    m_bRescanRequested = true;
+    scan();
+}
+
+void LibraryScanner::slotAddNewImportedTrack(TrackPointer pImportedTrack) {
+    //kLogger.debug() << "slotAddNewImportedTrack" << pImportedTrack->getLocation();
+    if (!m_scannerGlobal || m_scannerGlobal->shouldCancel()) {
+        return;
+    }
+    m_importedTracks.append(pImportedTrack);
+    if (m_importedTracks.size() >= kAddTracksBatchSize) {
+        addImportedTracks();
+    }
+}
+
+void LibraryScanner::addImportedTracks() {
+    if (m_importedTracks.isEmpty()) {
+        return;
+    }
+    ScopedTimer timer("LibraryScanner::addImportedTracks");
+    const QList<TrackPointer> addedTracks =
+            m_trackDao.addTracksAddImportedTracks(m_importedTracks, false);
+    QSet<QString> addedTrackLocations;
+    for (const TrackPointer& pTrack : addedTracks) {
+        const QString trackLocation(pTrack->getLocation());
+        addedTrackLocations.insert(trackLocation);
+        // Acknowledge successful track addition
+        m_scannerGlobal->trackAdded(trackLocation);
+        // Signal the main instance of TrackDAO, that there is
+        // a new track in the database.
+        emit(trackAdded(pTrack));
+        emit(progressLoading(trackLocation));
+    }
+    for (const TrackPointer& pImportedTrack : m_importedTracks) {
+        const QString trackLocation(pImportedTrack->getLocation());
+        if (!addedTrackLocations.contains(trackLocation)) {
+            // Acknowledge failed track addition like slotAddNewTrack()
+            m_scannerGlobal->trackAdded(trackLocation);
+            kLogger.warning()
+                    << "Failed to add track to library:"
+                    << trackLocation;
+        }
+    }
+    m_importedTracks.clear();
+}
+
 bool LibraryScanner::changeScannerState(ScannerState newState) {
     switch (newState) {
     case IDLE:
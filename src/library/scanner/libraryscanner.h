@@ -7,6 +7,7 @@
 #include <QStringList>
 #include <QSemaphore>
 #include <QScopedPointer>
+#include <QSet>
 
 #include "library/dao/cuedao.h"
 #include "library/dao/libraryhashdao.h"
@@ -14,14 +15,17 @@
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackdao.h"
 #include "library/dao/analysisdao.h"
+#include "library/dao/scanindexdao.h"
 #include "library/scanner/scannerglobal.h"
 #include "track/track.h"
 #include "util/db/dbconnectionpool.h"
+#include "util/memory.h"
 
 #include <gtest/gtest.h>
 
 class ScannerTask;
 class LibraryScannerDlg;
+class LibraryWatcher;
 class TrackCollection;
 
 class LibraryScanner : public QThread {
@@ -73,6 +77,10 @@ class LibraryScanner : public QThread {
     void slotDirectoryUnchanged(const QString& directoryPath);
     void slotTrackExists(const QString& trackPath);
     void slotAddNewTrack(const QString& trackPath);
+    void slotAddNewImportedTrack(TrackPointer pImportedTrack);
+
+    // LibraryWatcher signal handler.
+    void slotDirectoriesChanged(const QStringList& dirPaths);
 
   private:
     enum ScannerState {
@@ -97,6 +105,9 @@ class LibraryScanner : public QThread {
     bool changeScannerState(LibraryScanner::ScannerState newState);
 
     void cleanUpScan();
+    // Adds the pending imported tracks to the database.
+    void addImportedTracks();
+    void updateScanIndex();
 
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
 
@@ -104,6 +115,8 @@ class LibraryScanner : public QThread {
     // thread.
     TrackCollection* m_pTrackCollection;
 
+    UserSettingsPointer m_pConfig;
+
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
 
@@ -114,6 +127,18 @@ class LibraryScanner : public QThread {
     DirectoryDAO m_directoryDao;
     AnalysisDao m_analysisDao;
     TrackDAO m_trackDao;
+    ScanIndexDAO m_scanIndexDao;
+
+    // Lives in the library scanner thread while it is running.
+    std::unique_ptr<LibraryWatcher> m_pWatcher;
+    // Directories reported by the watcher that have not been scanned yet.
+    // Only accessed from the library scanner thread.
+    QSet<QString> m_changedDirectories;
+    bool m_bRescanRequested;
+
+    // Tracks imported by the scanner tasks that are added to the
+    // database in batches.
+    QList<TrackPointer> m_importedTracks;
 
     // Global scanner state for scan currently in progress.
     ScannerGlobalPointer m_scannerGlobal;
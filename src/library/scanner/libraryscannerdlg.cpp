@@ -23,9 +23,16 @@
 
 #include "library/scanner/libraryscannerdlg.h"
 
+namespace {
+
+const mixxx::Duration kRateUpdateInterval = mixxx::Duration::fromMillis(500);
+
+} // anonymous namespace
+
 LibraryScannerDlg::LibraryScannerDlg(QWidget* parent, Qt::WindowFlags f)
         : QWidget(parent, f),
-          m_bCancelled(false) {
+          m_bCancelled(false),
+          m_tracksAdded(0) {
     setWindowIcon(QIcon(":/images/mixxx_icon.svg"));
 
     QVBoxLayout* pLayout = new QVBoxLayout(this);
@@ -47,6 +54,11 @@ LibraryScannerDlg::LibraryScannerDlg(QWidget* parent, Qt::WindowFlags f)
     connect(this, SIGNAL(progress(QString)),
             pCurrent, SLOT(setText(QString)));
     pLayout->addWidget(pCurrent);
+
+    QLabel* pRate = new QLabel(this);
+    connect(this, SIGNAL(rate(QString)),
+            pRate, SLOT(setText(QString)));
+    pLayout->addWidget(pRate);
     setLayout(pLayout);
 }
 
@@ -65,6 +77,19 @@ void LibraryScannerDlg::slotUpdate(QString path) {
     }
 }
 
+void LibraryScannerDlg::slotTrackAdded(QString path) {
+    ++m_tracksAdded;
+    slotUpdate(path);
+
+    const mixxx::Duration elapsed = m_timer.elapsed();
+    if (isVisible() && elapsed - m_rateUpdated >= kRateUpdateInterval) {
+        m_rateUpdated = elapsed;
+        emit(rate(tr("%1 files added (%2 files/s)")
+                .arg(m_tracksAdded)
+                .arg(m_tracksAdded / elapsed.toDoubleSeconds(), 0, 'f', 1)));
+    }
+}
+
 void LibraryScannerDlg::slotUpdateCover(QString path) {
     //qDebug() << "LibraryScannerDlg slotUpdate" << m_timer.elapsed() << path;
     if (!m_bCancelled && m_timer.elapsed() > mixxx::Duration::fromSeconds(2)) {
@@ -88,6 +113,9 @@ void LibraryScannerDlg::slotCancel() {
 
 void LibraryScannerDlg::slotScanStarted() {
     m_bCancelled = false;
+    m_tracksAdded = 0;
+    m_rateUpdated = mixxx::Duration();
+    emit(rate(QString()));
     m_timer.start();
 }
 
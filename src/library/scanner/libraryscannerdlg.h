@@ -33,6 +33,7 @@ class LibraryScannerDlg : public QWidget {
 
   public slots:
     void slotUpdate(QString path);
+    void slotTrackAdded(QString path);
     void slotUpdateCover(QString path);
     void slotCancel();
     void slotScanFinished();
@@ -41,10 +42,14 @@ class LibraryScannerDlg : public QWidget {
   signals:
     void scanCancelled();
     void progress(QString);
+    void rate(QString);
 
   private:
     PerformanceTimer m_timer;
     bool m_bCancelled;
+
+    int m_tracksAdded;
+    mixxx::Duration m_rateUpdated;
 };
 
 #endif
@@ -0,0 +1,178 @@
+#include "library/scanner/librarywatcher.h"
+
+#include <QFile>
+#include <QSocketNotifier>
+
+#ifdef __LINUX__
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("LibraryWatcher");
+
+// Waiting for the file system to settle before reporting changes avoids
+// rescanning the library for every single file that is copied into it.
+const int kSettleMillis = 2000;
+
+#ifdef __LINUX__
+const uint32_t kWatchedEvents =
+        IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+        IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+} // anonymous namespace
+
+LibraryWatcher::LibraryWatcher(QObject* pParent)
+        : QObject(pParent),
+          m_fd(-1),
+          m_pNotifier(nullptr),
+          m_eventsLost(false),
+          m_watchLimitReached(false) {
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(kSettleMillis);
+    connect(&m_settleTimer, SIGNAL(timeout()),
+            this, SLOT(slotSettled()));
+#ifdef __LINUX__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        kLogger.warning()
+                << "Failed to initialize inotify:"
+                << strerror(errno);
+        return;
+    }
+    m_pNotifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_pNotifier, SIGNAL(activated(int)),
+            this, SLOT(slotReadEvents()));
+#endif
+}
+
+LibraryWatcher::~LibraryWatcher() {
+#ifdef __LINUX__
+    if (m_fd >= 0) {
+        delete m_pNotifier;
+        // Closing the file descriptor removes all watches
+        close(m_fd);
+    }
+#endif
+}
+
+void LibraryWatcher::watchDirectories(const QStringList& dirPaths) {
+    if (!isSupported()) {
+        return;
+    }
+    const QSet<QString> newDirPaths = dirPaths.toSet();
+    const QStringList oldDirPaths = m_watchDescriptors.keys();
+    for (const QString& dirPath : oldDirPaths) {
+        if (!newDirPaths.contains(dirPath)) {
+            removeWatch(dirPath);
+        }
+    }
+    m_watchLimitReached = false;
+    for (const QString& dirPath : newDirPaths) {
+        if (!m_watchDescriptors.contains(dirPath)) {
+            addWatch(dirPath);
+        }
+    }
+    kLogger.debug()
+            << "Watching" << m_watchDescriptors.size() << "directories";
+}
+
+void LibraryWatcher::addWatch(const QString& dirPath) {
+#ifdef __LINUX__
+    if (m_watchLimitReached) {
+        return;
+    }
+    const int wd = inotify_add_watch(m_fd,
+            QFile::encodeName(dirPath).constData(), kWatchedEvents);
+    if (wd < 0) {
+        if (errno == ENOSPC) {
+            kLogger.warning()
+                    << "Not all library directories are watched."
+                    << "Increase fs.inotify.max_user_watches to watch"
+                    << "large libraries.";
+            m_watchLimitReached = true;
+        } else {
+            kLogger.warning()
+                    << "Failed to watch" << dirPath << ":"
+                    << strerror(errno);
+        }
+        return;
+    }
+    m_watchDescriptors.insert(dirPath, wd);
+    // Paths that resolve to the same directory share a watch
+    m_watchedDirs.insert(wd, dirPath);
+#else
+    Q_UNUSED(dirPath);
+#endif
+}
+
+void LibraryWatcher::removeWatch(const QString& dirPath) {
+    const int wd = m_watchDescriptors.take(dirPath);
+    if (m_watchedDirs.value(wd) != dirPath) {
+        return;
+    }
+    m_watchedDirs.remove(wd);
+#ifdef __LINUX__
+    inotify_rm_watch(m_fd, wd);
+#endif
+}
+
+void LibraryWatcher::slotReadEvents() {
+#ifdef __LINUX__
+    char buffer[4096]
+            __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            if (length < 0 && errno != EAGAIN) {
+                kLogger.warning()
+                        << "Failed to read inotify events:"
+                        << strerror(errno);
+            }
+            break;
+        }
+        const char* pEvent = buffer;
+        while (pEvent < buffer + length) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(pEvent);
+            pEvent += sizeof(struct inotify_event) + event->len;
+            if (event->mask & IN_Q_OVERFLOW) {
+                m_eventsLost = true;
+                continue;
+            }
+            const QString dirPath = m_watchedDirs.value(event->wd);
+            if (dirPath.isEmpty()) {
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                // The directory has been removed or unmounted
+                m_watchedDirs.remove(event->wd);
+                m_watchDescriptors.remove(dirPath);
+                continue;
+            }
+            m_changedDirs.insert(dirPath);
+        }
+    }
+    if (m_eventsLost || !m_changedDirs.isEmpty()) {
+        m_settleTimer.start();
+    }
+#endif
+}
+
+void LibraryWatcher::slotSettled() {
+    QStringList changedDirs;
+    if (m_eventsLost) {
+        kLogger.info()
+                << "Changes have been lost, the whole library needs to be checked";
+    } else {
+        changedDirs = m_changedDirs.toList();
+    }
+    m_eventsLost = false;
+    m_changedDirs.clear();
+    emit(directoriesChanged(changedDirs));
+}
@@ -0,0 +1,57 @@
+#ifndef LIBRARYWATCHER_H
+#define LIBRARYWATCHER_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+class QSocketNotifier;
+
+// Watches the directories of the library for changes and reports the
+// directories whose entries have been added, removed, renamed or written.
+// Bursts of changes, e.g. while copying an album, are reported at once
+// after the file system has settled.
+//
+// Only implemented with inotify on Linux. On other platforms no changes
+// are reported and the library needs to be rescanned manually.
+class LibraryWatcher : public QObject {
+    Q_OBJECT
+  public:
+    explicit LibraryWatcher(QObject* pParent = nullptr);
+    ~LibraryWatcher() override;
+
+    bool isSupported() const {
+        return m_fd >= 0;
+    }
+
+    // Replaces the set of watched directories. Subdirectories are not
+    // watched implicitly and need to be included.
+    void watchDirectories(const QStringList& dirPaths);
+
+  signals:
+    // An empty list is reported if changes might have been lost and
+    // all directories need to be checked again.
+    void directoriesChanged(QStringList dirPaths);
+
+  private slots:
+    void slotReadEvents();
+    void slotSettled();
+
+  private:
+    void addWatch(const QString& dirPath);
+    void removeWatch(const QString& dirPath);
+
+    int m_fd;
+    QSocketNotifier* m_pNotifier;
+    QHash<QString, int> m_watchDescriptors;
+    QHash<int, QString> m_watchedDirs;
+
+    QTimer m_settleTimer;
+    QSet<QString> m_changedDirs;
+    bool m_eventsLost;
+    bool m_watchLimitReached;
+};
+
+#endif /* LIBRARYWATCHER_H */
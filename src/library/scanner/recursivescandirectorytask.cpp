@@ -1,3 +1,4 @@
+#include <QDateTime>
 #include <QDirIterator>
 
 #include "library/scanner/recursivescandirectorytask.h"
@@ -26,6 +27,32 @@ void RecursiveScanDirectoryTask::run() {
     //qDebug() << "Burn CPU";
     //for (int i = 0;i < 1000000000; i++) asm("nop");
 
+    QString dirPath = m_dir.path();
+
+    // Try to retrieve a hash from the last time that directory was scanned.
+    int prevHash = m_scannerGlobal->directoryHashInDatabase(dirPath);
+    bool prevHashExists = prevHash != -1;
+
+    if (prevHashExists) {
+        const ScanIndexDirectory* pIndexedDirectory =
+                m_scannerGlobal->indexedDirectory(dirPath);
+        if (pIndexedDirectory &&
+                scanIndexedDirectory(dirPath, *pIndexedDirectory)) {
+            setSuccess(true);
+            return;
+        }
+    }
+
+    // The stamp of the directory is taken before listing its entries.
+    // Otherwise changes made while listing would go unnoticed.
+    const bool indexDirectory = m_scannerGlobal->scanIndexEnabled() &&
+            (prevHashExists || m_scanUnhashed);
+    ScanIndexDirectory newIndexedDirectory;
+    if (indexDirectory) {
+        newIndexedDirectory = ScanIndexDirectory(FileStamp::of(dirPath),
+                QDateTime::currentMSecsSinceEpoch());
+    }
+
     // Note, we save on filesystem operations (and random work) by initializing
     // a QDirIterator with a QDir instead of a QString -- but it inherits its
     // Filter from the QDir so we have to set it first. If the QDir has not done
@@ -56,6 +83,12 @@ void RecursiveScanDirectoryTask::run() {
             if (supportedExtensionsRegex.indexIn(fileName) != -1) {
                 newHashStr.append(currentFile);
                 filesToImport.append(currentFileInfo);
+                if (indexDirectory) {
+                    ScanIndexDirectory::File file;
+                    file.name = fileName;
+                    file.stamp = FileStamp::of(currentFile);
+                    newIndexedDirectory.files.append(file);
+                }
             } else if (supportedCoverExtensionsRegex.indexIn(fileName) != -1) {
                 possibleCovers.append(currentFileInfo);
             }
@@ -68,6 +101,10 @@ void RecursiveScanDirectoryTask::run() {
             }
             const QDir currentDir(currentFile);
             dirsToScan.append(currentDir);
+            if (indexDirectory) {
+                newIndexedDirectory.subdirectories.append(
+                        currentFileInfo.fileName());
+            }
         }
     }
 
@@ -75,11 +112,25 @@ void RecursiveScanDirectoryTask::run() {
     // Calculate a hash of the directory's file list.
     int newHash = qHash(newHashStr.join(""));
 
-    QString dirPath = m_dir.path();
-
-    // Try to retrieve a hash from the last time that directory was scanned.
-    int prevHash = m_scannerGlobal->directoryHashInDatabase(dirPath);
-    bool prevHashExists = prevHash != -1;
+    if (indexDirectory) {
+        // The file names don't reveal files that have been modified in
+        // place, their stamps do.
+        auto prevIndexed = m_scannerGlobal->scanIndex().constFind(dirPath);
+        if (prevIndexed != m_scannerGlobal->scanIndex().constEnd()) {
+            QHash<QString, FileStamp> prevStamps;
+            for (const ScanIndexDirectory::File& file : prevIndexed->files) {
+                prevStamps.insert(file.name, file.stamp);
+            }
+            for (const ScanIndexDirectory::File& file : newIndexedDirectory.files) {
+                auto prevStamp = prevStamps.constFind(file.name);
+                if (prevStamp != prevStamps.constEnd() &&
+                        prevStamp.value() != file.stamp) {
+                    m_scannerGlobal->addModifiedTrack(dirPath + '/' + file.name);
+                }
+            }
+        }
+        m_scannerGlobal->indexDirectory(dirPath, newIndexedDirectory);
+    }
 
     if (prevHashExists || m_scanUnhashed) {
         // Compare the hashes, and if they don't match, rescan the files in that
@@ -102,6 +153,51 @@ void RecursiveScanDirectoryTask::run() {
         m_scannerGlobal->addUnhashedDir(m_dir, m_pToken);
     }
 
+    scanSubdirectories(dirsToScan);
+    setSuccess(true);
+}
+
+bool RecursiveScanDirectoryTask::scanIndexedDirectory(
+        const QString& dirPath, const ScanIndexDirectory& indexedDirectory) {
+    if (!indexedDirectory.isListingUnchanged(FileStamp::of(dirPath))) {
+        return false;
+    }
+
+    ScanIndexDirectory updatedDirectory = indexedDirectory;
+    bool filesModified = false;
+    for (ScanIndexDirectory::File& file : updatedDirectory.files) {
+        const QString trackLocation = dirPath + '/' + file.name;
+        const FileStamp stamp = FileStamp::of(trackLocation);
+        if (!stamp.isValid()) {
+            // Removing a file always changes the stamp of its directory,
+            // unless the clock of the file system can't be trusted.
+            return false;
+        }
+        if (stamp != file.stamp) {
+            m_scannerGlobal->addModifiedTrack(trackLocation);
+            file.stamp = stamp;
+            filesModified = true;
+        }
+    }
+    if (filesModified) {
+        m_scannerGlobal->indexDirectory(dirPath, updatedDirectory);
+    }
+    emit(directoryUnchanged(dirPath));
+
+    QLinkedList<QDir> dirsToScan;
+    for (const QString& subdirectory : indexedDirectory.subdirectories) {
+        const QString subdirectoryPath = dirPath + '/' + subdirectory;
+        if (m_scannerGlobal->directoryBlacklisted(subdirectoryPath)) {
+            continue;
+        }
+        dirsToScan.append(QDir(subdirectoryPath));
+    }
+    scanSubdirectories(dirsToScan);
+    return true;
+}
+
+void RecursiveScanDirectoryTask::scanSubdirectories(
+        const QLinkedList<QDir>& dirsToScan) {
     // Process all of the sub-directories.
     foreach (const QDir& nextDir, dirsToScan) {
         // Atomically test and mark the directory as scanned to avoid
@@ -113,5 +209,4 @@ void RecursiveScanDirectoryTask::run() {
                                                    nextDir, m_pToken, m_scanUnhashed));
         }
     }
-    setSuccess(true);
 }
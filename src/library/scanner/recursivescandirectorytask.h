@@ -2,6 +2,7 @@
 #define RECURSIVESCANDIRECTORYTASK_H
 
 #include <QDir>
+#include <QLinkedList>
 
 #include "library/scanner/scannertask.h"
 #include "util/sandbox.h"
@@ -11,6 +12,10 @@
 // performing a hash of the directory's file list, and those hashes are stored
 // in the database. Successful if the scan completed without being
 // cancelled. False if the scan was cancelled part-way through.
+//
+// Directories whose stamp has not changed since they have been indexed by
+// a previous scan are not listed again. Only the stamps of their indexed
+// files are checked to detect files that have been modified in place.
 class RecursiveScanDirectoryTask : public ScannerTask {
     Q_OBJECT
   public:
@@ -25,6 +30,11 @@ class RecursiveScanDirectoryTask : public ScannerTask {
     virtual void run();
 
   private:
+    // Returns false if the directory needs to be listed.
+    bool scanIndexedDirectory(const QString& dirPath,
+                              const ScanIndexDirectory& indexedDirectory);
+    void scanSubdirectories(const QLinkedList<QDir>& dirsToScan);
+
     QDir m_dir;
     SecurityTokenPointer m_pToken;
     bool m_scanUnhashed;
@@ -0,0 +1,53 @@
+#include "library/scanner/scanindex.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
+#ifndef __WINDOWS__
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+// FAT stores modification times with a resolution of 2 s, most other file
+// systems are at least as precise.
+const qint64 kMtimeResolutionMillis = 2000;
+
+const qint64 kNanosPerMilli = 1000000;
+
+} // anonymous namespace
+
+// static
+FileStamp FileStamp::of(const QString& path) {
+#ifdef __WINDOWS__
+    QFileInfo fileInfo(path);
+    if (!fileInfo.exists()) {
+        return FileStamp();
+    }
+    return FileStamp(fileInfo.size(),
+            fileInfo.lastModified().toMSecsSinceEpoch() * kNanosPerMilli,
+            0);
+#else
+    struct stat fileStat;
+    if (::stat(QFile::encodeName(path).constData(), &fileStat) != 0) {
+        return FileStamp();
+    }
+#ifdef __APPLE__
+    const qint64 mtimeNanos =
+            static_cast<qint64>(fileStat.st_mtimespec.tv_sec) * 1000000000 +
+            fileStat.st_mtimespec.tv_nsec;
+#else
+    const qint64 mtimeNanos =
+            static_cast<qint64>(fileStat.st_mtim.tv_sec) * 1000000000 +
+            fileStat.st_mtim.tv_nsec;
+#endif
+    return FileStamp(fileStat.st_size, mtimeNanos, fileStat.st_ino);
+#endif
+}
+
+bool ScanIndexDirectory::isListingUnchanged(const FileStamp& stamp) const {
+    return stamp.isValid() && stamp == m_stamp &&
+            stamp.mtimeNanos() <
+                    (m_indexedAtMillis - kMtimeResolutionMillis) * kNanosPerMilli;
+}
@@ -0,0 +1,105 @@
+#ifndef SCANINDEX_H
+#define SCANINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// The state of a file or directory on disk. It changes whenever a file is
+// modified in place or replaced, and whenever entries are added to, removed
+// from or renamed in a directory.
+class FileStamp {
+  public:
+    FileStamp()
+            : m_size(-1),
+              m_mtimeNanos(-1),
+              m_inode(0) {
+    }
+    FileStamp(qint64 size, qint64 mtimeNanos, quint64 inode)
+            : m_size(size),
+              m_mtimeNanos(mtimeNanos),
+              m_inode(inode) {
+    }
+
+    // Returns an invalid stamp if the file does not exist.
+    static FileStamp of(const QString& path);
+
+    bool isValid() const {
+        return m_mtimeNanos >= 0;
+    }
+
+    qint64 size() const {
+        return m_size;
+    }
+    qint64 mtimeNanos() const {
+        return m_mtimeNanos;
+    }
+    // Always 0 on platforms without inodes.
+    quint64 inode() const {
+        return m_inode;
+    }
+
+  private:
+    qint64 m_size;
+    qint64 m_mtimeNanos;
+    quint64 m_inode;
+};
+
+inline bool operator==(const FileStamp& lhs, const FileStamp& rhs) {
+    return lhs.size() == rhs.size() &&
+            lhs.mtimeNanos() == rhs.mtimeNanos() &&
+            lhs.inode() == rhs.inode();
+}
+
+inline bool operator!=(const FileStamp& lhs, const FileStamp& rhs) {
+    return !(lhs == rhs);
+}
+
+// What the library scanner has found in a directory the last time it listed
+// its entries. As long as the stamp of the directory does not change the
+// scanner uses the entries from the index instead of listing the directory
+// again.
+class ScanIndexDirectory {
+  public:
+    struct File {
+        QString name;
+        FileStamp stamp;
+    };
+
+    ScanIndexDirectory()
+            : m_indexedAtMillis(0) {
+    }
+    ScanIndexDirectory(const FileStamp& stamp, qint64 indexedAtMillis)
+            : m_stamp(stamp),
+              m_indexedAtMillis(indexedAtMillis) {
+    }
+
+    // Returns true if the entries of the directory can not have changed
+    // since it has been indexed. Changes that happen within the timestamp
+    // resolution of the file system after it was listed are not visible in
+    // its stamp, so the listing is only trusted for older modifications.
+    bool isListingUnchanged(const FileStamp& stamp) const;
+
+    const FileStamp& stamp() const {
+        return m_stamp;
+    }
+    // Time at which the entries were listed in milliseconds since the epoch.
+    qint64 indexedAtMillis() const {
+        return m_indexedAtMillis;
+    }
+
+    // The names of the subdirectories
+    QStringList subdirectories;
+    // The supported audio files
+    QVector<File> files;
+
+  private:
+    FileStamp m_stamp;
+    qint64 m_indexedAtMillis;
+};
+
+// Indexed directories by path
+typedef QHash<QString, ScanIndexDirectory> ScanIndex;
+
+#endif /* SCANINDEX_H */
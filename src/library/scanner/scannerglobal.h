@@ -9,6 +9,7 @@
 #include <QMutexLocker>
 #include <QSharedPointer>
 
+#include "library/scanner/scanindex.h"
 #include "util/task.h"
 #include "util/performancetimer.h"
 
@@ -40,9 +41,15 @@ class ScannerGlobal {
                   const QHash<QString, int>& directoryHashes,
                   const QRegExp& supportedExtensionsMatcher,
                   const QRegExp& supportedCoverExtensionsMatcher,
-                  const QStringList& directoriesBlacklist)
+                  const QStringList& directoriesBlacklist,
+                  bool scanIndexEnabled = false,
+                  const ScanIndex& scanIndex = ScanIndex(),
+                  const QSet<QString>& changedDirectories = QSet<QString>())
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
+              m_scanIndexEnabled(scanIndexEnabled),
+              m_scanIndex(scanIndex),
+              m_changedDirectories(changedDirectories),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
@@ -66,6 +73,50 @@ class ScannerGlobal {
         return m_directoryHashes.value(directoryPath, -1);
     }
 
+    inline bool scanIndexEnabled() const {
+        return m_scanIndexEnabled;
+    }
+
+    // Returns the index entry of the directory from the previous scan or
+    // nullptr if it has not been indexed or has been reported as changed.
+    inline const ScanIndexDirectory* indexedDirectory(const QString& directoryPath) const {
+        if (m_changedDirectories.contains(directoryPath)) {
+            return nullptr;
+        }
+        auto it = m_scanIndex.constFind(directoryPath);
+        if (it == m_scanIndex.constEnd()) {
+            return nullptr;
+        }
+        return &it.value();
+    }
+
+    const ScanIndex& scanIndex() const {
+        return m_scanIndex;
+    }
+
+    // Stores the new or updated index entry of a directory.
+    void indexDirectory(const QString& directoryPath,
+                        const ScanIndexDirectory& directory) {
+        QMutexLocker locker(&m_updatedScanIndexMutex);
+        m_updatedScanIndex.insert(directoryPath, directory);
+    }
+
+    inline const ScanIndex& updatedScanIndex() const {
+        // no need for locking here, because it is only used
+        // when only one using thread is around.
+        return m_updatedScanIndex;
+    }
+
+    // Tracks that have been modified in place since the previous scan.
+    void addModifiedTrack(const QString& trackLocation) {
+        QMutexLocker locker(&m_updatedScanIndexMutex);
+        m_modifiedTracks << trackLocation;
+    }
+
+    inline const QStringList& modifiedTracks() const {
+        return m_modifiedTracks;
+    }
+
     inline bool directoryBlacklisted(const QString& directoryPath) const {
         return m_directoriesBlacklist.contains(directoryPath);
     }
@@ -179,6 +230,17 @@ class ScannerGlobal {
     QSet<QString> m_trackLocations;
     QHash<QString, int> m_directoryHashes;
 
+    // The index of the previous scan and the directories that have been
+    // reported as changed since then.
+    bool m_scanIndexEnabled;
+    ScanIndex m_scanIndex;
+    QSet<QString> m_changedDirectories;
+
+    // Index entries and tracks collected by the scan tasks.
+    mutable QMutex m_updatedScanIndexMutex;
+    ScanIndex m_updatedScanIndex;
+    QStringList m_modifiedTracks;
+
     mutable QMutex m_supportedExtensionsMatcherMutex;
     QRegExp m_supportedExtensionsMatcher;
 
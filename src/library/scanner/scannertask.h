@@ -26,6 +26,9 @@ class ScannerTask : public QObject, public QRunnable {
     void directoryUnchanged(const QString& directoryPath);
     void trackExists(const QString& filePath);
     void addNewTrack(const QString& filePath);
+    // The metadata of the file has already been imported into a temporary
+    // track object.
+    void addNewImportedTrack(TrackPointer pImportedTrack);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
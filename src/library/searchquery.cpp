@@ -2,6 +2,7 @@
 
 #include "library/searchquery.h"
 
+#include "library/columnartrackindex.h"
 #include "library/queryutil.h"
 #include "track/keyutils.h"
 #include "library/dao/trackschema.h"
@@ -34,7 +35,8 @@ QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& colum
     } else if (column == LIBRARYTABLE_TRACKNUMBER) {
         return pTrack->getTrackNumber();
     } else if (column == LIBRARYTABLE_LOCATION) {
-        return QDir::toNativeSeparators(pTrack->getLocation());
+        // Same separators as in the database, see BaseTrackCache
+        return pTrack->getLocation();
     } else if (column == LIBRARYTABLE_COMMENT) {
         return pTrack->getComment();
     } else if (column == LIBRARYTABLE_DURATION) {
@@ -76,6 +78,15 @@ QString QueryNode::concatSqlClauses(
     }
 }
 
+bool GroupNode::canMatchIndex(const ColumnarTrackIndex& index) const {
+    for (const auto& pNode: m_nodes) {
+        if (!pNode->canMatchIndex(index)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool AndNode::match(const TrackPointer& pTrack) const {
     for (const auto& pNode: m_nodes) {
         if (!pNode->match(pTrack)) {
@@ -87,6 +98,15 @@ bool AndNode::match(const TrackPointer& pTrack) const {
     return true;
 }
 
+bool AndNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    for (const auto& pNode: m_nodes) {
+        if (!pNode->matchIndex(index, row)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 QString AndNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(m_nodes.size());
@@ -116,6 +136,18 @@ bool OrNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool OrNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    VERIFY_OR_DEBUG_ASSERT(!m_nodes.empty()) {
+        return true;
+    }
+    for (const auto& pNode: m_nodes) {
+        if (pNode->matchIndex(index, row)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QString OrNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(m_nodes.size());
@@ -132,6 +164,14 @@ bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
 
+bool NotNode::canMatchIndex(const ColumnarTrackIndex& index) const {
+    return m_pNode->canMatchIndex(index);
+}
+
+bool NotNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    return !m_pNode->matchIndex(index, row);
+}
+
 QString NotNode::toSql() const {
     QString sql(m_pNode->toSql());
     if (sql.isEmpty()) {
@@ -149,7 +189,8 @@ TextFilterNode::TextFilterNode(const QSqlDatabase& database,
                const QString& argument)
         : m_database(database),
           m_sqlColumns(sqlColumns),
-          m_argument(argument) {
+          m_argument(argument),
+          m_indexMatchInitialized(false) {
     mixxx::DbConnection::makeStringLatinLow(&m_argument);
 }
 
@@ -169,6 +210,42 @@ bool TextFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool TextFilterNode::canMatchIndex(const ColumnarTrackIndex& index) const {
+    // LIKE wildcards and the handling of trailing spaces in toSql()
+    // are only supported by the database.
+    if (m_argument.contains(kSqlLikeMatchAll) ||
+            m_argument.contains(kSqlLikeMatchOne) ||
+            (m_argument.size() > 0 && m_argument[m_argument.size() - 1].isSpace())) {
+        return false;
+    }
+    for (const auto& sqlColumn: m_sqlColumns) {
+        int column = index.columnIndex(sqlColumn);
+        if (column < 0 ||
+                index.columnType(column) != ColumnarTrackIndex::ColumnType::Text) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TextFilterNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    if (!m_indexMatchInitialized) {
+        // Each distinct string only needs to be searched once
+        for (const auto& sqlColumn: m_sqlColumns) {
+            m_indexColumns.push_back(index.columnIndex(sqlColumn));
+        }
+        m_matchingStrings = index.matchStrings(m_argument);
+        m_indexMatchInitialized = true;
+    }
+    for (int column: m_indexColumns) {
+        const quint32 stringId = index.stringId(row, column);
+        if (stringId < m_matchingStrings.size() && m_matchingStrings[stringId]) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QString TextFilterNode::toSql() const {
     FieldEscaper escaper(m_database);
     QString argument = m_argument;
@@ -200,6 +277,24 @@ bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool NullOrEmptyTextFilterNode::canMatchIndex(const ColumnarTrackIndex& index) const {
+    if (m_sqlColumns.isEmpty()) {
+        return true;
+    }
+    int column = index.columnIndex(m_sqlColumns.first());
+    return column >= 0 &&
+            index.columnType(column) == ColumnarTrackIndex::ColumnType::Text;
+}
+
+bool NullOrEmptyTextFilterNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    if (!m_sqlColumns.isEmpty()) {
+        // only use the major column
+        int column = index.columnIndex(m_sqlColumns.first());
+        return index.foldedString(index.stringId(row, column)).isEmpty();
+    }
+    return false;
+}
+
 QString NullOrEmptyTextFilterNode::toSql() const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -216,6 +311,19 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
 }
 
 bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    return matchTrackId(pTrack->getId());
+}
+
+bool CrateFilterNode::canMatchIndex(const ColumnarTrackIndex& index) const {
+    Q_UNUSED(index);
+    return true;
+}
+
+bool CrateFilterNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    return matchTrackId(index.trackId(row));
+}
+
+bool CrateFilterNode::matchTrackId(TrackId trackId) const {
     if (!m_matchInitialized) {
         CrateTrackSelectResult crateTracks(
              m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
@@ -227,7 +335,7 @@ bool CrateFilterNode::match(const TrackPointer& pTrack) const {
         m_matchInitialized = true;
     }
 
-    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), trackId);
 }
 
 QString CrateFilterNode::toSql() const {
@@ -242,6 +350,19 @@ NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
 }
 
 bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    return matchTrackId(pTrack->getId());
+}
+
+bool NoCrateFilterNode::canMatchIndex(const ColumnarTrackIndex& index) const {
+    Q_UNUSED(index);
+    return true;
+}
+
+bool NoCrateFilterNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    return matchTrackId(index.trackId(row));
+}
+
+bool NoCrateFilterNode::matchTrackId(TrackId trackId) const {
     if (!m_matchInitialized) {
         TrackSelectResult tracks(
                 m_pCrateStorage->selectAllTracksSorted());
@@ -253,7 +374,7 @@ bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
         m_matchInitialized = true;
     }
 
-    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), trackId);
 }
 
 QString NoCrateFilterNode::toSql() const {
@@ -325,23 +446,49 @@ bool NumericFilterNode::match(const TrackPointer& pTrack) const {
             continue;
         }
 
-        double dValue = value.toDouble();
-        if (m_bOperatorQuery) {
-            if ((m_operator == "=" && dValue == m_dOperatorArgument) ||
-                (m_operator == "<" && dValue < m_dOperatorArgument) ||
-                (m_operator == ">" && dValue > m_dOperatorArgument) ||
-                (m_operator == "<=" && dValue <= m_dOperatorArgument) ||
-                (m_operator == ">=" && dValue >= m_dOperatorArgument)) {
+        if (matchValue(value.toDouble())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NumericFilterNode::canMatchIndex(const ColumnarTrackIndex& index) const {
+    for (const auto& sqlColumn: m_sqlColumns) {
+        if (index.columnIndex(sqlColumn) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NumericFilterNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    for (const auto& sqlColumn: m_sqlColumns) {
+        double dValue;
+        if (!index.numericValue(row, index.columnIndex(sqlColumn), &dValue)) {
+            if (m_bNullQuery) {
                 return true;
             }
-        } else if (m_bRangeQuery && dValue >= m_dRangeLow &&
-                   dValue <= m_dRangeHigh) {
+            continue;
+        }
+        if (matchValue(dValue)) {
             return true;
         }
     }
     return false;
 }
 
+bool NumericFilterNode::matchValue(double dValue) const {
+    if (m_bOperatorQuery) {
+        return (m_operator == "=" && dValue == m_dOperatorArgument) ||
+                (m_operator == "<" && dValue < m_dOperatorArgument) ||
+                (m_operator == ">" && dValue > m_dOperatorArgument) ||
+                (m_operator == "<=" && dValue <= m_dOperatorArgument) ||
+                (m_operator == ">=" && dValue >= m_dOperatorArgument);
+    }
+    return m_bRangeQuery && dValue >= m_dRangeLow && dValue <= m_dRangeHigh;
+}
+
 QString NumericFilterNode::toSql() const {
     if (m_bNullQuery) {
         for (const auto& sqlColumn: m_sqlColumns) {
@@ -391,6 +538,19 @@ bool NullNumericFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool NullNumericFilterNode::canMatchIndex(const ColumnarTrackIndex& index) const {
+    return m_sqlColumns.isEmpty() || index.columnIndex(m_sqlColumns.first()) >= 0;
+}
+
+bool NullNumericFilterNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    if (!m_sqlColumns.isEmpty()) {
+        // only use the major column
+        double dValue;
+        return !index.numericValue(row, index.columnIndex(m_sqlColumns.first()), &dValue);
+    }
+    return false;
+}
+
 QString NullNumericFilterNode::toSql() const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -451,6 +611,19 @@ bool KeyFilterNode::match(const TrackPointer& pTrack) const {
     return m_matchKeys.contains(pTrack->getKey());
 }
 
+bool KeyFilterNode::canMatchIndex(const ColumnarTrackIndex& index) const {
+    return index.columnIndex(LIBRARYTABLE_KEY_ID) >= 0;
+}
+
+bool KeyFilterNode::matchIndex(const ColumnarTrackIndex& index, int row) const {
+    double dValue;
+    if (!index.numericValue(row, index.columnIndex(LIBRARYTABLE_KEY_ID), &dValue)) {
+        return false;
+    }
+    return m_matchKeys.contains(
+            static_cast<mixxx::track::io::key::ChromaticKey>(static_cast<int>(dValue)));
+}
+
 QString KeyFilterNode::toSql() const {
     QStringList searchClauses;
     for (const auto& matchKey: m_matchKeys) {
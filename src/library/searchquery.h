@@ -16,6 +16,8 @@
 #include "util/memory.h"
 #include "library/crate/cratestorage.h"
 
+class ColumnarTrackIndex;
+
 const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty string
 
 QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& column);
@@ -28,6 +30,14 @@ class QueryNode {
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
 
+    // Evaluation on the in-memory index of a BaseTrackCache instead of a
+    // track object. matchIndex() must only be called if canMatchIndex()
+    // returns true for the same index, which is not the case if the node
+    // depends on columns that are missing or can only be evaluated by
+    // the database.
+    virtual bool canMatchIndex(const ColumnarTrackIndex& index) const = 0;
+    virtual bool matchIndex(const ColumnarTrackIndex& index, int row) const = 0;
+
   protected:
     QueryNode() {}
 
@@ -41,6 +51,8 @@ class GroupNode : public QueryNode {
         m_nodes.push_back(std::move(pNode));
     }
 
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override;
+
   protected:
     // NOTE(uklotzde): std::vector is more suitable (efficiency)
     // than a QList for a private member. And QList from Qt 4
@@ -52,12 +64,14 @@ class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 };
 
 class NotNode : public QueryNode {
@@ -69,6 +83,8 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -82,11 +98,17 @@ class TextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 
   private:
     QSqlDatabase m_database;
     QStringList m_sqlColumns;
     QString m_argument;
+    mutable bool m_indexMatchInitialized;
+    mutable std::vector<int> m_indexColumns;
+    // Indexed by the string ids of the index
+    mutable std::vector<bool> m_matchingStrings;
 };
 
 class NullOrEmptyTextFilterNode : public QueryNode {
@@ -99,6 +121,8 @@ class NullOrEmptyTextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 
   private:
     QSqlDatabase m_database;
@@ -113,8 +137,12 @@ class CrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 
   private:
+    bool matchTrackId(TrackId trackId) const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -127,8 +155,12 @@ class NoCrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 
   private:
+    bool matchTrackId(TrackId trackId) const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -141,6 +173,8 @@ class NumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 
   protected:
     // Single argument constructor for that does not call init()
@@ -154,6 +188,7 @@ class NumericFilterNode : public QueryNode {
 
   private:
     virtual double parse(const QString& arg, bool *ok);
+    bool matchValue(double dValue) const;
 
     QStringList m_sqlColumns;
     bool m_bOperatorQuery;
@@ -171,6 +206,8 @@ class NullNumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 
     QStringList m_sqlColumns;
 };
@@ -189,6 +226,8 @@ class KeyFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override;
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override;
 
   private:
     QList<mixxx::track::io::key::ChromaticKey> m_matchKeys;
@@ -214,6 +253,18 @@ class SqlNode : public QueryNode {
         return m_sql;
     }
 
+    bool canMatchIndex(const ColumnarTrackIndex& index) const override {
+        // Arbitrary SQL can only be evaluated by the database
+        Q_UNUSED(index);
+        return false;
+    }
+
+    bool matchIndex(const ColumnarTrackIndex& index, int row) const override {
+        Q_UNUSED(index);
+        Q_UNUSED(row);
+        return true;
+    }
+
   private:
     QString m_sql;
 };
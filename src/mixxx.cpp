@@ -169,10 +169,9 @@ MixxxMainWindow::MixxxMainWindow(QApplication* pApp, const CmdlineArgs& args)
 
     Version::logBuildDetails();
 
-    // Only record stats in developer mode.
-    if (m_cmdLineArgs.getDeveloper()) {
-        StatsManager::createInstance();
-    }
+    // Stats with an id are always recorded. Stats with a string tag
+    // are only recorded in developer mode.
+    StatsManager::createInstance();
 
     m_pSettingsManager = new SettingsManager(this, args.getSettingsPath());
 
@@ -17,6 +17,18 @@ class WaveformSettings {
                 ConfigKey("[Library]", "EnableWaveformCaching"), enabled);
     }
 
+    // Compressed waveforms need less disk space, but they are decoded
+    // into memory instead of being mapped directly when loading a track.
+    bool waveformCacheCompressionEnabled() const {
+        return m_pConfig->getValue<bool>(
+                ConfigKey("[Library]", "CompressWaveformCache"), false);
+    }
+
+    void setWaveformCacheCompressionEnabled(bool enabled) {
+        m_pConfig->setValue<bool>(
+                ConfigKey("[Library]", "CompressWaveformCache"), enabled);
+    }
+
     bool waveformGenerationWithAnalysisEnabled() const {
         return m_pConfig->getValue<bool>(
                 ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true);
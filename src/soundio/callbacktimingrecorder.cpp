@@ -0,0 +1,259 @@
+#include "soundio/callbacktimingrecorder.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <QFile>
+#include <QtDebug>
+
+#include "util/math.h"
+
+namespace {
+
+// The number of xrun reports that can be passed to the reader before
+// it collects them. Further reports are discarded.
+const int kXrunReportFifoSize = 8;
+
+// The number of xrun reports that are kept by the reader
+const int kMaxXrunReports = 16;
+
+double nanosToMicros(qint64 nanos) {
+    return nanos / 1000.0;
+}
+
+} // anonymous namespace
+
+constexpr int CallbackTimingRecorder::kStageCount;
+constexpr int CallbackTimingRecorder::kXrunHistorySize;
+constexpr int CallbackTimingRecorder::kLinearBinCount;
+constexpr int CallbackTimingRecorder::kSubBinCount;
+constexpr int CallbackTimingRecorder::kMaxExponent;
+constexpr int CallbackTimingRecorder::kBinCount;
+
+// static
+const char* CallbackTimingRecorder::stageName(Stage stage) {
+    // Same names as the corresponding ScopedTimer keys
+    switch (stage) {
+    case Stage::Input:
+        return "SoundDevicePortAudio::callbackProcess input";
+    case Stage::Engine:
+        return "SoundDevicePortAudio::callbackProcess prepare";
+    case Stage::Output:
+        return "SoundDevicePortAudio::callbackProcess output";
+    }
+    return "unknown";
+}
+
+CallbackTimingRecorder::CallbackTimingRecorder()
+        : m_historyCount(0),
+          m_historyIndex(0),
+          m_callbackCount(0),
+          m_xrunCount(0),
+          m_maxNanos(0),
+          m_pendingXrunCode(0),
+          m_resetRequested(false),
+          m_xrunReportFifo(kXrunReportFifoSize) {
+    m_creationTimer.start();
+    m_callbackTimer.start();
+    memset(&m_current, 0, sizeof(m_current));
+    memset(&m_xrunReport, 0, sizeof(m_xrunReport));
+    for (auto& count : m_histogram) {
+        count.store(0);
+    }
+}
+
+// static
+int CallbackTimingRecorder::binForMicros(qint64 micros) {
+    if (micros < kLinearBinCount) {
+        return static_cast<int>(math_max<qint64>(micros, 0));
+    }
+    int exponent = 4;
+    while ((micros >> (exponent + 1)) != 0) {
+        ++exponent;
+    }
+    if (exponent >= kMaxExponent) {
+        return kBinCount - 1;
+    }
+    // The 3 bits below the most significant bit select the sub bin
+    const int subBin = static_cast<int>((micros >> (exponent - 3)) & (kSubBinCount - 1));
+    return kLinearBinCount + (exponent - 4) * kSubBinCount + subBin;
+}
+
+// static
+qint64 CallbackTimingRecorder::binUpperBoundMicros(int bin) {
+    if (bin < kLinearBinCount) {
+        return bin + 1;
+    }
+    const int exponent = 4 + (bin - kLinearBinCount) / kSubBinCount;
+    const int subBin = (bin - kLinearBinCount) % kSubBinCount;
+    return static_cast<qint64>(kSubBinCount + subBin + 1) << (exponent - 3);
+}
+
+void CallbackTimingRecorder::beginCallback() {
+    m_callbackTimer.start();
+    m_current.startNanos = m_creationTimer.elapsed().toIntegerNanos();
+    for (int i = 0; i < kStageCount; ++i) {
+        m_current.stageNanos[i] = 0;
+    }
+}
+
+void CallbackTimingRecorder::endCallback(SINT framesPerBuffer, double sampleRate) {
+    if (m_resetRequested.exchange(false)) {
+        reset();
+    }
+
+    m_current.durationNanos = m_callbackTimer.elapsed().toIntegerNanos();
+    m_current.budgetNanos = sampleRate > 0 ?
+            static_cast<qint64>(framesPerBuffer * 1e9 / sampleRate) : 0;
+
+    // Only the callback thread writes the statistics, so there is
+    // no need for an atomic read-modify-write.
+    std::atomic<quint32>& count =
+            m_histogram[binForMicros(m_current.durationNanos / 1000)];
+    count.store(count.load(std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+    m_callbackCount.store(m_callbackCount.load(std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+    if (m_current.durationNanos > m_maxNanos.load(std::memory_order_relaxed)) {
+        m_maxNanos.store(m_current.durationNanos, std::memory_order_relaxed);
+    }
+
+    m_history[m_historyIndex] = m_current;
+    m_historyIndex = (m_historyIndex + 1) % kXrunHistorySize;
+    m_historyCount = math_min(m_historyCount + 1, kXrunHistorySize);
+
+    const int xrunCode = m_pendingXrunCode.exchange(0);
+    if (xrunCode != 0) {
+        m_xrunCount.store(m_xrunCount.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+        m_xrunReport.code = xrunCode;
+        m_xrunReport.recordCount = m_historyCount;
+        const int oldestIndex = (m_historyIndex - m_historyCount + kXrunHistorySize)
+                % kXrunHistorySize;
+        for (int i = 0; i < m_historyCount; ++i) {
+            m_xrunReport.records[i] =
+                    m_history[(oldestIndex + i) % kXrunHistorySize];
+        }
+        // Discarded if the reader did not keep up
+        m_xrunReportFifo.write(&m_xrunReport, 1);
+    }
+}
+
+void CallbackTimingRecorder::reportXrun(int code) {
+    // Codes are always positive, the most recent one wins
+    m_pendingXrunCode.store(math_max(code, 1));
+}
+
+void CallbackTimingRecorder::requestReset() {
+    m_resetRequested.store(true);
+}
+
+void CallbackTimingRecorder::reset() {
+    for (auto& count : m_histogram) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    m_callbackCount.store(0, std::memory_order_relaxed);
+    m_xrunCount.store(0, std::memory_order_relaxed);
+    m_maxNanos.store(0, std::memory_order_relaxed);
+    m_historyCount = 0;
+    m_historyIndex = 0;
+}
+
+CallbackTimingRecorder::Statistics CallbackTimingRecorder::statistics() const {
+    quint32 histogram[kBinCount];
+    qint64 total = 0;
+    for (int i = 0; i < kBinCount; ++i) {
+        histogram[i] = m_histogram[i].load(std::memory_order_relaxed);
+        total += histogram[i];
+    }
+
+    Statistics stats;
+    stats.callbackCount = m_callbackCount.load(std::memory_order_relaxed);
+    stats.xrunCount = m_xrunCount.load(std::memory_order_relaxed);
+    stats.maxMicros = nanosToMicros(m_maxNanos.load(std::memory_order_relaxed));
+
+    // Percentiles are reported as the upper bound of their bin, but never
+    // above the maximum.
+    const auto percentile = [&](double p) {
+        const qint64 rank = static_cast<qint64>(ceil(p * total));
+        qint64 cumulative = 0;
+        for (int i = 0; i < kBinCount; ++i) {
+            cumulative += histogram[i];
+            if (cumulative >= rank && cumulative > 0) {
+                return math_min<double>(binUpperBoundMicros(i), stats.maxMicros);
+            }
+        }
+        return 0.0;
+    };
+    stats.p50Micros = percentile(0.5);
+    stats.p99Micros = percentile(0.99);
+    stats.p999Micros = percentile(0.999);
+    return stats;
+}
+
+void CallbackTimingRecorder::collectXrunReports() {
+    XrunReport report;
+    while (m_xrunReportFifo.read(&report, 1) == 1) {
+        m_xrunReports.append(report);
+        while (m_xrunReports.size() > kMaxXrunReports) {
+            m_xrunReports.removeFirst();
+        }
+    }
+}
+
+bool CallbackTimingRecorder::dumpToFile(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "Failed to open" << fileName << "for writing";
+        return false;
+    }
+    QTextStream stream(&file);
+    writeReport(&stream);
+    return stream.status() == QTextStream::Ok;
+}
+
+void CallbackTimingRecorder::writeReport(QTextStream* pStream) {
+    collectXrunReports();
+    QTextStream& out = *pStream;
+
+    const Statistics stats = statistics();
+    out << "Audio callback timing\n"
+        << "callbacks: " << stats.callbackCount << "\n"
+        << "xruns: " << stats.xrunCount << "\n"
+        << "p50: " << stats.p50Micros << " us\n"
+        << "p99: " << stats.p99Micros << " us\n"
+        << "p99.9: " << stats.p999Micros << " us\n"
+        << "max: " << stats.maxMicros << " us\n"
+        << "\nHistogram (upper bound in us, count)\n";
+    for (int i = 0; i < kBinCount; ++i) {
+        const quint32 count = m_histogram[i].load(std::memory_order_relaxed);
+        if (count > 0) {
+            out << binUpperBoundMicros(i) << "\t" << count << "\n";
+        }
+    }
+
+    out << "\nLast " << m_xrunReports.size() << " xruns"
+        << " (times in us, stages: ";
+    for (int i = 0; i < kStageCount; ++i) {
+        out << (i > 0 ? ", " : "") << stageName(static_cast<Stage>(i));
+    }
+    out << ")\n";
+    for (const auto& report : m_xrunReports) {
+        out << "\nxrun code " << report.code << "\n"
+            << "start\tduration\tbudget";
+        for (int i = 0; i < kStageCount; ++i) {
+            out << "\tstage" << i;
+        }
+        out << "\n";
+        for (int i = 0; i < report.recordCount; ++i) {
+            const Record& record = report.records[i];
+            out << nanosToMicros(record.startNanos) << "\t"
+                << nanosToMicros(record.durationNanos) << "\t"
+                << nanosToMicros(record.budgetNanos);
+            for (int j = 0; j < kStageCount; ++j) {
+                out << "\t" << nanosToMicros(record.stageNanos[j]);
+            }
+            out << (record.durationNanos > record.budgetNanos ? "\toverrun\n" : "\n");
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef CALLBACKTIMINGRECORDER_H
+#define CALLBACKTIMINGRECORDER_H
+
+#include <atomic>
+
+#include <QList>
+#include <QString>
+#include <QTextStream>
+
+#include "util/fifo.h"
+#include "util/performancetimer.h"
+#include "util/types.h"
+
+// Records the duration of each audio callback of the clock reference
+// device for tuning the audio buffer size and for finding the cause of
+// buffer underflows (xruns).
+//
+// The durations of all callbacks are collected in a histogram with
+// logarithmic bins. The last kXrunHistorySize callbacks, including the
+// durations of their stages, are kept in a ring buffer. A copy of this
+// ring buffer is passed to the reader whenever an xrun is reported.
+//
+// All recording functions must only be called from the audio callback
+// thread and are lock-free. reportXrun() and requestReset() may be called
+// from any thread. All other functions must only be called from a single
+// reader thread, usually the main thread.
+class CallbackTimingRecorder {
+  public:
+    // The stages of a callback that are also measured by a ScopedTimer
+    enum class Stage {
+        Input = 0,
+        Engine = 1,
+        Output = 2,
+    };
+    static constexpr int kStageCount = 3;
+    static const char* stageName(Stage stage);
+
+    static constexpr int kXrunHistorySize = 32;
+
+    struct Record {
+        // Relative to the creation of the recorder
+        qint64 startNanos;
+        qint64 durationNanos;
+        // The duration of the audio buffer, i.e. the time budget
+        qint64 budgetNanos;
+        qint64 stageNanos[kStageCount];
+    };
+
+    struct XrunReport {
+        int code;
+        // Oldest first, the last record is the callback in which
+        // the xrun has been reported.
+        int recordCount;
+        Record records[kXrunHistorySize];
+    };
+
+    struct Statistics {
+        qint64 callbackCount;
+        qint64 xrunCount;
+        double p50Micros;
+        double p99Micros;
+        double p999Micros;
+        double maxMicros;
+    };
+
+    // Measures the duration of a stage of the current callback
+    class ScopedStage {
+      public:
+        ScopedStage(CallbackTimingRecorder* pRecorder, Stage stage)
+                : m_pRecorder(pRecorder),
+                  m_stage(stage) {
+            m_timer.start();
+        }
+        ~ScopedStage() {
+            m_pRecorder->m_current.stageNanos[static_cast<int>(m_stage)] +=
+                    m_timer.elapsed().toIntegerNanos();
+        }
+
+      private:
+        CallbackTimingRecorder* const m_pRecorder;
+        const Stage m_stage;
+        PerformanceTimer m_timer;
+    };
+
+    CallbackTimingRecorder();
+
+    // Audio callback thread
+    void beginCallback();
+    void endCallback(SINT framesPerBuffer, double sampleRate);
+
+    // Any thread
+    void reportXrun(int code);
+    void requestReset();
+
+    // Reader thread
+    Statistics statistics() const;
+    // Takes over the xrun reports from the callback thread. Needs to be
+    // called regularly, otherwise the reports of subsequent xruns are lost.
+    void collectXrunReports();
+    bool dumpToFile(const QString& fileName);
+
+    // Exposed for tests
+    static int binForMicros(qint64 micros);
+    static qint64 binUpperBoundMicros(int bin);
+
+  private:
+    // 16 linear bins for [0, 16) us followed by 8 bins per power of 2
+    // up to 2^24 us (~16 s)
+    static constexpr int kLinearBinCount = 16;
+    static constexpr int kSubBinCount = 8;
+    static constexpr int kMaxExponent = 24;
+    static constexpr int kBinCount =
+            kLinearBinCount + (kMaxExponent - 4) * kSubBinCount;
+
+    void reset();
+    void writeReport(QTextStream* pStream);
+
+    // Audio callback thread
+    PerformanceTimer m_creationTimer;
+    PerformanceTimer m_callbackTimer;
+    Record m_current;
+    Record m_history[kXrunHistorySize];
+    int m_historyCount;
+    int m_historyIndex;
+    XrunReport m_xrunReport;
+
+    // Written by the audio callback thread only
+    std::atomic<quint32> m_histogram[kBinCount];
+    std::atomic<qint64> m_callbackCount;
+    std::atomic<qint64> m_xrunCount;
+    std::atomic<qint64> m_maxNanos;
+
+    std::atomic<int> m_pendingXrunCode;
+    std::atomic<bool> m_resetRequested;
+    FIFO<XrunReport> m_xrunReportFifo;
+
+    // Reader thread
+    QList<XrunReport> m_xrunReports;
+};
+
+#endif /* CALLBACKTIMINGRECORDER_H */
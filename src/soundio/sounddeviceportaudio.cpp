@@ -861,6 +861,10 @@ int SoundDevicePortAudio::callbackProcessClkRef(
     // This must be the very first call, else timeInfo becomes invalid
     updateCallbackEntryToDacTime(timeInfo);
 
+    CallbackTimingRecorder* pTimingRecorder =
+            m_pSoundManager->getCallbackTimingRecorder();
+    pTimingRecorder->beginCallback();
+
     Trace trace("SoundDevicePortAudio::callbackProcessClkRef %1",
                 getInternalName());
 
@@ -930,8 +934,11 @@ int SoundDevicePortAudio::callbackProcessClkRef(
     if (in) {
         ScopedTimer t("SoundDevicePortAudio::callbackProcess input %1",
                 getInternalName());
-        composeInputBuffer(in, framesPerBuffer, 0, m_inputParams.channelCount);
-        m_pSoundManager->pushInputBuffers(m_audioInputs, m_framesPerBuffer);
+        CallbackTimingRecorder::ScopedStage stage(pTimingRecorder,
+                CallbackTimingRecorder::Stage::Input);
+        // The input is only composed for destinations that need it
+        m_pSoundManager->pushInputViews(m_audioInputs, in, framesPerBuffer,
+                m_inputParams.channelCount);
     }
 
     m_pSoundManager->readProcess();
@@ -939,12 +946,16 @@ int SoundDevicePortAudio::callbackProcessClkRef(
     {
         ScopedTimer t("SoundDevicePortAudio::callbackProcess prepare %1",
                 getInternalName());
+        CallbackTimingRecorder::ScopedStage stage(pTimingRecorder,
+                CallbackTimingRecorder::Stage::Engine);
         m_pSoundManager->onDeviceOutputCallback(framesPerBuffer);
     }
 
     if (out) {
         ScopedTimer t("SoundDevicePortAudio::callbackProcess output %1",
                 getInternalName());
+        CallbackTimingRecorder::ScopedStage stage(pTimingRecorder,
+                CallbackTimingRecorder::Stage::Output);
 
         if (m_outputParams.channelCount <= 0) {
             qWarning()
@@ -961,6 +972,8 @@ int SoundDevicePortAudio::callbackProcessClkRef(
 
     updateAudioLatencyUsage(framesPerBuffer);
 
+    pTimingRecorder->endCallback(framesPerBuffer, m_dSampleRate);
+
     return paContinue;
 }
 
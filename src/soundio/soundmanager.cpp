@@ -19,11 +19,13 @@
 #include <QtDebug>
 #include <cstring> // for memcpy and strcmp
 
+#include <QDir>
 #include <QLibrary>
 #include <portaudio.h>
 
 #include "control/controlobject.h"
 #include "control/controlproxy.h"
+#include "control/controlpushbutton.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginemaster.h"
 #include "engine/sidechain/enginenetworkstream.h"
@@ -36,6 +38,7 @@
 #include "util/compatibility.h"
 #include "util/cmdlineargs.h"
 #include "util/defs.h"
+#include "util/math.h"
 #include "util/sample.h"
 #include "util/sleep.h"
 #include "util/version.h"
@@ -47,6 +50,9 @@ namespace {
 
 #define CPU_OVERLOAD_DURATION 500 // in ms
 
+// How often the callback timing statistics are published as controls
+const int kCallbackTimingUpdateIntervalMillis = 1000;
+
 struct DeviceMode {
     SoundDevicePointer pDevice;
     bool isInput;
@@ -81,6 +87,38 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
     m_pMasterAudioLatencyOverload = new ControlProxy("[Master]",
             "audio_latency_overload");
 
+    // Callback durations in microseconds
+    m_pCallbackTimingP50 = new ControlObject(
+            ConfigKey("[Master]", "audio_callback_duration_p50"));
+    m_pCallbackTimingP99 = new ControlObject(
+            ConfigKey("[Master]", "audio_callback_duration_p99"));
+    m_pCallbackTimingP999 = new ControlObject(
+            ConfigKey("[Master]", "audio_callback_duration_p999"));
+    m_pCallbackTimingMax = new ControlObject(
+            ConfigKey("[Master]", "audio_callback_duration_max"));
+    m_pCallbackTimingXrunCount = new ControlObject(
+            ConfigKey("[Master]", "audio_callback_xrun_count"));
+    m_pCallbackTimingP50->setReadOnly();
+    m_pCallbackTimingP99->setReadOnly();
+    m_pCallbackTimingP999->setReadOnly();
+    m_pCallbackTimingMax->setReadOnly();
+    m_pCallbackTimingXrunCount->setReadOnly();
+
+    // Writes the statistics and the callbacks before the last xruns
+    // to a file in the settings directory.
+    m_pCallbackTimingDump = new ControlPushButton(
+            ConfigKey("[Master]", "audio_callback_timing_dump"));
+    connect(m_pCallbackTimingDump, SIGNAL(valueChanged(double)),
+            this, SLOT(slotDumpCallbackTiming(double)));
+    m_pCallbackTimingReset = new ControlPushButton(
+            ConfigKey("[Master]", "audio_callback_timing_reset"));
+    connect(m_pCallbackTimingReset, SIGNAL(valueChanged(double)),
+            this, SLOT(slotResetCallbackTiming(double)));
+
+    connect(&m_callbackTimingUpdateTimer, SIGNAL(timeout()),
+            this, SLOT(slotUpdateCallbackTimingControls()));
+    m_callbackTimingUpdateTimer.start(kCallbackTimingUpdateIntervalMillis);
+
     //Hack because PortAudio samplerate enumeration is slow as hell on Linux (ALSA dmix sucks, so we can't blame PortAudio)
     m_samplerates.push_back(44100);
     m_samplerates.push_back(48000);
@@ -114,6 +152,13 @@ SoundManager::~SoundManager() {
     delete m_pControlObjectVinylControlGainCO;
     delete m_pMasterAudioLatencyOverloadCount;
     delete m_pMasterAudioLatencyOverload;
+    delete m_pCallbackTimingP50;
+    delete m_pCallbackTimingP99;
+    delete m_pCallbackTimingP999;
+    delete m_pCallbackTimingMax;
+    delete m_pCallbackTimingXrunCount;
+    delete m_pCallbackTimingDump;
+    delete m_pCallbackTimingReset;
 }
 
 QList<SoundDevicePointer> SoundManager::getDeviceList(
@@ -585,13 +630,59 @@ void SoundManager::onDeviceOutputCallback(const SINT iFramesPerBuffer) {
 
 void SoundManager::pushInputBuffers(const QList<AudioInputBuffer>& inputs,
                                     const SINT iFramesPerBuffer) {
-   for (QList<AudioInputBuffer>::ConstIterator i = inputs.begin(),
+    for (QList<AudioInputBuffer>::ConstIterator i = inputs.begin(),
                  e = inputs.end(); i != e; ++i) {
         const AudioInputBuffer& in = *i;
         CSAMPLE* pInputBuffer = in.getBuffer();
+        // The buffer has already been composed by the device
+        const AudioInputView view(pInputBuffer, 2, 2);
         for (auto it = m_registeredDestinations.constFind(in);
              it != m_registeredDestinations.constEnd() && it.key() == in; ++it) {
-            it.value()->receiveBuffer(in, pInputBuffer, iFramesPerBuffer);
+            AudioDestination* pDestination = it.value();
+            if (pDestination->receivesInputViews()) {
+                pDestination->receiveView(in, view, iFramesPerBuffer);
+            } else {
+                pDestination->receiveBuffer(in, pInputBuffer, iFramesPerBuffer);
+            }
+        }
+    }
+}
+
+void SoundManager::pushInputViews(const QList<AudioInputBuffer>& inputs,
+                                  const CSAMPLE* pDeviceBuffer,
+                                  const SINT iFramesPerBuffer,
+                                  const int iFrameSize) {
+    pushInputViews(m_registeredDestinations, inputs, pDeviceBuffer,
+            iFramesPerBuffer, iFrameSize);
+}
+
+// static
+void SoundManager::pushInputViews(
+        const QHash<AudioInput, AudioDestination*>& destinations,
+        const QList<AudioInputBuffer>& inputs,
+        const CSAMPLE* pDeviceBuffer,
+        const SINT iFramesPerBuffer,
+        const int iFrameSize) {
+    for (QList<AudioInputBuffer>::ConstIterator i = inputs.begin(),
+                 e = inputs.end(); i != e; ++i) {
+        const AudioInputBuffer& in = *i;
+        const ChannelGroup chanGroup = in.getChannelGroup();
+        const AudioInputView view(&pDeviceBuffer[chanGroup.getChannelBase()],
+                iFrameSize, math_min<int>(chanGroup.getChannelCount(), 2));
+        // Composed on demand, at most once per input
+        CSAMPLE* pInputBuffer = NULL;
+        for (auto it = destinations.constFind(in);
+             it != destinations.constEnd() && it.key() == in; ++it) {
+            AudioDestination* pDestination = it.value();
+            if (pDestination->receivesInputViews()) {
+                pDestination->receiveView(in, view, iFramesPerBuffer);
+                continue;
+            }
+            if (!pInputBuffer) {
+                pInputBuffer = in.getBuffer();
+                view.copyStereo(pInputBuffer, 0, iFramesPerBuffer);
+            }
+            pDestination->receiveBuffer(in, pInputBuffer, iFramesPerBuffer);
         }
     }
 }
@@ -692,3 +783,32 @@ void SoundManager::processUnderflowHappened() {
         --m_underflowUpdateCount;
     }
 }
+
+void SoundManager::slotUpdateCallbackTimingControls() {
+    m_callbackTimingRecorder.collectXrunReports();
+    const CallbackTimingRecorder::Statistics stats =
+            m_callbackTimingRecorder.statistics();
+    m_pCallbackTimingP50->forceSet(stats.p50Micros);
+    m_pCallbackTimingP99->forceSet(stats.p99Micros);
+    m_pCallbackTimingP999->forceSet(stats.p999Micros);
+    m_pCallbackTimingMax->forceSet(stats.maxMicros);
+    m_pCallbackTimingXrunCount->forceSet(stats.xrunCount);
+}
+
+void SoundManager::slotDumpCallbackTiming(double v) {
+    if (v <= 0) {
+        return;
+    }
+    const QString fileName = QDir(m_pConfig->getSettingsPath())
+            .filePath("audio_callback_timing.txt");
+    if (m_callbackTimingRecorder.dumpToFile(fileName)) {
+        qDebug() << "Audio callback timing written to" << fileName;
+    }
+}
+
+void SoundManager::slotResetCallbackTiming(double v) {
+    if (v <= 0) {
+        return;
+    }
+    m_callbackTimingRecorder.requestReset();
+}
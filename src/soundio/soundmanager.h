@@ -21,12 +21,14 @@
 
 #include <QObject>
 #include <QString>
+#include <QTimer>
 #include <QList>
 #include <QHash>
 #include <QSharedPointer>
 
 #include "preferences/usersettings.h"
 #include "engine/sidechain/enginenetworkstream.h"
+#include "soundio/callbacktimingrecorder.h"
 #include "soundio/soundmanagerconfig.h"
 #include "soundio/sounddevice.h"
 #include "util/types.h"
@@ -40,6 +42,7 @@ class AudioSource;
 class AudioDestination;
 class ControlObject;
 class ControlProxy;
+class ControlPushButton;
 class SoundDeviceNotFound;
 
 #define MIXXX_PORTAUDIO_JACK_STRING "JACK Audio Connection Kit"
@@ -103,6 +106,23 @@ class SoundManager : public QObject {
     void pushInputBuffers(const QList<AudioInputBuffer>& inputs,
                           const SINT iFramesPerBuffer);
 
+    // Like pushInputBuffers, but for inputs that have not been composed yet.
+    // Destinations that accept views read the samples straight from the
+    // interleaved pDeviceBuffer, the inputs are only copied to their buffers
+    // for destinations that need contiguous stereo samples.
+    void pushInputViews(const QList<AudioInputBuffer>& inputs,
+                        const CSAMPLE* pDeviceBuffer,
+                        const SINT iFramesPerBuffer,
+                        const int iFrameSize);
+    // The routing of pushInputViews() for the given destinations. It
+    // doesn't depend on the state of SoundManager or any device.
+    static void pushInputViews(
+            const QHash<AudioInput, AudioDestination*>& destinations,
+            const QList<AudioInputBuffer>& inputs,
+            const CSAMPLE* pDeviceBuffer,
+            const SINT iFramesPerBuffer,
+            const int iFrameSize);
+
 
     void writeProcess() const;
     void readProcess() const;
@@ -116,8 +136,14 @@ class SoundManager : public QObject {
         return m_pNetworkStream;
     }
 
+    // The timing of the callbacks of the clock reference device
+    CallbackTimingRecorder* getCallbackTimingRecorder() {
+        return &m_callbackTimingRecorder;
+    }
+
     void underflowHappened(int code) {
         m_underflowHappened = 1;
+        m_callbackTimingRecorder.reportXrun(code);
         // Disable the engine warnings by default, because printing a warning is a
         // locking function that will make the problem worse
         if (CmdlineArgs::Instance().getDeveloper()) {
@@ -133,6 +159,11 @@ class SoundManager : public QObject {
     void outputRegistered(AudioOutput output, AudioSource *src);
     void inputRegistered(AudioInput input, AudioDestination *dest);
 
+  private slots:
+    void slotUpdateCallbackTimingControls();
+    void slotDumpCallbackTiming(double v);
+    void slotResetCallbackTiming(double v);
+
   private:
     // Closes all the devices and empties the list of devices we have.
     void clearDeviceList(bool sleepAfterClosing);
@@ -166,6 +197,16 @@ class SoundManager : public QObject {
     int m_underflowUpdateCount;
     ControlProxy* m_pMasterAudioLatencyOverloadCount;
     ControlProxy* m_pMasterAudioLatencyOverload;
+
+    CallbackTimingRecorder m_callbackTimingRecorder;
+    QTimer m_callbackTimingUpdateTimer;
+    ControlObject* m_pCallbackTimingP50;
+    ControlObject* m_pCallbackTimingP99;
+    ControlObject* m_pCallbackTimingP999;
+    ControlObject* m_pCallbackTimingMax;
+    ControlObject* m_pCallbackTimingXrunCount;
+    ControlPushButton* m_pCallbackTimingDump;
+    ControlPushButton* m_pCallbackTimingReset;
 };
 
 #endif
@@ -16,6 +16,7 @@
 #include "soundio/soundmanagerutil.h"
 
 #include "engine/channels/enginechannel.h"
+#include "util/sample.h"
 
 /**
  * Constructs a ChannelGroup.
@@ -464,6 +465,41 @@ void AudioInput::setType(AudioPathType type) {
     }
 }
 
+void AudioInputView::copyStereo(CSAMPLE* pDest, SINT iFrameOffset,
+                                SINT iFrames) const {
+    const CSAMPLE* pSrc = &m_pData[iFrameOffset * m_frameSize];
+    if (m_frameSize == 2 && m_channelCount == 2) {
+        SampleUtil::copy(pDest, pSrc, iFrames * 2);
+    } else if (m_channelCount == 1) {
+        for (SINT iFrameNo = 0; iFrameNo < iFrames; ++iFrameNo) {
+            const CSAMPLE sample = pSrc[iFrameNo * m_frameSize];
+            pDest[iFrameNo * 2] = sample;
+            pDest[iFrameNo * 2 + 1] = sample;
+        }
+    } else {
+        for (SINT iFrameNo = 0; iFrameNo < iFrames; ++iFrameNo) {
+            pDest[iFrameNo * 2] = pSrc[iFrameNo * m_frameSize];
+            pDest[iFrameNo * 2 + 1] = pSrc[iFrameNo * m_frameSize + 1];
+        }
+    }
+}
+
+SINT AudioInputView::writeStereo(FIFO<CSAMPLE>* pFifo, SINT iFrames) const {
+    CSAMPLE* dataPtr1;
+    ring_buffer_size_t size1;
+    CSAMPLE* dataPtr2;
+    ring_buffer_size_t size2;
+    // The FIFO only ever holds whole stereo frames, so both regions do
+    const int samplesWritable = pFifo->aquireWriteRegions(iFrames * 2,
+            &dataPtr1, &size1, &dataPtr2, &size2);
+    copyStereo(dataPtr1, 0, size1 / 2);
+    if (size2 > 0) {
+        copyStereo(dataPtr2, size1 / 2, size2 / 2);
+    }
+    pFifo->releaseWriteRegions(samplesWritable);
+    return samplesWritable / 2;
+}
+
 /**
  * Defined for QHash, so ChannelGroup can be used as a QHash key.
  */
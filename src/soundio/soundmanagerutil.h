@@ -160,6 +160,34 @@ class AudioInputBuffer : public AudioInput {
     CSAMPLE* m_pBuffer;
 };
 
+// A view of the samples of an AudioInput in the interleaved buffer of a sound
+// device, without copying them. Channel c of frame i is at
+// getData()[i * getFrameSize() + c]. A mono input is read as a stereo signal
+// with both channels equal, like the copied AudioInputBuffers.
+class AudioInputView {
+  public:
+    AudioInputView(const CSAMPLE* pData, int frameSize, int channelCount)
+            : m_pData(pData),
+              m_frameSize(frameSize),
+              m_channelCount(channelCount) {
+    }
+    inline const CSAMPLE* getData() const { return m_pData; }
+    inline int getFrameSize() const { return m_frameSize; }
+    inline int getChannelCount() const { return m_channelCount; }
+
+    // Copies iFrames stereo frames starting at iFrameOffset to pDest.
+    void copyStereo(CSAMPLE* pDest, SINT iFrameOffset, SINT iFrames) const;
+
+    // Writes iFrames stereo frames to pFifo and returns the number of frames
+    // that fit.
+    SINT writeStereo(FIFO<CSAMPLE>* pFifo, SINT iFrames) const;
+
+  private:
+    const CSAMPLE* m_pData;
+    int m_frameSize;
+    int m_channelCount;
+};
+
 
 class AudioSource {
 public:
@@ -184,6 +212,20 @@ public:
     virtual void receiveBuffer(AudioInput input, const CSAMPLE* pBuffer,
                                unsigned int iNumFrames) = 0;
 
+    // Destinations that are done with the samples when receiving returns can
+    // read them straight from the device buffer. If this returns true,
+    // SoundManager calls receiveView() instead of receiveBuffer() and skips
+    // copying the input to a contiguous stereo buffer for this destination.
+    virtual bool receivesInputViews() const { return false; }
+
+    // Like receiveBuffer(), but the view is only valid during the call.
+    virtual void receiveView(AudioInput input, const AudioInputView& view,
+                             unsigned int iNumFrames) {
+        Q_UNUSED(input);
+        Q_UNUSED(view);
+        Q_UNUSED(iNumFrames);
+    }
+
     // This is called by SoundManager whenever an input is configured for this
     // destination. When this is called it is guaranteed that no callback is
     // active.
@@ -199,6 +199,20 @@ class AudioSource: public UrlResource, public AudioSignal, public virtual /*impl
 
         using AudioSignal::setChannelCount;
         using AudioSignal::setSampleRate;
+
+        // Decoders that need to scan the whole file for building a
+        // seek index may persist this index in the given directory.
+        // Reopening the file loads the persisted index instead of
+        // scanning it again. Disabled if empty.
+        const QString& seekIndexDir() const {
+            return m_seekIndexDir;
+        }
+        void setSeekIndexDir(const QString& seekIndexDir) {
+            m_seekIndexDir = seekIndexDir;
+        }
+
+      private:
+        QString m_seekIndexDir;
     };
 
     // Opens the AudioSource for reading audio data.
@@ -0,0 +1,304 @@
+#include "sources/mp3seekindex.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("Mp3SeekIndex");
+
+const char kFileMagic[8] = { 'M', 'I', 'X', 'X', 'X', 'M', 'P', '3' };
+const quint32 kFileVersion = 1;
+const QString kFileSuffix = QStringLiteral(".mp3idx");
+
+// Tags are stored at the beginning (ID3v2) or at the end (ID3v1, APE)
+// of MP3 files. Modifying them moves the MP3 frames or changes the
+// file size.
+const quint64 kHashedBytes = 64 * 1024;
+
+// An index needs 8 bytes per MP3 frame, i.e. ~1.1 MiB per hour
+const qint64 kMaxTotalSize = 64 * 1024 * 1024;
+
+// Number of frame headers that are verified when loading an index
+const quint64 kVerifiedFrameCount = 16;
+
+} // anonymous namespace
+
+struct Mp3SeekIndex::Header {
+    char magic[8];
+    quint32 version;
+    quint32 sampleRate;
+    quint32 channelCount;
+    quint32 bitrate;
+    quint64 fileSize;
+    quint64 frameCount;
+    qint64 frameLength;
+    qint64 lastAccessMSecsSinceEpoch;
+};
+
+// The differences to the preceding frame, or to the beginning of the
+// file and the audio stream for the first frame.
+struct Mp3SeekIndex::Entry {
+    quint32 frameIndexDelta;
+    quint32 byteOffsetDelta;
+};
+
+Mp3SeekIndex::Mp3SeekIndex(
+        const QString& dirPath,
+        const unsigned char* pFileData,
+        quint64 fileSize)
+        : sampleRate(0),
+          channelCount(0),
+          bitrate(0),
+          frameLength(0),
+          m_dirPath(dirPath),
+          m_pFileData(pFileData),
+          m_fileSize(fileSize) {
+    DEBUG_ASSERT(m_pFileData || (m_fileSize == 0));
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(m_fileSize));
+    const quint64 headBytes = math_min(m_fileSize, kHashedBytes);
+    hash.addData(reinterpret_cast<const char*>(m_pFileData), headBytes);
+    const quint64 tailBytes = math_min(m_fileSize - headBytes, kHashedBytes);
+    hash.addData(reinterpret_cast<const char*>(m_pFileData + m_fileSize - tailBytes),
+            tailBytes);
+    m_filePath = QDir(m_dirPath).absoluteFilePath(
+            QString::fromLatin1(hash.result().toHex()) + kFileSuffix);
+}
+
+bool Mp3SeekIndex::isValid(const Header& header) const {
+    return (std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) == 0) &&
+            (header.version == kFileVersion) &&
+            (header.fileSize == m_fileSize) &&
+            (header.sampleRate > 0) &&
+            (header.channelCount > 0) &&
+            (header.frameCount > 0) &&
+            (header.frameLength > 0);
+}
+
+bool Mp3SeekIndex::isFrameHeaderAt(quint64 byteOffset) const {
+    // All frame headers start with 11 set bits for synchronization
+    return ((byteOffset + 1) < m_fileSize) &&
+            (m_pFileData[byteOffset] == 0xFF) &&
+            ((m_pFileData[byteOffset + 1] & 0xE0) == 0xE0);
+}
+
+bool Mp3SeekIndex::load() {
+    QFile file(m_filePath);
+    if (!file.exists()) {
+        return false;
+    }
+    // Read-only index files are still usable, but their access time
+    // can't be updated
+    if (!file.open(QIODevice::ReadWrite) && !file.open(QIODevice::ReadOnly)) {
+        kLogger.warning()
+                << "Failed to open index file"
+                << m_filePath;
+        return false;
+    }
+    Header header;
+    if ((file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)) ||
+            !isValid(header) ||
+            (file.size() != static_cast<qint64>(
+                    sizeof(Header) + header.frameCount * sizeof(Entry)))) {
+        kLogger.warning()
+                << "Discarding invalid index file"
+                << m_filePath;
+        file.close();
+        file.remove();
+        return false;
+    }
+    std::vector<Entry> entries(header.frameCount);
+    const qint64 entryBytes = entries.size() * sizeof(Entry);
+    if (file.read(reinterpret_cast<char*>(entries.data()), entryBytes) != entryBytes) {
+        kLogger.warning()
+                << "Failed to read index file"
+                << m_filePath;
+        return false;
+    }
+
+    frames.clear();
+    frames.reserve(entries.size());
+    Frame frame;
+    frame.frameIndex = 0;
+    frame.byteOffset = 0;
+    for (const auto& entry : entries) {
+        frame.frameIndex += entry.frameIndexDelta;
+        frame.byteOffset += entry.byteOffsetDelta;
+        if ((!frames.empty() &&
+                    ((frame.frameIndex <= frames.back().frameIndex) ||
+                            (frame.byteOffset <= frames.back().byteOffset))) ||
+                (frame.frameIndex >= header.frameLength) ||
+                (frame.byteOffset >= m_fileSize)) {
+            kLogger.warning()
+                    << "Discarding inconsistent index file"
+                    << m_filePath;
+            frames.clear();
+            file.close();
+            file.remove();
+            return false;
+        }
+        frames.push_back(frame);
+    }
+    // Collisions of the hash are unlikely, but verifying a few samples
+    // that are spread over the whole file is cheap
+    const quint64 verifyStep = math_max<quint64>(frames.size() / kVerifiedFrameCount, 1);
+    for (quint64 i = 0; i < frames.size(); i += verifyStep) {
+        if (!isFrameHeaderAt(frames[i].byteOffset)) {
+            kLogger.warning()
+                    << "Index file"
+                    << m_filePath
+                    << "does not match the MP3 frames";
+            frames.clear();
+            return false;
+        }
+    }
+
+    sampleRate = header.sampleRate;
+    channelCount = header.channelCount;
+    bitrate = header.bitrate;
+    frameLength = header.frameLength;
+
+    if (file.isWritable()) {
+        const qint64 lastAccessMSecsSinceEpoch =
+                QDateTime::currentMSecsSinceEpoch();
+        if (!file.seek(offsetof(Header, lastAccessMSecsSinceEpoch)) ||
+                (file.write(reinterpret_cast<const char*>(&lastAccessMSecsSinceEpoch),
+                         sizeof(lastAccessMSecsSinceEpoch)) !=
+                        sizeof(lastAccessMSecsSinceEpoch))) {
+            kLogger.warning()
+                    << "Failed to update access time of index file"
+                    << m_filePath;
+        }
+    }
+    return true;
+}
+
+bool Mp3SeekIndex::save() {
+    VERIFY_OR_DEBUG_ASSERT(!frames.empty() && (frameLength > 0)) {
+        return false;
+    }
+    const QDir dir(m_dirPath);
+    if (!dir.exists() && !QDir().mkpath(dir.absolutePath())) {
+        kLogger.warning()
+                << "Failed to create index directory"
+                << dir.absolutePath();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+    header.version = kFileVersion;
+    header.sampleRate = sampleRate;
+    header.channelCount = channelCount;
+    header.bitrate = bitrate;
+    header.fileSize = m_fileSize;
+    header.frameCount = frames.size();
+    header.frameLength = frameLength;
+    header.lastAccessMSecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+
+    std::vector<Entry> entries;
+    entries.reserve(frames.size());
+    Frame prevFrame;
+    prevFrame.frameIndex = 0;
+    prevFrame.byteOffset = 0;
+    for (const auto& frame : frames) {
+        // MP3 frames are short and contiguous, only junk data between
+        // them might take up more than a few bytes
+        VERIFY_OR_DEBUG_ASSERT((frame.frameIndex - prevFrame.frameIndex) <=
+                        std::numeric_limits<quint32>::max() &&
+                (frame.byteOffset - prevFrame.byteOffset) <=
+                        std::numeric_limits<quint32>::max()) {
+            return false;
+        }
+        Entry entry;
+        entry.frameIndexDelta = frame.frameIndex - prevFrame.frameIndex;
+        entry.byteOffsetDelta = frame.byteOffset - prevFrame.byteOffset;
+        entries.push_back(entry);
+        prevFrame = frame;
+    }
+
+    // Writing into a temporary file prevents that concurrent readers
+    // see a partially written index
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to create index file"
+                << m_filePath;
+        return false;
+    }
+    const qint64 entryBytes = entries.size() * sizeof(Entry);
+    if ((file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) ||
+            (file.write(reinterpret_cast<const char*>(entries.data()), entryBytes) != entryBytes) ||
+            !file.commit()) {
+        kLogger.warning()
+                << "Failed to write index file"
+                << m_filePath;
+        return false;
+    }
+
+    evictLeastRecentlyUsed();
+    return true;
+}
+
+void Mp3SeekIndex::evictLeastRecentlyUsed() const {
+    struct IndexFile {
+        QString filePath;
+        qint64 size;
+        qint64 lastAccess;
+    };
+    std::vector<IndexFile> indexFiles;
+    qint64 totalSize = 0;
+    const QFileInfoList fileInfos = QDir(m_dirPath).entryInfoList(
+            QStringList() << (QStringLiteral("*") + kFileSuffix), QDir::Files);
+    for (const auto& fileInfo : fileInfos) {
+        QFile file(fileInfo.absoluteFilePath());
+        Header header;
+        if (!file.open(QIODevice::ReadOnly) ||
+                (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header))) {
+            continue;
+        }
+        totalSize += fileInfo.size();
+        if (fileInfo.absoluteFilePath() != m_filePath) {
+            indexFiles.push_back(IndexFile{
+                    fileInfo.absoluteFilePath(),
+                    fileInfo.size(),
+                    header.lastAccessMSecsSinceEpoch});
+        }
+    }
+    if (totalSize <= kMaxTotalSize) {
+        return;
+    }
+
+    std::sort(indexFiles.begin(), indexFiles.end(),
+            [](const IndexFile& lhs, const IndexFile& rhs) {
+                return lhs.lastAccess < rhs.lastAccess;
+            });
+    for (const auto& indexFile : indexFiles) {
+        if (totalSize <= kMaxTotalSize) {
+            break;
+        }
+        if (QFile::remove(indexFile.filePath)) {
+            kLogger.debug()
+                    << "Evicted index file"
+                    << indexFile.filePath;
+            totalSize -= indexFile.size;
+        }
+    }
+}
+
+} // namespace mixxx
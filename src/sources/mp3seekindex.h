@@ -0,0 +1,79 @@
+#ifndef MIXXX_MP3SEEKINDEX_H
+#define MIXXX_MP3SEEKINDEX_H
+
+#include <QString>
+
+#include <vector>
+
+#include "util/types.h"
+
+namespace mixxx {
+
+// Persists the positions of all frames in an MP3 file that are
+// collected by scanning the whole file when opening it. Reopening
+// the same file only needs to load the index instead of decoding
+// the headers of all frames again, which takes a noticeable amount
+// of time for long files.
+//
+// Index files are keyed by the size of the MP3 file and a hash of
+// its first and last bytes where tags are stored, i.e. moving a file
+// keeps its index valid while editing its tags invalidates it. The
+// total size of all index files in a directory is bounded by evicting
+// the least recently used files.
+//
+// Not thread-safe. Concurrent instances may access the same directory.
+class Mp3SeekIndex {
+  public:
+    struct Frame {
+        // The index of the first sample frame
+        SINT frameIndex;
+        // The position of the frame header relative to the beginning
+        // of the file
+        quint64 byteOffset;
+    };
+
+    // The file data needs to stay valid during the lifetime of this
+    // object.
+    Mp3SeekIndex(
+            const QString& dirPath,
+            const unsigned char* pFileData,
+            quint64 fileSize);
+
+    // Loads a persisted index for the file. Returns false if no
+    // valid index exists.
+    bool load();
+
+    // Persists the index for the file, replacing an existing index.
+    bool save();
+
+    const QString& filePath() const {
+        return m_filePath;
+    }
+
+    SINT sampleRate;
+    SINT channelCount;
+    // in kbps, 0 if unknown
+    SINT bitrate;
+    // The total number of sample frames
+    SINT frameLength;
+    // Ordered by frame index
+    std::vector<Frame> frames;
+
+  private:
+    struct Header;
+    struct Entry;
+
+    bool isValid(const Header& header) const;
+    bool isFrameHeaderAt(quint64 byteOffset) const;
+
+    void evictLeastRecentlyUsed() const;
+
+    const QString m_dirPath;
+    const unsigned char* const m_pFileData;
+    const quint64 m_fileSize;
+    QString m_filePath;
+};
+
+} // namespace mixxx
+
+#endif // MIXXX_MP3SEEKINDEX_H
@@ -3,6 +3,7 @@
 
 #include "util/math.h"
 #include "util/logger.h"
+#include "util/memory.h"
 
 #include <id3tag.h>
 
@@ -193,7 +194,7 @@ void SoundSourceMp3::finishDecoding() {
 
 SoundSource::OpenResult SoundSourceMp3::tryOpen(
         OpenMode /*mode*/,
-        const OpenParams& /*config*/) {
+        const OpenParams& params) {
     DEBUG_ASSERT(!channelCount().valid());
     DEBUG_ASSERT(!sampleRate().valid());
 
@@ -213,14 +214,27 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     // described in the following bug report:
     // https://bugs.launchpad.net/mixxx/+bug/1452005
 
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    m_avgSeekFrameCount = 0;
+    m_curFrameIndex = 0;
+
+    std::unique_ptr<Mp3SeekIndex> pSeekIndex;
+    if (m_pFileData && !params.seekIndexDir().isEmpty()) {
+        pSeekIndex = std::make_unique<Mp3SeekIndex>(
+                params.seekIndexDir(), m_pFileData, m_fileSize);
+        if (pSeekIndex->load()) {
+            if (initFromSeekIndex(*pSeekIndex)) {
+                return finishOpening();
+            }
+            // Scan the file again and replace the index
+        }
+    }
+
     // Transfer it to the mad stream-buffer:
     mad_stream_options(&m_madStream, MAD_OPTION_IGNORECRC);
     mad_stream_buffer(&m_madStream, m_pFileData, m_fileSize);
     DEBUG_ASSERT(m_pFileData == m_madStream.this_frame);
 
-    DEBUG_ASSERT(m_seekFrameList.empty());
-    m_avgSeekFrameCount = 0;
-    m_curFrameIndex = 0;
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -383,8 +397,6 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
 
     // Calculate average values
-    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
-    m_avgSeekFrameCount = frameLength() / m_seekFrameList.size();
     if (cntBitrateFrames > 0) {
         const unsigned long avgBitrate = sumBitrateFrames / cntBitrateFrames;
         initBitrateOnce(avgBitrate / 1000); // bps -> kbps
@@ -392,8 +404,63 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         kLogger.warning() << "Bitrate cannot be calculated from headers";
     }
 
+    if (pSeekIndex) {
+        saveSeekIndex(pSeekIndex.get());
+    }
+
+    return finishOpening();
+}
+
+bool SoundSourceMp3::initFromSeekIndex(const Mp3SeekIndex& seekIndex) {
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    // The index has been verified against the file, but not
+    // its audio properties
+    if ((getIndexBySampleRate(SampleRate(seekIndex.sampleRate)) >= kSampleRateCount) ||
+            (seekIndex.channelCount > kChannelCountMax) ||
+            (seekIndex.frames.front().frameIndex != 0)) {
+        kLogger.warning()
+                << "Ignoring invalid seek index"
+                << seekIndex.filePath()
+                << "for file"
+                << m_file.fileName();
+        return false;
+    }
+    // Including the terminating seek frame
+    m_seekFrameList.reserve(seekIndex.frames.size() + 1);
+    for (const auto& frame : seekIndex.frames) {
+        addSeekFrame(frame.frameIndex, m_pFileData + frame.byteOffset);
+    }
+    setSampleRate(SampleRate(seekIndex.sampleRate));
+    setChannelCount(ChannelCount(seekIndex.channelCount));
+    initFrameIndexRangeOnce(IndexRange::forward(0, seekIndex.frameLength));
+    if (seekIndex.bitrate > 0) {
+        initBitrateOnce(seekIndex.bitrate);
+    }
+    return true;
+}
+
+void SoundSourceMp3::saveSeekIndex(Mp3SeekIndex* pSeekIndex) const {
+    pSeekIndex->sampleRate = sampleRate();
+    pSeekIndex->channelCount = channelCount();
+    pSeekIndex->bitrate = bitrate();
+    pSeekIndex->frameLength = frameLength();
+    pSeekIndex->frames.clear();
+    pSeekIndex->frames.reserve(m_seekFrameList.size());
+    for (const auto& seekFrame : m_seekFrameList) {
+        Mp3SeekIndex::Frame frame;
+        frame.frameIndex = seekFrame.frameIndex;
+        frame.byteOffset = seekFrame.pInputData - m_pFileData;
+        pSeekIndex->frames.push_back(frame);
+    }
+    pSeekIndex->save();
+}
+
+SoundSource::OpenResult SoundSourceMp3::finishOpening() {
+    DEBUG_ASSERT(m_seekFrameList.size() > 0);
+    m_avgSeekFrameCount = frameLength() / m_seekFrameList.size();
+
     // Terminate m_seekFrameList
-    addSeekFrame(m_curFrameIndex, 0);
+    addSeekFrame(frameIndexMax(), 0);
     DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
 
     // Restart decoding at the beginning of the audio stream
@@ -2,6 +2,7 @@
 #define MIXXX_SOUNDSOURCEMP3_H
 
 #include "sources/soundsourceprovider.h"
+#include "sources/mp3seekindex.h"
 
 #ifdef _MSC_VER
 // So mad.h doesn't try to use inline assembly which MSVC doesn't support.
@@ -33,6 +34,11 @@ class SoundSourceMp3 final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    bool initFromSeekIndex(const Mp3SeekIndex& seekIndex);
+    void saveSeekIndex(Mp3SeekIndex* pSeekIndex) const;
+    // Terminates the list of seek frames and starts decoding
+    OpenResult finishOpening();
+
     QFile m_file;
     quint64 m_fileSize;
     unsigned char* m_pFileData;
@@ -43,10 +49,9 @@ class SoundSourceMp3 final : public SoundSource {
         const unsigned char* pInputData;
     };
 
-    /** It is not possible to make a precise seek in an mp3 file without decoding the whole stream.
-     * To have precise seek within a limited range from the current decode position, we keep track
-     * of past decoded frame, and their exact position. If a seek occurs and it is within the
-     * range of frames we keep track of a precise seek occurs, otherwise an imprecise seek is performed
+    /** It is not possible to make a precise seek in an mp3 file without knowing the position
+     * of all frames. The positions are collected by scanning the whole file when opening it or
+     * loaded from a persisted Mp3SeekIndex.
      */
     typedef std::vector<SeekFrameType> SeekFrameList;
     SeekFrameList m_seekFrameList; // ordered-by frameIndex
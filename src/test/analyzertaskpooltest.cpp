@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include <QThread>
+
+#include "analyzer/analyzertaskpool.h"
+#include "util/memory.h"
+
+namespace {
+
+class TaskSubmitterThread : public QThread {
+  public:
+    TaskSubmitterThread(AnalyzerTaskPool* pPool, int queueIndex, int batchCount)
+            : m_pPool(pPool),
+              m_queueIndex(queueIndex),
+              m_batchCount(batchCount),
+              m_counters(5),
+              m_failedBatches(0) {
+    }
+
+    int failedBatches() const {
+        return m_failedBatches;
+    }
+
+  protected:
+    void run() override {
+        std::vector<AnalyzerTaskPool::Task> tasks;
+        for (auto& counter : m_counters) {
+            int* pCounter = &counter;
+            tasks.push_back([pCounter] {
+                ++(*pCounter);
+            });
+        }
+        for (int batch = 1; batch <= m_batchCount; ++batch) {
+            m_pPool->run(m_queueIndex, &tasks);
+            // All tasks have finished when returning from run()
+            for (const auto& counter : m_counters) {
+                if (counter != batch) {
+                    ++m_failedBatches;
+                    break;
+                }
+            }
+        }
+    }
+
+  private:
+    AnalyzerTaskPool* const m_pPool;
+    const int m_queueIndex;
+    const int m_batchCount;
+    std::vector<int> m_counters;
+    int m_failedBatches;
+};
+
+TEST(AnalyzerTaskPoolTest, RunWithoutHelperThreads) {
+    AnalyzerTaskPool pool(1, 0);
+    int sum = 0;
+    std::vector<AnalyzerTaskPool::Task> tasks;
+    for (int i = 1; i <= 10; ++i) {
+        tasks.push_back([&sum, i] {
+            sum += i;
+        });
+    }
+    pool.run(0, &tasks);
+    EXPECT_EQ(55, sum);
+}
+
+TEST(AnalyzerTaskPoolTest, TasksAreStolen) {
+    AnalyzerTaskPool pool(1, 2);
+    ASSERT_EQ(2, pool.helperThreadCount());
+    const Qt::HANDLE callingThread = QThread::currentThreadId();
+    std::atomic<int> stolenTasks(0);
+    std::vector<AnalyzerTaskPool::Task> tasks;
+    for (int i = 0; i < 4; ++i) {
+        tasks.push_back([&stolenTasks, callingThread] {
+            // Give the helper threads a chance to steal
+            QThread::msleep(20);
+            if (QThread::currentThreadId() != callingThread) {
+                ++stolenTasks;
+            }
+        });
+    }
+    pool.run(0, &tasks);
+    EXPECT_LT(0, stolenTasks.load());
+}
+
+TEST(AnalyzerTaskPoolTest, ConcurrentBatches) {
+    const int kQueueCount = 4;
+    AnalyzerTaskPool pool(kQueueCount, 2);
+    std::vector<std::unique_ptr<TaskSubmitterThread>> threads;
+    for (int i = 0; i < kQueueCount; ++i) {
+        threads.push_back(std::make_unique<TaskSubmitterThread>(&pool, i, 1000));
+        threads.back()->start();
+    }
+    for (const auto& pThread : threads) {
+        pThread->wait();
+        EXPECT_EQ(0, pThread->failedBatches());
+    }
+}
+
+}  // namespace
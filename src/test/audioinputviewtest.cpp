@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "soundio/soundmanagerutil.h"
+#include "util/fifo.h"
+#include "util/types.h"
+
+namespace {
+
+const int kFrames = 64;
+
+class AudioInputViewTest : public testing::Test {
+  protected:
+    // An interleaved device buffer with the given number of channels, where
+    // each sample encodes its frame and channel.
+    std::vector<CSAMPLE> makeDeviceBuffer(int frameSize) const {
+        std::vector<CSAMPLE> buffer(kFrames * frameSize);
+        for (int i = 0; i < kFrames; ++i) {
+            for (int c = 0; c < frameSize; ++c) {
+                buffer[i * frameSize + c] = sampleAt(i, c);
+            }
+        }
+        return buffer;
+    }
+
+    static CSAMPLE sampleAt(int frame, int channel) {
+        return frame + channel / 10.0f;
+    }
+};
+
+TEST_F(AudioInputViewTest, CopyContiguousStereo) {
+    std::vector<CSAMPLE> device = makeDeviceBuffer(2);
+    std::vector<CSAMPLE> output(kFrames * 2);
+    AudioInputView view(device.data(), 2, 2);
+    view.copyStereo(output.data(), 0, kFrames);
+    EXPECT_EQ(device, output);
+}
+
+TEST_F(AudioInputViewTest, CopyStridedStereo) {
+    std::vector<CSAMPLE> device = makeDeviceBuffer(8);
+    std::vector<CSAMPLE> output(kFrames * 2);
+    // The second input of a four channel pair device
+    AudioInputView view(&device[4], 8, 2);
+    view.copyStereo(output.data(), 3, kFrames - 3);
+    for (int i = 0; i < kFrames - 3; ++i) {
+        EXPECT_EQ(sampleAt(i + 3, 4), output[i * 2]);
+        EXPECT_EQ(sampleAt(i + 3, 5), output[i * 2 + 1]);
+    }
+}
+
+TEST_F(AudioInputViewTest, CopyStridedMono) {
+    std::vector<CSAMPLE> device = makeDeviceBuffer(3);
+    std::vector<CSAMPLE> output(kFrames * 2);
+    AudioInputView view(&device[2], 3, 1);
+    view.copyStereo(output.data(), 0, kFrames);
+    for (int i = 0; i < kFrames; ++i) {
+        EXPECT_EQ(sampleAt(i, 2), output[i * 2]);
+        EXPECT_EQ(sampleAt(i, 2), output[i * 2 + 1]);
+    }
+}
+
+TEST_F(AudioInputViewTest, WriteStereoWrapsAroundFifo) {
+    std::vector<CSAMPLE> device = makeDeviceBuffer(4);
+    AudioInputView view(&device[2], 4, 2);
+    FIFO<CSAMPLE> fifo(kFrames * 2);
+
+    // Move the write position to the middle of the FIFO
+    std::vector<CSAMPLE> output(kFrames * 2);
+    fifo.write(output.data(), kFrames);
+    fifo.read(output.data(), kFrames);
+
+    EXPECT_EQ(kFrames, view.writeStereo(&fifo, kFrames));
+    ASSERT_EQ(kFrames * 2, fifo.read(output.data(), kFrames * 2));
+    for (int i = 0; i < kFrames; ++i) {
+        EXPECT_EQ(sampleAt(i, 2), output[i * 2]);
+        EXPECT_EQ(sampleAt(i, 3), output[i * 2 + 1]);
+    }
+}
+
+TEST_F(AudioInputViewTest, WriteStereoOverflow) {
+    std::vector<CSAMPLE> device = makeDeviceBuffer(2);
+    AudioInputView view(device.data(), 2, 2);
+    FIFO<CSAMPLE> fifo(kFrames);
+
+    // Only the frames that fit are written
+    EXPECT_EQ(kFrames / 2, view.writeStereo(&fifo, kFrames));
+    EXPECT_EQ(0, view.writeStereo(&fifo, kFrames));
+    std::vector<CSAMPLE> output(kFrames);
+    ASSERT_EQ(kFrames, fifo.read(output.data(), kFrames));
+    for (int i = 0; i < kFrames; ++i) {
+        EXPECT_EQ(device[i], output[i]);
+    }
+}
+
+}  // namespace
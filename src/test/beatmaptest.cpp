@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <QtDebug>
 
+#include <atomic>
+#include <thread>
+
 #include "track/beatmap.h"
 #include "util/memory.h"
 
@@ -294,4 +297,55 @@ TEST_F(BeatMapTest, TestBpmAround) {
     EXPECT_DOUBLE_EQ(filebpm, pMap->getBpmAroundPosition(1 * approx_beat_length, 4));
 }
 
+TEST_F(BeatMapTest, IteratorSurvivesEdits) {
+    m_pTrack->setSampleRate(m_iSampleRate);
+    const double beatLengthFrames = getBeatLengthFrames(60.0);
+    QVector<double> beats = createBeatVector(0, 4, beatLengthFrames);
+    auto pMap = std::make_unique<BeatMap>(*m_pTrack, 0, beats);
+
+    std::unique_ptr<BeatIterator> it = pMap->findBeats(0, 10 * beatLengthFrames * m_iFrameSize);
+    ASSERT_TRUE(it.get() != nullptr);
+    // The iterator keeps seeing the beats it was created for
+    pMap->translate(2 * m_iFrameSize);
+    pMap->removeBeat(beatLengthFrames * m_iFrameSize + 2 * m_iFrameSize);
+    for (int i = 0; i < beats.size(); ++i) {
+        ASSERT_TRUE(it->hasNext());
+        EXPECT_DOUBLE_EQ(beats[i] * m_iFrameSize, it->next());
+    }
+    EXPECT_FALSE(it->hasNext());
+}
+
+TEST_F(BeatMapTest, LookupsWhileEditing) {
+    m_pTrack->setSampleRate(m_iSampleRate);
+    const double beatLengthFrames = getBeatLengthFrames(60.0);
+    const double offsetFrames = 10;
+    QVector<double> beats = createBeatVector(0, 1000, beatLengthFrames);
+    auto pMap = std::make_unique<BeatMap>(*m_pTrack, 0, beats);
+
+    // Lookups on another thread always see one of the two grids
+    std::atomic<bool> done(false);
+    std::atomic<int> unexpected(0);
+    std::thread lookups([&]() {
+        const double position = 500.5 * beatLengthFrames * m_iFrameSize;
+        while (!done.load()) {
+            const double nextBeat = pMap->findNextBeat(position);
+            const double nextBeatFrames = nextBeat / m_iFrameSize;
+            if (nextBeatFrames != 501 * beatLengthFrames &&
+                    nextBeatFrames != 501 * beatLengthFrames + offsetFrames) {
+                ++unexpected;
+            }
+            if (pMap->getBpm() != 60.0) {
+                ++unexpected;
+            }
+        }
+    });
+    for (int i = 0; i < 200; ++i) {
+        pMap->translate(offsetFrames * m_iFrameSize);
+        pMap->translate(-offsetFrames * m_iFrameSize);
+    }
+    done.store(true);
+    lookups.join();
+    EXPECT_EQ(0, unexpected.load());
+}
+
 }  // namespace
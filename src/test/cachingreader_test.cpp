@@ -0,0 +1,377 @@
+#include <gtest/gtest.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <QDir>
+#include <QThread>
+#include <QtDebug>
+
+#include "engine/cachingreader/cachingreader.h"
+#include "engine/cachingreader/cachingreaderchunkindex.h"
+#include "engine/engineworkerscheduler.h"
+#include "test/mixxxtest.h"
+#include "util/performancetimer.h"
+#include "util/sample.h"
+
+namespace {
+
+const SINT kNumberOfTestChunks = 80;
+
+class CachingReaderChunkIndexTest : public testing::Test {
+  protected:
+    CachingReaderChunkIndexTest()
+            : m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfTestChunks) {
+        for (SINT i = 0; i < kNumberOfTestChunks; ++i) {
+            m_chunks.push_back(new CachingReaderChunkForOwner(
+                    mixxx::SampleBuffer::WritableSlice(
+                            m_sampleBuffer,
+                            CachingReaderChunk::kSamples * i,
+                            CachingReaderChunk::kSamples)));
+        }
+    }
+    ~CachingReaderChunkIndexTest() override {
+        qDeleteAll(m_chunks);
+    }
+
+    mixxx::SampleBuffer m_sampleBuffer;
+    QVector<CachingReaderChunkForOwner*> m_chunks;
+};
+
+TEST_F(CachingReaderChunkIndexTest, InsertFindRemove) {
+    CachingReaderChunkIndex index(kNumberOfTestChunks);
+    EXPECT_EQ(nullptr, index.find(0));
+
+    // Consecutive chunks around the play position
+    for (SINT i = 0; i < kNumberOfTestChunks / 2; ++i) {
+        EXPECT_TRUE(index.insert(100 + i, m_chunks[i]));
+    }
+    // Colliding chunks far away from the play position, e.g. hotcues
+    const SINT kSlots = roundUpToPowerOf2(2 * kNumberOfTestChunks);
+    for (SINT i = kNumberOfTestChunks / 2; i < kNumberOfTestChunks; ++i) {
+        EXPECT_TRUE(index.insert(100 + i * kSlots, m_chunks[i]));
+    }
+    EXPECT_EQ(kNumberOfTestChunks, index.size());
+
+    for (SINT i = 0; i < kNumberOfTestChunks / 2; ++i) {
+        EXPECT_EQ(m_chunks[i], index.find(100 + i));
+    }
+    for (SINT i = kNumberOfTestChunks / 2; i < kNumberOfTestChunks; ++i) {
+        EXPECT_EQ(m_chunks[i], index.find(100 + i * kSlots));
+    }
+
+    // Remove every other chunk and verify that the remaining
+    // chunks are still reachable.
+    for (SINT i = 0; i < kNumberOfTestChunks; i += 2) {
+        const SINT chunkIndex =
+                (i < kNumberOfTestChunks / 2) ? (100 + i) : (100 + i * kSlots);
+        EXPECT_EQ(1, index.remove(chunkIndex));
+        EXPECT_EQ(0, index.remove(chunkIndex));
+        EXPECT_EQ(nullptr, index.find(chunkIndex));
+    }
+    EXPECT_EQ(kNumberOfTestChunks / 2, index.size());
+    for (SINT i = 1; i < kNumberOfTestChunks; i += 2) {
+        const SINT chunkIndex =
+                (i < kNumberOfTestChunks / 2) ? (100 + i) : (100 + i * kSlots);
+        EXPECT_EQ(m_chunks[i], index.find(chunkIndex));
+    }
+
+    index.clear();
+    EXPECT_EQ(0, index.size());
+    EXPECT_EQ(nullptr, index.find(101));
+}
+
+TEST_F(CachingReaderChunkIndexTest, Full) {
+    CachingReaderChunkIndex index(kNumberOfTestChunks);
+    for (SINT i = 0; i < kNumberOfTestChunks; ++i) {
+        EXPECT_TRUE(index.insert(i, m_chunks[i]));
+    }
+    EXPECT_EQ(kNumberOfTestChunks, index.size());
+}
+
+class CachingReaderWorkerTest : public CachingReaderChunkIndexTest {
+  protected:
+    CachingReaderChunkReadRequest newRequest(SINT chunkIndex, bool prefetch) {
+        CachingReaderChunkForOwner* pChunk = m_chunks[m_requestCount++];
+        pChunk->init(chunkIndex);
+        CachingReaderChunkReadRequest request;
+        request.giveToWorker(pChunk, prefetch);
+        return request;
+    }
+
+    // Removes and returns the chunk index of the selected request
+    static SINT takeNextRequest(
+            std::vector<CachingReaderChunkReadRequest>* pRequests,
+            SINT nextChunkIndex) {
+        const int next = CachingReaderWorker::selectNextReadRequest(
+                pRequests->data(), pRequests->size(), nextChunkIndex);
+        const SINT chunkIndex = (*pRequests)[next].chunk->getIndex();
+        pRequests->erase(pRequests->begin() + next);
+        return chunkIndex;
+    }
+
+    int m_requestCount = 0;
+};
+
+TEST_F(CachingReaderWorkerTest, SelectNextReadRequest) {
+    // Play position, hotcue and speculative requests
+    std::vector<CachingReaderChunkReadRequest> requests;
+    requests.push_back(newRequest(10, false));
+    requests.push_back(newRequest(50, false));
+    requests.push_back(newRequest(11, false));
+    requests.push_back(newRequest(51, true));
+    requests.push_back(newRequest(30, true));
+
+    EXPECT_EQ(10, takeNextRequest(&requests, -1));
+    // Continue decoding without seeking
+    EXPECT_EQ(11, takeNextRequest(&requests, 11));
+    EXPECT_EQ(50, takeNextRequest(&requests, 12));
+    // Only speculative requests left
+    EXPECT_EQ(51, takeNextRequest(&requests, 51));
+    EXPECT_EQ(30, takeNextRequest(&requests, 52));
+    EXPECT_TRUE(requests.empty());
+}
+
+TEST_F(CachingReaderWorkerTest, SpeculativeRequestsAreDeferred) {
+    std::vector<CachingReaderChunkReadRequest> requests;
+    requests.push_back(newRequest(21, true));
+    requests.push_back(newRequest(60, false));
+
+    // Continuing a speculative read must not delay other requests
+    EXPECT_EQ(60, takeNextRequest(&requests, 21));
+    EXPECT_EQ(21, takeNextRequest(&requests, 61));
+}
+
+// Without a track loaded the worker answers each request immediately,
+// which reveals the order in which the requests are processed.
+class CachingReaderWorkerQueueTest : public CachingReaderWorkerTest {
+  protected:
+    CachingReaderWorkerQueueTest()
+            : m_requestFIFO(kNumberOfTestChunks),
+              m_statusFIFO(kNumberOfTestChunks),
+              m_worker("[Test]", UserSettingsPointer(),
+                      &m_requestFIFO, &m_statusFIFO) {
+    }
+
+    CachingReaderChunkForOwner* queueRequest(SINT chunkIndex, bool prefetch) {
+        CachingReaderChunkReadRequest request = newRequest(chunkIndex, prefetch);
+        EXPECT_EQ(1, m_requestFIFO.write(&request, 1));
+        return static_cast<CachingReaderChunkForOwner*>(request.chunk);
+    }
+
+    // Returns the chunk index of the processed request
+    SINT processNextRequest() {
+        if (!m_worker.processNextReadRequest()) {
+            return -1;
+        }
+        ReaderStatusUpdate update;
+        EXPECT_EQ(1, m_statusFIFO.read(&update, 1));
+        return update.chunk->getIndex();
+    }
+
+    FIFO<CachingReaderChunkReadRequest> m_requestFIFO;
+    FIFO<ReaderStatusUpdate> m_statusFIFO;
+    CachingReaderWorker m_worker;
+};
+
+TEST_F(CachingReaderWorkerQueueTest, UrgentRequestDuringPrefetch) {
+    for (SINT i = 0; i < 4; ++i) {
+        queueRequest(30 + i, true);
+    }
+    EXPECT_EQ(30, processNextRequest());
+
+    // The play position jumped while the speculative requests are pending
+    queueRequest(70, false);
+    EXPECT_EQ(70, processNextRequest());
+    EXPECT_EQ(31, processNextRequest());
+    EXPECT_EQ(32, processNextRequest());
+    EXPECT_EQ(33, processNextRequest());
+    EXPECT_EQ(-1, processNextRequest());
+}
+
+TEST_F(CachingReaderWorkerQueueTest, PromotedSpeculativeRequest) {
+    queueRequest(30, true);
+    CachingReaderChunkForOwner* pChunk = queueRequest(40, true);
+    queueRequest(50, false);
+    EXPECT_EQ(50, processNextRequest());
+
+    // The pending chunk is hinted again without speculation
+    pChunk->setSpeculative(false);
+    EXPECT_EQ(40, processNextRequest());
+    EXPECT_EQ(30, processNextRequest());
+    EXPECT_EQ(-1, processNextRequest());
+}
+
+// Benchmarks for the engine-facing operations of CachingReader. Each
+// iteration is timed individually to report latency percentiles, since
+// the worst case is what matters in the audio callback.
+
+const SINT kBenchmarkSamples = 2 * 1024;
+
+class CachingReaderBenchmarkFixture {
+  public:
+    CachingReaderBenchmarkFixture()
+            : m_reader("[BenchmarkDeck]", UserSettingsPointer()),
+              m_buffer(kBenchmarkSamples) {
+        m_scheduler.start(QThread::HighPriority);
+        m_reader.setScheduler(&m_scheduler);
+        m_reader.newTrack(Track::newTemporary(
+                QDir::currentPath() + "/src/test/sine-30.wav"));
+    }
+
+    // Hints and reads until the requested region has been decoded into
+    // the cache. Returns false on timeout.
+    bool prefetch(SINT startSample, SINT numSamples) {
+        HintVector hints;
+        Hint hint;
+        hint.frame = CachingReaderChunk::samples2frames(startSample);
+        hint.frameCount = CachingReaderChunk::samples2frames(numSamples);
+        hint.priority = 1;
+        hints.append(hint);
+        for (int retry = 0; retry < 5000; ++retry) {
+            m_reader.hintAndMaybeWake(hints);
+            m_scheduler.runWorkers();
+            if (m_reader.read(startSample, kBenchmarkSamples, false,
+                        m_buffer.data()) == CachingReader::ReadResult::AVAILABLE) {
+                return true;
+            }
+            QThread::msleep(1);
+        }
+        return false;
+    }
+
+    CachingReader* reader() {
+        return &m_reader;
+    }
+
+    void runWorkers() {
+        m_scheduler.runWorkers();
+    }
+
+    CSAMPLE* buffer() {
+        return m_buffer.data();
+    }
+
+  private:
+    EngineWorkerScheduler m_scheduler;
+    CachingReader m_reader;
+    mixxx::SampleBuffer m_buffer;
+};
+
+void skipBenchmark(benchmark::State* pState) {
+    qWarning() << "Failed to load test track";
+    pState->SetLabel("failed to load test track");
+    while (pState->KeepRunning()) {
+    }
+}
+
+TEST(CachingReaderPrefetchTest, SpeculativeHintsAreServed) {
+    CachingReaderBenchmarkFixture fixture;
+    ASSERT_TRUE(fixture.prefetch(0, kBenchmarkSamples));
+
+    // A speculative hint for a hotcue covers the frames that are
+    // needed after jumping to it
+    const SINT hotcueFrame = 8 * CachingReaderChunk::kFrames;
+    HintVector hints;
+    Hint hint;
+    hint.frame = hotcueFrame;
+    hint.frameCount = Hint::kFrameCountPrefetch;
+    hint.priority = Hint::kPriorityPrefetch;
+    hints.append(hint);
+    const SINT readSample = CachingReaderChunk::frames2samples(
+            hotcueFrame + CachingReaderChunk::kFrames);
+    bool available = false;
+    for (int retry = 0; (retry < 5000) && !available; ++retry) {
+        fixture.reader()->hintAndMaybeWake(hints);
+        fixture.runWorkers();
+        available = fixture.reader()->read(readSample, kBenchmarkSamples, false,
+                fixture.buffer()) == CachingReader::ReadResult::AVAILABLE;
+        if (!available) {
+            QThread::msleep(1);
+        }
+    }
+    EXPECT_TRUE(available);
+}
+
+void setLatencyPercentileLabel(benchmark::State* pState,
+        std::vector<qint64>* pLatencies) {
+    if (pLatencies->empty()) {
+        return;
+    }
+    std::sort(pLatencies->begin(), pLatencies->end());
+    const auto percentile = [pLatencies](double p) {
+        return (*pLatencies)[static_cast<size_t>(p * (pLatencies->size() - 1))];
+    };
+    pState->SetLabel(QString("p50=%1ns p99=%2ns p99.9=%3ns max=%4ns")
+            .arg(percentile(0.5))
+            .arg(percentile(0.99))
+            .arg(percentile(0.999))
+            .arg(pLatencies->back())
+            .toStdString());
+}
+
+static void BM_CachingReaderRead(benchmark::State& state) {
+    CachingReaderBenchmarkFixture fixture;
+    // Jump between the requested number of cached regions like
+    // a scratching or seeking deck does.
+    const SINT regions = state.range_x();
+    const SINT regionDistance = 4 * CachingReaderChunk::kSamples;
+    for (SINT i = 0; i < regions; ++i) {
+        if (!fixture.prefetch(i * regionDistance, kBenchmarkSamples)) {
+            skipBenchmark(&state);
+            return;
+        }
+    }
+
+    std::vector<qint64> latencies;
+    latencies.reserve(1 << 20);
+    SINT region = 0;
+    PerformanceTimer timer;
+    while (state.KeepRunning()) {
+        timer.start();
+        fixture.reader()->read(
+                region * regionDistance, kBenchmarkSamples, false, fixture.buffer());
+        if (latencies.size() < latencies.capacity()) {
+            latencies.push_back(timer.elapsed().toIntegerNanos());
+        }
+        region = (region + 1) % regions;
+    }
+    setLatencyPercentileLabel(&state, &latencies);
+}
+BENCHMARK(BM_CachingReaderRead)->Arg(1)->Arg(4)->Arg(16);
+
+static void BM_CachingReaderHintAndMaybeWake(benchmark::State& state) {
+    CachingReaderBenchmarkFixture fixture;
+    if (!fixture.prefetch(0, kBenchmarkSamples)) {
+        skipBenchmark(&state);
+        return;
+    }
+
+    // Hints for the play position and a number of hotcues that are
+    // spread across the track.
+    HintVector hints;
+    const SINT hintCount = state.range_x();
+    for (SINT i = 0; i < hintCount; ++i) {
+        Hint hint;
+        hint.frame = i * 3 * CachingReaderChunk::kFrames;
+        hint.frameCount = Hint::kFrameCountForward;
+        hint.priority = 1;
+        hints.append(hint);
+    }
+
+    std::vector<qint64> latencies;
+    latencies.reserve(1 << 20);
+    PerformanceTimer timer;
+    while (state.KeepRunning()) {
+        timer.start();
+        fixture.reader()->hintAndMaybeWake(hints);
+        if (latencies.size() < latencies.capacity()) {
+            latencies.push_back(timer.elapsed().toIntegerNanos());
+        }
+    }
+    setLatencyPercentileLabel(&state, &latencies);
+}
+BENCHMARK(BM_CachingReaderHintAndMaybeWake)->Arg(1)->Arg(8)->Arg(32);
+
+}  // namespace
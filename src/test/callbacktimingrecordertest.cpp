@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryFile>
+#include <QThread>
+
+#include "soundio/callbacktimingrecorder.h"
+
+namespace {
+
+TEST(CallbackTimingRecorderTest, BinsAreMonotonic) {
+    int lastBin = CallbackTimingRecorder::binForMicros(0);
+    EXPECT_EQ(0, lastBin);
+    for (qint64 micros = 1; micros < (1 << 20); micros += 1 + micros / 64) {
+        const int bin = CallbackTimingRecorder::binForMicros(micros);
+        ASSERT_LE(lastBin, bin) << micros;
+        // The upper bound is exclusive
+        ASSERT_LT(micros, CallbackTimingRecorder::binUpperBoundMicros(bin))
+                << micros;
+        if (bin > 0) {
+            ASSERT_GE(micros, CallbackTimingRecorder::binUpperBoundMicros(bin - 1))
+                    << micros;
+        }
+        lastBin = bin;
+    }
+}
+
+TEST(CallbackTimingRecorderTest, BinResolution) {
+    // Linear bins below 16 us
+    EXPECT_EQ(5, CallbackTimingRecorder::binForMicros(5));
+    EXPECT_EQ(6, CallbackTimingRecorder::binUpperBoundMicros(5));
+    // 8 bins per power of 2 above, i.e. a relative error below 12.5%
+    const int bin = CallbackTimingRecorder::binForMicros(5000);
+    EXPECT_GT(5000 * 1.125, CallbackTimingRecorder::binUpperBoundMicros(bin));
+    // Huge values end up in the last bin
+    EXPECT_EQ(CallbackTimingRecorder::binForMicros(qint64(1) << 40),
+            CallbackTimingRecorder::binForMicros(qint64(1) << 30));
+}
+
+TEST(CallbackTimingRecorderTest, Statistics) {
+    CallbackTimingRecorder recorder;
+    CallbackTimingRecorder::Statistics stats = recorder.statistics();
+    EXPECT_EQ(0, stats.callbackCount);
+    EXPECT_EQ(0.0, stats.p50Micros);
+
+    for (int i = 0; i < 10; ++i) {
+        recorder.beginCallback();
+        recorder.endCallback(256, 44100);
+    }
+    recorder.beginCallback();
+    QThread::msleep(5);
+    recorder.endCallback(256, 44100);
+
+    stats = recorder.statistics();
+    EXPECT_EQ(11, stats.callbackCount);
+    EXPECT_EQ(0, stats.xrunCount);
+    EXPECT_LE(stats.p50Micros, stats.p99Micros);
+    EXPECT_LE(stats.p99Micros, stats.p999Micros);
+    EXPECT_LE(stats.p999Micros, stats.maxMicros);
+    EXPECT_GE(stats.maxMicros, 5000.0);
+    // The slow callback is above the 50th but not above the 90th percentile
+    EXPECT_LT(stats.p50Micros, 5000.0);
+    EXPECT_EQ(stats.maxMicros, stats.p99Micros);
+
+    recorder.requestReset();
+    // The reset is applied by the callback thread
+    recorder.beginCallback();
+    recorder.endCallback(256, 44100);
+    stats = recorder.statistics();
+    EXPECT_EQ(1, stats.callbackCount);
+    EXPECT_GT(5000.0, stats.maxMicros);
+}
+
+TEST(CallbackTimingRecorderTest, XrunReport) {
+    CallbackTimingRecorder recorder;
+    const int kCallbackCount = CallbackTimingRecorder::kXrunHistorySize + 5;
+    for (int i = 0; i < kCallbackCount; ++i) {
+        recorder.beginCallback();
+        {
+            CallbackTimingRecorder::ScopedStage stage(&recorder,
+                    CallbackTimingRecorder::Stage::Engine);
+        }
+        if (i == kCallbackCount - 1) {
+            recorder.reportXrun(6);
+        }
+        recorder.endCallback(256, 44100);
+    }
+    EXPECT_EQ(1, recorder.statistics().xrunCount);
+
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    ASSERT_TRUE(recorder.dumpToFile(file.fileName()));
+
+    QFile dump(file.fileName());
+    ASSERT_TRUE(dump.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QString content = QString::fromUtf8(dump.readAll());
+    EXPECT_TRUE(content.contains(QString("callbacks: %1").arg(kCallbackCount)));
+    EXPECT_TRUE(content.contains("xruns: 1"));
+    EXPECT_TRUE(content.contains("xrun code 6"));
+    EXPECT_TRUE(content.contains(CallbackTimingRecorder::stageName(
+            CallbackTimingRecorder::Stage::Engine)));
+    // Header + one line per callback in the history of the xrun
+    const int xrunIndex = content.indexOf("xrun code 6");
+    EXPECT_EQ(CallbackTimingRecorder::kXrunHistorySize + 1,
+            content.mid(xrunIndex).count('\n') - 1);
+}
+
+}  // namespace
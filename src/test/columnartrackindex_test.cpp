@@ -0,0 +1,407 @@
+#include <gtest/gtest.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QtDebug>
+
+#include "library/columnartrackindex.h"
+#include "library/searchquery.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+const QStringList kColumnNames = QStringList()
+        << "id" << "artist" << "title" << "album" << "genre"
+        << "location" << "year" << "bpm" << "key_id" << "datetime_added";
+
+const QVector<ColumnarTrackIndex::ColumnType> kColumnTypes = {
+    ColumnarTrackIndex::ColumnType::Numeric,
+    ColumnarTrackIndex::ColumnType::Text,
+    ColumnarTrackIndex::ColumnType::Text,
+    ColumnarTrackIndex::ColumnType::Text,
+    ColumnarTrackIndex::ColumnType::Text,
+    ColumnarTrackIndex::ColumnType::Text,
+    ColumnarTrackIndex::ColumnType::Text,
+    ColumnarTrackIndex::ColumnType::Numeric,
+    ColumnarTrackIndex::ColumnType::Numeric,
+    ColumnarTrackIndex::ColumnType::Variant,
+};
+
+const QStringList kSearchColumns = QStringList()
+        << "artist" << "title" << "album" << "genre" << "location";
+
+QVector<QVariant> makeRecord(int id, const QString& artist, const QString& title,
+        const QVariant& bpm) {
+    QVector<QVariant> record(kColumnNames.size());
+    record[0] = QVariant(static_cast<qlonglong>(id));
+    record[1] = artist;
+    record[2] = title;
+    record[3] = QVariant(QVariant::String);
+    record[4] = QString("House");
+    record[5] = QString("/music/%1/%2.mp3").arg(artist, title);
+    record[6] = QString("2001");
+    record[7] = bpm;
+    record[8] = QVariant(static_cast<qlonglong>(1));
+    record[9] = QVariant(QDateTime(QDate(2018, 1, 1)));
+    return record;
+}
+
+class ColumnarTrackIndexTest : public testing::Test {
+  protected:
+    ColumnarTrackIndexTest()
+            : m_index(kColumnNames, kColumnTypes) {
+    }
+
+    std::vector<int> matchingRows(const QueryNode& node) const {
+        EXPECT_TRUE(node.canMatchIndex(m_index));
+        std::vector<int> rows;
+        for (int i = 1; i <= 4; ++i) {
+            int row = m_index.row(TrackId(i));
+            if (row >= 0 && node.matchIndex(m_index, row)) {
+                rows.push_back(i);
+            }
+        }
+        return rows;
+    }
+
+    ColumnarTrackIndex m_index;
+};
+
+TEST_F(ColumnarTrackIndexTest, StoresValues) {
+    m_index.setTrack(TrackId(1), makeRecord(1, "Artist", "Title", 120.5));
+    m_index.setTrack(TrackId(2), makeRecord(2, "Artist", "Other", QVariant(QVariant::Double)));
+    ASSERT_EQ(2, m_index.trackCount());
+
+    const int row = m_index.row(TrackId(1));
+    ASSERT_LE(0, row);
+    EXPECT_EQ(TrackId(1), m_index.trackId(row));
+    EXPECT_EQ(QVariant(QString("Artist")), m_index.value(row, 1));
+    // NULL of the database
+    EXPECT_TRUE(m_index.value(row, 3).isNull());
+    EXPECT_EQ(QVariant::String, m_index.value(row, 3).type());
+    EXPECT_EQ(QVariant(120.5), m_index.value(row, 7));
+    EXPECT_EQ(QVariant::LongLong, m_index.value(row, 8).type());
+    EXPECT_EQ(QVariant(QDateTime(QDate(2018, 1, 1))), m_index.value(row, 9));
+    // Out of range
+    EXPECT_FALSE(m_index.value(row, kColumnNames.size()).isValid());
+
+    double bpm = 0.0;
+    EXPECT_TRUE(m_index.numericValue(row, 7, &bpm));
+    EXPECT_EQ(120.5, bpm);
+    EXPECT_FALSE(m_index.numericValue(m_index.row(TrackId(2)), 7, &bpm));
+    EXPECT_TRUE(m_index.isNull(m_index.row(TrackId(2)), 7));
+    double year = 0.0;
+    EXPECT_TRUE(m_index.numericValue(row, 6, &year));
+    EXPECT_EQ(2001.0, year);
+
+    // Equal strings are interned
+    EXPECT_EQ(m_index.stringId(row, 1), m_index.stringId(m_index.row(TrackId(2)), 1));
+
+    // Irregular values keep their type
+    QVector<QVariant> record = makeRecord(1, "Artist", "Title", QString("fast"));
+    record[2] = 42;
+    m_index.setTrack(TrackId(1), record);
+    EXPECT_EQ(row, m_index.row(TrackId(1)));
+    EXPECT_EQ(QVariant(QString("fast")), m_index.value(row, 7));
+    EXPECT_FALSE(m_index.numericValue(row, 7, &bpm));
+    EXPECT_EQ(QVariant(42), m_index.value(row, 2));
+    EXPECT_EQ("42", m_index.foldedString(m_index.stringId(row, 2)));
+}
+
+TEST_F(ColumnarTrackIndexTest, ReusesRows) {
+    m_index.setTrack(TrackId(1), makeRecord(1, "A", "B", 100.0));
+    m_index.setTrack(TrackId(2), makeRecord(2, "C", "D", 100.0));
+    const int row = m_index.row(TrackId(1));
+    m_index.removeTrack(TrackId(1));
+    EXPECT_FALSE(m_index.contains(TrackId(1)));
+    EXPECT_EQ(1, m_index.trackCount());
+    // Removing again is a no-op
+    m_index.removeTrack(TrackId(1));
+    EXPECT_EQ(1, m_index.trackCount());
+
+    m_index.setTrack(TrackId(3), makeRecord(3, "E", "F", 100.0));
+    EXPECT_EQ(row, m_index.row(TrackId(3)));
+    EXPECT_EQ(QVariant(QString("E")), m_index.value(row, 1));
+
+    m_index.clear();
+    EXPECT_EQ(0, m_index.trackCount());
+    EXPECT_EQ(-1, m_index.row(TrackId(2)));
+}
+
+TEST_F(ColumnarTrackIndexTest, CompactStrings) {
+    m_index.setTrack(TrackId(1), makeRecord(1, "A", "B", 100.0));
+    m_index.setTrack(TrackId(2), makeRecord(2, "C", "D", 100.0));
+    m_index.setTrack(TrackId(3), makeRecord(3, "A", "E", 100.0));
+    // Trigram index of the old strings
+    EXPECT_FALSE(m_index.matchStrings("/music/c/d.mp3").empty());
+    EXPECT_EQ(0, m_index.releasedStringCount());
+    // null, "House", "2001" and 3 * (artist, title, location) - 1 shared artist
+    EXPECT_EQ(11, m_index.stringCount());
+
+    m_index.removeTrack(TrackId(2));
+    m_index.setTrack(TrackId(3), makeRecord(3, "A", "F", 100.0));
+    // All 5 strings of track 2 and the title and location of track 3
+    EXPECT_EQ(7, m_index.releasedStringCount());
+    EXPECT_EQ(13, m_index.stringCount());
+
+    m_index.compactStrings();
+    EXPECT_EQ(0, m_index.releasedStringCount());
+    EXPECT_EQ(8, m_index.stringCount());
+    const int row1 = m_index.row(TrackId(1));
+    const int row3 = m_index.row(TrackId(3));
+    EXPECT_EQ(QVariant(QString("A")), m_index.value(row1, 1));
+    EXPECT_EQ(QVariant(QString("B")), m_index.value(row1, 2));
+    EXPECT_EQ(QVariant(QString("A")), m_index.value(row3, 1));
+    EXPECT_EQ(QVariant(QString("F")), m_index.value(row3, 2));
+    EXPECT_EQ(QVariant(QString("/music/A/F.mp3")), m_index.value(row3, 5));
+    EXPECT_TRUE(m_index.isNull(row3, 3));
+    EXPECT_EQ(m_index.stringId(row1, 1), m_index.stringId(row3, 1));
+
+    // The trigram index is rebuilt for the new string ids
+    const std::vector<bool> matches = m_index.matchStrings("/music/a/f.mp3");
+    ASSERT_EQ(8u, matches.size());
+    EXPECT_TRUE(matches[m_index.stringId(row3, 5)]);
+    EXPECT_FALSE(matches[m_index.stringId(row1, 5)]);
+    EXPECT_EQ(1, std::count(matches.begin(), matches.end(), true));
+
+    // Strings are still shared after compaction
+    m_index.setTrack(TrackId(4), makeRecord(4, "A", "B", 100.0));
+    EXPECT_EQ(m_index.stringId(row1, 2),
+            m_index.stringId(m_index.row(TrackId(4)), 2));
+    EXPECT_EQ(8, m_index.stringCount());
+}
+
+TEST_F(ColumnarTrackIndexTest, MatchStrings) {
+    m_index.setTrack(TrackId(1), makeRecord(1, "Beyoncé", "Crazy in Love", 100.0));
+    m_index.setTrack(TrackId(2), makeRecord(2, "Lovebirds", "Want You in My Soul", 120.0));
+    m_index.setTrack(TrackId(3), makeRecord(3, "Eval", "Solve", 128.0));
+
+    const auto matchingStrings = [this](QString needle) {
+        ColumnarTrackIndex::foldString(&needle);
+        QStringList strings;
+        std::vector<bool> matches = m_index.matchStrings(needle);
+        EXPECT_EQ(m_index.stringCount(), static_cast<int>(matches.size()));
+        for (int i = 0; i < m_index.stringCount(); ++i) {
+            if (matches[i]) {
+                strings << m_index.foldedString(i);
+            }
+        }
+        strings.sort();
+        return strings;
+    };
+
+    // Short needles are not looked up by trigrams
+    EXPECT_EQ(QStringList() << "/music/eval/solve.mp3"
+            << "/music/lovebirds/want you in my soul.mp3"
+            << "solve" << "want you in my soul", matchingStrings("SO"));
+    EXPECT_EQ(QStringList() << "/music/beyonce/crazy in love.mp3"
+            << "/music/lovebirds/want you in my soul.mp3"
+            << "crazy in love" << "lovebirds", matchingStrings("LoV"));
+    // All trigrams must be contained in the right order
+    EXPECT_EQ(QStringList() << "/music/beyonce/crazy in love.mp3" << "beyonce",
+            matchingStrings("BEYONCE"));
+    EXPECT_EQ(QStringList(), matchingStrings("evol"));
+    EXPECT_EQ(QStringList(), matchingStrings("xyz"));
+
+    // Strings added after the trigram index has been built are found
+    m_index.setTrack(TrackId(4), makeRecord(4, "Love", "Will Tear Us Apart", 140.0));
+    EXPECT_EQ(QStringList() << "/music/beyonce/crazy in love.mp3"
+            << "/music/love/will tear us apart.mp3"
+            << "/music/lovebirds/want you in my soul.mp3"
+            << "crazy in love" << "love" << "lovebirds", matchingStrings("love"));
+}
+
+TEST_F(ColumnarTrackIndexTest, QueryNodes) {
+    m_index.setTrack(TrackId(1), makeRecord(1, "Beyoncé", "Crazy in Love", 100.0));
+    m_index.setTrack(TrackId(2), makeRecord(2, "Lovebirds", "Want You in My Soul", 120.0));
+    m_index.setTrack(TrackId(3), makeRecord(3, "Eval", "Solve", QVariant(QVariant::Double)));
+    m_index.setTrack(TrackId(4), makeRecord(4, "", "Love Will Tear Us Apart", 140.0));
+
+    EXPECT_EQ(std::vector<int>({1, 2, 4}),
+            matchingRows(TextFilterNode(QSqlDatabase(), kSearchColumns, "LOVE")));
+    EXPECT_EQ(std::vector<int>({2}),
+            matchingRows(TextFilterNode(QSqlDatabase(), QStringList() << "artist", "love")));
+    EXPECT_EQ(std::vector<int>({1}),
+            matchingRows(TextFilterNode(QSqlDatabase(), QStringList() << "artist", "beyonce")));
+
+    EXPECT_EQ(std::vector<int>({2, 4}),
+            matchingRows(NumericFilterNode(QStringList() << "bpm", ">100")));
+    EXPECT_EQ(std::vector<int>({1, 2}),
+            matchingRows(NumericFilterNode(QStringList() << "bpm", "100-120")));
+    EXPECT_EQ(std::vector<int>({3}),
+            matchingRows(NullNumericFilterNode(QStringList() << "bpm")));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4}),
+            matchingRows(NumericFilterNode(QStringList() << "year", "2001")));
+    EXPECT_EQ(std::vector<int>({4}),
+            matchingRows(NullOrEmptyTextFilterNode(QSqlDatabase(), QStringList() << "artist")));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4}),
+            matchingRows(KeyFilterNode(mixxx::track::io::key::C_MAJOR, false)));
+
+    AndNode andNode;
+    andNode.addNode(std::make_unique<TextFilterNode>(QSqlDatabase(), kSearchColumns, "love"));
+    andNode.addNode(std::make_unique<NotNode>(
+            std::make_unique<TextFilterNode>(QSqlDatabase(), kSearchColumns, "soul")));
+    EXPECT_EQ(std::vector<int>({1, 4}), matchingRows(andNode));
+}
+
+TEST_F(ColumnarTrackIndexTest, UnsupportedQueryNodes) {
+    // LIKE wildcards
+    EXPECT_FALSE(TextFilterNode(QSqlDatabase(), kSearchColumns, "lo%ve")
+            .canMatchIndex(m_index));
+    // Missing column
+    EXPECT_FALSE(TextFilterNode(QSqlDatabase(), QStringList() << "composer", "love")
+            .canMatchIndex(m_index));
+    // Not a text column
+    EXPECT_FALSE(TextFilterNode(QSqlDatabase(), QStringList() << "datetime_added", "2018")
+            .canMatchIndex(m_index));
+    EXPECT_FALSE(SqlNode("mixxx_deleted=0").canMatchIndex(m_index));
+
+    AndNode andNode;
+    andNode.addNode(std::make_unique<TextFilterNode>(QSqlDatabase(), kSearchColumns, "love"));
+    EXPECT_TRUE(andNode.canMatchIndex(m_index));
+    andNode.addNode(std::make_unique<SqlNode>("mixxx_deleted=0"));
+    EXPECT_FALSE(andNode.canMatchIndex(m_index));
+}
+
+// A synthetic library with words that share many trigrams
+class SyntheticLibrary {
+  public:
+    static const int kTrackCount = 200000;
+
+    SyntheticLibrary()
+            : m_index(kColumnNames, kColumnTypes) {
+        const char* const kSyllables[] = {
+            "la", "lo", "ve", "da", "nce", "ni", "ght", "mo", "on", "so",
+            "ul", "ra", "in", "ta", "ke", "me", "hi", "gh", "er", "de",
+            "ep", "ho", "use", "tr", "an", "ce", "su", "mm", "el", "ba",
+        };
+        const int kSyllableCount = sizeof(kSyllables) / sizeof(kSyllables[0]);
+
+        std::mt19937 generator(42);
+        const auto word = [&]() {
+            QString word;
+            const int syllables = 2 + generator() % 3;
+            for (int i = 0; i < syllables; ++i) {
+                word += kSyllables[generator() % kSyllableCount];
+            }
+            word[0] = word[0].toUpper();
+            return word;
+        };
+        const auto words = [&](int count) {
+            QStringList result;
+            for (int i = 0; i < count; ++i) {
+                result << word();
+            }
+            return result.join(" ");
+        };
+
+        QStringList artists;
+        for (int i = 0; i < kTrackCount / 25; ++i) {
+            artists << words(1 + i % 2);
+        }
+        QStringList albums;
+        for (int i = 0; i < kTrackCount / 10; ++i) {
+            albums << words(1 + i % 3);
+        }
+        QStringList genres;
+        for (int i = 0; i < 40; ++i) {
+            genres << word();
+        }
+
+        for (int i = 0; i < kTrackCount; ++i) {
+            const QString artist = artists[generator() % artists.size()];
+            const QString title = words(1 + i % 4);
+            const QString album = albums[generator() % albums.size()];
+            QVector<QVariant> record(kColumnNames.size());
+            record[0] = QVariant(static_cast<qlonglong>(i + 1));
+            record[1] = artist;
+            record[2] = title;
+            record[3] = album;
+            record[4] = genres[generator() % genres.size()];
+            record[5] = QString("/home/user/Music/%1/%2/%3.mp3").arg(artist, album, title);
+            record[6] = QString::number(1960 + generator() % 60);
+            record[7] = 80.0 + (generator() % 1000) / 10.0;
+            record[8] = QVariant(static_cast<qlonglong>(1 + generator() % 24));
+            record[9] = QVariant(QDateTime(QDate(2018, 1, 1)));
+            m_index.setTrack(TrackId(i + 1), record);
+            m_records.push_back(record);
+            m_rows.push_back(m_index.row(TrackId(i + 1)));
+        }
+    }
+
+    static const SyntheticLibrary& instance() {
+        static SyntheticLibrary library;
+        return library;
+    }
+
+    ColumnarTrackIndex m_index;
+    // The previous per-track storage of BaseTrackCache
+    std::vector<QVector<QVariant>> m_records;
+    std::vector<int> m_rows;
+};
+
+const char* const kTypedQuery = "lovenight";
+
+// Filters the synthetic library after each keystroke while typing
+// a search term. Arguments:
+// 0: Evaluate QVariant records like TextFilterNode::match()
+// 1: Filter all rows of the columnar index
+// 2: Only filter the rows that matched the previous keystroke
+static void BM_SearchWhileTyping(benchmark::State& state) {
+    const SyntheticLibrary& library = SyntheticLibrary::instance();
+    QVector<int> searchColumns;
+    for (const auto& column : kSearchColumns) {
+        searchColumns << kColumnNames.indexOf(column);
+    }
+
+    const int queryLength = strlen(kTypedQuery);
+    size_t matches = 0;
+    std::vector<int> previousRows;
+    std::vector<int> rows;
+    while (state.KeepRunning()) {
+        previousRows = library.m_rows;
+        for (int i = 1; i <= queryLength; ++i) {
+            const QString argument = QString(kTypedQuery).left(i);
+            rows.clear();
+            if (state.range_x() == 0) {
+                QString foldedArgument = argument;
+                ColumnarTrackIndex::foldString(&foldedArgument);
+                for (size_t row = 0; row < library.m_records.size(); ++row) {
+                    for (const int column : searchColumns) {
+                        QString value = library.m_records[row][column].toString();
+                        mixxx::DbConnection::makeStringLatinLow(&value);
+                        if (value.contains(foldedArgument)) {
+                            rows.push_back(row);
+                            break;
+                        }
+                    }
+                }
+            } else {
+                TextFilterNode node(QSqlDatabase(), kSearchColumns, argument);
+                const std::vector<int>& candidateRows =
+                        state.range_x() == 2 ? previousRows : library.m_rows;
+                for (const int row : candidateRows) {
+                    if (node.matchIndex(library.m_index, row)) {
+                        rows.push_back(row);
+                    }
+                }
+            }
+            previousRows.swap(rows);
+        }
+        matches = previousRows.size();
+    }
+    state.SetItemsProcessed(state.iterations() * queryLength);
+    state.SetLabel(QString("%1 tracks, %2 matches")
+            .arg(SyntheticLibrary::kTrackCount)
+            .arg(matches)
+            .toStdString());
+}
+BENCHMARK(BM_SearchWhileTyping)->Arg(0)->Arg(1)->Arg(2);
+
+}  // namespace
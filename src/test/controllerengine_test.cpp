@@ -1,3 +1,7 @@
+#include <benchmark/benchmark.h>
+
+#include <limits>
+
 #include <QtDebug>
 #include <QThread>
 
@@ -8,6 +12,7 @@
 #include "controllers/controllerdebug.h"
 #include "controllers/softtakeover.h"
 #include "test/mixxxtest.h"
+#include "util/alphabetafilter.h"
 #include "util/memory.h"
 #include "util/time.h"
 
@@ -35,6 +40,21 @@ class ControllerEngineTest : public MixxxTest {
                                         QScriptValueList());
     }
 
+    // Tears down and re-initializes the script engine like
+    // scriptHasChanged(), which needs a controller with a preset.
+    void reloadScripts() {
+        cEngine->gracefulShutdown();
+        delete cEngine->m_pEngine;
+        cEngine->m_pEngine = nullptr;
+        cEngine->initializeScriptEngine();
+        pScriptEngine = cEngine->m_pEngine;
+    }
+
+    // Runs the scratch timer of deck as if it fired now.
+    void scratchProcess(int deck) {
+        cEngine->scratchProcess(cEngine->m_scratchTimers.key(deck));
+    }
+
     ControllerEngine *cEngine;
     QScriptEngine *pScriptEngine;
 };
@@ -73,6 +93,60 @@ TEST_F(ControllerEngineTest, getSetValue) {
     EXPECT_DOUBLE_EQ(1.0, co->get());
 }
 
+TEST_F(ControllerEngineTest, getSetValueByHandle) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    EXPECT_TRUE(execute("function() {"
+                        "  var handle = engine.getControlHandle('[Test]', 'co');"
+                        "  engine.setValueByHandle(handle, engine.getValueByHandle(handle) + 1);"
+                        "}"));
+    EXPECT_DOUBLE_EQ(1.0, co->get());
+    // Handles are resolved once per control.
+    EXPECT_EQ(cEngine->getControlHandle("[Test]", "co"),
+              cEngine->getControlHandle("[Test]", "co"));
+}
+
+TEST_F(ControllerEngineTest, getSetParameterByHandle) {
+    auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "co"),
+                                                -10.0, 10.0);
+    int handle = cEngine->getControlHandle("[Test]", "co");
+    cEngine->setParameterByHandle(handle, 1.0);
+    EXPECT_DOUBLE_EQ(10.0, co->get());
+    EXPECT_DOUBLE_EQ(1.0, cEngine->getParameterByHandle(handle));
+    // NaN is ignored like by setParameter()
+    cEngine->setParameterByHandle(handle, std::numeric_limits<double>::quiet_NaN());
+    EXPECT_DOUBLE_EQ(10.0, co->get());
+}
+
+TEST_F(ControllerEngineTest, controlHandle_AfterReload) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    auto co2 = std::make_unique<ControlObject>(ConfigKey("[Test]", "co2"));
+    EXPECT_EQ(0, cEngine->getControlHandle("[Test]", "co"));
+    EXPECT_EQ(1, cEngine->getControlHandle("[Test]", "co2"));
+
+    reloadScripts();
+
+    // The handles of the old script are invalid ...
+    cEngine->setValueByHandle(1, 1.0);
+    EXPECT_DOUBLE_EQ(0.0, co2->get());
+    // ... and the reloaded script gets new ones
+    EXPECT_TRUE(execute("function() {"
+                        "  var handle = engine.getControlHandle('[Test]', 'co2');"
+                        "  engine.setValueByHandle(handle, engine.getValueByHandle(handle) + 1);"
+                        "}"));
+    EXPECT_DOUBLE_EQ(1.0, co2->get());
+    EXPECT_EQ(0, cEngine->getControlHandle("[Test]", "co2"));
+    EXPECT_DOUBLE_EQ(1.0, cEngine->getValueByHandle(0));
+}
+
+TEST_F(ControllerEngineTest, controlHandle_Invalid) {
+    EXPECT_EQ(-1, cEngine->getControlHandle("[Nothing]", "nothing"));
+    EXPECT_TRUE(execute("function() {"
+                        "  engine.setValueByHandle(-1, 1.0);"
+                        "  engine.setValueByHandle(42, 1.0);"
+                        "  return engine.getValueByHandle(42);"
+                        "}"));
+}
+
 TEST_F(ControllerEngineTest, setParameter) {
     auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "co"),
                                                 -10.0, 10.0);
@@ -612,3 +686,67 @@ TEST_F(ControllerEngineTest, colorProxy) {
         EXPECT_EQ(jsColor2.property("id").toInt32(), color->m_iId);
     }
 }
+
+TEST_F(ControllerEngineTest, scratchTick_ObservedInPeriodOfArrival) {
+    auto pScratch2 = std::make_unique<ControlObject>(
+            ConfigKey("[Channel1]", "scratch2"));
+    auto pScratch2Enable = std::make_unique<ControlObject>(
+            ConfigKey("[Channel1]", "scratch2_enable"));
+
+    const int intervalsPerRev = 128;
+    const double rpm = 33.0 + 1.0 / 3;
+    const double alpha = 1.0 / 8;
+    const double beta = alpha / 32;
+    cEngine->scratchEnable(1, intervalsPerRev, rpm, alpha, beta, false);
+
+    // One tick in each of the first two 1 ms periods.
+    mixxx::Time::setTestElapsedTime(mixxx::Duration::fromMicros(10200));
+    cEngine->scratchTick(1, 1);
+    mixxx::Time::setTestElapsedTime(mixxx::Duration::fromMicros(11500));
+    cEngine->scratchTick(1, 1);
+
+    // The timer fires late, after both periods have passed.
+    mixxx::Time::setTestElapsedTime(mixxx::Duration::fromMillis(12));
+    scratchProcess(1);
+
+    // Each tick is observed in its own period instead of both at once.
+    const double dx = 1.0 / ((rpm * intervalsPerRev) / 60.0);
+    AlphaBetaFilter expected;
+    expected.init(0.001, 0.0, alpha, beta);
+    expected.observation(dx);
+    expected.observation(dx);
+    EXPECT_DOUBLE_EQ(expected.predictedVelocity(), pScratch2->get());
+}
+
+// Simulates LED feedback of a script that updates a control 1000 times by
+// name (Arg 0) or by handle (Arg 1).
+static void BM_ControllerEngine_SetValue(benchmark::State& state) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    ControllerEngine* pEngine = new ControllerEngine(nullptr);
+    QScriptValue function;
+    if (state.range_x() == 0) {
+        function = pEngine->wrapFunctionCode(
+                "function() {"
+                "  for (var i = 0; i < 1000; ++i) {"
+                "    engine.setValue('[Test]', 'co', i);"
+                "  }"
+                "}", 0);
+    } else {
+        function = pEngine->wrapFunctionCode(
+                "function() {"
+                "  var handle = engine.getControlHandle('[Test]', 'co');"
+                "  for (var i = 0; i < 1000; ++i) {"
+                "    engine.setValueByHandle(handle, i);"
+                "  }"
+                "}", 0);
+    }
+    while (state.KeepRunning()) {
+        pEngine->execute(function, 0, 0, 0, 0, "[Test]",
+                         mixxx::Duration::fromMillis(0));
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+    state.SetLabel(state.range_x() == 0 ? "by name" : "by handle");
+    pEngine->gracefulShutdown();
+    delete pEngine;
+}
+BENCHMARK(BM_ControllerEngine_SetValue)->Arg(0)->Arg(1);
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <QSet>
+
+#include "effects/effectprocessor.h"
+#include "engine/channelhandle.h"
+#include "test/baseeffecttest.h"
+
+namespace {
+
+const mixxx::EngineParameters kBufferParameters(
+        mixxx::AudioSignal::SampleRate(96000),
+        MAX_BUFFER_LEN / mixxx::kEngineChannelCount);
+
+class RecyclableTestState : public EffectState {
+  public:
+    static constexpr std::size_t kAllocatedBytes = 1024;
+
+    RecyclableTestState(const mixxx::EngineParameters& bufferParameters)
+            : EffectState(bufferParameters),
+              value(0) {
+        ++s_constructed;
+    }
+
+    bool isRecyclable() const override {
+        return true;
+    }
+
+    void reset(const mixxx::EngineParameters& bufferParameters) override {
+        Q_UNUSED(bufferParameters);
+        value = 0;
+    }
+
+    std::size_t allocatedBytes() const override {
+        return kAllocatedBytes;
+    }
+
+    int value;
+
+    static int s_constructed;
+};
+
+int RecyclableTestState::s_constructed = 0;
+
+class TestState : public EffectState {
+  public:
+    TestState(const mixxx::EngineParameters& bufferParameters)
+            : EffectState(bufferParameters) {
+        ++s_constructed;
+    }
+
+    static int s_constructed;
+};
+
+int TestState::s_constructed = 0;
+
+template <typename State>
+class TestEffectProcessor : public EffectProcessorImpl<State> {
+  public:
+    void processChannel(const ChannelHandle& handle,
+                        State* pState,
+                        const CSAMPLE* pInput, CSAMPLE* pOutput,
+                        const mixxx::EngineParameters& bufferParameters,
+                        const EffectEnableState enableState,
+                        const GroupFeatureState& groupFeatures) override {
+        Q_UNUSED(handle);
+        Q_UNUSED(pState);
+        Q_UNUSED(pInput);
+        Q_UNUSED(pOutput);
+        Q_UNUSED(bufferParameters);
+        Q_UNUSED(enableState);
+        Q_UNUSED(groupFeatures);
+    }
+};
+
+class EffectStatePoolTest : public BaseEffectTest {
+  protected:
+    EffectStatePoolTest()
+            : m_master(m_factory.getOrCreateHandle("[Master]"), "[Master]"),
+              m_headphone(m_factory.getOrCreateHandle("[Headphone]"), "[Headphone]") {
+        m_pEffectsManager->registerOutputChannel(m_master);
+        m_pEffectsManager->registerOutputChannel(m_headphone);
+        for (int i = 1; i <= 4; ++i) {
+            const QString group = QString("[Channel%1]").arg(i);
+            m_pEffectsManager->registerInputChannel(ChannelHandleAndGroup(
+                    m_factory.getOrCreateHandle(group), group));
+        }
+        RecyclableTestState::s_constructed = 0;
+        TestState::s_constructed = 0;
+    }
+
+    ChannelHandleFactory m_factory;
+    ChannelHandleAndGroup m_master;
+    ChannelHandleAndGroup m_headphone;
+};
+
+TEST_F(EffectStatePoolTest, PreallocatesRecyclableStates) {
+    TestEffectProcessor<RecyclableTestState> processor;
+    processor.initialize(QSet<ChannelHandleAndGroup>(),
+            m_pEffectsManager.data(), kBufferParameters);
+    // 4 inputs * 2 outputs
+    EXPECT_EQ(8, RecyclableTestState::s_constructed);
+    EXPECT_EQ(8 * (sizeof(RecyclableTestState) + RecyclableTestState::kAllocatedBytes),
+            processor.stateMemoryBytes());
+
+    for (int i = 0; i < 8; ++i) {
+        auto pState = static_cast<RecyclableTestState*>(
+                processor.createState(kBufferParameters));
+        pState->value = i + 1;
+        delete pState;
+    }
+    EXPECT_EQ(8, RecyclableTestState::s_constructed);
+}
+
+TEST_F(EffectStatePoolTest, RecyclesStatesOfDisabledInputs) {
+    TestEffectProcessor<RecyclableTestState> processor;
+    processor.initialize(QSet<ChannelHandleAndGroup>(),
+            m_pEffectsManager.data(), kBufferParameters);
+    const std::size_t memoryBytes = processor.stateMemoryBytes();
+
+    const ChannelHandle input = m_factory.getOrCreateHandle("[Channel1]");
+    EffectStatesMap statesMap;
+    statesMap.insert(m_master.handle(), processor.createState(kBufferParameters));
+    statesMap.insert(m_headphone.handle(), processor.createState(kBufferParameters));
+    static_cast<RecyclableTestState*>(statesMap[m_master.handle()])->value = 42;
+    ASSERT_TRUE(processor.loadStatesForInputChannel(&input, &statesMap));
+    EXPECT_EQ(memoryBytes, processor.stateMemoryBytes());
+
+    processor.deleteStatesForInputChannel(&input);
+    EXPECT_EQ(memoryBytes, processor.stateMemoryBytes());
+
+    // A recycled state is reset before it is reused
+    for (int i = 0; i < 8; ++i) {
+        auto pState = static_cast<RecyclableTestState*>(
+                processor.createState(kBufferParameters));
+        EXPECT_EQ(0, pState->value);
+        delete pState;
+    }
+    EXPECT_EQ(8, RecyclableTestState::s_constructed);
+}
+
+TEST_F(EffectStatePoolTest, DeletesNonRecyclableStates) {
+    TestEffectProcessor<TestState> processor;
+    processor.initialize(QSet<ChannelHandleAndGroup>(),
+            m_pEffectsManager.data(), kBufferParameters);
+    // The probe state is deleted immediately
+    EXPECT_EQ(1, TestState::s_constructed);
+    EXPECT_EQ(0U, processor.stateMemoryBytes());
+
+    const ChannelHandle input = m_factory.getOrCreateHandle("[Channel1]");
+    EffectStatesMap statesMap;
+    statesMap.insert(m_master.handle(), processor.createState(kBufferParameters));
+    statesMap.insert(m_headphone.handle(), processor.createState(kBufferParameters));
+    ASSERT_TRUE(processor.loadStatesForInputChannel(&input, &statesMap));
+    EXPECT_EQ(2 * sizeof(TestState), processor.stateMemoryBytes());
+
+    processor.deleteStatesForInputChannel(&input);
+    EXPECT_EQ(0U, processor.stateMemoryBytes());
+}
+
+} // namespace
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilteriirbank.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kBufferSize = 512;
+
+class EngineFilterIIRBankTest : public testing::Test {
+  protected:
+    EngineFilterIIRBankTest()
+            : m_input(kBufferSize) {
+        // A deterministic noise with a DC offset and full scale peaks
+        unsigned int seed = 1;
+        for (int i = 0; i < kBufferSize; ++i) {
+            seed = seed * 1103515245 + 12345;
+            m_input[i] = ((seed >> 16) % 2001) / 1000.0f - 0.9f;
+        }
+    }
+
+    // The bank must produce exactly the same samples and leave the
+    // filters in exactly the same state as the scalar filters.
+    template<typename FilterA, typename FilterB>
+    void assertBankMatchesFilters(FilterA* pScalarA, FilterB* pScalarB,
+            FilterA* pBankA, FilterB* pBankB, bool inPlace) {
+        std::vector<CSAMPLE> scalarA(m_input);
+        std::vector<CSAMPLE> scalarB(m_input);
+        std::vector<CSAMPLE> bankA(m_input);
+        std::vector<CSAMPLE> bankB(m_input);
+        if (inPlace) {
+            pScalarA->process(scalarA.data(), scalarA.data(), kBufferSize);
+            pScalarB->process(scalarB.data(), scalarB.data(), kBufferSize);
+            EngineFilterIIRBank::process(
+                    pBankA, bankA.data(), bankA.data(),
+                    pBankB, bankB.data(), bankB.data(),
+                    kBufferSize);
+        } else {
+            pScalarA->process(m_input.data(), scalarA.data(), kBufferSize);
+            pScalarB->process(m_input.data(), scalarB.data(), kBufferSize);
+            EngineFilterIIRBank::process(
+                    pBankA, m_input.data(), bankA.data(),
+                    pBankB, m_input.data(), bankB.data(),
+                    kBufferSize);
+        }
+        for (int i = 0; i < kBufferSize; ++i) {
+            ASSERT_EQ(0, memcmp(&scalarA[i], &bankA[i], sizeof(CSAMPLE)))
+                    << "sample " << i << ": " << scalarA[i] << " != " << bankA[i];
+            ASSERT_EQ(0, memcmp(&scalarB[i], &bankB[i], sizeof(CSAMPLE)))
+                    << "sample " << i << ": " << scalarB[i] << " != " << bankB[i];
+        }
+    }
+
+    std::vector<CSAMPLE> m_input;
+};
+
+TEST_F(EngineFilterIIRBankTest, LinkwitzRiley8Crossover) {
+    EngineFilterLinkwitzRiley8Low scalarLow(kSampleRate, 2484);
+    EngineFilterLinkwitzRiley8High scalarHigh(kSampleRate, 2484);
+    EngineFilterLinkwitzRiley8Low bankLow(kSampleRate, 2484);
+    EngineFilterLinkwitzRiley8High bankHigh(kSampleRate, 2484);
+    // The first buffer ramps from the paused state and is processed by
+    // the scalar fallback, the following buffers run in the lanes
+    for (int i = 0; i < 4; ++i) {
+        assertBankMatchesFilters(&scalarLow, &scalarHigh,
+                &bankLow, &bankHigh, false);
+    }
+    // Ramping to new corners and back to the lanes
+    scalarLow.setFrequencyCorners(kSampleRate, 246);
+    scalarHigh.setFrequencyCorners(kSampleRate, 246);
+    bankLow.setFrequencyCorners(kSampleRate, 246);
+    bankHigh.setFrequencyCorners(kSampleRate, 246);
+    for (int i = 0; i < 3; ++i) {
+        assertBankMatchesFilters(&scalarLow, &scalarHigh,
+                &bankLow, &bankHigh, true);
+    }
+}
+
+TEST_F(EngineFilterIIRBankTest, BesselLowPasses) {
+    EngineFilterBessel4Low scalarLow4(kSampleRate, 246);
+    EngineFilterBessel4Low scalarHigh4(kSampleRate, 2484);
+    EngineFilterBessel4Low bankLow4(kSampleRate, 246);
+    EngineFilterBessel4Low bankHigh4(kSampleRate, 2484);
+    EngineFilterBessel8Low scalarLow8(kSampleRate, 246);
+    EngineFilterBessel8Low scalarHigh8(kSampleRate, 2484);
+    EngineFilterBessel8Low bankLow8(kSampleRate, 246);
+    EngineFilterBessel8Low bankHigh8(kSampleRate, 2484);
+    for (int i = 0; i < 3; ++i) {
+        assertBankMatchesFilters(&scalarLow4, &scalarHigh4,
+                &bankLow4, &bankHigh4, true);
+        assertBankMatchesFilters(&scalarLow8, &scalarHigh8,
+                &bankLow8, &bankHigh8, false);
+    }
+}
+
+TEST_F(EngineFilterIIRBankTest, MixedWithScalarProcessing) {
+    EngineFilterLinkwitzRiley8Low scalarLow(kSampleRate, 1000);
+    EngineFilterLinkwitzRiley8High scalarHigh(kSampleRate, 1000);
+    EngineFilterLinkwitzRiley8Low bankLow(kSampleRate, 1000);
+    EngineFilterLinkwitzRiley8High bankHigh(kSampleRate, 1000);
+    assertBankMatchesFilters(&scalarLow, &scalarHigh, &bankLow, &bankHigh, false);
+    assertBankMatchesFilters(&scalarLow, &scalarHigh, &bankLow, &bankHigh, false);
+
+    // The state written back by the bank continues in process()
+    std::vector<CSAMPLE> scalarOut(kBufferSize);
+    std::vector<CSAMPLE> bankOut(kBufferSize);
+    scalarLow.process(m_input.data(), scalarOut.data(), kBufferSize);
+    bankLow.process(m_input.data(), bankOut.data(), kBufferSize);
+    scalarHigh.process(m_input.data(), scalarOut.data(), kBufferSize);
+    bankHigh.process(m_input.data(), bankOut.data(), kBufferSize);
+    EXPECT_EQ(scalarOut, bankOut);
+    assertBankMatchesFilters(&scalarLow, &scalarHigh, &bankLow, &bankHigh, false);
+
+    // Pausing resets both filters
+    scalarLow.pauseFilter();
+    bankLow.pauseFilter();
+    assertBankMatchesFilters(&scalarLow, &scalarHigh, &bankLow, &bankHigh, false);
+    assertBankMatchesFilters(&scalarLow, &scalarHigh, &bankLow, &bankHigh, false);
+}
+
+}  // namespace
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include <QThread>
+
+#include "engine/engineparallelprocessor.h"
+
+namespace {
+
+class CountingTask : public EngineParallelProcessor::Task {
+  public:
+    explicit CountingTask(int maxTaskCount)
+            : m_counts(maxTaskCount) {
+        reset();
+    }
+
+    void reset() {
+        for (auto& count : m_counts) {
+            count.store(0);
+        }
+        m_otherThreadCount.store(0);
+    }
+
+    void processTask(int taskIndex) override {
+        m_counts[taskIndex].fetch_add(1);
+        if (QThread::currentThread() != m_pCallingThread) {
+            m_otherThreadCount.fetch_add(1);
+        }
+    }
+
+    int count(int taskIndex) const {
+        return m_counts[taskIndex].load();
+    }
+
+    int otherThreadCount() const {
+        return m_otherThreadCount.load();
+    }
+
+  private:
+    std::vector<std::atomic<int>> m_counts;
+    std::atomic<int> m_otherThreadCount;
+    QThread* const m_pCallingThread = QThread::currentThread();
+};
+
+TEST(EngineParallelProcessorTest, NoHelperThreads) {
+    EngineParallelProcessor processor(0);
+    EXPECT_EQ(0, processor.helperThreadCount());
+
+    CountingTask task(8);
+    processor.run(&task, 8);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(1, task.count(i));
+    }
+    EXPECT_EQ(0, task.otherThreadCount());
+}
+
+TEST(EngineParallelProcessorTest, HelperThreadCountIsLimited) {
+    EngineParallelProcessor processor(1024);
+    EXPECT_EQ(EngineParallelProcessor::maxHelperThreadCount(),
+            processor.helperThreadCount());
+}
+
+TEST(EngineParallelProcessorTest, ProcessesEachTaskOnce) {
+    EngineParallelProcessor processor(3);
+    const int kMaxTaskCount = 20;
+    CountingTask task(kMaxTaskCount);
+    // Many short runs with varying task counts to detect helper
+    // threads that claim tasks of the wrong run.
+    for (int run = 0; run < 10000; ++run) {
+        const int taskCount = run % (kMaxTaskCount + 1);
+        task.reset();
+        processor.run(&task, taskCount);
+        for (int i = 0; i < kMaxTaskCount; ++i) {
+            ASSERT_EQ(i < taskCount ? 1 : 0, task.count(i))
+                    << "run " << run << " task " << i;
+        }
+    }
+}
+
+TEST(EngineParallelProcessorTest, WakesParkedHelperThreads) {
+    EngineParallelProcessor processor(3);
+    const int kTaskCount = 8;
+    CountingTask task(kTaskCount);
+    for (int run = 0; run < 5; ++run) {
+        // Long enough for the helper threads to park between the runs
+        QThread::msleep(20);
+        task.reset();
+        processor.run(&task, kTaskCount);
+        for (int i = 0; i < kTaskCount; ++i) {
+            ASSERT_EQ(1, task.count(i)) << "run " << run << " task " << i;
+        }
+    }
+}
+
+}  // namespace
@@ -1,7 +1,10 @@
+#include <benchmark/benchmark.h>
+
 #include <QThread>
 #include <QtDebug>
 
 #include <atomic>
+#include <vector>
 
 #include "test/mixxxtest.h"
 
@@ -125,6 +128,34 @@ TEST_F(GlobalTrackCacheTest, resolveByFileInfo) {
     }
 }
 
+TEST_F(GlobalTrackCacheTest, lookupByIdWithoutLocking) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    const TrackId trackId(1);
+    EXPECT_EQ(TrackPointer(), GlobalTrackCache::lookupTrackById(trackId));
+
+    TrackPointer track;
+    {
+        GlobalTrackCacheResolver resolver(kTestFile);
+        track = resolver.getTrack();
+        ASSERT_TRUE(static_cast<bool>(track));
+        // Not visible until the id has been initialized
+        EXPECT_EQ(TrackPointer(), GlobalTrackCache::lookupTrackById(trackId));
+        resolver.initTrackIdAndUnlockCache(trackId);
+    }
+
+    auto trackById = GlobalTrackCache::lookupTrackById(trackId);
+    EXPECT_EQ(track, trackById);
+    EXPECT_EQ(2, track.use_count());
+    // Other ids are distributed among different shards
+    EXPECT_EQ(TrackPointer(), GlobalTrackCache::lookupTrackById(TrackId(2)));
+
+    trackById.reset();
+    track.reset();
+    EXPECT_EQ(TrackPointer(), GlobalTrackCache::lookupTrackById(trackId));
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+}
+
 TEST_F(GlobalTrackCacheTest, concurrentDelete) {
     ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
 
@@ -185,3 +216,67 @@ TEST_F(GlobalTrackCacheTest, evictWhileMoving) {
     EXPECT_TRUE(static_cast<bool>(track1));
     EXPECT_FALSE(static_cast<bool>(track2));
 }
+
+namespace {
+
+const int kBenchmarkTrackCount = 1000;
+
+// Populates the cache once with tracks that are referenced until
+// the application exits. The benchmark threads only read from
+// the cache. The fixture is intentionally leaked, because the
+// tracks must not be evicted after the application has been
+// destroyed.
+class GlobalTrackCacheBenchmarkFixture: public virtual GlobalTrackCacheSaver {
+  public:
+    static GlobalTrackCacheBenchmarkFixture* instance() {
+        static GlobalTrackCacheBenchmarkFixture* pInstance =
+                new GlobalTrackCacheBenchmarkFixture();
+        return pInstance;
+    }
+
+    void saveCachedTrack(Track* /*pTrack*/) noexcept override {
+    }
+
+  private:
+    GlobalTrackCacheBenchmarkFixture() {
+        GlobalTrackCache::createInstance(this);
+        m_tracks.reserve(kBenchmarkTrackCount);
+        for (int i = 0; i < kBenchmarkTrackCount; ++i) {
+            // The files don't exist and the tracks are only cached by id
+            GlobalTrackCacheResolver resolver(
+                    QFileInfo(kTestDir.absoluteFilePath(
+                            QString("benchmark-%1.mp3").arg(i))),
+                    TrackId(i + 1));
+            m_tracks.push_back(resolver.getTrack());
+        }
+    }
+
+    std::vector<TrackPointer> m_tracks;
+};
+
+} // anonymous namespace
+
+// Looks up cached tracks by id concurrently from multiple threads,
+// either through the exclusively locked cache (0) or through the
+// shards that are locked for reading (1).
+static void BM_GlobalTrackCacheLookupById(benchmark::State& state) {
+    GlobalTrackCacheBenchmarkFixture::instance();
+    const bool sharded = state.range_x() != 0;
+    // Each thread starts at a different track
+    int trackIndex = (state.thread_index * 7919) % kBenchmarkTrackCount;
+    while (state.KeepRunning()) {
+        const TrackId trackId(trackIndex + 1);
+        TrackPointer pTrack;
+        if (sharded) {
+            pTrack = GlobalTrackCache::lookupTrackById(trackId);
+        } else {
+            pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+        }
+        benchmark::DoNotOptimize(pTrack);
+        trackIndex = (trackIndex + 1) % kBenchmarkTrackCount;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(sharded ? "sharded" : "locked");
+}
+BENCHMARK(BM_GlobalTrackCacheLookupById)
+        ->Arg(0)->Arg(1)->ThreadRange(1, 16)->UseRealTime();
@@ -60,7 +60,7 @@ MixxxTest::ApplicationScope::~ApplicationScope() {
     s_pApplication.reset();
 }
 
-MixxxTest::MixxxTest()
+MixxxTestEnvironment::MixxxTestEnvironment()
         // This directory has to be deleted later to clean up the test env.
         : m_testDataDir(makeTestDir()),
           m_pConfig(new UserSettings(makeTestConfigFile(
@@ -68,7 +68,7 @@ MixxxTest::MixxxTest()
     ControlDoublePrivate::setUserConfig(m_pConfig);
 }
 
-MixxxTest::~MixxxTest() {
+MixxxTestEnvironment::~MixxxTestEnvironment() {
     // Mixxx leaks a ton of COs normally. To make new tests not affected by
     // previous tests, we clear our all COs after every MixxxTest completion.
     QList<QSharedPointer<ControlDoublePrivate>> leakedControls;
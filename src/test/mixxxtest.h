@@ -18,27 +18,16 @@
 
 typedef QScopedPointer<QTemporaryFile> ScopedTemporaryFile;
 
-class MixxxTest : public testing::Test {
+// The environment of each test, i.e. a test data directory with an empty
+// configuration. All ControlObjects that are left over are deleted and
+// the directory is removed on destruction. It doesn't depend on gtest and
+// is also set up by the benchmarks.
+class MixxxTestEnvironment {
   public:
-    MixxxTest();
-    virtual ~MixxxTest();
-
-    // ApplicationScope creates QApplication as a singleton and keeps
-    // it alive during all tests. This prevents issues with creating
-    // and destroying the QApplication multiple times in the same process.
-    // http://stackoverflow.com/questions/14243858/qapplication-segfaults-in-googletest
-    class ApplicationScope {
-    public:
-        ApplicationScope(int& argc, char** argv);
-        ~ApplicationScope();
-    };
-    friend class ApplicationScope;
+    MixxxTestEnvironment();
+    virtual ~MixxxTestEnvironment();
 
   protected:
-    static QApplication* application() {
-        return s_pApplication.data();
-    }
-
     UserSettingsPointer config() const {
         return m_pConfig;
     }
@@ -65,12 +54,32 @@ class MixxxTest : public testing::Test {
     }
 
   private:
-    static QScopedPointer<MixxxApplication> s_pApplication;
-
     const QDir m_testDataDir;
 
   protected:
     UserSettingsPointer m_pConfig;
 };
 
+class MixxxTest : public testing::Test, public MixxxTestEnvironment {
+  public:
+    // ApplicationScope creates QApplication as a singleton and keeps
+    // it alive during all tests. This prevents issues with creating
+    // and destroying the QApplication multiple times in the same process.
+    // http://stackoverflow.com/questions/14243858/qapplication-segfaults-in-googletest
+    class ApplicationScope {
+    public:
+        ApplicationScope(int& argc, char** argv);
+        ~ApplicationScope();
+    };
+    friend class ApplicationScope;
+
+  protected:
+    static QApplication* application() {
+        return s_pApplication.data();
+    }
+
+  private:
+    static QScopedPointer<MixxxApplication> s_pApplication;
+};
+
 #endif /* MIXXXTEST_H */
@@ -95,3 +95,181 @@ DECLARE_EFFECT_BENCHMARK(ReverbEffect)
 }  // namespace
 #endif
 
+#include <benchmark/benchmark.h>
+
+#include <QTemporaryDir>
+
+#include "effects/effectinstantiator.h"
+#include "effects/effectmanifest.h"
+#include "effects/effectprocessor.h"
+#include "effects/effectsmanager.h"
+#include "engine/channelhandle.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "engine/effects/engineeffectrack.h"
+#include "engine/effects/engineeffectsmanager.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "preferences/usersettings.h"
+#include "util/memory.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+// Passes its input through, so the benchmark measures the buffer traffic
+// of the effect chains rather than the DSP of any particular effect.
+class PassthroughEffect : public EffectProcessorImpl<EffectState> {
+  public:
+    PassthroughEffect(EngineEffect* pEffect) {
+        Q_UNUSED(pEffect);
+    }
+
+    static EffectManifestPointer getManifest() {
+        EffectManifestPointer pManifest(new EffectManifest());
+        pManifest->setId("org.mixxx.test.passthrough");
+        pManifest->setName("Passthrough");
+        pManifest->setEffectRampsFromDry(true);
+        return pManifest;
+    }
+
+    void processChannel(const ChannelHandle& handle,
+                        EffectState* pState,
+                        const CSAMPLE* pInput, CSAMPLE* pOutput,
+                        const mixxx::EngineParameters& bufferParameters,
+                        const EffectEnableState enableState,
+                        const GroupFeatureState& groupFeatures) override {
+        Q_UNUSED(handle);
+        Q_UNUSED(pState);
+        Q_UNUSED(enableState);
+        Q_UNUSED(groupFeatures);
+        SampleUtil::copy(pOutput, pInput, bufferParameters.samplesPerBuffer());
+    }
+};
+
+// Mixes 8 channels into the master output through a rack of 4 chains with
+// 3 effects each, like ChannelMixer::applyEffectsAndMixChannels does. The
+// argument is the number of chains with enabled effects.
+static void BM_EffectChainsProcessPostFaderAndMix(benchmark::State& state) {
+    const int kNumChannels = 8;
+    const int kNumChains = 4;
+    const int kNumEffectsPerChain = 3;
+    const unsigned int kSampleRate = 44100;
+    const unsigned int kNumSamples = 1024;
+    const mixxx::EngineParameters bufferParameters(
+            mixxx::AudioSignal::SampleRate(kSampleRate),
+            kNumSamples / mixxx::kEngineChannelCount);
+    const int numActiveChains = state.range_x();
+
+    QTemporaryDir tempDir;
+    UserSettingsPointer pConfig(new UserSettings(tempDir.path() + "/mixxx.cfg"));
+    ChannelHandleFactory factory;
+    EffectsManager effectsManager(nullptr, pConfig, &factory);
+    const ChannelHandleAndGroup master(factory.getOrCreateHandle("[Master]"), "[Master]");
+    effectsManager.registerOutputChannel(master);
+    QList<ChannelHandle> inputHandles;
+    for (int i = 1; i <= kNumChannels; ++i) {
+        const QString group = QString("[Channel%1]").arg(i);
+        const ChannelHandle handle = factory.getOrCreateHandle(group);
+        effectsManager.registerInputChannel(ChannelHandleAndGroup(handle, group));
+        inputHandles.append(handle);
+    }
+
+    QPair<EffectsRequestPipe*, EffectsResponsePipe*> pipes =
+            TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                    1024, 1024, false, false);
+    QScopedPointer<EffectsRequestPipe> pRequestPipe(pipes.first);
+    // Takes ownership of the response pipe
+    EngineEffectsManager engineEffectsManager(pipes.second);
+    EffectsResponsePipe* pResponsePipe = pipes.second;
+
+    // Destroyed before engineEffectsManager, which does not own them
+    EngineEffectRack rack(0);
+    std::vector<std::unique_ptr<EngineEffectChain>> chains;
+    std::vector<std::unique_ptr<EngineEffect>> effects;
+
+    {
+        EffectsRequest request;
+        request.type = EffectsRequest::ADD_EFFECT_RACK;
+        request.AddEffectRack.pRack = &rack;
+        request.AddEffectRack.signalProcessingStage = SignalProcessingStage::Postfader;
+        engineEffectsManager.processEffectsRequest(request, pResponsePipe);
+    }
+
+    const EffectManifestPointer pManifest = PassthroughEffect::getManifest();
+    const EffectInstantiatorPointer pInstantiator(
+            new EffectProcessorInstantiator<PassthroughEffect>());
+    for (int i = 0; i < kNumChains; ++i) {
+        chains.push_back(std::make_unique<EngineEffectChain>(
+                QString("org.mixxx.test.chain%1").arg(i),
+                effectsManager.registeredInputChannels(),
+                effectsManager.registeredOutputChannels()));
+        EngineEffectChain* pChain = chains.back().get();
+        {
+            EffectsRequest request;
+            request.type = EffectsRequest::ADD_CHAIN_TO_RACK;
+            request.AddChainToRack.pChain = pChain;
+            request.AddChainToRack.iIndex = i;
+            rack.processEffectsRequest(request, pResponsePipe);
+        }
+        {
+            EffectsRequest request;
+            request.type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+            request.SetEffectChainParameters.enabled = true;
+            request.SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+            request.SetEffectChainParameters.mix = 0.5;
+            pChain->processEffectsRequest(request, pResponsePipe);
+        }
+
+        QList<EngineEffect*> chainEffects;
+        for (int j = 0; j < kNumEffectsPerChain; ++j) {
+            effects.push_back(std::make_unique<EngineEffect>(pManifest,
+                    QSet<ChannelHandleAndGroup>(), &effectsManager, pInstantiator));
+            EngineEffect* pEffect = effects.back().get();
+            chainEffects.append(pEffect);
+            EffectsRequest request;
+            request.type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
+            request.AddEffectToChain.pEffect = pEffect;
+            request.AddEffectToChain.iIndex = j;
+            pChain->processEffectsRequest(request, pResponsePipe);
+            if (i < numActiveChains) {
+                EffectsRequest enableRequest;
+                enableRequest.type = EffectsRequest::SET_EFFECT_PARAMETERS;
+                enableRequest.SetEffectParameters.enabled = true;
+                pEffect->processEffectsRequest(enableRequest, pResponsePipe);
+            }
+        }
+
+        for (const ChannelHandle& inputHandle : inputHandles) {
+            EffectsRequest request;
+            request.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+            request.EnableInputChannelForChain.pChannelHandle = &inputHandle;
+            request.EnableInputChannelForChain.pEffectStatesMapArray =
+                    new EffectStatesMapArray;
+            for (int j = 0; j < chainEffects.size(); ++j) {
+                (*request.EnableInputChannelForChain.pEffectStatesMapArray)[j].insert(
+                        master.handle(), chainEffects[j]->createState(bufferParameters));
+            }
+            pChain->processEffectsRequest(request, pResponsePipe);
+        }
+    }
+
+    mixxx::SampleBuffer input(kNumSamples);
+    SampleUtil::fill(input.data(), 0.5f, kNumSamples);
+    mixxx::SampleBuffer output(kNumSamples);
+    const GroupFeatureState featureState;
+    while (state.KeepRunning()) {
+        SampleUtil::clear(output.data(), kNumSamples);
+        for (const ChannelHandle& inputHandle : inputHandles) {
+            engineEffectsManager.processPostFaderAndMix(
+                    inputHandle, master.handle(),
+                    input.data(), output.data(),
+                    kNumSamples, kSampleRate, featureState,
+                    CSAMPLE_GAIN(0.8), CSAMPLE_GAIN(0.8));
+        }
+        benchmark::DoNotOptimize(output.data()[kNumSamples / 2]);
+    }
+}
+BENCHMARK(BM_EffectChainsProcessPostFaderAndMix)
+        ->Arg(0)->Arg(1)->Arg(2)->Arg(4);
+
+}  // namespace
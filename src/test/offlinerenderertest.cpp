@@ -0,0 +1,243 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <sndfile.h>
+
+#include <cmath>
+#include <vector>
+
+#include "engine/offlinerenderer.h"
+#include "recording/defs_recording.h"
+#include "test/signalpathtest.h"
+#include "util/math.h"
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kFramesPerBuffer = 1024;
+
+class OfflineRendererTest : public SignalPathTest {
+  protected:
+    OfflineRendererTest()
+            : m_renderer(config(), m_pEngineMaster, kSampleRate, kFramesPerBuffer) {
+    }
+
+    // Returns the peak of each buffer of the rendered file
+    std::vector<CSAMPLE> readBufferPeaks(const QString& fileName) {
+        SF_INFO info;
+        info.format = 0;
+        SNDFILE* pSndfile = sf_open(fileName.toLocal8Bit().constData(), SFM_READ, &info);
+        EXPECT_NE(nullptr, pSndfile);
+        std::vector<CSAMPLE> peaks;
+        if (!pSndfile) {
+            return peaks;
+        }
+        EXPECT_EQ(kSampleRate, info.samplerate);
+        EXPECT_EQ(2, info.channels);
+        std::vector<float> buffer(kFramesPerBuffer * 2);
+        sf_count_t frames;
+        while ((frames = sf_readf_float(pSndfile, buffer.data(), kFramesPerBuffer)) > 0) {
+            CSAMPLE peak = 0;
+            for (sf_count_t i = 0; i < frames * 2; ++i) {
+                peak = math_max(peak, fabsf(buffer[i]));
+            }
+            peaks.push_back(peak);
+        }
+        sf_close(pSndfile);
+        return peaks;
+    }
+
+    OfflineRenderer m_renderer;
+};
+
+TEST(ControlTimelineTest, ParsesEvents) {
+    ControlTimeline timeline;
+    QString errorMessage;
+    ASSERT_TRUE(timeline.parse(
+            "# seconds control value\n"
+            "\n"
+            "2.5  [Master],crossfader  -0.5\n"
+            "0    [Channel1],play      1\n"
+            "  2.5 [Channel1],load     /path/with spaces/track.mp3\n",
+            &errorMessage)) << errorMessage.toStdString();
+
+    const QList<ControlTimeline::Event>& events = timeline.events();
+    ASSERT_EQ(3, events.size());
+    EXPECT_EQ(0.0, events[0].seconds);
+    EXPECT_EQ(ConfigKey("[Channel1]", "play"), events[0].key);
+    EXPECT_EQ("1", events[0].value);
+    // Events at the same time keep their order
+    EXPECT_EQ(ConfigKey("[Master]", "crossfader"), events[1].key);
+    EXPECT_EQ("-0.5", events[1].value);
+    EXPECT_EQ(ConfigKey("[Channel1]", "load"), events[2].key);
+    EXPECT_EQ("/path/with spaces/track.mp3", events[2].value);
+    EXPECT_EQ(2.5, timeline.durationSeconds());
+}
+
+TEST(ControlTimelineTest, RejectsInvalidEvents) {
+    ControlTimeline timeline;
+    timeline.addEvent(1.0, ConfigKey("[Channel1]", "play"), 1.0);
+    QString errorMessage;
+    EXPECT_FALSE(timeline.parse("x [Channel1],play 1", &errorMessage));
+    EXPECT_FALSE(timeline.parse("-1 [Channel1],play 1", &errorMessage));
+    EXPECT_FALSE(timeline.parse("1 Channel1,play 1", &errorMessage));
+    EXPECT_FALSE(timeline.parse("1 [Channel1],play", &errorMessage));
+    EXPECT_FALSE(errorMessage.isEmpty());
+    // The timeline is unchanged
+    ASSERT_EQ(1, timeline.events().size());
+    EXPECT_EQ("1", timeline.events().first().value);
+}
+
+TEST_F(OfflineRendererTest, RendersTimelineToFile) {
+    // Both events are in the middle of a buffer and are applied at its start
+    ControlTimeline timeline;
+    timeline.addEvent(0.5, ConfigKey(m_sGroup1, "play"), 1.0);
+    timeline.addEvent(2.0, ConfigKey(m_sGroup1, "volume"), 0.0);
+    const int playBuffer = 0.5 * kSampleRate / kFramesPerBuffer;
+    const int muteBuffer = 2.0 * kSampleRate / kFramesPerBuffer;
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString fileName = dir.path() + "/render.wav";
+    QString errorMessage;
+    ASSERT_TRUE(m_renderer.renderToFile(timeline, 2.5, fileName,
+            EncoderFactory::getFactory().getFormatFor(ENCODING_WAVE),
+            &errorMessage)) << errorMessage.toStdString();
+    EXPECT_EQ(static_cast<SINT>(2.5 * kSampleRate), m_renderer.renderedFrames());
+    EXPECT_GT(m_renderer.realtimeFactor(), 0.0);
+
+    const std::vector<CSAMPLE> peaks = readBufferPeaks(fileName);
+    ASSERT_EQ(static_cast<size_t>(
+            (m_renderer.renderedFrames() + kFramesPerBuffer - 1) / kFramesPerBuffer),
+            peaks.size());
+    for (int i = 0; i < static_cast<int>(peaks.size()); ++i) {
+        if (i < playBuffer || i > muteBuffer) {
+            EXPECT_EQ(0.0f, peaks[i]) << "buffer " << i;
+        } else {
+            // The renderer waits for the reader, so faster than realtime
+            // playback never runs into cache misses.
+            EXPECT_GT(peaks[i], 0.0f) << "buffer " << i;
+        }
+    }
+}
+
+TEST_F(OfflineRendererTest, CommandHandlerReceivesNonNumericEvents) {
+    ControlTimeline timeline;
+    timeline.addEvent(0.1, ConfigKey(m_sGroup2, "load"), QString("track.mp3"));
+    QString errorMessage;
+    // Without a handler the event can't be applied
+    EXPECT_FALSE(m_renderer.render(timeline, 0.2, &errorMessage));
+    EXPECT_FALSE(errorMessage.isEmpty());
+
+    QList<ConfigKey> keys;
+    QStringList values;
+    m_renderer.setCommandHandler([&keys, &values](const ConfigKey& key, const QString& value) {
+        keys.append(key);
+        values.append(value);
+        return true;
+    });
+    EXPECT_TRUE(m_renderer.render(timeline, 0.2, &errorMessage));
+    ASSERT_EQ(1, keys.size());
+    EXPECT_EQ(ConfigKey(m_sGroup2, "load"), keys.first());
+    EXPECT_EQ("track.mp3", values.first());
+}
+
+TEST_F(OfflineRendererTest, UnknownControlAbortsRendering) {
+    ControlTimeline timeline;
+    timeline.addEvent(0.1, ConfigKey(m_sGroup1, "no_such_control"), 1.0);
+    QString errorMessage;
+    EXPECT_FALSE(m_renderer.render(timeline, 1.0, &errorMessage));
+    EXPECT_FALSE(errorMessage.isEmpty());
+    EXPECT_LT(m_renderer.renderedFrames(), kSampleRate);
+}
+
+TEST_F(OfflineRendererTest, RendersLoadedTrackDeterministically) {
+    // The track is loaded and starts playing in the first buffer, the
+    // renderer must wait until it has been loaded
+    ControlTimeline timeline;
+    timeline.addEvent(0.0, ConfigKey(m_sGroup1, "load"), QString("sine-30.wav"));
+    m_renderer.setCommandHandler([this](const ConfigKey& key, const QString& value) {
+        Q_UNUSED(value);
+        if (key != ConfigKey(m_sGroup1, "load")) {
+            return false;
+        }
+        const QString location = QDir::currentPath() + "/src/test/sine-30.wav";
+        m_pMixerDeck1->slotLoadTrack(Track::newTemporary(location), true);
+        return true;
+    });
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const Encoder::Format format =
+            EncoderFactory::getFactory().getFormatFor(ENCODING_WAVE);
+    QString errorMessage;
+    const QString fileName1 = dir.path() + "/render1.wav";
+    ASSERT_TRUE(m_renderer.renderToFile(timeline, 1.0, fileName1,
+            format, &errorMessage)) << errorMessage.toStdString();
+    const QString fileName2 = dir.path() + "/render2.wav";
+    ASSERT_TRUE(m_renderer.renderToFile(timeline, 1.0, fileName2,
+            format, &errorMessage)) << errorMessage.toStdString();
+
+    QFile file1(fileName1);
+    QFile file2(fileName2);
+    ASSERT_TRUE(file1.open(QIODevice::ReadOnly));
+    ASSERT_TRUE(file2.open(QIODevice::ReadOnly));
+    const QByteArray data1 = file1.readAll();
+    EXPECT_EQ(data1, file2.readAll());
+
+    const std::vector<CSAMPLE> peaks = readBufferPeaks(fileName1);
+    ASSERT_GT(peaks.size(), 2u);
+    EXPECT_GT(peaks[1], 0.0f);
+}
+
+class OfflineRendererBenchmarkFixture : public MixxxTestEnvironment,
+        public SignalPathEnvironment {
+  public:
+    OfflineRendererBenchmarkFixture()
+            : SignalPathEnvironment(config()),
+              m_renderer(config(), m_pEngineMaster, kSampleRate, kFramesPerBuffer) {
+        loadTestTracks();
+    }
+
+    OfflineRenderer* renderer() {
+        return &m_renderer;
+    }
+
+  private:
+    OfflineRenderer m_renderer;
+};
+
+// Renders a mix of all decks playing at different rates, i.e. the
+// throughput of the whole engine. The label shows the realtime factor.
+static void BM_OfflineRender(benchmark::State& state) {
+    OfflineRendererBenchmarkFixture fixture;
+    const double seconds = state.range_x();
+    ControlTimeline timeline;
+    const char* groups[] = { "[Channel1]", "[Channel2]", "[Channel3]" };
+    for (int i = 0; i < 3; ++i) {
+        timeline.addEvent(0.0, ConfigKey(groups[i], "playposition"), 0.0);
+        timeline.addEvent(0.0, ConfigKey(groups[i], "rate"), 0.25 * i);
+        timeline.addEvent(0.0, ConfigKey(groups[i], "play"), 1.0);
+    }
+
+    double realtimeFactor = 0.0;
+    QString errorMessage;
+    while (state.KeepRunning()) {
+        if (!fixture.renderer()->render(timeline, seconds, &errorMessage)) {
+            state.SetLabel(errorMessage.toStdString());
+            continue;
+        }
+        realtimeFactor = fixture.renderer()->realtimeFactor();
+    }
+    if (errorMessage.isEmpty()) {
+        state.SetLabel(QString("realtime factor %1")
+                .arg(realtimeFactor, 0, 'f', 1).toStdString());
+    }
+}
+BENCHMARK(BM_OfflineRender)->Arg(10)->Arg(60);
+
+} // namespace
@@ -1,15 +1,26 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <benchmark/benchmark.h>
 
+#include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QScopedPointer>
 
+#include "control/controlpotmeter.h"
+#include "controllers/midi/midicontrollerpreset.h"
+#include "controllers/midi/midimessage.h"
 #include "controllers/midi/portmidicontroller.h"
 #include "controllers/midi/portmididevice.h"
 #include "test/mixxxtest.h"
+#include "util/time.h"
 
 using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::InvokeWithoutArgs;
 using ::testing::NotNull;
 using ::testing::Return;
+using ::testing::SaveArg;
 using ::testing::Sequence;
 using ::testing::SetArrayArgument;
 
@@ -18,9 +29,11 @@ class MockPortMidiController : public PortMidiController {
     MockPortMidiController(const PmDeviceInfo* inputDeviceInfo,
                            const PmDeviceInfo* outputDeviceInfo,
                            int inputDeviceIndex,
-                           int outputDeviceIndex) : PortMidiController(
+                           int outputDeviceIndex,
+                           bool useInputThread = false) : PortMidiController(
                                inputDeviceInfo, outputDeviceInfo,
-                               inputDeviceIndex, outputDeviceIndex) {
+                               inputDeviceIndex, outputDeviceIndex,
+                               useInputThread) {
     }
     ~MockPortMidiController() override {
     }
@@ -33,6 +46,10 @@ class MockPortMidiController : public PortMidiController {
         PortMidiController::sendSysexMsg(data, length);
     }
 
+    void setOutputBatching(bool enabled) override {
+        PortMidiController::setOutputBatching(enabled);
+    }
+
     MOCK_METHOD4(receive, void(unsigned char, unsigned char, unsigned char,
                                mixxx::Duration));
     MOCK_METHOD2(receive, void(const QByteArray, mixxx::Duration));
@@ -51,6 +68,7 @@ class MockPortMidiDevice : public PortMidiDevice {
     MOCK_METHOD0(poll, PmError());
     MOCK_METHOD2(read, int(PmEvent*, int32_t));
     MOCK_METHOD1(writeShort, PmError(int32_t));
+    MOCK_METHOD2(write, PmError(PmEvent*, int32_t));
     MOCK_METHOD1(writeSysEx, PmError(unsigned char*));
 };
 
@@ -78,6 +96,50 @@ class PortMidiControllerTest : public MixxxTest {
         m_pController->setPortMidiOutputDevice(m_mockOutput);
     }
 
+  public:
+    // For the benchmarks, which can not be friends of PortMidiController.
+    static void setPortMidiInputDevice(PortMidiController* pController,
+                                       PortMidiDevice* pDevice) {
+        pController->setPortMidiInputDevice(pDevice);
+    }
+
+    static int openController(PortMidiController* pController) {
+        return pController->open();
+    }
+
+    static int closeController(PortMidiController* pController) {
+        return pController->close();
+    }
+
+    static bool pollController(PortMidiController* pController) {
+        return pController->poll();
+    }
+
+  protected:
+    // Replaces the controller with one that reads its input on a
+    // PortMidiReader thread.
+    void useInputThread() {
+        m_mockInput = new MockPortMidiDevice(&m_inputDeviceInfo, 0);
+        m_mockOutput = new MockPortMidiDevice(&m_outputDeviceInfo, 0);
+        m_pController.reset(new MockPortMidiController(&m_inputDeviceInfo,
+                                                       &m_outputDeviceInfo,
+                                                       0, 0, true));
+        m_pController->setPortMidiInputDevice(m_mockInput);
+        m_pController->setPortMidiOutputDevice(m_mockOutput);
+    }
+
+    // Processes queued events until done() returns true or a timeout.
+    template <typename Predicate>
+    bool processEventsUntil(Predicate done) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!done() && timer.elapsed() < 1000) {
+            QCoreApplication::processEvents();
+            QThread::msleep(1);
+        }
+        return done();
+    }
+
     void openDevice() {
         m_pController->open();
     }
@@ -168,6 +230,67 @@ TEST_F(PortMidiControllerTest, WriteShort) {
     m_pController->sendShortMsg(0x80, 0x3C, 0x40);
 };
 
+TEST_F(PortMidiControllerTest, WriteShort_Batched) {
+    EXPECT_CALL(*m_mockOutput, isOpen())
+            .WillRepeatedly(Return(true));
+    EXPECT_CALL(*m_mockOutput, writeShort(_))
+            .Times(0);
+    std::vector<PmMessage> written;
+    EXPECT_CALL(*m_mockOutput, write(NotNull(), 4))
+            .WillOnce(DoAll(Invoke([&written](PmEvent* pEvents, int32_t length) {
+                                for (int i = 0; i < length; ++i) {
+                                    written.push_back(pEvents[i].message);
+                                }
+                            }),
+                            Return(pmNoError)));
+
+    m_pController->setOutputBatching(true);
+    m_pController->sendShortMsg(0x90, 0x3C, 0x7F);
+    // Replaces the last message of the channel
+    m_pController->sendShortMsg(0x80, 0x3C, 0x00);
+    m_pController->sendShortMsg(0xB0, 0x10, 0x40);
+    // Messages on other channels don't interrupt the replacement
+    m_pController->sendShortMsg(0xB1, 0x10, 0x40);
+    m_pController->sendShortMsg(0xB0, 0x10, 0x20);
+    // Not the last message of the channel anymore
+    m_pController->sendShortMsg(0x90, 0x3C, 0x7F);
+    EXPECT_TRUE(written.empty());
+
+    // The batch is sent once control returns to the event loop.
+    application()->processEvents();
+    ASSERT_EQ(4u, written.size());
+    EXPECT_EQ(0x003C80, written[0]);
+    EXPECT_EQ(0x2010B0, written[1]);
+    EXPECT_EQ(0x4010B1, written[2]);
+    EXPECT_EQ(0x7F3C90, written[3]);
+};
+
+TEST_F(PortMidiControllerTest, WriteShort_BatchedKeepsNrpnOrder) {
+    EXPECT_CALL(*m_mockOutput, isOpen())
+            .WillRepeatedly(Return(true));
+    std::vector<PmMessage> written;
+    EXPECT_CALL(*m_mockOutput, write(NotNull(), 8))
+            .WillOnce(DoAll(Invoke([&written](PmEvent* pEvents, int32_t length) {
+                                for (int i = 0; i < length; ++i) {
+                                    written.push_back(pEvents[i].message);
+                                }
+                            }),
+                            Return(pmNoError)));
+
+    // Two NRPNs, each selected by CC 99/98 and set by CC 6/38
+    const std::vector<PmMessage> expected = {
+            0x0163B0, 0x0262B0, 0x1006B0, 0x2026B0,
+            0x0163B0, 0x0362B0, 0x3006B0, 0x4026B0};
+    m_pController->setOutputBatching(true);
+    for (const auto message : expected) {
+        m_pController->sendShortMsg(Pm_MessageStatus(message),
+                Pm_MessageData1(message), Pm_MessageData2(message));
+    }
+
+    application()->processEvents();
+    EXPECT_EQ(expected, written);
+};
+
 TEST_F(PortMidiControllerTest, WriteSysex) {
     QList<int> sysex;
     sysex.append(0xF0);
@@ -479,3 +602,176 @@ TEST_F(PortMidiControllerTest, Poll_Read_SysEx_BufferOverflow) {
     pollDevice();
     pollDevice();
 };
+
+TEST_F(PortMidiControllerTest, InputThread_NotPolled) {
+    EXPECT_TRUE(m_pController->isPolling());
+    EXPECT_FALSE(m_pController->hasArrivalTimestamps());
+    useInputThread();
+    EXPECT_FALSE(m_pController->isPolling());
+    EXPECT_TRUE(m_pController->hasArrivalTimestamps());
+}
+
+TEST_F(PortMidiControllerTest, InputThread_Read) {
+    useInputThread();
+
+    std::vector<PmEvent> messages;
+    messages.push_back(MakeEvent(0x403C90, 0x0));
+    messages.push_back(MakeEvent(0x332211F0, 0x1));
+    messages.push_back(MakeEvent(0xF7665544, 0x2));
+
+    QByteArray sysex;
+    sysex.append(0xF0);
+    sysex.append(0x11);
+    sysex.append(0x22);
+    sysex.append(0x33);
+    sysex.append(0x44);
+    sysex.append(0x55);
+    sysex.append(0x66);
+    sysex.append(0xF7);
+
+    ON_CALL(*m_mockInput, isOpen())
+            .WillByDefault(Return(true));
+    ON_CALL(*m_mockOutput, isOpen())
+            .WillByDefault(Return(false));
+    EXPECT_CALL(*m_mockInput, openInput(MIXXX_PORTMIDI_BUFFER_LEN))
+            .WillOnce(Return(pmNoError));
+    EXPECT_CALL(*m_mockInput, poll())
+            .WillOnce(Return((PmError)TRUE))
+            .WillRepeatedly(Return((PmError)FALSE));
+    EXPECT_CALL(*m_mockInput, read(NotNull(), _))
+            .WillOnce(DoAll(SetArrayArgument<0>(messages.begin(), messages.end()),
+                            Return(messages.size())));
+    EXPECT_CALL(*m_mockInput, close())
+            .WillOnce(Return(pmNoError));
+
+    const mixxx::Duration beforeArrival = mixxx::Time::elapsed();
+    mixxx::Duration timestamp;
+    bool sysexReceived = false;
+    Sequence events;
+    EXPECT_CALL(*m_pController, receive(0x90, 0x3C, 0x40, _))
+            .InSequence(events)
+            .WillOnce(SaveArg<3>(&timestamp));
+    EXPECT_CALL(*m_pController, receive(sysex, _))
+            .InSequence(events)
+            .WillOnce(InvokeWithoutArgs([&sysexReceived] {
+                sysexReceived = true;
+            }));
+
+    // The controller is not polled, the events are delivered through the
+    // event loop of its thread.
+    openDevice();
+    EXPECT_TRUE(processEventsUntil([&sysexReceived] {
+        return sysexReceived;
+    }));
+    closeDevice();
+
+    // The events are stamped with their arrival time instead of the
+    // PortMidi timestamp.
+    EXPECT_LE(beforeArrival, timestamp);
+    EXPECT_GE(mixxx::Time::elapsed(), timestamp);
+}
+
+TEST_F(PortMidiControllerTest, InputThread_StopBeforeStart) {
+    // E.g. a controller that is closed right after it has been opened. The
+    // stop request must not be lost if the thread is scheduled afterwards.
+    EXPECT_CALL(*m_mockInput, poll())
+            .Times(0);
+    QMutex deviceMutex;
+    PortMidiReader reader(m_mockInput, &deviceMutex);
+    reader.stop();
+    reader.start();
+    EXPECT_TRUE(reader.wait(5000));
+}
+
+namespace {
+
+// Delivers a single message each time post() is called.
+class FakePortMidiDevice : public PortMidiDevice {
+  public:
+    explicit FakePortMidiDevice(const PmDeviceInfo* info)
+            : PortMidiDevice(info, 0),
+              m_message(0) {
+    }
+
+    void post(PmMessage message) {
+        m_message.store(message);
+    }
+
+    bool isOpen() const override {
+        return true;
+    }
+    PmError openInput(int32_t bufferSize) override {
+        Q_UNUSED(bufferSize);
+        return pmNoError;
+    }
+    PmError close() override {
+        return pmNoError;
+    }
+    PmError poll() override {
+        return m_message.load() != 0 ? (PmError)TRUE : (PmError)FALSE;
+    }
+    int read(PmEvent* buffer, int32_t length) override {
+        Q_UNUSED(length);
+        PmMessage message = m_message.fetchAndStoreOrdered(0);
+        if (message == 0) {
+            return 0;
+        }
+        buffer[0].message = message;
+        buffer[0].timestamp = 0;
+        return 1;
+    }
+
+  private:
+    QAtomicInt m_message;
+};
+
+} // anonymous namespace
+
+// Measures the time from the arrival of a MIDI message at the device until the
+// mapped control has changed. Arg 0 polls the device every millisecond like
+// the ControllerManager does, Arg 1 reads it on a PortMidiReader thread.
+static void BM_PortMidiController_ArrivalToControlChange(benchmark::State& state) {
+    const bool useInputThread = state.range_x() != 0;
+
+    PmDeviceInfo inputDeviceInfo;
+    inputDeviceInfo.name = "Benchmark Input Device";
+    inputDeviceInfo.interf = "Test";
+    inputDeviceInfo.input = 1;
+    inputDeviceInfo.output = 0;
+    inputDeviceInfo.opened = 0;
+
+    ConfigKey key("[Test]", "co");
+    ControlPotmeter co(key, 0.0, 1.0);
+    const unsigned char status = MIDI_CC | 0x01;
+    const unsigned char control = 0x10;
+    MidiControllerPreset preset;
+    preset.inputMappings.insertMulti(MidiKey(status, control).key,
+            MidiInputMapping(MidiKey(status, control), MidiOptions(), key));
+
+    PortMidiController controller(&inputDeviceInfo, nullptr, 0, 0,
+                                  useInputThread);
+    FakePortMidiDevice* pDevice = new FakePortMidiDevice(&inputDeviceInfo);
+    PortMidiControllerTest::setPortMidiInputDevice(&controller, pDevice);
+    controller.setPreset(preset);
+    PortMidiControllerTest::openController(&controller);
+
+    unsigned char value = 0x00;
+    while (state.KeepRunning()) {
+        value = value == 0x00 ? 0x7F : 0x00;
+        const bool expected = value != 0x00;
+        pDevice->post(Pm_Message(status, control, value));
+        while ((co.get() > 0.5) != expected) {
+            if (useInputThread) {
+                QCoreApplication::processEvents();
+            } else {
+                QThread::usleep(1000);
+                PortMidiControllerTest::pollController(&controller);
+            }
+        }
+    }
+
+    PortMidiControllerTest::closeController(&controller);
+    state.SetLabel(useInputThread ? "reader thread" : "polled");
+}
+BENCHMARK(BM_PortMidiController_ArrivalToControlChange)
+        ->Arg(0)->Arg(1)->UseRealTime();
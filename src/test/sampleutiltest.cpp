@@ -1,6 +1,8 @@
 #include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include <QtDebug>
 #include <QList>
 #include <QPair>
@@ -29,6 +31,7 @@ class SampleUtilTest : public testing::Test {
         }
     }
     void TearDown() override {
+        SampleUtilSimd::setEnabled(true);
         for (int i = 0; i < buffers.size(); ++i) {
             SampleUtil::free(buffers[i]);
         }
@@ -51,6 +54,14 @@ class SampleUtilTest : public testing::Test {
         }
     }
 
+    // Fills the buffer with a signal that exceeds the valid
+    // sample range and is different for each seed.
+    void FillBufferWithSignal(CSAMPLE* pBuffer, int length, int seed) {
+        for (int i = 0; i < length; ++i) {
+            pBuffer[i] = 1.5f * sin(0.01f * (seed + 1) * i + seed);
+        }
+    }
+
     QList<int> sizes;
     QList<CSAMPLE*> buffers;
     QList<int> evenBuffers;
@@ -146,6 +157,36 @@ TEST_F(SampleUtilTest, add2WithGain) {
     }
 }
 
+TEST_F(SampleUtilTest, add2WithRampingGainMatchesCopy2WithRampingGain) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int size = sizes[evenBuffers[i]];
+        CSAMPLE* src1 = buffers[evenBuffers[i]];
+        FillBufferWithSignal(src1, size, i);
+        CSAMPLE* src2 = SampleUtil::alloc(size);
+        FillBufferWithSignal(src2, size, i + 1);
+        CSAMPLE* expected = SampleUtil::alloc(size);
+        CSAMPLE* actual = SampleUtil::alloc(size);
+
+        SampleUtil::copy2WithRampingGain(expected,
+                src1, 0.9f, 0.4f,
+                src2, 0.1f, 0.6f,
+                size);
+        SampleUtil::add(expected, src1, size);
+        SampleUtil::copy(actual, src1, size);
+        SampleUtil::add2WithRampingGain(actual,
+                src1, 0.9f, 0.4f,
+                src2, 0.1f, 0.6f,
+                size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ(expected[j], actual[j]);
+        }
+
+        SampleUtil::free(src2);
+        SampleUtil::free(expected);
+        SampleUtil::free(actual);
+    }
+}
+
 TEST_F(SampleUtilTest, add3WithGain) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -363,6 +404,144 @@ TEST_F(SampleUtilTest, interleaveBuffer) {
     }
 }
 
+// The SIMD kernels must produce the same results as the scalar code. The
+// buffer sizes are chosen to exercise the scalar remainder of each kernel.
+
+TEST_F(SampleUtilTest, simdCopyWithRampingGainMatchesScalar) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int size = sizes[evenBuffers[i]];
+        CSAMPLE* src = buffers[evenBuffers[i]];
+        FillBufferWithSignal(src, size, i);
+        CSAMPLE* expected = SampleUtil::alloc(size);
+        CSAMPLE* actual = SampleUtil::alloc(size);
+
+        SampleUtilSimd::setEnabled(false);
+        SampleUtil::copyWithRampingGain(expected, src, 0.1f, 0.9f, size);
+        SampleUtilSimd::setEnabled(true);
+        SampleUtil::copyWithRampingGain(actual, src, 0.1f, 0.9f, size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ(expected[j], actual[j]);
+        }
+
+        SampleUtilSimd::setEnabled(false);
+        SampleUtil::addWithRampingGain(expected, src, 0.7f, 0.2f, size);
+        SampleUtilSimd::setEnabled(true);
+        SampleUtil::addWithRampingGain(actual, src, 0.7f, 0.2f, size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ(expected[j], actual[j]);
+        }
+
+        SampleUtil::free(expected);
+        SampleUtil::free(actual);
+    }
+}
+
+TEST_F(SampleUtilTest, simdCopy3WithGainMatchesScalar) {
+    for (int i = 0; i < buffers.size(); ++i) {
+        int size = sizes[i];
+        CSAMPLE* src1 = buffers[i];
+        CSAMPLE* src2 = SampleUtil::alloc(size);
+        CSAMPLE* src3 = SampleUtil::alloc(size);
+        FillBufferWithSignal(src1, size, 1);
+        FillBufferWithSignal(src2, size, 2);
+        FillBufferWithSignal(src3, size, 3);
+        CSAMPLE* expected = SampleUtil::alloc(size);
+        CSAMPLE* actual = SampleUtil::alloc(size);
+
+        SampleUtilSimd::setEnabled(false);
+        SampleUtil::copy3WithGain(expected, src1, 0.3f, src2, 0.5f, src3, 0.7f, size);
+        SampleUtilSimd::setEnabled(true);
+        SampleUtil::copy3WithGain(actual, src1, 0.3f, src2, 0.5f, src3, 0.7f, size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ(expected[j], actual[j]);
+        }
+
+        SampleUtil::free(src2);
+        SampleUtil::free(src3);
+        SampleUtil::free(expected);
+        SampleUtil::free(actual);
+    }
+}
+
+TEST_F(SampleUtilTest, simdCopy3WithRampingGainMatchesScalar) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int size = sizes[evenBuffers[i]];
+        CSAMPLE* src1 = buffers[evenBuffers[i]];
+        CSAMPLE* src2 = SampleUtil::alloc(size);
+        CSAMPLE* src3 = SampleUtil::alloc(size);
+        FillBufferWithSignal(src1, size, 1);
+        FillBufferWithSignal(src2, size, 2);
+        FillBufferWithSignal(src3, size, 3);
+        CSAMPLE* expected = SampleUtil::alloc(size);
+        CSAMPLE* actual = SampleUtil::alloc(size);
+
+        SampleUtilSimd::setEnabled(false);
+        SampleUtil::copy3WithRampingGain(expected, src1, 0.0f, 1.0f,
+                src2, 1.0f, 0.0f, src3, 0.5f, 0.6f, size);
+        SampleUtilSimd::setEnabled(true);
+        SampleUtil::copy3WithRampingGain(actual, src1, 0.0f, 1.0f,
+                src2, 1.0f, 0.0f, src3, 0.5f, 0.6f, size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ(expected[j], actual[j]);
+        }
+
+        SampleUtil::free(src2);
+        SampleUtil::free(src3);
+        SampleUtil::free(expected);
+        SampleUtil::free(actual);
+    }
+}
+
+TEST_F(SampleUtilTest, simdSumAbsPerChannelMatchesScalar) {
+    for (int i = 0; i < evenBuffers.size(); ++i) {
+        int size = sizes[evenBuffers[i]];
+        CSAMPLE* buffer = buffers[evenBuffers[i]];
+        FillBufferWithSignal(buffer, size, i);
+
+        CSAMPLE expectedL, expectedR, actualL, actualR;
+        SampleUtilSimd::setEnabled(false);
+        SampleUtil::CLIP_STATUS expectedClipping = SampleUtil::sumAbsPerChannel(
+                &expectedL, &expectedR, buffer, size);
+        SampleUtilSimd::setEnabled(true);
+        SampleUtil::CLIP_STATUS actualClipping = SampleUtil::sumAbsPerChannel(
+                &actualL, &actualR, buffer, size);
+        // The order of additions differs
+        EXPECT_NEAR(expectedL, actualL, expectedL * 1e-5);
+        EXPECT_NEAR(expectedR, actualR, expectedR * 1e-5);
+        EXPECT_EQ(expectedClipping, actualClipping);
+
+        // A single clipped sample at the end of the buffer
+        SampleUtil::clear(buffer, size);
+        buffer[size - 1] = -1.1f;
+        actualClipping = SampleUtil::sumAbsPerChannel(
+                &actualL, &actualR, buffer, size);
+        EXPECT_EQ(SampleUtil::CLIP_STATUS(SampleUtil::CLIPPING_RIGHT),
+                actualClipping);
+    }
+}
+
+TEST_F(SampleUtilTest, simdCopyClampBufferMatchesScalar) {
+    for (int i = 0; i < buffers.size(); ++i) {
+        int size = sizes[i];
+        CSAMPLE* src = buffers[i];
+        FillBufferWithSignal(src, size, i);
+        CSAMPLE* expected = SampleUtil::alloc(size);
+        CSAMPLE* actual = SampleUtil::alloc(size);
+
+        SampleUtilSimd::setEnabled(false);
+        SampleUtil::copyClampBuffer(expected, src, size);
+        SampleUtilSimd::setEnabled(true);
+        SampleUtil::copyClampBuffer(actual, src, size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ(expected[j], actual[j]);
+            EXPECT_LE(fabs(actual[j]), CSAMPLE_PEAK);
+        }
+
+        SampleUtil::free(expected);
+        SampleUtil::free(actual);
+    }
+}
+
 TEST_F(SampleUtilTest, deinterleaveBuffer) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -621,4 +800,125 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+// Compares the SIMD kernels with the scalar fallback for typical audio
+// buffer sizes. The second argument enables (1) or disables (0) SIMD.
+
+class ScopedSampleUtilSimd {
+  public:
+    explicit ScopedSampleUtilSimd(benchmark::State* pState) {
+        const bool enabled = pState->range_y() != 0;
+        SampleUtilSimd::setEnabled(enabled);
+        pState->SetLabel(enabled ?
+                SampleUtilSimd::instructionSetName() : "scalar");
+    }
+    ~ScopedSampleUtilSimd() {
+        SampleUtilSimd::setEnabled(true);
+    }
+};
+
+static void SimdBenchmarkArguments(benchmark::internal::Benchmark* b) {
+    for (int frames : {64, 256, 1024}) {
+        b->ArgPair(frames, 0);
+        b->ArgPair(frames, 1);
+    }
+}
+
+static void BM_SimdCopyWithRampingGain(benchmark::State& state) {
+    ScopedSampleUtilSimd simd(&state);
+    const SINT size = state.range_x() * 2;
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+
+    while(state.KeepRunning()) {
+        SampleUtil::copyWithRampingGain(buffer, buffer2, 0.1f, 0.9f, size);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range_x());
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_SimdCopyWithRampingGain)->Apply(SimdBenchmarkArguments);
+
+static void BM_SimdCopy4WithRampingGain(benchmark::State& state) {
+    ScopedSampleUtilSimd simd(&state);
+    const SINT size = state.range_x() * 2;
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* sources[4];
+    for (int i = 0; i < 4; ++i) {
+        sources[i] = SampleUtil::alloc(size);
+        SampleUtil::fill(sources[i], 0.1f * i, size);
+    }
+
+    while(state.KeepRunning()) {
+        SampleUtil::copy4WithRampingGain(buffer,
+                sources[0], 0.1f, 0.2f, sources[1], 0.3f, 0.4f,
+                sources[2], 0.5f, 0.6f, sources[3], 0.7f, 0.8f, size);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range_x());
+
+    SampleUtil::free(buffer);
+    for (int i = 0; i < 4; ++i) {
+        SampleUtil::free(sources[i]);
+    }
+}
+BENCHMARK(BM_SimdCopy4WithRampingGain)->Apply(SimdBenchmarkArguments);
+
+static void BM_SimdSumAbsPerChannel(benchmark::State& state) {
+    ScopedSampleUtilSimd simd(&state);
+    const SINT size = state.range_x() * 2;
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+    CSAMPLE sumL, sumR;
+
+    while(state.KeepRunning()) {
+        SampleUtil::sumAbsPerChannel(&sumL, &sumR, buffer, size);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range_x());
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_SimdSumAbsPerChannel)->Apply(SimdBenchmarkArguments);
+
+static void BM_SimdCopyClampBuffer(benchmark::State& state) {
+    ScopedSampleUtilSimd simd(&state);
+    const SINT size = state.range_x() * 2;
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 1.5f, size);
+
+    while(state.KeepRunning()) {
+        SampleUtil::copyClampBuffer(buffer, buffer2, size);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range_x());
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_SimdCopyClampBuffer)->Apply(SimdBenchmarkArguments);
+
+static void BM_SimdInterleaveBuffer(benchmark::State& state) {
+    ScopedSampleUtilSimd simd(&state);
+    const SINT frames = state.range_x();
+    CSAMPLE* buffer = SampleUtil::alloc(frames * 2);
+    SampleUtil::fill(buffer, 0.0f, frames * 2);
+    CSAMPLE* buffer2 = SampleUtil::alloc(frames);
+    SampleUtil::fill(buffer2, 0.1f, frames);
+    CSAMPLE* buffer3 = SampleUtil::alloc(frames);
+    SampleUtil::fill(buffer3, 0.2f, frames);
+
+    while(state.KeepRunning()) {
+        SampleUtil::interleaveBuffer(buffer, buffer2, buffer3, frames);
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK(BM_SimdInterleaveBuffer)->Apply(SimdBenchmarkArguments);
+
 }  // namespace
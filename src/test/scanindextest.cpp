@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "library/dao/scanindexdao.h"
+#include "library/scanner/scanindex.h"
+#include "test/librarytest.h"
+
+namespace {
+
+const qint64 kNanosPerMilli = 1000000;
+
+class ScanIndexTest : public LibraryTest {
+  protected:
+    ScanIndexTest() {
+        m_scanIndexDao.initialize(dbConnection());
+    }
+
+    static void writeFile(const QString& path, const QByteArray& content) {
+        QFile file(path);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        ASSERT_EQ(content.size(), file.write(content));
+    }
+
+    ScanIndexDAO m_scanIndexDao;
+};
+
+TEST_F(ScanIndexTest, FileStampOfMissingFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    EXPECT_FALSE(FileStamp::of(tempDir.path() + "/missing").isValid());
+    EXPECT_TRUE(FileStamp::of(tempDir.path()).isValid());
+}
+
+TEST_F(ScanIndexTest, FileStampChangesWithContent) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.path() + "/track.mp3";
+    writeFile(filePath, "a");
+    const FileStamp stamp = FileStamp::of(filePath);
+    ASSERT_TRUE(stamp.isValid());
+    EXPECT_EQ(stamp, FileStamp::of(filePath));
+
+    writeFile(filePath, "ab");
+    EXPECT_NE(stamp, FileStamp::of(filePath));
+}
+
+TEST_F(ScanIndexTest, ListingUnchanged) {
+    const qint64 nowMillis = QDateTime::currentMSecsSinceEpoch();
+    const FileStamp stamp(4096, (nowMillis - 60000) * kNanosPerMilli, 42);
+
+    ScanIndexDirectory directory(stamp, nowMillis);
+    EXPECT_TRUE(directory.isListingUnchanged(stamp));
+    EXPECT_FALSE(directory.isListingUnchanged(FileStamp()));
+    EXPECT_FALSE(directory.isListingUnchanged(
+            FileStamp(4096, (nowMillis - 50000) * kNanosPerMilli, 42)));
+    EXPECT_FALSE(directory.isListingUnchanged(
+            FileStamp(4096, (nowMillis - 60000) * kNanosPerMilli, 43)));
+}
+
+TEST_F(ScanIndexTest, ListingModifiedWhileIndexing) {
+    // Entries might have been added within the resolution of the
+    // modification time after the directory has been listed.
+    const qint64 nowMillis = QDateTime::currentMSecsSinceEpoch();
+    const FileStamp stamp(4096, (nowMillis - 500) * kNanosPerMilli, 42);
+
+    ScanIndexDirectory directory(stamp, nowMillis);
+    EXPECT_FALSE(directory.isListingUnchanged(stamp));
+}
+
+TEST_F(ScanIndexTest, SaveAndLoad) {
+    ScanIndex index;
+    ScanIndexDirectory artist(FileStamp(4096, 1000, 1), 2000);
+    artist.subdirectories << "Album 1" << "Album 2";
+    index.insert("/music/Artist", artist);
+    ScanIndexDirectory album(FileStamp(4096, 3000, 2), 4000);
+    ScanIndexDirectory::File file;
+    file.name = "01 Track.flac";
+    file.stamp = FileStamp(123456, 5000, 3);
+    album.files.append(file);
+    index.insert("/music/Artist/Album 1", album);
+    m_scanIndexDao.saveDirectories(index);
+
+    ScanIndex loaded = m_scanIndexDao.getIndex();
+    ASSERT_EQ(2, loaded.size());
+    EXPECT_EQ(artist.stamp(), loaded["/music/Artist"].stamp());
+    EXPECT_EQ(2000, loaded["/music/Artist"].indexedAtMillis());
+    EXPECT_EQ(artist.subdirectories, loaded["/music/Artist"].subdirectories);
+    EXPECT_TRUE(loaded["/music/Artist"].files.isEmpty());
+    ASSERT_EQ(1, loaded["/music/Artist/Album 1"].files.size());
+    EXPECT_EQ(file.name, loaded["/music/Artist/Album 1"].files[0].name);
+    EXPECT_EQ(file.stamp, loaded["/music/Artist/Album 1"].files[0].stamp);
+
+    // Saving a directory again replaces its files
+    album.files.clear();
+    index.clear();
+    index.insert("/music/Artist/Album 1", album);
+    m_scanIndexDao.saveDirectories(index);
+    loaded = m_scanIndexDao.getIndex();
+    ASSERT_EQ(2, loaded.size());
+    EXPECT_TRUE(loaded["/music/Artist/Album 1"].files.isEmpty());
+
+    m_scanIndexDao.removeDirectories(QStringList() << "/music/Artist");
+    loaded = m_scanIndexDao.getIndex();
+    ASSERT_EQ(1, loaded.size());
+    EXPECT_TRUE(loaded.contains("/music/Artist/Album 1"));
+}
+
+TEST_F(ScanIndexTest, ChangedExtensionsDiscardIndex) {
+    m_scanIndexDao.validateSupportedExtensions("\\.(mp3|flac)$");
+    ScanIndex index;
+    index.insert("/music", ScanIndexDirectory(FileStamp(4096, 1000, 1), 2000));
+    m_scanIndexDao.saveDirectories(index);
+
+    m_scanIndexDao.validateSupportedExtensions("\\.(mp3|flac)$");
+    EXPECT_EQ(1, m_scanIndexDao.getIndex().size());
+
+    m_scanIndexDao.validateSupportedExtensions("\\.(mp3|flac|opus)$");
+    EXPECT_TRUE(m_scanIndexDao.getIndex().isEmpty());
+}
+
+} // namespace
@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+#include <QList>
+
+#include <cmath>
+#include <vector>
+
+#include "encoder/encoder.h"
+#include "encoder/encodervorbissettings.h"
+#include "encoder/sharedencoder.h"
+#include "recording/defs_recording.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kBufferSize = 4096;
+const int kBufferCount = 100;
+
+class CollectingSink : public EncoderCallback {
+  public:
+    void write(const unsigned char *header, const unsigned char *body,
+               int headerLen, int bodyLen) override {
+        QByteArray packet(reinterpret_cast<const char*>(header), headerLen);
+        packet.append(reinterpret_cast<const char*>(body), bodyLen);
+        packets.append(packet);
+        data.append(packet);
+    }
+    int tell() override {
+        return -1;
+    }
+    void seek(int pos) override {
+        Q_UNUSED(pos);
+    }
+    int filelen() override {
+        return 0;
+    }
+
+    QList<QByteArray> packets;
+    QByteArray data;
+};
+
+class SharedEncoderTest : public MixxxTest {
+  protected:
+    SharedEncoderTest()
+            : m_format(EncoderFactory::getFactory().getFormatFor(ENCODING_OGG)),
+              m_sine(kBufferSize),
+              m_silence(kBufferSize, 0) {
+        for (int i = 0; i < kBufferSize; ++i) {
+            m_sine[i] = std::sin(2 * M_PI * 440 * (i / 2) / kSampleRate);
+        }
+    }
+
+    EncoderPointer subscribe(const EncoderSettings& settings, CollectingSink* pSink) {
+        QString errorMessage;
+        EncoderPointer pEncoder = EncoderFactory::getFactory().getSharedEncoder(
+                m_format, settings, kSampleRate, config(), pSink, &errorMessage);
+        EXPECT_TRUE(pEncoder) << errorMessage.toStdString();
+        return pEncoder;
+    }
+
+    const Encoder::Format m_format;
+    std::vector<CSAMPLE> m_sine;
+    std::vector<CSAMPLE> m_silence;
+};
+
+TEST_F(SharedEncoderTest, SinksReceiveTheSameStream) {
+    EncoderVorbisSettings settings(config());
+    CollectingSink sink1;
+    CollectingSink sink2;
+    EncoderPointer pEncoder1 = subscribe(settings, &sink1);
+    EncoderPointer pEncoder2 = subscribe(settings, &sink2);
+    ASSERT_TRUE(pEncoder1 && pEncoder2);
+
+    // The samples are only encoded once, i.e. the second sink receives
+    // the encoded sine wave instead of its own input.
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder1->encodeBuffer(m_sine.data(), kBufferSize);
+        pEncoder2->encodeBuffer(m_silence.data(), kBufferSize);
+    }
+    ASSERT_FALSE(sink1.data.isEmpty());
+    EXPECT_TRUE(sink1.data.startsWith("OggS"));
+    EXPECT_EQ(sink1.data, sink2.data);
+}
+
+TEST_F(SharedEncoderTest, LateSinkReceivesStreamHeader) {
+    EncoderVorbisSettings settings(config());
+    CollectingSink sink1;
+    EncoderPointer pEncoder1 = subscribe(settings, &sink1);
+    ASSERT_TRUE(pEncoder1);
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder1->encodeBuffer(m_sine.data(), kBufferSize);
+    }
+    ASSERT_GT(sink1.packets.size(), 1);
+
+    CollectingSink sink2;
+    EncoderPointer pEncoder2 = subscribe(settings, &sink2);
+    ASSERT_TRUE(pEncoder2);
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder1->encodeBuffer(m_sine.data(), kBufferSize);
+        pEncoder2->encodeBuffer(m_sine.data(), kBufferSize);
+    }
+    // The identification header is on the first page of the stream
+    ASSERT_FALSE(sink2.packets.isEmpty());
+    EXPECT_EQ(sink1.packets.first(), sink2.packets.first());
+    // Followed by the audio that has been encoded since joining
+    EXPECT_TRUE(sink1.data.endsWith(sink2.packets.last()));
+    EXPECT_LT(sink2.data.size(), sink1.data.size());
+}
+
+TEST_F(SharedEncoderTest, DifferentSettingsAreEncodedSeparately) {
+    EncoderVorbisSettings settings(config());
+    const QList<int> qualityValues = settings.getQualityValues();
+    ASSERT_GT(qualityValues.size(), 1);
+    settings.setQualityByValue(qualityValues.first());
+    CollectingSink sink1;
+    EncoderPointer pEncoder1 = subscribe(settings, &sink1);
+    settings.setQualityByValue(qualityValues.last());
+    CollectingSink sink2;
+    EncoderPointer pEncoder2 = subscribe(settings, &sink2);
+    ASSERT_TRUE(pEncoder1 && pEncoder2);
+
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder1->encodeBuffer(m_sine.data(), kBufferSize);
+        pEncoder2->encodeBuffer(m_sine.data(), kBufferSize);
+    }
+    ASSERT_FALSE(sink1.data.isEmpty());
+    ASSERT_FALSE(sink2.data.isEmpty());
+    EXPECT_NE(sink1.data, sink2.data);
+}
+
+TEST_F(SharedEncoderTest, StalledSinkDoesNotBlockOthers) {
+    EncoderVorbisSettings settings(config());
+    CollectingSink sink1;
+    CollectingSink sink2;
+    EncoderPointer pEncoder1 = subscribe(settings, &sink1);
+    EncoderPointer pEncoder2 = subscribe(settings, &sink2);
+    ASSERT_TRUE(pEncoder1 && pEncoder2);
+
+    pEncoder1->encodeBuffer(m_sine.data(), kBufferSize);
+    pEncoder2->encodeBuffer(m_sine.data(), kBufferSize);
+    const int stalledSize = sink2.data.size();
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder1->encodeBuffer(m_sine.data(), kBufferSize);
+    }
+    ASSERT_GT(sink1.data.size(), stalledSize);
+    EXPECT_EQ(stalledSize, sink2.data.size());
+
+    // The stalled sink catches up without encoding the samples again
+    pEncoder2->encodeBuffer(m_silence.data(), kBufferSize);
+    EXPECT_EQ(sink1.data, sink2.data);
+}
+
+TEST_F(SharedEncoderTest, DifferentMetadataIsEncodedSeparately) {
+    EncoderVorbisSettings settings(config());
+    CollectingSink sink1;
+    CollectingSink sink2;
+    QString errorMessage;
+    EncoderPointer pEncoder1 = EncoderFactory::getFactory().getSharedEncoder(
+            m_format, settings, kSampleRate, config(), &sink1, &errorMessage,
+            "Artist", "Title 1", "Album");
+    EncoderPointer pEncoder2 = EncoderFactory::getFactory().getSharedEncoder(
+            m_format, settings, kSampleRate, config(), &sink2, &errorMessage,
+            "Artist", "Title 2", "Album");
+    ASSERT_TRUE(pEncoder1 && pEncoder2) << errorMessage.toStdString();
+
+    // The second sink receives its own input and metadata
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder1->encodeBuffer(m_sine.data(), kBufferSize);
+        pEncoder2->encodeBuffer(m_silence.data(), kBufferSize);
+    }
+    EXPECT_TRUE(sink1.data.contains("Title 1"));
+    EXPECT_FALSE(sink1.data.contains("Title 2"));
+    EXPECT_TRUE(sink2.data.contains("Title 2"));
+    EXPECT_NE(sink1.data, sink2.data);
+}
+
+TEST_F(SharedEncoderTest, LeavingSinkDoesNotDisturbOthers) {
+    EncoderVorbisSettings settings(config());
+    CollectingSink sink1;
+    CollectingSink sink2;
+    EncoderPointer pEncoder1 = subscribe(settings, &sink1);
+    EncoderPointer pEncoder2 = subscribe(settings, &sink2);
+    ASSERT_TRUE(pEncoder1 && pEncoder2);
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder1->encodeBuffer(m_sine.data(), kBufferSize);
+        pEncoder2->encodeBuffer(m_sine.data(), kBufferSize);
+    }
+    int headerPageCount = 0;
+    while (headerPageCount < sink2.packets.size() &&
+            SharedEncoder::isOggHeaderPage(sink2.packets[headerPageCount])) {
+        ++headerPageCount;
+    }
+    ASSERT_GT(headerPageCount, 0);
+
+    // The leaving sink doesn't receive the tail of the stream
+    pEncoder1->flush();
+    pEncoder1.reset();
+    EXPECT_EQ(sink1.data, sink2.data);
+
+    // The other sink continues the same stream instead of a new one
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder2->encodeBuffer(m_sine.data(), kBufferSize);
+    }
+    EXPECT_GT(sink2.data.size(), sink1.data.size());
+    EXPECT_TRUE(sink2.data.startsWith(sink1.data));
+    for (int i = headerPageCount; i < sink2.packets.size(); ++i) {
+        EXPECT_FALSE(SharedEncoder::isOggHeaderPage(sink2.packets[i]));
+    }
+}
+
+TEST_F(SharedEncoderTest, LastSinkReceivesStreamTail) {
+    EncoderVorbisSettings settings(config());
+    CollectingSink sink1;
+    CollectingSink sink2;
+    EncoderPointer pEncoder1 = subscribe(settings, &sink1);
+    EncoderPointer pEncoder2 = subscribe(settings, &sink2);
+    ASSERT_TRUE(pEncoder1 && pEncoder2);
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder1->encodeBuffer(m_sine.data(), kBufferSize);
+        pEncoder2->encodeBuffer(m_sine.data(), kBufferSize);
+    }
+    pEncoder1->flush();
+    pEncoder1.reset();
+
+    // Flushing writes the samples that are still buffered in the encoder
+    const int size = sink2.data.size();
+    pEncoder2->flush();
+    EXPECT_GT(sink2.data.size(), size);
+    pEncoder2.reset();
+
+    // Sinks that subscribe later start a new stream
+    CollectingSink sink3;
+    EncoderPointer pEncoder3 = subscribe(settings, &sink3);
+    ASSERT_TRUE(pEncoder3);
+    for (int i = 0; i < kBufferCount; ++i) {
+        pEncoder3->encodeBuffer(m_sine.data(), kBufferSize);
+    }
+    ASSERT_FALSE(sink3.packets.isEmpty());
+    EXPECT_TRUE(SharedEncoder::isOggHeaderPage(sink3.packets.first()));
+}
+
+} // namespace
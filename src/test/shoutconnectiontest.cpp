@@ -0,0 +1,185 @@
+#ifdef __BROADCAST__
+
+#include <gtest/gtest.h>
+
+#include <shout/shout.h>
+
+#include <QByteArray>
+
+#include <memory>
+
+#include "encoder/sharedencoder.h"
+#include "engine/sidechain/shoutconnection.h"
+#include "preferences/broadcastprofile.h"
+#include "test/mixxxtest.h"
+#include "util/memory.h"
+
+namespace {
+
+const int kPageSize = 4096;
+
+// An Ogg page with the given granule position, header pages have a
+// granule position of 0
+QByteArray makeOggPage(int index, char granulePosition) {
+    QByteArray page(kPageSize, static_cast<char>('a' + index % 26));
+    page.replace(0, 4, "OggS");
+    page[4] = 0;
+    page[5] = 0;
+    for (int i = 6; i < 14; ++i) {
+        page[i] = 0;
+    }
+    page[6] = granulePosition;
+    return page;
+}
+
+QByteArray makeHeaderPage(int index) {
+    return makeOggPage(index, 0);
+}
+
+QByteArray makeAudioPage(int index) {
+    return makeOggPage(index, static_cast<char>(1 + index % 100));
+}
+
+} // namespace
+
+// The connection is never opened, i.e. sending to the server fails
+// like on a broken connection.
+class ShoutConnectionTest : public MixxxTest {
+  protected:
+    ShoutConnectionTest()
+            : m_pProfile(new BroadcastProfile("ShoutConnectionTest")) {
+        shout_init();
+        m_pConnection = std::make_unique<ShoutConnection>(m_pProfile, config());
+        m_pConnection->m_iShoutStatus = SHOUTERR_CONNECTED;
+        m_pConnection->m_format_is_ov = true;
+        // Give up immediately when reconnecting
+        m_pConnection->m_limitReconnects = true;
+        m_pConnection->m_maximumRetries = 0;
+    }
+    ~ShoutConnectionTest() override {
+        m_pConnection.reset();
+        shout_shutdown();
+    }
+
+    void setMp3Format() {
+        m_pConnection->m_format_is_ov = false;
+        m_pConnection->m_format_is_mp3 = true;
+    }
+
+    void setSendQueue(int capacityBytes, NetworkSendQueue::OverflowPolicy policy) {
+        m_pConnection->m_sendQueue.setCapacityBytes(capacityBytes);
+        m_pConnection->m_sendQueue.setOverflowPolicy(policy);
+    }
+
+    // Called by the encoder
+    void write(const QByteArray& packet) {
+        m_pConnection->write(nullptr,
+                reinterpret_cast<const unsigned char*>(packet.constData()),
+                0, packet.size());
+    }
+
+    void flushSendQueue() {
+        m_pConnection->flushSendQueue();
+    }
+
+    bool sendQueueOverflow() const {
+        return m_pConnection->m_sendQueueOverflow;
+    }
+
+    const NetworkSendQueue& sendQueue() const {
+        return m_pConnection->m_sendQueue;
+    }
+
+    // Removes the queued packets without sending them to the server
+    QByteArray takeQueuedData() {
+        QByteArray data;
+        m_pConnection->m_sendQueue.flush([&data](const char* pData, int size) {
+            data.append(pData, size);
+            return size;
+        });
+        return data;
+    }
+
+    bool isReconnecting() const {
+        return m_pProfile->connectionStatus() == BroadcastProfile::STATUS_FAILURE;
+    }
+
+    BroadcastProfilePtr m_pProfile;
+    std::unique_ptr<ShoutConnection> m_pConnection;
+};
+
+TEST_F(ShoutConnectionTest, DropOldestKeepsOggHeaderPages) {
+    ASSERT_TRUE(SharedEncoder::isOggHeaderPage(makeHeaderPage(0)));
+    ASSERT_FALSE(SharedEncoder::isOggHeaderPage(makeAudioPage(0)));
+    setSendQueue(4 * kPageSize, NetworkSendQueue::OverflowPolicy::DropOldest);
+
+    write(makeHeaderPage(0));
+    write(makeHeaderPage(1));
+    for (int i = 0; i < 10; ++i) {
+        write(makeAudioPage(i));
+    }
+    EXPECT_FALSE(sendQueueOverflow());
+    EXPECT_EQ(makeHeaderPage(0) + makeHeaderPage(1) +
+            makeAudioPage(8) + makeAudioPage(9),
+            takeQueuedData());
+}
+
+TEST_F(ShoutConnectionTest, DropOldestReconnectsIfHeaderPagesOverflow) {
+    setSendQueue(2 * kPageSize, NetworkSendQueue::OverflowPolicy::DropOldest);
+
+    write(makeHeaderPage(0));
+    write(makeHeaderPage(1));
+    EXPECT_FALSE(sendQueueOverflow());
+    write(makeHeaderPage(2));
+    EXPECT_TRUE(sendQueueOverflow());
+
+    flushSendQueue();
+    EXPECT_TRUE(isReconnecting());
+    EXPECT_FALSE(sendQueueOverflow());
+    EXPECT_TRUE(sendQueue().isEmpty());
+}
+
+TEST_F(ShoutConnectionTest, Mp3PacketsAreDropped) {
+    setMp3Format();
+    setSendQueue(2 * kPageSize, NetworkSendQueue::OverflowPolicy::DropOldest);
+
+    // Only Ogg streams have header pages
+    for (int i = 0; i < 4; ++i) {
+        write(makeHeaderPage(i));
+    }
+    EXPECT_FALSE(sendQueueOverflow());
+    EXPECT_EQ(makeHeaderPage(2) + makeHeaderPage(3), takeQueuedData());
+}
+
+TEST_F(ShoutConnectionTest, ReconnectPolicyReconnectsOnOverflow) {
+    setSendQueue(2 * kPageSize, NetworkSendQueue::OverflowPolicy::Reconnect);
+
+    write(makeAudioPage(0));
+    write(makeAudioPage(1));
+    EXPECT_FALSE(sendQueueOverflow());
+    write(makeAudioPage(2));
+    EXPECT_TRUE(sendQueueOverflow());
+    EXPECT_FALSE(isReconnecting());
+
+    // Reconnects before sending and discards the outdated packets
+    flushSendQueue();
+    EXPECT_TRUE(isReconnecting());
+    EXPECT_TRUE(sendQueue().isEmpty());
+}
+
+TEST_F(ShoutConnectionTest, RepeatedSendFailuresReconnect) {
+    setSendQueue(16 * kPageSize, NetworkSendQueue::OverflowPolicy::Reconnect);
+    write(makeAudioPage(0));
+
+    // sendToServer() fails, but the packet is kept for a few retries
+    for (int i = 0; i < 3; ++i) {
+        flushSendQueue();
+        EXPECT_FALSE(isReconnecting());
+        EXPECT_EQ(kPageSize, sendQueue().queuedBytes());
+    }
+    flushSendQueue();
+    EXPECT_TRUE(isReconnecting());
+    EXPECT_TRUE(sendQueue().isEmpty());
+}
+
+#endif // __BROADCAST__
@@ -52,39 +52,42 @@ class TestEngineMaster : public EngineMaster {
     }
 };
 
-class BaseSignalPathTest : public MixxxTest {
-  protected:
-    BaseSignalPathTest() {
+// Wires up an EngineMaster with three decks and a preview deck like the
+// application. It doesn't depend on gtest and is also set up by the
+// benchmarks, together with a MixxxTestEnvironment that has to outlive it.
+class SignalPathEnvironment {
+  public:
+    explicit SignalPathEnvironment(UserSettingsPointer pConfig) {
         m_pGuiTick = std::make_unique<GuiTick>();
         m_pChannelHandleFactory = new ChannelHandleFactory();
         m_pNumDecks = new ControlObject(ConfigKey("[Master]", "num_decks"));
-        m_pEffectsManager = new EffectsManager(NULL, config(), m_pChannelHandleFactory);
+        m_pEffectsManager = new EffectsManager(NULL, pConfig, m_pChannelHandleFactory);
         m_pVisualsManager = new VisualsManager();
-        m_pEngineMaster = new TestEngineMaster(m_pConfig, "[Master]",
+        m_pEngineMaster = new TestEngineMaster(pConfig, "[Master]",
                                                m_pEffectsManager, m_pChannelHandleFactory,
                                                false);
 
-        m_pMixerDeck1 = new Deck(NULL, m_pConfig, m_pEngineMaster, m_pEffectsManager,
+        m_pMixerDeck1 = new Deck(NULL, pConfig, m_pEngineMaster, m_pEffectsManager,
                 m_pVisualsManager, EngineChannel::CENTER, m_sGroup1);
         m_pMixerDeck1->setupEqControls();
 
-        m_pMixerDeck2 = new Deck(NULL, m_pConfig, m_pEngineMaster, m_pEffectsManager,
+        m_pMixerDeck2 = new Deck(NULL, pConfig, m_pEngineMaster, m_pEffectsManager,
                 m_pVisualsManager, EngineChannel::CENTER, m_sGroup2);
         m_pMixerDeck2->setupEqControls();
 
-        m_pMixerDeck3 = new Deck(NULL, m_pConfig, m_pEngineMaster, m_pEffectsManager,
+        m_pMixerDeck3 = new Deck(NULL, pConfig, m_pEngineMaster, m_pEffectsManager,
                 m_pVisualsManager, EngineChannel::CENTER, m_sGroup3);
         m_pMixerDeck3->setupEqControls();
         m_pChannel1 = m_pMixerDeck1->getEngineDeck();
         m_pChannel2 = m_pMixerDeck2->getEngineDeck();
         m_pChannel3 = m_pMixerDeck3->getEngineDeck();
-        m_pPreview1 = new PreviewDeck(NULL, m_pConfig, m_pEngineMaster, m_pEffectsManager,
+        m_pPreview1 = new PreviewDeck(NULL, pConfig, m_pEngineMaster, m_pEffectsManager,
                 m_pVisualsManager, EngineChannel::CENTER, m_sPreviewGroup);
         ControlObject::set(ConfigKey(m_sPreviewGroup, "file_bpm"), 2.0);
 
         // TODO(owilliams) Tests fail with this turned on because EngineSync is syncing
         // to this sampler.  FIX IT!
-        // m_pSampler1 = new Sampler(NULL, m_pConfig,
+        // m_pSampler1 = new Sampler(NULL, pConfig,
         //                           m_pEngineMaster, m_pEffectsManager,
         //                           EngineChannel::CENTER, m_sSamplerGroup);
         // ControlObject::getControl(ConfigKey(m_sSamplerGroup, "file_bpm"))->set(2.0);
@@ -97,7 +100,7 @@ class BaseSignalPathTest : public MixxxTest {
         ControlObject::set(ConfigKey("[Master]", "enabled"), 1.0);
     }
 
-    ~BaseSignalPathTest() override {
+    virtual ~SignalPathEnvironment() {
         delete m_pMixerDeck1;
         delete m_pMixerDeck2;
         delete m_pMixerDeck3;
@@ -114,6 +117,7 @@ class BaseSignalPathTest : public MixxxTest {
         delete m_pNumDecks;
     }
 
+  protected:
     void addDeck(EngineDeck* pDeck) {
         ControlObject::set(ConfigKey(pDeck->getGroup(), "master"), 1.0);
         ControlObject::set(ConfigKey(pDeck->getGroup(), "rate_dir"), kDefaultRateDir);
@@ -132,6 +136,54 @@ class BaseSignalPathTest : public MixxxTest {
         }
     }
 
+    double getRateSliderValue(double rate) const {
+        return (rate - 1.0) / kRateRangeDivisor;
+    }
+
+    void ProcessBuffer() {
+        m_pEngineMaster->process(kProcessBufferSize);
+    }
+
+    // Loads the same sine wave into all three decks
+    void loadTestTracks() {
+        const QString kTrackLocationTest = QDir::currentPath() + "/src/test/sine-30.wav";
+        TrackPointer pTrack(Track::newTemporary(kTrackLocationTest));
+
+        loadTrack(m_pMixerDeck1, pTrack);
+        loadTrack(m_pMixerDeck2, pTrack);
+        loadTrack(m_pMixerDeck3, pTrack);
+    }
+
+    ChannelHandleFactory* m_pChannelHandleFactory;
+    ControlObject* m_pNumDecks;
+    std::unique_ptr<GuiTick> m_pGuiTick;
+    VisualsManager* m_pVisualsManager;
+    EffectsManager* m_pEffectsManager;
+    EngineSync* m_pEngineSync;
+    TestEngineMaster* m_pEngineMaster;
+    Deck *m_pMixerDeck1, *m_pMixerDeck2, *m_pMixerDeck3;
+    EngineDeck *m_pChannel1, *m_pChannel2, *m_pChannel3;
+    PreviewDeck* m_pPreview1;
+
+    static const char* m_sGroup1;
+    static const char* m_sGroup2;
+    static const char* m_sGroup3;
+    static const char* m_sMasterGroup;
+    static const char* m_sInternalClockGroup;
+    static const char* m_sPreviewGroup;
+    static const char* m_sSamplerGroup;
+    static const double kDefaultRateRange;
+    static const double kDefaultRateDir;
+    static const double kRateRangeDivisor;
+    static const int kProcessBufferSize;
+};
+
+class BaseSignalPathTest : public MixxxTest, public SignalPathEnvironment {
+  protected:
+    BaseSignalPathTest()
+            : SignalPathEnvironment(config()) {
+    }
+
     // Asserts that the contents of the output buffer matches a reference
     // data file where each float sample value must be within the delta to pass.
     // To create a reference file, just run the test. It will fail, but the test
@@ -191,48 +243,12 @@ class BaseSignalPathTest : public MixxxTest {
         }
         f.close();
     }
-
-    double getRateSliderValue(double rate) const {
-        return (rate - 1.0) / kRateRangeDivisor;
-    }
-
-    void ProcessBuffer() {
-        m_pEngineMaster->process(kProcessBufferSize);
-    }
-
-    ChannelHandleFactory* m_pChannelHandleFactory;
-    ControlObject* m_pNumDecks;
-    std::unique_ptr<GuiTick> m_pGuiTick;
-    VisualsManager* m_pVisualsManager;
-    EffectsManager* m_pEffectsManager;
-    EngineSync* m_pEngineSync;
-    TestEngineMaster* m_pEngineMaster;
-    Deck *m_pMixerDeck1, *m_pMixerDeck2, *m_pMixerDeck3;
-    EngineDeck *m_pChannel1, *m_pChannel2, *m_pChannel3;
-    PreviewDeck* m_pPreview1;
-
-    static const char* m_sGroup1;
-    static const char* m_sGroup2;
-    static const char* m_sGroup3;
-    static const char* m_sMasterGroup;
-    static const char* m_sInternalClockGroup;
-    static const char* m_sPreviewGroup;
-    static const char* m_sSamplerGroup;
-    static const double kDefaultRateRange;
-    static const double kDefaultRateDir;
-    static const double kRateRangeDivisor;
-    static const int kProcessBufferSize;
 };
 
 class SignalPathTest : public BaseSignalPathTest {
   protected:
     SignalPathTest() {
-        const QString kTrackLocationTest = QDir::currentPath() + "/src/test/sine-30.wav";
-        TrackPointer pTrack(Track::newTemporary(kTrackLocationTest));
-
-        loadTrack(m_pMixerDeck1, pTrack);
-        loadTrack(m_pMixerDeck2, pTrack);
-        loadTrack(m_pMixerDeck3, pTrack);
+        loadTestTracks();
     }
 };
 
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <QHash>
+#include <QList>
+
+#include <vector>
+
+#include "soundio/soundmanager.h"
+#include "soundio/soundmanagerutil.h"
+#include "test/signalpathtest.h"
+
+namespace {
+
+const int kFrames = 256;
+// A four channel device with the timecode input on channels 3 and 4
+const int kFrameSize = 4;
+const unsigned char kChannelBase = 2;
+const CSAMPLE kUnwritten = -2.0f;
+
+// Reads the samples from the device buffer like VinylControlProcessor
+class ViewDestination : public AudioDestination {
+  public:
+    void receiveBuffer(AudioInput input, const CSAMPLE* pBuffer,
+                       unsigned int iNumFrames) override {
+        Q_UNUSED(input);
+        Q_UNUSED(pBuffer);
+        Q_UNUSED(iNumFrames);
+        ADD_FAILURE() << "Received a copied buffer instead of a view";
+    }
+    bool receivesInputViews() const override {
+        return true;
+    }
+    void receiveView(AudioInput input, const AudioInputView& view,
+                     unsigned int iNumFrames) override {
+        Q_UNUSED(input);
+        samples.resize(iNumFrames * 2);
+        view.copyStereo(samples.data(), 0, iNumFrames);
+    }
+
+    std::vector<CSAMPLE> samples;
+};
+
+// Needs the input as contiguous stereo samples like EngineAux
+class BufferDestination : public AudioDestination {
+  public:
+    BufferDestination()
+            : pReceived(NULL) {
+    }
+    void receiveBuffer(AudioInput input, const CSAMPLE* pBuffer,
+                       unsigned int iNumFrames) override {
+        Q_UNUSED(input);
+        pReceived = pBuffer;
+        samples.assign(pBuffer, pBuffer + iNumFrames * 2);
+    }
+
+    const CSAMPLE* pReceived;
+    std::vector<CSAMPLE> samples;
+};
+
+}  // namespace
+
+// Routes the inputs like SoundManager, but without a SoundManager that
+// would initialize PortAudio and probe the devices.
+class SoundManagerRoutingTest : public BaseSignalPathTest {
+  protected:
+    SoundManagerRoutingTest()
+            : m_input(AudioInput::VINYLCONTROL, kChannelBase, 2, 0),
+              m_device(kFrames * kFrameSize),
+              m_inputBuffer(kFrames * 2, kUnwritten) {
+        for (int i = 0; i < kFrames; ++i) {
+            for (int c = 0; c < kFrameSize; ++c) {
+                m_device[i * kFrameSize + c] = i / 1000.0f + c / 10.0f;
+            }
+            m_expected.push_back(m_device[i * kFrameSize + kChannelBase]);
+            m_expected.push_back(m_device[i * kFrameSize + kChannelBase + 1]);
+        }
+        m_inputs.append(AudioInputBuffer(m_input, m_inputBuffer.data()));
+
+        // Like PlayerManager, which registers the vinyl control
+        // processor and the passthrough deck for the same input
+        registerInput(&m_vinylControl);
+        registerInput(m_pChannel1);
+    }
+
+    // Like SoundManager::registerInput()
+    void registerInput(AudioDestination* pDestination) {
+        m_destinations.insertMulti(m_input, pDestination);
+    }
+
+    void setPassthrough(bool enabled) {
+        ControlObject::set(ConfigKey(m_pChannel1->getGroup(), "passthrough"),
+                enabled ? 1.0 : 0.0);
+    }
+
+    void pushInputViews() {
+        SoundManager::pushInputViews(m_destinations, m_inputs,
+                m_device.data(), kFrames, kFrameSize);
+    }
+
+    // The samples that the deck has received for passthrough
+    std::vector<CSAMPLE> deckSamples() const {
+        const CSAMPLE* pSamples = m_pChannel1->m_sampleBuffer;
+        if (!pSamples) {
+            return std::vector<CSAMPLE>();
+        }
+        return std::vector<CSAMPLE>(pSamples, pSamples + kFrames * 2);
+    }
+
+    bool inputBufferUnwritten() const {
+        for (const auto sample : m_inputBuffer) {
+            if (sample != kUnwritten) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ViewDestination m_vinylControl;
+    BufferDestination m_bufferDestination;
+
+    QHash<AudioInput, AudioDestination*> m_destinations;
+    const AudioInput m_input;
+    std::vector<CSAMPLE> m_device;
+    std::vector<CSAMPLE> m_inputBuffer;
+    std::vector<CSAMPLE> m_expected;
+    QList<AudioInputBuffer> m_inputs;
+};
+
+TEST_F(SoundManagerRoutingTest, VinylControlWithoutPassthroughIsNotCopied) {
+    setPassthrough(false);
+    pushInputViews();
+
+    EXPECT_EQ(m_expected, m_vinylControl.samples);
+    EXPECT_FALSE(m_pChannel1->isPassthroughActive());
+    EXPECT_TRUE(deckSamples().empty());
+    EXPECT_TRUE(inputBufferUnwritten());
+}
+
+TEST_F(SoundManagerRoutingTest, VinylControlWithPassthrough) {
+    setPassthrough(true);
+    pushInputViews();
+
+    EXPECT_EQ(m_expected, m_vinylControl.samples);
+    EXPECT_TRUE(m_pChannel1->isPassthroughActive());
+    // The deck copies the samples to its own buffer
+    EXPECT_EQ(m_expected, deckSamples());
+    EXPECT_TRUE(inputBufferUnwritten());
+
+    setPassthrough(false);
+    pushInputViews();
+    EXPECT_FALSE(m_pChannel1->isPassthroughActive());
+    EXPECT_TRUE(deckSamples().empty());
+}
+
+TEST_F(SoundManagerRoutingTest, BufferDestinationReceivesComposedInput) {
+    registerInput(&m_bufferDestination);
+    setPassthrough(false);
+    pushInputViews();
+
+    EXPECT_EQ(m_expected, m_vinylControl.samples);
+    EXPECT_EQ(m_inputBuffer.data(), m_bufferDestination.pReceived);
+    EXPECT_EQ(m_expected, m_bufferDestination.samples);
+}
@@ -1,3 +1,7 @@
+#include <benchmark/benchmark.h>
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QtDebug>
 
@@ -645,3 +649,198 @@ TEST_F(SoundSourceProxyTest, regressionTestCachingReaderChunkJumpForward) {
         }
     }
 }
+
+namespace {
+
+const QString kMp3ProviderName = QStringLiteral("MAD: MPEG Audio Decoder");
+
+// Opens an MP3 file with the MAD decoder that uses a persisted seek
+// index. Returns nullptr if the file is decoded by a different
+// SoundSource.
+mixxx::AudioSourcePointer openMp3AudioSource(
+        const QString& filePath,
+        const QString& seekIndexDir) {
+    SoundSourceProxy proxy(Track::newTemporary(filePath));
+    if (!proxy.getSoundSourceProvider() ||
+            (proxy.getSoundSourceProvider()->getName() != kMp3ProviderName)) {
+        return mixxx::AudioSourcePointer();
+    }
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setSeekIndexDir(seekIndexDir);
+    return proxy.openAudioSource(openParams);
+}
+
+// Concatenates copies of an MP3 file for simulating long files. The
+// tags between the copies are skipped while scanning the file.
+bool writeConcatenatedMp3File(
+        const QString& filePath,
+        const QString& sourceFilePath,
+        int copies) {
+    QFile sourceFile(sourceFilePath);
+    if (!sourceFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = sourceFile.readAll();
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    for (int i = 0; i < copies; ++i) {
+        if (file.write(data) != data.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QStringList seekIndexFiles(const QString& seekIndexDir) {
+    return QDir(seekIndexDir).entryList(QDir::Files);
+}
+
+} // anonymous namespace
+
+TEST_F(SoundSourceProxyTest, persistMp3SeekIndex) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.path() + "/long.mp3";
+    ASSERT_TRUE(writeConcatenatedMp3File(
+            filePath, kTestDir.absoluteFilePath("cover-test-png.mp3"), 20));
+    const QString seekIndexDir = tempDir.path() + "/seekindex";
+
+    // Scanning the file creates the index
+    QElapsedTimer timer;
+    timer.start();
+    mixxx::AudioSourcePointer pScannedSource =
+            openMp3AudioSource(filePath, seekIndexDir);
+    const qint64 scanNanos = timer.nsecsElapsed();
+    if (!pScannedSource) {
+        qWarning() << "Skipping test, MP3 files are not decoded by" << kMp3ProviderName;
+        return;
+    }
+    ASSERT_EQ(1, seekIndexFiles(seekIndexDir).size());
+
+    // Reopening the file loads the index
+    timer.start();
+    mixxx::AudioSourcePointer pIndexedSource =
+            openMp3AudioSource(filePath, seekIndexDir);
+    const qint64 loadNanos = timer.nsecsElapsed();
+    ASSERT_FALSE(!pIndexedSource);
+    qDebug() << "Opening MP3 file took"
+             << scanNanos / 1000 << "us when scanning and"
+             << loadNanos / 1000 << "us with a seek index";
+    EXPECT_EQ(pScannedSource->frameIndexRange(), pIndexedSource->frameIndexRange());
+    EXPECT_EQ(pScannedSource->sampleRate(), pIndexedSource->sampleRate());
+    EXPECT_EQ(pScannedSource->channelCount(), pIndexedSource->channelCount());
+    EXPECT_EQ(pScannedSource->bitrate(), pIndexedSource->bitrate());
+
+    // Both sources decode the same samples after seeking
+    const SINT kReadFrameCount = 4096;
+    mixxx::SampleBuffer scannedBuffer(pScannedSource->frames2samples(kReadFrameCount));
+    mixxx::SampleBuffer indexedBuffer(pIndexedSource->frames2samples(kReadFrameCount));
+    const SINT seekStep = pScannedSource->frameLength() / 7;
+    for (SINT frameIndex = pScannedSource->frameIndexMax() - kReadFrameCount;
+            frameIndex >= pScannedSource->frameIndexMin();
+            frameIndex -= seekStep) {
+        const auto readRange = mixxx::IndexRange::forward(frameIndex, kReadFrameCount);
+        const auto scannedRange = pScannedSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        readRange,
+                        mixxx::SampleBuffer::WritableSlice(scannedBuffer))).frameIndexRange();
+        const auto indexedRange = pIndexedSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        readRange,
+                        mixxx::SampleBuffer::WritableSlice(indexedBuffer))).frameIndexRange();
+        ASSERT_EQ(readRange, scannedRange);
+        ASSERT_EQ(readRange, indexedRange);
+        expectDecodedSamplesEqual(
+                pScannedSource->frames2samples(kReadFrameCount),
+                scannedBuffer.data(),
+                indexedBuffer.data(),
+                "Decoding with seek index differs");
+    }
+}
+
+TEST_F(SoundSourceProxyTest, discardInvalidMp3SeekIndex) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.path() + "/long.mp3";
+    ASSERT_TRUE(writeConcatenatedMp3File(
+            filePath, kTestDir.absoluteFilePath("cover-test-png.mp3"), 2));
+    const QString seekIndexDir = tempDir.path() + "/seekindex";
+
+    mixxx::AudioSourcePointer pScannedSource =
+            openMp3AudioSource(filePath, seekIndexDir);
+    if (!pScannedSource) {
+        qWarning() << "Skipping test, MP3 files are not decoded by" << kMp3ProviderName;
+        return;
+    }
+    ASSERT_EQ(1, seekIndexFiles(seekIndexDir).size());
+    const QString indexFilePath =
+            QDir(seekIndexDir).absoluteFilePath(seekIndexFiles(seekIndexDir).first());
+
+    // Truncate the index
+    const qint64 indexFileSize = QFileInfo(indexFilePath).size();
+    ASSERT_TRUE(QFile::resize(indexFilePath, indexFileSize - 1));
+
+    mixxx::AudioSourcePointer pReopenedSource =
+            openMp3AudioSource(filePath, seekIndexDir);
+    ASSERT_FALSE(!pReopenedSource);
+    EXPECT_EQ(pScannedSource->frameIndexRange(), pReopenedSource->frameIndexRange());
+    // The file has been scanned again and the index replaced
+    ASSERT_EQ(1, seekIndexFiles(seekIndexDir).size());
+    EXPECT_EQ(indexFileSize, QFileInfo(indexFilePath).size());
+}
+
+// Measures the time for opening a long MP3 file with the given number
+// of concatenated copies of a test file, either by scanning all frames
+// (0) or by loading a persisted seek index (1).
+static void BM_Mp3Open(benchmark::State& state) {
+    QTemporaryDir tempDir;
+    const QString filePath = tempDir.path() + "/long.mp3";
+    writeConcatenatedMp3File(
+            filePath, kTestDir.absoluteFilePath("cover-test-png.mp3"),
+            state.range_y());
+    const QString seekIndexDir = state.range_x() ? tempDir.path() + "/seekindex" : QString();
+    if (!openMp3AudioSource(filePath, seekIndexDir)) {
+        state.SetLabel("MP3 files are not decoded by MAD");
+        while (state.KeepRunning()) {
+        }
+        return;
+    }
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(openMp3AudioSource(filePath, seekIndexDir));
+    }
+}
+BENCHMARK(BM_Mp3Open)->ArgPair(0, 100)->ArgPair(1, 100)->ArgPair(0, 1000)->ArgPair(1, 1000);
+
+// Measures the latency of random jumps within a long MP3 file, e.g.
+// for hot cues, including the decoding of the first chunk.
+static void BM_Mp3Seek(benchmark::State& state) {
+    QTemporaryDir tempDir;
+    const QString filePath = tempDir.path() + "/long.mp3";
+    writeConcatenatedMp3File(
+            filePath, kTestDir.absoluteFilePath("cover-test-png.mp3"),
+            state.range_x());
+    auto pAudioSource = openMp3AudioSource(filePath, QString());
+    if (!pAudioSource) {
+        state.SetLabel("MP3 files are not decoded by MAD");
+        while (state.KeepRunning()) {
+        }
+        return;
+    }
+    const SINT kReadFrameCount = 1024;
+    mixxx::SampleBuffer readBuffer(pAudioSource->frames2samples(kReadFrameCount));
+    const SINT seekRange = pAudioSource->frameLength() - kReadFrameCount;
+    // Deterministic pseudo-random positions
+    SINT frameIndex = 0;
+    while (state.KeepRunning()) {
+        frameIndex = (frameIndex + 7919 * kReadFrameCount) % seekRange;
+        benchmark::DoNotOptimize(pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        mixxx::IndexRange::forward(
+                                pAudioSource->frameIndexMin() + frameIndex,
+                                kReadFrameCount),
+                        mixxx::SampleBuffer::WritableSlice(readBuffer))));
+    }
+}
+BENCHMARK(BM_Mp3Seek)->Arg(100)->Arg(1000);
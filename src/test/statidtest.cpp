@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <QThread>
+
+#include "util/statid.h"
+#include "util/statsmanager.h"
+
+namespace {
+
+TEST(StatIdTest, MetricNames) {
+    EXPECT_EQ(QString("mixxx_enginemaster_process"),
+            StatId::metricNameForKey("EngineMaster::process"));
+    EXPECT_EQ(QString("mixxx_enginebuffer_process_pauselock"),
+            StatId::metricNameForKey("EngineBuffer::process_pauselock"));
+    EXPECT_EQ(QString("mixxx_callback_input_1"),
+            StatId::metricNameForKey("Callback input #1 "));
+}
+
+TEST(StatIdTest, RegisterOnce) {
+    const StatId statId("StatIdTest::registerOnce", Stat::COUNTER);
+    ASSERT_TRUE(statId.isValid());
+    const StatId sameStatId("StatIdTest::registerOnce", Stat::COUNTER);
+    EXPECT_EQ(statId.value(), sameStatId.value());
+    const StatId otherStatId("StatIdTest::other", Stat::COUNTER);
+    EXPECT_NE(statId.value(), otherStatId.value());
+    EXPECT_LT(otherStatId.value(), StatId::registeredCount());
+    EXPECT_EQ(QString("StatIdTest::registerOnce"),
+            StatId::info(statId.value()).key);
+}
+
+TEST(StatIdTest, ReportWithoutStatsManager) {
+    // Must not crash
+    const StatId statId("StatIdTest::noManager", Stat::COUNTER);
+    statId.report(1.0);
+}
+
+TEST(StatIdTest, ExportMetrics) {
+    StatsManager* pManager = StatsManager::createInstance();
+    const StatId durationId("StatIdTest::duration", Stat::DURATION_NANOSEC);
+    const StatId counterId("StatIdTest::counter", Stat::COUNTER);
+    for (int i = 1; i <= 4; ++i) {
+        durationId.report(i * 1000000.0);
+        counterId.report(2);
+    }
+
+    // The pipes are drained periodically by the StatsManager thread
+    QString metrics;
+    for (int i = 0; i < 100; ++i) {
+        metrics.clear();
+        QTextStream out(&metrics);
+        pManager->writeMetrics(&out);
+        out.flush();
+        if (metrics.contains("mixxx_statidtest_counter_total 8")) {
+            break;
+        }
+        QThread::msleep(20);
+    }
+    StatsManager::destroy();
+
+    EXPECT_TRUE(metrics.contains(
+            "# TYPE mixxx_statidtest_duration_seconds summary")) << metrics;
+    EXPECT_TRUE(metrics.contains(
+            "mixxx_statidtest_duration_seconds_count 4")) << metrics;
+    EXPECT_TRUE(metrics.contains(
+            "mixxx_statidtest_duration_seconds_sum 0.01")) << metrics;
+    EXPECT_TRUE(metrics.contains(
+            "mixxx_statidtest_duration_seconds_max 0.004")) << metrics;
+    EXPECT_TRUE(metrics.contains(
+            "# TYPE mixxx_statidtest_counter_total counter")) << metrics;
+    EXPECT_TRUE(metrics.contains(
+            "mixxx_statidtest_counter_total 8")) << metrics;
+    EXPECT_TRUE(metrics.contains(
+            "mixxx_stats_dropped_reports_total 0")) << metrics;
+}
+
+}  // namespace
@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <QTemporaryDir>
+
+#include "sources/soundsourceproxy.h"
 #include "test/librarytest.h"
+#include "track/globaltrackcache.h"
 
 using ::testing::UnorderedElementsAre;
 
@@ -47,3 +51,91 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile));
 }
+
+TEST_F(TrackDAOTest, addTracksAddImportedTracks) {
+    TrackDAO& trackDAO = collection()->getTrackDAO();
+
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString testFile(QDir::currentPath() +
+            "/src/test/id3-test-data/cover-test-png.mp3");
+    // More tracks than fit into a single multi-row insert
+    const int kTrackCount = 50;
+    QStringList trackLocations;
+    QList<TrackPointer> importedTracks;
+    for (int i = 0; i < kTrackCount; ++i) {
+        const QString trackLocation(
+                tempDir.path() + QString("/track%1.mp3").arg(i));
+        ASSERT_TRUE(QFile::copy(testFile, trackLocation));
+        trackLocations << trackLocation;
+        TrackPointer pImportedTrack = Track::newTemporary(trackLocation);
+        SoundSourceProxy(pImportedTrack).updateTrackFromSource();
+        importedTracks << pImportedTrack;
+    }
+
+    // A location that already exists is reused
+    trackDAO.addTracksPrepare();
+    const TrackId existingId = trackDAO.addTracksAddTrack(
+            Track::newTemporary(trackLocations.first()), false);
+    trackDAO.addTracksFinish(false);
+    ASSERT_TRUE(existingId.isValid());
+
+    trackDAO.addTracksPrepare();
+    const QList<TrackPointer> addedTracks =
+            trackDAO.addTracksAddImportedTracks(importedTracks, false);
+    trackDAO.addTracksFinish(false);
+
+    // The existing track location is reused
+    ASSERT_EQ(kTrackCount, addedTracks.size());
+    QSet<TrackId> trackIds;
+    for (int i = 0; i < kTrackCount; ++i) {
+        const TrackPointer& pTrack = addedTracks[i];
+        EXPECT_EQ(trackLocations[i], pTrack->getLocation());
+        EXPECT_TRUE(pTrack->getId().isValid());
+        EXPECT_EQ(importedTracks[i]->getTitle(), pTrack->getTitle());
+        EXPECT_EQ(importedTracks[i]->getArtist(), pTrack->getArtist());
+        EXPECT_EQ(pTrack->getId(), trackDAO.getTrackId(pTrack->getLocation()));
+        trackIds.insert(pTrack->getId());
+    }
+    EXPECT_EQ(existingId, addedTracks.first()->getId());
+    EXPECT_EQ(kTrackCount, trackIds.size());
+    EXPECT_EQ(trackLocations.toSet(), trackDAO.getTrackLocations());
+}
+
+TEST_F(TrackDAOTest, addTracksAddImportedTracksCachedMeanwhile) {
+    TrackDAO& trackDAO = collection()->getTrackDAO();
+
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString testFile(QDir::currentPath() +
+            "/src/test/id3-test-data/cover-test-png.mp3");
+    const QString trackLocation(tempDir.path() + "/cached.mp3");
+    ASSERT_TRUE(QFile::copy(testFile, trackLocation));
+
+    // The track is cached after the scanner has parsed the file, e.g.
+    // because it has been loaded into a deck.
+    TrackPointer pImportedTrack = Track::newTemporary(trackLocation);
+    SoundSourceProxy(pImportedTrack).updateTrackFromSource();
+    const QString parsedTitle = pImportedTrack->getTitle();
+    pImportedTrack->setTitle("outdated");
+    TrackPointer pCachedTrack;
+    {
+        GlobalTrackCacheResolver cacheResolver(QFileInfo(trackLocation));
+        pCachedTrack = cacheResolver.getTrack();
+    }
+    ASSERT_TRUE(pCachedTrack);
+    EXPECT_FALSE(pCachedTrack->getId().isValid());
+
+    trackDAO.addTracksPrepare();
+    const QList<TrackPointer> addedTracks =
+            trackDAO.addTracksAddImportedTracks(
+                    QList<TrackPointer>() << pImportedTrack, false);
+    trackDAO.addTracksFinish(false);
+
+    // The cached object is added instead of the imported metadata
+    ASSERT_EQ(1, addedTracks.size());
+    EXPECT_EQ(pCachedTrack, addedTracks.first());
+    EXPECT_TRUE(pCachedTrack->getId().isValid());
+    EXPECT_EQ(parsedTitle, pCachedTrack->getTitle());
+    EXPECT_EQ(pCachedTrack->getId(), trackDAO.getTrackId(trackLocation));
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <benchmark/benchmark.h>
+
+#include <QTemporaryDir>
+#include <QtDebug>
+
+#include "util/math.h"
+#include "util/memory.h"
+#include "waveform/waveform.h"
+#include "waveform/waveformfile.h"
+
+namespace {
+
+const int kSampleRate = 44100;
+const int kVisualSampleRate = 441;
+
+// Silence at the start and the end with noise in between, i.e. a mix of
+// data that compresses well and data that doesn't compress at all.
+void fillWaveform(Waveform* pWaveform) {
+    const int dataSize = pWaveform->getDataSize();
+    WaveformData* pData = pWaveform->data();
+    unsigned int seed = 12345;
+    for (int i = 0; i < dataSize; ++i) {
+        if (i < dataSize / 8 || i > dataSize * 7 / 8) {
+            pData[i] = WaveformData(0);
+            continue;
+        }
+        seed = seed * 1103515245 + 12345;
+        pData[i] = WaveformData(static_cast<int>(seed >> 1));
+    }
+    pWaveform->setCompletion(dataSize);
+}
+
+std::unique_ptr<Waveform> createWaveform(int seconds) {
+    auto pWaveform = std::make_unique<Waveform>(
+            kSampleRate, kSampleRate * seconds, kVisualSampleRate, -1);
+    fillWaveform(pWaveform.get());
+    return pWaveform;
+}
+
+std::unique_ptr<Waveform> createWaveformSummary(int seconds) {
+    auto pWaveform = std::make_unique<Waveform>(
+            kSampleRate, kSampleRate * seconds, kVisualSampleRate, 2 * 1920);
+    fillWaveform(pWaveform.get());
+    return pWaveform;
+}
+
+void expectSameData(const Waveform& expected, const WaveformMipLevel& level) {
+    ASSERT_EQ(expected.getDataSize(), level.dataSize);
+    for (int i = 0; i < level.dataSize; ++i) {
+        ASSERT_EQ(expected.get(i).m_i, level.data[i].m_i) << "at index " << i;
+    }
+}
+
+class WaveformFileTest : public testing::TestWithParam<WaveformFile::Encoding> {
+};
+
+TEST_P(WaveformFileTest, WriteAndRead) {
+    const auto pWaveform = createWaveform(60);
+    const QByteArray data = WaveformFile::write(*pWaveform, GetParam(), 0);
+    ASSERT_TRUE(WaveformFile::isWaveformFile(data));
+
+    auto pFile = WaveformFile::fromByteArray(data);
+    ASSERT_TRUE(pFile);
+    EXPECT_EQ(1, pFile->levelCount());
+    EXPECT_DOUBLE_EQ(pWaveform->getVisualSampleRate(), pFile->visualSampleRate());
+    EXPECT_DOUBLE_EQ(pWaveform->getAudioVisualRatio(), pFile->audioVisualRatio());
+    expectSameData(*pWaveform, pFile->level(0));
+
+    const Waveform loaded(std::move(pFile));
+    EXPECT_TRUE(loaded.isValid());
+    EXPECT_EQ(pWaveform->getDataSize(), loaded.getDataSize());
+    EXPECT_EQ(loaded.getDataSize(), loaded.getCompletion());
+    EXPECT_EQ(Waveform::SaveState::Saved, loaded.saveState());
+}
+
+TEST_P(WaveformFileTest, MipLevelsKeepPeaks) {
+    const auto pWaveform = createWaveformSummary(300);
+    const QByteArray data = WaveformFile::write(
+            *pWaveform, GetParam(), WaveformFile::kMaxMipLevelCount);
+    auto pFile = WaveformFile::fromByteArray(data);
+    ASSERT_TRUE(pFile);
+    // ~3840 -> ~1920 -> ~960, levels with less than 512 samples are omitted
+    ASSERT_EQ(3, pFile->levelCount());
+    expectSameData(*pWaveform, pFile->level(0));
+
+    for (int levelIndex = 1; levelIndex < pFile->levelCount(); ++levelIndex) {
+        const WaveformMipLevel& level = pFile->level(levelIndex);
+        const int pairsPerSample = 1 << levelIndex;
+        for (int i = 0; i < level.dataSize; ++i) {
+            unsigned char maxAll = 0;
+            unsigned char maxLow = 0;
+            for (int j = 0; j < pairsPerSample; ++j) {
+                const int index = (i / 2 * pairsPerSample + j) * 2 + i % 2;
+                if (index < pWaveform->getDataSize()) {
+                    maxAll = math_max(maxAll, pWaveform->getAll(index));
+                    maxLow = math_max(maxLow, pWaveform->getLow(index));
+                }
+            }
+            ASSERT_EQ(maxAll, level.data[i].filtered.all);
+            ASSERT_EQ(maxLow, level.data[i].filtered.low);
+        }
+    }
+
+    const Waveform loaded(std::move(pFile));
+    EXPECT_EQ(3, loaded.getMipLevelCount());
+    EXPECT_EQ((pWaveform->getDataSize() + 7) / 8 * 2, loaded.getMipLevelDataSize(2));
+}
+
+TEST_P(WaveformFileTest, OpenFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.path() + "/waveform";
+    const auto pWaveform = createWaveform(30);
+    {
+        QFile file(filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(WaveformFile::write(*pWaveform, GetParam(), 0));
+    }
+    {
+        QFile file(filePath);
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        EXPECT_FALSE(WaveformFile::readHeader(&file).isEmpty());
+    }
+    auto pFile = WaveformFile::open(filePath);
+    ASSERT_TRUE(pFile);
+    expectSameData(*pWaveform, pFile->level(0));
+}
+
+INSTANTIATE_TEST_CASE_P(WaveformFileEncodings, WaveformFileTest,
+        testing::Values(
+                WaveformFile::Encoding::Raw,
+                WaveformFile::Encoding::DeltaRle));
+
+TEST(WaveformFileCorruptTest, RejectInvalidData) {
+    const auto pWaveform = createWaveform(10);
+    const QByteArray data = WaveformFile::write(
+            *pWaveform, WaveformFile::Encoding::DeltaRle, 0);
+    ASSERT_TRUE(WaveformFile::fromByteArray(data));
+    EXPECT_FALSE(WaveformFile::fromByteArray(data.left(data.size() - 1)));
+    EXPECT_FALSE(WaveformFile::fromByteArray(pWaveform->toByteArray()));
+    EXPECT_FALSE(WaveformFile::isWaveformFile(pWaveform->toByteArray()));
+    EXPECT_TRUE(WaveformFile::header(pWaveform->toByteArray()).isEmpty());
+
+    QByteArray corruptVersion = data;
+    corruptVersion[4] = 0x7F;
+    EXPECT_FALSE(WaveformFile::fromByteArray(corruptVersion));
+}
+
+TEST(WaveformFileSizeTest, CompressionReducesSize) {
+    const auto pWaveform = createWaveform(120);
+    const QByteArray raw = WaveformFile::write(
+            *pWaveform, WaveformFile::Encoding::Raw, 0);
+    const QByteArray compressed = WaveformFile::write(
+            *pWaveform, WaveformFile::Encoding::DeltaRle, 0);
+    EXPECT_LT(compressed.size(), raw.size());
+}
+
+// Compares loading the protobuf blobs of previous versions (0) with
+// loading the memory-mappable file raw (1) and compressed (2).
+static void BM_WaveformLoad(benchmark::State& state) {
+    QTemporaryDir tempDir;
+    const QString filePath = tempDir.path() + "/waveform";
+    const auto pWaveform = createWaveform(300);
+    const QByteArray compressedProtobuf = qCompress(pWaveform->toByteArray());
+    {
+        const WaveformFile::Encoding encoding = state.range_x() == 2 ?
+                WaveformFile::Encoding::DeltaRle : WaveformFile::Encoding::Raw;
+        QFile file(filePath);
+        file.open(QIODevice::WriteOnly);
+        file.write(WaveformFile::write(*pWaveform, encoding, 0));
+    }
+    while (state.KeepRunning()) {
+        std::unique_ptr<Waveform> pLoaded;
+        if (state.range_x() == 0) {
+            pLoaded = std::make_unique<Waveform>(qUncompress(compressedProtobuf));
+        } else {
+            pLoaded = std::make_unique<Waveform>(WaveformFile::open(filePath));
+        }
+        benchmark::DoNotOptimize(pLoaded->getAll(pLoaded->getDataSize() / 2));
+    }
+}
+BENCHMARK(BM_WaveformLoad)->Arg(0)->Arg(1)->Arg(2);
+
+}  // namespace
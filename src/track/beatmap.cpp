@@ -8,6 +8,10 @@
 #include <QtDebug>
 #include <QtGlobal>
 #include <QMutexLocker>
+#include <QThread>
+
+#include <algorithm>
+#include <vector>
 
 #include "track/beatmap.h"
 #include "track/beatutils.h"
@@ -21,7 +25,7 @@ inline double samplesToFrames(const double samples) {
     return floor(samples / kFrameSize);
 }
 
-inline double framesToSamples(const int frames) {
+inline double framesToSamples(const double frames) {
     return frames * kFrameSize;
 }
 
@@ -29,15 +33,194 @@ bool BeatLessThan(const Beat& beat1, const Beat& beat2) {
     return beat1.frame_position() < beat2.frame_position();
 }
 
+// An immutable copy of the enabled beats of a BeatMap. Lookups skip
+// disabled beats anyway, so the snapshot is a flat array of frame
+// positions that can be searched without looking at the Beat messages.
+class BeatMapSnapshot : public std::enable_shared_from_this<BeatMapSnapshot> {
+  public:
+    BeatMapSnapshot(const BeatList& beats, SINT sampleRate)
+            : m_sampleRate(sampleRate),
+              m_bpm(0) {
+        m_frames.reserve(beats.size());
+        for (const Beat& beat : beats) {
+            if (beat.enabled()) {
+                m_frames.push_back(beat.frame_position());
+            }
+        }
+        if (isValid()) {
+            m_bpm = calculateBpm(m_frames.front(), m_frames.back());
+        }
+    }
+
+    bool isValid() const {
+        return m_sampleRate > 0 && !m_frames.empty();
+    }
+
+    const std::vector<double>& frames() const {
+        return m_frames;
+    }
+
+    double bpm() const {
+        return m_bpm;
+    }
+
+    double findNthBeat(double dFrame, int n) const;
+    void findPrevNextBeats(double dFrame, double* pPrevFrame, double* pNextFrame) const;
+    double calculateBpm(double startFrame, double stopFrame) const;
+
+  private:
+    typedef std::vector<double>::const_iterator const_iterator;
+
+    // Finds the beats around dFrame. If dFrame is within 1/10th of a
+    // second of a beat, we pretend to be on that beat and pOnBeat points
+    // at it. Beats that are not found point at the end.
+    void findBeatsAround(double dFrame, const_iterator* pPrevBeat,
+            const_iterator* pOnBeat, const_iterator* pNextBeat) const;
+
+    SINT m_sampleRate;
+    double m_bpm;
+    std::vector<double> m_frames;
+};
+
+void BeatMapSnapshot::findBeatsAround(double dFrame, const_iterator* pPrevBeat,
+        const_iterator* pOnBeat, const_iterator* pNextBeat) const {
+    *pPrevBeat = m_frames.end();
+    *pOnBeat = m_frames.end();
+    *pNextBeat = m_frames.end();
+
+    // it points at the first occurrence of beat or the next largest beat
+    const_iterator it = std::lower_bound(m_frames.begin(), m_frames.end(), dFrame);
+
+    // If the position is within 1/10th of a second of the next or previous
+    // beat, pretend we are on that beat.
+    const double kFrameEpsilon = 0.1 * m_sampleRate;
+
+    // Back-up by one.
+    if (it != m_frames.begin()) {
+        --it;
+    }
+
+    // Scan forward to find whether we are on a beat. There are at most
+    // three beats to look at.
+    for (; it != m_frames.end(); ++it) {
+        const double delta = *it - dFrame;
+
+        // We are "on" this beat.
+        if (fabs(delta) < kFrameEpsilon) {
+            *pOnBeat = it;
+            return;
+        }
+
+        if (delta < 0) {
+            // If we are not on the beat and delta < 0 then this beat comes
+            // before our current position.
+            *pPrevBeat = it;
+        } else {
+            // If we are past the beat and we aren't on it then this beat comes
+            // after our current position.
+            *pNextBeat = it;
+            // Stop because we have everything we need now.
+            return;
+        }
+    }
+}
+
+double BeatMapSnapshot::findNthBeat(double dFrame, int n) const {
+    const_iterator prevBeat;
+    const_iterator onBeat;
+    const_iterator nextBeat;
+    findBeatsAround(dFrame, &prevBeat, &onBeat, &nextBeat);
+
+    // If we are within epsilon samples of a beat then the immediately next and
+    // previous beats are the beat we are on.
+    if (onBeat != m_frames.end()) {
+        nextBeat = onBeat;
+        prevBeat = onBeat;
+    }
+
+    if (n > 0) {
+        if (nextBeat != m_frames.end() && n - 1 < m_frames.end() - nextBeat) {
+            return *(nextBeat + (n - 1));
+        }
+    } else if (n < 0) {
+        if (prevBeat != m_frames.end() && -n - 1 <= prevBeat - m_frames.begin()) {
+            return *(prevBeat - (-n - 1));
+        }
+    }
+    return -1;
+}
+
+void BeatMapSnapshot::findPrevNextBeats(double dFrame,
+        double* pPrevFrame, double* pNextFrame) const {
+    const_iterator prevBeat;
+    const_iterator onBeat;
+    const_iterator nextBeat;
+    findBeatsAround(dFrame, &prevBeat, &onBeat, &nextBeat);
+
+    // If we are within epsilon samples of a beat then the immediately next and
+    // previous beats are the beat we are on.
+    if (onBeat != m_frames.end()) {
+        prevBeat = onBeat;
+        nextBeat = onBeat + 1;
+    }
+
+    *pPrevFrame = prevBeat != m_frames.end() ? *prevBeat : -1;
+    *pNextFrame = nextBeat != m_frames.end() ? *nextBeat : -1;
+}
+
+double BeatMapSnapshot::calculateBpm(double startFrame, double stopFrame) const {
+    if (startFrame > stopFrame) {
+        return -1;
+    }
+
+    const_iterator curBeat =
+            std::lower_bound(m_frames.begin(), m_frames.end(), startFrame);
+    const_iterator lastBeat =
+            std::upper_bound(m_frames.begin(), m_frames.end(), stopFrame);
+    if (curBeat >= lastBeat) {
+        return -1;
+    }
+
+    QVector<double> beatvect;
+    beatvect.reserve(lastBeat - curBeat);
+    for (; curBeat != lastBeat; ++curBeat) {
+        beatvect.append(*curBeat);
+    }
+    return BeatUtils::calculateBpm(beatvect, m_sampleRate, 0, 9999);
+}
+
+// Lookups never block: they announce themselves in m_activeReaders before
+// they load the published snapshot. A writer that has published a new
+// snapshot waits until it sees no active readers, after that nobody can
+// use the previous snapshot any more.
+class BeatMap::SnapshotReader {
+  public:
+    explicit SnapshotReader(const BeatMap& beatMap)
+            : m_activeReaders(beatMap.m_activeReaders) {
+        m_activeReaders.fetch_add(1);
+        m_pSnapshot = beatMap.m_pPublishedSnapshot.load();
+    }
+    ~SnapshotReader() {
+        m_activeReaders.fetch_sub(1);
+    }
+
+    const BeatMapSnapshot* operator->() const {
+        return m_pSnapshot;
+    }
+
+  private:
+    std::atomic<int>& m_activeReaders;
+    const BeatMapSnapshot* m_pSnapshot;
+};
+
 class BeatMapIterator : public BeatIterator {
   public:
-    BeatMapIterator(BeatList::const_iterator start, BeatList::const_iterator end)
-            : m_currentBeat(start),
+    BeatMapIterator(std::shared_ptr<const BeatMapSnapshot> pSnapshot,
+            std::vector<double>::const_iterator start,
+            std::vector<double>::const_iterator end)
+            : m_pSnapshot(std::move(pSnapshot)),
+              m_currentBeat(start),
               m_endBeat(end) {
-        // Advance to the first enabled beat.
-        while (m_currentBeat != m_endBeat && !m_currentBeat->enabled()) {
-            ++m_currentBeat;
-        }
     }
 
     virtual bool hasNext() const {
@@ -45,24 +228,24 @@ class BeatMapIterator : public BeatIterator {
     }
 
     virtual double next() {
-        double beat = framesToSamples(m_currentBeat->frame_position());
+        double beat = framesToSamples(*m_currentBeat);
         ++m_currentBeat;
-        while (m_currentBeat != m_endBeat && !m_currentBeat->enabled()) {
-            ++m_currentBeat;
-        }
         return beat;
     }
 
   private:
-    BeatList::const_iterator m_currentBeat;
-    BeatList::const_iterator m_endBeat;
+    // Keeps the beats alive while the BeatMap is edited
+    const std::shared_ptr<const BeatMapSnapshot> m_pSnapshot;
+    std::vector<double>::const_iterator m_currentBeat;
+    std::vector<double>::const_iterator m_endBeat;
 };
 
 BeatMap::BeatMap(const Track& track, SINT iSampleRate)
         : m_mutex(QMutex::Recursive),
           m_iSampleRate(iSampleRate > 0 ? iSampleRate : track.getSampleRate()),
-          m_dCachedBpm(0),
-          m_dLastFrame(0) {
+          m_pSnapshot(std::make_shared<BeatMapSnapshot>(m_beats, m_iSampleRate)),
+          m_pPublishedSnapshot(m_pSnapshot.get()),
+          m_activeReaders(0) {
     // BeatMap should live in the same thread as the track it is associated
     // with.
     moveToThread(track.thread());
@@ -86,9 +269,11 @@ BeatMap::BeatMap (const BeatMap& other)
         : m_mutex(QMutex::Recursive),
           m_subVersion(other.m_subVersion),
           m_iSampleRate(other.m_iSampleRate),
-          m_dCachedBpm(other.m_dCachedBpm),
-          m_dLastFrame(other.m_dLastFrame),
-          m_beats(other.m_beats) {
+          m_beats(other.m_beats),
+          // The snapshot is immutable and can be shared
+          m_pSnapshot(other.m_pSnapshot),
+          m_pPublishedSnapshot(m_pSnapshot.get()),
+          m_activeReaders(0) {
     moveToThread(other.thread());
 }
 
@@ -177,10 +362,6 @@ double BeatMap::findPrevBeat(double dSamples) const {
 }
 
 double BeatMap::findClosestBeat(double dSamples) const {
-    QMutexLocker locker(&m_mutex);
-    if (!isValid()) {
-        return -1;
-    }
     double prevBeat;
     double nextBeat;
     findPrevNextBeats(dSamples, &prevBeat, &nextBeat);
@@ -194,211 +375,75 @@ double BeatMap::findClosestBeat(double dSamples) const {
 }
 
 double BeatMap::findNthBeat(double dSamples, int n) const {
-    QMutexLocker locker(&m_mutex);
-
-    if (!isValid() || n == 0) {
+    SnapshotReader snapshot(*this);
+    if (!snapshot->isValid() || n == 0) {
         return -1;
     }
-
-    Beat beat;
     // Reduce sample offset to a frame offset.
-    beat.set_frame_position(samplesToFrames(dSamples));
-
-    // it points at the first occurrence of beat or the next largest beat
-    BeatList::const_iterator it =
-            qLowerBound(m_beats.constBegin(), m_beats.constEnd(), beat, BeatLessThan);
-
-    // If the position is within 1/10th of a second of the next or previous
-    // beat, pretend we are on that beat.
-    const double kFrameEpsilon = 0.1 * m_iSampleRate;
-
-    // Back-up by one.
-    if (it != m_beats.begin()) {
-        --it;
-    }
-
-    // Scan forward to find whether we are on a beat.
-    BeatList::const_iterator on_beat = m_beats.constEnd();
-    BeatList::const_iterator previous_beat = m_beats.constEnd();
-    BeatList::const_iterator next_beat = m_beats.constEnd();
-    for (; it != m_beats.end(); ++it) {
-        qint32 delta = it->frame_position() - beat.frame_position();
-
-        // We are "on" this beat.
-        if (abs(delta) < kFrameEpsilon) {
-            on_beat = it;
-            break;
-        }
-
-        if (delta < 0) {
-            // If we are not on the beat and delta < 0 then this beat comes
-            // before our current position.
-            previous_beat = it;
-        } else {
-            // If we are past the beat and we aren't on it then this beat comes
-            // after our current position.
-            next_beat = it;
-            // Stop because we have everything we need now.
-            break;
-        }
-    }
-
-    // If we are within epsilon samples of a beat then the immediately next and
-    // previous beats are the beat we are on.
-    if (on_beat != m_beats.end()) {
-        next_beat = on_beat;
-        previous_beat = on_beat;
-    }
-
-    if (n > 0) {
-        for (; next_beat != m_beats.end(); ++next_beat) {
-            if (!next_beat->enabled()) {
-                continue;
-            }
-            if (n == 1) {
-                // Return a sample offset
-                return framesToSamples(next_beat->frame_position());
-            }
-            --n;
-        }
-    } else if (n < 0 && previous_beat != m_beats.end()) {
-        for (; true; --previous_beat) {
-            if (previous_beat->enabled()) {
-                if (n == -1) {
-                    // Return a sample offset
-                    return framesToSamples(previous_beat->frame_position());
-                }
-                ++n;
-            }
-
-            // Don't step before the start of the list.
-            if (previous_beat == m_beats.begin()) {
-                break;
-            }
-        }
+    const double beatFrame = snapshot->findNthBeat(samplesToFrames(dSamples), n);
+    if (beatFrame == -1) {
+        return -1;
     }
-    return -1;
+    // Return a sample offset
+    return framesToSamples(beatFrame);
 }
 
 bool BeatMap::findPrevNextBeats(double dSamples,
                                 double* dpPrevBeatSamples,
                                 double* dpNextBeatSamples) const {
-    QMutexLocker locker(&m_mutex);
+    *dpPrevBeatSamples = -1;
+    *dpNextBeatSamples = -1;
 
-    if (!isValid()) {
-        *dpPrevBeatSamples = -1;
-        *dpNextBeatSamples = -1;
+    SnapshotReader snapshot(*this);
+    if (!snapshot->isValid()) {
         return false;
     }
 
-    Beat beat;
+    double prevBeatFrame;
+    double nextBeatFrame;
     // Reduce sample offset to a frame offset.
-    beat.set_frame_position(samplesToFrames(dSamples));
-
-    // it points at the first occurrence of beat or the next largest beat
-    BeatList::const_iterator it =
-            qLowerBound(m_beats.constBegin(), m_beats.constEnd(), beat, BeatLessThan);
-
-    // If the position is within 1/10th of a second of the next or previous
-    // beat, pretend we are on that beat.
-    const double kFrameEpsilon = 0.1 * m_iSampleRate;
-
-    // Back-up by one.
-    if (it != m_beats.begin()) {
-        --it;
+    snapshot->findPrevNextBeats(samplesToFrames(dSamples),
+            &prevBeatFrame, &nextBeatFrame);
+    if (prevBeatFrame != -1) {
+        *dpPrevBeatSamples = framesToSamples(prevBeatFrame);
     }
-
-    // Scan forward to find whether we are on a beat.
-    BeatList::const_iterator on_beat = m_beats.constEnd();
-    BeatList::const_iterator previous_beat = m_beats.constEnd();
-    BeatList::const_iterator next_beat = m_beats.constEnd();
-    for (; it != m_beats.end(); ++it) {
-        qint32 delta = it->frame_position() - beat.frame_position();
-
-        // We are "on" this beat.
-        if (abs(delta) < kFrameEpsilon) {
-            on_beat = it;
-            break;
-        }
-
-        if (delta < 0) {
-            // If we are not on the beat and delta < 0 then this beat comes
-            // before our current position.
-            previous_beat = it;
-        } else {
-            // If we are past the beat and we aren't on it then this beat comes
-            // after our current position.
-            next_beat = it;
-            // Stop because we have everything we need now.
-            break;
-        }
-    }
-
-    // If we are within epsilon samples of a beat then the immediately next and
-    // previous beats are the beat we are on.
-    if (on_beat != m_beats.end()) {
-        previous_beat = on_beat;
-        next_beat = on_beat + 1;
-    }
-
-    *dpPrevBeatSamples = -1;
-    *dpNextBeatSamples = -1;
-
-    for (; next_beat != m_beats.end(); ++next_beat) {
-        if (!next_beat->enabled()) {
-            continue;
-        }
-        *dpNextBeatSamples = framesToSamples(next_beat->frame_position());
-        break;
-    }
-    if (previous_beat != m_beats.end()) {
-        for (; true; --previous_beat) {
-            if (previous_beat->enabled()) {
-                *dpPrevBeatSamples = framesToSamples(previous_beat->frame_position());
-                break;
-            }
-
-            // Don't step before the start of the list.
-            if (previous_beat == m_beats.begin()) {
-                break;
-            }
-        }
+    if (nextBeatFrame != -1) {
+        *dpNextBeatSamples = framesToSamples(nextBeatFrame);
     }
     return *dpPrevBeatSamples != -1 && *dpNextBeatSamples != -1;
 }
 
 std::unique_ptr<BeatIterator> BeatMap::findBeats(double startSample, double stopSample) const {
-    QMutexLocker locker(&m_mutex);
+    SnapshotReader snapshot(*this);
     //startSample and stopSample are sample offsets, converting them to
     //frames
-    if (!isValid() || startSample > stopSample) {
+    if (!snapshot->isValid() || startSample > stopSample) {
         return std::unique_ptr<BeatIterator>();
     }
 
-    Beat startBeat, stopBeat;
-    startBeat.set_frame_position(samplesToFrames(startSample));
-    stopBeat.set_frame_position(samplesToFrames(stopSample));
-
-    BeatList::const_iterator curBeat =
-            qLowerBound(m_beats.constBegin(), m_beats.constEnd(),
-                        startBeat, BeatLessThan);
-
-    BeatList::const_iterator lastBeat =
-            qUpperBound(m_beats.constBegin(), m_beats.constEnd(),
-                        stopBeat, BeatLessThan);
+    const std::vector<double>& frames = snapshot->frames();
+    std::vector<double>::const_iterator curBeat = std::lower_bound(
+            frames.begin(), frames.end(), samplesToFrames(startSample));
+    std::vector<double>::const_iterator lastBeat = std::upper_bound(
+            frames.begin(), frames.end(), samplesToFrames(stopSample));
 
     if (curBeat >= lastBeat) {
         return std::unique_ptr<BeatIterator>();
     }
-    return std::make_unique<BeatMapIterator>(curBeat, lastBeat);
+    // The iterator owns a reference to the snapshot that outlives the reader
+    return std::make_unique<BeatMapIterator>(
+            snapshot->shared_from_this(), curBeat, lastBeat);
 }
 
 bool BeatMap::hasBeatInRange(double startSample, double stopSample) const {
-    QMutexLocker locker(&m_mutex);
-    if (!isValid() || startSample > stopSample) {
+    SnapshotReader snapshot(*this);
+    if (!snapshot->isValid() || startSample > stopSample) {
         return false;
     }
-    double curBeat = findNextBeat(startSample);
+    double curBeat = snapshot->findNthBeat(samplesToFrames(startSample), 1);
+    if (curBeat != -1) {
+        curBeat = framesToSamples(curBeat);
+    }
     if (curBeat <= stopSample) {
         return true;
     }
@@ -406,51 +451,49 @@ bool BeatMap::hasBeatInRange(double startSample, double stopSample) const {
 }
 
 double BeatMap::getBpm() const {
-    QMutexLocker locker(&m_mutex);
-    if (!isValid())
+    SnapshotReader snapshot(*this);
+    if (!snapshot->isValid())
         return -1;
-    return m_dCachedBpm;
+    return snapshot->bpm();
 }
 
 double BeatMap::getBpmRange(double startSample, double stopSample) const {
-    QMutexLocker locker(&m_mutex);
-    if (!isValid())
+    SnapshotReader snapshot(*this);
+    if (!snapshot->isValid())
         return -1;
-    Beat startBeat, stopBeat;
-    startBeat.set_frame_position(samplesToFrames(startSample));
-    stopBeat.set_frame_position(samplesToFrames(stopSample));
-    return calculateBpm(startBeat, stopBeat);
+    return snapshot->calculateBpm(
+            samplesToFrames(startSample), samplesToFrames(stopSample));
 }
 
 double BeatMap::getBpmAroundPosition(double curSample, int n) const {
-    QMutexLocker locker(&m_mutex);
-    if (!isValid())
+    SnapshotReader snapshot(*this);
+    if (!snapshot->isValid())
         return -1;
 
+    const std::vector<double>& frames = snapshot->frames();
+    const double curFrame = samplesToFrames(curSample);
+
     // To make sure we are always counting n beats, iterate backward to the
     // lower bound, then iterate forward from there to the upper bound.
     // a value of -1 indicates we went off the map -- count from the beginning.
-    double lower_bound = findNthBeat(curSample, -n);
-    if (lower_bound == -1) {
-        lower_bound = framesToSamples(m_beats.first().frame_position());
+    double lowerBound = snapshot->findNthBeat(curFrame, -n);
+    if (lowerBound == -1) {
+        lowerBound = frames.front();
     }
 
     // If we hit the end of the beat map, recalculate the lower bound.
-    double upper_bound = findNthBeat(lower_bound, n * 2);
-    if (upper_bound == -1) {
-        upper_bound = framesToSamples(m_beats.last().frame_position());
-        lower_bound = findNthBeat(upper_bound, n * -2);
+    double upperBound = snapshot->findNthBeat(lowerBound, n * 2);
+    if (upperBound == -1) {
+        upperBound = frames.back();
+        lowerBound = snapshot->findNthBeat(upperBound, n * -2);
         // Super edge-case -- the track doesn't have n beats!  Do the best
         // we can.
-        if (lower_bound == -1) {
-            lower_bound = framesToSamples(m_beats.first().frame_position());
+        if (lowerBound == -1) {
+            lowerBound = frames.front();
         }
     }
 
-    Beat startBeat, stopBeat;
-    startBeat.set_frame_position(samplesToFrames(lower_bound));
-    stopBeat.set_frame_position(samplesToFrames(upper_bound));
-    return calculateBpm(startBeat, stopBeat);
+    return snapshot->calculateBpm(lowerBound, upperBound);
 }
 
 void BeatMap::addBeat(double dBeatSample) {
@@ -715,39 +758,13 @@ void BeatMap::setBpm(double dBpm) {
 }
 
 void BeatMap::onBeatlistChanged() {
-    if (!isValid()) {
-        m_dLastFrame = 0;
-        m_dCachedBpm = 0;
-        return;
-    }
-    m_dLastFrame = m_beats.last().frame_position();
-    Beat startBeat = m_beats.first();
-    Beat stopBeat =  m_beats.last();
-    m_dCachedBpm = calculateBpm(startBeat, stopBeat);
-}
-
-double BeatMap::calculateBpm(const Beat& startBeat, const Beat& stopBeat) const {
-    if (startBeat.frame_position() > stopBeat.frame_position()) {
-        return -1;
-    }
-
-    BeatList::const_iterator curBeat =
-            qLowerBound(m_beats.constBegin(), m_beats.constEnd(), startBeat, BeatLessThan);
-
-    BeatList::const_iterator lastBeat =
-            qUpperBound(m_beats.constBegin(), m_beats.constEnd(), stopBeat, BeatLessThan);
-
-    QVector<double> beatvect;
-    for (; curBeat != lastBeat; ++curBeat) {
-        const Beat& beat = *curBeat;
-        if (beat.enabled()) {
-            beatvect.append(beat.frame_position());
-        }
-    }
-
-    if (beatvect.isEmpty()) {
-        return -1;
-    }
-
-    return BeatUtils::calculateBpm(beatvect, m_iSampleRate, 0, 9999);
+    std::shared_ptr<const BeatMapSnapshot> pSnapshot =
+            std::make_shared<BeatMapSnapshot>(m_beats, m_iSampleRate);
+    m_pPublishedSnapshot.store(pSnapshot.get());
+    // Lookups are short and never block, i.e. the wait is over as soon as
+    // the lookups that might have loaded the previous snapshot are done.
+    while (m_activeReaders.load() > 0) {
+        QThread::yieldCurrentThread();
+    }
+    m_pSnapshot = std::move(pSnapshot);
 }
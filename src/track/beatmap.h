@@ -10,6 +10,9 @@
 
 #include <QMutex>
 
+#include <atomic>
+#include <memory>
+
 #include "track/track.h"
 #include "track/beats.h"
 #include "proto/beats.pb.h"
@@ -18,6 +21,12 @@
 
 typedef QList<mixxx::track::io::Beat> BeatList;
 
+class BeatMapSnapshot;
+
+// The beats are stored in a BeatList that is only touched by mutations and
+// serialization under the mutex. All lookups use an immutable snapshot of
+// the enabled beat positions that is replaced after every mutation, such
+// that the engine never waits for the GUI editing the beats.
 class BeatMap final : public Beats {
   public:
     // Construct a BeatMap. iSampleRate may be provided if a more accurate
@@ -81,13 +90,15 @@ class BeatMap final : public Beats {
     virtual void setBpm(double dBpm);
 
   private:
+    // Pins the published snapshot while it is in use, see onBeatlistChanged()
+    class SnapshotReader;
+
     BeatMap(const BeatMap& other);
     bool readByteArray(const QByteArray& byteArray);
     void createFromBeatVector(const QVector<double>& beats);
+    // Replaces the snapshot of the lookups by one of m_beats and releases
+    // the previous one when no lookup uses it any more.
     void onBeatlistChanged();
-
-    double calculateBpm(const mixxx::track::io::Beat& startBeat,
-                        const mixxx::track::io::Beat& stopBeat) const;
     // For internal use only.
     bool isValid() const;
 
@@ -101,9 +112,13 @@ class BeatMap final : public Beats {
     mutable QMutex m_mutex;
     QString m_subVersion;
     SINT m_iSampleRate;
-    double m_dCachedBpm;
-    double m_dLastFrame;
     BeatList m_beats;
+
+    // Owns the published snapshot, guarded by m_mutex
+    std::shared_ptr<const BeatMapSnapshot> m_pSnapshot;
+    std::atomic<const BeatMapSnapshot*> m_pPublishedSnapshot;
+    // The number of lookups that might use the published snapshot
+    mutable std::atomic<int> m_activeReaders;
 };
 
 #endif /* BEATMAP_H_ */
@@ -115,7 +115,7 @@ void GlobalTrackCacheLocker::unlockCache() {
         if (kLogStats && debugLogEnabled()) {
             kLogger.debug()
                     << "#tracksById ="
-                    << m_pInstance->m_tracksById.size()
+                    << m_pInstance->tracksByIdCount()
                     << "/ #tracksByCanonicalLocation ="
                     << m_pInstance->m_tracksByCanonicalLocation.size();
         }
@@ -247,10 +247,25 @@ void GlobalTrackCache::evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cach
     }
 }
 
+//static
+TrackPointer GlobalTrackCache::lookupTrackById(const TrackId& trackId) {
+    DEBUG_ASSERT(s_pInstance);
+    bool found = false;
+    TrackPointer strongPtr = s_pInstance->lookupAliveById(trackId, &found);
+    if (found && !strongPtr) {
+        // The track needs to be revived
+        return GlobalTrackCacheLocker().lookupTrackById(trackId);
+    }
+    return strongPtr;
+}
+
+GlobalTrackCache::Shard::Shard()
+    : tracksById(kUnorderedCollectionMinCapacity / kShardCount, DbId::hash_fun) {
+}
+
 GlobalTrackCache::GlobalTrackCache(GlobalTrackCacheSaver* pSaver)
     : m_mutex(QMutex::Recursive),
-      m_pSaver(pSaver),
-      m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun) {
+      m_pSaver(pSaver) {
     DEBUG_ASSERT(m_pSaver);
     qRegisterMetaType<GlobalTrackCacheEntryPointer>("GlobalTrackCacheEntryPointer");
 }
@@ -259,6 +274,22 @@ GlobalTrackCache::~GlobalTrackCache() {
     deactivate();
 }
 
+GlobalTrackCache::Shard& GlobalTrackCache::shardOf(const TrackId& trackId) {
+    return m_shards[DbId::hash_fun(trackId) % kShardCount];
+}
+
+const GlobalTrackCache::Shard& GlobalTrackCache::shardOf(const TrackId& trackId) const {
+    return m_shards[DbId::hash_fun(trackId) % kShardCount];
+}
+
+std::size_t GlobalTrackCache::tracksByIdCount() const {
+    std::size_t count = 0;
+    for (const auto& shard: m_shards) {
+        count += shard.tracksById.size();
+    }
+    return count;
+}
+
 void GlobalTrackCache::relocateTracks(
         GlobalTrackCacheRelocator* pRelocator) {
     if (debugLogEnabled()) {
@@ -323,23 +354,26 @@ void GlobalTrackCache::deactivate() {
     // referenced or not. This ensures that the eviction
     // callback is triggered for all modified tracks before
     // exiting the application.
-    auto i = m_tracksById.begin();
-    while (i != m_tracksById.end()) {
-        Track* plainPtr= i->second->getPlainPtr();
-        m_pSaver->saveCachedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(plainPtr->getCanonicalLocation());
-        i = m_tracksById.erase(i);
+    for (auto& shard: m_shards) {
+        QWriteLocker shardLocker(&shard.lock);
+        auto i = shard.tracksById.begin();
+        while (i != shard.tracksById.end()) {
+            Track* plainPtr= i->second->getPlainPtr();
+            m_pSaver->saveCachedTrack(plainPtr);
+            m_tracksByCanonicalLocation.erase(plainPtr->getCanonicalLocation());
+            i = shard.tracksById.erase(i);
+        }
     }
 
     auto j = m_tracksByCanonicalLocation.begin();
     while (j != m_tracksByCanonicalLocation.end()) {
-        Track* plainPtr= i->second->getPlainPtr();
+        Track* plainPtr= j->second->getPlainPtr();
         m_pSaver->saveCachedTrack(plainPtr);
         j = m_tracksByCanonicalLocation.erase(j);
     }
 
     // Verify that all cached tracks have been evicted
-    DEBUG_ASSERT(m_tracksById.empty());
+    DEBUG_ASSERT(tracksByIdCount() == 0);
     DEBUG_ASSERT(m_tracksByCanonicalLocation.empty());
 
     // The singular cache instance is already unavailable and
@@ -350,13 +384,14 @@ void GlobalTrackCache::deactivate() {
 }
 
 bool GlobalTrackCache::isEmpty() const {
-    return m_tracksById.empty() && m_tracksByCanonicalLocation.empty();
+    return tracksByIdCount() == 0 && m_tracksByCanonicalLocation.empty();
 }
 
 TrackPointer GlobalTrackCache::lookupById(
         const TrackId& trackId) {
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
+    const TracksById& tracksById = shardOf(trackId).tracksById;
+    const auto trackById(tracksById.find(trackId));
+    if (tracksById.end() != trackById) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
@@ -376,6 +411,22 @@ TrackPointer GlobalTrackCache::lookupById(
     }
 }
 
+TrackPointer GlobalTrackCache::lookupAliveById(
+        const TrackId& trackId,
+        bool* pFound) const {
+    DEBUG_ASSERT(pFound);
+    const Shard& shard = shardOf(trackId);
+    QReadLocker shardLocker(&shard.lock);
+    const auto trackById(shard.tracksById.find(trackId));
+    if (shard.tracksById.end() == trackById) {
+        *pFound = false;
+        return TrackPointer();
+    }
+    *pFound = true;
+    // Zombies that are about to be evicted can't be locked
+    return trackById->second->getSavingWeakPtr().lock();
+}
+
 TrackPointer GlobalTrackCache::lookupByRef(
         const TrackRef& trackRef) {
     if (trackRef.hasId()) {
@@ -432,7 +483,14 @@ TrackPointer GlobalTrackCache::revive(
 
     savingPtr = TrackPointer(entryPtr->getPlainPtr(),
             EvictAndSaveFunctor(entryPtr));
-    entryPtr->setSavingWeakPtr(savingPtr);
+    const TrackId trackId = entryPtr->getPlainPtr()->getId();
+    if (trackId.isValid()) {
+        // The entry is visible for lookupAliveById()
+        QWriteLocker shardLocker(&shardOf(trackId).lock);
+        entryPtr->setSavingWeakPtr(savingPtr);
+    } else {
+        entryPtr->setSavingWeakPtr(savingPtr);
+    }
     return savingPtr;
 }
 
@@ -534,9 +592,11 @@ void GlobalTrackCache::resolve(
 
     if (trackRef.hasId()) {
         // Insert item by id
-        DEBUG_ASSERT(m_tracksById.find(
-                trackRef.getId()) == m_tracksById.end());
-        m_tracksById.insert(std::make_pair(
+        Shard& shard = shardOf(trackRef.getId());
+        QWriteLocker shardLocker(&shard.lock);
+        DEBUG_ASSERT(shard.tracksById.find(
+                trackRef.getId()) == shard.tracksById.end());
+        shard.tracksById.insert(std::make_pair(
                 trackRef.getId(),
                 cacheEntryPtr));
     }
@@ -568,14 +628,18 @@ TrackRef GlobalTrackCache::initTrackId(
     DEBUG_ASSERT(pDel);
 
     // Insert item by id
-    DEBUG_ASSERT(m_tracksById.find(trackId) == m_tracksById.end());
-    m_tracksById.insert(std::make_pair(
-            trackId,
-            pDel->getCacheEntryPointer()));
+    Shard& shard = shardOf(trackId);
+    {
+        QWriteLocker shardLocker(&shard.lock);
+        DEBUG_ASSERT(shard.tracksById.find(trackId) == shard.tracksById.end());
+        shard.tracksById.insert(std::make_pair(
+                trackId,
+                pDel->getCacheEntryPointer()));
+    }
 
     strongPtr->initId(trackId);
     DEBUG_ASSERT(createTrackRef(*strongPtr) == trackRefWithId);
-    DEBUG_ASSERT(m_tracksById.find(trackId) != m_tracksById.end());
+    DEBUG_ASSERT(shard.tracksById.find(trackId) != shard.tracksById.end());
 
     return trackRefWithId;
 }
@@ -636,10 +700,12 @@ bool GlobalTrackCache::evict(Track* plainPtr) {
                 << plainPtr;
     }
     if (trackRef.hasId()) {
-        const auto trackById = m_tracksById.find(trackRef.getId());
-        if (trackById != m_tracksById.end()) {
+        Shard& shard = shardOf(trackRef.getId());
+        QWriteLocker shardLocker(&shard.lock);
+        const auto trackById = shard.tracksById.find(trackRef.getId());
+        if (trackById != shard.tracksById.end()) {
             DEBUG_ASSERT(trackById->second->getPlainPtr() == plainPtr);
-            m_tracksById.erase(trackById);
+            shard.tracksById.erase(trackById);
             evicted = true;
         }
     }
@@ -662,9 +728,11 @@ bool GlobalTrackCache::evict(Track* plainPtr) {
 }
 
 bool GlobalTrackCache::isEvicted(Track* plainPtr) const {
-    for (auto&& entry: m_tracksById) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-            return false;
+    for (const auto& shard: m_shards) {
+        for (auto&& entry: shard.tracksById) {
+            if (entry.second->getPlainPtr() == plainPtr) {
+                return false;
+            }
         }
     }
     for (auto&& entry: m_tracksByCanonicalLocation) {
@@ -1,9 +1,12 @@
 #pragma once
 
 
+#include <array>
 #include <map>
 #include <unordered_map>
 
+#include <QReadWriteLock>
+
 #include "track/track.h"
 #include "track/trackref.h"
 
@@ -182,6 +185,16 @@ public:
     // See also: GlobalTrackCacheLocker::deactivateCache()
     static void destroyInstance();
 
+    // Lookup an existing and still referenced Track object by id
+    // without locking the whole cache. Only the shard that contains
+    // the id is locked for reading, i.e. concurrent lookups of
+    // different or even the same tracks don't block each other.
+    //
+    // Tracks that are about to be evicted can only be revived while
+    // holding the cache lock. The lookup then falls back to a locked
+    // lookup through GlobalTrackCacheLocker.
+    static TrackPointer lookupTrackById(const TrackId& trackId);
+
     // Deleter callbacks for the smart-pointer
     static void evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cacheEntryPtr);
 
@@ -200,6 +213,11 @@ private:
 
     TrackPointer lookupById(
             const TrackId& trackId);
+    // Only locks the corresponding shard for reading. Zombie
+    // tracks are not revived, but reported as found.
+    TrackPointer lookupAliveById(
+            const TrackId& trackId,
+            bool* pFound) const;
     TrackPointer lookupByRef(
             const TrackRef& trackRef);
 
@@ -230,7 +248,25 @@ private:
 
     // This caches the unsaved Tracks by ID
     typedef std::unordered_map<TrackId, GlobalTrackCacheEntryPointer, TrackId::hash_fun_t> TracksById;
-    TracksById m_tracksById;
+
+    // The tracks by ID are distributed among multiple shards that
+    // are guarded by their own lock. Modifying a shard or any of
+    // its entries requires to hold both m_mutex and the lock of
+    // the shard for writing. Reading a shard requires to hold
+    // either m_mutex or the lock of the shard for reading.
+    struct Shard {
+        Shard();
+
+        mutable QReadWriteLock lock;
+        TracksById tracksById;
+    };
+    static constexpr std::size_t kShardCount = 16;
+    std::array<Shard, kShardCount> m_shards;
+
+    Shard& shardOf(const TrackId& trackId);
+    const Shard& shardOf(const TrackId& trackId) const;
+
+    std::size_t tracksByIdCount() const;
 
     // This caches the unsaved Tracks by location
     typedef std::map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
@@ -58,6 +58,9 @@ bool CmdlineArgs::Parse(int &argc, char **argv) {
         } else if (argv[i] == QString("--timelinePath") && i+1 < argc) {
             m_timelinePath = QString::fromLocal8Bit(argv[i+1]);
             i++;
+        } else if (argv[i] == QString("--metricsPath") && i+1 < argc) {
+            m_metricsPath = QString::fromLocal8Bit(argv[i+1]);
+            i++;
         } else if (argv[i] == QString("--logLevel") && i+1 < argc) {
             logLevelSet = true;
             auto level = QLatin1String(argv[i+1]);
@@ -147,6 +150,9 @@ void CmdlineArgs::printUsage() {
 --developer             Enables developer-mode. Includes extra log info,\n\
                         stats on performance, and a Developer tools menu.\n\
 \n\
+--metricsPath PATH      Periodically exports performance metrics to the\n\
+                        file at PATH in the Prometheus text format.\n\
+\n\
 --safeMode              Enables safe-mode. Disables OpenGL waveforms,\n\
                         and spinning vinyl widgets. Try this option if\n\
                         Mixxx is crashing on startup.\n\
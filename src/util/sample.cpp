@@ -2,6 +2,7 @@
 #include <cstddef>
 
 #include "util/sample.h"
+#include "util/samplesimd.h"
 #include "util/math.h"
 
 #ifdef __WINDOWS__
@@ -239,6 +240,10 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        if (SampleUtilSimd::addWithRampingGain(
+                pDest, pSrc, start_gain, gain_delta, numSamples)) {
+            return;
+        }
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples / 2; ++i) {
             const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
@@ -270,6 +275,34 @@ void SampleUtil::add2WithGain(CSAMPLE* M_RESTRICT pDest,
     }
 }
 
+// static
+void SampleUtil::add2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1, CSAMPLE_GAIN gain1in, CSAMPLE_GAIN gain1out,
+        const CSAMPLE* M_RESTRICT pSrc2, CSAMPLE_GAIN gain2in, CSAMPLE_GAIN gain2out,
+        SINT numSamples) {
+    if (gain1in == CSAMPLE_GAIN_ZERO && gain1out == CSAMPLE_GAIN_ZERO) {
+        return addWithRampingGain(pDest, pSrc2, gain2in, gain2out, numSamples);
+    } else if (gain2in == CSAMPLE_GAIN_ZERO && gain2out == CSAMPLE_GAIN_ZERO) {
+        return addWithRampingGain(pDest, pSrc1, gain1in, gain1out, numSamples);
+    } else if (gain1in == gain1out && gain2in == gain2out) {
+        return add2WithGain(pDest, pSrc1, gain1in, pSrc2, gain2in, numSamples);
+    }
+
+    const CSAMPLE_GAIN gain_delta1 = (gain1out - gain1in)
+            / CSAMPLE_GAIN(numSamples / 2);
+    const CSAMPLE_GAIN start_gain1 = gain1in + gain_delta1;
+    const CSAMPLE_GAIN gain_delta2 = (gain2out - gain2in)
+            / CSAMPLE_GAIN(numSamples / 2);
+    const CSAMPLE_GAIN start_gain2 = gain2in + gain_delta2;
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numSamples / 2; ++i) {
+        const CSAMPLE_GAIN gain1 = start_gain1 + gain_delta1 * i;
+        const CSAMPLE_GAIN gain2 = start_gain2 + gain_delta2 * i;
+        pDest[i * 2] += pSrc1[i * 2] * gain1 + pSrc2[i * 2] * gain2;
+        pDest[i * 2 + 1] += pSrc1[i * 2 + 1] * gain1 + pSrc2[i * 2 + 1] * gain2;
+    }
+}
+
 // static
 void SampleUtil::add3WithGain(CSAMPLE* pDest,
         const CSAMPLE* M_RESTRICT pSrc1, CSAMPLE_GAIN gain1,
@@ -332,6 +365,10 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        if (SampleUtilSimd::copyWithRampingGain(
+                pDest, pSrc, start_gain, gain_delta, numSamples)) {
+            return;
+        }
         // note: LOOP VECTORIZED only with "int i"
         for (int i = 0; i < numSamples / 2; ++i) {
             const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
@@ -378,6 +415,20 @@ void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
 // static
 SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
         CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
+    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
+    SINT simdClippedL;
+    SINT simdClippedR;
+    if (SampleUtilSimd::sumAbsPerChannel(pfAbsL, pfAbsR,
+            &simdClippedL, &simdClippedR, pBuffer, numSamples)) {
+        if (simdClippedL > 0) {
+            clipping |= SampleUtil::CLIPPING_LEFT;
+        }
+        if (simdClippedR > 0) {
+            clipping |= SampleUtil::CLIPPING_RIGHT;
+        }
+        return clipping;
+    }
+
     CSAMPLE fAbsL = CSAMPLE_ZERO;
     CSAMPLE fAbsR = CSAMPLE_ZERO;
     CSAMPLE clippedL = 0;
@@ -396,7 +447,6 @@ SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
 
     *pfAbsL = fAbsL;
     *pfAbsR = fAbsR;
-    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
     if (clippedL > 0) {
         clipping |= SampleUtil::CLIPPING_LEFT;
     }
@@ -409,6 +459,9 @@ SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
 // static
 void SampleUtil::copyClampBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc, SINT iNumSamples) {
+    if (SampleUtilSimd::copyClampBuffer(pDest, pSrc, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (SINT i = 0; i < iNumSamples; ++i) {
         pDest[i] = clampSample(pSrc[i]);
@@ -420,6 +473,9 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1,
         const CSAMPLE* M_RESTRICT pSrc2,
         SINT numFrames) {
+    if (SampleUtilSimd::interleaveBuffer(pDest, pSrc1, pSrc2, numFrames)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (SINT i = 0; i < numFrames; ++i) {
         pDest[2 * i] = pSrc1[i];
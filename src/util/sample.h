@@ -8,6 +8,7 @@
 
 #include "util/types.h"
 #include "util/platform.h"
+#include "util/samplesimd.h"
 
 // A group of utilities for working with samples.
 class SampleUtil {
@@ -179,6 +180,14 @@ class SampleUtil {
             CSAMPLE_GAIN gain1, const CSAMPLE* pSrc2, CSAMPLE_GAIN gain2,
             SINT numSamples);
 
+    // Add to each sample of pDest, pSrc1 multiplied by a gain ramping from
+    // gain1in to gain1out plus pSrc2 multiplied by a gain ramping from
+    // gain2in to gain2out
+    static void add2WithRampingGain(CSAMPLE* pDest,
+            const CSAMPLE* pSrc1, CSAMPLE_GAIN gain1in, CSAMPLE_GAIN gain1out,
+            const CSAMPLE* pSrc2, CSAMPLE_GAIN gain2in, CSAMPLE_GAIN gain2out,
+            SINT numSamples);
+
     // Add to each sample of pDest, pSrc1 multiplied by gain1 plus pSrc2
     // multiplied by gain2 plus pSrc3 multiplied by gain3
     static void add3WithGain(CSAMPLE* pDest, const CSAMPLE* pSrc1,
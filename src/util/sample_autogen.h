@@ -11,6 +11,11 @@ static inline void copy1WithGain(CSAMPLE* M_RESTRICT pDest,
         clear(pDest, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0};
+    const CSAMPLE_GAIN gains[] = {gain0};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 1, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0;
@@ -25,6 +30,12 @@ static inline void copy1WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     }
     const CSAMPLE_GAIN gain_delta0 = (gain0out - gain0in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain0 = gain0in + gain_delta0;
+    const CSAMPLE* pSrcs[] = {pSrc0};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 1, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -44,6 +55,11 @@ static inline void copy2WithGain(CSAMPLE* M_RESTRICT pDest,
         copy1WithGain(pDest, pSrc0, gain0, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 2, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -66,6 +82,12 @@ static inline void copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain0 = gain0in + gain_delta0;
     const CSAMPLE_GAIN gain_delta1 = (gain1out - gain1in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain1 = gain1in + gain_delta1;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 2, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -93,6 +115,11 @@ static inline void copy3WithGain(CSAMPLE* M_RESTRICT pDest,
         copy2WithGain(pDest, pSrc0, gain0, pSrc1, gain1, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 3, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -123,6 +150,12 @@ static inline void copy3WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain1 = gain1in + gain_delta1;
     const CSAMPLE_GAIN gain_delta2 = (gain2out - gain2in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain2 = gain2in + gain_delta2;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 3, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -158,6 +191,11 @@ static inline void copy4WithGain(CSAMPLE* M_RESTRICT pDest,
         copy3WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 4, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -196,6 +234,12 @@ static inline void copy4WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain2 = gain2in + gain_delta2;
     const CSAMPLE_GAIN gain_delta3 = (gain3out - gain3in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain3 = gain3in + gain_delta3;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 4, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -239,6 +283,11 @@ static inline void copy5WithGain(CSAMPLE* M_RESTRICT pDest,
         copy4WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 5, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -285,6 +334,12 @@ static inline void copy5WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain3 = gain3in + gain_delta3;
     const CSAMPLE_GAIN gain_delta4 = (gain4out - gain4in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain4 = gain4in + gain_delta4;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 5, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -336,6 +391,11 @@ static inline void copy6WithGain(CSAMPLE* M_RESTRICT pDest,
         copy5WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 6, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -390,6 +450,12 @@ static inline void copy6WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain4 = gain4in + gain_delta4;
     const CSAMPLE_GAIN gain_delta5 = (gain5out - gain5in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain5 = gain5in + gain_delta5;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 6, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -449,6 +515,11 @@ static inline void copy7WithGain(CSAMPLE* M_RESTRICT pDest,
         copy6WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 7, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -511,6 +582,12 @@ static inline void copy7WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain5 = gain5in + gain_delta5;
     const CSAMPLE_GAIN gain_delta6 = (gain6out - gain6in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain6 = gain6in + gain_delta6;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 7, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -578,6 +655,11 @@ static inline void copy8WithGain(CSAMPLE* M_RESTRICT pDest,
         copy7WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 8, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -648,6 +730,12 @@ static inline void copy8WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain6 = gain6in + gain_delta6;
     const CSAMPLE_GAIN gain_delta7 = (gain7out - gain7in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain7 = gain7in + gain_delta7;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 8, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -723,6 +811,11 @@ static inline void copy9WithGain(CSAMPLE* M_RESTRICT pDest,
         copy8WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 9, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -801,6 +894,12 @@ static inline void copy9WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain7 = gain7in + gain_delta7;
     const CSAMPLE_GAIN gain_delta8 = (gain8out - gain8in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain8 = gain8in + gain_delta8;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 9, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -884,6 +983,11 @@ static inline void copy10WithGain(CSAMPLE* M_RESTRICT pDest,
         copy9WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 10, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -970,6 +1074,12 @@ static inline void copy10WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain8 = gain8in + gain_delta8;
     const CSAMPLE_GAIN gain_delta9 = (gain9out - gain9in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain9 = gain9in + gain_delta9;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 10, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -1061,6 +1171,11 @@ static inline void copy11WithGain(CSAMPLE* M_RESTRICT pDest,
         copy10WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 11, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -1155,6 +1270,12 @@ static inline void copy11WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain9 = gain9in + gain_delta9;
     const CSAMPLE_GAIN gain_delta10 = (gain10out - gain10in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain10 = gain10in + gain_delta10;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 11, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -1254,6 +1375,11 @@ static inline void copy12WithGain(CSAMPLE* M_RESTRICT pDest,
         copy11WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 12, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -1356,6 +1482,12 @@ static inline void copy12WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain10 = gain10in + gain_delta10;
     const CSAMPLE_GAIN gain_delta11 = (gain11out - gain11in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain11 = gain11in + gain_delta11;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 12, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -1463,6 +1595,11 @@ static inline void copy13WithGain(CSAMPLE* M_RESTRICT pDest,
         copy12WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 13, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -1573,6 +1710,12 @@ static inline void copy13WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain11 = gain11in + gain_delta11;
     const CSAMPLE_GAIN gain_delta12 = (gain12out - gain12in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain12 = gain12in + gain_delta12;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 13, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -1688,6 +1831,11 @@ static inline void copy14WithGain(CSAMPLE* M_RESTRICT pDest,
         copy13WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 14, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -1806,6 +1954,12 @@ static inline void copy14WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain12 = gain12in + gain_delta12;
     const CSAMPLE_GAIN gain_delta13 = (gain13out - gain13in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain13 = gain13in + gain_delta13;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 14, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -1929,6 +2083,11 @@ static inline void copy15WithGain(CSAMPLE* M_RESTRICT pDest,
         copy14WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 15, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -2055,6 +2214,12 @@ static inline void copy15WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain13 = gain13in + gain_delta13;
     const CSAMPLE_GAIN gain_delta14 = (gain14out - gain14in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain14 = gain14in + gain_delta14;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 15, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -2186,6 +2351,11 @@ static inline void copy16WithGain(CSAMPLE* M_RESTRICT pDest,
         copy15WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 16, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -2320,6 +2490,12 @@ static inline void copy16WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain14 = gain14in + gain_delta14;
     const CSAMPLE_GAIN gain_delta15 = (gain15out - gain15in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain15 = gain15in + gain_delta15;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 16, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -2459,6 +2635,11 @@ static inline void copy17WithGain(CSAMPLE* M_RESTRICT pDest,
         copy16WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 17, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -2601,6 +2782,12 @@ static inline void copy17WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain15 = gain15in + gain_delta15;
     const CSAMPLE_GAIN gain_delta16 = (gain16out - gain16in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain16 = gain16in + gain_delta16;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 17, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -2748,6 +2935,11 @@ static inline void copy18WithGain(CSAMPLE* M_RESTRICT pDest,
         copy17WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 18, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -2898,6 +3090,12 @@ static inline void copy18WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain16 = gain16in + gain_delta16;
     const CSAMPLE_GAIN gain_delta17 = (gain17out - gain17in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain17 = gain17in + gain_delta17;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 18, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -3053,6 +3251,11 @@ static inline void copy19WithGain(CSAMPLE* M_RESTRICT pDest,
         copy18WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 19, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -3211,6 +3414,12 @@ static inline void copy19WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain17 = gain17in + gain_delta17;
     const CSAMPLE_GAIN gain_delta18 = (gain18out - gain18in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain18 = gain18in + gain_delta18;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 19, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -3374,6 +3583,11 @@ static inline void copy20WithGain(CSAMPLE* M_RESTRICT pDest,
         copy19WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 20, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -3540,6 +3754,12 @@ static inline void copy20WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain18 = gain18in + gain_delta18;
     const CSAMPLE_GAIN gain_delta19 = (gain19out - gain19in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain19 = gain19in + gain_delta19;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 20, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -3711,6 +3931,11 @@ static inline void copy21WithGain(CSAMPLE* M_RESTRICT pDest,
         copy20WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 21, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -3885,6 +4110,12 @@ static inline void copy21WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain19 = gain19in + gain_delta19;
     const CSAMPLE_GAIN gain_delta20 = (gain20out - gain20in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain20 = gain20in + gain_delta20;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 21, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -4064,6 +4295,11 @@ static inline void copy22WithGain(CSAMPLE* M_RESTRICT pDest,
         copy21WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 22, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -4246,6 +4482,12 @@ static inline void copy22WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain20 = gain20in + gain_delta20;
     const CSAMPLE_GAIN gain_delta21 = (gain21out - gain21in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain21 = gain21in + gain_delta21;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 22, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -4433,6 +4675,11 @@ static inline void copy23WithGain(CSAMPLE* M_RESTRICT pDest,
         copy22WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 23, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -4623,6 +4870,12 @@ static inline void copy23WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain21 = gain21in + gain_delta21;
     const CSAMPLE_GAIN gain_delta22 = (gain22out - gain22in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain22 = gain22in + gain_delta22;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 23, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -4818,6 +5071,11 @@ static inline void copy24WithGain(CSAMPLE* M_RESTRICT pDest,
         copy23WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, pSrc22, gain22, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22, gain23};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 24, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -5016,6 +5274,12 @@ static inline void copy24WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain22 = gain22in + gain_delta22;
     const CSAMPLE_GAIN gain_delta23 = (gain23out - gain23in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain23 = gain23in + gain_delta23;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22, start_gain23};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22, gain_delta23};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 24, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -5219,6 +5483,11 @@ static inline void copy25WithGain(CSAMPLE* M_RESTRICT pDest,
         copy24WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, pSrc22, gain22, pSrc23, gain23, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22, gain23, gain24};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 25, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -5425,6 +5694,12 @@ static inline void copy25WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain23 = gain23in + gain_delta23;
     const CSAMPLE_GAIN gain_delta24 = (gain24out - gain24in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain24 = gain24in + gain_delta24;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22, start_gain23, start_gain24};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22, gain_delta23, gain_delta24};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 25, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -5636,6 +5911,11 @@ static inline void copy26WithGain(CSAMPLE* M_RESTRICT pDest,
         copy25WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, pSrc22, gain22, pSrc23, gain23, pSrc24, gain24, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22, gain23, gain24, gain25};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 26, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -5850,6 +6130,12 @@ static inline void copy26WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain24 = gain24in + gain_delta24;
     const CSAMPLE_GAIN gain_delta25 = (gain25out - gain25in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain25 = gain25in + gain_delta25;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22, start_gain23, start_gain24, start_gain25};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22, gain_delta23, gain_delta24, gain_delta25};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 26, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -6069,6 +6355,11 @@ static inline void copy27WithGain(CSAMPLE* M_RESTRICT pDest,
         copy26WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, pSrc22, gain22, pSrc23, gain23, pSrc24, gain24, pSrc25, gain25, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22, gain23, gain24, gain25, gain26};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 27, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -6291,6 +6582,12 @@ static inline void copy27WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain25 = gain25in + gain_delta25;
     const CSAMPLE_GAIN gain_delta26 = (gain26out - gain26in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain26 = gain26in + gain_delta26;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22, start_gain23, start_gain24, start_gain25, start_gain26};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22, gain_delta23, gain_delta24, gain_delta25, gain_delta26};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 27, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -6518,6 +6815,11 @@ static inline void copy28WithGain(CSAMPLE* M_RESTRICT pDest,
         copy27WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, pSrc22, gain22, pSrc23, gain23, pSrc24, gain24, pSrc25, gain25, pSrc26, gain26, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22, gain23, gain24, gain25, gain26, gain27};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 28, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -6748,6 +7050,12 @@ static inline void copy28WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain26 = gain26in + gain_delta26;
     const CSAMPLE_GAIN gain_delta27 = (gain27out - gain27in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain27 = gain27in + gain_delta27;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22, start_gain23, start_gain24, start_gain25, start_gain26, start_gain27};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22, gain_delta23, gain_delta24, gain_delta25, gain_delta26, gain_delta27};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 28, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -6983,6 +7291,11 @@ static inline void copy29WithGain(CSAMPLE* M_RESTRICT pDest,
         copy28WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, pSrc22, gain22, pSrc23, gain23, pSrc24, gain24, pSrc25, gain25, pSrc26, gain26, pSrc27, gain27, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27, pSrc28};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22, gain23, gain24, gain25, gain26, gain27, gain28};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 29, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -7221,6 +7534,12 @@ static inline void copy29WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain27 = gain27in + gain_delta27;
     const CSAMPLE_GAIN gain_delta28 = (gain28out - gain28in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain28 = gain28in + gain_delta28;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27, pSrc28};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22, start_gain23, start_gain24, start_gain25, start_gain26, start_gain27, start_gain28};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22, gain_delta23, gain_delta24, gain_delta25, gain_delta26, gain_delta27, gain_delta28};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 29, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -7464,6 +7783,11 @@ static inline void copy30WithGain(CSAMPLE* M_RESTRICT pDest,
         copy29WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, pSrc22, gain22, pSrc23, gain23, pSrc24, gain24, pSrc25, gain25, pSrc26, gain26, pSrc27, gain27, pSrc28, gain28, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27, pSrc28, pSrc29};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22, gain23, gain24, gain25, gain26, gain27, gain28, gain29};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 30, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -7710,6 +8034,12 @@ static inline void copy30WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain28 = gain28in + gain_delta28;
     const CSAMPLE_GAIN gain_delta29 = (gain29out - gain29in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain29 = gain29in + gain_delta29;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27, pSrc28, pSrc29};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22, start_gain23, start_gain24, start_gain25, start_gain26, start_gain27, start_gain28, start_gain29};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22, gain_delta23, gain_delta24, gain_delta25, gain_delta26, gain_delta27, gain_delta28, gain_delta29};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 30, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -7961,6 +8291,11 @@ static inline void copy31WithGain(CSAMPLE* M_RESTRICT pDest,
         copy30WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, pSrc22, gain22, pSrc23, gain23, pSrc24, gain24, pSrc25, gain25, pSrc26, gain26, pSrc27, gain27, pSrc28, gain28, pSrc29, gain29, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27, pSrc28, pSrc29, pSrc30};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22, gain23, gain24, gain25, gain26, gain27, gain28, gain29, gain30};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 31, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -8215,6 +8550,12 @@ static inline void copy31WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain29 = gain29in + gain_delta29;
     const CSAMPLE_GAIN gain_delta30 = (gain30out - gain30in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain30 = gain30in + gain_delta30;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27, pSrc28, pSrc29, pSrc30};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22, start_gain23, start_gain24, start_gain25, start_gain26, start_gain27, start_gain28, start_gain29, start_gain30};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22, gain_delta23, gain_delta24, gain_delta25, gain_delta26, gain_delta27, gain_delta28, gain_delta29, gain_delta30};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 31, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -8474,6 +8815,11 @@ static inline void copy32WithGain(CSAMPLE* M_RESTRICT pDest,
         copy31WithGain(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, pSrc4, gain4, pSrc5, gain5, pSrc6, gain6, pSrc7, gain7, pSrc8, gain8, pSrc9, gain9, pSrc10, gain10, pSrc11, gain11, pSrc12, gain12, pSrc13, gain13, pSrc14, gain14, pSrc15, gain15, pSrc16, gain16, pSrc17, gain17, pSrc18, gain18, pSrc19, gain19, pSrc20, gain20, pSrc21, gain21, pSrc22, gain22, pSrc23, gain23, pSrc24, gain24, pSrc25, gain25, pSrc26, gain26, pSrc27, gain27, pSrc28, gain28, pSrc29, gain29, pSrc30, gain30, iNumSamples);
         return;
     }
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27, pSrc28, pSrc29, pSrc30, pSrc31};
+    const CSAMPLE_GAIN gains[] = {gain0, gain1, gain2, gain3, gain4, gain5, gain6, gain7, gain8, gain9, gain10, gain11, gain12, gain13, gain14, gain15, gain16, gain17, gain18, gain19, gain20, gain21, gain22, gain23, gain24, gain25, gain26, gain27, gain28, gain29, gain30, gain31};
+    if (SampleUtilSimd::copyNWithGain(pDest, pSrcs, gains, 32, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples; ++i) {
         pDest[i] = pSrc0[i] * gain0 +
@@ -8736,6 +9082,12 @@ static inline void copy32WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain30 = gain30in + gain_delta30;
     const CSAMPLE_GAIN gain_delta31 = (gain31out - gain31in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain31 = gain31in + gain_delta31;
+    const CSAMPLE* pSrcs[] = {pSrc0, pSrc1, pSrc2, pSrc3, pSrc4, pSrc5, pSrc6, pSrc7, pSrc8, pSrc9, pSrc10, pSrc11, pSrc12, pSrc13, pSrc14, pSrc15, pSrc16, pSrc17, pSrc18, pSrc19, pSrc20, pSrc21, pSrc22, pSrc23, pSrc24, pSrc25, pSrc26, pSrc27, pSrc28, pSrc29, pSrc30, pSrc31};
+    const CSAMPLE_GAIN start_gains[] = {start_gain0, start_gain1, start_gain2, start_gain3, start_gain4, start_gain5, start_gain6, start_gain7, start_gain8, start_gain9, start_gain10, start_gain11, start_gain12, start_gain13, start_gain14, start_gain15, start_gain16, start_gain17, start_gain18, start_gain19, start_gain20, start_gain21, start_gain22, start_gain23, start_gain24, start_gain25, start_gain26, start_gain27, start_gain28, start_gain29, start_gain30, start_gain31};
+    const CSAMPLE_GAIN gain_deltas[] = {gain_delta0, gain_delta1, gain_delta2, gain_delta3, gain_delta4, gain_delta5, gain_delta6, gain_delta7, gain_delta8, gain_delta9, gain_delta10, gain_delta11, gain_delta12, gain_delta13, gain_delta14, gain_delta15, gain_delta16, gain_delta17, gain_delta18, gain_delta19, gain_delta20, gain_delta21, gain_delta22, gain_delta23, gain_delta24, gain_delta25, gain_delta26, gain_delta27, gain_delta28, gain_delta29, gain_delta30, gain_delta31};
+    if (SampleUtilSimd::copyNWithRampingGain(pDest, pSrcs, start_gains, gain_deltas, 32, iNumSamples)) {
+        return;
+    }
     // note: LOOP VECTORIZED.
     for (int i = 0; i < iNumSamples / 2; ++i) {
         const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
@@ -0,0 +1,613 @@
+#include <cmath>
+
+#include "util/samplesimd.h"
+#include "util/platform.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MIXXX_SAMPLESIMD_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+// NEON is only used if the build target guarantees its availability,
+// i.e. always on AArch64 and on ARMv7 if compiled with -mfpu=neon.
+#define MIXXX_SAMPLESIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// The AVX2 kernels are compiled for AVX2 independent of the build target
+// and must only be called after checking that the CPU supports AVX2. MSVC
+// does not need any special flags for using AVX2 intrinsics.
+#if defined(__GNUC__)
+#define M_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define M_TARGET_AVX2
+#endif
+
+namespace {
+
+struct Kernels {
+    void (*copyWithRampingGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+            SINT numSamples);
+    void (*addWithRampingGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+            SINT numSamples);
+    void (*copyNWithGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* const* pSrc, const CSAMPLE_GAIN* gain,
+            int numSources, int numSamples);
+    void (*copyNWithRampingGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* const* pSrc,
+            const CSAMPLE_GAIN* startGain, const CSAMPLE_GAIN* gainDelta,
+            int numSources, int numSamples);
+    void (*sumAbsPerChannel)(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+            SINT* pClippedL, SINT* pClippedR,
+            const CSAMPLE* pBuffer, SINT numSamples);
+    void (*copyClampBuffer)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc, SINT numSamples);
+    void (*interleaveBuffer)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1, const CSAMPLE* M_RESTRICT pSrc2,
+            SINT numFrames);
+};
+
+// The scalar remainders of all kernels use exactly the same
+// calculations as the scalar implementations in SampleUtil.
+
+inline void copyNWithGainScalar(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc, const CSAMPLE_GAIN* gain,
+        int numSources, int start, int end) {
+    for (int i = start; i < end; ++i) {
+        CSAMPLE sum = pSrc[0][i] * gain[0];
+        for (int k = 1; k < numSources; ++k) {
+            sum += pSrc[k][i] * gain[k];
+        }
+        pDest[i] = sum;
+    }
+}
+
+inline void copyNWithRampingGainScalar(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        const CSAMPLE_GAIN* startGain, const CSAMPLE_GAIN* gainDelta,
+        int numSources, int startFrame, int endFrame) {
+    for (int i = startFrame; i < endFrame; ++i) {
+        const CSAMPLE_GAIN gain0 = startGain[0] + gainDelta[0] * i;
+        CSAMPLE sumL = pSrc[0][i * 2] * gain0;
+        CSAMPLE sumR = pSrc[0][i * 2 + 1] * gain0;
+        for (int k = 1; k < numSources; ++k) {
+            const CSAMPLE_GAIN gain = startGain[k] + gainDelta[k] * i;
+            sumL += pSrc[k][i * 2] * gain;
+            sumR += pSrc[k][i * 2 + 1] * gain;
+        }
+        pDest[i * 2] = sumL;
+        pDest[i * 2 + 1] = sumR;
+    }
+}
+
+#ifdef MIXXX_SAMPLESIMD_AVX2
+
+bool cpuSupportsAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // The OS must save the AVX registers on context switches
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || ((_xgetbv(0) & 0x6) != 0x6)) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__)
+    // Might be invoked during static initialization
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+// Each 256-bit register holds 4 stereo frames
+M_TARGET_AVX2
+inline __m256 avx2FrameIndices() {
+    return _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+}
+
+M_TARGET_AVX2
+void avx2CopyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+        SINT numSamples) {
+    const int numFrames = static_cast<int>(numSamples / 2);
+    const int numVectorFrames = numFrames & ~3;
+    const __m256 vStartGain = _mm256_set1_ps(startGain);
+    const __m256 vGainDelta = _mm256_set1_ps(gainDelta);
+    const __m256 vFrameStep = _mm256_set1_ps(4.0f);
+    __m256 vFrameIndex = avx2FrameIndices();
+    for (int i = 0; i < numVectorFrames; i += 4) {
+        const __m256 vGain = _mm256_add_ps(vStartGain,
+                _mm256_mul_ps(vGainDelta, vFrameIndex));
+        _mm256_storeu_ps(pDest + i * 2,
+                _mm256_mul_ps(_mm256_loadu_ps(pSrc + i * 2), vGain));
+        vFrameIndex = _mm256_add_ps(vFrameIndex, vFrameStep);
+    }
+    for (int i = numVectorFrames; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+M_TARGET_AVX2
+void avx2AddWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+        SINT numSamples) {
+    const int numFrames = static_cast<int>(numSamples / 2);
+    const int numVectorFrames = numFrames & ~3;
+    const __m256 vStartGain = _mm256_set1_ps(startGain);
+    const __m256 vGainDelta = _mm256_set1_ps(gainDelta);
+    const __m256 vFrameStep = _mm256_set1_ps(4.0f);
+    __m256 vFrameIndex = avx2FrameIndices();
+    for (int i = 0; i < numVectorFrames; i += 4) {
+        const __m256 vGain = _mm256_add_ps(vStartGain,
+                _mm256_mul_ps(vGainDelta, vFrameIndex));
+        _mm256_storeu_ps(pDest + i * 2,
+                _mm256_add_ps(_mm256_loadu_ps(pDest + i * 2),
+                        _mm256_mul_ps(_mm256_loadu_ps(pSrc + i * 2), vGain)));
+        vFrameIndex = _mm256_add_ps(vFrameIndex, vFrameStep);
+    }
+    for (int i = numVectorFrames; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+M_TARGET_AVX2
+void avx2CopyNWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc, const CSAMPLE_GAIN* gain,
+        int numSources, int numSamples) {
+    const int numVectorSamples = numSamples & ~7;
+    for (int i = 0; i < numVectorSamples; i += 8) {
+        __m256 vSum = _mm256_mul_ps(
+                _mm256_loadu_ps(pSrc[0] + i), _mm256_set1_ps(gain[0]));
+        for (int k = 1; k < numSources; ++k) {
+            vSum = _mm256_add_ps(vSum, _mm256_mul_ps(
+                    _mm256_loadu_ps(pSrc[k] + i), _mm256_set1_ps(gain[k])));
+        }
+        _mm256_storeu_ps(pDest + i, vSum);
+    }
+    copyNWithGainScalar(pDest, pSrc, gain, numSources,
+            numVectorSamples, numSamples);
+}
+
+M_TARGET_AVX2
+void avx2CopyNWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        const CSAMPLE_GAIN* startGain, const CSAMPLE_GAIN* gainDelta,
+        int numSources, int numSamples) {
+    const int numFrames = numSamples / 2;
+    const int numVectorFrames = numFrames & ~3;
+    const __m256 vFrameStep = _mm256_set1_ps(4.0f);
+    __m256 vFrameIndex = avx2FrameIndices();
+    for (int i = 0; i < numVectorFrames; i += 4) {
+        __m256 vGain = _mm256_add_ps(_mm256_set1_ps(startGain[0]),
+                _mm256_mul_ps(_mm256_set1_ps(gainDelta[0]), vFrameIndex));
+        __m256 vSum = _mm256_mul_ps(_mm256_loadu_ps(pSrc[0] + i * 2), vGain);
+        for (int k = 1; k < numSources; ++k) {
+            vGain = _mm256_add_ps(_mm256_set1_ps(startGain[k]),
+                    _mm256_mul_ps(_mm256_set1_ps(gainDelta[k]), vFrameIndex));
+            vSum = _mm256_add_ps(vSum,
+                    _mm256_mul_ps(_mm256_loadu_ps(pSrc[k] + i * 2), vGain));
+        }
+        _mm256_storeu_ps(pDest + i * 2, vSum);
+        vFrameIndex = _mm256_add_ps(vFrameIndex, vFrameStep);
+    }
+    copyNWithRampingGainScalar(pDest, pSrc, startGain, gainDelta,
+            numSources, numVectorFrames, numFrames);
+}
+
+M_TARGET_AVX2
+void avx2SumAbsPerChannel(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+        SINT* pClippedL, SINT* pClippedR,
+        const CSAMPLE* pBuffer, SINT numSamples) {
+    const SINT numFrames = numSamples / 2;
+    const SINT numVectorFrames = numFrames & ~3;
+    const __m256 vAbsMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 vPeak = _mm256_set1_ps(CSAMPLE_PEAK);
+    __m256 vSum = _mm256_setzero_ps();
+    __m256i vClipped = _mm256_setzero_si256();
+    for (SINT i = 0; i < numVectorFrames; i += 4) {
+        const __m256 vAbs = _mm256_and_ps(vAbsMask, _mm256_loadu_ps(pBuffer + i * 2));
+        vSum = _mm256_add_ps(vSum, vAbs);
+        // The comparison yields -1 for each clipped sample
+        vClipped = _mm256_sub_epi32(vClipped, _mm256_castps_si256(
+                _mm256_cmp_ps(vAbs, vPeak, _CMP_GT_OQ)));
+    }
+    float sums[8];
+    int clipped[8];
+    _mm256_storeu_ps(sums, vSum);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(clipped), vClipped);
+    CSAMPLE fAbsL = sums[0] + sums[2] + sums[4] + sums[6];
+    CSAMPLE fAbsR = sums[1] + sums[3] + sums[5] + sums[7];
+    SINT clippedL = clipped[0] + clipped[2] + clipped[4] + clipped[6];
+    SINT clippedR = clipped[1] + clipped[3] + clipped[5] + clipped[7];
+    for (SINT i = numVectorFrames; i < numFrames; ++i) {
+        const CSAMPLE absl = fabs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        const CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    *pClippedL = clippedL;
+    *pClippedR = clippedR;
+}
+
+M_TARGET_AVX2
+void avx2CopyClampBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc, SINT numSamples) {
+    const SINT numVectorSamples = numSamples & ~7;
+    const __m256 vMax = _mm256_set1_ps(CSAMPLE_PEAK);
+    const __m256 vMin = _mm256_set1_ps(-CSAMPLE_PEAK);
+    for (SINT i = 0; i < numVectorSamples; i += 8) {
+        _mm256_storeu_ps(pDest + i, _mm256_max_ps(vMin,
+                _mm256_min_ps(_mm256_loadu_ps(pSrc + i), vMax)));
+    }
+    for (SINT i = numVectorSamples; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE_clamp(pSrc[i]);
+    }
+}
+
+M_TARGET_AVX2
+void avx2InterleaveBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1, const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    const SINT numVectorFrames = numFrames & ~7;
+    for (SINT i = 0; i < numVectorFrames; i += 8) {
+        const __m256 vSrc1 = _mm256_loadu_ps(pSrc1 + i);
+        const __m256 vSrc2 = _mm256_loadu_ps(pSrc2 + i);
+        // The unpack instructions operate on 128-bit lanes:
+        // vLow = [a0 b0 a1 b1 | a4 b4 a5 b5]
+        // vHigh = [a2 b2 a3 b3 | a6 b6 a7 b7]
+        const __m256 vLow = _mm256_unpacklo_ps(vSrc1, vSrc2);
+        const __m256 vHigh = _mm256_unpackhi_ps(vSrc1, vSrc2);
+        _mm256_storeu_ps(pDest + i * 2,
+                _mm256_permute2f128_ps(vLow, vHigh, 0x20));
+        _mm256_storeu_ps(pDest + i * 2 + 8,
+                _mm256_permute2f128_ps(vLow, vHigh, 0x31));
+    }
+    for (SINT i = numVectorFrames; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+const Kernels kAvx2Kernels = {
+    avx2CopyWithRampingGain,
+    avx2AddWithRampingGain,
+    avx2CopyNWithGain,
+    avx2CopyNWithRampingGain,
+    avx2SumAbsPerChannel,
+    avx2CopyClampBuffer,
+    avx2InterleaveBuffer,
+};
+
+#endif // MIXXX_SAMPLESIMD_AVX2
+
+#ifdef MIXXX_SAMPLESIMD_NEON
+
+// Each 128-bit register holds 2 stereo frames
+inline float32x4_t neonFrameIndices() {
+    const float indices[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+    return vld1q_f32(indices);
+}
+
+void neonCopyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+        SINT numSamples) {
+    const int numFrames = static_cast<int>(numSamples / 2);
+    const int numVectorFrames = numFrames & ~1;
+    const float32x4_t vStartGain = vdupq_n_f32(startGain);
+    const float32x4_t vGainDelta = vdupq_n_f32(gainDelta);
+    const float32x4_t vFrameStep = vdupq_n_f32(2.0f);
+    float32x4_t vFrameIndex = neonFrameIndices();
+    for (int i = 0; i < numVectorFrames; i += 2) {
+        const float32x4_t vGain = vaddq_f32(vStartGain,
+                vmulq_f32(vGainDelta, vFrameIndex));
+        vst1q_f32(pDest + i * 2, vmulq_f32(vld1q_f32(pSrc + i * 2), vGain));
+        vFrameIndex = vaddq_f32(vFrameIndex, vFrameStep);
+    }
+    for (int i = numVectorFrames; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void neonAddWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+        SINT numSamples) {
+    const int numFrames = static_cast<int>(numSamples / 2);
+    const int numVectorFrames = numFrames & ~1;
+    const float32x4_t vStartGain = vdupq_n_f32(startGain);
+    const float32x4_t vGainDelta = vdupq_n_f32(gainDelta);
+    const float32x4_t vFrameStep = vdupq_n_f32(2.0f);
+    float32x4_t vFrameIndex = neonFrameIndices();
+    for (int i = 0; i < numVectorFrames; i += 2) {
+        const float32x4_t vGain = vaddq_f32(vStartGain,
+                vmulq_f32(vGainDelta, vFrameIndex));
+        vst1q_f32(pDest + i * 2, vaddq_f32(vld1q_f32(pDest + i * 2),
+                vmulq_f32(vld1q_f32(pSrc + i * 2), vGain)));
+        vFrameIndex = vaddq_f32(vFrameIndex, vFrameStep);
+    }
+    for (int i = numVectorFrames; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void neonCopyNWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc, const CSAMPLE_GAIN* gain,
+        int numSources, int numSamples) {
+    const int numVectorSamples = numSamples & ~3;
+    for (int i = 0; i < numVectorSamples; i += 4) {
+        float32x4_t vSum = vmulq_f32(vld1q_f32(pSrc[0] + i), vdupq_n_f32(gain[0]));
+        for (int k = 1; k < numSources; ++k) {
+            vSum = vaddq_f32(vSum,
+                    vmulq_f32(vld1q_f32(pSrc[k] + i), vdupq_n_f32(gain[k])));
+        }
+        vst1q_f32(pDest + i, vSum);
+    }
+    copyNWithGainScalar(pDest, pSrc, gain, numSources,
+            numVectorSamples, numSamples);
+}
+
+void neonCopyNWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* const* pSrc,
+        const CSAMPLE_GAIN* startGain, const CSAMPLE_GAIN* gainDelta,
+        int numSources, int numSamples) {
+    const int numFrames = numSamples / 2;
+    const int numVectorFrames = numFrames & ~1;
+    const float32x4_t vFrameStep = vdupq_n_f32(2.0f);
+    float32x4_t vFrameIndex = neonFrameIndices();
+    for (int i = 0; i < numVectorFrames; i += 2) {
+        float32x4_t vGain = vaddq_f32(vdupq_n_f32(startGain[0]),
+                vmulq_f32(vdupq_n_f32(gainDelta[0]), vFrameIndex));
+        float32x4_t vSum = vmulq_f32(vld1q_f32(pSrc[0] + i * 2), vGain);
+        for (int k = 1; k < numSources; ++k) {
+            vGain = vaddq_f32(vdupq_n_f32(startGain[k]),
+                    vmulq_f32(vdupq_n_f32(gainDelta[k]), vFrameIndex));
+            vSum = vaddq_f32(vSum, vmulq_f32(vld1q_f32(pSrc[k] + i * 2), vGain));
+        }
+        vst1q_f32(pDest + i * 2, vSum);
+        vFrameIndex = vaddq_f32(vFrameIndex, vFrameStep);
+    }
+    copyNWithRampingGainScalar(pDest, pSrc, startGain, gainDelta,
+            numSources, numVectorFrames, numFrames);
+}
+
+void neonSumAbsPerChannel(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+        SINT* pClippedL, SINT* pClippedR,
+        const CSAMPLE* pBuffer, SINT numSamples) {
+    const SINT numFrames = numSamples / 2;
+    const SINT numVectorFrames = numFrames & ~1;
+    const float32x4_t vPeak = vdupq_n_f32(CSAMPLE_PEAK);
+    float32x4_t vSum = vdupq_n_f32(0.0f);
+    uint32x4_t vClipped = vdupq_n_u32(0);
+    for (SINT i = 0; i < numVectorFrames; i += 2) {
+        const float32x4_t vAbs = vabsq_f32(vld1q_f32(pBuffer + i * 2));
+        vSum = vaddq_f32(vSum, vAbs);
+        // The comparison yields all bits set, i.e. -1, for each clipped sample
+        vClipped = vsubq_u32(vClipped, vcgtq_f32(vAbs, vPeak));
+    }
+    float sums[4];
+    uint32_t clipped[4];
+    vst1q_f32(sums, vSum);
+    vst1q_u32(clipped, vClipped);
+    CSAMPLE fAbsL = sums[0] + sums[2];
+    CSAMPLE fAbsR = sums[1] + sums[3];
+    SINT clippedL = clipped[0] + clipped[2];
+    SINT clippedR = clipped[1] + clipped[3];
+    for (SINT i = numVectorFrames; i < numFrames; ++i) {
+        const CSAMPLE absl = fabs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        const CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    *pClippedL = clippedL;
+    *pClippedR = clippedR;
+}
+
+void neonCopyClampBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc, SINT numSamples) {
+    const SINT numVectorSamples = numSamples & ~3;
+    const float32x4_t vMax = vdupq_n_f32(CSAMPLE_PEAK);
+    const float32x4_t vMin = vdupq_n_f32(-CSAMPLE_PEAK);
+    for (SINT i = 0; i < numVectorSamples; i += 4) {
+        vst1q_f32(pDest + i, vmaxq_f32(vMin, vminq_f32(vld1q_f32(pSrc + i), vMax)));
+    }
+    for (SINT i = numVectorSamples; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE_clamp(pSrc[i]);
+    }
+}
+
+void neonInterleaveBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1, const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    const SINT numVectorFrames = numFrames & ~3;
+    for (SINT i = 0; i < numVectorFrames; i += 4) {
+        float32x4x2_t vFrames;
+        vFrames.val[0] = vld1q_f32(pSrc1 + i);
+        vFrames.val[1] = vld1q_f32(pSrc2 + i);
+        vst2q_f32(pDest + i * 2, vFrames);
+    }
+    for (SINT i = numVectorFrames; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+const Kernels kNeonKernels = {
+    neonCopyWithRampingGain,
+    neonAddWithRampingGain,
+    neonCopyNWithGain,
+    neonCopyNWithRampingGain,
+    neonSumAbsPerChannel,
+    neonCopyClampBuffer,
+    neonInterleaveBuffer,
+};
+
+#endif // MIXXX_SAMPLESIMD_NEON
+
+SampleUtilSimd::InstructionSet detectInstructionSet() {
+#if defined(MIXXX_SAMPLESIMD_AVX2)
+    if (cpuSupportsAvx2()) {
+        return SampleUtilSimd::InstructionSet::AVX2;
+    }
+#elif defined(MIXXX_SAMPLESIMD_NEON)
+    return SampleUtilSimd::InstructionSet::NEON;
+#endif
+    return SampleUtilSimd::InstructionSet::NONE;
+}
+
+const Kernels* kernelsForInstructionSet(SampleUtilSimd::InstructionSet instructionSet) {
+    switch (instructionSet) {
+#if defined(MIXXX_SAMPLESIMD_AVX2)
+    case SampleUtilSimd::InstructionSet::AVX2:
+        return &kAvx2Kernels;
+#endif
+#if defined(MIXXX_SAMPLESIMD_NEON)
+    case SampleUtilSimd::InstructionSet::NEON:
+        return &kNeonKernels;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+// The CPU is only probed once during static initialization. Until then
+// all kernels report to be unavailable and the scalar code is used.
+const SampleUtilSimd::InstructionSet s_detectedInstructionSet =
+        detectInstructionSet();
+const Kernels* s_pKernels =
+        kernelsForInstructionSet(s_detectedInstructionSet);
+
+} // anonymous namespace
+
+// static
+SampleUtilSimd::InstructionSet SampleUtilSimd::instructionSet() {
+    return s_pKernels ? s_detectedInstructionSet : InstructionSet::NONE;
+}
+
+// static
+const char* SampleUtilSimd::instructionSetName() {
+    switch (instructionSet()) {
+    case InstructionSet::AVX2:
+        return "AVX2";
+    case InstructionSet::NEON:
+        return "NEON";
+    default:
+        return "none";
+    }
+}
+
+// static
+void SampleUtilSimd::setEnabled(bool enabled) {
+    s_pKernels = enabled ?
+            kernelsForInstructionSet(s_detectedInstructionSet) : nullptr;
+}
+
+// static
+bool SampleUtilSimd::copyWithRampingGain(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+        SINT numSamples) {
+    if (!s_pKernels) {
+        return false;
+    }
+    s_pKernels->copyWithRampingGain(pDest, pSrc, startGain, gainDelta, numSamples);
+    return true;
+}
+
+// static
+bool SampleUtilSimd::addWithRampingGain(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+        SINT numSamples) {
+    if (!s_pKernels) {
+        return false;
+    }
+    s_pKernels->addWithRampingGain(pDest, pSrc, startGain, gainDelta, numSamples);
+    return true;
+}
+
+// static
+bool SampleUtilSimd::copyNWithGain(CSAMPLE* pDest,
+        const CSAMPLE* const* pSrc, const CSAMPLE_GAIN* gain,
+        int numSources, int numSamples) {
+    if (!s_pKernels) {
+        return false;
+    }
+    s_pKernels->copyNWithGain(pDest, pSrc, gain, numSources, numSamples);
+    return true;
+}
+
+// static
+bool SampleUtilSimd::copyNWithRampingGain(CSAMPLE* pDest,
+        const CSAMPLE* const* pSrc,
+        const CSAMPLE_GAIN* startGain, const CSAMPLE_GAIN* gainDelta,
+        int numSources, int numSamples) {
+    if (!s_pKernels) {
+        return false;
+    }
+    s_pKernels->copyNWithRampingGain(pDest, pSrc, startGain, gainDelta,
+            numSources, numSamples);
+    return true;
+}
+
+// static
+bool SampleUtilSimd::sumAbsPerChannel(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+        SINT* pClippedL, SINT* pClippedR,
+        const CSAMPLE* pBuffer, SINT numSamples) {
+    if (!s_pKernels) {
+        return false;
+    }
+    s_pKernels->sumAbsPerChannel(pfAbsL, pfAbsR, pClippedL, pClippedR,
+            pBuffer, numSamples);
+    return true;
+}
+
+// static
+bool SampleUtilSimd::copyClampBuffer(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        SINT numSamples) {
+    if (!s_pKernels) {
+        return false;
+    }
+    s_pKernels->copyClampBuffer(pDest, pSrc, numSamples);
+    return true;
+}
+
+// static
+bool SampleUtilSimd::interleaveBuffer(CSAMPLE* pDest, const CSAMPLE* pSrc1,
+        const CSAMPLE* pSrc2, SINT numFrames) {
+    if (!s_pKernels) {
+        return false;
+    }
+    s_pKernels->interleaveBuffer(pDest, pSrc1, pSrc2, numFrames);
+    return true;
+}
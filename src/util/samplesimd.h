@@ -0,0 +1,72 @@
+#ifndef MIXXX_UTIL_SAMPLESIMD_H
+#define MIXXX_UTIL_SAMPLESIMD_H
+
+#include "util/types.h"
+
+// Explicit SIMD implementations of the hot SampleUtil kernels.
+//
+// Most SampleUtil functions rely on auto-vectorization by the compiler,
+// which is limited to the instruction set of the build target (SSE2 for
+// portable x86 builds). The kernels in this class are compiled for AVX2 on
+// x86 and selected at runtime if the CPU supports it. On ARM the NEON
+// kernels are used when compiling for a target with NEON support.
+//
+// All kernels return false if no SIMD implementation is available and the
+// caller has to fall back to the scalar implementation. The kernels produce
+// the same results as the scalar code up to rounding errors. Those occur if
+// the compiler fuses multiplications and additions of the scalar code for
+// the build target or due to a different order of additions in sums over
+// many samples like sumAbsPerChannel().
+class SampleUtilSimd {
+  public:
+    enum class InstructionSet {
+        NONE,
+        AVX2,
+        NEON,
+    };
+
+    // The instruction set that is used for all kernels
+    static InstructionSet instructionSet();
+    static const char* instructionSetName();
+
+    // Enables or disables all SIMD kernels, e.g. to compare the results
+    // and performance with the scalar fallback in tests and benchmarks.
+    // Not thread-safe and must not be used in production code!
+    static void setEnabled(bool enabled);
+
+    static bool copyWithRampingGain(CSAMPLE* pDest, const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+            SINT numSamples);
+
+    static bool addWithRampingGain(CSAMPLE* pDest, const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta,
+            SINT numSamples);
+
+    // Generic version of the generated SampleUtil::copyNWithGain()
+    // functions for numSources sources.
+    static bool copyNWithGain(CSAMPLE* pDest,
+            const CSAMPLE* const* pSrc, const CSAMPLE_GAIN* gain,
+            int numSources, int numSamples);
+
+    // Generic version of the generated SampleUtil::copyNWithRampingGain()
+    // functions for numSources sources. The gain of each stereo frame is
+    // startGain + gainDelta * frameIndex.
+    static bool copyNWithRampingGain(CSAMPLE* pDest,
+            const CSAMPLE* const* pSrc,
+            const CSAMPLE_GAIN* startGain, const CSAMPLE_GAIN* gainDelta,
+            int numSources, int numSamples);
+
+    // Returns the clipped sample counts of both channels in
+    // pClippedL and pClippedR.
+    static bool sumAbsPerChannel(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+            SINT* pClippedL, SINT* pClippedR,
+            const CSAMPLE* pBuffer, SINT numSamples);
+
+    static bool copyClampBuffer(CSAMPLE* pDest, const CSAMPLE* pSrc,
+            SINT numSamples);
+
+    static bool interleaveBuffer(CSAMPLE* pDest, const CSAMPLE* pSrc1,
+            const CSAMPLE* pSrc2, SINT numFrames);
+};
+
+#endif /* MIXXX_UTIL_SAMPLESIMD_H */
@@ -0,0 +1,123 @@
+#include "util/statid.h"
+
+#include <atomic>
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "util/assert.h"
+#include "util/statsmanager.h"
+
+namespace {
+
+// Stats are registered in static variables, i.e. the number of
+// distinct keys is bounded by the code.
+const int kMaxStatIds = 1024;
+
+class StatIdRegistry {
+  public:
+    StatIdRegistry()
+            : m_count(0) {
+    }
+
+    int registerStat(const char* key,
+            Stat::StatType type,
+            Stat::ComputeFlags compute) {
+        const QString strKey = QString::fromUtf8(key);
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_ids.constFind(strKey);
+        if (it != m_ids.constEnd()) {
+            DEBUG_ASSERT(m_infos[it.value()].type == type);
+            return it.value();
+        }
+        const int id = m_count.load();
+        VERIFY_OR_DEBUG_ASSERT(id < kMaxStatIds) {
+            qWarning() << "Too many stat ids, ignoring" << strKey;
+            return -1;
+        }
+        StatId::Info& info = m_infos[id];
+        info.key = strKey;
+        info.metricName = StatId::metricNameForKey(strKey);
+        info.type = type;
+        info.compute = compute;
+        m_ids.insert(strKey, id);
+        // Publishes the info for readers that don't lock the mutex
+        m_count.store(id + 1);
+        return id;
+    }
+
+    int count() const {
+        return m_count.load();
+    }
+
+    const StatId::Info& info(int id) const {
+        DEBUG_ASSERT(id >= 0 && id < count());
+        return m_infos[id];
+    }
+
+  private:
+    std::atomic<int> m_count;
+    QMutex m_mutex;
+    QHash<QString, int> m_ids;
+    StatId::Info m_infos[kMaxStatIds];
+};
+
+StatIdRegistry& registry() {
+    static StatIdRegistry s_registry;
+    return s_registry;
+}
+
+} // anonymous namespace
+
+// static
+const Stat::ComputeFlags StatId::kDefaultComputeFlags;
+
+StatId::StatId(const char* key,
+        Stat::StatType type,
+        Stat::ComputeFlags compute)
+        : m_id(registry().registerStat(key, type, compute)) {
+}
+
+void StatId::report(double value) const {
+    if (m_id < 0 || !StatsManager::s_bStatIdsEnabled.load()) {
+        return;
+    }
+    StatIdReport report;
+    report.id = m_id;
+    report.value = value;
+    StatsManager::instance()->maybeWriteReport(report);
+}
+
+// static
+int StatId::registeredCount() {
+    return registry().count();
+}
+
+// static
+const StatId::Info& StatId::info(int id) {
+    return registry().info(id);
+}
+
+// static
+QString StatId::metricNameForKey(const QString& key) {
+    QString name("mixxx_");
+    bool separator = true;
+    for (const QChar ch : key) {
+        if ((ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9')) {
+            name += ch;
+            separator = false;
+        } else if (ch >= 'A' && ch <= 'Z') {
+            name += ch.toLower();
+            separator = false;
+        } else if (!separator) {
+            // Collapse all other characters into a single underscore
+            name += '_';
+            separator = true;
+        }
+    }
+    if (name.endsWith('_')) {
+        name.chop(1);
+    }
+    return name;
+}
@@ -0,0 +1,74 @@
+#ifndef STATID_H
+#define STATID_H
+
+#include <QString>
+
+#include "util/stat.h"
+
+// Identifies a stat by an integer instead of a string tag. Each key is
+// registered once at namespace scope or in a constructor, i.e. before
+// the audio callback starts:
+//
+//   namespace {
+//   const StatId kProcessStatId("EngineMaster::process",
+//           Stat::DURATION_NANOSEC);
+//   } // anonymous namespace
+//   ...
+//   kProcessStatId.report(value);
+//
+// Don't use function-local statics in real-time code: their first use
+// registers the key under a mutex and every use checks a guard variable.
+//
+// Reporting neither allocates memory nor formats any strings. The value
+// is written into a lock-free pipe of the calling thread that is drained
+// periodically by the StatsManager. This makes it suitable for always-on
+// instrumentation of the audio callback.
+class StatId {
+  public:
+    static const Stat::ComputeFlags kDefaultComputeFlags =
+            Stat::COUNT | Stat::SUM | Stat::AVERAGE | Stat::MIN | Stat::MAX;
+
+    // The registration is thread-safe. Registering the same key again
+    // returns the id of the existing stat.
+    StatId(const char* key,
+            Stat::StatType type,
+            Stat::ComputeFlags compute = kDefaultComputeFlags);
+
+    int value() const {
+        return m_id;
+    }
+
+    bool isValid() const {
+        return m_id >= 0;
+    }
+
+    // Silently dropped if no StatsManager is running or the pipe of
+    // the calling thread is full.
+    void report(double value) const;
+
+    struct Info {
+        QString key;
+        // Name of the exported metric, derived from the key
+        QString metricName;
+        Stat::StatType type;
+        Stat::ComputeFlags compute;
+    };
+
+    // The number of registered stats only grows. Ids in the range
+    // [0, registeredCount()) are valid.
+    static int registeredCount();
+    static const Info& info(int id);
+
+    // Maps a key like "EngineMaster::process" to "mixxx_enginemaster_process"
+    static QString metricNameForKey(const QString& key);
+
+  private:
+    int m_id;
+};
+
+struct StatIdReport {
+    int id;
+    double value;
+};
+
+#endif /* STATID_H */
@@ -3,6 +3,9 @@
 #include <QTextStream>
 #include <QFile>
 #include <QMetaType>
+#include <QSaveFile>
+
+#include <algorithm>
 
 #include "util/statsmanager.h"
 #include "util/compatibility.h"
@@ -12,12 +15,26 @@
 const int kStatsPipeSize = 1 << 10;
 const int kProcessLength = kStatsPipeSize * 4 / 5;
 
+// Reports of stats with an id don't wake up the StatsManager thread.
+// The pipes are drained periodically instead and must be able to hold
+// all reports of a thread in between.
+const int kStatIdPipeSize = 1 << 13;
+const unsigned long kProcessIntervalMillis = 100;
+const int kStatIdReadBatchSize = 256;
+
+// Interval between exports of the metrics file
+const mixxx::Duration kMetricsExportInterval = mixxx::Duration::fromSeconds(10);
+
 // static
 bool StatsManager::s_bStatsManagerEnabled = false;
 
+// static
+std::atomic<bool> StatsManager::s_bStatIdsEnabled(false);
+
 StatsPipe::StatsPipe(StatsManager* pManager)
         : FIFO<StatReport>(kStatsPipeSize),
-          m_pManager(pManager) {
+          m_pManager(pManager),
+          m_idReports(kStatIdPipeSize) {
     qRegisterMetaType<Stat>("Stat");
 }
 
@@ -29,8 +46,11 @@ StatsPipe::~StatsPipe() {
 
 StatsManager::StatsManager()
         : QThread(),
-          m_quit(0) {
-    s_bStatsManagerEnabled = true;
+          m_quit(0),
+          m_droppedStatIdReports(0) {
+    s_bStatsManagerEnabled = CmdlineArgs::Instance().getDeveloper();
+    s_bStatIdsEnabled.store(true);
+    m_lastMetricsExport.start();
     setObjectName("StatsManager");
     moveToThread(this);
     start(QThread::LowPriority);
@@ -38,6 +58,7 @@ StatsManager::StatsManager()
 
 StatsManager::~StatsManager() {
     s_bStatsManagerEnabled = false;
+    s_bStatIdsEnabled.store(false);
     m_quit = 1;
     m_statsPipeCondition.wakeAll();
     wait();
@@ -49,6 +70,19 @@ StatsManager::~StatsManager() {
          it != m_stats.constEnd(); ++it) {
         qDebug() << it.value();
     }
+    for (const auto& stat : m_statsById) {
+        if (stat.m_report_count > 0) {
+            qDebug() << stat;
+        }
+    }
+    if (m_droppedStatIdReports.load() > 0) {
+        qDebug() << "Dropped" << m_droppedStatIdReports.load()
+                << "reports of stats with an id";
+    }
+
+    if (!CmdlineArgs::Instance().getMetricsPath().isEmpty()) {
+        exportMetrics(CmdlineArgs::Instance().getMetricsPath());
+    }
 
     if (!m_baseStats.isEmpty()) {
         qDebug() << "=====================================";
@@ -197,9 +231,51 @@ bool StatsManager::maybeWriteReport(const StatReport& report) {
     return success;
 }
 
+bool StatsManager::maybeWriteReport(const StatIdReport& report) {
+    StatsPipe* pStatsPipe = getStatsPipeForThread();
+    if (pStatsPipe == NULL) {
+        return false;
+    }
+    if (pStatsPipe->idReports().write(&report, 1) != 1) {
+        m_droppedStatIdReports.fetch_add(1);
+        return false;
+    }
+    return true;
+}
+
+void StatsManager::processIncomingStatIdReports(StatsPipe* pStatsPipe) {
+    StatIdReport reports[kStatIdReadBatchSize];
+    int count;
+    while ((count = pStatsPipe->idReports().read(reports, kStatIdReadBatchSize)) > 0) {
+        for (int i = 0; i < count; ++i) {
+            const int id = reports[i].id;
+            if (static_cast<int>(m_statsById.size()) <= id) {
+                m_statsById.resize(StatId::registeredCount());
+                m_statsByIdUpdated.resize(m_statsById.size(), false);
+            }
+            Stat& stat = m_statsById[id];
+            if (stat.m_report_count == 0) {
+                const StatId::Info& info = StatId::info(id);
+                stat.m_tag = info.key;
+                stat.m_type = info.type;
+                stat.m_compute = info.compute;
+            }
+            StatReport report;
+            report.tag = nullptr;
+            report.time = 0;
+            report.type = stat.m_type;
+            report.compute = stat.m_compute;
+            report.value = reports[i].value;
+            stat.processReport(report);
+            m_statsByIdUpdated[id] = true;
+        }
+    }
+}
+
 void StatsManager::processIncomingStatReports() {
     StatReport report;
     foreach (StatsPipe* pStatsPipe, m_statsPipes) {
+        processIncomingStatIdReports(pStatsPipe);
         while (pStatsPipe->read(&report, 1) == 1) {
             QString tag = QString::fromUtf8(report.tag);
             Stat& info = m_stats[tag];
@@ -238,17 +314,113 @@ void StatsManager::processIncomingStatReports() {
     }
 }
 
+namespace {
+
+// Conversion factor from the unit of a stat into the base unit of
+// the exported metric
+double metricScale(Stat::StatType type) {
+    switch (type) {
+    case Stat::DURATION_NANOSEC:
+        return 1e-9;
+    case Stat::DURATION_MSEC:
+        return 1e-3;
+    default:
+        return 1.0;
+    }
+}
+
+QString metricName(const Stat& stat, const QString& baseName) {
+    switch (stat.m_type) {
+    case Stat::DURATION_NANOSEC:
+    case Stat::DURATION_MSEC:
+    case Stat::DURATION_SEC:
+        return baseName + "_seconds";
+    case Stat::COUNTER:
+        return baseName + "_total";
+    default:
+        return baseName;
+    }
+}
+
+} // anonymous namespace
+
+void StatsManager::writeMetrics(QTextStream* pStream) {
+    QTextStream& out = *pStream;
+    // Counts must not be rounded
+    out.setRealNumberPrecision(15);
+    QMutexLocker locker(&m_statsPipeLock);
+    for (std::size_t id = 0; id < m_statsById.size(); ++id) {
+        const Stat& stat = m_statsById[id];
+        if (stat.m_report_count <= 0) {
+            continue;
+        }
+        const QString name = metricName(stat, StatId::info(id).metricName);
+        const double scale = metricScale(stat.m_type);
+        out << "# HELP " << name << " " << stat.m_tag << "\n";
+        if (stat.m_type == Stat::COUNTER) {
+            out << "# TYPE " << name << " counter\n";
+            out << name << " " << stat.m_sum << "\n";
+            continue;
+        }
+        out << "# TYPE " << name << " summary\n";
+        out << name << "_sum " << stat.m_sum * scale << "\n";
+        out << name << "_count " << stat.m_report_count << "\n";
+        if (stat.m_compute & Stat::MIN) {
+            out << "# TYPE " << name << "_min gauge\n";
+            out << name << "_min " << stat.m_min * scale << "\n";
+        }
+        if (stat.m_compute & Stat::MAX) {
+            out << "# TYPE " << name << "_max gauge\n";
+            out << name << "_max " << stat.m_max * scale << "\n";
+        }
+    }
+    out << "# HELP mixxx_stats_dropped_reports_total"
+        << " Reports lost due to a full stats pipe\n";
+    out << "# TYPE mixxx_stats_dropped_reports_total counter\n";
+    out << "mixxx_stats_dropped_reports_total "
+        << m_droppedStatIdReports.load() << "\n";
+}
+
+void StatsManager::exportMetrics(const QString& filename) {
+    // Replace the file atomically to never expose a partial export
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Could not open metrics file for writing:"
+                   << filename;
+        return;
+    }
+    {
+        QTextStream out(&file);
+        writeMetrics(&out);
+    }
+    if (!file.commit()) {
+        qWarning() << "Failed to write metrics file:" << filename;
+    }
+}
+
 void StatsManager::run() {
     qDebug() << "StatsManager thread starting up.";
     while (true) {
         m_statsPipeLock.lock();
-        m_statsPipeCondition.wait(&m_statsPipeLock);
+        m_statsPipeCondition.wait(&m_statsPipeLock, kProcessIntervalMillis);
         // We want to process reports even when we are about to quit since we
         // want to print the most accurate stat report on shutdown.
         processIncomingStatReports();
+        const bool emitAllStats = m_emitAllStats.load() == 1;
+        if (s_bStatsManagerEnabled) {
+            // Stats with an id are aggregated in the same map as the
+            // stats with a tag for the developer tools
+            for (std::size_t id = 0; id < m_statsById.size(); ++id) {
+                if (m_statsByIdUpdated[id] ||
+                        (emitAllStats && m_statsById[id].m_report_count > 0)) {
+                    emit(statUpdated(m_statsById[id]));
+                }
+            }
+        }
+        std::fill(m_statsByIdUpdated.begin(), m_statsByIdUpdated.end(), false);
         m_statsPipeLock.unlock();
 
-        if (m_emitAllStats.load() == 1) {
+        if (emitAllStats) {
             for (auto it = m_stats.constBegin();
                  it != m_stats.constEnd(); ++it) {
                 emit(statUpdated(it.value()));
@@ -256,6 +428,13 @@ void StatsManager::run() {
             m_emitAllStats = 0;
         }
 
+        if (m_lastMetricsExport.elapsed() >= kMetricsExportInterval) {
+            m_lastMetricsExport.restart();
+            if (!CmdlineArgs::Instance().getMetricsPath().isEmpty()) {
+                exportMetrics(CmdlineArgs::Instance().getMetricsPath());
+            }
+        }
+
         if (m_quit.load() == 1) {
             qDebug() << "StatsManager thread shutting down.";
             break;
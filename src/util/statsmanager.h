@@ -11,10 +11,16 @@
 #include <QWaitCondition>
 #include <QThreadStorage>
 #include <QList>
+#include <QTextStream>
+
+#include <atomic>
+#include <vector>
 
 #include "util/fifo.h"
+#include "util/performancetimer.h"
 #include "util/singleton.h"
 #include "util/stat.h"
+#include "util/statid.h"
 #include "util/event.h"
 
 class StatsManager;
@@ -23,8 +29,15 @@ class StatsPipe : public FIFO<StatReport> {
   public:
     StatsPipe(StatsManager* pManager);
     virtual ~StatsPipe();
+
+    // Reports of stats with an id, see StatId
+    FIFO<StatIdReport>& idReports() {
+        return m_idReports;
+    }
+
   private:
     StatsManager* m_pManager;
+    FIFO<StatIdReport> m_idReports;
 };
 
 class StatsManager : public QThread, public Singleton<StatsManager> {
@@ -36,7 +49,18 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
     // Returns true if write succeeds.
     bool maybeWriteReport(const StatReport& report);
 
+    // Lock-free, does not wake up the StatsManager thread. Returns
+    // true if write succeeds.
+    bool maybeWriteReport(const StatIdReport& report);
+
+    // Stats with a string tag are only recorded in developer mode
     static bool s_bStatsManagerEnabled;
+    // Stats with an id are always recorded while the StatsManager exists
+    static std::atomic<bool> s_bStatIdsEnabled;
+
+    // Writes all stats with an id in the Prometheus text exposition
+    // format, e.g. for the textfile collector of the node exporter.
+    void writeMetrics(QTextStream* pStream);
 
     // Tell the StatsManager to emit statUpdated for every stat that exists.
     void emitAllStats() {
@@ -55,9 +79,11 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
 
   private:
     void processIncomingStatReports();
+    void processIncomingStatIdReports(StatsPipe* pStatsPipe);
     StatsPipe* getStatsPipeForThread();
     void onStatsPipeDestroyed(StatsPipe* pPipe);
     void writeTimeline(const QString& filename);
+    void exportMetrics(const QString& filename);
 
     QAtomicInt m_emitAllStats;
     QAtomicInt m_quit;
@@ -66,6 +92,12 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
     QMap<QString, Stat> m_experimentStats;
     QList<Event> m_events;
 
+    // Indexed by the stat id
+    std::vector<Stat> m_statsById;
+    std::vector<bool> m_statsByIdUpdated;
+    std::atomic<int> m_droppedStatIdReports;
+    PerformanceTimer m_lastMetricsExport;
+
     QWaitCondition m_statsPipeCondition;
     QMutex m_statsPipeLock;
     QList<StatsPipe*> m_statsPipes;
@@ -9,6 +9,7 @@
 #include "util/parented_ptr.h"
 #include "util/performancetimer.h"
 #include "util/stat.h"
+#include "util/statid.h"
 
 const Stat::ComputeFlags kDefaultComputeFlags = Stat::COUNT | Stat::SUM | Stat::AVERAGE |
         Stat::MAX | Stat::MIN | Stat::SAMPLE_VARIANCE;
@@ -110,6 +111,30 @@ class ScopedTimer {
     bool m_cancel;
 };
 
+// Always-on counterpart of ScopedTimer for hot code paths like the audio
+// callback. The elapsed time is reported to a StatId that has been
+// registered once, i.e. without any string handling:
+//
+//   // At namespace scope, see StatId
+//   const StatId kProcessStatId("EngineMaster::process", Stat::DURATION_NANOSEC);
+//   ...
+//   ScopedStatTimer timer(kProcessStatId);
+class ScopedStatTimer {
+  public:
+    explicit ScopedStatTimer(const StatId& statId)
+            : m_statId(statId) {
+        m_time.start();
+    }
+
+    ~ScopedStatTimer() {
+        m_statId.report(m_time.elapsed().toIntegerNanos());
+    }
+
+  private:
+    const StatId& m_statId;
+    PerformanceTimer m_time;
+};
+
 // A timer that provides a similar API to QTimer but uses render events from the
 // VSyncThread as its source of timing events. This means the timer cannot fire
 // at a rate faster than the user's configured waveform FPS.
@@ -206,7 +206,13 @@ bool VinylControlProcessor::deckConfigured(int index) const {
 void VinylControlProcessor::receiveBuffer(AudioInput input,
                                           const CSAMPLE* pBuffer,
                                           unsigned int nFrames) {
-    ScopedTimer t("VinylControlProcessor::receiveBuffer");
+    receiveView(input, AudioInputView(pBuffer, 2, 2), nFrames);
+}
+
+void VinylControlProcessor::receiveView(AudioInput input,
+                                        const AudioInputView& view,
+                                        unsigned int nFrames) {
+    ScopedTimer t("VinylControlProcessor::receiveView");
     if (input.getType() != AudioInput::VINYLCONTROL) {
         qDebug() << "WARNING: AudioInput type is not VINYLCONTROL. Ignoring incoming buffer.";
         return;
@@ -226,11 +232,10 @@ void VinylControlProcessor::receiveBuffer(AudioInput input,
         return;
     }
 
-    const int kChannels = 2;
-    const int nSamples = nFrames * kChannels;
-    int samplesWritten = pSamplePipe->write(pBuffer, nSamples);
+    // De-interleaves the samples straight from the device buffer
+    SINT framesWritten = view.writeStereo(pSamplePipe, nFrames);
 
-    if (samplesWritten < nSamples) {
+    if (framesWritten < static_cast<SINT>(nFrames)) {
         qWarning() << "ERROR: Buffer overflow in VinylControlProcessor. Dropping samples on the floor."
                    << "VCIndex:" << vcIndex;
     }
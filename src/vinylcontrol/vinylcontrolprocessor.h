@@ -56,6 +56,14 @@ class VinylControlProcessor : public QThread, public AudioDestination {
     void receiveBuffer(AudioInput input, const CSAMPLE* pBuffer,
                        unsigned int iNumFrames);
 
+    // The samples are copied to the FIFO of the input while receiving, so
+    // they can be read from the device buffer.
+    bool receivesInputViews() const {
+        return true;
+    }
+    void receiveView(AudioInput input, const AudioInputView& view,
+                     unsigned int iNumFrames);
+
   protected:
     void run();
 
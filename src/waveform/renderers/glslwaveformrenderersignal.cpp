@@ -1,10 +1,14 @@
 #include <QGLFramebufferObject>
 
+#include <algorithm>
+#include <vector>
+
 #include "waveform/renderers/glslwaveformrenderersignal.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
 
 #include "waveform/waveform.h"
 #include "waveform/waveformwidgetfactory.h"
+#include "util/math.h"
 
 GLSLWaveformRendererSignal::GLSLWaveformRendererSignal(WaveformWidgetRenderer* waveformWidgetRenderer,
                                                        bool rgbShader)
@@ -116,8 +120,31 @@ bool GLSLWaveformRendererSignal::loadTexture() {
         int textureWidth = waveform->getTextureStride();
         int textureHeight = waveform->getTextureSize() / waveform->getTextureStride();
 
+        // Only the valid data is uploaded, because waveforms that have
+        // been loaded from a file are not padded to the texture size.
+        // The shaders don't access texels beyond the waveform length,
+        // but a nearest-neighbour lookup at the border of the last valid
+        // texel may pick its neighbour. The rest of the last row and the
+        // row below are therefore zeroed instead of left uninitialized.
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureWidth, textureHeight, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, data);
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        const int fullRows = dataSize / textureWidth;
+        if (fullRows > 0) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, textureWidth, fullRows,
+                            GL_RGBA, GL_UNSIGNED_BYTE, data);
+        }
+        const int paddedRows = math_min(2, textureHeight - fullRows);
+        if (paddedRows > 0) {
+            const int remainder = dataSize % textureWidth;
+            std::vector<WaveformData> paddedData(
+                    paddedRows * textureWidth, WaveformData(0));
+            std::copy(data + fullRows * textureWidth,
+                    data + fullRows * textureWidth + remainder,
+                    paddedData.begin());
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, fullRows,
+                            textureWidth, paddedRows,
+                            GL_RGBA, GL_UNSIGNED_BYTE, paddedData.data());
+        }
         int error = glGetError();
         if (error) {
             qDebug() << "GLSLWaveformRendererSignal::loadTexture - glTexImage2D error" << error;
@@ -1,6 +1,7 @@
 #include <QtDebug>
 
 #include "waveform/waveform.h"
+#include "waveform/waveformfile.h"
 #include "proto/waveform.pb.h"
 
 using namespace mixxx::track;
@@ -21,6 +22,7 @@ Waveform::Waveform(const QByteArray data)
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
@@ -28,11 +30,39 @@ Waveform::Waveform(const QByteArray data)
     readByteArray(data);
 }
 
+Waveform::Waveform(std::unique_ptr<WaveformFile> pFile)
+        : m_id(-1),
+          m_saveState(SaveState::NotSaved),
+          m_dataSize(0),
+          m_pData(nullptr),
+          m_pFile(std::move(pFile)),
+          m_visualSampleRate(0),
+          m_audioVisualRatio(0),
+          m_textureStride(computeTextureStride(0)),
+          m_completion(-1) {
+    VERIFY_OR_DEBUG_ASSERT(m_pFile && m_pFile->levelCount() > 0) {
+        m_pFile.reset();
+        resize(0);
+        return;
+    }
+    for (int level = 0; level < m_pFile->levelCount(); ++level) {
+        m_mipLevels.push_back(m_pFile->level(level));
+    }
+    m_pData = m_mipLevels.front().data;
+    m_dataSize = m_mipLevels.front().dataSize;
+    m_textureStride = computeTextureStride(m_dataSize);
+    m_visualSampleRate = m_pFile->visualSampleRate();
+    m_audioVisualRatio = m_pFile->audioVisualRatio();
+    m_completion = m_dataSize;
+    m_saveState = SaveState::Saved;
+}
+
 Waveform::Waveform(int audioSampleRate, int audioSamples,
                    int desiredVisualSampleRate, int maxVisualSamples)
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(1024),
@@ -108,7 +138,7 @@ QByteArray Waveform::toByteArray() const {
 
     int dataSize = getDataSize();
     for (int i = 0; i < dataSize; ++i) {
-        const WaveformData& datum = m_data.at(i);
+        const WaveformData& datum = m_pData[i];
         all->add_value(datum.filtered.all);
         low->add_value(datum.filtered.low);
         mid->add_value(datum.filtered.mid);
@@ -201,6 +231,7 @@ void Waveform::resize(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    updateDataPointer();
 }
 
 void Waveform::assign(int size, int value) {
@@ -208,12 +239,20 @@ void Waveform::assign(int size, int value) {
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, value);
     m_saveState = SaveState::SavePending;
+    updateDataPointer();
+}
+
+void Waveform::updateDataPointer() {
+    m_pData = &m_data[0];
+    m_mipLevels.clear();
+    m_mipLevels.push_back(WaveformMipLevel{m_pData, m_dataSize});
 }
 
 void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size("+QString::number(getDataSize())+")"
              << "textureStride("+QString::number(m_textureStride)+")"
+             << "mipLevels("+QString::number(getMipLevelCount())+")"
              << "completion("+QString::number(getCompletion())+")"
              << "visualSampleRate("+QString::number(m_visualSampleRate)+")"
              << "audioVisualRatio("+QString::number(m_audioVisualRatio)+")";
@@ -1,6 +1,7 @@
 #ifndef WAVEFORM_H
 #define WAVEFORM_H
 
+#include <memory>
 #include <vector>
 
 #include <QMutex>
@@ -10,6 +11,7 @@
 #include <QSharedPointer>
 #include <QMutexLocker>
 
+#include "util/assert.h"
 #include "util/class.h"
 #include "util/compatibility.h"
 
@@ -29,6 +31,14 @@ union WaveformData {
     WaveformData(int i) { m_i = i;}
 };
 
+// A level of the waveform data with reduced resolution.
+struct WaveformMipLevel {
+    const WaveformData* data;
+    int dataSize;
+};
+
+class WaveformFile;
+
 class Waveform {
   public:
     enum class SaveState {
@@ -38,6 +48,9 @@ class Waveform {
     };
 
     explicit Waveform(const QByteArray pData = QByteArray());
+    // Takes ownership of a loaded file. The data of the waveform is read
+    // directly from the file, i.e. from the mapped memory if possible.
+    explicit Waveform(std::unique_ptr<WaveformFile> pFile);
     Waveform(int audioSampleRate, int audioSamples,
              int desiredVisualSampleRate, int maxVisualSamples);
 
@@ -91,6 +104,12 @@ class Waveform {
         m_saveState = eState;
     }
 
+    // We do not lock the mutex since m_visualSampleRate is not changed after
+    // the constructor runs.
+    double getVisualSampleRate() const {
+        return m_visualSampleRate;
+    }
+
     // We do not lock the mutex since m_audioVisualRatio is not changed after
     // the constructor runs.
     double getAudioVisualRatio() const {
@@ -110,28 +129,49 @@ class Waveform {
     // the constructor runs.
     inline int getTextureStride() const { return m_textureStride; }
 
-    // We do not lock the mutex since m_data is not resized after the
-    // constructor runs.
-    inline int getTextureSize() const { return m_data.size(); }
+    // We do not lock the mutex since m_textureStride is not changed after
+    // the constructor runs. Only the first getDataSize() elements of the
+    // texture are valid. Waveforms that have been loaded from a file are
+    // not padded to the texture size.
+    inline int getTextureSize() const { return m_textureStride * m_textureStride; }
 
     // Atomically get the number of data elements in this Waveform. We do not
     // lock the mutex since m_dataSize is not changed after the constructor
     // runs.
     inline int getDataSize() const { return m_dataSize; }
 
-    inline const WaveformData& get(int i) const { return m_data[i];}
-    inline unsigned char getLow(int i) const { return m_data[i].filtered.low;}
-    inline unsigned char getMid(int i) const { return m_data[i].filtered.mid;}
-    inline unsigned char getHigh(int i) const { return m_data[i].filtered.high;}
-    inline unsigned char getAll(int i) const { return m_data[i].filtered.all;}
+    inline const WaveformData& get(int i) const { return m_pData[i];}
+    inline unsigned char getLow(int i) const { return m_pData[i].filtered.low;}
+    inline unsigned char getMid(int i) const { return m_pData[i].filtered.mid;}
+    inline unsigned char getHigh(int i) const { return m_pData[i].filtered.high;}
+    inline unsigned char getAll(int i) const { return m_pData[i].filtered.all;}
 
     // We do not lock the mutex since m_data is not resized after the
-    // constructor runs.
-    WaveformData* data() { return &m_data[0];}
+    // constructor runs. Waveforms that have been loaded from a file
+    // are read-only.
+    WaveformData* data() {
+        DEBUG_ASSERT(!m_pFile);
+        return &m_data[0];
+    }
 
-    // We do not lock the mutex since m_data is not resized after the
+    // We do not lock the mutex since m_pData is not changed after the
     // constructor runs.
-    const WaveformData* data() const { return &m_data[0];}
+    const WaveformData* data() const { return m_pData;}
+
+    // Level 0 is the full resolution data. A sample pair (left, right)
+    // of level n holds the maximum of 2^n sample pairs of level 0. Only
+    // waveforms that have been loaded from a WaveformFile with precomputed
+    // mip levels provide more than a single level. The levels are not
+    // changed after the constructor runs.
+    int getMipLevelCount() const {
+        return static_cast<int>(m_mipLevels.size());
+    }
+    int getMipLevelDataSize(int level) const {
+        return m_mipLevels[level].dataSize;
+    }
+    const WaveformData* mipLevelData(int level) const {
+        return m_mipLevels[level].data;
+    }
 
     void dump() const;
 
@@ -140,12 +180,13 @@ class Waveform {
     void resize(int size);
     void assign(int size, int value = 0);
 
+    void updateDataPointer();
+
     inline WaveformData& at(int i) { return m_data[i];}
     inline unsigned char& low(int i) { return m_data[i].filtered.low;}
     inline unsigned char& mid(int i) { return m_data[i].filtered.mid;}
     inline unsigned char& high(int i) { return m_data[i].filtered.high;}
     inline unsigned char& all(int i) { return m_data[i].filtered.all;}
-    double getVisualSampleRate() const { return m_visualSampleRate; }
 
     // If stored in the database, the ID of the waveform.
     int m_id;
@@ -165,6 +206,11 @@ class Waveform {
     // TODO(XXX): In the future we should switch to QVector and use the raw data
     // pointer when performance matters.
     std::vector<WaveformData> m_data;
+    // Points either into m_data or into m_pFile
+    const WaveformData* m_pData;
+    // The file if the waveform has been loaded from a WaveformFile
+    std::unique_ptr<WaveformFile> m_pFile;
+    std::vector<WaveformMipLevel> m_mipLevels;
     // Not allowed to change after the constructor runs.
     double m_visualSampleRate;
     // Not allowed to change after the constructor runs.
@@ -2,17 +2,45 @@
 
 #include "waveform/waveformfactory.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformfile.h"
 
 // static
 Waveform* WaveformFactory::loadWaveformFromAnalysis(
         const AnalysisDao::AnalysisInfo& analysis) {
-    Waveform* pWaveform = new Waveform(analysis.data);
+    Waveform* pWaveform;
+    if (!analysis.dataFilePath.isEmpty()) {
+        std::unique_ptr<WaveformFile> pFile =
+                WaveformFile::open(analysis.dataFilePath);
+        pWaveform = pFile ? new Waveform(std::move(pFile)) : new Waveform();
+    } else if (WaveformFile::isWaveformFile(analysis.data)) {
+        std::unique_ptr<WaveformFile> pFile =
+                WaveformFile::fromByteArray(analysis.data);
+        pWaveform = pFile ? new Waveform(std::move(pFile)) : new Waveform();
+    } else {
+        pWaveform = new Waveform(analysis.data);
+    }
     pWaveform->setId(analysis.analysisId);
     pWaveform->setVersion(analysis.version);
     pWaveform->setDescription(analysis.description);
     return pWaveform;
 }
 
+// static
+QByteArray WaveformFactory::saveWaveformToAnalysisData(
+        const Waveform& waveform,
+        AnalysisDao::AnalysisType type,
+        bool compress) {
+    // Compressed levels are decoded into memory while loading. The raw
+    // encoding allows to use the mapped file directly.
+    const WaveformFile::Encoding encoding = compress ?
+            WaveformFile::Encoding::DeltaRle : WaveformFile::Encoding::Raw;
+    // Only the overview widgets benefit from precomputed mip levels.
+    // The waveform widgets need the full resolution.
+    const int maxMipLevelCount = type == AnalysisDao::TYPE_WAVESUMMARY ?
+            WaveformFile::kMaxMipLevelCount : 0;
+    return WaveformFile::write(waveform, encoding, maxMipLevelCount);
+}
+
 // static
 WaveformFactory::VersionClass WaveformFactory::waveformVersionToVersionClass(const QString& version) {
     if (version == WAVEFORM_CURRENT_VERSION) {
@@ -20,6 +48,11 @@ WaveformFactory::VersionClass WaveformFactory::waveformVersionToVersionClass(con
         return VC_USE;
     }
 
+    if (version == WAVEFORM_5_VERSION) {
+        // Used from Mixxx 1.12 alpha until 2.2, stored as protobuf
+        return VC_MIGRATE;
+    }
+
     if (version == WAVEFORM_4_VERSION) {
         // Used in Mixxx 1.12 beta, suffers Bug lp:1406389
         return VC_REMOVE;
@@ -46,6 +79,11 @@ WaveformFactory::VersionClass WaveformFactory::waveformSummaryVersionToVersionCl
         return VC_USE;
     }
 
+    if (version == WAVEFORMSUMMARY_5_VERSION) {
+        // Used from Mixxx 1.12 alpha until 2.2, stored as protobuf
+        return VC_MIGRATE;
+    }
+
     if (version == WAVEFORMSUMMARY_4_VERSION) {
         // Used in Mixxx 1.12 beta, suffers Bug lp:1406389
         return VC_REMOVE;
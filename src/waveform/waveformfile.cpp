@@ -0,0 +1,428 @@
+#include "waveform/waveformfile.h"
+
+#include <cstring>
+
+#include <QIODevice>
+#include <QtDebug>
+
+#include "util/math.h"
+#include "util/memory.h"
+
+namespace {
+
+const char kMagic[4] = {'M', 'X', 'W', 'F'};
+const quint32 kFormatVersion = 1;
+
+// Levels are aligned to allow accessing the mapped data directly
+const int kLevelAlignment = 16;
+
+// Mip levels with fewer samples are not useful for the overview
+const int kMinMipLevelDataSize = 512;
+
+// Upper bound for sanity checks while parsing. The summary is limited
+// to a few thousand samples and the waveform to a few hundred samples
+// per second.
+const int kMaxLevelCount = 32;
+const quint32 kMaxDataSize = 1 << 28;
+
+struct FileHeader {
+    char magic[4];
+    quint32 formatVersion;
+    quint32 levelCount;
+    quint32 reserved;
+    double visualSampleRate;
+    double audioVisualRatio;
+};
+static_assert(sizeof(FileHeader) == 32, "unexpected padding");
+
+struct LevelHeader {
+    quint32 dataSize;
+    quint32 encoding;
+    quint64 offset;
+    quint64 byteCount;
+};
+static_assert(sizeof(LevelHeader) == 24, "unexpected padding");
+
+static_assert(sizeof(WaveformData) == 4, "unexpected padding");
+
+// Control bytes of the run-length encoding. Values below kRunFlag are
+// followed by (control + 1) literal bytes. Values from kRunFlag on are
+// followed by a single byte that is repeated (control - kRunFlag +
+// kMinRunLength) times.
+const int kRunFlag = 0x80;
+const int kMinRunLength = 3;
+const int kMaxRunLength = 0x7F + kMinRunLength;
+const int kMaxLiteralLength = 0x80;
+
+// The 4 signals of the waveform are encoded one after another as planes
+const int kPlaneCount = 4;
+// Deltas are taken between successive samples of the same channel
+const int kDeltaDistance = 2;
+
+inline unsigned char& planeValue(WaveformData* pData, int plane) {
+    switch (plane) {
+    case 0:
+        return pData->filtered.low;
+    case 1:
+        return pData->filtered.mid;
+    case 2:
+        return pData->filtered.high;
+    default:
+        return pData->filtered.all;
+    }
+}
+
+inline unsigned char planeValue(const WaveformData& data, int plane) {
+    return planeValue(const_cast<WaveformData*>(&data), plane);
+}
+
+void encodeRuns(const std::vector<unsigned char>& input, QByteArray* pOutput) {
+    const int size = static_cast<int>(input.size());
+    int i = 0;
+    while (i < size) {
+        int runLength = 1;
+        while (i + runLength < size &&
+                input[i + runLength] == input[i] &&
+                runLength < kMaxRunLength) {
+            ++runLength;
+        }
+        if (runLength >= kMinRunLength) {
+            pOutput->append(static_cast<char>(kRunFlag + runLength - kMinRunLength));
+            pOutput->append(static_cast<char>(input[i]));
+            i += runLength;
+            continue;
+        }
+        // Collect literals until the next run starts
+        const int literalStart = i;
+        int literalLength = 0;
+        while (i < size && literalLength < kMaxLiteralLength) {
+            if (i + kMinRunLength <= size &&
+                    input[i] == input[i + 1] &&
+                    input[i] == input[i + 2]) {
+                break;
+            }
+            ++i;
+            ++literalLength;
+        }
+        DEBUG_ASSERT(literalLength > 0);
+        pOutput->append(static_cast<char>(literalLength - 1));
+        pOutput->append(
+                reinterpret_cast<const char*>(&input[literalStart]),
+                literalLength);
+    }
+}
+
+// Decodes exactly output.size() bytes. Returns the number of consumed
+// input bytes or -1 if the input is corrupt.
+qint64 decodeRuns(const uchar* pInput, qint64 inputSize,
+        std::vector<unsigned char>* pOutput) {
+    const int size = static_cast<int>(pOutput->size());
+    qint64 pos = 0;
+    int i = 0;
+    while (i < size) {
+        if (pos >= inputSize) {
+            return -1;
+        }
+        const int control = pInput[pos++];
+        if (control >= kRunFlag) {
+            const int runLength = control - kRunFlag + kMinRunLength;
+            if (pos >= inputSize || i + runLength > size) {
+                return -1;
+            }
+            std::memset(&(*pOutput)[i], pInput[pos++], runLength);
+            i += runLength;
+        } else {
+            const int literalLength = control + 1;
+            if (pos + literalLength > inputSize || i + literalLength > size) {
+                return -1;
+            }
+            std::memcpy(&(*pOutput)[i], pInput + pos, literalLength);
+            pos += literalLength;
+            i += literalLength;
+        }
+    }
+    return pos;
+}
+
+QByteArray encodeDeltaRle(const WaveformData* pData, int dataSize) {
+    QByteArray encoded;
+    std::vector<unsigned char> deltas(dataSize);
+    for (int plane = 0; plane < kPlaneCount; ++plane) {
+        for (int i = 0; i < dataSize; ++i) {
+            const unsigned char previous = i >= kDeltaDistance ?
+                    planeValue(pData[i - kDeltaDistance], plane) : 0;
+            // Wraps around, i.e. the deltas are exactly reversible
+            deltas[i] = static_cast<unsigned char>(
+                    planeValue(pData[i], plane) - previous);
+        }
+        encodeRuns(deltas, &encoded);
+    }
+    return encoded;
+}
+
+bool decodeDeltaRle(const uchar* pInput, qint64 inputSize,
+        std::vector<WaveformData>* pData) {
+    const int dataSize = static_cast<int>(pData->size());
+    std::vector<unsigned char> deltas(dataSize);
+    qint64 pos = 0;
+    for (int plane = 0; plane < kPlaneCount; ++plane) {
+        const qint64 consumed = decodeRuns(pInput + pos, inputSize - pos, &deltas);
+        if (consumed < 0) {
+            return false;
+        }
+        pos += consumed;
+        for (int i = 0; i < dataSize; ++i) {
+            const unsigned char previous = i >= kDeltaDistance ?
+                    planeValue((*pData)[i - kDeltaDistance], plane) : 0;
+            planeValue(&(*pData)[i], plane) =
+                    static_cast<unsigned char>(previous + deltas[i]);
+        }
+    }
+    return pos == inputSize;
+}
+
+// Returns the size of the header including the level table or -1
+// if the data does not start with a valid file header.
+int headerSize(const char* pData, qint64 size) {
+    if (size < static_cast<qint64>(sizeof(FileHeader))) {
+        return -1;
+    }
+    FileHeader fileHeader;
+    std::memcpy(&fileHeader, pData, sizeof(fileHeader));
+    if (std::memcmp(fileHeader.magic, kMagic, sizeof(kMagic)) != 0 ||
+            fileHeader.formatVersion != kFormatVersion ||
+            fileHeader.levelCount == 0 ||
+            fileHeader.levelCount > static_cast<quint32>(kMaxLevelCount)) {
+        return -1;
+    }
+    return sizeof(FileHeader) + fileHeader.levelCount * sizeof(LevelHeader);
+}
+
+int alignedSize(int size) {
+    return (size + kLevelAlignment - 1) / kLevelAlignment * kLevelAlignment;
+}
+
+} // anonymous namespace
+
+// static
+const int WaveformFile::kMaxMipLevelCount;
+
+WaveformFile::WaveformFile()
+        : m_pMapped(nullptr),
+          m_visualSampleRate(0),
+          m_audioVisualRatio(0) {
+}
+
+// static
+void WaveformFile::reduceMipLevel(
+        const WaveformData* pData,
+        int dataSize,
+        std::vector<WaveformData>* pReduced) {
+    // Two sample pairs of the input become one sample pair of the output
+    pReduced->assign((dataSize + 3) / 4 * 2, WaveformData(0));
+    for (int i = 0; i < dataSize; ++i) {
+        WaveformData& reduced = (*pReduced)[(i / 4) * 2 + (i % 2)];
+        reduced.filtered.low = math_max(reduced.filtered.low, pData[i].filtered.low);
+        reduced.filtered.mid = math_max(reduced.filtered.mid, pData[i].filtered.mid);
+        reduced.filtered.high = math_max(reduced.filtered.high, pData[i].filtered.high);
+        reduced.filtered.all = math_max(reduced.filtered.all, pData[i].filtered.all);
+    }
+}
+
+// static
+QByteArray WaveformFile::write(
+        const Waveform& waveform,
+        Encoding encoding,
+        int maxMipLevelCount) {
+    const int dataSize = waveform.getDataSize();
+    VERIFY_OR_DEBUG_ASSERT(dataSize > 0) {
+        return QByteArray();
+    }
+
+    std::vector<std::vector<WaveformData>> mipLevels;
+    const WaveformData* pPreviousLevel = waveform.data();
+    int previousLevelSize = dataSize;
+    while (static_cast<int>(mipLevels.size()) <
+            math_min(maxMipLevelCount, kMaxMipLevelCount)) {
+        std::vector<WaveformData> reduced;
+        reduceMipLevel(pPreviousLevel, previousLevelSize, &reduced);
+        if (static_cast<int>(reduced.size()) < kMinMipLevelDataSize) {
+            break;
+        }
+        mipLevels.push_back(std::move(reduced));
+        pPreviousLevel = mipLevels.back().data();
+        previousLevelSize = static_cast<int>(mipLevels.back().size());
+    }
+
+    std::vector<WaveformMipLevel> levels;
+    levels.push_back(WaveformMipLevel{waveform.data(), dataSize});
+    for (const auto& mipLevel : mipLevels) {
+        levels.push_back(WaveformMipLevel{
+                mipLevel.data(), static_cast<int>(mipLevel.size())});
+    }
+
+    std::vector<QByteArray> payloads;
+    for (const auto& level : levels) {
+        if (encoding == Encoding::DeltaRle) {
+            payloads.push_back(encodeDeltaRle(level.data, level.dataSize));
+        } else {
+            payloads.push_back(QByteArray::fromRawData(
+                    reinterpret_cast<const char*>(level.data),
+                    level.dataSize * sizeof(WaveformData)));
+        }
+    }
+
+    FileHeader fileHeader;
+    std::memcpy(fileHeader.magic, kMagic, sizeof(kMagic));
+    fileHeader.formatVersion = kFormatVersion;
+    fileHeader.levelCount = static_cast<quint32>(levels.size());
+    fileHeader.reserved = 0;
+    fileHeader.visualSampleRate = waveform.getVisualSampleRate();
+    fileHeader.audioVisualRatio = waveform.getAudioVisualRatio();
+
+    QByteArray data;
+    data.append(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    int offset = alignedSize(sizeof(FileHeader) + levels.size() * sizeof(LevelHeader));
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        LevelHeader levelHeader;
+        levelHeader.dataSize = static_cast<quint32>(levels[i].dataSize);
+        levelHeader.encoding = static_cast<quint32>(encoding);
+        levelHeader.offset = offset;
+        levelHeader.byteCount = payloads[i].size();
+        data.append(reinterpret_cast<const char*>(&levelHeader), sizeof(levelHeader));
+        offset = alignedSize(offset + payloads[i].size());
+    }
+    for (const auto& payload : payloads) {
+        data.append(QByteArray(alignedSize(data.size()) - data.size(), '\0'));
+        data.append(payload);
+    }
+    return data;
+}
+
+// static
+std::unique_ptr<WaveformFile> WaveformFile::open(const QString& filePath) {
+    std::unique_ptr<WaveformFile> pFile(new WaveformFile);
+    pFile->m_file.setFileName(filePath);
+    if (!pFile->m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open waveform file" << filePath;
+        return nullptr;
+    }
+    const qint64 size = pFile->m_file.size();
+    // The mapping is released when m_file is closed
+    pFile->m_pMapped = pFile->m_file.map(0, size);
+    bool valid;
+    if (pFile->m_pMapped) {
+        valid = pFile->parse(pFile->m_pMapped, size);
+    } else {
+        // Fall back to reading the file, e.g. on file systems that
+        // don't support memory-mapping
+        pFile->m_data = pFile->m_file.readAll();
+        pFile->m_file.close();
+        valid = pFile->parse(
+                reinterpret_cast<const uchar*>(pFile->m_data.constData()),
+                pFile->m_data.size());
+    }
+    if (!valid) {
+        qWarning() << "Invalid waveform file" << filePath;
+        return nullptr;
+    }
+    return pFile;
+}
+
+// static
+std::unique_ptr<WaveformFile> WaveformFile::fromByteArray(const QByteArray& data) {
+    std::unique_ptr<WaveformFile> pFile(new WaveformFile);
+    // Implicitly shared, the data is not copied
+    pFile->m_data = data;
+    if (!pFile->parse(
+            reinterpret_cast<const uchar*>(pFile->m_data.constData()),
+            pFile->m_data.size())) {
+        return nullptr;
+    }
+    return pFile;
+}
+
+// static
+bool WaveformFile::isWaveformFile(const QByteArray& data) {
+    return headerSize(data.constData(), data.size()) > 0;
+}
+
+// static
+QByteArray WaveformFile::header(const QByteArray& data) {
+    const int size = headerSize(data.constData(), data.size());
+    if (size < 0 || size > data.size()) {
+        return QByteArray();
+    }
+    return data.left(size);
+}
+
+// static
+QByteArray WaveformFile::readHeader(QIODevice* pDevice) {
+    const QByteArray fileHeader = pDevice->peek(sizeof(FileHeader));
+    const int size = headerSize(fileHeader.constData(), fileHeader.size());
+    if (size < 0) {
+        return QByteArray();
+    }
+    QByteArray header = pDevice->read(size);
+    if (header.size() != size) {
+        return QByteArray();
+    }
+    return header;
+}
+
+bool WaveformFile::parse(const uchar* pData, qint64 size) {
+    const int levelTableEnd = headerSize(reinterpret_cast<const char*>(pData), size);
+    if (levelTableEnd < 0 || levelTableEnd > size) {
+        return false;
+    }
+    FileHeader fileHeader;
+    std::memcpy(&fileHeader, pData, sizeof(fileHeader));
+    if (!(fileHeader.visualSampleRate > 0) || !(fileHeader.audioVisualRatio > 0)) {
+        return false;
+    }
+    m_visualSampleRate = fileHeader.visualSampleRate;
+    m_audioVisualRatio = fileHeader.audioVisualRatio;
+
+    m_levels.clear();
+    m_decodedLevels.clear();
+    m_decodedLevels.reserve(fileHeader.levelCount);
+    for (quint32 i = 0; i < fileHeader.levelCount; ++i) {
+        LevelHeader levelHeader;
+        std::memcpy(&levelHeader,
+                pData + sizeof(FileHeader) + i * sizeof(LevelHeader),
+                sizeof(levelHeader));
+        if (levelHeader.dataSize == 0 ||
+                levelHeader.dataSize > kMaxDataSize ||
+                levelHeader.offset % kLevelAlignment != 0 ||
+                levelHeader.offset < static_cast<quint64>(levelTableEnd) ||
+                levelHeader.offset > static_cast<quint64>(size) ||
+                levelHeader.byteCount > static_cast<quint64>(size) - levelHeader.offset) {
+            return false;
+        }
+        const uchar* pLevelData = pData + levelHeader.offset;
+        const int dataSize = static_cast<int>(levelHeader.dataSize);
+        switch (static_cast<Encoding>(levelHeader.encoding)) {
+        case Encoding::Raw:
+            if (levelHeader.byteCount != dataSize * sizeof(WaveformData)) {
+                return false;
+            }
+            m_levels.push_back(WaveformMipLevel{
+                    reinterpret_cast<const WaveformData*>(pLevelData),
+                    dataSize});
+            break;
+        case Encoding::DeltaRle:
+            m_decodedLevels.emplace_back(dataSize);
+            if (!decodeDeltaRle(pLevelData, levelHeader.byteCount,
+                    &m_decodedLevels.back())) {
+                return false;
+            }
+            m_levels.push_back(WaveformMipLevel{
+                    m_decodedLevels.back().data(),
+                    dataSize});
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
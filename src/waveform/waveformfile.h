@@ -0,0 +1,102 @@
+#ifndef WAVEFORMFILE_H
+#define WAVEFORMFILE_H
+
+#include <memory>
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include "util/class.h"
+#include "waveform/waveform.h"
+
+class QIODevice;
+
+// Binary file format for storing waveforms that can be memory-mapped
+// and used without parsing or copying the data.
+//
+// The file starts with a fixed size header followed by a table with an
+// entry for each level. The levels follow aligned to 16 bytes. Level 0
+// contains the full resolution waveform data. The following mip levels
+// are reduced by a factor of 2 each. They are precomputed for the
+// overview widgets that don't need the full resolution.
+//
+// Levels are stored either raw, i.e. exactly as in memory, or compressed
+// with a delta/run-length encoding. Raw levels are accessed directly in
+// the mapped file, compressed levels are decoded while loading.
+//
+// All values are stored in native byte order. Files that have been written
+// on a platform with a different byte order are rejected.
+class WaveformFile {
+  public:
+    enum class Encoding : quint32 {
+        Raw = 0,
+        DeltaRle = 1,
+    };
+
+    static const int kMaxMipLevelCount = 8;
+
+    // Serializes level 0 of the waveform together with at most
+    // maxMipLevelCount precomputed mip levels.
+    static QByteArray write(
+            const Waveform& waveform,
+            Encoding encoding,
+            int maxMipLevelCount);
+
+    // Maps the file into memory. Returns nullptr if the file could not
+    // be read or if it is not a valid waveform file.
+    static std::unique_ptr<WaveformFile> open(const QString& filePath);
+    // Uses the serialized data as returned by write().
+    static std::unique_ptr<WaveformFile> fromByteArray(const QByteArray& data);
+
+    // Checks the header of the serialized data.
+    static bool isWaveformFile(const QByteArray& data);
+    // Returns the header including the level table or an empty array
+    // if the data or the device does not start with a valid header.
+    static QByteArray header(const QByteArray& data);
+    static QByteArray readHeader(QIODevice* pDevice);
+
+    // Reduces the resolution of the waveform data by a factor of 2
+    // while preserving the peaks of both channels.
+    static void reduceMipLevel(
+            const WaveformData* pData,
+            int dataSize,
+            std::vector<WaveformData>* pReduced);
+
+    bool isMapped() const {
+        return m_pMapped != nullptr;
+    }
+
+    double visualSampleRate() const {
+        return m_visualSampleRate;
+    }
+    double audioVisualRatio() const {
+        return m_audioVisualRatio;
+    }
+
+    int levelCount() const {
+        return static_cast<int>(m_levels.size());
+    }
+    const WaveformMipLevel& level(int level) const {
+        return m_levels[level];
+    }
+
+  private:
+    WaveformFile();
+
+    bool parse(const uchar* pData, qint64 size);
+
+    QFile m_file;
+    uchar* m_pMapped;
+    // Content of the file if it could not be mapped
+    QByteArray m_data;
+    double m_visualSampleRate;
+    double m_audioVisualRatio;
+    std::vector<WaveformMipLevel> m_levels;
+    std::vector<std::vector<WaveformData>> m_decodedLevels;
+
+    DISALLOW_COPY_AND_ASSIGN(WaveformFile);
+};
+
+#endif // WAVEFORMFILE_H
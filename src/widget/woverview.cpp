@@ -41,6 +41,7 @@ WOverview::WOverview(
         UserSettingsPointer pConfig,
         QWidget* parent) :
         WWidget(parent),
+        m_waveformMipLevel(0),
         m_actualCompletion(0),
         m_pixmapDone(false),
         m_waveformPeak(-1.0),
@@ -174,6 +175,8 @@ void WOverview::slotWaveformSummaryUpdated() {
     if (m_pWaveform) {
         // If the waveform is already complete, just draw it.
         if (m_pWaveform->getCompletion() == m_pWaveform->getDataSize()) {
+            // The size and the mip levels of the new waveform might differ
+            m_waveformSourceImage = QImage();
             m_actualCompletion = 0;
             if (drawNextPixmapPart()) {
                 update();
@@ -191,6 +194,19 @@ void WOverview::slotWaveformSummaryUpdated() {
     }
 }
 
+int WOverview::selectMipLevel(const Waveform& waveform) {
+    if (waveform.getCompletion() < waveform.getDataSize()) {
+        // Incomplete waveforms are drawn incrementally
+        return 0;
+    }
+    int level = 0;
+    while (level + 1 < waveform.getMipLevelCount() &&
+            waveform.getMipLevelDataSize(level + 1) / 2 >= length()) {
+        ++level;
+    }
+    return level;
+}
+
 void WOverview::onTrackAnalyzerProgress(TrackId trackId, AnalyzerProgress analyzerProgress) {
     if (!m_pCurrentTrack || (m_pCurrentTrack->getId() != trackId)) {
         return;
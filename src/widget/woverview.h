@@ -74,11 +74,17 @@ class WOverview : public WWidget, public TrackDropTarget {
         return m_pWaveform;
     }
 
+    // Returns the coarsest mip level of a complete waveform that still
+    // provides a sample pair for each pixel.
+    int selectMipLevel(const Waveform& waveform);
+
     QImage m_waveformSourceImage;
     QImage m_waveformImageScaled;
 
     WaveformSignalColors m_signalColors;
 
+    // The mip level of the waveform that is drawn into the source image
+    int m_waveformMipLevel;
     // Hold the last visual sample processed to generate the pixmap
     int m_actualCompletion;
 
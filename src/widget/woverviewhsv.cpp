@@ -27,22 +27,28 @@ bool WOverviewHSV::drawNextPixmapPart() {
         return false;
     }
 
-    const int dataSize = pWaveform->getDataSize();
-    if (dataSize == 0) {
+    if (pWaveform->getDataSize() == 0) {
         return false;
     }
 
     if (m_waveformSourceImage.isNull()) {
+        m_waveformMipLevel = selectMipLevel(*pWaveform);
         // Waveform pixmap twice the height of the viewport to be scalable
         // by total_gain
         // We keep full range waveform data to scale it on paint
-        m_waveformSourceImage = QImage(dataSize / 2, 2 * 255,
+        m_waveformSourceImage = QImage(
+                pWaveform->getMipLevelDataSize(m_waveformMipLevel) / 2, 2 * 255,
                 QImage::Format_ARGB32_Premultiplied);
         m_waveformSourceImage.fill(QColor(0, 0, 0, 0).value());
     }
 
-    // Always multiple of 2
-    const int waveformCompletion = pWaveform->getCompletion();
+    const WaveformData* const data = pWaveform->mipLevelData(m_waveformMipLevel);
+    const int dataSize = pWaveform->getMipLevelDataSize(m_waveformMipLevel);
+
+    // Always multiple of 2. Mip levels are only selected for complete
+    // waveforms.
+    const int waveformCompletion = m_waveformMipLevel > 0 ?
+            dataSize : pWaveform->getCompletion();
     // Test if there is some new to draw (at least of pixel width)
     const int completionIncrement = waveformCompletion - m_actualCompletion;
 
@@ -80,15 +86,15 @@ bool WOverviewHSV::drawNextPixmapPart() {
 
     for (currentCompletion = m_actualCompletion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
-        maxAll[0] = pWaveform->getAll(currentCompletion);
-        maxAll[1] = pWaveform->getAll(currentCompletion+1);
+        maxAll[0] = data[currentCompletion].filtered.all;
+        maxAll[1] = data[currentCompletion+1].filtered.all;
         if (maxAll[0] || maxAll[1]) {
-            maxLow[0] = pWaveform->getLow(currentCompletion);
-            maxLow[1] = pWaveform->getLow(currentCompletion+1);
-            maxMid[0] = pWaveform->getMid(currentCompletion);
-            maxMid[1] = pWaveform->getMid(currentCompletion+1);
-            maxHigh[0] = pWaveform->getHigh(currentCompletion);
-            maxHigh[1] = pWaveform->getHigh(currentCompletion+1);
+            maxLow[0] = data[currentCompletion].filtered.low;
+            maxLow[1] = data[currentCompletion+1].filtered.low;
+            maxMid[0] = data[currentCompletion].filtered.mid;
+            maxMid[1] = data[currentCompletion+1].filtered.mid;
+            maxHigh[0] = data[currentCompletion].filtered.high;
+            maxHigh[1] = data[currentCompletion+1].filtered.high;
 
             total = (maxLow[0] + maxLow[1] + maxMid[0] + maxMid[1] +
                      maxHigh[0] + maxHigh[1]) * 1.2;
@@ -118,8 +124,8 @@ bool WOverviewHSV::drawNextPixmapPart() {
             currentCompletion < nextCompletion; currentCompletion += 2) {
         m_waveformPeak = math_max3(
                 m_waveformPeak,
-                static_cast<float>(pWaveform->getAll(currentCompletion)),
-                static_cast<float>(pWaveform->getAll(currentCompletion + 1)));
+                static_cast<float>(data[currentCompletion].filtered.all),
+                static_cast<float>(data[currentCompletion + 1].filtered.all));
     }
 
     m_actualCompletion = nextCompletion;
@@ -29,22 +29,28 @@ bool WOverviewLMH::drawNextPixmapPart() {
         return false;
     }
 
-    const int dataSize = pWaveform->getDataSize();
-    if (dataSize == 0) {
+    if (pWaveform->getDataSize() == 0) {
         return false;
     }
 
     if (m_waveformSourceImage.isNull()) {
+        m_waveformMipLevel = selectMipLevel(*pWaveform);
         // Waveform pixmap twice the height of the viewport to be scalable
         // by total_gain
         // We keep full range waveform data to scale it on paint
-        m_waveformSourceImage = QImage(dataSize / 2, 2 * 255,
+        m_waveformSourceImage = QImage(
+                pWaveform->getMipLevelDataSize(m_waveformMipLevel) / 2, 2 * 255,
                 QImage::Format_ARGB32_Premultiplied);
         m_waveformSourceImage.fill(QColor(0, 0, 0, 0).value());
     }
 
-    // Always multiple of 2
-    const int waveformCompletion = pWaveform->getCompletion();
+    const WaveformData* const data = pWaveform->mipLevelData(m_waveformMipLevel);
+    const int dataSize = pWaveform->getMipLevelDataSize(m_waveformMipLevel);
+
+    // Always multiple of 2. Mip levels are only selected for complete
+    // waveforms.
+    const int waveformCompletion = m_waveformMipLevel > 0 ?
+            dataSize : pWaveform->getCompletion();
     // Test if there is some new to draw (at least of pixel width)
     const int completionIncrement = waveformCompletion - m_actualCompletion;
 
@@ -77,8 +83,8 @@ bool WOverviewLMH::drawNextPixmapPart() {
 
     for (currentCompletion = m_actualCompletion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
-        unsigned char lowNeg = pWaveform->getLow(currentCompletion);
-        unsigned char lowPos = pWaveform->getLow(currentCompletion+1);
+        unsigned char lowNeg = data[currentCompletion].filtered.low;
+        unsigned char lowPos = data[currentCompletion+1].filtered.low;
         if (lowPos || lowNeg) {
             painter.setPen(lowColorPen);
             painter.drawLine(QPoint(currentCompletion / 2, -lowNeg),
@@ -90,18 +96,18 @@ bool WOverviewLMH::drawNextPixmapPart() {
             currentCompletion < nextCompletion; currentCompletion += 2) {
         painter.setPen(midColorPen);
         painter.drawLine(QPoint(currentCompletion / 2,
-                -pWaveform->getMid(currentCompletion)),
+                -data[currentCompletion].filtered.mid),
                 QPoint(currentCompletion / 2,
-                pWaveform->getMid(currentCompletion+1)));
+                data[currentCompletion+1].filtered.mid));
     }
 
     for (currentCompletion = m_actualCompletion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
         painter.setPen(highColorPen);
         painter.drawLine(QPoint(currentCompletion / 2,
-                -pWaveform->getHigh(currentCompletion)),
+                -data[currentCompletion].filtered.high),
                 QPoint(currentCompletion / 2,
-                pWaveform->getHigh(currentCompletion+1)));
+                data[currentCompletion+1].filtered.high));
     }
 
     // Evaluate waveform ratio peak
@@ -110,8 +116,8 @@ bool WOverviewLMH::drawNextPixmapPart() {
             currentCompletion < nextCompletion; currentCompletion += 2) {
         m_waveformPeak = math_max3(
                 m_waveformPeak,
-                static_cast<float>(pWaveform->getAll(currentCompletion)),
-                static_cast<float>(pWaveform->getAll(currentCompletion + 1)));
+                static_cast<float>(data[currentCompletion].filtered.all),
+                static_cast<float>(data[currentCompletion + 1].filtered.all));
     }
 
     m_actualCompletion = nextCompletion;
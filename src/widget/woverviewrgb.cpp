@@ -26,22 +26,28 @@ bool WOverviewRGB::drawNextPixmapPart() {
         return false;
     }
 
-    const int dataSize = pWaveform->getDataSize();
-    if (dataSize == 0) {
+    if (pWaveform->getDataSize() == 0) {
         return false;
     }
 
     if (m_waveformSourceImage.isNull()) {
+        m_waveformMipLevel = selectMipLevel(*pWaveform);
         // Waveform pixmap twice the height of the viewport to be scalable
         // by total_gain
         // We keep full range waveform data to scale it on paint
-        m_waveformSourceImage = QImage(dataSize / 2, 2 * 255,
+        m_waveformSourceImage = QImage(
+                pWaveform->getMipLevelDataSize(m_waveformMipLevel) / 2, 2 * 255,
                 QImage::Format_ARGB32_Premultiplied);
         m_waveformSourceImage.fill(QColor(0, 0, 0, 0).value());
     }
 
-    // Always multiple of 2
-    const int waveformCompletion = pWaveform->getCompletion();
+    const WaveformData* const data = pWaveform->mipLevelData(m_waveformMipLevel);
+    const int dataSize = pWaveform->getMipLevelDataSize(m_waveformMipLevel);
+
+    // Always multiple of 2. Mip levels are only selected for complete
+    // waveforms.
+    const int waveformCompletion = m_waveformMipLevel > 0 ?
+            dataSize : pWaveform->getCompletion();
     // Test if there is some new to draw (at least of pixel width)
     const int completionIncrement = waveformCompletion - m_actualCompletion;
 
@@ -76,13 +82,13 @@ bool WOverviewRGB::drawNextPixmapPart() {
     for (currentCompletion = m_actualCompletion;
             currentCompletion < nextCompletion; currentCompletion += 2) {
 
-        unsigned char left = pWaveform->getAll(currentCompletion);
-        unsigned char right = pWaveform->getAll(currentCompletion + 1);
+        unsigned char left = data[currentCompletion].filtered.all;
+        unsigned char right = data[currentCompletion + 1].filtered.all;
 
         // Retrieve "raw" LMH values from waveform
-        qreal low = static_cast<qreal>(pWaveform->getLow(currentCompletion));
-        qreal mid = static_cast<qreal>(pWaveform->getMid(currentCompletion));
-        qreal high = static_cast<qreal>(pWaveform->getHigh(currentCompletion));
+        qreal low = static_cast<qreal>(data[currentCompletion].filtered.low);
+        qreal mid = static_cast<qreal>(data[currentCompletion].filtered.mid);
+        qreal high = static_cast<qreal>(data[currentCompletion].filtered.high);
 
         // Do matrix multiplication
         qreal red = low * lowColor_r + mid * midColor_r + high * highColor_r;
@@ -98,9 +104,9 @@ bool WOverviewRGB::drawNextPixmapPart() {
         }
 
         // Retrieve "raw" LMH values from waveform
-        low = static_cast<qreal>(pWaveform->getLow(currentCompletion + 1));
-        mid = static_cast<qreal>(pWaveform->getMid(currentCompletion + 1));
-        high = static_cast<qreal>(pWaveform->getHigh(currentCompletion + 1));
+        low = static_cast<qreal>(data[currentCompletion + 1].filtered.low);
+        mid = static_cast<qreal>(data[currentCompletion + 1].filtered.mid);
+        high = static_cast<qreal>(data[currentCompletion + 1].filtered.high);
 
         // Do matrix multiplication
         red = low * lowColor_r + mid * midColor_r + high * highColor_r;
@@ -121,8 +127,8 @@ bool WOverviewRGB::drawNextPixmapPart() {
             currentCompletion < nextCompletion; currentCompletion += 2) {
         m_waveformPeak = math_max3(
                 m_waveformPeak,
-                static_cast<float>(pWaveform->getAll(currentCompletion)),
-                static_cast<float>(pWaveform->getAll(currentCompletion + 1)));
+                static_cast<float>(data[currentCompletion].filtered.all),
+                static_cast<float>(data[currentCompletion + 1].filtered.all));
     }
 
     m_actualCompletion = nextCompletion;